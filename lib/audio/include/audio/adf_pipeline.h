@@ -7,6 +7,8 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
+#include "audio/latency_queue.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -122,6 +124,12 @@ typedef struct {
     bool usb_input_ready;
     bool usb_input_active;
     bool usb_fallback_to_aux;
+    // Inter-stage queues: occupancy, drops and enqueue-to-dequeue age. Every
+    // queue enforces its build.h budget, so queueing latency never exceeds
+    // queue_latency_ceiling_ms (the sum of the budgets).
+    latency_queue_stats_t pcm_queue;    // TX capture → encode, RX decode → playout
+    latency_queue_stats_t opus_queue;   // RX mesh → decode
+    uint32_t queue_latency_ceiling_ms;
 } adf_pipeline_stats_t;
 
 esp_err_t adf_pipeline_get_stats(adf_pipeline_handle_t pipeline, adf_pipeline_stats_t *stats);
@@ -169,6 +177,23 @@ esp_err_t adf_pipeline_get_fft_bins(adf_pipeline_handle_t pipeline,
  */
 esp_err_t adf_pipeline_get_latest_fft_bins(float *bins_out, size_t bin_count, bool *valid_out);
 
+/**
+ * Live levels for high-rate meters: the highest frame peak and frame RMS (Q15,
+ * 32767 = full scale) since the previous call, and the current PCM queue fill.
+ * TX meters the captured input after gain/mute, RX the playout. The audio
+ * tasks update the hold lock-free, so polling this never stalls them.
+ */
+typedef struct {
+    uint16_t peak_q15;
+    uint16_t rms_q15;
+    uint8_t buffer_fill_percent;
+    bool signal_present;
+} adf_pipeline_levels_t;
+
+esp_err_t adf_pipeline_take_levels(adf_pipeline_handle_t pipeline, adf_pipeline_levels_t *levels);
+// Same for the active local pipeline; ESP_ERR_NOT_FOUND before one exists.
+esp_err_t adf_pipeline_take_latest_levels(adf_pipeline_levels_t *levels);
+
 /**
  * Output gain and mute controls (primarily for RX/COMBO playback).
  * Changes take effect on the next audio frame; no restart required.
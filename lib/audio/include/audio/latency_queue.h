@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Latency-bounded FIFO between two pipeline stages, over caller-owned memory.
+// Every item is stamped with its enqueue time. Producers never wait: when the
+// queue is full the oldest items are evicted to make room, so a stalled
+// consumer costs old audio rather than growing latency. Consumers drop items
+// whose age exceeds max_age_us before reading, so nothing older than the
+// budget ever leaves the queue. Not thread-safe; ring_buffer.c adds the lock.
+//
+// Items are stored contiguously behind a 16-byte header (length, enqueue
+// time). Stream reads (latency_queue_read) may span and split items; item
+// reads (latency_queue_peek/release) hand out one whole item in place.
+
+#define LATENCY_QUEUE_ITEM_OVERHEAD 16
+
+typedef struct {
+    uint32_t enqueued;
+    uint32_t dequeued;          // Items fully consumed
+    uint32_t evicted;           // Dropped by push to make room
+    uint32_t expired;           // Dropped by the consumer past max_age_us
+    uint32_t rejected;          // Larger than the queue, or the head was held
+    uint32_t items;             // Queued now
+    uint32_t items_peak;
+    uint32_t bytes;             // Payload queued now
+    uint32_t bytes_peak;
+    uint32_t age_last_us;       // Enqueue-to-dequeue of the last consumed item
+    uint32_t age_max_us;
+    uint64_t age_total_us;      // Sum over dequeued; mean = age_total_us / dequeued
+} latency_queue_stats_t;
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t head;                // Next write offset
+    size_t tail;                // Oldest item
+    size_t wrap_end;            // End of the upper segment while wrapped
+    bool wrapped;               // Items run tail..wrap_end, then 0..head
+    bool held;                  // Oldest item handed out by peek
+    size_t read_off;            // Payload of the oldest item already streamed out
+    int64_t max_age_us;         // 0 = no budget
+    latency_queue_stats_t stats;
+} latency_queue_t;
+
+// buf must outlive the queue. max_age_us of 0 disables expiry.
+void latency_queue_init(latency_queue_t *q, uint8_t *buf, size_t size, int64_t max_age_us);
+void latency_queue_reset(latency_queue_t *q);
+void latency_queue_set_max_age(latency_queue_t *q, int64_t max_age_us);
+
+// Appends one item stamped now_us, evicting the oldest items as needed.
+// False when the item cannot fit even in an empty queue, or when room could
+// only be made by evicting an item a consumer still holds.
+bool latency_queue_push(latency_queue_t *q, const uint8_t *data, size_t len, int64_t now_us);
+
+// Drops items older than the budget at now_us; returns how many.
+uint32_t latency_queue_expire(latency_queue_t *q, int64_t now_us);
+
+// Payload bytes queued (after any partial stream read).
+size_t latency_queue_available(const latency_queue_t *q);
+
+// Stream read: expires stale items, then copies exactly len bytes across item
+// boundaries. False (nothing consumed) when fewer than len bytes remain.
+bool latency_queue_read(latency_queue_t *q, uint8_t *out, size_t len, int64_t now_us);
+
+// Item read: expires stale items, then returns the oldest item in place and
+// holds it until latency_queue_release. NULL when empty.
+const uint8_t *latency_queue_peek(latency_queue_t *q, size_t *len, int64_t now_us);
+void latency_queue_release(latency_queue_t *q, int64_t now_us);
+
+// Copies the statistics; reset clears the counters and restarts the peaks
+// from the current occupancy.
+void latency_queue_get_stats(latency_queue_t *q, latency_queue_stats_t *out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
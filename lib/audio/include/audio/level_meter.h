@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Peak and RMS level of a PCM stream, held between reads. The audio task
+// feeds every frame; a reader (the portal meter stream) takes the highest
+// frame peak and frame RMS since its previous take. Both sides are lock-free,
+// so metering never blocks the audio path. Levels are Q15: 32767 = full scale.
+
+#define LEVEL_METER_Q15_MAX 32767U
+
+typedef struct {
+    atomic_uint peak_q15;       // Max frame peak since the last take
+    atomic_uint rms_q15;        // Max frame RMS since the last take
+} level_meter_t;
+
+void level_meter_reset(level_meter_t *m);
+// Audio task: one frame of mono samples.
+void level_meter_feed_s16(level_meter_t *m, const int16_t *samples, size_t count);
+// Reader: levels since the previous take; the hold restarts at zero.
+void level_meter_take(level_meter_t *m, uint16_t *peak_q15, uint16_t *rms_q15);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "audio/latency_queue.h"
+
 typedef struct ring_buffer_t ring_buffer_t;
 
 /**
@@ -16,6 +18,7 @@ ring_buffer_t* ring_buffer_create(size_t size);
 
 /**
  * Create a ring buffer with explicit mode and memory policy.
+ * @param size Storage in bytes, including LATENCY_QUEUE_ITEM_OVERHEAD per write
  * @param item_mode true for NOSPLIT (discrete items), false for BYTEBUF (stream)
  * @param allow_psram true to attempt allocation in external PSRAM
  * 
@@ -23,6 +26,10 @@ ring_buffer_t* ring_buffer_create(size_t size);
  *          Use for variable-length packets (e.g., Opus frames with length prefix).
  * BYTEBUF: Stream-based. Reads can span multiple writes.
  *          Use for continuous data like PCM audio.
+ *
+ * Every write is stamped with its enqueue time (audio/latency_queue.h). When
+ * full, writes evict the oldest data; with a latency budget set, reads and
+ * ring_buffer_available() first discard data older than the budget.
  */
 ring_buffer_t* ring_buffer_create_ex(size_t size, bool item_mode, bool allow_psram);
 
@@ -35,7 +42,14 @@ void ring_buffer_destroy(ring_buffer_t *rb);
 void ring_buffer_set_consumer(ring_buffer_t *rb, TaskHandle_t consumer);
 
 /**
- * Write data to the ring buffer.
+ * Drop queued data older than budget_ms at the consumer (0 = no budget).
+ */
+void ring_buffer_set_latency_budget(ring_buffer_t *rb, uint32_t budget_ms);
+
+/**
+ * Write data to the ring buffer. Never blocks: when full, the oldest data is
+ * evicted to make room. Returns ESP_ERR_NO_MEM only when the data is larger
+ * than the buffer or room would require evicting a received item.
  * If a consumer task is set, it will be notified via xTaskNotifyGive().
  */
 esp_err_t ring_buffer_write(ring_buffer_t *rb, const uint8_t *data, size_t len);
@@ -69,3 +83,9 @@ uint8_t* ring_buffer_receive_item(ring_buffer_t *rb, size_t *item_size);
  * Return an item received via ring_buffer_receive_item().
  */
 void ring_buffer_return_item(ring_buffer_t *rb, uint8_t *item);
+
+/**
+ * Occupancy, eviction/expiry counts and enqueue-to-dequeue age of consumed
+ * items. reset clears the counters and restarts the peaks.
+ */
+esp_err_t ring_buffer_get_stats(ring_buffer_t *rb, latency_queue_stats_t *stats, bool reset);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config/build.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sequence-ordered hold ahead of the Opus decoder. Frames leave in order; a
+// missing frame waits up to hold_ms after a later frame arrives, so a NACKed
+// retransmit can fill it, and is then concealed. Frames for a sequence that
+// already left (played or concealed) are dropped: playout never goes back.
+
+typedef enum {
+    RX_REORDER_ACCEPTED,
+    RX_REORDER_LATE,            // Already played or concealed
+    RX_REORDER_DUPLICATE,
+    RX_REORDER_FULL,            // Too far ahead: drain with rx_reorder_pop, then push again
+    RX_REORDER_INVALID,
+} rx_reorder_push_t;
+
+typedef enum {
+    RX_REORDER_NONE,            // Nothing due yet
+    RX_REORDER_FRAME,
+    RX_REORDER_CONCEAL,         // Missing past its hold: run PLC for this seq
+} rx_reorder_pop_t;
+
+typedef struct {
+    uint32_t repaired;          // Arrived after later frames, in time to play
+    uint32_t late;
+    uint32_t duplicates;
+    uint32_t concealed;
+    uint32_t skipped;           // Missing beyond max_conceal; not concealed
+    uint32_t resets;
+} rx_reorder_stats_t;
+
+typedef struct {
+    bool used;
+    uint16_t seq;
+    uint16_t len;
+    int64_t arrival_ms;
+    uint8_t data[OPUS_MAX_FRAME_BYTES];
+} rx_reorder_slot_t;
+
+typedef struct {
+    rx_reorder_slot_t slots[RX_REORDER_SLOTS];
+    uint32_t hold_ms;
+    uint8_t max_conceal;        // Per gap, as RX_PLC_MAX_FRAMES_PER_GAP
+    uint8_t max_stale;          // Further behind than this is a sender restart
+    bool started;
+    uint16_t next_seq;          // Next to leave
+    uint16_t newest_seq;
+    uint8_t held;
+    uint8_t conceal_run;
+    bool flushing;              // Holds are skipped until next_seq reaches flush_to
+    uint16_t flush_to;
+    rx_reorder_stats_t stats;
+} rx_reorder_t;
+
+void rx_reorder_init(rx_reorder_t *r, uint32_t hold_ms, uint8_t max_conceal, uint8_t max_stale);
+
+rx_reorder_push_t rx_reorder_push(rx_reorder_t *r, uint16_t seq, const uint8_t *data, uint16_t len, int64_t now_ms);
+
+// Call until RX_REORDER_NONE. A frame's data stays valid until the next push.
+rx_reorder_pop_t rx_reorder_pop(rx_reorder_t *r, int64_t now_ms, uint16_t *seq, const uint8_t **data, uint16_t *len);
+
+#ifdef __cplusplus
+}
+#endif
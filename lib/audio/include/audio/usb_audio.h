@@ -5,6 +5,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "audio/latency_queue.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +27,12 @@ esp_err_t usb_audio_deinit(void);
  */
 esp_err_t usb_audio_read_stereo(int16_t *stereo_buffer, size_t max_frames, size_t *frames_read);
 
+/**
+ * Occupancy and age statistics of the USB capture queue (host → TX capture).
+ * Returns ESP_ERR_INVALID_STATE before usb_audio_init().
+ */
+esp_err_t usb_audio_get_queue_stats(latency_queue_stats_t *stats, bool reset);
+
 /**
  * Runtime state helpers used by TX input mode policy.
  */
@@ -57,6 +57,14 @@ esp_err_t adf_pipeline_get_fft_bins(adf_pipeline_handle_t pipeline,
     return adf_pipeline_get_fft_bins_impl(pipeline, bins_out, bin_count, valid_out);
 }
 
+esp_err_t adf_pipeline_take_levels(adf_pipeline_handle_t pipeline, adf_pipeline_levels_t *levels)
+{
+    if (!pipeline || !levels) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return adf_pipeline_take_levels_impl(pipeline, levels);
+}
+
 esp_err_t adf_pipeline_get_latest_fft_bins(float *bins_out, size_t bin_count, bool *valid_out)
 {
     adf_pipeline_handle_t pipeline = adf_pipeline_get_latest_pipeline();
@@ -68,3 +76,12 @@ esp_err_t adf_pipeline_get_latest_fft_bins(float *bins_out, size_t bin_count, bo
     }
     return adf_pipeline_get_fft_bins_impl(pipeline, bins_out, bin_count, valid_out);
 }
+
+esp_err_t adf_pipeline_take_latest_levels(adf_pipeline_levels_t *levels)
+{
+    adf_pipeline_handle_t pipeline = adf_pipeline_get_latest_pipeline();
+    if (!pipeline) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return adf_pipeline_take_levels(pipeline, levels);
+}
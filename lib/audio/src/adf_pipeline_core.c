@@ -18,14 +18,17 @@ static const char *TAG = "adf_pipeline";
 int16_t s_capture_stereo_frame[AUDIO_FRAME_SAMPLES * 2];
 int16_t s_capture_mono_frame[AUDIO_FRAME_SAMPLES];
 int16_t s_encode_pcm_frame[AUDIO_FRAME_SAMPLES];
-uint8_t s_encode_opus_frame[OPUS_MAX_FRAME_BYTES];
 int16_t s_decode_pcm_frame[AUDIO_FRAME_SAMPLES];
 int16_t s_playback_mono_frame[AUDIO_FRAME_SAMPLES];
 int16_t s_playback_last_good_mono[AUDIO_FRAME_SAMPLES];
 int16_t s_playback_stereo_frame[AUDIO_FRAME_SAMPLES * 2];
 int16_t s_playback_silence[AUDIO_FRAME_SAMPLES * 2];
 
+_Static_assert(AUDIO_QUEUE_ITEM_OVERHEAD == LATENCY_QUEUE_ITEM_OVERHEAD,
+               "build.h queue sizing must match the latency_queue item header");
+
 static adf_pipeline_handle_t s_latest_pipeline = NULL;
+static const uint16_t s_stat_gauges[] = { ADF_STAT_WORD(avg_encode_time_us), ADF_STAT_WORD(avg_decode_time_us) };
 
 static esp_err_t init_opus_encoder(adf_pipeline_handle_t pipeline, uint32_t bitrate, uint8_t complexity)
 {
@@ -67,11 +70,19 @@ esp_err_t adf_pipeline_create_impl(const adf_pipeline_config_t *config, adf_pipe
     pipeline->x = 0.0f;
     pipeline->y = 0.0f;
     pipeline->z = 0.0f;
+    level_meter_reset(&pipeline->level);
     pipeline->mutex = xSemaphoreCreateMutex();
+    network_stat_counters_init(&pipeline->counters, pipeline->counter_words, pipeline->counter_baseline,
+                               ADF_STATS_COUNTER_WORDS, s_stat_gauges,
+                               sizeof(s_stat_gauges) / sizeof(s_stat_gauges[0]));
     
     // Allocate buffers in internal SRAM for speed and reliability (since they are now smaller)
     pipeline->pcm_buffer = ring_buffer_create_ex(PCM_BUFFER_SIZE, false, false);
     pipeline->opus_buffer = ring_buffer_create_ex(OPUS_BUFFER_SIZE, true, false);
+    ring_buffer_set_latency_budget(pipeline->pcm_buffer, pipeline->type == ADF_PIPELINE_TX
+                                                             ? TX_PCM_QUEUE_BUDGET_MS
+                                                             : RX_PCM_QUEUE_BUDGET_MS);
+    ring_buffer_set_latency_budget(pipeline->opus_buffer, RX_OPUS_QUEUE_BUDGET_MS);
 
     if (pipeline->type == ADF_PIPELINE_TX) {
         init_opus_encoder(pipeline, OPUS_BITRATE, OPUS_COMPLEXITY);
@@ -116,8 +127,25 @@ void adf_pipeline_destroy_impl(adf_pipeline_handle_t p) {
 bool adf_pipeline_is_running_impl(adf_pipeline_handle_t p) { return p->running; }
 esp_err_t adf_pipeline_get_stats_impl(adf_pipeline_handle_t p, adf_pipeline_stats_t *s) {
     memcpy(s, &p->stats, sizeof(adf_pipeline_stats_t));
+    network_stat_snapshot(&p->counters, (uint32_t *)s);
+
+    ring_buffer_get_stats(p->pcm_buffer, &s->pcm_queue, false);
+    ring_buffer_get_stats(p->opus_buffer, &s->opus_queue, false);
+    const uint32_t pcm_capacity = AUDIO_FRAME_BYTES_INTERNAL_MONO * PCM_BUFFER_FRAMES;
+    s->buffer_fill_percent = (uint8_t)((s->pcm_queue.bytes * 100U) / pcm_capacity);
+    s->buffer_fill_peak_percent = (uint8_t)((s->pcm_queue.bytes_peak * 100U) / pcm_capacity);
+    s->queue_latency_ceiling_ms = AUDIO_QUEUE_LATENCY_CEILING_MS;
+    return ESP_OK;
+}
+esp_err_t adf_pipeline_take_levels_impl(adf_pipeline_handle_t p, adf_pipeline_levels_t *levels) {
+    level_meter_take(&p->level, &levels->peak_q15, &levels->rms_q15);
+    const uint32_t pcm_capacity = AUDIO_FRAME_BYTES_INTERNAL_MONO * PCM_BUFFER_FRAMES;
+    size_t queued = ring_buffer_available(p->pcm_buffer);
+    levels->buffer_fill_percent = (uint8_t)(queued >= pcm_capacity ? 100U : (queued * 100U) / pcm_capacity);
+    levels->signal_present = p->stats.input_signal_present;
     return ESP_OK;
 }
+
 esp_err_t adf_pipeline_set_input_mode_impl(adf_pipeline_handle_t p, adf_input_mode_t m) {
     p->input_mode = m;
     return ESP_OK;
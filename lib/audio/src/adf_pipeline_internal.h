@@ -9,6 +9,7 @@ void adf_pipeline_destroy_impl(adf_pipeline_handle_t pipeline);
 bool adf_pipeline_is_running_impl(adf_pipeline_handle_t pipeline);
 
 esp_err_t adf_pipeline_get_stats_impl(adf_pipeline_handle_t pipeline, adf_pipeline_stats_t *stats);
+esp_err_t adf_pipeline_take_levels_impl(adf_pipeline_handle_t pipeline, adf_pipeline_levels_t *levels);
 esp_err_t adf_pipeline_set_input_mode_impl(adf_pipeline_handle_t pipeline, adf_input_mode_t mode);
 
 esp_err_t adf_pipeline_feed_opus_impl(adf_pipeline_handle_t pipeline,
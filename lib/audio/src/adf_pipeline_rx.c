@@ -3,6 +3,7 @@
 #include "audio/es8388_audio.h"
 #include "audio/i2s_audio.h"
 #include "audio/pcm_convert.h"
+#include "audio/rx_reorder.h"
 #include "audio/rx_underrun_concealment.h"
 #include "audio/sequence_tracker.h"
 #include "config/build.h"
@@ -15,18 +16,47 @@
 
 static const char *TAG = "adf_pipeline";
 
+static rx_reorder_t s_rx_reorder;
+
+// Decodes whatever the reorder hold releases: frames in order, and PLC for
+// gaps whose retransmit did not arrive in time.
+static void rx_decode_drain(adf_pipeline_handle_t pipeline, network_stat_shard_t *stat_shard,
+                            int16_t *pcm_frame, int64_t now_ms)
+{
+    uint16_t seq;
+    const uint8_t *payload;
+    uint16_t payload_len;
+    rx_reorder_pop_t due;
+
+    while ((due = rx_reorder_pop(&s_rx_reorder, now_ms, &seq, &payload, &payload_len)) != RX_REORDER_NONE) {
+        int decoded;
+        if (due == RX_REORDER_CONCEAL) {
+            decoded = opus_decode(pipeline->decoder, NULL, 0, pcm_frame, AUDIO_FRAME_SAMPLES, 1);
+            network_stat_add(&pipeline->counters, stat_shard, ADF_STAT_WORD(rx_plc_frames_injected), 1);
+        } else {
+            decoded = opus_decode(pipeline->decoder, payload, payload_len, pcm_frame, AUDIO_FRAME_SAMPLES, 0);
+        }
+        if (decoded > 0) {
+            ring_buffer_write(pipeline->pcm_buffer, (uint8_t *)pcm_frame, AUDIO_FRAME_BYTES_MONO);
+        } else {
+            network_stat_add(&pipeline->counters, stat_shard, ADF_STAT_WORD(rx_decode_errors), 1);
+        }
+    }
+}
+
 void rx_decode_task(void *arg)
 {
     adf_pipeline_handle_t pipeline = (adf_pipeline_handle_t)arg;
+    network_stat_shard_t *stat_shard = adf_stats_shard(pipeline);
     int16_t *pcm_frame = s_decode_pcm_frame;
-    uint16_t last_seq = 0;
-    bool first_packet = true;
 
-    ESP_LOGI(TAG, "RX decode task started (16-bit pure)");
+    rx_reorder_init(&s_rx_reorder, RX_REORDER_HOLD_MS, RX_PLC_MAX_FRAMES_PER_GAP, RX_MAX_STALE_FRAMES_TO_DROP);
+    ESP_LOGI(TAG, "RX decode task started (16-bit pure, %d ms reorder hold)", RX_REORDER_HOLD_MS);
 
     while (pipeline->running) {
         ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
-        
+        int64_t now_ms = esp_timer_get_time() / 1000;
+
         size_t item_size = 0;
         uint8_t *item = ring_buffer_receive_item(pipeline->opus_buffer, &item_size);
         while (item) {
@@ -36,29 +66,22 @@ void rx_decode_task(void *arg)
             uint16_t payload_len = (item[7] << 8) | item[8];
             uint8_t *payload = item + 9;
 
-            if (first_packet) {
-                last_seq = seq - MESH_FRAMES_PER_PACKET;
-                first_packet = false;
-            }
-
-            // Handle Packet Loss Concealment (PLC)
-            int gap = (uint16_t)(seq - last_seq) - MESH_FRAMES_PER_PACKET;
-            if (gap > 0 && gap < 10) {
-                for (int i = 0; i < gap; i++) {
-                    opus_decode(pipeline->decoder, NULL, 0, pcm_frame, AUDIO_FRAME_SAMPLES, 1);
-                    ring_buffer_write(pipeline->pcm_buffer, (uint8_t *)pcm_frame, AUDIO_FRAME_BYTES_MONO);
-                }
+            rx_reorder_push_t pushed = rx_reorder_push(&s_rx_reorder, seq, payload, payload_len, now_ms);
+            if (pushed == RX_REORDER_FULL) {
+                // Far ahead of a held gap: give up on the gap to make room.
+                rx_decode_drain(pipeline, stat_shard, pcm_frame, now_ms);
+                pushed = rx_reorder_push(&s_rx_reorder, seq, payload, payload_len, now_ms);
             }
-
-            int decoded = opus_decode(pipeline->decoder, payload, payload_len, pcm_frame, AUDIO_FRAME_SAMPLES, 0);
-            if (decoded > 0) {
-                ring_buffer_write(pipeline->pcm_buffer, (uint8_t *)pcm_frame, AUDIO_FRAME_BYTES_MONO);
-                last_seq = seq;
+            if (pushed == RX_REORDER_LATE || pushed == RX_REORDER_DUPLICATE) {
+                network_stat_add(&pipeline->counters, stat_shard, ADF_STAT_WORD(rx_late_or_duplicate_frames), 1);
             }
 
             ring_buffer_return_item(pipeline->opus_buffer, item);
+            rx_decode_drain(pipeline, stat_shard, pcm_frame, now_ms);
             item = ring_buffer_receive_item(pipeline->opus_buffer, &item_size);
         }
+        // Gaps whose hold ran out while nothing new arrived.
+        rx_decode_drain(pipeline, stat_shard, pcm_frame, now_ms);
     }
     vTaskDelete(NULL);
 }
@@ -90,6 +113,7 @@ void rx_playback_task(void *arg)
                 }
             }
 
+            level_meter_feed_s16(&pipeline->level, mono_frame, AUDIO_FRAME_SAMPLES);
             memcpy(last_good_mono, mono_frame, AUDIO_FRAME_BYTES_MONO);
             pcm_convert_mono_to_stereo_s16(mono_frame, stereo_frame, AUDIO_FRAME_SAMPLES);
             es8388_audio_write_stereo(stereo_frame, AUDIO_FRAME_SAMPLES);
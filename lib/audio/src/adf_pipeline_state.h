@@ -1,8 +1,10 @@
 #pragma once
 
 #include "audio/adf_pipeline.h"
+#include "audio/level_meter.h"
 #include "audio/ring_buffer.h"
 #include "config/build.h"
+#include "network/stat_counters.h"
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
@@ -10,6 +12,15 @@
 
 #include "opus.h"
 
+// The uint32_t head of adf_pipeline_stats_t is kept in sharded counters so the
+// pipeline tasks never race each other or adf_pipeline_get_stats(); the narrower
+// trailing fields are single-writer flags and levels updated in place.
+#define ADF_STATS_COUNTER_WORDS NETWORK_STAT_WORD(adf_pipeline_stats_t, buffer_fill_percent)
+#define ADF_STAT_WORD(field)    NETWORK_STAT_WORD(adf_pipeline_stats_t, field)
+_Static_assert(offsetof(adf_pipeline_stats_t, buffer_fill_percent) % sizeof(uint32_t) == 0 &&
+               ADF_STATS_COUNTER_WORDS <= STAT_COUNTER_MAX_WORDS,
+               "adf_pipeline_stats_t counter head must be whole uint32_t words");
+
 struct adf_pipeline {
     adf_pipeline_type_t type;
     volatile bool running;
@@ -29,8 +40,12 @@ struct adf_pipeline {
 
     SemaphoreHandle_t mutex;
 
-    adf_pipeline_stats_t stats;
+    adf_pipeline_stats_t stats;         // Trailing gauges only; see ADF_STATS_COUNTER_WORDS
+    network_stat_counters_t counters;
+    _Atomic uint32_t counter_words[STAT_COUNTER_SHARDS * ADF_STATS_COUNTER_WORDS];
+    uint32_t counter_baseline[ADF_STATS_COUNTER_WORDS];
     uint16_t input_silence_frames;
+    level_meter_t level;                // TX: captured input, RX: playout (portal meters)
 
     uint16_t tx_seq;
     uint16_t last_rx_seq;
@@ -51,9 +66,13 @@ struct adf_pipeline {
 extern int16_t s_capture_stereo_frame[AUDIO_FRAME_SAMPLES * 2];
 extern int16_t s_capture_mono_frame[AUDIO_FRAME_SAMPLES];
 extern int16_t s_encode_pcm_frame[AUDIO_FRAME_SAMPLES];
-extern uint8_t s_encode_opus_frame[OPUS_MAX_FRAME_BYTES];
 extern int16_t s_decode_pcm_frame[AUDIO_FRAME_SAMPLES];
 extern int16_t s_playback_mono_frame[AUDIO_FRAME_SAMPLES];
 extern int16_t s_playback_last_good_mono[AUDIO_FRAME_SAMPLES];
 extern int16_t s_playback_stereo_frame[AUDIO_FRAME_SAMPLES * 2];
 extern int16_t s_playback_silence[AUDIO_FRAME_SAMPLES * 2];
+
+static inline network_stat_shard_t *adf_stats_shard(adf_pipeline_handle_t pipeline)
+{
+    return network_stat_shard(&pipeline->counters, xTaskGetCurrentTaskHandle());
+}
@@ -14,7 +14,6 @@
 #include <string.h>
 
 static const char *TAG = "adf_pipeline";
-static uint8_t s_batch_buffer[MESH_OPUS_BATCH_MAX_BYTES];
 
 #ifndef UNIT_TEST
 static uint16_t calculate_pcm_peak_s16(const int16_t *samples, size_t sample_count)
@@ -126,6 +125,7 @@ void tx_capture_task(void *arg)
         }
 
         if (frames_read > 0) {
+            level_meter_feed_s16(&pipeline->level, mono_frame, frames_read);
             ring_buffer_write(pipeline->pcm_buffer, (const uint8_t *)mono_frame, frames_read * 2);
         }
     }
@@ -136,11 +136,11 @@ void tx_encode_task(void *arg)
 {
     adf_pipeline_handle_t pipeline = (adf_pipeline_handle_t)arg;
     int16_t *pcm_frame = s_encode_pcm_frame;
-    uint8_t *opus_frame = s_encode_opus_frame;
     uint32_t batch_count = 0;
-    size_t batch_payload_len = 0;
+    network_stat_shard_t *stat_shard = adf_stats_shard(pipeline);
 
     ESP_LOGI(TAG, "TX encode task started (16-bit, batch=%d)", MESH_FRAMES_PER_PACKET);
+    network_audio_tx_reset();
 
     while (pipeline->running) {
         ulTaskNotifyTake(pdFALSE, pdMS_TO_TICKS(10));
@@ -149,30 +149,31 @@ void tx_encode_task(void *arg)
 
 #if !TX_CONTINUOUS_STREAMING
             if (pipeline->input_mode != ADF_INPUT_MODE_TONE && !pipeline->stats.input_signal_present) {
-                batch_count = 0; batch_payload_len = 0; continue;
+                batch_count = 0; network_audio_tx_reset(); continue;
             }
 #endif
 
+            // Encode straight into the outgoing mesh packet behind its length prefix.
+            size_t slot_capacity = 0;
+            uint8_t *opus_slot = network_audio_tx_frame_slot(&slot_capacity);
+            if (!opus_slot) {
+                batch_count = 0; network_audio_tx_reset(); continue;
+            }
+
             int64_t start_us = esp_timer_get_time();
-            int opus_len = opus_encode(pipeline->encoder, pcm_frame, AUDIO_FRAME_SAMPLES, opus_frame, OPUS_MAX_FRAME_BYTES);
+            int opus_len = opus_encode(pipeline->encoder, pcm_frame, AUDIO_FRAME_SAMPLES, opus_slot, (opus_int32)slot_capacity);
             uint32_t dur = (uint32_t)(esp_timer_get_time() - start_us);
-            pipeline->stats.avg_encode_time_us = (pipeline->stats.avg_encode_time_us * 7 + dur) / 8;
-
-            if (opus_len < 0) continue;
+            uint32_t avg_us = network_stat_read(&pipeline->counters, ADF_STAT_WORD(avg_encode_time_us));
+            network_stat_set(&pipeline->counters, stat_shard, ADF_STAT_WORD(avg_encode_time_us), (avg_us * 7 + dur) / 8);
 
-            uint8_t *dst = s_batch_buffer + batch_payload_len;
-            dst[0] = (opus_len >> 8) & 0xFF;
-            dst[1] = opus_len & 0xFF;
-            memcpy(dst + 2, opus_frame, opus_len);
-            batch_payload_len += 2 + opus_len;
+            if (opus_len <= 0 || network_audio_tx_commit_frame((size_t)opus_len) != ESP_OK) continue;
             batch_count++;
 
             if (batch_count >= MESH_FRAMES_PER_PACKET) {
-                network_send_audio_batch(s_batch_buffer, batch_payload_len, pipeline->tx_seq, 
-                                         (uint32_t)(esp_timer_get_time()/1000), batch_count, 1);
-                pipeline->stats.frames_processed += batch_count;
+                network_audio_tx_send(pipeline->tx_seq, (uint32_t)(esp_timer_get_time()/1000), 1);
+                network_stat_add(&pipeline->counters, stat_shard, ADF_STAT_WORD(frames_processed), batch_count);
                 pipeline->tx_seq += batch_count;
-                batch_count = 0; batch_payload_len = 0;
+                batch_count = 0;
             }
         }
     }
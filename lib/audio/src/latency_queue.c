@@ -0,0 +1,228 @@
+#include "audio/latency_queue.h"
+
+#include <string.h>
+
+typedef struct {
+    uint32_t len;
+    uint32_t reserved;
+    int64_t enqueued_us;
+} latency_queue_hdr_t;
+
+_Static_assert(sizeof(latency_queue_hdr_t) == LATENCY_QUEUE_ITEM_OVERHEAD,
+               "latency_queue item header size");
+
+static size_t item_span(size_t len)
+{
+    return (LATENCY_QUEUE_ITEM_OVERHEAD + len + 7U) & ~(size_t)7U;
+}
+
+static latency_queue_hdr_t read_hdr(const latency_queue_t *q, size_t off)
+{
+    latency_queue_hdr_t hdr;
+    memcpy(&hdr, q->buf + off, sizeof(hdr));
+    return hdr;
+}
+
+static void record_age(latency_queue_t *q, int64_t enqueued_us, int64_t now_us)
+{
+    int64_t age = now_us - enqueued_us;
+    uint32_t age_us = age <= 0 ? 0 : (age >= (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)age);
+    q->stats.dequeued++;
+    q->stats.age_last_us = age_us;
+    q->stats.age_total_us += age_us;
+    if (age_us > q->stats.age_max_us) {
+        q->stats.age_max_us = age_us;
+    }
+}
+
+// Removes the oldest item, including whatever a stream read left of it.
+static void pop_oldest(latency_queue_t *q)
+{
+    latency_queue_hdr_t hdr = read_hdr(q, q->tail);
+    q->stats.bytes -= hdr.len - (uint32_t)q->read_off;
+    q->stats.items--;
+    q->read_off = 0;
+    q->tail += item_span(hdr.len);
+
+    if (q->wrapped && q->tail == q->wrap_end) {
+        q->tail = 0;
+        q->wrapped = false;
+    }
+    if (q->stats.items == 0) {
+        q->head = 0;
+        q->tail = 0;
+        q->wrapped = false;
+    }
+}
+
+// Finds span contiguous bytes at head, wrapping to the start when the upper
+// segment is too short. Never evicts.
+static bool make_room(latency_queue_t *q, size_t span)
+{
+    if (q->stats.items == 0) {
+        return span <= q->size;
+    }
+    if (q->wrapped) {
+        return q->tail - q->head >= span;
+    }
+    if (q->size - q->head >= span) {
+        return true;
+    }
+    if (q->tail >= span) {
+        q->wrap_end = q->head;
+        q->head = 0;
+        q->wrapped = true;
+        return true;
+    }
+    return false;
+}
+
+void latency_queue_init(latency_queue_t *q, uint8_t *buf, size_t size, int64_t max_age_us)
+{
+    memset(q, 0, sizeof(*q));
+    q->buf = buf;
+    q->size = size & ~(size_t)7U;
+    q->max_age_us = max_age_us;
+}
+
+void latency_queue_reset(latency_queue_t *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->wrap_end = 0;
+    q->wrapped = false;
+    q->held = false;
+    q->read_off = 0;
+    q->stats.items = 0;
+    q->stats.bytes = 0;
+}
+
+void latency_queue_set_max_age(latency_queue_t *q, int64_t max_age_us)
+{
+    q->max_age_us = max_age_us;
+}
+
+bool latency_queue_push(latency_queue_t *q, const uint8_t *data, size_t len, int64_t now_us)
+{
+    size_t span = item_span(len);
+    if (len == 0 || len > UINT32_MAX || span > q->size) {
+        q->stats.rejected++;
+        return false;
+    }
+
+    while (!make_room(q, span)) {
+        if (q->held) {
+            q->stats.rejected++;
+            return false;
+        }
+        pop_oldest(q);
+        q->stats.evicted++;
+    }
+
+    latency_queue_hdr_t hdr = { .len = (uint32_t)len, .reserved = 0, .enqueued_us = now_us };
+    memcpy(q->buf + q->head, &hdr, sizeof(hdr));
+    memcpy(q->buf + q->head + sizeof(hdr), data, len);
+    q->head += span;
+
+    q->stats.enqueued++;
+    q->stats.items++;
+    q->stats.bytes += (uint32_t)len;
+    if (q->stats.items > q->stats.items_peak) {
+        q->stats.items_peak = q->stats.items;
+    }
+    if (q->stats.bytes > q->stats.bytes_peak) {
+        q->stats.bytes_peak = q->stats.bytes;
+    }
+    return true;
+}
+
+uint32_t latency_queue_expire(latency_queue_t *q, int64_t now_us)
+{
+    uint32_t dropped = 0;
+    if (q->max_age_us <= 0) {
+        return 0;
+    }
+    while (q->stats.items > 0 && !q->held) {
+        latency_queue_hdr_t hdr = read_hdr(q, q->tail);
+        if (now_us - hdr.enqueued_us <= q->max_age_us) {
+            break;
+        }
+        pop_oldest(q);
+        dropped++;
+    }
+    q->stats.expired += dropped;
+    return dropped;
+}
+
+size_t latency_queue_available(const latency_queue_t *q)
+{
+    return q->stats.bytes;
+}
+
+bool latency_queue_read(latency_queue_t *q, uint8_t *out, size_t len, int64_t now_us)
+{
+    if (q->held) {
+        return false;
+    }
+    latency_queue_expire(q, now_us);
+    if (q->stats.bytes < len) {
+        return false;
+    }
+
+    while (len > 0) {
+        latency_queue_hdr_t hdr = read_hdr(q, q->tail);
+        size_t left = hdr.len - q->read_off;
+        size_t n = len < left ? len : left;
+        memcpy(out, q->buf + q->tail + sizeof(hdr) + q->read_off, n);
+        out += n;
+        len -= n;
+        q->read_off += n;
+        q->stats.bytes -= (uint32_t)n;
+        if (q->read_off == hdr.len) {
+            record_age(q, hdr.enqueued_us, now_us);
+            pop_oldest(q);
+        }
+    }
+    return true;
+}
+
+const uint8_t *latency_queue_peek(latency_queue_t *q, size_t *len, int64_t now_us)
+{
+    if (q->held) {
+        return NULL;
+    }
+    latency_queue_expire(q, now_us);
+    if (q->stats.items == 0) {
+        return NULL;
+    }
+    latency_queue_hdr_t hdr = read_hdr(q, q->tail);
+    q->held = true;
+    *len = hdr.len - q->read_off;
+    return q->buf + q->tail + sizeof(hdr) + q->read_off;
+}
+
+void latency_queue_release(latency_queue_t *q, int64_t now_us)
+{
+    if (!q->held) {
+        return;
+    }
+    latency_queue_hdr_t hdr = read_hdr(q, q->tail);
+    record_age(q, hdr.enqueued_us, now_us);
+    q->held = false;
+    pop_oldest(q);
+}
+
+void latency_queue_get_stats(latency_queue_t *q, latency_queue_stats_t *out, bool reset)
+{
+    *out = q->stats;
+    if (!reset) {
+        return;
+    }
+    latency_queue_stats_t fresh = {
+        .items = q->stats.items,
+        .items_peak = q->stats.items,
+        .bytes = q->stats.bytes,
+        .bytes_peak = q->stats.bytes,
+    };
+    q->stats = fresh;
+}
@@ -0,0 +1,44 @@
+#include "audio/level_meter.h"
+
+#include <math.h>
+
+static void hold_max(atomic_uint *hold, unsigned value)
+{
+    unsigned cur = atomic_load_explicit(hold, memory_order_relaxed);
+    while (value > cur &&
+           !atomic_compare_exchange_weak_explicit(hold, &cur, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void level_meter_reset(level_meter_t *m)
+{
+    atomic_store(&m->peak_q15, 0);
+    atomic_store(&m->rms_q15, 0);
+}
+
+void level_meter_feed_s16(level_meter_t *m, const int16_t *samples, size_t count)
+{
+    if (!samples || count == 0) {
+        return;
+    }
+    unsigned peak = 0;
+    uint64_t sum_sq = 0;
+    for (size_t i = 0; i < count; i++) {
+        int32_t s = samples[i];
+        unsigned mag = (unsigned)(s < 0 ? -s : s);
+        if (mag > peak) {
+            peak = mag;
+        }
+        sum_sq += (uint64_t)(s * s);
+    }
+    unsigned rms = (unsigned)sqrtf((float)sum_sq / (float)count);
+    // -32768 is the one magnitude past Q15 full scale.
+    hold_max(&m->peak_q15, peak > LEVEL_METER_Q15_MAX ? LEVEL_METER_Q15_MAX : peak);
+    hold_max(&m->rms_q15, rms > LEVEL_METER_Q15_MAX ? LEVEL_METER_Q15_MAX : rms);
+}
+
+void level_meter_take(level_meter_t *m, uint16_t *peak_q15, uint16_t *rms_q15)
+{
+    *peak_q15 = (uint16_t)atomic_exchange_explicit(&m->peak_q15, 0, memory_order_relaxed);
+    *rms_q15 = (uint16_t)atomic_exchange_explicit(&m->rms_q15, 0, memory_order_relaxed);
+}
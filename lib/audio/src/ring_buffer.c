@@ -1,18 +1,23 @@
 #include "audio/ring_buffer.h"
+#include "audio/latency_queue.h"
 #include <freertos/FreeRTOS.h>
-#include <freertos/ringbuf.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
 #include <esp_log.h>
 #include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "ring_buffer";
 
-// Forward declaration for xRingbufferCreateWithCaps which may be missing in some headers
-RingbufHandle_t xRingbufferCreateWithCaps(size_t xBufferSize, RingbufferType_t xBufferType, UBaseType_t uxCaps);
-
+// Inter-stage queue: a latency_queue (age-stamped items, drop-oldest on
+// overflow, consumer-side expiry past the latency budget) behind a mutex.
+// Producers never block, so a slow consumer costs old audio, not latency.
 struct ring_buffer_t {
-    RingbufHandle_t handle;
+    latency_queue_t queue;
+    uint8_t *storage;
+    SemaphoreHandle_t lock;
     TaskHandle_t consumer;  // Task to notify on write (event-driven)
 };
 
@@ -21,45 +26,44 @@ ring_buffer_t* ring_buffer_create(size_t size) {
 }
 
 ring_buffer_t* ring_buffer_create_ex(size_t size, bool item_mode, bool allow_psram) {
-    ring_buffer_t *rb = malloc(sizeof(ring_buffer_t));
+    ring_buffer_t *rb = calloc(1, sizeof(ring_buffer_t));
     if (!rb) return NULL;
-    
-    RingbufferType_t type = item_mode ? RINGBUF_TYPE_NOSPLIT : RINGBUF_TYPE_BYTEBUF;
-    
+
+    bool in_psram = false;
 #if CONFIG_SPIRAM_USE_MALLOC
     // If PSRAM is allowed, try PSRAM first
     if (allow_psram) {
-        // Must use xRingbufferCreateStatic or xRingbufferCreateWithCaps if available
-        // But ESP-IDF 5.2 has xRingbufferCreateWithCaps
-        rb->handle = xRingbufferCreateWithCaps(size, type, MALLOC_CAP_SPIRAM);
-        if (rb->handle) {
-             ESP_LOGI(TAG, "Ring buffer created in PSRAM: %u bytes, mode=%s", (unsigned)size, 
-                      item_mode ? "ITEM" : "BYTE");
-             rb->consumer = NULL;
-             return rb;
+        rb->storage = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        in_psram = rb->storage != NULL;
+        if (!in_psram) {
+            ESP_LOGW(TAG, "PSRAM allocation failed for %u bytes, falling back to internal RAM", (unsigned)size);
         }
-        ESP_LOGW(TAG, "PSRAM allocation failed for %u bytes, falling back to internal RAM", (unsigned)size);
     }
+#else
+    (void)allow_psram;
 #endif
-
-    rb->handle = xRingbufferCreate(size, type);
-    if (!rb->handle) {
-        free(rb);
+    if (!rb->storage) {
+        rb->storage = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    rb->lock = xSemaphoreCreateMutex();
+    if (!rb->storage || !rb->lock) {
+        ring_buffer_destroy(rb);
         return NULL;
     }
-    
-    rb->consumer = NULL;
-    
-    ESP_LOGI(TAG, "Ring buffer created in SRAM: %u bytes, mode=%s", (unsigned)size, 
-             item_mode ? "ITEM" : "BYTE");
+
+    latency_queue_init(&rb->queue, rb->storage, size, 0);
+
+    ESP_LOGI(TAG, "Ring buffer created in %s: %u bytes, mode=%s", in_psram ? "PSRAM" : "SRAM",
+             (unsigned)size, item_mode ? "ITEM" : "BYTE");
     return rb;
 }
 
 void ring_buffer_destroy(ring_buffer_t *rb) {
     if (rb) {
-        if (rb->handle) {
-            vRingbufferDelete(rb->handle);
+        if (rb->lock) {
+            vSemaphoreDelete(rb->lock);
         }
+        heap_caps_free(rb->storage);
         free(rb);
     }
 }
@@ -71,97 +75,101 @@ void ring_buffer_set_consumer(ring_buffer_t *rb, TaskHandle_t consumer) {
     }
 }
 
+void ring_buffer_set_latency_budget(ring_buffer_t *rb, uint32_t budget_ms) {
+    if (!rb) return;
+    xSemaphoreTake(rb->lock, portMAX_DELAY);
+    latency_queue_set_max_age(&rb->queue, (int64_t)budget_ms * 1000);
+    xSemaphoreGive(rb->lock);
+}
+
 esp_err_t ring_buffer_write(ring_buffer_t *rb, const uint8_t *data, size_t len) {
-    if (!rb || !rb->handle) return ESP_ERR_INVALID_ARG;
-    
-    if (xRingbufferSend(rb->handle, data, len, pdMS_TO_TICKS(10)) != pdTRUE) {
+    if (!rb || !data) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(rb->lock, portMAX_DELAY);
+    bool stored = latency_queue_push(&rb->queue, data, len, esp_timer_get_time());
+    xSemaphoreGive(rb->lock);
+    if (!stored) {
         return ESP_ERR_NO_MEM;
     }
-    
+
     // Notify consumer task that data is available (event-driven)
     if (rb->consumer) {
         xTaskNotifyGive(rb->consumer);
     }
-    
+
     return ESP_OK;
 }
 
 esp_err_t ring_buffer_read(ring_buffer_t *rb, uint8_t *data, size_t len) {
-    if (!rb || !rb->handle) return ESP_ERR_INVALID_ARG;
-    
-    size_t item_size = 0;
-    // CRITICAL: Use xRingbufferReceiveUpTo for BYTEBUF to avoid discarding extra bytes!
-    // xRingbufferReceive returns ALL contiguous bytes, but ReturnItem frees them ALL.
-    // ReceiveUpTo limits to exactly `len` bytes, preserving remaining data.
-    uint8_t *item = xRingbufferReceiveUpTo(rb->handle, &item_size, 0, len);
-    
-    if (!item) {
-        return ESP_ERR_NOT_FOUND;
-    }
-    
-    memcpy(data, item, item_size);
-    vRingbufferReturnItem(rb->handle, item);
-    
-    return ESP_OK;
+    if (!rb || !data) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(rb->lock, portMAX_DELAY);
+    bool ok = latency_queue_read(&rb->queue, data, len, esp_timer_get_time());
+    xSemaphoreGive(rb->lock);
+    return ok ? ESP_OK : ESP_ERR_NOT_FOUND;
 }
 
 esp_err_t ring_buffer_read_blocking(ring_buffer_t *rb, uint8_t *data, size_t len, TickType_t timeout) {
-    if (!rb || !rb->handle) return ESP_ERR_INVALID_ARG;
-    
+    if (!rb || !data) return ESP_ERR_INVALID_ARG;
+
     TickType_t start = xTaskGetTickCount();
     TickType_t remaining = timeout;
-    
+
     while (remaining > 0 || timeout == portMAX_DELAY) {
+        if (ring_buffer_read(rb, data, len) == ESP_OK) {
+            return ESP_OK;
+        }
+
         // Wait for notification from producer
         uint32_t notified = ulTaskNotifyTake(pdTRUE, remaining);
-        
         if (notified == 0 && timeout != portMAX_DELAY) {
-            // Timeout expired
-            return ESP_ERR_TIMEOUT;
-        }
-        
-        // Check if enough data is available
-        if (ring_buffer_available(rb) >= len) {
-            size_t item_size = 0;
-            uint8_t *item = xRingbufferReceiveUpTo(rb->handle, &item_size, 0, len);
-            
-            if (item && item_size == len) {
-                memcpy(data, item, len);
-                vRingbufferReturnItem(rb->handle, item);
-                return ESP_OK;
-            }
-            
-            if (item) {
-                vRingbufferReturnItem(rb->handle, item);
-            }
+            return ring_buffer_read(rb, data, len) == ESP_OK ? ESP_OK : ESP_ERR_TIMEOUT;
         }
-        
+
         // Update remaining time
         if (timeout != portMAX_DELAY) {
             TickType_t elapsed = xTaskGetTickCount() - start;
             remaining = (elapsed < timeout) ? (timeout - elapsed) : 0;
         }
     }
-    
+
     return ESP_ERR_TIMEOUT;
 }
 
 size_t ring_buffer_available(ring_buffer_t *rb) {
-    if (!rb || !rb->handle) return 0;
-    
-    UBaseType_t waiting;
-    vRingbufferGetInfo(rb->handle, NULL, NULL, NULL, NULL, &waiting);
-    return waiting;
+    if (!rb) return 0;
+
+    xSemaphoreTake(rb->lock, portMAX_DELAY);
+    latency_queue_expire(&rb->queue, esp_timer_get_time());
+    size_t available = latency_queue_available(&rb->queue);
+    xSemaphoreGive(rb->lock);
+    return available;
 }
 
 uint8_t* ring_buffer_receive_item(ring_buffer_t *rb, size_t *item_size) {
-    if (!rb || !rb->handle || !item_size) return NULL;
-    
-    return (uint8_t*)xRingbufferReceive(rb->handle, item_size, 0);
+    if (!rb || !item_size) return NULL;
+
+    // The item stays in place until ring_buffer_return_item; the queue will not
+    // evict it meanwhile, so it is safe to use outside the lock.
+    xSemaphoreTake(rb->lock, portMAX_DELAY);
+    const uint8_t *item = latency_queue_peek(&rb->queue, item_size, esp_timer_get_time());
+    xSemaphoreGive(rb->lock);
+    return (uint8_t *)item;
 }
 
 void ring_buffer_return_item(ring_buffer_t *rb, uint8_t *item) {
-    if (rb && rb->handle && item) {
-        vRingbufferReturnItem(rb->handle, item);
+    if (rb && item) {
+        xSemaphoreTake(rb->lock, portMAX_DELAY);
+        latency_queue_release(&rb->queue, esp_timer_get_time());
+        xSemaphoreGive(rb->lock);
     }
 }
+
+esp_err_t ring_buffer_get_stats(ring_buffer_t *rb, latency_queue_stats_t *stats, bool reset) {
+    if (!rb || !stats) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(rb->lock, portMAX_DELAY);
+    latency_queue_get_stats(&rb->queue, stats, reset);
+    xSemaphoreGive(rb->lock);
+    return ESP_OK;
+}
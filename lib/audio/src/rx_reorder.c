@@ -0,0 +1,133 @@
+#include "audio/rx_reorder.h"
+
+#include <string.h>
+
+#define REORDER_SLOT(r, seq) (&(r)->slots[(uint16_t)(seq) % RX_REORDER_SLOTS])
+
+void rx_reorder_init(rx_reorder_t *r, uint32_t hold_ms, uint8_t max_conceal, uint8_t max_stale)
+{
+    memset(r, 0, sizeof(*r));
+    r->hold_ms = hold_ms;
+    r->max_conceal = max_conceal;
+    r->max_stale = max_stale;
+}
+
+static void rx_reorder_clear(rx_reorder_t *r, uint16_t next_seq)
+{
+    for (int i = 0; i < RX_REORDER_SLOTS; i++) {
+        r->slots[i].used = false;
+    }
+    r->held = 0;
+    r->conceal_run = 0;
+    r->flushing = false;
+    r->next_seq = next_seq;
+    r->newest_seq = next_seq;
+}
+
+static void rx_reorder_advance(rx_reorder_t *r, uint16_t to)
+{
+    r->next_seq = to;
+    if (r->flushing && (int16_t)(r->next_seq - r->flush_to) >= 0) {
+        r->flushing = false;
+    }
+}
+
+rx_reorder_push_t rx_reorder_push(rx_reorder_t *r, uint16_t seq, const uint8_t *data, uint16_t len, int64_t now_ms)
+{
+    if (!data || len == 0 || len > OPUS_MAX_FRAME_BYTES) {
+        return RX_REORDER_INVALID;
+    }
+    if (!r->started) {
+        r->started = true;
+        rx_reorder_clear(r, seq);
+    }
+
+    int16_t delta = (int16_t)(seq - r->next_seq);
+    if (delta < 0) {
+        if ((uint16_t)(-delta) <= r->max_stale) {
+            r->stats.late++;
+            return RX_REORDER_LATE;
+        }
+        r->stats.resets++;
+        rx_reorder_clear(r, seq);
+        delta = 0;
+    }
+    if (delta >= RX_REORDER_SLOTS) {
+        // Everything before seq leaves now, held or not.
+        r->flushing = true;
+        r->flush_to = seq;
+        return RX_REORDER_FULL;
+    }
+
+    rx_reorder_slot_t *slot = REORDER_SLOT(r, seq);
+    if (slot->used) {
+        r->stats.duplicates++;
+        return RX_REORDER_DUPLICATE;
+    }
+    if (r->held == 0 || (int16_t)(seq - r->newest_seq) > 0) {
+        r->newest_seq = seq;
+    } else {
+        r->stats.repaired++;
+    }
+    slot->used = true;
+    slot->seq = seq;
+    slot->len = len;
+    slot->arrival_ms = now_ms;
+    memcpy(slot->data, data, len);
+    r->held++;
+    return RX_REORDER_ACCEPTED;
+}
+
+rx_reorder_pop_t rx_reorder_pop(rx_reorder_t *r, int64_t now_ms, uint16_t *seq, const uint8_t **data, uint16_t *len)
+{
+    while (r->held > 0 || r->flushing) {
+        rx_reorder_slot_t *slot = REORDER_SLOT(r, r->next_seq);
+        if (slot->used) {
+            slot->used = false;
+            r->held--;
+            r->conceal_run = 0;
+            *seq = slot->seq;
+            *data = slot->data;
+            *len = slot->len;
+            rx_reorder_advance(r, (uint16_t)(r->next_seq + 1));
+            return RX_REORDER_FRAME;
+        }
+
+        // next_seq is missing and later frames wait on it. The gap is known
+        // since the first of them arrived.
+        if (!r->flushing) {
+            int64_t first_arrival_ms = now_ms;
+            for (int i = 0; i < RX_REORDER_SLOTS; i++) {
+                if (r->slots[i].used && r->slots[i].arrival_ms < first_arrival_ms) {
+                    first_arrival_ms = r->slots[i].arrival_ms;
+                }
+            }
+            if (now_ms - first_arrival_ms < (int64_t)r->hold_ms) {
+                return RX_REORDER_NONE;
+            }
+        }
+
+        if (r->conceal_run < r->max_conceal) {
+            r->conceal_run++;
+            r->stats.concealed++;
+            *seq = r->next_seq;
+            *data = NULL;
+            *len = 0;
+            rx_reorder_advance(r, (uint16_t)(r->next_seq + 1));
+            return RX_REORDER_CONCEAL;
+        }
+
+        // Past the conceal cap: jump to the next held frame.
+        uint16_t target = r->flush_to;
+        for (uint16_t off = 1; off < RX_REORDER_SLOTS; off++) {
+            if (REORDER_SLOT(r, r->next_seq + off)->used) {
+                target = (uint16_t)(r->next_seq + off);
+                break;
+            }
+        }
+        r->stats.skipped += (uint16_t)(target - r->next_seq);
+        r->conceal_run = 0;
+        rx_reorder_advance(r, target);
+    }
+    return RX_REORDER_NONE;
+}
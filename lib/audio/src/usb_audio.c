@@ -26,8 +26,9 @@ static esp_err_t usb_audio_output_cb(uint8_t *buf, size_t len, void *cb_ctx) {
         return ESP_ERR_INVALID_STATE;
     }
 
+    // A full ring evicts its oldest audio; only a packet larger than the ring fails.
     if (ring_buffer_write(s_usb_audio_buffer, buf, len) != ESP_OK) {
-        ESP_LOGW(TAG, "USB ring buffer full, dropping %u bytes", (unsigned)len);
+        ESP_LOGW(TAG, "USB ring buffer rejected %u bytes", (unsigned)len);
         return ESP_ERR_NO_MEM;
     }
 
@@ -48,6 +49,7 @@ esp_err_t usb_audio_init(void) {
                      (unsigned)USB_AUDIO_BUFFER_BYTES);
             return ESP_ERR_NO_MEM;
         }
+        ring_buffer_set_latency_budget(s_usb_audio_buffer, USB_AUDIO_QUEUE_BUDGET_MS);
     }
 
     if (!s_usb_uac_registered) {
@@ -121,6 +123,16 @@ esp_err_t usb_audio_read_stereo(int16_t *stereo_buffer, size_t max_frames, size_
 #endif
 }
 
+esp_err_t usb_audio_get_queue_stats(latency_queue_stats_t *stats, bool reset) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_usb_audio_buffer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return ring_buffer_get_stats(s_usb_audio_buffer, stats, reset);
+}
+
 bool usb_audio_is_ready(void) {
     return s_usb_runtime_ready;
 }
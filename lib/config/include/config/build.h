@@ -98,8 +98,13 @@
 // USB input capture/runtime policy (SRC USB mode)
 #define USB_AUDIO_BUFFER_MS                  200
 #define USB_AUDIO_FRAME_BYTES_STEREO         (AUDIO_CHANNELS_STEREO * AUDIO_BYTES_PER_SAMPLE)
+// Each UAC callback is one ring item with its own queue header. Size for the
+// smallest delivery, one full-speed USB frame (1ms), so batching never costs depth.
+#define USB_AUDIO_PACKET_MS                  1
+#define USB_AUDIO_PACKET_BYTES \
+    (((AUDIO_SAMPLE_RATE * USB_AUDIO_PACKET_MS) / 1000) * USB_AUDIO_FRAME_BYTES_STEREO)
 #define USB_AUDIO_BUFFER_BYTES \
-    (((AUDIO_SAMPLE_RATE * USB_AUDIO_BUFFER_MS) / 1000) * USB_AUDIO_FRAME_BYTES_STEREO)
+    ((USB_AUDIO_PACKET_BYTES + AUDIO_QUEUE_ITEM_OVERHEAD) * (USB_AUDIO_BUFFER_MS / USB_AUDIO_PACKET_MS))
 #define USB_AUDIO_INACTIVITY_TIMEOUT_MS      1500
 #define USB_AUDIO_INACTIVITY_CONFIRM_MS      300
 #define USB_AUDIO_INACTIVITY_TIMEOUT_FRAMES \
@@ -141,7 +146,12 @@
 // RF power in quarter-dBm units (80 = 20 dBm max, 52 = 13 dBm).
 // In very close-range setups, reducing TX power can prevent receiver saturation/auth churn.
 #define WIFI_TX_POWER_QDBM     52
-#define UDP_PORT               3333
+#define UDP_PORT               3333      // Default root port of the host UDP transport (test/native/shared)
+#define UDP_TRANSPORT_MAX_PEERS 16       // Children a host UDP root tracks (learned from their datagrams)
+// Host impairment emulator (test/native/shared/impairment.h), native tests only.
+#define NET_IMPAIR_MAX_INFLIGHT        64   // Packets queued awaiting delivery
+#define NET_IMPAIR_MAX_JITTER_SAMPLES  32   // Empirical jitter table size
+#define NET_IMPAIR_MAX_SCHEDULE_STEPS  16   // "impair" steps kept from one fault schedule
 // Mesh packet batching: combine N Opus frames per mesh packet to reduce mesh pps.
 // With GROUP multicast: 50fps / N = total mesh packets/sec (no per-child multiply)
 // CRITICAL TRADEOFF:
@@ -151,6 +161,12 @@
 #define MESH_FRAMES_PER_PACKET     2   // 2 frames per packet = 25 pps; sweet spot for reliability vs overhead
 #define MESH_OPUS_BATCH_MAX_BYTES  (MESH_FRAMES_PER_PACKET * (2 + OPUS_MAX_FRAME_BYTES))  // 1028 bytes
 #define MAX_PACKET_SIZE            (NET_FRAME_HEADER_SIZE + MESH_OPUS_BATCH_MAX_BYTES)
+// Audio header version on the wire. v2 drops the per-packet src_id (26 -> 11 bytes);
+// receivers decode v1 and v2, so set 1 only while pre-v2 OUT firmware is in the fleet.
+#define NET_FRAME_TX_VERSION       2
+#define NET_FRAME_V2_MAX_STREAMS   MIXER_MAX_STREAMS  // Receiver-side stream_id -> src_id slots
+#define STREAM_ANNOUNCE_INTERVAL_MS 5000              // SRC re-announces so late joiners can resolve v2
+#define STREAM_ANNOUNCE_START_PACKETS 4             // Announced ahead of each of a stream's first packets (v2 RX drops until anchored)
 // Demo transport baseline selected from 2026-03-29 send-mode A/B artifact.
 // Root fanout runs with MESH_DATA_GROUP | MESH_DATA_NONBLOCK in mesh_tx.c.
 #define TRANSPORT_SETTINGS_PROFILE_ID "baseline-current"
@@ -193,12 +209,23 @@
 #define PCM_BUFFER_FRAMES          16    // 16 × 20ms = 320ms PCM buffer (memory-safe limit)
 #define OPUS_BUFFER_FRAMES         16    // 16 × 20ms = 320ms compressed burst tolerance
 
-// Derived: buffer sizes in bytes
-#define PCM_BUFFER_SIZE            (AUDIO_FRAME_BYTES_INTERNAL_MONO * PCM_BUFFER_FRAMES)
+// Derived: buffer sizes in bytes. Every queued item carries a 16-byte
+// enqueue-time header (LATENCY_QUEUE_ITEM_OVERHEAD in audio/latency_queue.h).
+#define AUDIO_QUEUE_ITEM_OVERHEAD  16
+#define PCM_BUFFER_SIZE            ((AUDIO_FRAME_BYTES_INTERNAL_MONO + AUDIO_QUEUE_ITEM_OVERHEAD) * PCM_BUFFER_FRAMES)
 
-// Opus buffer includes 2-byte length prefix per frame
-#define OPUS_BUFFER_ITEM_MAX       (3 + OPUS_MAX_FRAME_BYTES)  // flags + len + payload
-#define OPUS_BUFFER_SIZE           (OPUS_BUFFER_ITEM_MAX * OPUS_BUFFER_FRAMES)  // 4112
+// Opus buffer items: [flags:1][seq:2][ts:4][len:2] + payload
+#define OPUS_BUFFER_ITEM_MAX       (9 + OPUS_MAX_FRAME_BYTES)
+#define OPUS_BUFFER_SIZE           ((OPUS_BUFFER_ITEM_MAX + AUDIO_QUEUE_ITEM_OVERHEAD) * OPUS_BUFFER_FRAMES)
+
+// Per-queue latency budgets: consumers drop items older than this, producers
+// evict the oldest item when a queue is full, so no queue can hold audio longer
+// than its budget. The sum bounds the queueing part of mouth-to-ear latency.
+#define USB_AUDIO_QUEUE_BUDGET_MS  (5 * AUDIO_FRAME_MS)     // host → capture
+#define TX_PCM_QUEUE_BUDGET_MS     (3 * AUDIO_FRAME_MS)     // capture → encode
+#define RX_OPUS_QUEUE_BUDGET_MS    (4 * AUDIO_FRAME_MS)     // mesh RX → decode
+#define RX_PCM_QUEUE_BUDGET_MS     (JITTER_BUFFER_FRAMES * AUDIO_FRAME_MS)  // decode → playout
+#define AUDIO_QUEUE_LATENCY_CEILING_MS 480
 
 // Jitter buffer (in codec frames)
 // Priority is smooth, uninterrupted playback under multi-node contention.
@@ -214,6 +241,11 @@
 // Drop packets that arrive this many frames behind the latest accepted sequence.
 // Larger backward jumps are treated as sequence discontinuities (new baseline).
 #define RX_MAX_STALE_FRAMES_TO_DROP 24
+// Reorder hold ahead of decode: a gap waits this long for its retransmit before
+// it is concealed. The gap is seen one packet after the loss, and the root only
+// resends while the copy lands within MESH_RETX_PLAYOUT_BUDGET_MS of the send.
+#define RX_REORDER_HOLD_MS          (MESH_RETX_PLAYOUT_BUDGET_MS - MESH_FRAMES_PER_PACKET * AUDIO_FRAME_MS)  // 80ms
+#define RX_REORDER_SLOTS            8    // 8 × 20ms: the hold plus one packet in flight
 // Decode fairness cap: limit RX decode bursts per scheduler slice to avoid CPU monopolization.
 #define RX_DECODE_MAX_ITEMS_PER_CYCLE 8
 // Stop decoding when PCM queue is near full so playback cadence can drain without catch-up bursts.
@@ -274,6 +306,64 @@
 #define MESH_RX_BUFFER_SIZE  1500      // MTU-sized receive buffer
 #define DEDUPE_CACHE_SIZE    256       // Sequence deduplication cache
 
+// Raw RX capture (network/rx_capture.h): OUT nodes record every received mesh
+// packet and dump the ring over serial on the first burst loss. ~9 KB/s at 25 pps.
+#define RX_CAPTURE_ENABLED             0
+#define RX_CAPTURE_RING_BYTES          (512 * 1024)  // PSRAM: ~55 s of traffic
+#define RX_CAPTURE_RING_BYTES_INTERNAL (24 * 1024)   // Without PSRAM: ~2.5 s
+#define RX_CAPTURE_SNAPLEN             MESH_RX_BUFFER_SIZE
+#define RX_CAPTURE_ARM_MS              10000     // Fill this long before a burst loss can trigger a dump
+#define RX_CAPTURE_DUMP_TASK_STACK     (3 * 1024)
+#define RX_CAPTURE_DUMP_TASK_PRIO      1         // Below everything that plays audio
+
+// Root per-child link table (open addressing, linear probing). Power of two,
+// kept <= ~80% full at MESH_ROUTE_TABLE_SIZE nodes.
+#define MESH_LINK_TABLE_CAPACITY  64
+#define MESH_LINK_STALE_MS        30000     // Drop entries with no heartbeat/pong for this long
+
+// Ping service: pings run continuously (parent toward root, root round-robin over
+// children) with several IDs in flight; latency consumers read the window median.
+#define MESH_PING_INTERVAL_MS     1000
+#define MESH_PING_TIMEOUT_MS      2000
+#define MESH_PING_MAX_INFLIGHT    4
+#define MESH_RTT_WINDOW_SAMPLES   32        // ~30s of upstream samples at 1 Hz
+
+// Sharded statistics counters (transport and pipeline stats). Each writer task
+// owns a shard; the last one is shared by any writers beyond that.
+#define STAT_COUNTER_SHARDS       8
+#define STAT_COUNTER_MAX_WORDS    80        // Largest stats struct, in uint32_t words
+#define STAT_COUNTER_MAX_GAUGES   8
+#define STAT_SNAPSHOT_RETRIES     16        // Seqlock retries per shard before accepting a copy
+#define STAT_RATE_TICK_MS         1000      // Rate sampling period (1 s window)
+
+// Shared ref-counted packet buffers (RX, TX builder, retransmit cache).
+// Sized for a full retransmit cache plus in-flight RX/TX and a held callback ref.
+#define MESH_PKT_BUF_SIZE    MESH_RX_BUFFER_SIZE
+#define MESH_PKT_POOL_SIZE   (MESH_RETX_CACHE_SLOTS + 4)
+
+// Selective retransmit: root keeps recent audio packets, OUT nodes NACK gaps.
+// A retransmit is only sent if it can still land inside the receiver prefill.
+#define MESH_RETX_CACHE_SLOTS        8         // 8 packets x 40ms = 320ms of history
+#define MESH_RETX_PLAYOUT_BUDGET_MS  (JITTER_PREFILL_FRAMES * AUDIO_FRAME_MS)  // 120ms
+#define MESH_RETX_DEFAULT_ONE_WAY_MS 10        // Used until a child ping has completed
+#define MESH_RETX_RATE_WINDOW_MS     1000
+#define MESH_RETX_MAX_PER_WINDOW     25        // Root cap: at most ~1 extra packet per 40ms
+#define MESH_NACK_RATE_WINDOW_MS     1000
+#define MESH_NACK_MAX_PER_WINDOW     10        // OUT cap: protects the uplink from NACK storms
+#define MESH_NACK_MAX_GAP_FRAMES     33        // base_seq + 32-bit bitmap; larger gaps are resets
+
+// Root fanout policy (mesh_fanout.c): P2P vs GROUP chosen from delivery evidence.
+// Switches need MESH_FANOUT_SWITCH_WINDOWS agreeing windows and a minimum dwell.
+#define MESH_FANOUT_P2P_MAX_CHILDREN    10     // More descendants always use GROUP (airtime)
+#define MESH_FANOUT_P2P_RETURN_CHILDREN 8      // Size-driven GROUP returns to P2P at or below this
+#define MESH_FANOUT_WINDOW_MS           1000
+#define MESH_FANOUT_SWITCH_WINDOWS      3
+#define MESH_FANOUT_MIN_DWELL_MS        5000
+#define MESH_FANOUT_QFULL_ENTER_PCT     10     // P2P sends hitting QUEUE_FULL -> GROUP
+#define MESH_FANOUT_QFULL_STREAK        8      // Consecutive saturated packets -> GROUP now
+#define MESH_FANOUT_LOSS_ENTER_PCT      5      // NACKed frames under GROUP -> P2P
+#define MESH_FANOUT_P2P_COOLDOWN_MS     30000  // Don't retry P2P this soon after it saturated
+
 // ============================================================================
 // Control Layer Configuration
 // ============================================================================
@@ -283,12 +373,21 @@
 #define CONTROL_STATE_CACHE_TTL_MS   120000
 #define CONTROL_STATE_CACHE_MAX_NODES 32
 
+// Control-plane coalescing: messages queued within one tick go out as a single
+// bundle per destination. Relays fold their subtree's heartbeats into their own
+// upstream heartbeat bundle.
+#define CONTROL_COALESCE_TICK_MS     20           // Max added latency for a queued control message
+#define CONTROL_BUNDLE_MAX_BYTES     1024         // Leaves MESH_RX_BUFFER_SIZE headroom
+#define CONTROL_DIGEST_MAX_NODES     16           // Subtree heartbeats a relay holds between sends
+#define CONTROL_DIGEST_MAX_AGE_MS    12000        // ~2 heartbeat intervals; older entries are dropped
+
 // ============================================================================
 // Portal Configuration (TX/COMBO only)
 // ============================================================================
 
 #define PORTAL_HTTP_STACK_BYTES      (6 * 1024)
 #define PORTAL_WS_PUSH_STACK_BYTES   (4 * 1024)
+#define PORTAL_METER_STACK_BYTES     (3 * 1024)
 #define PORTAL_DNS_STACK_BYTES       (3 * 1024)
 #define PORTAL_OTA_STACK_BYTES       (8 * 1024)
 #define PORTAL_MIN_FREE_HEAP         (36 * 1024)  // Skip portal if free heap is too low
@@ -299,6 +398,14 @@
 #define PORTAL_STATUS_SCHEMA_VERSION 1            // /api/status schema version
 #define PORTAL_CONTROL_METRICS_SCHEMA_VERSION 1   // /api/control/metrics schema version
 #define PORTAL_CONTROL_METRICS_JSON_BUF_SIZE 512  // /api/control/metrics response buffer (worst-case payload < 400B)
+#define PORTAL_ASSETS_PARTITION      "portal"     // Raw data partition holding the packed portal UI
+#define PORTAL_ASSETS_SUBTYPE        0x40         // Custom data subtype of that partition (partitions.csv)
+#define PORTAL_ASSET_PATH_MAX        64           // Longest asset path looked up, query string excluded
+#define PORTAL_JSON_CHUNK_BYTES      256          // Streamed JSON: bytes per HTTP chunk / WebSocket fragment
+#define PORTAL_WS_MAX_CLIENTS        4            // Concurrent /ws subscribers; more are refused
+#define PORTAL_WS_MAX_RX_BYTES       128          // Largest client frame accepted (subscription requests)
+#define PORTAL_WS_SEND_WAIT_MS       20           // Longest wait for a /ws socket mid-message before the session is closed
+#define PORTAL_METER_INTERVAL_MS     (AUDIO_FRAME_MS * FFT_UPDATE_INTERVAL_FRAMES)  // /ws/meters rate, one frame per FFT update
 #define PORTAL_CONTROL_RATE_LIMIT_WINDOW_MS 5000  // 5s rate limit window
 #define PORTAL_CONTROL_RATE_LIMIT_MAX_REQUESTS 10 // Max 10 requests per window
 #define PORTAL_CDC_LOG_MIRROR_ENABLED 1           // Mirror ESP logs to TinyUSB CDC ACM channel 0
@@ -339,6 +446,9 @@
 #define MIXER_STREAM_GAIN_MIN_PCT      0
 #define MIXER_STREAM_GAIN_DEFAULT_PCT  100
 #define MIXER_STREAM_GAIN_MAX_PCT      400
+#define MIXER_PUBLISH_COALESCE_MS      50     // Slider bursts -> one mesh update per window
+#define MIXER_SYNC_REQUEST_MIN_MS      1000   // Gap-triggered full-sync requests, at most this often
+#define MIXER_VERSION_BEACON_MS        5000   // Root re-announces its state version; heals a lost last delta
 
 // ============================================================================
 // Memory Monitoring Thresholds
@@ -350,6 +460,33 @@
 #define MEMORY_MONITOR_TASK_STACK    MEMORY_MONITOR_TASK_STACK_BYTES
 #define MEMORY_MONITOR_TASK_PRIO     1
 
+// ============================================================================
+// Telemetry Snapshot
+// One task samples mesh, heap, transport and pipeline state at a fixed cadence
+// and publishes an immutable snapshot; portal, display and dashboard read it.
+// ============================================================================
+
+#define TELEMETRY_PUBLISH_INTERVAL_MS 250
+#define TELEMETRY_TASK_STACK_BYTES   (3 * 1024)
+#define TELEMETRY_TASK_PRIO          2
+#define TELEMETRY_TASK_HEADROOM      8            // Task status slots beyond the live count, for tasks created meanwhile
+
+// ============================================================================
+// OLED Display & Dashboard Rendering
+// Frames send only the pages that changed. The mode/orientation commands are
+// re-sent on a slow timer (EMI recovery), followed by one full repaint.
+// A priority-1 renderer task draws display and dashboard off the main loop.
+// ============================================================================
+
+#define DISPLAY_REINFORCE_INTERVAL_MS 2000
+#define RENDERER_FRAME_MS            100    // Display frame rate (10 fps)
+#define RENDERER_DASHBOARD_MS        1000   // Serial dashboard block
+#define RENDERER_MAX_IDLE_MS         1000   // Redraw an unchanged screen at least this often
+#define RENDERER_TASK_STACK_BYTES    (4 * 1024)
+#define RENDERER_TASK_PRIO           1
+#define RENDERER_TASK_CORE           0      // Off the audio core
+#define MAIN_LOOP_PERIOD_MS          1000   // app_main: watchdog and housekeeping only
+
 // ============================================================================
 // Battery Monitoring
 // Requires external voltage divider: BAT+ → R1 → GPIO4 → R2 → GND
@@ -401,12 +538,29 @@ _Static_assert(RX_UNDERRUN_REBUFFER_MISSES >= (RX_UNDERRUN_CONCEAL_FRAMES + RX_U
                "RX_UNDERRUN_REBUFFER_MISSES must allow conceal+fade before forced rebuffer");
 
 // Jitter target must fit in the actual PCM ring buffer capacity
+_Static_assert(RX_REORDER_HOLD_MS < JITTER_PREFILL_FRAMES * AUDIO_FRAME_MS &&
+               RX_REORDER_SLOTS * AUDIO_FRAME_MS >= RX_REORDER_HOLD_MS + MESH_FRAMES_PER_PACKET * AUDIO_FRAME_MS,
+               "RX reorder hold must fit the prefill, and its slots must cover the hold");
+
 _Static_assert(JITTER_BUFFER_FRAMES <= PCM_BUFFER_FRAMES,
                "JITTER_BUFFER_FRAMES must be <= PCM_BUFFER_FRAMES");
 
 _Static_assert(RX_PCM_HIGH_WATER_FRAMES >= JITTER_PREFILL_FRAMES,
                "RX_PCM_HIGH_WATER_FRAMES must stay above startup prefill");
 
+// Queue budgets must cover the depth the pipeline deliberately holds, and their
+// sum is the proven queueing ceiling reported by adf_pipeline_get_stats().
+_Static_assert(RX_PCM_QUEUE_BUDGET_MS >= (JITTER_PREFILL_FRAMES + 1) * AUDIO_FRAME_MS,
+               "RX_PCM_QUEUE_BUDGET_MS must hold the startup prefill");
+
+_Static_assert(TX_PCM_QUEUE_BUDGET_MS >= 2 * AUDIO_FRAME_MS && RX_OPUS_QUEUE_BUDGET_MS >= 2 * AUDIO_FRAME_MS &&
+               USB_AUDIO_QUEUE_BUDGET_MS >= 2 * AUDIO_FRAME_MS,
+               "Queue latency budgets must allow at least one frame of scheduling slack");
+
+_Static_assert(USB_AUDIO_QUEUE_BUDGET_MS + TX_PCM_QUEUE_BUDGET_MS + RX_OPUS_QUEUE_BUDGET_MS +
+               RX_PCM_QUEUE_BUDGET_MS <= AUDIO_QUEUE_LATENCY_CEILING_MS,
+               "Per-queue latency budgets exceed AUDIO_QUEUE_LATENCY_CEILING_MS");
+
 #ifdef NET_FRAME_HEADER_SIZE
 // Network packet buffer sizing must include the largest supported batched Opus payload.
 _Static_assert(MAX_PACKET_SIZE >= (NET_FRAME_HEADER_SIZE + MESH_OPUS_BATCH_MAX_BYTES),
@@ -417,6 +571,24 @@ _Static_assert(MAX_PACKET_SIZE <= MESH_RX_BUFFER_SIZE,
                "MESH_RX_BUFFER_SIZE must be >= MAX_PACKET_SIZE");
 #endif
 
+// NACK bitmap covers base_seq plus 32 following sequences
+_Static_assert(MESH_NACK_MAX_GAP_FRAMES >= 1 && MESH_NACK_MAX_GAP_FRAMES <= 33,
+               "MESH_NACK_MAX_GAP_FRAMES must fit in mesh_nack_t bitmap");
+
+_Static_assert((MESH_LINK_TABLE_CAPACITY & (MESH_LINK_TABLE_CAPACITY - 1)) == 0,
+               "MESH_LINK_TABLE_CAPACITY must be a power of two");
+_Static_assert(MESH_LINK_TABLE_CAPACITY * 4 >= MESH_ROUTE_TABLE_SIZE * 5,
+               "MESH_LINK_TABLE_CAPACITY must keep the load factor <= 0.8");
+_Static_assert(MESH_PING_MAX_INFLIGHT * MESH_PING_INTERVAL_MS >= MESH_PING_TIMEOUT_MS,
+               "MESH_PING_MAX_INFLIGHT must cover pings outstanding until timeout");
+_Static_assert(STAT_COUNTER_SHARDS >= 2,
+               "STAT_COUNTER_SHARDS needs at least one owned shard plus the shared one");
+_Static_assert(CONTROL_BUNDLE_MAX_BYTES <= MESH_RX_BUFFER_SIZE,
+               "CONTROL_BUNDLE_MAX_BYTES must fit the mesh RX buffer");
+
+// v2 header packs ttl and frame_count into one nibble each
+_Static_assert(MESH_FRAMES_PER_PACKET <= 15, "MESH_FRAMES_PER_PACKET must fit the v2 header nibble");
+
 // DMA buffer size per descriptor must fit in hardware limit (4092 bytes)
 // For stereo 16-bit: 4 bytes per frame, so max ~1023 frames
 _Static_assert((I2S_DMA_CHUNK_SAMPLES * AUDIO_CHANNELS_STEREO * AUDIO_BYTES_PER_SAMPLE) <= 4092,
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read-only index over the portal asset bundle that tools/portal_bundle.py
+// packs from portal-ui/dist. The bundle is memory-mapped from the `portal`
+// partition and never copied: a lookup returns pointers into the mapping, so
+// a response is its precomputed headers plus one send of the stored body.
+//
+// Layout (little-endian, offsets from the bundle start):
+//   header   magic "SMPB", u16 version, u16 count, u32 total_size, u32 checksum
+//   entries  count x { u32 path, u32 type, u32 etag, u32 cache, u32 data,
+//                      u32 data_len, u32 flags }, sorted by path bytes
+//   strings  NUL-terminated, referenced by the entry offsets
+//   data     asset bodies
+// checksum is FNV-1a over bytes [ASSET_BUNDLE_HEADER_BYTES, total_size).
+
+#define ASSET_BUNDLE_MAGIC          "SMPB"
+#define ASSET_BUNDLE_VERSION        1
+#define ASSET_BUNDLE_HEADER_BYTES   16
+#define ASSET_BUNDLE_ENTRY_BYTES    28
+
+#define ASSET_BUNDLE_F_GZIP         0x01    // Body is gzip; send Content-Encoding: gzip
+
+typedef struct {
+    const uint8_t *base;
+    uint32_t size;
+    uint16_t count;
+} asset_bundle_t;
+
+typedef struct {
+    const char *path;           // "/index.html"
+    const char *content_type;
+    const char *etag;           // Quoted, ready for the ETag header
+    const char *cache_control;
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t flags;             // ASSET_BUNDLE_F_*
+} asset_bundle_entry_t;
+
+// Bundle size announced by a header, or 0 if hdr is not a bundle header.
+// Lets the caller map exactly the bundle rather than the whole partition.
+uint32_t asset_bundle_size(const uint8_t *hdr, size_t len);
+// Validates the header, checksum and every entry. False leaves b unusable.
+bool asset_bundle_open(asset_bundle_t *b, const void *base, size_t size);
+// Exact path match; the caller strips the query string.
+bool asset_bundle_find(const asset_bundle_t *b, const char *path, asset_bundle_entry_t *out);
+// True if an If-None-Match value (a list, W/ tags or *) names etag.
+bool asset_bundle_etag_matches(const char *if_none_match, const char *etag);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-core CPU load and the busiest tasks, from FreeRTOS run-time counters.
+// A core's load is what its idle task did not get. Reports cover the last
+// CPU_LOAD_BUCKET_MS bucket and the last CPU_LOAD_HISTORY buckets; counters
+// may wrap between samples.
+
+#define CPU_LOAD_MAX_CORES      2
+#define CPU_LOAD_MAX_TASKS      32
+#define CPU_LOAD_TOP_TASKS      4
+#define CPU_LOAD_NAME_LEN       16      // configMAX_TASK_NAME_LEN
+#define CPU_LOAD_CORE_ANY       0xFF    // Task not pinned to a core
+#define CPU_LOAD_BUCKET_MS      1000
+#define CPU_LOAD_HISTORY        10      // Closed buckets kept: the long window
+#define CPU_LOAD_WINDOW_COUNT   2       // Last bucket, then the whole history
+
+typedef struct {
+    uint32_t id;                // Unique per task for its lifetime (FreeRTOS task number)
+    const char *name;
+    uint8_t core;               // CPU_LOAD_CORE_ANY when not pinned
+    bool idle;                  // The idle task of core
+    uint32_t runtime;           // Accumulated run-time counter
+} cpu_load_task_sample_t;
+
+typedef struct {
+    char name[CPU_LOAD_NAME_LEN];
+    uint8_t core;
+    uint8_t pct;                // Share of one core over the window
+} cpu_load_top_t;
+
+typedef struct {
+    uint32_t window_ms;         // Measured span; 0 until the first bucket closes
+    uint8_t core_pct[CPU_LOAD_MAX_CORES];
+    uint8_t top_count;
+    cpu_load_top_t top[CPU_LOAD_TOP_TASKS];     // Busiest first, idle tasks excluded
+} cpu_load_window_t;
+
+typedef struct {
+    uint8_t cores;
+    cpu_load_window_t window[CPU_LOAD_WINDOW_COUNT];
+} cpu_load_report_t;
+
+// The ring has one open bucket besides the CPU_LOAD_HISTORY closed ones.
+#define CPU_LOAD_SLOTS (CPU_LOAD_HISTORY + 1)
+
+typedef struct {
+    uint32_t id;
+    char name[CPU_LOAD_NAME_LEN];
+    uint8_t core;
+    bool idle;
+    bool seen;                  // Present in the current sample
+    uint32_t last_runtime;
+    uint32_t run[CPU_LOAD_SLOTS];
+} cpu_load_entry_t;
+
+typedef struct {
+    uint8_t cores;
+    uint32_t bucket_ticks;      // Counter ticks per bucket
+    uint32_t ticks_per_ms;
+    bool started;
+    bool overflowed;            // Some task went untracked; new entries start from a baseline
+    uint32_t last_now;
+    uint8_t head;               // Open bucket
+    uint8_t closed;             // Closed buckets held, <= CPU_LOAD_HISTORY
+    uint32_t elapsed[CPU_LOAD_SLOTS];
+    uint32_t idle[CPU_LOAD_SLOTS][CPU_LOAD_MAX_CORES];
+    uint8_t task_count;
+    cpu_load_entry_t tasks[CPU_LOAD_MAX_TASKS];
+} cpu_load_t;
+
+// counter_hz is the rate of the run-time clock (1 MHz for esp_timer).
+void cpu_load_init(cpu_load_t *c, uint8_t cores, uint32_t counter_hz);
+
+// Feeds one reading of every task. The first sample only sets the baseline.
+// Tasks missing from a sample are forgotten; tasks past CPU_LOAD_MAX_TASKS
+// are not tracked.
+void cpu_load_sample(cpu_load_t *c, uint32_t now, const cpu_load_task_sample_t *tasks, size_t count);
+
+void cpu_load_report(const cpu_load_t *c, cpu_load_report_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,3 +8,6 @@ void display_clear(void);
 void display_render_src(display_view_t view, const src_status_t *status);
 void display_render_out(display_view_t view, const out_status_t *status);
 void display_show_message(const char *line1, const char *line2);
+// True when the view draws an animation, which changes every frame.
+bool display_animating_src(display_view_t view, const src_status_t *status);
+bool display_animating_out(display_view_t view, const out_status_t *status);
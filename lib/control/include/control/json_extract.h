@@ -4,6 +4,79 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Single-pass JSON tokenizer in the style of jsmn. json_parse walks the body
+// once and records every value into a caller-provided token array; nothing is
+// allocated and the body is not modified. Tokens are in document order and
+// each one knows where its subtree ends, so field lookups and array walks run
+// over the index instead of rescanning the text.
+
+#define JSON_MAX_DEPTH      16
+#define JSON_MAX_BODY_LEN   UINT16_MAX
+
+#define JSON_ERR_NOMEM  (-1)    // More tokens (or nesting) than the caller allowed
+#define JSON_ERR_INVAL  (-2)    // Not valid JSON
+#define JSON_ERR_PART   (-3)    // Truncated: ends inside a value
+
+typedef enum {
+    JSON_TOK_UNDEFINED = 0,
+    JSON_TOK_OBJECT,
+    JSON_TOK_ARRAY,
+    JSON_TOK_STRING,
+    JSON_TOK_PRIMITIVE,         // number, true, false or null
+} json_tok_type_t;
+
+#define JSON_TOK_F_KEY      0x01    // String used as an object member name
+#define JSON_TOK_F_ESCAPED  0x02    // String contains backslash escapes
+
+typedef struct {
+    uint8_t type;               // json_tok_type_t
+    uint8_t flags;              // JSON_TOK_F_*
+    uint16_t start;             // First byte; strings start after the opening quote
+    uint16_t end;               // One past the last byte; strings end at the closing quote
+    uint16_t size;              // Object members or array elements
+    uint16_t next;              // Index one past this token's subtree
+} json_tok_t;
+
+typedef struct {
+    const char *js;
+    uint16_t len;
+    uint16_t count;
+    const json_tok_t *toks;
+} json_doc_t;
+
+// Tokenizes js[0..len) (stopping early at a NUL) into toks. Returns the token
+// count, or a JSON_ERR_* code. Token 0 is the root value.
+int json_parse(json_doc_t *doc, const char *js, size_t len, json_tok_t *toks, uint16_t max_toks);
+
+// Walkers. Members of an object are visited by key: the value is key + 1.
+// All return -1 when there is nothing there.
+int json_first_child(const json_doc_t *doc, int tok);
+int json_next_sibling(const json_doc_t *doc, int parent, int tok);
+int json_object_get(const json_doc_t *doc, int obj, const char *key);
+int json_object_get_type(const json_doc_t *doc, int obj, const char *key, json_tok_type_t type);
+
+// Typed readers for a single token. Strings are unescaped; numbers must use
+// the whole token. False on a type mismatch, range error or truncation.
+bool json_tok_equals(const json_doc_t *doc, int tok, const char *str);
+bool json_tok_string(const json_doc_t *doc, int tok, char *out, size_t out_size);
+bool json_tok_bool(const json_doc_t *doc, int tok, bool *out);
+bool json_tok_uint16(const json_doc_t *doc, int tok, uint16_t *out);
+bool json_tok_int(const json_doc_t *doc, int tok, int *out);
+bool json_tok_float(const json_doc_t *doc, int tok, float *out);
+
+// Typed member accessors: json_object_get + the reader above.
+bool json_get_string(const json_doc_t *doc, int obj, const char *key, char *out, size_t out_size);
+bool json_get_bool(const json_doc_t *doc, int obj, const char *key, bool *out);
+bool json_get_uint16(const json_doc_t *doc, int obj, const char *key, uint16_t *out);
+bool json_get_int(const json_doc_t *doc, int obj, const char *key, int *out);
+bool json_get_float(const json_doc_t *doc, int obj, const char *key, float *out);
+
+// One-shot helpers for callers that read a single field: each call indexes the
+// body (up to JSON_EXTRACT_MAX_TOKENS on the stack) and returns the first
+// member named field anywhere in it. Prefer json_parse + json_get_* for more
+// than a field or two.
+#define JSON_EXTRACT_MAX_TOKENS 128
+
 bool json_extract_string_field(const char *body, const char *field, char *out, size_t out_size);
 bool json_extract_bool_field(const char *body, const char *field, bool *out);
 bool json_extract_uint16_field(const char *body, const char *field, uint16_t *out);
@@ -11,6 +84,8 @@ bool json_extract_float_field(const char *body, const char *field, float *out);
 bool json_extract_int_field(const char *body, const char *field, int *out);
 bool json_extract_array_field_span(
     const char *body, const char *field, const char **start_out, const char **end_out);
+bool json_extract_object_field_span(
+    const char *body, const char *field, const char **start_out, const char **end_out);
 bool json_extract_next_array_object_span(const char *array_start,
                                          const char *array_end,
                                          const char **cursor_io,
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming JSON writer. Output goes into a small caller-owned buffer. In
+// stream mode the buffer is handed to a sink (an HTTP chunk, a WebSocket
+// fragment) each time it fills, so a document of any length costs only the
+// buffer. In buffer mode the document must fit; anything past the end is
+// counted but dropped, and the result reports the full length the way
+// snprintf does. Commas, quoting, escaping and number formatting are done
+// here without printf.
+
+#define JSON_WRITER_MAX_DEPTH 16
+
+// Receives buf[0..len). final is set on the last call for the document (len
+// may be 0 then). Returns false to abort; the writer drops everything after.
+typedef bool (*json_writer_sink_t)(void *ctx, const char *data, size_t len, bool final);
+
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t used;                // Pending bytes in buf
+    size_t total;               // Bytes of document produced so far
+    json_writer_sink_t sink;    // NULL in buffer mode
+    void *ctx;
+    uint32_t has_items;         // Bit d: the container at depth d already has a member
+    uint32_t in_object;         // Bit d: the container at depth d is an object
+    uint8_t depth;
+    bool after_key;             // Next value belongs to the key just written
+    bool truncated;             // Buffer mode ran out of room
+    bool failed;                // Sink error or misuse (depth, missing or stray key)
+} json_writer_t;
+
+// Buffer mode: size includes room for the terminating NUL.
+void json_writer_init_buf(json_writer_t *w, char *buf, size_t size);
+// Stream mode: buf is scratch space flushed to sink as it fills.
+void json_writer_init_stream(json_writer_t *w, char *buf, size_t size, json_writer_sink_t sink, void *ctx);
+
+// Ends the document. Buffer mode NUL-terminates and returns the full length
+// (>= size when truncated). Stream mode makes the final sink call and returns
+// the bytes sent. -1 on a sink error or unbalanced containers.
+int json_writer_finish(json_writer_t *w);
+
+void json_writer_begin_object(json_writer_t *w);
+void json_writer_end_object(json_writer_t *w);
+void json_writer_begin_array(json_writer_t *w);
+void json_writer_end_array(json_writer_t *w);
+void json_writer_key(json_writer_t *w, const char *key);
+
+void json_writer_string(json_writer_t *w, const char *str);     // NULL writes null
+void json_writer_string_n(json_writer_t *w, const char *str, size_t len);
+void json_writer_uint(json_writer_t *w, uint64_t value);
+void json_writer_int(json_writer_t *w, int64_t value);
+void json_writer_bool(json_writer_t *w, bool value);
+void json_writer_null(json_writer_t *w);
+// Fixed-point with up to 6 decimals; trailing zeros are kept. NaN and
+// infinities (and magnitudes past int64 range) write null.
+void json_writer_float(json_writer_t *w, float value, uint8_t decimals);
+// Writes "AA:BB:CC:DD:EE:FF".
+void json_writer_mac(json_writer_t *w, const uint8_t mac[6]);
+// Pre-encoded JSON written verbatim as one value.
+void json_writer_raw(json_writer_t *w, const char *json, size_t len);
+
+// key + value in one call.
+void json_writer_field_string(json_writer_t *w, const char *key, const char *str);
+void json_writer_field_uint(json_writer_t *w, const char *key, uint64_t value);
+void json_writer_field_int(json_writer_t *w, const char *key, int64_t value);
+void json_writer_field_bool(json_writer_t *w, const char *key, bool value);
+void json_writer_field_float(json_writer_t *w, const char *key, float value, uint8_t decimals);
+void json_writer_field_mac(json_writer_t *w, const char *key, const uint8_t mac[6]);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/build.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary meter frame for the portal's /ws/meters stream. One frame carries
+// the spectrum as uint8 bins, Q15 peak/RMS per stream and the PCM buffer fill,
+// in a few dozen bytes instead of several hundred characters of JSON.
+//
+// Version 1 layout, little-endian:
+//   0   u8   magic 'M'
+//   1   u8   version (METER_FRAME_VERSION)
+//   2   u8   flags (METER_FRAME_F_*)
+//   3   u8   bin_count
+//   4   u16  seq (wraps)
+//   6   u32  ts_ms (sender uptime, wraps)
+//   10  u8   buffer_fill_pct (0-100)
+//   11  u8   stream_count
+//   12  u8   bins[bin_count]          0 = FFT_DB_FLOOR, 255 = FFT_DB_CEIL
+//   ..  stream_count x { u8 id, u16 peak_q15, u16 rms_q15 }
+// Newer versions may append fields after the streams; a decoder for version
+// N reads what it knows and ignores the rest. Fields are never reordered.
+
+#define METER_FRAME_MAGIC           0x4D
+#define METER_FRAME_VERSION         1
+#define METER_FRAME_HEADER_BYTES    12
+#define METER_FRAME_STREAM_BYTES    5
+#define METER_FRAME_MAX_BINS        FFT_PORTAL_BIN_COUNT
+#define METER_FRAME_MAX_STREAMS     (MIXER_MAX_STREAMS + 1)
+#define METER_FRAME_MAX_BYTES       (METER_FRAME_HEADER_BYTES + METER_FRAME_MAX_BINS + \
+                                     METER_FRAME_MAX_STREAMS * METER_FRAME_STREAM_BYTES)
+
+#define METER_FRAME_F_BINS_VALID    0x01    // bins hold a computed spectrum
+#define METER_FRAME_F_SIGNAL        0x02    // Input above the activity threshold
+
+#define METER_FRAME_STREAM_LOCAL    0       // This node's own capture (TX) or playout (RX)
+
+typedef struct {
+    uint8_t id;                 // METER_FRAME_STREAM_LOCAL or a mixer stream id
+    uint16_t peak_q15;
+    uint16_t rms_q15;
+} meter_frame_stream_t;
+
+typedef struct {
+    uint8_t version;            // Filled by decode; encode always writes METER_FRAME_VERSION
+    uint8_t flags;
+    uint16_t seq;
+    uint32_t ts_ms;
+    uint8_t buffer_fill_pct;
+    uint8_t bin_count;
+    uint8_t bins[METER_FRAME_MAX_BINS];
+    uint8_t stream_count;
+    meter_frame_stream_t streams[METER_FRAME_MAX_STREAMS];
+} meter_frame_t;
+
+// Bytes written, or 0 when the frame is invalid or out does not fit it.
+size_t meter_frame_encode(const meter_frame_t *frame, uint8_t *out, size_t out_size);
+// False on a bad magic, an unknown major layout or a short buffer.
+bool meter_frame_decode(const uint8_t *data, size_t len, meter_frame_t *frame);
+
+// Normalized FFT magnitude (0..1, as adf_pipeline reports it) to a bin byte.
+uint8_t meter_frame_quantize_bin(float norm);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mesh node table behind the portal: struct-of-arrays fields, an
+// open-addressed MAC index and a coarse timer wheel for expiry. Not locked;
+// times are passed in.
+
+#define NODE_TABLE_CAPACITY     MESH_ROUTE_TABLE_SIZE
+#define NODE_TABLE_INDEX_SLOTS  128     // Power of two; load stays <= 0.4
+#define NODE_TABLE_WHEEL_SLOTS  32      // Power of two; slots * tick must exceed the expiry
+#define NODE_TABLE_WHEEL_TICK_MS 1000
+#define NODE_TABLE_NONE         0xFF    // Dense index / link terminator
+
+#define NODE_TABLE_F_PINNED     0x01    // Never expires (this node)
+#define NODE_TABLE_F_ROUTED     0x02    // Present in the last routing table snapshot
+#define NODE_TABLE_F_HEARTBEAT  0x04    // Metadata came from a heartbeat
+
+typedef struct {
+    uint8_t count;
+    uint32_t expire_ms;
+
+    // Dense node fields, [0, count).
+    uint8_t mac[NODE_TABLE_CAPACITY][6];
+    uint8_t parent_mac[NODE_TABLE_CAPACITY][6];
+    uint8_t role[NODE_TABLE_CAPACITY];
+    uint8_t is_root[NODE_TABLE_CAPACITY];
+    uint8_t layer[NODE_TABLE_CAPACITY];
+    int8_t rssi[NODE_TABLE_CAPACITY];
+    uint16_t children[NODE_TABLE_CAPACITY];
+    uint8_t stream_active[NODE_TABLE_CAPACITY];
+    uint32_t uptime_ms[NODE_TABLE_CAPACITY];
+    float x[NODE_TABLE_CAPACITY];
+    float y[NODE_TABLE_CAPACITY];
+    float z[NODE_TABLE_CAPACITY];
+    int64_t last_seen_ms[NODE_TABLE_CAPACITY];
+    uint8_t flags[NODE_TABLE_CAPACITY];         // NODE_TABLE_F_*
+
+    // MAC -> dense index; NODE_TABLE_NONE marks an empty slot. Linear
+    // probing with backward-shift deletion, so there are no tombstones.
+    uint8_t index[NODE_TABLE_INDEX_SLOTS];
+
+    // Timer wheel: every unpinned node sits in the bucket of the tick it was
+    // last scheduled for, on a doubly linked list through the dense index.
+    uint8_t wheel_head[NODE_TABLE_WHEEL_SLOTS];
+    uint8_t wheel_next[NODE_TABLE_CAPACITY];
+    uint8_t wheel_prev[NODE_TABLE_CAPACITY];
+    uint8_t wheel_slot[NODE_TABLE_CAPACITY];    // Bucket the node is linked into
+    uint32_t wheel_tick;                        // Last tick processed
+    bool wheel_started;
+} node_table_t;
+
+_Static_assert(NODE_TABLE_CAPACITY < NODE_TABLE_NONE, "node indices must fit below NODE_TABLE_NONE");
+_Static_assert((NODE_TABLE_INDEX_SLOTS & (NODE_TABLE_INDEX_SLOTS - 1)) == 0 &&
+               NODE_TABLE_INDEX_SLOTS * 2 >= NODE_TABLE_CAPACITY * 5,
+               "NODE_TABLE_INDEX_SLOTS must be a power of two with load <= 0.4");
+_Static_assert((NODE_TABLE_WHEEL_SLOTS & (NODE_TABLE_WHEEL_SLOTS - 1)) == 0,
+               "NODE_TABLE_WHEEL_SLOTS must be a power of two");
+
+void node_table_init(node_table_t *t, uint32_t expire_ms);
+
+// Dense index of mac, or -1.
+int node_table_find(const node_table_t *t, const uint8_t mac[6]);
+// Finds or adds mac and marks it seen at now_ms. -1 when the table is full.
+int node_table_touch(node_table_t *t, const uint8_t mac[6], int64_t now_ms);
+// Pinned nodes (this node) are exempt from expiry.
+void node_table_pin(node_table_t *t, int idx);
+// Removes by dense index; the last node moves into the hole.
+void node_table_remove(node_table_t *t, int idx);
+
+// Advances the wheel to now_ms and removes nodes silent for expire_ms.
+// Costs one bucket per elapsed tick plus the nodes in those buckets.
+size_t node_table_expire(node_table_t *t, int64_t now_ms);
+
+// Diffs a routing table snapshot against the previous one: MACs new to the
+// routing table are added (or touched), nodes that dropped out of it are
+// removed unless pinned. Nodes known only from heartbeats or positions are
+// left alone. Returns the number of nodes added plus removed.
+size_t node_table_sync_routes(node_table_t *t, const uint8_t (*macs)[6], size_t count, int64_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,6 +2,7 @@
 
 #include <esp_err.h>
 #include <esp_http_server.h>
+#include "control/json_writer.h"
 #include <stddef.h>
 #include <stdbool.h>
 
@@ -23,4 +24,6 @@ bool portal_control_plane_allow_rate_limited_request(portal_control_endpoint_t e
 esp_err_t portal_control_plane_send_unauthorized(httpd_req_t *req);
 esp_err_t portal_control_plane_send_rate_limited(httpd_req_t *req);
 
+void portal_control_plane_write_metrics_json(json_writer_t *w);
+// Buffer form of the above; returns the full length like snprintf.
 int portal_control_plane_serialize_metrics_json(char *buf, size_t buf_len);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <esp_err.h>
+
+#include "network/mixer_control.h"
+#include "network/uplink_control.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Token budget for one portal request body (json_extract.h). A full mixer POST
+// with MIXER_MAX_STREAMS streams and every alias field stays well below it.
+#define PORTAL_JSON_MAX_TOKENS 96
+
+// POST /api/mixer body -> mixer message. The body is indexed once and every
+// field is read from the index. msg->out_gain_pct is kept when the body has no
+// outGainPct; stream_count is 0 when the body has no streams (keep current).
+// ESP_ERR_INVALID_ARG on malformed JSON or out-of-range values.
+esp_err_t mixer_ctrl_decode_json(const char *json, mixer_ctrl_message_t *msg);
+
+// POST /api/uplink body -> uplink message ({"enabled", "ssid", "password"}).
+esp_err_t uplink_ctrl_decode_json(const char *json, uplink_ctrl_message_t *msg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "control/json_writer.h"
+#include "network/mesh_net.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// GET /api/uplink and /api/mixer documents, also embedded in /api/status.
+void uplink_status_write_json(json_writer_t *w, const network_uplink_status_t *st);
+void mixer_status_write_json(json_writer_t *w, const network_mixer_status_t *st);
+
+// Current network state in buffer form; return the full length like snprintf.
+int uplink_ctrl_serialize_json(char *buf, size_t buf_len);
+int mixer_ctrl_serialize_json(char *buf, size_t buf_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,6 +3,7 @@
 #include <esp_err.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include "control/json_writer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,6 +11,7 @@ extern "C" {
 
 esp_err_t portal_ota_start(const char *url);
 bool portal_ota_in_progress(void);
+void portal_ota_write_json(json_writer_t *w);
 int portal_ota_serialize_json(char *buf, size_t buf_size);
 void portal_ota_confirm_running_image(void);
 
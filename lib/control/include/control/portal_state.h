@@ -4,11 +4,16 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "network/mesh_net.h"
+#include "control/json_writer.h"
+#include "control/telemetry.h"
+#include "control/node_table.h"
 
-#define PORTAL_MAX_NODES 32
+#define PORTAL_MAX_NODES NODE_TABLE_CAPACITY    // The mesh routing limit
 #define PORTAL_STALE_TIMEOUT_MS 6000   // 3 missed heartbeats (2s interval)
 #define PORTAL_EXPIRE_TIMEOUT_MS 30000 // Remove after 30s
 
+// One node as the portal reports it: a copy out of the node table
+// (control/node_table.h), taken under the portal state lock.
 typedef struct {
     uint8_t mac[6];
     uint8_t role;           // 0=OUT, 1=SRC
@@ -22,19 +27,58 @@ typedef struct {
     uint32_t uptime_ms;
     float x, y, z;          // Positional coordinates
     int64_t last_seen_us;   // esp_timer_get_time() when last heartbeat received
-    bool stale;
 } portal_node_t;
 
+// Subscription topics of the /ws feed; every status document member has one.
+typedef enum {
+    PORTAL_TOPIC_STATUS = 0,    // Summary, OTA, uplink, mixer, USB
+    PORTAL_TOPIC_NODES,
+    PORTAL_TOPIC_METERS,
+    PORTAL_TOPIC_SPECTRUM,
+    PORTAL_TOPIC_LOGS,          // Monitor lines
+    PORTAL_TOPIC_COUNT,
+} portal_topic_t;
+
+extern const char *const portal_topic_names[PORTAL_TOPIC_COUNT];
+
+// One consistent sample behind a status document: the telemetry snapshot (or
+// a direct sample before the publisher runs) and the clock. Begin also
+// refreshes this node's entry, syncs the node table with the routing table
+// and expires silent nodes.
+typedef struct {
+    const telemetry_snapshot_t *telemetry;
+    telemetry_snapshot_t scratch;
+    int64_t now_us;
+} portal_state_frame_t;
+
+// A top-level member of the status document. write emits "key":value into
+// the open object, or nothing when the value is unavailable.
 typedef struct {
-    portal_node_t nodes[PORTAL_MAX_NODES];
-    uint8_t node_count;
-    uint8_t self_mac[6];    // "you are here" MAC
-} portal_state_t;
+    const char *key;
+    uint8_t topic;              // portal_topic_t
+    bool per_frame;             // Differs on every frame (timestamps)
+    void (*write)(json_writer_t *w, const portal_state_frame_t *f);
+} portal_state_field_t;
 
+// Also registers for root heartbeats; until it runs, updates are dropped.
 esp_err_t portal_state_init(void);
 void portal_state_update_from_heartbeat(const uint8_t *sender_mac, const mesh_heartbeat_t *hb);
 void portal_state_update_position(const uint8_t *mac, float x, float y, float z);
 void portal_state_update_self(void);
 void portal_state_expire_stale(void);
+// Diffs the node table against the current routing table.
+void portal_state_sync_with_routing_table(void);
+// Full /api/status document (docs/quality/contracts/portal-observability-
+// contract.md): summary, node table, monitor history, OTA, uplink, mixer and
+// USB state. Streams, so the size of the node table costs no stack.
+void portal_state_write_json(json_writer_t *w);
+// The members portal_state_write_json emits, in document order.
+const portal_state_field_t *portal_state_fields(size_t *count);
+void portal_state_frame_begin(portal_state_frame_t *f);
+void portal_state_frame_end(portal_state_frame_t *f);
+void portal_state_write_node(json_writer_t *w, const portal_node_t *n, int64_t now_us);
 int portal_state_serialize_json(char *buf, size_t buf_size);
-const portal_state_t *portal_state_get(void);
+// Node i of [0, count), copied under the lock. False once i is past the end
+// (the table can shrink between calls).
+size_t portal_state_node_count(void);
+bool portal_state_get_node(size_t i, portal_node_t *out);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame decisions for the renderer task: whether this frame needs drawing and
+// whether the serial dashboard is due. Unchanged frames are skipped unless the
+// view animates or max_idle_ms passed without a redraw.
+
+#define RENDER_PACER_DISPLAY    0x01
+#define RENDER_PACER_DASHBOARD  0x02
+
+typedef struct {
+    uint32_t dashboard_ms;
+    uint32_t max_idle_ms;
+    bool drawn;                 // A frame has been drawn at least once
+    bool dashboard_drawn;
+    uint32_t generation;        // Inputs of the last drawn frame
+    uint8_t view;
+    int64_t last_draw_ms;
+    int64_t last_dashboard_ms;
+    uint32_t frames_drawn;
+    uint32_t frames_skipped;
+} render_pacer_t;
+
+void render_pacer_init(render_pacer_t *p, uint32_t dashboard_ms, uint32_t max_idle_ms);
+
+// Returns RENDER_PACER_* bits for the frame at now_ms.
+uint8_t render_pacer_tick(render_pacer_t *p, int64_t now_ms, uint32_t generation, uint8_t view, bool animating);
+
+#ifdef __cplusplus
+}
+#endif
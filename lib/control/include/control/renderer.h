@@ -0,0 +1,36 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdbool.h>
+
+#include "control/status.h"
+#include "control/telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Display and serial dashboard rendering on their own low-priority task, so
+// a slow I2C transfer or a long serial print never holds up the main loop.
+// Each RENDERER_FRAME_MS the task takes the latest telemetry snapshot and,
+// when the pacer (control/render_pacer.h) says the frame changed, redraws the
+// display's back buffer and flushes it; the dashboard prints every
+// RENDERER_DASHBOARD_MS. The role (SRC/OUT) supplies the callbacks, all of
+// which run on the renderer task; the status they share is the task's alone.
+
+typedef struct {
+    display_view_t view;
+    // Refreshes the role's status from a new snapshot.
+    void (*update)(const telemetry_snapshot_t *t);
+    void (*render_display)(display_view_t view);
+    void (*render_dashboard)(void);
+    // True while the view animates, so every frame is drawn.
+    bool (*animating)(display_view_t view);
+} renderer_config_t;
+
+// Starts the task; config must outlive it.
+esp_err_t renderer_start(const renderer_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
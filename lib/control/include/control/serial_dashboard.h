@@ -1,6 +1,7 @@
 #pragma once
 
 #include "status.h"
+#include "control/json_writer.h"
 #include <esp_err.h>
 #include <stdbool.h>
 
@@ -14,4 +15,11 @@ void dashboard_render_src(const src_status_t *status);
 void dashboard_render_out(const out_status_t *status);
 
 void dashboard_log(const char *fmt, ...);
+// Writes the monitor history as [{"seq":..,"line":".."},..], oldest first.
+void dashboard_write_monitor_json(json_writer_t *w);
+// Same, limited to after_seq < seq <= last_seq; returns the newest seq
+// written (after_seq when none).
+uint32_t dashboard_write_monitor_range_json(json_writer_t *w, uint32_t after_seq, uint32_t last_seq);
+// Seq of the newest line logged, 0 before the first.
+uint32_t dashboard_monitor_last_seq(void);
 int dashboard_serialize_recent_json(char *buf, size_t buf_size);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Single-writer, many-reader published snapshot over caller-owned storage
+// (SNAPSHOT_RCU_SLOTS copies of one struct). Readers never wait, and a
+// snapshot never changes under a reader that holds it. When readers hold
+// every spare slot, the writer skips that publication.
+
+#define SNAPSHOT_RCU_SLOTS 3
+
+typedef struct {
+    uint8_t *storage;           // SNAPSHOT_RCU_SLOTS x slot_size
+    size_t slot_size;
+    atomic_int current;         // Published slot, -1 before the first publish
+    atomic_uint generation;     // Publications so far; 0 = nothing published
+    atomic_uint readers[SNAPSHOT_RCU_SLOTS];
+    int writing;                // Slot handed out by write_begin, -1 when none
+    uint32_t skipped;           // write_begin found no free slot
+} snapshot_rcu_t;
+
+void snapshot_rcu_init(snapshot_rcu_t *rcu, void *storage, size_t slot_size);
+
+// Writer side. write_begin returns a slot to fill (its previous contents are
+// stale), or NULL when every spare slot is still being read. commit publishes
+// it and returns the new generation.
+void *snapshot_rcu_write_begin(snapshot_rcu_t *rcu);
+uint32_t snapshot_rcu_write_commit(snapshot_rcu_t *rcu);
+
+// Reader side. acquire returns the latest snapshot (NULL before the first
+// publish); every non-NULL acquire needs a matching release.
+const void *snapshot_rcu_acquire(snapshot_rcu_t *rcu);
+void snapshot_rcu_release(snapshot_rcu_t *rcu, const void *snapshot);
+
+uint32_t snapshot_rcu_generation(snapshot_rcu_t *rcu);
+
+#ifdef __cplusplus
+}
+#endif
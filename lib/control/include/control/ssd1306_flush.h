@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Incremental SSD1306 framebuffer flush: only pages that differ from a shadow
+// of the panel are sent, trimmed to the changed columns, one I2C transaction
+// per page.
+
+#define SSD1306_FLUSH_MAX_WIDTH     128
+#define SSD1306_FLUSH_MAX_PAGES     8
+#define SSD1306_FLUSH_HEADER_BYTES  13      // 6 x (control, command), then the data control byte
+
+#define SSD1306_CTRL_CMD_SINGLE     0x80    // Co=1, D/C#=0: one command byte follows
+#define SSD1306_CTRL_CMD_STREAM     0x00    // Co=0, D/C#=0: the rest are command bytes
+#define SSD1306_CTRL_DATA_STREAM    0x40    // Co=0, D/C#=1: the rest are GDDRAM bytes
+
+// Writes one I2C transaction to the panel; false on a bus error.
+typedef bool (*ssd1306_write_fn)(void *ctx, const uint8_t *data, size_t len);
+
+typedef struct {
+    uint8_t width;
+    uint8_t pages;
+    uint8_t synced;             // Bit per page: shadow matches the panel
+    uint8_t shadow[SSD1306_FLUSH_MAX_PAGES * SSD1306_FLUSH_MAX_WIDTH];
+    uint8_t tx[SSD1306_FLUSH_HEADER_BYTES + SSD1306_FLUSH_MAX_WIDTH];
+} ssd1306_flush_t;
+
+// Starts with every page unsynced, so the first flush sends the whole frame.
+void ssd1306_flush_init(ssd1306_flush_t *f, uint8_t width, uint8_t pages);
+// The panel's contents are unknown (reset, reconfigured); resend everything.
+void ssd1306_flush_invalidate(ssd1306_flush_t *f);
+
+// Sends the changed parts of fb (pages * width bytes, page-major). A page
+// whose write fails stays unsynced and is retried by the next flush.
+// Returns the number of pages sent.
+int ssd1306_flush(ssd1306_flush_t *f, const uint8_t *fb, ssd1306_write_fn write, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
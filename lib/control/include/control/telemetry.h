@@ -0,0 +1,75 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "audio/adf_pipeline.h"
+#include "control/cpu_load.h"
+#include "config/build.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Published telemetry. One task samples every source once per
+// TELEMETRY_PUBLISH_INTERVAL_MS into an immutable snapshot; HTTP, WebSocket,
+// display and dashboard read the latest one instead of each querying the Wi-Fi
+// driver, heap and pipeline on its own. Reads are lock-free (snapshot_rcu.h),
+// so the sampling cost stays the same however many clients are connected.
+
+typedef struct {
+    uint32_t generation;            // Increments with every publication
+    int64_t sampled_us;
+    uint32_t uptime_s;
+
+    uint32_t heap_free;
+    uint32_t heap_total;
+    uint32_t heap_min_free;
+    uint8_t heap_used_pct;
+
+    bool mesh_connected;
+    bool mesh_root;
+    uint8_t mesh_layer;
+    int rssi;
+    uint32_t connected_nodes;
+    uint32_t latency_ms;
+
+    uint32_t tx_kbps;               // Audio payload over the last ~1 s
+    bool receiving_audio;
+
+    bool pipeline_valid;            // pipeline holds adf_pipeline_get_stats output
+    adf_pipeline_stats_t pipeline;
+    adf_input_mode_t input_mode;
+    bool usb_ready;
+    bool usb_active;
+
+    bool fft_valid;
+    float fft_bins[FFT_PORTAL_BIN_COUNT];
+
+    // Accumulated by the publisher across samples; telemetry_sample alone
+    // leaves it empty (window_ms 0).
+    cpu_load_report_t cpu;
+    uint32_t cpu_samples_skipped;   // Task list could not be read; the report holds older buckets
+} telemetry_snapshot_t;
+
+// Starts the publisher for pipeline (NULL samples no pipeline state) and
+// publishes the first snapshot before returning.
+esp_err_t telemetry_start(adf_pipeline_handle_t pipeline);
+void telemetry_stop(void);
+
+// Latest snapshot, or NULL before telemetry_start. Hold it only as long as
+// needed and hand it back with telemetry_release.
+const telemetry_snapshot_t *telemetry_acquire(void);
+void telemetry_release(const telemetry_snapshot_t *snapshot);
+
+// Samples every source directly into out, as the publisher does each
+// interval. For readers that find no snapshot yet; pipeline may be NULL.
+void telemetry_sample(telemetry_snapshot_t *out, adf_pipeline_handle_t pipeline);
+
+// Generation of the latest snapshot; cheap change detection for pollers.
+uint32_t telemetry_generation(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/build.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Subscriber table and change tracking for the portal WebSocket feed. Each
+// pass the caller reports a hash per document field and per keyed item (one
+// per node), and the hub reports what changed. A subscriber gets a full
+// snapshot of its topics, then deltas; a message it misses resyncs it with a
+// full snapshot.
+
+#define WS_HUB_MAX_CLIENTS  PORTAL_WS_MAX_CLIENTS
+#define WS_HUB_MAX_FIELDS   32
+#define WS_HUB_MAX_ITEMS    MESH_ROUTE_TABLE_SIZE   // One per portal node
+
+typedef enum {
+    WS_HUB_SEND_NONE = 0,
+    WS_HUB_SEND_FULL,
+    WS_HUB_SEND_DELTA,
+} ws_hub_send_t;
+
+typedef enum {
+    WS_HUB_SENT_OK = 0,
+    WS_HUB_SENT_BACKED_UP,      // Socket full before anything went out
+    WS_HUB_SENT_FAILED,         // Send error or a message cut short: the stream is unusable
+} ws_hub_result_t;
+
+typedef struct {
+    int fd;                     // -1 when the slot is free
+    uint8_t topics;             // Bit per subscribed topic
+    uint32_t epoch;             // Changes on add and resubscribe
+    bool needs_full;            // New, resubscribed or dropped a message
+    uint32_t sent_full;
+    uint32_t sent_delta;
+    uint32_t dropped;           // Messages skipped because the socket was backed up
+} ws_hub_client_t;
+
+typedef struct {
+    uint64_t key;
+    uint32_t hash;
+    bool seen;                  // Reported during the current pass
+    bool changed;               // New or different hash this pass
+} ws_hub_item_t;
+
+typedef struct {
+    ws_hub_client_t clients[WS_HUB_MAX_CLIENTS];
+    uint32_t field_hash[WS_HUB_MAX_FIELDS];
+    uint32_t known_fields;      // Bit per field reported at least once
+    uint32_t changed_fields;    // Bit per field changed this pass
+    ws_hub_item_t items[WS_HUB_MAX_ITEMS];
+    uint8_t item_count;
+    uint64_t removed[WS_HUB_MAX_ITEMS];
+    uint8_t removed_count;      // Items gone since the previous pass
+    uint8_t changed_topics;     // Bit per topic with anything to send this pass
+    uint32_t seq;               // Pass number, stamped on every message
+    uint32_t next_epoch;
+} ws_hub_t;
+
+// A send planned under the caller's lock and carried out without it.
+typedef struct {
+    int fd;
+    uint8_t topics;
+    uint32_t epoch;
+    ws_hub_send_t kind;
+} ws_hub_job_t;
+
+void ws_hub_init(ws_hub_t *hub);
+
+// Registers fd (or re-registers it) subscribed to topics; it gets a full
+// snapshot on the next pass. Returns false when every slot is taken.
+bool ws_hub_add_client(ws_hub_t *hub, int fd, uint8_t topics);
+void ws_hub_remove_client(ws_hub_t *hub, int fd);
+// Changing topics resyncs the client with a full snapshot.
+bool ws_hub_set_topics(ws_hub_t *hub, int fd, uint8_t topics);
+int ws_hub_client_count(const ws_hub_t *hub);
+bool ws_hub_needs_full(const ws_hub_t *hub);
+
+// One pass: begin, report every field and item, end. Fields are numbered by
+// the caller (< WS_HUB_MAX_FIELDS); items are keyed, and items not reported
+// during a pass are listed as removed at end.
+void ws_hub_begin_pass(ws_hub_t *hub);
+bool ws_hub_update_field(ws_hub_t *hub, unsigned field, uint8_t topic, uint32_t hash);
+bool ws_hub_update_item(ws_hub_t *hub, uint64_t key, uint8_t topic, uint32_t hash);
+// For topics diffed by the caller (an append-only log): mark it changed.
+void ws_hub_mark_topic(ws_hub_t *hub, uint8_t topic);
+void ws_hub_end_pass(ws_hub_t *hub, uint8_t item_topic);
+
+bool ws_hub_field_changed(const ws_hub_t *hub, unsigned field);
+// True for items changed this pass, and for items the table could not track.
+bool ws_hub_item_changed(const ws_hub_t *hub, uint64_t key);
+
+// What to send client slot i this pass; fills job unless WS_HUB_SEND_NONE.
+// writable says whether its socket can take a message now; when it cannot and
+// something was due, the message is dropped and the client flagged for a full
+// resync.
+ws_hub_send_t ws_hub_plan(ws_hub_t *hub, int i, bool writable, ws_hub_job_t *job);
+// Outcome of a job. BACKED_UP resyncs the client, FAILED removes it. Ignored
+// when the client left or resubscribed after the job was planned.
+void ws_hub_sent(ws_hub_t *hub, const ws_hub_job_t *job, ws_hub_result_t result);
+
+// FNV-1a over a JSON encoding, usable as a json_writer sink (ctx is a
+// uint32_t seeded with WS_HUB_HASH_SEED).
+#define WS_HUB_HASH_SEED 2166136261u
+bool ws_hub_hash_sink(void *ctx, const char *data, size_t len, bool final);
+
+#ifdef __cplusplus
+}
+#endif
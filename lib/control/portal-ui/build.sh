@@ -7,8 +7,8 @@ cd "$SCRIPT_DIR"
 
 pnpm install
 pnpm run build
-pnpm run export:spiffs
+pnpm run bundle
 
 echo ""
-echo "SPIFFS data ready in: $(dirname "$SCRIPT_DIR")/data"
-echo "Upload with: pio run -e tx -t uploadfs"
+echo "Portal bundle is packed from dist/ and flashed with the firmware:"
+echo "  pio run -e src -t upload"
@@ -23,6 +23,7 @@
     meshState: 'Mesh --',
     bpm: null,
     fftBins: null,
+    levels: null,
     monitor: [],
     ota: null,
     uplink: null,
@@ -943,6 +944,90 @@
 
   // ---- WebSocket / connection ----
 
+  // The node sends one {"type":"full"} snapshot of the subscribed topics, then
+  // {"type":"delta"} messages: changed members under "set", node upserts and
+  // removals, and new monitor lines. liveState is the reassembled document.
+  const WS_TOPICS = ['status', 'nodes', 'meters', 'spectrum', 'logs'];
+  const WS_MONITOR_HISTORY_MAX = 48;
+  let liveState = null;
+
+  function applyWsMessage(msg) {
+    if (!msg || typeof msg !== 'object') return null;
+    if (msg.type === 'full') {
+      liveState = { ...(msg.state || {}) };
+      if (!Array.isArray(liveState.nodes)) liveState.nodes = [];
+      if (!Array.isArray(liveState.monitor)) liveState.monitor = [];
+    } else if (msg.type === 'delta') {
+      if (!liveState) return null;
+      Object.assign(liveState, msg.set || {});
+      if (msg.nodes) {
+        const removed = new Set(msg.nodes.remove || []);
+        const byMac = new Map(liveState.nodes.filter((n) => !removed.has(n.mac)).map((n) => [n.mac, n]));
+        (msg.nodes.upsert || []).forEach((n) => byMac.set(n.mac, n));
+        liveState.nodes = Array.from(byMac.values());
+      }
+      if (Array.isArray(msg.monitor) && msg.monitor.length) {
+        liveState.monitor = liveState.monitor.concat(msg.monitor).slice(-WS_MONITOR_HISTORY_MAX);
+      }
+    } else if (Array.isArray(msg.nodes)) {
+      liveState = msg;
+    } else {
+      return null;
+    }
+    if (msg.ts) liveState.ts = msg.ts;
+    return liveState;
+  }
+
+  // /ws/meters: binary frames at the FFT rate (layout in meter_frame.h).
+  // Bins are uint8 over the portal dB range, levels Q15 per stream.
+  const METER_FRAME_MAGIC = 0x4d;
+  const METER_FRAME_HEADER_BYTES = 12;
+  let meterWs = null;
+
+  function decodeMeterFrame(buf) {
+    const dv = new DataView(buf);
+    if (dv.byteLength < METER_FRAME_HEADER_BYTES || dv.getUint8(0) !== METER_FRAME_MAGIC || dv.getUint8(1) === 0) return null;
+    const flags = dv.getUint8(2);
+    const binCount = dv.getUint8(3);
+    const streamCount = dv.getUint8(11);
+    if (dv.byteLength < METER_FRAME_HEADER_BYTES + binCount + streamCount * 5) return null;
+    const bins = [];
+    for (let i = 0; i < binCount; i++) bins.push(dv.getUint8(METER_FRAME_HEADER_BYTES + i) / 255);
+    const streams = [];
+    for (let i = 0, off = METER_FRAME_HEADER_BYTES + binCount; i < streamCount; i++, off += 5) {
+      streams.push({ id: dv.getUint8(off), peak: dv.getUint16(off + 1, true) / 32767, rms: dv.getUint16(off + 3, true) / 32767 });
+    }
+    return {
+      version: dv.getUint8(1),
+      binsValid: (flags & 0x01) !== 0,
+      signal: (flags & 0x02) !== 0,
+      seq: dv.getUint16(4, true),
+      tsMs: dv.getUint32(6, true),
+      bufferPct: dv.getUint8(10),
+      bins,
+      streams
+    };
+  }
+
+  function connectMeterWs() {
+    if (meterWs && (meterWs.readyState === 0 || meterWs.readyState === 1)) return;
+    try {
+      meterWs = new WebSocket(`ws://${window.location.host}/ws/meters`);
+    } catch (_) {
+      meterWs = null;
+      return;
+    }
+    meterWs.binaryType = 'arraybuffer';
+    meterWs.onmessage = (ev) => {
+      const m = ev.data instanceof ArrayBuffer ? decodeMeterFrame(ev.data) : null;
+      if (!m) return;
+      if (m.binsValid) state.fftBins = m.bins;
+      state.levels = { signal: m.signal, bufferPct: m.bufferPct, streams: m.streams };
+    };
+    // The JSON socket owns reconnects; it reopens this one from onopen.
+    meterWs.onclose = () => { meterWs = null; };
+  }
+
   function scheduleReconnect() {
     wsAttempts += 1;
     setConnState('reconnecting', 'Reconnecting');
@@ -974,18 +1059,25 @@
       demoMode = false;
       if (demoRuntime.intervalId) { clearInterval(demoRuntime.intervalId); demoRuntime.intervalId = null; }
       setConnState('connected', 'Connected');
+      liveState = null;
+      try { ws.send(JSON.stringify({ subscribe: WS_TOPICS })); } catch (_) {}
+      connectMeterWs();
     };
 
     ws.onmessage = (ev) => {
       try {
-        const msg = JSON.parse(ev.data);
-        if (msg && Array.isArray(msg.nodes)) {
-          ingestPortalPayload(msg);
+        const doc = applyWsMessage(JSON.parse(ev.data));
+        if (doc) {
+          ingestPortalPayload(doc);
         }
       } catch (_) {}
     };
 
-    ws.onclose = () => scheduleReconnect();
+    ws.onclose = () => {
+      liveState = null;
+      if (meterWs) { try { meterWs.close(); } catch (_) {} }
+      scheduleReconnect();
+    };
     ws.onerror = () => { try { ws.close(); } catch (_) {} };
   }
 
@@ -0,0 +1,146 @@
+#include "control/asset_bundle.h"
+
+#include <string.h>
+
+typedef enum {
+    ENTRY_PATH = 0,
+    ENTRY_TYPE,
+    ENTRY_ETAG,
+    ENTRY_CACHE,
+    ENTRY_DATA,
+    ENTRY_DATA_LEN,
+    ENTRY_FLAGS,
+} entry_field_t;
+
+// The mapping has no alignment guarantee for a given field; read bytewise.
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t entry_field(const asset_bundle_t *b, uint16_t i, entry_field_t field)
+{
+    return get_u32(b->base + ASSET_BUNDLE_HEADER_BYTES + (size_t)i * ASSET_BUNDLE_ENTRY_BYTES + field * 4U);
+}
+
+static const char *entry_string(const asset_bundle_t *b, uint16_t i, entry_field_t field)
+{
+    return (const char *)b->base + entry_field(b, i, field);
+}
+
+static bool string_in_bounds(const asset_bundle_t *b, uint32_t off, uint32_t strings_start)
+{
+    if (off < strings_start || off >= b->size) {
+        return false;
+    }
+    return memchr(b->base + off, '\0', b->size - off) != NULL;
+}
+
+uint32_t asset_bundle_size(const uint8_t *hdr, size_t len)
+{
+    if (len < ASSET_BUNDLE_HEADER_BYTES || memcmp(hdr, ASSET_BUNDLE_MAGIC, 4) != 0 ||
+        (hdr[4] | (hdr[5] << 8)) != ASSET_BUNDLE_VERSION) {
+        return 0;
+    }
+    uint32_t size = get_u32(hdr + 8);
+    return size >= ASSET_BUNDLE_HEADER_BYTES ? size : 0;
+}
+
+bool asset_bundle_open(asset_bundle_t *b, const void *base, size_t size)
+{
+    memset(b, 0, sizeof(*b));
+    const uint8_t *p = (const uint8_t *)base;
+    uint32_t total = asset_bundle_size(p, size);
+    if (total == 0 || total > size) {
+        return false;
+    }
+
+    uint32_t hash = 2166136261U;
+    for (uint32_t i = ASSET_BUNDLE_HEADER_BYTES; i < total; i++) {
+        hash = (hash ^ p[i]) * 16777619U;
+    }
+    if (hash != get_u32(p + 12)) {
+        return false;
+    }
+
+    asset_bundle_t probe = { .base = p, .size = total, .count = (uint16_t)(p[6] | (p[7] << 8)) };
+    uint32_t strings_start = ASSET_BUNDLE_HEADER_BYTES + (uint32_t)probe.count * ASSET_BUNDLE_ENTRY_BYTES;
+    if (probe.count == 0 || strings_start > total) {
+        return false;
+    }
+    for (uint16_t i = 0; i < probe.count; i++) {
+        uint32_t data = entry_field(&probe, i, ENTRY_DATA);
+        uint32_t len = entry_field(&probe, i, ENTRY_DATA_LEN);
+        if (!string_in_bounds(&probe, entry_field(&probe, i, ENTRY_PATH), strings_start) ||
+            !string_in_bounds(&probe, entry_field(&probe, i, ENTRY_TYPE), strings_start) ||
+            !string_in_bounds(&probe, entry_field(&probe, i, ENTRY_ETAG), strings_start) ||
+            !string_in_bounds(&probe, entry_field(&probe, i, ENTRY_CACHE), strings_start) ||
+            data < strings_start || len > total - data) {
+            return false;
+        }
+        // Lookups bisect, so the packer's ordering is part of the format.
+        if (i > 0 && strcmp(entry_string(&probe, i - 1, ENTRY_PATH), entry_string(&probe, i, ENTRY_PATH)) >= 0) {
+            return false;
+        }
+    }
+    *b = probe;
+    return true;
+}
+
+bool asset_bundle_find(const asset_bundle_t *b, const char *path, asset_bundle_entry_t *out)
+{
+    int lo = 0;
+    int hi = (int)b->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(path, entry_string(b, (uint16_t)mid, ENTRY_PATH));
+        if (cmp == 0) {
+            uint16_t i = (uint16_t)mid;
+            out->path = entry_string(b, i, ENTRY_PATH);
+            out->content_type = entry_string(b, i, ENTRY_TYPE);
+            out->etag = entry_string(b, i, ENTRY_ETAG);
+            out->cache_control = entry_string(b, i, ENTRY_CACHE);
+            out->data = b->base + entry_field(b, i, ENTRY_DATA);
+            out->len = entry_field(b, i, ENTRY_DATA_LEN);
+            out->flags = entry_field(b, i, ENTRY_FLAGS);
+            return true;
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return false;
+}
+
+bool asset_bundle_etag_matches(const char *if_none_match, const char *etag)
+{
+    size_t etag_len = strlen(etag);
+    const char *p = if_none_match;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        if (*p == '*') {
+            return true;
+        }
+        // If-None-Match uses weak comparison: W/"x" matches "x".
+        if (p[0] == 'W' && p[1] == '/') {
+            p += 2;
+        }
+        const char *end = p;
+        while (*end && *end != ',') {
+            end++;
+        }
+        size_t len = (size_t)(end - p);
+        while (len > 0 && (p[len - 1] == ' ' || p[len - 1] == '\t')) {
+            len--;
+        }
+        if (len == etag_len && memcmp(p, etag, len) == 0) {
+            return true;
+        }
+        p = end;
+    }
+    return false;
+}
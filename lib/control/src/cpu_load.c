@@ -0,0 +1,180 @@
+#include "control/cpu_load.h"
+
+#include <string.h>
+
+static const uint8_t k_window_buckets[CPU_LOAD_WINDOW_COUNT] = { 1, CPU_LOAD_HISTORY };
+
+void cpu_load_init(cpu_load_t *c, uint8_t cores, uint32_t counter_hz)
+{
+    memset(c, 0, sizeof(*c));
+    c->cores = cores < CPU_LOAD_MAX_CORES ? cores : CPU_LOAD_MAX_CORES;
+    c->ticks_per_ms = counter_hz >= 1000 ? counter_hz / 1000 : 1;
+    c->bucket_ticks = c->ticks_per_ms * CPU_LOAD_BUCKET_MS;
+}
+
+static cpu_load_entry_t *find_entry(cpu_load_t *c, uint32_t id)
+{
+    for (int i = 0; i < c->task_count; i++) {
+        if (c->tasks[i].id == id) {
+            return &c->tasks[i];
+        }
+    }
+    return NULL;
+}
+
+static cpu_load_entry_t *add_entry(cpu_load_t *c, const cpu_load_task_sample_t *s)
+{
+    if (c->task_count >= CPU_LOAD_MAX_TASKS) {
+        return NULL;
+    }
+    cpu_load_entry_t *e = &c->tasks[c->task_count++];
+    memset(e, 0, sizeof(*e));
+    e->id = s->id;
+    if (s->name) {
+        strncpy(e->name, s->name, CPU_LOAD_NAME_LEN - 1);
+    }
+    // A task absent from the previous sample was created since, so all of its
+    // run time falls in this interval. After an overflow it may instead be an
+    // old task that just got a slot; start it from a baseline then.
+    e->last_runtime = (c->started && !c->overflowed) ? 0 : s->runtime;
+    return e;
+}
+
+static void close_bucket(cpu_load_t *c)
+{
+    c->head = (uint8_t)((c->head + 1) % CPU_LOAD_SLOTS);
+    if (c->closed < CPU_LOAD_HISTORY) {
+        c->closed++;
+    }
+    c->elapsed[c->head] = 0;
+    memset(c->idle[c->head], 0, sizeof(c->idle[c->head]));
+    for (int i = 0; i < c->task_count; i++) {
+        c->tasks[i].run[c->head] = 0;
+    }
+}
+
+void cpu_load_sample(cpu_load_t *c, uint32_t now, const cpu_load_task_sample_t *tasks, size_t count)
+{
+    uint32_t dt = now - c->last_now;
+    uint8_t h = c->head;
+    if (c->started) {
+        c->elapsed[h] += dt;
+    }
+    c->last_now = now;
+
+    for (int i = 0; i < c->task_count; i++) {
+        c->tasks[i].seen = false;
+    }
+    bool overflow = false;
+    for (size_t i = 0; i < count; i++) {
+        const cpu_load_task_sample_t *s = &tasks[i];
+        cpu_load_entry_t *e = find_entry(c, s->id);
+        if (!e) {
+            e = add_entry(c, s);
+            if (!e) {
+                overflow = true;
+                continue;
+            }
+        }
+        uint32_t run = s->runtime - e->last_runtime;
+        e->last_runtime = s->runtime;
+        if (run > dt) {
+            run = dt;       // A task runs on one core at a time
+        }
+        e->core = s->core;
+        e->idle = s->idle;
+        e->seen = true;
+        if (!c->started) {
+            continue;
+        }
+        e->run[h] += run;
+        if (s->idle && s->core < c->cores) {
+            c->idle[h][s->core] += run;
+        }
+    }
+
+    // Forget deleted tasks; the last entry moves into the hole.
+    for (int i = 0; i < c->task_count;) {
+        if (c->tasks[i].seen) {
+            i++;
+            continue;
+        }
+        c->tasks[i] = c->tasks[--c->task_count];
+    }
+    c->overflowed = overflow;
+    c->started = true;
+
+    if (c->elapsed[h] >= c->bucket_ticks) {
+        close_bucket(c);
+    }
+}
+
+static uint8_t pct_of(uint64_t part, uint64_t total)
+{
+    if (part >= total) {
+        return 100;
+    }
+    return (uint8_t)((part * 100 + total / 2) / total);
+}
+
+static void report_window(const cpu_load_t *c, uint8_t buckets, cpu_load_window_t *out)
+{
+    uint64_t elapsed = 0;
+    uint64_t idle[CPU_LOAD_MAX_CORES] = { 0 };
+    for (uint8_t k = 1; k <= buckets; k++) {
+        uint8_t slot = (uint8_t)((c->head + CPU_LOAD_SLOTS - k) % CPU_LOAD_SLOTS);
+        elapsed += c->elapsed[slot];
+        for (uint8_t core = 0; core < c->cores; core++) {
+            idle[core] += c->idle[slot][core];
+        }
+    }
+    if (elapsed == 0) {
+        return;
+    }
+    out->window_ms = (uint32_t)(elapsed / c->ticks_per_ms);
+    for (uint8_t core = 0; core < c->cores; core++) {
+        out->core_pct[core] = (uint8_t)(100 - pct_of(idle[core], elapsed));
+    }
+
+    // Insertion into a short sorted list; the table is small.
+    uint64_t top_run[CPU_LOAD_TOP_TASKS];
+    const cpu_load_entry_t *top[CPU_LOAD_TOP_TASKS];
+    uint8_t n = 0;
+    for (int i = 0; i < c->task_count; i++) {
+        const cpu_load_entry_t *e = &c->tasks[i];
+        if (e->idle) {
+            continue;
+        }
+        uint64_t run = 0;
+        for (uint8_t k = 1; k <= buckets; k++) {
+            run += e->run[(c->head + CPU_LOAD_SLOTS - k) % CPU_LOAD_SLOTS];
+        }
+        if (run == 0 || (n == CPU_LOAD_TOP_TASKS && run <= top_run[n - 1])) {
+            continue;
+        }
+        uint8_t j = n < CPU_LOAD_TOP_TASKS ? n++ : (uint8_t)(n - 1);
+        while (j > 0 && top_run[j - 1] < run) {
+            top_run[j] = top_run[j - 1];
+            top[j] = top[j - 1];
+            j--;
+        }
+        top_run[j] = run;
+        top[j] = e;
+    }
+    out->top_count = n;
+    for (uint8_t i = 0; i < n; i++) {
+        memcpy(out->top[i].name, top[i]->name, CPU_LOAD_NAME_LEN);
+        out->top[i].core = top[i]->core;
+        out->top[i].pct = pct_of(top_run[i], elapsed);
+    }
+}
+
+void cpu_load_report(const cpu_load_t *c, cpu_load_report_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->cores = c->cores;
+    for (int w = 0; w < CPU_LOAD_WINDOW_COUNT; w++) {
+        uint8_t buckets = k_window_buckets[w] < c->closed ? k_window_buckets[w] : c->closed;
+        report_window(c, buckets, &out->window[w]);
+    }
+}
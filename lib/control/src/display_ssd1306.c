@@ -3,6 +3,8 @@
 #include "config/pins.h"
 #include "config/build.h"
 #include "network/mesh_net.h"
+#include "control/telemetry.h"
+#include "control/ssd1306_flush.h"
 #include <esp_log.h>
 #include <driver/i2c.h>
 #include <driver/gpio.h>
@@ -51,6 +53,9 @@ static bool display_initialized = false;
 // Display buffer (1 bit per pixel, organized in pages)
 static uint8_t display_buffer[DISPLAY_WIDTH * DISPLAY_PAGES];
 
+// What the panel currently shows; display_update sends only the difference.
+static ssd1306_flush_t display_flush;
+
 // Simple 5x7 font (ASCII 32-126)
 static const uint8_t font5x7[][5] = {
     {0x00, 0x00, 0x00, 0x00, 0x00}, // (space)
@@ -156,20 +161,14 @@ static esp_err_t ssd1306_write_command(uint8_t cmd) {
     return ret;
 }
 
-// I2C write data (static buffer to avoid malloc/free on every update)
-static uint8_t i2c_tx_buffer[1 + DISPLAY_WIDTH];  // Max size: 1 byte header + 128 bytes data
-
-static esp_err_t ssd1306_write_data(const uint8_t *data, size_t len) {
-    if (len > DISPLAY_WIDTH) return ESP_ERR_INVALID_SIZE;
-    
-    i2c_tx_buffer[0] = 0x40;  // 0x40 = data mode
-    memcpy(&i2c_tx_buffer[1], data, len);
-    
-    esp_err_t ret = i2c_master_write_to_device(I2C_MASTER_NUM, SSD1306_I2C_ADDR, i2c_tx_buffer, len + 1, pdMS_TO_TICKS(100));
+// One I2C transaction carrying a prepared control/command/data stream
+static bool ssd1306_write_bus(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx;
+    esp_err_t ret = i2c_master_write_to_device(I2C_MASTER_NUM, SSD1306_I2C_ADDR, data, len, pdMS_TO_TICKS(100));
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2C write data (%zu bytes) failed: %s", len, esp_err_to_name(ret));
+        ESP_LOGE(TAG, "I2C write (%zu bytes) failed: %s", len, esp_err_to_name(ret));
     }
-    return ret;
+    return ret == ESP_OK;
 }
 
 // Initialize SSD1306
@@ -386,6 +385,7 @@ esp_err_t display_init(void) {
     ESP_LOGI(TAG, "Init sequence complete");
     
     display_clear();
+    ssd1306_flush_init(&display_flush, DISPLAY_WIDTH, DISPLAY_PAGES);
     ESP_LOGI(TAG, "Display buffer cleared");
     
     display_update();  // Initial clear
@@ -402,25 +402,31 @@ void display_clear(void) {
 }
 
 // Re-send critical SSD1306 config commands that could be corrupted by I2C/MCLK EMI.
-// If EMI flips SEG_REMAP or COM_SCAN, the display mirrors/flips. Re-sending every
-// frame ensures self-correction within one refresh cycle (~100ms).
+// If EMI flips SEG_REMAP or COM_SCAN, the display mirrors/flips. Runs on a slow
+// timer rather than per frame; the whole frame is repainted afterwards, since
+// pixels written under a corrupted mode may sit anywhere in GDDRAM.
 static void display_reinforce_config(void) {
-    static uint32_t reinforce_counter = 0;
-    reinforce_counter++;
-    // Reinforce every 10th frame (~1s at 10Hz) to reduce I2C traffic
-    if ((reinforce_counter % 10) != 0) return;
-
-    ssd1306_write_command(SSD1306_CMD_MEMORY_MODE);
-    ssd1306_write_command(0x00);  // Horizontal addressing mode
-    ssd1306_write_command(SSD1306_CMD_SEG_REMAP | 0x01);  // Column 127 → SEG0
-    ssd1306_write_command(SSD1306_CMD_COM_SCAN_DEC);       // COM[N-1] → COM0
-    ssd1306_write_command(SSD1306_CMD_SET_START_LINE | 0x00);
-    ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_OFFSET);
-    ssd1306_write_command(0x00);
-    ssd1306_write_command(SSD1306_CMD_NORMAL_DISPLAY);
+    static const uint8_t config[] = {
+        SSD1306_CTRL_CMD_STREAM,
+        SSD1306_CMD_MEMORY_MODE, 0x00,              // Horizontal addressing mode
+        SSD1306_CMD_SEG_REMAP | 0x01,               // Column 127 → SEG0
+        SSD1306_CMD_COM_SCAN_DEC,                   // COM[N-1] → COM0
+        SSD1306_CMD_SET_START_LINE | 0x00,
+        SSD1306_CMD_SET_DISPLAY_OFFSET, 0x00,
+        SSD1306_CMD_NORMAL_DISPLAY,
+    };
+    static int64_t last_us = 0;
+    int64_t now_us = esp_timer_get_time();
+    if (now_us - last_us < (int64_t)DISPLAY_REINFORCE_INTERVAL_MS * 1000) {
+        return;
+    }
+    last_us = now_us;
+    if (ssd1306_write_bus(NULL, config, sizeof(config))) {
+        ssd1306_flush_invalidate(&display_flush);
+    }
 }
 
-// Update display from buffer (page-by-page to avoid large I2C writes)
+// Update display from buffer: only pages that changed, one I2C transaction each
 static void display_update(void) {
     if (!display_initialized) {
         return;
@@ -428,31 +434,7 @@ static void display_update(void) {
 
     // Periodically re-send orientation/mode commands to recover from EMI corruption
     display_reinforce_config();
-    
-    for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
-        // Set column address range
-        esp_err_t err = ssd1306_write_command(SSD1306_CMD_SET_COLUMN_ADDR);
-        if (err != ESP_OK) continue;
-        
-        err = ssd1306_write_command(0);  // Start column
-        if (err != ESP_OK) continue;
-        
-        err = ssd1306_write_command(DISPLAY_WIDTH - 1);  // End column
-        if (err != ESP_OK) continue;
-        
-        // Set page address range
-        err = ssd1306_write_command(SSD1306_CMD_SET_PAGE_ADDR);
-        if (err != ESP_OK) continue;
-        
-        err = ssd1306_write_command(page);  // Start page
-        if (err != ESP_OK) continue;
-        
-        err = ssd1306_write_command(page);  // End page (same)
-        if (err != ESP_OK) continue;
-        
-        // Write one page (128 bytes)
-        ssd1306_write_data(&display_buffer[page * DISPLAY_WIDTH], DISPLAY_WIDTH);
-    }
+    ssd1306_flush(&display_flush, display_buffer, ssd1306_write_bus, NULL);
 }
 
 // Draw a character at x, y (page-based)
@@ -509,6 +491,22 @@ static void display_draw_signal_bars(uint8_t x, uint8_t y, int rssi) {
 }
 
 // Render SRC display
+// RAM and uptime for the INFO views, from the published telemetry snapshot
+// (read directly only before the publisher has started).
+static void read_system_info(uint32_t *ram_pct, uint32_t *uptime_s) {
+    const telemetry_snapshot_t *t = telemetry_acquire();
+    if (t) {
+        *ram_pct = t->heap_used_pct;
+        *uptime_s = t->uptime_s;
+        telemetry_release(t);
+        return;
+    }
+    uint32_t total = heap_caps_get_total_size(MALLOC_CAP_8BIT);
+    uint32_t free_mem = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    *ram_pct = (total > 0) ? ((total - free_mem) * 100 / total) : 0;
+    *uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
 void display_render_src(display_view_t view, const src_status_t *status) {
     if (!display_initialized) return;
     
@@ -593,14 +591,12 @@ void display_render_src(display_view_t view, const src_status_t *status) {
         }
     } else {
         char buf[22];
-        
-        uint32_t total = heap_caps_get_total_size(MALLOC_CAP_8BIT);
-        uint32_t free_mem = heap_caps_get_free_size(MALLOC_CAP_8BIT);
-        uint32_t ram_pct = (total > 0) ? ((total - free_mem) * 100 / total) : 0;
+        uint32_t ram_pct, uptime_s;
+        read_system_info(&ram_pct, &uptime_s);
+
         snprintf(buf, sizeof(buf), "RAM: %lu%%", ram_pct);
         display_draw_string(0, 0, buf);
         
-        uint32_t uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
         uint32_t hours = uptime_s / 3600;
         uint32_t mins = (uptime_s % 3600) / 60;
         uint32_t secs = uptime_s % 60;
@@ -687,7 +683,8 @@ void display_render_out(display_view_t view, const out_status_t *status) {
         snprintf(buf, sizeof(buf), "Batt: %u%%", status->battery_pct);
         display_draw_string(0, 2, buf);
 
-        uint32_t uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+        uint32_t ram_pct, uptime_s;
+        read_system_info(&ram_pct, &uptime_s);
         uint32_t hours = uptime_s / 3600;
         uint32_t mins = (uptime_s % 3600) / 60;
         uint32_t secs = uptime_s % 60;
@@ -698,6 +695,14 @@ void display_render_out(display_view_t view, const out_status_t *status) {
     display_update();
 }
 
+bool display_animating_src(display_view_t view, const src_status_t *status) {
+    return display_initialized && view == DISPLAY_VIEW_AUDIO && status->audio_active;
+}
+
+bool display_animating_out(display_view_t view, const out_status_t *status) {
+    return display_initialized && view == DISPLAY_VIEW_AUDIO && status->receiving_audio;
+}
+
 // Show a simple two-line message (e.g. startup/searching screens)
 void display_show_message(const char *line1, const char *line2) {
     if (!display_initialized) return;
@@ -1,251 +1,670 @@
 #include "control/json_extract.h"
 
 #include <ctype.h>
-#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
-/* Builds a JSON key pattern like `"fieldName":` for non-string value lookup */
-static bool build_json_field_key(const char *field, char *key, size_t key_size) {
-    if (!field || !key || key_size == 0) {
+typedef enum {
+    JSON_WANT_VALUE,
+    JSON_WANT_VALUE_OR_CLOSE,   // Just after '['
+    JSON_WANT_KEY,
+    JSON_WANT_KEY_OR_CLOSE,     // Just after '{'
+    JSON_WANT_COLON,
+    JSON_WANT_COMMA_OR_CLOSE,
+    JSON_WANT_END,
+} json_want_t;
+
+static bool json_is_ws(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool json_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// true, false, null or a JSON number.
+static bool json_primitive_valid(const char *p, size_t len)
+{
+    if ((len == 4 && memcmp(p, "true", 4) == 0) || (len == 5 && memcmp(p, "false", 5) == 0) ||
+        (len == 4 && memcmp(p, "null", 4) == 0)) {
+        return true;
+    }
+    size_t i = 0;
+    if (i < len && p[i] == '-') {
+        i++;
+    }
+    if (i >= len || !json_is_digit(p[i])) {
         return false;
     }
-    int written = snprintf(key, key_size, "\"%s\":", field);
-    return written > 0 && (size_t)written < key_size;
+    if (p[i] == '0') {
+        i++;
+    } else {
+        while (i < len && json_is_digit(p[i])) {
+            i++;
+        }
+    }
+    if (i < len && p[i] == '.') {
+        i++;
+        if (i >= len || !json_is_digit(p[i])) {
+            return false;
+        }
+        while (i < len && json_is_digit(p[i])) {
+            i++;
+        }
+    }
+    if (i < len && (p[i] == 'e' || p[i] == 'E')) {
+        i++;
+        if (i < len && (p[i] == '+' || p[i] == '-')) {
+            i++;
+        }
+        if (i >= len || !json_is_digit(p[i])) {
+            return false;
+        }
+        while (i < len && json_is_digit(p[i])) {
+            i++;
+        }
+    }
+    return i == len;
 }
 
-static const char *skip_json_ws(const char *p) {
-    while (p && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
-        p++;
+// Scans the string starting after the opening quote at pos. Returns the offset
+// of the closing quote, or a JSON_ERR_* code.
+static int json_scan_string(const char *js, size_t len, size_t pos, uint8_t *flags)
+{
+    for (size_t p = pos; p < len; p++) {
+        char c = js[p];
+        if (c == '"') {
+            return (int)p;
+        }
+        if ((unsigned char)c < 0x20) {
+            return JSON_ERR_INVAL;
+        }
+        if (c != '\\') {
+            continue;
+        }
+        *flags |= JSON_TOK_F_ESCAPED;
+        if (++p >= len) {
+            return JSON_ERR_PART;
+        }
+        if (js[p] == 'u') {
+            for (int i = 0; i < 4; i++) {
+                if (++p >= len) {
+                    return JSON_ERR_PART;
+                }
+                if (!isxdigit((unsigned char)js[p])) {
+                    return JSON_ERR_INVAL;
+                }
+            }
+        } else if (!strchr("\"\\/bfnrt", js[p])) {
+            return JSON_ERR_INVAL;
+        }
     }
-    return p;
+    return JSON_ERR_PART;
 }
 
-static const char *json_extract_find_matching_delim(const char *start, char open, char close) {
-    if (!start || *start != open) {
-        return NULL;
+int json_parse(json_doc_t *doc, const char *js, size_t len, json_tok_t *toks, uint16_t max_toks)
+{
+    if (!doc || !js || !toks) {
+        return JSON_ERR_INVAL;
+    }
+    const char *nul = memchr(js, '\0', len);
+    if (nul) {
+        len = (size_t)(nul - js);
+    }
+    if (len > JSON_MAX_BODY_LEN) {
+        return JSON_ERR_NOMEM;
     }
 
+    doc->js = js;
+    doc->len = (uint16_t)len;
+    doc->count = 0;
+    doc->toks = toks;
+
+    uint16_t stack[JSON_MAX_DEPTH];
     int depth = 0;
-    bool in_string = false;
-    bool escape = false;
-    for (const char *p = start; *p; p++) {
-        if (in_string) {
-            if (escape) {
-                escape = false;
-                continue;
-            }
-            if (*p == '\\') {
-                escape = true;
-                continue;
-            }
-            if (*p == '"') {
-                in_string = false;
-            }
+    uint16_t count = 0;
+    json_want_t want = JSON_WANT_VALUE;
+    size_t pos = 0;
+
+    while (pos < len) {
+        char c = js[pos];
+        if (json_is_ws(c)) {
+            pos++;
             continue;
         }
+        json_tok_t *parent = depth > 0 ? &toks[stack[depth - 1]] : NULL;
+
+        switch (c) {
+            case '{':
+            case '[':
+                if (want != JSON_WANT_VALUE && want != JSON_WANT_VALUE_OR_CLOSE) {
+                    return JSON_ERR_INVAL;
+                }
+                if (depth == JSON_MAX_DEPTH || count == max_toks) {
+                    return JSON_ERR_NOMEM;
+                }
+                if (parent && parent->type == JSON_TOK_ARRAY) {
+                    parent->size++;
+                }
+                toks[count] = (json_tok_t){
+                    .type = c == '{' ? JSON_TOK_OBJECT : JSON_TOK_ARRAY,
+                    .start = (uint16_t)pos,
+                };
+                stack[depth++] = count++;
+                want = c == '{' ? JSON_WANT_KEY_OR_CLOSE : JSON_WANT_VALUE_OR_CLOSE;
+                pos++;
+                break;
+
+            case '}':
+            case ']':
+                if (!parent) {
+                    return JSON_ERR_INVAL;
+                }
+                if (c == '}' ? (parent->type != JSON_TOK_OBJECT ||
+                                (want != JSON_WANT_KEY_OR_CLOSE && want != JSON_WANT_COMMA_OR_CLOSE))
+                             : (parent->type != JSON_TOK_ARRAY ||
+                                (want != JSON_WANT_VALUE_OR_CLOSE && want != JSON_WANT_COMMA_OR_CLOSE))) {
+                    return JSON_ERR_INVAL;
+                }
+                parent->end = (uint16_t)(pos + 1);
+                parent->next = count;
+                depth--;
+                want = depth > 0 ? JSON_WANT_COMMA_OR_CLOSE : JSON_WANT_END;
+                pos++;
+                break;
+
+            case ':':
+                if (want != JSON_WANT_COLON) {
+                    return JSON_ERR_INVAL;
+                }
+                want = JSON_WANT_VALUE;
+                pos++;
+                break;
+
+            case ',':
+                if (want != JSON_WANT_COMMA_OR_CLOSE) {
+                    return JSON_ERR_INVAL;
+                }
+                want = parent->type == JSON_TOK_OBJECT ? JSON_WANT_KEY : JSON_WANT_VALUE;
+                pos++;
+                break;
+
+            case '"': {
+                bool key = want == JSON_WANT_KEY || want == JSON_WANT_KEY_OR_CLOSE;
+                if (!key && want != JSON_WANT_VALUE && want != JSON_WANT_VALUE_OR_CLOSE) {
+                    return JSON_ERR_INVAL;
+                }
+                if (count == max_toks) {
+                    return JSON_ERR_NOMEM;
+                }
+                uint8_t flags = key ? JSON_TOK_F_KEY : 0;
+                int close = json_scan_string(js, len, pos + 1, &flags);
+                if (close < 0) {
+                    return close;
+                }
+                if (parent && (key || parent->type == JSON_TOK_ARRAY)) {
+                    parent->size++;
+                }
+                toks[count] = (json_tok_t){
+                    .type = JSON_TOK_STRING,
+                    .flags = flags,
+                    .start = (uint16_t)(pos + 1),
+                    .end = (uint16_t)close,
+                    .next = (uint16_t)(count + 1),
+                };
+                count++;
+                want = key ? JSON_WANT_COLON : (depth > 0 ? JSON_WANT_COMMA_OR_CLOSE : JSON_WANT_END);
+                pos = (size_t)close + 1;
+                break;
+            }
 
-        if (*p == '"') {
-            in_string = true;
-            continue;
-        }
-        if (*p == open) {
-            depth++;
-        } else if (*p == close) {
-            depth--;
-            if (depth == 0) {
-                return p;
+            default: {
+                if (want != JSON_WANT_VALUE && want != JSON_WANT_VALUE_OR_CLOSE) {
+                    return JSON_ERR_INVAL;
+                }
+                size_t end = pos;
+                while (end < len && !json_is_ws(js[end]) && js[end] != ',' && js[end] != ']' &&
+                       js[end] != '}' && js[end] != ':') {
+                    end++;
+                }
+                if (!json_primitive_valid(js + pos, end - pos)) {
+                    // A number or literal cut off by the end of input is truncation.
+                    return end == len ? JSON_ERR_PART : JSON_ERR_INVAL;
+                }
+                if (count == max_toks) {
+                    return JSON_ERR_NOMEM;
+                }
+                if (parent && parent->type == JSON_TOK_ARRAY) {
+                    parent->size++;
+                }
+                toks[count] = (json_tok_t){
+                    .type = JSON_TOK_PRIMITIVE,
+                    .start = (uint16_t)pos,
+                    .end = (uint16_t)end,
+                    .next = (uint16_t)(count + 1),
+                };
+                count++;
+                want = depth > 0 ? JSON_WANT_COMMA_OR_CLOSE : JSON_WANT_END;
+                pos = end;
+                break;
             }
         }
     }
-    return NULL;
+
+    if (want != JSON_WANT_END) {
+        return count == 0 ? JSON_ERR_INVAL : JSON_ERR_PART;
+    }
+    doc->count = count;
+    return count;
 }
 
-bool json_extract_string_field(const char *body, const char *field, char *out, size_t out_size) {
-    if (!body || !field || !out || out_size == 0) {
-        return false;
+static bool json_tok_valid(const json_doc_t *doc, int tok)
+{
+    return doc && tok >= 0 && tok < doc->count;
+}
+
+int json_first_child(const json_doc_t *doc, int tok)
+{
+    if (!json_tok_valid(doc, tok)) {
+        return -1;
     }
+    const json_tok_t *t = &doc->toks[tok];
+    if ((t->type != JSON_TOK_OBJECT && t->type != JSON_TOK_ARRAY) || t->size == 0) {
+        return -1;
+    }
+    return tok + 1;
+}
 
-    /* String values need the opening quote included in the search key */
-    char key[66];
-    if (!field || strlen(field) + 4 >= sizeof(key)) {
-        return false;
+int json_next_sibling(const json_doc_t *doc, int parent, int tok)
+{
+    if (!json_tok_valid(doc, parent) || !json_tok_valid(doc, tok)) {
+        return -1;
     }
-    snprintf(key, sizeof(key), "\"%s\":\"", field);
+    // Object members step over the key and its value.
+    int next = doc->toks[parent].type == JSON_TOK_OBJECT ? doc->toks[tok + 1].next : doc->toks[tok].next;
+    return next < doc->toks[parent].next ? next : -1;
+}
 
-    const char *start = strstr(body, key);
-    if (!start) {
-        return false;
+int json_object_get(const json_doc_t *doc, int obj, const char *key)
+{
+    if (!json_tok_valid(doc, obj) || doc->toks[obj].type != JSON_TOK_OBJECT || !key) {
+        return -1;
     }
-    start += strlen(key);
+    for (int k = json_first_child(doc, obj); k >= 0; k = json_next_sibling(doc, obj, k)) {
+        if (json_tok_equals(doc, k, key)) {
+            return k + 1;
+        }
+    }
+    return -1;
+}
 
-    const char *end = strchr(start, '"');
-    if (!end) {
-        return false;
+int json_object_get_type(const json_doc_t *doc, int obj, const char *key, json_tok_type_t type)
+{
+    int value = json_object_get(doc, obj, key);
+    return value >= 0 && doc->toks[value].type == type ? value : -1;
+}
+
+static uint32_t json_hex4(const char *p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v = (v << 4) | (uint32_t)(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
     }
+    return v;
+}
 
-    size_t len = (size_t)(end - start);
-    if (len >= out_size) {
+static bool json_put_utf8(char *out, size_t out_size, size_t *o, uint32_t cp)
+{
+    char buf[4];
+    size_t n;
+    if (cp < 0x80) {
+        buf[0] = (char)cp;
+        n = 1;
+    } else if (cp < 0x800) {
+        buf[0] = (char)(0xC0 | (cp >> 6));
+        buf[1] = (char)(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        buf[0] = (char)(0xE0 | (cp >> 12));
+        buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = (char)(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        buf[0] = (char)(0xF0 | (cp >> 18));
+        buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[3] = (char)(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    if (*o + n >= out_size) {
         return false;
     }
+    memcpy(out + *o, buf, n);
+    *o += n;
+    return true;
+}
 
-    memcpy(out, start, len);
-    out[len] = '\0';
+// Decodes a string token (escapes already validated by json_parse) into a
+// NUL-terminated buffer. False when it does not fit.
+static bool json_unescape(const char *s, size_t len, char *out, size_t out_size)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = s[i];
+        if (c == '\\') {
+            c = s[++i];
+            switch (c) {
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    uint32_t cp = json_hex4(s + i + 1);
+                    i += 4;
+                    if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < len && s[i + 1] == '\\' && s[i + 2] == 'u') {
+                        uint32_t lo = json_hex4(s + i + 3);
+                        if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    if (cp >= 0xD800 && cp <= 0xDFFF) {
+                        cp = 0xFFFD;    // Unpaired surrogate
+                    }
+                    if (!json_put_utf8(out, out_size, &o, cp)) {
+                        return false;
+                    }
+                    continue;
+                }
+                default: break;     // '"', '\\' and '/' stand for themselves
+            }
+        }
+        if (o + 1 >= out_size) {
+            return false;
+        }
+        out[o++] = c;
+    }
+    out[o] = '\0';
     return true;
 }
 
-bool json_extract_bool_field(const char *body, const char *field, bool *out) {
-    if (!body || !field || !out) {
+bool json_tok_equals(const json_doc_t *doc, int tok, const char *str)
+{
+    if (!json_tok_valid(doc, tok) || doc->toks[tok].type != JSON_TOK_STRING || !str) {
         return false;
     }
+    const json_tok_t *t = &doc->toks[tok];
+    size_t len = (size_t)(t->end - t->start);
+    if (!(t->flags & JSON_TOK_F_ESCAPED)) {
+        return strlen(str) == len && memcmp(doc->js + t->start, str, len) == 0;
+    }
+    char decoded[64];
+    return json_unescape(doc->js + t->start, len, decoded, sizeof(decoded)) && strcmp(decoded, str) == 0;
+}
 
-    char key[64];
-    if (!build_json_field_key(field, key, sizeof(key))) {
+bool json_tok_string(const json_doc_t *doc, int tok, char *out, size_t out_size)
+{
+    if (!json_tok_valid(doc, tok) || doc->toks[tok].type != JSON_TOK_STRING || !out || out_size == 0) {
         return false;
     }
+    const json_tok_t *t = &doc->toks[tok];
+    return json_unescape(doc->js + t->start, (size_t)(t->end - t->start), out, out_size);
+}
 
-    const char *start = strstr(body, key);
-    if (!start) {
+bool json_tok_bool(const json_doc_t *doc, int tok, bool *out)
+{
+    if (!json_tok_valid(doc, tok) || doc->toks[tok].type != JSON_TOK_PRIMITIVE || !out) {
         return false;
     }
-    start += strlen(key);
-    while (*start == ' ' || *start == '\t') {
-        start++;
-    }
-
-    if (strncmp(start, "true", 4) == 0) {
+    const json_tok_t *t = &doc->toks[tok];
+    const char *p = doc->js + t->start;
+    if (t->end - t->start == 4 && memcmp(p, "true", 4) == 0) {
         *out = true;
         return true;
     }
-    if (strncmp(start, "false", 5) == 0) {
+    if (t->end - t->start == 5 && memcmp(p, "false", 5) == 0) {
         *out = false;
         return true;
     }
     return false;
 }
 
-bool json_extract_uint16_field(const char *body, const char *field, uint16_t *out) {
-    if (!body || !field || !out) {
-        return false;
-    }
-
-    char key[64];
-    if (!build_json_field_key(field, key, sizeof(key))) {
-        return false;
-    }
-
-    const char *start = strstr(body, key);
-    if (!start) {
-        return false;
-    }
-    start += strlen(key);
-    while (*start == ' ' || *start == '\t') {
-        start++;
-    }
-    if (!isdigit((unsigned char)*start)) {
+bool json_tok_uint16(const json_doc_t *doc, int tok, uint16_t *out)
+{
+    if (!json_tok_valid(doc, tok) || doc->toks[tok].type != JSON_TOK_PRIMITIVE || !out) {
         return false;
     }
-
+    const json_tok_t *t = &doc->toks[tok];
     uint32_t value = 0;
-    while (isdigit((unsigned char)*start)) {
-        value = (value * 10u) + (uint32_t)(*start - '0');
+    for (uint16_t i = t->start; i < t->end; i++) {
+        if (!json_is_digit(doc->js[i])) {
+            return false;
+        }
+        value = (value * 10u) + (uint32_t)(doc->js[i] - '0');
         if (value > 65535u) {
             return false;
         }
-        start++;
     }
     *out = (uint16_t)value;
     return true;
 }
 
-bool json_extract_float_field(const char *body, const char *field, float *out)
+// Copies a numeric token into a NUL-terminated scratch buffer for strtol/strtof.
+static bool json_tok_number_text(const json_doc_t *doc, int tok, char *buf, size_t buf_size)
 {
-    if (!body || !field || !out) {
+    if (!json_tok_valid(doc, tok) || doc->toks[tok].type != JSON_TOK_PRIMITIVE) {
         return false;
     }
-
-    char key[64];
-    if (!build_json_field_key(field, key, sizeof(key))) {
+    const json_tok_t *t = &doc->toks[tok];
+    size_t len = (size_t)(t->end - t->start);
+    const char first = doc->js[t->start];
+    if (len >= buf_size || (first != '-' && !json_is_digit(first))) {
         return false;
     }
+    memcpy(buf, doc->js + t->start, len);
+    buf[len] = '\0';
+    return true;
+}
 
-    const char *start = strstr(body, key);
-    if (!start) {
+bool json_tok_int(const json_doc_t *doc, int tok, int *out)
+{
+    char buf[24];
+    if (!out || !json_tok_number_text(doc, tok, buf, sizeof(buf))) {
         return false;
     }
-    start += strlen(key);
-    while (*start == ' ' || *start == '\t') {
-        start++;
-    }
-
     char *end;
-    float val = strtof(start, &end);
-    if (end == start) {
+    errno = 0;
+    long value = strtol(buf, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value < INT_MIN || value > INT_MAX) {
         return false;
     }
-    *out = val;
+    *out = (int)value;
     return true;
 }
 
-bool json_extract_int_field(const char *body, const char *field, int *out)
+bool json_tok_float(const json_doc_t *doc, int tok, float *out)
 {
-    if (!body || !field || !out) {
+    char buf[32];
+    if (!out || !json_tok_number_text(doc, tok, buf, sizeof(buf))) {
         return false;
     }
-
-    char key[64];
-    if (!build_json_field_key(field, key, sizeof(key))) {
+    char *end;
+    float value = strtof(buf, &end);
+    if (*end != '\0') {
         return false;
     }
+    *out = value;
+    return true;
+}
 
-    const char *start = strstr(body, key);
-    if (!start) {
-        return false;
+bool json_get_string(const json_doc_t *doc, int obj, const char *key, char *out, size_t out_size)
+{
+    return json_tok_string(doc, json_object_get(doc, obj, key), out, out_size);
+}
+
+bool json_get_bool(const json_doc_t *doc, int obj, const char *key, bool *out)
+{
+    return json_tok_bool(doc, json_object_get(doc, obj, key), out);
+}
+
+bool json_get_uint16(const json_doc_t *doc, int obj, const char *key, uint16_t *out)
+{
+    return json_tok_uint16(doc, json_object_get(doc, obj, key), out);
+}
+
+bool json_get_int(const json_doc_t *doc, int obj, const char *key, int *out)
+{
+    return json_tok_int(doc, json_object_get(doc, obj, key), out);
+}
+
+bool json_get_float(const json_doc_t *doc, int obj, const char *key, float *out)
+{
+    return json_tok_float(doc, json_object_get(doc, obj, key), out);
+}
+
+// Indexes body and returns the value of the first member named field at any
+// depth, in document order, or -1. Keeps the layout rules of the original
+// strstr lookups that the portal contract documents: the colon must follow the
+// key directly, string values must follow the colon directly, and other
+// scalars may only be preceded by spaces or tabs.
+static int json_extract_find(json_doc_t *doc, json_tok_t *toks, const char *body, const char *field)
+{
+    if (!body || !field || json_parse(doc, body, strlen(body), toks, JSON_EXTRACT_MAX_TOKENS) < 0) {
+        return -1;
     }
-    start += strlen(key);
-    while (*start == ' ' || *start == '\t') {
-        start++;
+    for (int i = 0; i < doc->count; i++) {
+        if (!(toks[i].flags & JSON_TOK_F_KEY) || !json_tok_equals(doc, i, field)) {
+            continue;
+        }
+        const json_tok_t *value = &toks[i + 1];
+        size_t colon = (size_t)toks[i].end + 1;
+        if (body[colon] != ':') {
+            return -1;
+        }
+        size_t value_start = value->type == JSON_TOK_STRING ? (size_t)value->start - 1 : value->start;
+        for (size_t p = colon + 1; p < value_start; p++) {
+            bool any_ws = value->type == JSON_TOK_OBJECT || value->type == JSON_TOK_ARRAY;
+            if (value->type == JSON_TOK_STRING || (!any_ws && body[p] != ' ' && body[p] != '\t')) {
+                return -1;
+            }
+        }
+        return i + 1;
     }
+    return -1;
+}
 
-    char *end;
-    long val = strtol(start, &end, 10);
-    if (end == start) {
-        return false;
+static const char *skip_json_ws(const char *p) {
+    while (p && json_is_ws(*p)) {
+        p++;
     }
-    *out = (int)val;
-    return true;
+    return p;
 }
 
-bool json_extract_array_field_span(
-    const char *body, const char *field, const char **start_out, const char **end_out)
-{
-    if (!body || !field || !start_out || !end_out) {
-        return false;
+static const char *json_extract_find_matching_delim(const char *start, char open, char close) {
+    if (!start || *start != open) {
+        return NULL;
     }
 
-    char key[64];
-    if (!build_json_field_key(field, key, sizeof(key))) {
-        return false;
+    int depth = 0;
+    bool in_string = false;
+    bool escape = false;
+    for (const char *p = start; *p; p++) {
+        if (in_string) {
+            if (escape) {
+                escape = false;
+                continue;
+            }
+            if (*p == '\\') {
+                escape = true;
+                continue;
+            }
+            if (*p == '"') {
+                in_string = false;
+            }
+            continue;
+        }
+
+        if (*p == '"') {
+            in_string = true;
+            continue;
+        }
+        if (*p == open) {
+            depth++;
+        } else if (*p == close) {
+            depth--;
+            if (depth == 0) {
+                return p;
+            }
+        }
     }
+    return NULL;
+}
 
-    const char *start = strstr(body, key);
-    if (!start) {
+bool json_extract_string_field(const char *body, const char *field, char *out, size_t out_size) {
+    json_doc_t doc;
+    json_tok_t toks[JSON_EXTRACT_MAX_TOKENS];
+    return json_tok_string(&doc, json_extract_find(&doc, toks, body, field), out, out_size);
+}
+
+bool json_extract_bool_field(const char *body, const char *field, bool *out) {
+    json_doc_t doc;
+    json_tok_t toks[JSON_EXTRACT_MAX_TOKENS];
+    return json_tok_bool(&doc, json_extract_find(&doc, toks, body, field), out);
+}
+
+bool json_extract_uint16_field(const char *body, const char *field, uint16_t *out) {
+    json_doc_t doc;
+    json_tok_t toks[JSON_EXTRACT_MAX_TOKENS];
+    return json_tok_uint16(&doc, json_extract_find(&doc, toks, body, field), out);
+}
+
+bool json_extract_float_field(const char *body, const char *field, float *out)
+{
+    json_doc_t doc;
+    json_tok_t toks[JSON_EXTRACT_MAX_TOKENS];
+    return json_tok_float(&doc, json_extract_find(&doc, toks, body, field), out);
+}
+
+bool json_extract_int_field(const char *body, const char *field, int *out)
+{
+    json_doc_t doc;
+    json_tok_t toks[JSON_EXTRACT_MAX_TOKENS];
+    return json_tok_int(&doc, json_extract_find(&doc, toks, body, field), out);
+}
+
+static bool json_extract_field_span(const char *body, const char *field, json_tok_type_t type,
+                                    const char **start_out, const char **end_out)
+{
+    if (!start_out || !end_out) {
         return false;
     }
-    start += strlen(key);
-    start = skip_json_ws(start);
-    if (!start || *start != '[') {
+    json_doc_t doc;
+    json_tok_t toks[JSON_EXTRACT_MAX_TOKENS];
+    int value = json_extract_find(&doc, toks, body, field);
+    if (value < 0 || toks[value].type != type) {
         return false;
     }
+    *start_out = body + toks[value].start;
+    *end_out = body + toks[value].end - 1;
+    return true;
+}
 
-    const char *end = json_extract_find_matching_delim(start, '[', ']');
-    if (!end) {
-        return false;
-    }
+bool json_extract_array_field_span(
+    const char *body, const char *field, const char **start_out, const char **end_out)
+{
+    return json_extract_field_span(body, field, JSON_TOK_ARRAY, start_out, end_out);
+}
 
-    *start_out = start;
-    *end_out = end;
-    return true;
+bool json_extract_object_field_span(
+    const char *body, const char *field, const char **start_out, const char **end_out)
+{
+    return json_extract_field_span(body, field, JSON_TOK_OBJECT, start_out, end_out);
 }
 
 bool json_extract_next_array_object_span(const char *array_start,
@@ -0,0 +1,371 @@
+#include "control/json_writer.h"
+
+#include <math.h>
+#include <string.h>
+
+static const char k_hex[] = "0123456789ABCDEF";
+
+static void flush(json_writer_t *w, bool final)
+{
+    if (!w->sink || w->failed) {
+        return;
+    }
+    if (!w->sink(w->ctx, w->buf, w->used, final)) {
+        w->failed = true;
+    }
+    w->used = 0;
+}
+
+static void put(json_writer_t *w, const char *data, size_t len)
+{
+    if (w->failed) {
+        return;
+    }
+    w->total += len;
+    while (len > 0) {
+        // Buffer mode keeps the last byte for the NUL.
+        size_t room = w->sink ? w->cap - w->used : (w->cap > w->used + 1 ? w->cap - w->used - 1 : 0);
+        if (room == 0) {
+            if (!w->sink) {
+                w->truncated = true;
+                return;
+            }
+            flush(w, false);
+            if (w->failed) {
+                return;
+            }
+            continue;
+        }
+        size_t n = len < room ? len : room;
+        memcpy(w->buf + w->used, data, n);
+        w->used += n;
+        data += n;
+        len -= n;
+    }
+}
+
+static void put_char(json_writer_t *w, char c)
+{
+    put(w, &c, 1);
+}
+
+// Comma and key bookkeeping shared by every value and key.
+static bool begin_item(json_writer_t *w, bool is_key)
+{
+    if (w->failed) {
+        return false;
+    }
+    if (w->after_key) {
+        if (is_key) {
+            w->failed = true;
+            return false;
+        }
+        w->after_key = false;
+        return true;
+    }
+    if (w->depth == 0) {
+        if (is_key || w->total > 0) {
+            w->failed = true;   // A key outside an object, or a second top-level value
+            return false;
+        }
+        return true;
+    }
+    uint32_t bit = 1U << (w->depth - 1);
+    if (is_key != ((w->in_object & bit) != 0)) {
+        w->failed = true;       // Object members need a key; array elements take none
+        return false;
+    }
+    if (w->has_items & bit) {
+        put_char(w, ',');
+    }
+    w->has_items |= bit;
+    return true;
+}
+
+static void put_escaped(json_writer_t *w, const char *s, size_t len)
+{
+    size_t run = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        char esc = 0;
+        switch (c) {
+            case '"': esc = '"'; break;
+            case '\\': esc = '\\'; break;
+            case '\n': esc = 'n'; break;
+            case '\r': esc = 'r'; break;
+            case '\t': esc = 't'; break;
+            case '\b': esc = 'b'; break;
+            case '\f': esc = 'f'; break;
+            default:
+                if (c >= 0x20) {
+                    continue;
+                }
+                break;
+        }
+        put(w, s + run, i - run);
+        run = i + 1;
+        if (esc) {
+            char pair[2] = { '\\', esc };
+            put(w, pair, sizeof(pair));
+        } else {
+            char u[6] = { '\\', 'u', '0', '0', k_hex[c >> 4], k_hex[c & 0x0F] };
+            put(w, u, sizeof(u));
+        }
+    }
+    put(w, s + run, len - run);
+}
+
+static void put_uint(json_writer_t *w, uint64_t v)
+{
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + (v % 10U));
+        v /= 10U;
+    } while (v > 0);
+    put(w, digits + sizeof(digits) - n, n);
+}
+
+void json_writer_init_buf(json_writer_t *w, char *buf, size_t size)
+{
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = size;
+    if (!buf || size == 0) {
+        w->failed = true;
+        return;
+    }
+    buf[0] = '\0';
+}
+
+void json_writer_init_stream(json_writer_t *w, char *buf, size_t size, json_writer_sink_t sink, void *ctx)
+{
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = size;
+    w->sink = sink;
+    w->ctx = ctx;
+    if (!buf || size == 0 || !sink) {
+        w->failed = true;
+    }
+}
+
+int json_writer_finish(json_writer_t *w)
+{
+    if (w->depth != 0 || w->after_key) {
+        w->failed = true;
+    }
+    if (w->sink) {
+        flush(w, true);
+    } else if (w->buf && w->cap > 0) {
+        w->buf[w->used] = '\0';
+    }
+    if (w->failed || w->total > INT32_MAX) {
+        return -1;
+    }
+    return (int)w->total;
+}
+
+static void open_container(json_writer_t *w, char c)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    if (w->depth >= JSON_WRITER_MAX_DEPTH) {
+        w->failed = true;
+        return;
+    }
+    put_char(w, c);
+    w->depth++;
+    uint32_t bit = 1U << (w->depth - 1);
+    w->has_items &= ~bit;
+    if (c == '{') {
+        w->in_object |= bit;
+    } else {
+        w->in_object &= ~bit;
+    }
+}
+
+static void close_container(json_writer_t *w, char c)
+{
+    if (w->failed) {
+        return;
+    }
+    uint32_t bit = w->depth > 0 ? 1U << (w->depth - 1) : 0;
+    if (w->depth == 0 || w->after_key || ((w->in_object & bit) != 0) != (c == '}')) {
+        w->failed = true;
+        return;
+    }
+    w->depth--;
+    put_char(w, c);
+}
+
+void json_writer_begin_object(json_writer_t *w) { open_container(w, '{'); }
+void json_writer_end_object(json_writer_t *w) { close_container(w, '}'); }
+void json_writer_begin_array(json_writer_t *w) { open_container(w, '['); }
+void json_writer_end_array(json_writer_t *w) { close_container(w, ']'); }
+
+void json_writer_key(json_writer_t *w, const char *key)
+{
+    if (!begin_item(w, true)) {
+        return;
+    }
+    put_char(w, '"');
+    put_escaped(w, key, strlen(key));
+    put(w, "\":", 2);
+    w->after_key = true;
+}
+
+void json_writer_string_n(json_writer_t *w, const char *str, size_t len)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    put_char(w, '"');
+    put_escaped(w, str, len);
+    put_char(w, '"');
+}
+
+void json_writer_string(json_writer_t *w, const char *str)
+{
+    if (!str) {
+        json_writer_null(w);
+        return;
+    }
+    json_writer_string_n(w, str, strlen(str));
+}
+
+void json_writer_uint(json_writer_t *w, uint64_t value)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    put_uint(w, value);
+}
+
+void json_writer_int(json_writer_t *w, int64_t value)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    if (value < 0) {
+        put_char(w, '-');
+        put_uint(w, (uint64_t)0 - (uint64_t)value);
+    } else {
+        put_uint(w, (uint64_t)value);
+    }
+}
+
+void json_writer_bool(json_writer_t *w, bool value)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    if (value) {
+        put(w, "true", 4);
+    } else {
+        put(w, "false", 5);
+    }
+}
+
+void json_writer_null(json_writer_t *w)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    put(w, "null", 4);
+}
+
+void json_writer_float(json_writer_t *w, float value, uint8_t decimals)
+{
+    static const uint32_t k_pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    if (decimals > 6) {
+        decimals = 6;
+    }
+    double scaled = (double)value * k_pow10[decimals];
+    if (!isfinite(scaled) || fabs(scaled) >= 9.2e18) {
+        json_writer_null(w);
+        return;
+    }
+    if (!begin_item(w, false)) {
+        return;
+    }
+
+    int64_t fixed = llround(scaled);
+    uint64_t mag = fixed < 0 ? (uint64_t)0 - (uint64_t)fixed : (uint64_t)fixed;
+    if (fixed < 0) {
+        put_char(w, '-');
+    }
+    put_uint(w, mag / k_pow10[decimals]);
+    if (decimals == 0) {
+        return;
+    }
+
+    char frac[7];
+    uint32_t rem = (uint32_t)(mag % k_pow10[decimals]);
+    frac[0] = '.';
+    for (int i = decimals; i > 0; i--) {
+        frac[i] = (char)('0' + rem % 10U);
+        rem /= 10U;
+    }
+    put(w, frac, (size_t)decimals + 1);
+}
+
+void json_writer_mac(json_writer_t *w, const uint8_t mac[6])
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    char out[19];
+    out[0] = '"';
+    for (int i = 0; i < 6; i++) {
+        out[1 + i * 3] = k_hex[mac[i] >> 4];
+        out[2 + i * 3] = k_hex[mac[i] & 0x0F];
+        out[3 + i * 3] = i < 5 ? ':' : '"';
+    }
+    put(w, out, sizeof(out));
+}
+
+void json_writer_raw(json_writer_t *w, const char *json, size_t len)
+{
+    if (!begin_item(w, false)) {
+        return;
+    }
+    put(w, json, len);
+}
+
+void json_writer_field_string(json_writer_t *w, const char *key, const char *str)
+{
+    json_writer_key(w, key);
+    json_writer_string(w, str);
+}
+
+void json_writer_field_uint(json_writer_t *w, const char *key, uint64_t value)
+{
+    json_writer_key(w, key);
+    json_writer_uint(w, value);
+}
+
+void json_writer_field_int(json_writer_t *w, const char *key, int64_t value)
+{
+    json_writer_key(w, key);
+    json_writer_int(w, value);
+}
+
+void json_writer_field_bool(json_writer_t *w, const char *key, bool value)
+{
+    json_writer_key(w, key);
+    json_writer_bool(w, value);
+}
+
+void json_writer_field_float(json_writer_t *w, const char *key, float value, uint8_t decimals)
+{
+    json_writer_key(w, key);
+    json_writer_float(w, value, decimals);
+}
+
+void json_writer_field_mac(json_writer_t *w, const char *key, const uint8_t mac[6])
+{
+    json_writer_key(w, key);
+    json_writer_mac(w, mac);
+}
@@ -0,0 +1,101 @@
+#include "control/meter_frame.h"
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+size_t meter_frame_encode(const meter_frame_t *frame, uint8_t *out, size_t out_size)
+{
+    if (frame->bin_count > METER_FRAME_MAX_BINS || frame->stream_count > METER_FRAME_MAX_STREAMS) {
+        return 0;
+    }
+    size_t len = METER_FRAME_HEADER_BYTES + frame->bin_count +
+                 (size_t)frame->stream_count * METER_FRAME_STREAM_BYTES;
+    if (len > out_size) {
+        return 0;
+    }
+
+    out[0] = METER_FRAME_MAGIC;
+    out[1] = METER_FRAME_VERSION;
+    out[2] = frame->flags;
+    out[3] = frame->bin_count;
+    put_u16(out + 4, frame->seq);
+    put_u32(out + 6, frame->ts_ms);
+    out[10] = frame->buffer_fill_pct;
+    out[11] = frame->stream_count;
+
+    uint8_t *p = out + METER_FRAME_HEADER_BYTES;
+    for (uint8_t i = 0; i < frame->bin_count; i++) {
+        *p++ = frame->bins[i];
+    }
+    for (uint8_t i = 0; i < frame->stream_count; i++) {
+        const meter_frame_stream_t *s = &frame->streams[i];
+        p[0] = s->id;
+        put_u16(p + 1, s->peak_q15);
+        put_u16(p + 3, s->rms_q15);
+        p += METER_FRAME_STREAM_BYTES;
+    }
+    return len;
+}
+
+bool meter_frame_decode(const uint8_t *data, size_t len, meter_frame_t *frame)
+{
+    if (len < METER_FRAME_HEADER_BYTES || data[0] != METER_FRAME_MAGIC || data[1] == 0) {
+        return false;
+    }
+    uint8_t bin_count = data[3];
+    uint8_t stream_count = data[11];
+    if (bin_count > METER_FRAME_MAX_BINS || stream_count > METER_FRAME_MAX_STREAMS ||
+        len < METER_FRAME_HEADER_BYTES + bin_count + (size_t)stream_count * METER_FRAME_STREAM_BYTES) {
+        return false;
+    }
+
+    frame->version = data[1];
+    frame->flags = data[2];
+    frame->bin_count = bin_count;
+    frame->seq = get_u16(data + 4);
+    frame->ts_ms = get_u32(data + 6);
+    frame->buffer_fill_pct = data[10];
+    frame->stream_count = stream_count;
+
+    const uint8_t *p = data + METER_FRAME_HEADER_BYTES;
+    for (uint8_t i = 0; i < bin_count; i++) {
+        frame->bins[i] = *p++;
+    }
+    for (uint8_t i = 0; i < stream_count; i++) {
+        frame->streams[i].id = p[0];
+        frame->streams[i].peak_q15 = get_u16(p + 1);
+        frame->streams[i].rms_q15 = get_u16(p + 3);
+        p += METER_FRAME_STREAM_BYTES;
+    }
+    return true;
+}
+
+uint8_t meter_frame_quantize_bin(float norm)
+{
+    if (!(norm > 0.0f)) {
+        return 0;       // Also NaN
+    }
+    if (norm >= 1.0f) {
+        return 255;
+    }
+    return (uint8_t)(norm * 255.0f + 0.5f);
+}
@@ -0,0 +1,302 @@
+#include "control/node_table.h"
+
+#include <string.h>
+
+#define INDEX_MASK (NODE_TABLE_INDEX_SLOTS - 1)
+#define WHEEL_MASK (NODE_TABLE_WHEEL_SLOTS - 1)
+// Latest deadline the wheel can hold without aliasing onto the current tick.
+#define WHEEL_MAX_EXPIRE_MS ((uint32_t)(NODE_TABLE_WHEEL_SLOTS - 2) * NODE_TABLE_WHEEL_TICK_MS)
+
+static uint32_t mac_hash(const uint8_t mac[6])
+{
+    // FNV-1a, as in the link table; the low MAC bytes carry most of the entropy.
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 6; i++) {
+        h ^= mac[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Index slot holding mac, or the empty slot where it would go.
+static uint32_t index_probe(const node_table_t *t, const uint8_t mac[6])
+{
+    uint32_t slot = mac_hash(mac) & INDEX_MASK;
+    while (t->index[slot] != NODE_TABLE_NONE && memcmp(t->mac[t->index[slot]], mac, 6) != 0) {
+        slot = (slot + 1) & INDEX_MASK;
+    }
+    return slot;
+}
+
+// Backward-shift deletion: pull later members of the probe run into the gap
+// so lookups never need tombstones.
+static void index_delete(node_table_t *t, uint32_t hole)
+{
+    uint32_t j = hole;
+    while (1) {
+        j = (j + 1) & INDEX_MASK;
+        if (t->index[j] == NODE_TABLE_NONE) {
+            break;
+        }
+        uint32_t home = mac_hash(t->mac[t->index[j]]) & INDEX_MASK;
+        // Movable unless home lies cyclically in (hole, j].
+        bool stays = hole <= j ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!stays) {
+            t->index[hole] = t->index[j];
+            hole = j;
+        }
+    }
+    t->index[hole] = NODE_TABLE_NONE;
+}
+
+static uint32_t deadline_tick(const node_table_t *t, int idx)
+{
+    int64_t deadline_ms = t->last_seen_ms[idx] + t->expire_ms;
+    return (uint32_t)((deadline_ms + NODE_TABLE_WHEEL_TICK_MS - 1) / NODE_TABLE_WHEEL_TICK_MS);
+}
+
+static void wheel_link(node_table_t *t, int idx, uint32_t tick)
+{
+    uint8_t b = (uint8_t)(tick & WHEEL_MASK);
+    t->wheel_slot[idx] = b;
+    t->wheel_prev[idx] = NODE_TABLE_NONE;
+    t->wheel_next[idx] = t->wheel_head[b];
+    if (t->wheel_head[b] != NODE_TABLE_NONE) {
+        t->wheel_prev[t->wheel_head[b]] = (uint8_t)idx;
+    }
+    t->wheel_head[b] = (uint8_t)idx;
+}
+
+static void wheel_unlink(node_table_t *t, int idx)
+{
+    uint8_t prev = t->wheel_prev[idx];
+    uint8_t next = t->wheel_next[idx];
+    if (prev != NODE_TABLE_NONE) {
+        t->wheel_next[prev] = next;
+    } else {
+        t->wheel_head[t->wheel_slot[idx]] = next;
+    }
+    if (next != NODE_TABLE_NONE) {
+        t->wheel_prev[next] = prev;
+    }
+}
+
+// Files idx under its deadline. Routed nodes are held by the routing table,
+// and anything already due waits for the next tick; both only get looked at
+// again when their bucket comes round.
+static void wheel_schedule(node_table_t *t, int idx)
+{
+    uint32_t tick = deadline_tick(t, idx);
+    if (t->flags[idx] & NODE_TABLE_F_ROUTED) {
+        tick = t->wheel_tick + NODE_TABLE_WHEEL_SLOTS - 1;
+    } else if (tick <= t->wheel_tick) {
+        tick = t->wheel_tick + 1;
+    }
+    wheel_link(t, idx, tick);
+}
+
+static void wheel_start(node_table_t *t, int64_t now_ms)
+{
+    if (!t->wheel_started) {
+        t->wheel_tick = (uint32_t)(now_ms / NODE_TABLE_WHEEL_TICK_MS);
+        t->wheel_started = true;
+    }
+}
+
+void node_table_init(node_table_t *t, uint32_t expire_ms)
+{
+    memset(t, 0, sizeof(*t));
+    t->expire_ms = expire_ms < WHEEL_MAX_EXPIRE_MS ? expire_ms : WHEEL_MAX_EXPIRE_MS;
+    memset(t->index, NODE_TABLE_NONE, sizeof(t->index));
+    memset(t->wheel_head, NODE_TABLE_NONE, sizeof(t->wheel_head));
+}
+
+int node_table_find(const node_table_t *t, const uint8_t mac[6])
+{
+    uint8_t idx = t->index[index_probe(t, mac)];
+    return idx == NODE_TABLE_NONE ? -1 : idx;
+}
+
+int node_table_touch(node_table_t *t, const uint8_t mac[6], int64_t now_ms)
+{
+    wheel_start(t, now_ms);
+    uint32_t slot = index_probe(t, mac);
+    int idx = t->index[slot];
+    if (idx != NODE_TABLE_NONE) {
+        // The wheel entry stays where it is; its bucket reschedules it lazily.
+        t->last_seen_ms[idx] = now_ms;
+        return idx;
+    }
+    if (t->count >= NODE_TABLE_CAPACITY) {
+        return -1;
+    }
+
+    idx = t->count++;
+    memcpy(t->mac[idx], mac, 6);
+    memset(t->parent_mac[idx], 0, 6);
+    t->role[idx] = 0;
+    t->is_root[idx] = 0;
+    t->layer[idx] = 0;
+    t->rssi[idx] = 0;
+    t->children[idx] = 0;
+    t->stream_active[idx] = 0;
+    t->uptime_ms[idx] = 0;
+    t->x[idx] = 0.0f;
+    t->y[idx] = 0.0f;
+    t->z[idx] = 0.0f;
+    t->last_seen_ms[idx] = now_ms;
+    t->flags[idx] = 0;
+    t->index[slot] = (uint8_t)idx;
+    wheel_schedule(t, idx);
+    return idx;
+}
+
+void node_table_pin(node_table_t *t, int idx)
+{
+    if (!(t->flags[idx] & NODE_TABLE_F_PINNED)) {
+        wheel_unlink(t, idx);
+        t->flags[idx] |= NODE_TABLE_F_PINNED;
+    }
+}
+
+static void move_node(node_table_t *t, int from, int to)
+{
+    memcpy(t->mac[to], t->mac[from], 6);
+    memcpy(t->parent_mac[to], t->parent_mac[from], 6);
+    t->role[to] = t->role[from];
+    t->is_root[to] = t->is_root[from];
+    t->layer[to] = t->layer[from];
+    t->rssi[to] = t->rssi[from];
+    t->children[to] = t->children[from];
+    t->stream_active[to] = t->stream_active[from];
+    t->uptime_ms[to] = t->uptime_ms[from];
+    t->x[to] = t->x[from];
+    t->y[to] = t->y[from];
+    t->z[to] = t->z[from];
+    t->last_seen_ms[to] = t->last_seen_ms[from];
+    t->flags[to] = t->flags[from];
+
+    t->index[index_probe(t, t->mac[to])] = (uint8_t)to;
+    if (!(t->flags[to] & NODE_TABLE_F_PINNED)) {
+        uint8_t prev = t->wheel_prev[from];
+        uint8_t next = t->wheel_next[from];
+        t->wheel_slot[to] = t->wheel_slot[from];
+        t->wheel_prev[to] = prev;
+        t->wheel_next[to] = next;
+        if (prev != NODE_TABLE_NONE) {
+            t->wheel_next[prev] = (uint8_t)to;
+        } else {
+            t->wheel_head[t->wheel_slot[to]] = (uint8_t)to;
+        }
+        if (next != NODE_TABLE_NONE) {
+            t->wheel_prev[next] = (uint8_t)to;
+        }
+    }
+}
+
+void node_table_remove(node_table_t *t, int idx)
+{
+    if (idx < 0 || idx >= t->count) {
+        return;
+    }
+    index_delete(t, index_probe(t, t->mac[idx]));
+    if (!(t->flags[idx] & NODE_TABLE_F_PINNED)) {
+        wheel_unlink(t, idx);
+    }
+    int last = --t->count;
+    if (idx != last) {
+        move_node(t, last, idx);
+    }
+}
+
+size_t node_table_expire(node_table_t *t, int64_t now_ms)
+{
+    if (!t->wheel_started) {
+        wheel_start(t, now_ms);
+        return 0;
+    }
+    uint32_t now_tick = (uint32_t)(now_ms / NODE_TABLE_WHEEL_TICK_MS);
+    if (now_tick <= t->wheel_tick) {
+        return 0;
+    }
+    // After a long gap one revolution still visits every bucket.
+    if (now_tick - t->wheel_tick > NODE_TABLE_WHEEL_SLOTS) {
+        t->wheel_tick = now_tick - NODE_TABLE_WHEEL_SLOTS;
+    }
+
+    size_t removed = 0;
+    while (t->wheel_tick < now_tick) {
+        t->wheel_tick++;
+        uint8_t b = (uint8_t)(t->wheel_tick & WHEEL_MASK);
+
+        // Detach the bucket, then reschedule survivors and collect the dead.
+        uint8_t due[NODE_TABLE_CAPACITY];
+        int due_count = 0;
+        uint8_t idx = t->wheel_head[b];
+        t->wheel_head[b] = NODE_TABLE_NONE;
+        while (idx != NODE_TABLE_NONE) {
+            uint8_t next = t->wheel_next[idx];
+            if (!(t->flags[idx] & NODE_TABLE_F_ROUTED) &&
+                t->last_seen_ms[idx] + t->expire_ms <= now_ms) {
+                // Relinked so remove can unlink it like any other node.
+                wheel_link(t, idx, t->wheel_tick);
+                due[due_count++] = idx;
+            } else {
+                wheel_schedule(t, idx);
+            }
+            idx = next;
+        }
+
+        // Highest index first: the node swapped into each hole is never one
+        // still waiting to be removed.
+        for (int i = 1; i < due_count; i++) {
+            for (int j = i; j > 0 && due[j - 1] < due[j]; j--) {
+                uint8_t tmp = due[j];
+                due[j] = due[j - 1];
+                due[j - 1] = tmp;
+            }
+        }
+        for (int i = 0; i < due_count; i++) {
+            node_table_remove(t, due[i]);
+        }
+        removed += (size_t)due_count;
+    }
+    return removed;
+}
+
+size_t node_table_sync_routes(node_table_t *t, const uint8_t (*macs)[6], size_t count, int64_t now_ms)
+{
+    bool listed[NODE_TABLE_CAPACITY] = { false };
+    size_t changes = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int idx = node_table_find(t, macs[i]);
+        if (idx < 0) {
+            idx = node_table_touch(t, macs[i], now_ms);
+            if (idx < 0) {
+                continue;
+            }
+            changes++;
+        }
+        if (!(t->flags[idx] & NODE_TABLE_F_ROUTED)) {
+            t->flags[idx] |= NODE_TABLE_F_ROUTED;
+        }
+        listed[idx] = true;
+    }
+
+    // Walk down so the node swapped into a hole has already been visited.
+    for (int idx = (int)t->count - 1; idx >= 0; idx--) {
+        if (!(t->flags[idx] & NODE_TABLE_F_ROUTED) || listed[idx]) {
+            continue;
+        }
+        if (t->flags[idx] & NODE_TABLE_F_PINNED) {
+            t->flags[idx] &= (uint8_t)~NODE_TABLE_F_ROUTED;
+            continue;
+        }
+        int last = t->count - 1;
+        node_table_remove(t, idx);
+        listed[idx] = listed[last];
+        changes++;
+    }
+    return changes;
+}
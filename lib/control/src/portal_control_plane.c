@@ -4,7 +4,6 @@
 
 #include <esp_log.h>
 #include <esp_timer.h>
-#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -198,34 +197,39 @@ esp_err_t portal_control_plane_send_rate_limited(httpd_req_t *req)
     return ESP_OK;
 }
 
+void portal_control_plane_write_metrics_json(json_writer_t *w)
+{
+    json_writer_begin_object(w);
+    json_writer_field_uint(w, "schemaVersion", PORTAL_CONTROL_METRICS_SCHEMA_VERSION);
+    json_writer_field_uint(w, "authRejects", s_auth_reject_count);
+    json_writer_field_uint(w, "otaRejects", s_ota_rate_limit.rejected_count);
+    json_writer_field_uint(w, "uplinkRejects", s_uplink_rate_limit.rejected_count);
+    json_writer_field_uint(w, "mixerRejects", s_mixer_rate_limit.rejected_count);
+    json_writer_field_uint(w, "meshPosRejects", s_mesh_pos_rate_limit.rejected_count);
+    json_writer_field_uint(w, "otaRequests", s_ota_requests_total);
+    json_writer_field_uint(w, "uplinkRequests", s_uplink_requests_total);
+    json_writer_field_uint(w, "mixerRequests", s_mixer_requests_total);
+    json_writer_field_uint(w, "meshPosRequests", s_mesh_pos_requests_total);
+    json_writer_field_uint(w, "otaApplyFails", s_ota_apply_fail_count);
+    json_writer_field_uint(w, "uplinkApplyFails", s_uplink_apply_fail_count);
+    json_writer_field_uint(w, "mixerApplyFails", s_mixer_apply_fail_count);
+    json_writer_field_uint(w, "meshPosApplyFails", s_mesh_pos_apply_fail_count);
+    json_writer_field_uint(w, "badRequests", s_bad_request_count);
+    json_writer_key(w, "rateLimit");
+    json_writer_begin_object(w);
+    json_writer_field_uint(w, "windowMs", PORTAL_CONTROL_RATE_LIMIT_WINDOW_MS);
+    json_writer_field_uint(w, "maxRequests", PORTAL_CONTROL_RATE_LIMIT_MAX_REQUESTS);
+    json_writer_end_object(w);
+    json_writer_end_object(w);
+}
+
 int portal_control_plane_serialize_metrics_json(char *buf, size_t buf_len)
 {
     if (!buf || buf_len == 0) {
         return 0;
     }
-    return snprintf(
-        buf,
-        buf_len,
-        "{\"schemaVersion\":%u,\"authRejects\":%lu,\"otaRejects\":%lu,\"uplinkRejects\":%lu,\"mixerRejects\":%lu,\"meshPosRejects\":%lu,"
-        "\"otaRequests\":%lu,\"uplinkRequests\":%lu,\"mixerRequests\":%lu,\"meshPosRequests\":%lu,"
-        "\"otaApplyFails\":%lu,\"uplinkApplyFails\":%lu,\"mixerApplyFails\":%lu,\"meshPosApplyFails\":%lu,"
-        "\"badRequests\":%lu,"
-        "\"rateLimit\":{\"windowMs\":%u,\"maxRequests\":%u}}",
-        (unsigned)PORTAL_CONTROL_METRICS_SCHEMA_VERSION,
-        (unsigned long)s_auth_reject_count,
-        (unsigned long)s_ota_rate_limit.rejected_count,
-        (unsigned long)s_uplink_rate_limit.rejected_count,
-        (unsigned long)s_mixer_rate_limit.rejected_count,
-        (unsigned long)s_mesh_pos_rate_limit.rejected_count,
-        (unsigned long)s_ota_requests_total,
-        (unsigned long)s_uplink_requests_total,
-        (unsigned long)s_mixer_requests_total,
-        (unsigned long)s_mesh_pos_requests_total,
-        (unsigned long)s_ota_apply_fail_count,
-        (unsigned long)s_uplink_apply_fail_count,
-        (unsigned long)s_mixer_apply_fail_count,
-        (unsigned long)s_mesh_pos_apply_fail_count,
-        (unsigned long)s_bad_request_count,
-        (unsigned)PORTAL_CONTROL_RATE_LIMIT_WINDOW_MS,
-        (unsigned)PORTAL_CONTROL_RATE_LIMIT_MAX_REQUESTS);
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, buf_len);
+    portal_control_plane_write_metrics_json(&w);
+    return json_writer_finish(&w);
 }
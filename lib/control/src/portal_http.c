@@ -3,81 +3,147 @@
 #include "control/portal_state.h"
 #include "control/portal_ota.h"
 #include "control/json_extract.h"
+#include "control/portal_json_decode.h"
+#include "control/portal_json_encode.h"
+#include "control/json_writer.h"
+#include "control/serial_dashboard.h"
+#include "control/telemetry.h"
+#include "control/ws_hub.h"
+#include "control/asset_bundle.h"
+#include "control/meter_frame.h"
+#include "audio/adf_pipeline.h"
+#include "network/mesh_net.h"
 #include "network/uplink_control.h"
 #include "network/mixer_control.h"
 #include "config/build.h"
 #include <esp_log.h>
 #include <esp_http_server.h>
-#include <esp_spiffs.h>
-#include <esp_vfs.h>
+#include <esp_partition.h>
 #include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 #include <string.h>
 #include <math.h>
-#include <sys/stat.h>
+#include <sys/select.h>
 
 #if BUILD_HAS_PORTAL
 
 static const char *TAG = "portal_http";
 static httpd_handle_t server = NULL;
-static int ws_fd = -1;
 static TaskHandle_t ws_push_task_handle = NULL;
-static char ws_json_buf[1024];
+static TaskHandle_t ws_meter_task_handle = NULL;
+static char ws_json_buf[PORTAL_JSON_CHUNK_BYTES];
 
-static void init_spiffs(void) {
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs", .partition_label = NULL,
-        .max_files = 5, .format_if_mount_failed = false
-    };
-    esp_vfs_spiffs_register(&conf);
-}
+// The UI is one precompressed bundle mapped straight from flash (see
+// asset_bundle.h). Every header is precomputed, so serving an asset is a
+// lookup and a single send from the mapping.
+static asset_bundle_t s_assets;
+static bool s_assets_ready = false;
+static esp_partition_mmap_handle_t s_assets_map;
 
-static esp_err_t handle_static(httpd_req_t *req) {
-    char path[128];
-    if (strcmp(req->uri, "/") == 0) strcpy(path, "/spiffs/index.html");
-    else snprintf(path, sizeof(path), "/spiffs%s", req->uri);
-    
-    struct stat st;
-    if (stat(path, &st) != 0) {
-        httpd_resp_send_404(req);
-        return ESP_OK;
+static void mount_assets(void) {
+    if (s_assets_ready) return;
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           PORTAL_ASSETS_SUBTYPE, PORTAL_ASSETS_PARTITION);
+    if (!part) {
+        ESP_LOGW(TAG, "No '%s' partition; portal UI unavailable", PORTAL_ASSETS_PARTITION);
+        return;
     }
-
-    FILE *f = fopen(path, "r");
-    if (!f) {
-        httpd_resp_send_500(req);
-        return ESP_OK;
+    uint8_t hdr[ASSET_BUNDLE_HEADER_BYTES];
+    uint32_t size = 0;
+    if (esp_partition_read(part, 0, hdr, sizeof(hdr)) == ESP_OK) size = asset_bundle_size(hdr, sizeof(hdr));
+    if (size == 0 || size > part->size) {
+        ESP_LOGW(TAG, "Portal asset bundle missing or invalid; flash it with `pio run -t upload`");
+        return;
+    }
+    const void *base = NULL;
+    if (esp_partition_mmap(part, 0, size, ESP_PARTITION_MMAP_DATA, &base, &s_assets_map) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to map portal asset bundle");
+        return;
     }
+    if (!asset_bundle_open(&s_assets, base, size)) {
+        ESP_LOGW(TAG, "Portal asset bundle failed validation");
+        esp_partition_munmap(s_assets_map);
+        return;
+    }
+    s_assets_ready = true;
+    ESP_LOGI(TAG, "Portal assets: %u files, %lu bytes", s_assets.count, (unsigned long)size);
+}
 
-    if (strstr(path, ".js")) httpd_resp_set_type(req, "application/javascript");
-    else if (strstr(path, ".css")) httpd_resp_set_type(req, "text/css");
-    else if (strstr(path, ".html")) httpd_resp_set_type(req, "text/html");
-    
-    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+// False when the URI is not an asset, so the caller can fall back.
+static bool serve_asset(httpd_req_t *req) {
+    if (!s_assets_ready) return false;
+    char path[PORTAL_ASSET_PATH_MAX];
+    size_t len = strcspn(req->uri, "?#");
+    if (len >= sizeof(path)) return false;
+    memcpy(path, req->uri, len);
+    path[len] = '\0';
+    if (strcmp(path, "/") == 0) strcpy(path, "/index.html");
+
+    asset_bundle_entry_t asset;
+    if (!asset_bundle_find(&s_assets, path, &asset)) return false;
 
-    char buf[1024];
-    size_t read;
-    while ((read = fread(buf, 1, sizeof(buf), f)) > 0) {
-        httpd_resp_send_chunk(req, buf, read);
+    httpd_resp_set_hdr(req, "ETag", asset.etag);
+    httpd_resp_set_hdr(req, "Cache-Control", asset.cache_control);
+    char inm[96];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK &&
+        asset_bundle_etag_matches(inm, asset.etag)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        httpd_resp_send(req, NULL, 0);
+        return true;
     }
-    fclose(f);
-    httpd_resp_send_chunk(req, NULL, 0);
+    httpd_resp_set_type(req, asset.content_type);
+    if (asset.flags & ASSET_BUNDLE_F_GZIP) httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_send(req, (const char *)asset.data, asset.len);
+    return true;
+}
+
+static esp_err_t handle_static(httpd_req_t *req) {
+    if (!serve_asset(req)) httpd_resp_send_404(req);
     return ESP_OK;
 }
 
-static esp_err_t handle_api_status(httpd_req_t *req) {
-    char buf[1024];
-    int len = portal_state_serialize_json(buf, sizeof(buf));
+// JSON responses are streamed as chunked transfer: the writer fills a
+// PORTAL_JSON_CHUNK_BYTES stack buffer and sends it each time it fills.
+static bool http_chunk_sink(void *ctx, const char *data, size_t len, bool final) {
+    httpd_req_t *req = (httpd_req_t *)ctx;
+    if (len > 0 && httpd_resp_send_chunk(req, data, len) != ESP_OK) return false;
+    return !final || httpd_resp_send_chunk(req, NULL, 0) == ESP_OK;
+}
+
+static esp_err_t send_json_stream(httpd_req_t *req, void (*write)(json_writer_t *w)) {
+    char chunk[PORTAL_JSON_CHUNK_BYTES];
+    json_writer_t w;
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, buf, len);
+    json_writer_init_stream(&w, chunk, sizeof(chunk), http_chunk_sink, req);
+    write(&w);
+    if (json_writer_finish(&w) < 0) {
+        ESP_LOGW(TAG, "JSON stream aborted on %s", req->uri);
+        return ESP_FAIL;
+    }
     return ESP_OK;
 }
 
+static void write_uplink_json(json_writer_t *w) {
+    network_uplink_status_t st;
+    if (network_get_uplink_status(&st) == ESP_OK) uplink_status_write_json(w, &st);
+    else json_writer_null(w);
+}
+
+static void write_mixer_json(json_writer_t *w) {
+    network_mixer_status_t st;
+    if (network_get_mixer_state(&st) == ESP_OK) mixer_status_write_json(w, &st);
+    else json_writer_null(w);
+}
+
+static esp_err_t handle_api_status(httpd_req_t *req) {
+    return send_json_stream(req, portal_state_write_json);
+}
+
 static esp_err_t handle_api_ota(httpd_req_t *req) {
     if (req->method == HTTP_GET) {
-        char buf[256];
-        int len = portal_ota_serialize_json(buf, sizeof(buf));
-        httpd_resp_set_type(req, "application/json");
-        return httpd_resp_send(req, buf, len);
+        return send_json_stream(req, portal_ota_write_json);
     }
     
     portal_control_plane_record_request(PORTAL_CONTROL_ENDPOINT_OTA);
@@ -89,7 +155,7 @@ static esp_err_t handle_api_ota(httpd_req_t *req) {
     body[r] = 0;
 
     char url[128];
-    if (json_extract_string_field(body, "\"url\"", url, sizeof(url))) {
+    if (json_extract_string_field(body, "url", url, sizeof(url))) {
         if (portal_ota_start(url) == ESP_OK) {
             httpd_resp_send(req, "{\"status\":\"started\"}", -1);
         } else {
@@ -100,17 +166,11 @@ static esp_err_t handle_api_ota(httpd_req_t *req) {
     return ESP_OK;
 }
 
-// These are missing in headers but present in .c files - we will add them locally for now
-extern int uplink_ctrl_serialize_json(char *buf, size_t buf_len);
-extern esp_err_t uplink_ctrl_decode_json(const char *json, uplink_ctrl_message_t *msg);
 extern esp_err_t uplink_ctrl_apply(const uplink_ctrl_message_t *msg);
 
 static esp_err_t handle_api_uplink(httpd_req_t *req) {
     if (req->method == HTTP_GET) {
-        char buf[256];
-        int len = uplink_ctrl_serialize_json(buf, sizeof(buf));
-        httpd_resp_set_type(req, "application/json");
-        return httpd_resp_send(req, buf, len);
+        return send_json_stream(req, write_uplink_json);
     }
     
     portal_control_plane_record_request(PORTAL_CONTROL_ENDPOINT_UPLINK);
@@ -122,27 +182,24 @@ static esp_err_t handle_api_uplink(httpd_req_t *req) {
     body[r] = 0;
 
     uplink_ctrl_message_t msg;
-    if (uplink_ctrl_decode_json(body, &msg) == ESP_OK) {
-        if (uplink_ctrl_apply(&msg) == ESP_OK) {
-            httpd_resp_send(req, "{\"status\":\"applied\"}", -1);
-        } else {
-            httpd_resp_set_status(req, "409 Conflict");
-            httpd_resp_send(req, "{\"error\":\"apply failed\"}", -1);
-        }
+    if (uplink_ctrl_decode_json(body, &msg) != ESP_OK) {
+        httpd_resp_set_status(req, "400 Bad Request");
+        return httpd_resp_send(req, "{\"error\":\"invalid body\"}", -1);
+    }
+    if (uplink_ctrl_apply(&msg) == ESP_OK) {
+        httpd_resp_send(req, "{\"status\":\"applied\"}", -1);
+    } else {
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_send(req, "{\"error\":\"apply failed\"}", -1);
     }
     return ESP_OK;
 }
 
-extern int mixer_ctrl_serialize_json(char *buf, size_t buf_len);
-extern esp_err_t mixer_ctrl_decode_json(const char *json, mixer_ctrl_message_t *msg);
 extern esp_err_t mixer_ctrl_apply(const mixer_ctrl_message_t *msg);
 
 static esp_err_t handle_api_mixer(httpd_req_t *req) {
     if (req->method == HTTP_GET) {
-        char buf[512];
-        int len = mixer_ctrl_serialize_json(buf, sizeof(buf));
-        httpd_resp_set_type(req, "application/json");
-        return httpd_resp_send(req, buf, len);
+        return send_json_stream(req, write_mixer_json);
     }
     
     portal_control_plane_record_request(PORTAL_CONTROL_ENDPOINT_MIXER);
@@ -153,14 +210,21 @@ static esp_err_t handle_api_mixer(httpd_req_t *req) {
     if (r <= 0) return ESP_FAIL;
     body[r] = 0;
 
-    mixer_ctrl_message_t msg;
-    if (mixer_ctrl_decode_json(body, &msg) == ESP_OK) {
-        if (mixer_ctrl_apply(&msg) == ESP_OK) {
-            httpd_resp_send(req, "{\"status\":\"applied\"}", -1);
-        } else {
-            httpd_resp_set_status(req, "409 Conflict");
-            httpd_resp_send(req, "{\"error\":\"apply failed\"}", -1);
-        }
+    // Bodies without outGainPct keep the current output gain.
+    mixer_ctrl_message_t msg = {0};
+    network_mixer_status_t current;
+    if (network_get_mixer_state(&current) == ESP_OK) {
+        msg.out_gain_pct = current.out_gain_pct;
+    }
+    if (mixer_ctrl_decode_json(body, &msg) != ESP_OK) {
+        httpd_resp_set_status(req, "400 Bad Request");
+        return httpd_resp_send(req, "{\"error\":\"invalid body\"}", -1);
+    }
+    if (mixer_ctrl_apply(&msg) == ESP_OK) {
+        httpd_resp_send(req, "{\"status\":\"applied\"}", -1);
+    } else {
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_send(req, "{\"error\":\"apply failed\"}", -1);
     }
     return ESP_OK;
 }
@@ -179,14 +243,12 @@ static esp_err_t handle_api_mesh_positions(httpd_req_t *req) {
 }
 
 static esp_err_t handle_api_control_metrics(httpd_req_t *req) {
-    char buf[512];
-    int len = portal_control_plane_serialize_metrics_json(buf, sizeof(buf));
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, buf, len);
-    return ESP_OK;
+    return send_json_stream(req, portal_control_plane_write_metrics_json);
 }
 
+// Anything that is not a bundled asset is a captive-portal probe.
 static esp_err_t handle_captive_redirect(httpd_req_t *req) {
+    if (serve_asset(req)) return ESP_OK;
     const esp_netif_ip_info_t *info = portal_get_ip_info();
     if (!info) return ESP_FAIL;
     char loc[64];
@@ -198,29 +260,410 @@ static esp_err_t handle_captive_redirect(httpd_req_t *req) {
 }
 
 #if CONFIG_HTTPD_WS_SUPPORT
+// /ws subscribers share one hub. Each client gets a full snapshot of its
+// topics, then {"type":"delta"} messages carrying only what changed; a
+// client sends {"subscribe":["nodes","meters",...]} to change topics.
+// handle_ws runs on the httpd task and edits the client table under
+// s_hub_lock. The pass state (hashes, changes) belongs to the push task, which
+// plans under the lock and sends without it.
+#define WS_TOPIC_BIT(t)     ((uint8_t)(1U << (t)))
+#define WS_DEFAULT_TOPICS   ((uint8_t)(WS_TOPIC_BIT(PORTAL_TOPIC_COUNT) - 1U) & (uint8_t)~WS_TOPIC_BIT(PORTAL_TOPIC_LOGS))
+
+_Static_assert(PORTAL_MAX_NODES <= WS_HUB_MAX_ITEMS, "ws_hub must track every portal node");
+_Static_assert(PORTAL_TOPIC_COUNT <= 8, "ws_hub topics are a uint8_t mask");
+
+static ws_hub_t s_hub;
+static SemaphoreHandle_t s_hub_lock = NULL;
+static uint32_t s_log_seq = 0;     // Newest monitor line already pushed as a delta
+
+static void ws_wake_push_task(void) {
+    if (ws_push_task_handle) xTaskNotifyGive(ws_push_task_handle);
+}
+
+static bool ws_parse_topics(const char *body, size_t len, uint8_t *topics) {
+    json_tok_t toks[16];
+    json_doc_t doc;
+    if (json_parse(&doc, body, len, toks, sizeof(toks) / sizeof(toks[0])) < 0) return false;
+    int arr = json_object_get_type(&doc, 0, "subscribe", JSON_TOK_ARRAY);
+    if (arr < 0) return false;
+
+    uint8_t mask = 0;
+    for (int tok = json_first_child(&doc, arr); tok >= 0; tok = json_next_sibling(&doc, arr, tok)) {
+        for (int t = 0; t < PORTAL_TOPIC_COUNT; t++) {
+            if (json_tok_equals(&doc, tok, portal_topic_names[t])) mask |= WS_TOPIC_BIT(t);
+        }
+    }
+    *topics = mask;
+    return true;
+}
+
 static esp_err_t handle_ws(httpd_req_t *req) {
+    int fd = httpd_req_to_sockfd(req);
     if (req->method == HTTP_GET) {
-        ws_fd = httpd_req_to_sockfd(req);
+        xSemaphoreTake(s_hub_lock, portMAX_DELAY);
+        bool added = ws_hub_add_client(&s_hub, fd, WS_DEFAULT_TOPICS);
+        xSemaphoreGive(s_hub_lock);
+        if (!added) {
+            ESP_LOGW(TAG, "WS: %d clients already connected, refusing fd %d", PORTAL_WS_MAX_CLIENTS, fd);
+            return ESP_FAIL;
+        }
+        ws_wake_push_task();
         return ESP_OK;
     }
+
     httpd_ws_frame_t pkt;
     memset(&pkt, 0, sizeof(pkt));
-    return httpd_ws_recv_frame(req, &pkt, 0);
+    esp_err_t ret = httpd_ws_recv_frame(req, &pkt, 0);
+    if (ret != ESP_OK) return ret;
+    if (pkt.len > PORTAL_WS_MAX_RX_BYTES) return ESP_FAIL;   // Unread payload would desync the stream
+    if (pkt.type != HTTPD_WS_TYPE_TEXT || pkt.len == 0) return ESP_OK;
+
+    uint8_t body[PORTAL_WS_MAX_RX_BYTES];
+    pkt.payload = body;
+    ret = httpd_ws_recv_frame(req, &pkt, sizeof(body));
+    if (ret != ESP_OK) return ret;
+
+    uint8_t topics;
+    if (!ws_parse_topics((const char *)body, pkt.len, &topics)) return ESP_OK;
+    xSemaphoreTake(s_hub_lock, portMAX_DELAY);
+    ws_hub_set_topics(&s_hub, fd, topics);
+    xSemaphoreGive(s_hub_lock);
+    ws_wake_push_task();
+    return ESP_OK;
+}
+
+// Backpressure probe, waiting up to wait_ms: a socket whose send buffer is full
+// would block the push task (and every other subscriber behind it).
+static bool ws_socket_writable(int fd, uint32_t wait_ms) {
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    struct timeval tv = { .tv_sec = wait_ms / 1000, .tv_usec = (wait_ms % 1000) * 1000 };
+    return select(fd + 1, NULL, &wfds, NULL, &tv) > 0;
+}
+
+// Documents larger than ws_json_buf go out as one fragmented message: a TEXT
+// frame, CONTINUE frames, and FIN on the last one.
+typedef struct {
+    int fd;
+    bool started;
+    bool backed_up;
+} ws_stream_t;
+
+// Every fragment is checked: a message that has started gets a short wait,
+// since giving up then leaves the client with half a message.
+static bool ws_fragment_sink(void *ctx, const char *data, size_t len, bool final) {
+    ws_stream_t *ws = (ws_stream_t *)ctx;
+    if (!ws_socket_writable(ws->fd, ws->started ? PORTAL_WS_SEND_WAIT_MS : 0)) {
+        ws->backed_up = true;
+        return false;
+    }
+    httpd_ws_frame_t pkt = {
+        .type = ws->started ? HTTPD_WS_TYPE_CONTINUE : HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)data,
+        .len = len,
+        .final = final,
+        .fragmented = ws->started || !final,
+    };
+    ws->started = true;
+    return httpd_ws_send_frame_async(server, ws->fd, &pkt) == ESP_OK;
+}
+
+static uint64_t ws_mac_key(const uint8_t mac[6]) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+    return key;
+}
+
+static uint32_t ws_hash_field(const portal_state_field_t *field, const portal_state_frame_t *f) {
+    uint32_t hash = WS_HUB_HASH_SEED;
+    char scratch[64];
+    json_writer_t w;
+    json_writer_init_stream(&w, scratch, sizeof(scratch), ws_hub_hash_sink, &hash);
+    json_writer_begin_object(&w);
+    field->write(&w, f);
+    json_writer_end_object(&w);
+    json_writer_finish(&w);
+    return hash;
+}
+
+static uint32_t ws_hash_node(const portal_node_t *n, int64_t now_us) {
+    uint32_t hash = WS_HUB_HASH_SEED;
+    char scratch[64];
+    json_writer_t w;
+    json_writer_init_stream(&w, scratch, sizeof(scratch), ws_hub_hash_sink, &hash);
+    portal_state_write_node(&w, n, now_us);
+    json_writer_finish(&w);
+    return hash;
+}
+
+static void ws_write_node_delta(json_writer_t *w, const portal_state_frame_t *f) {
+    portal_node_t n;
+    json_writer_key(w, "nodes");
+    json_writer_begin_object(w);
+    json_writer_key(w, "upsert");
+    json_writer_begin_array(w);
+    for (size_t i = 0; portal_state_get_node(i, &n); i++) {
+        if (ws_hub_item_changed(&s_hub, ws_mac_key(n.mac))) {
+            portal_state_write_node(w, &n, f->now_us);
+        }
+    }
+    json_writer_end_array(w);
+    json_writer_key(w, "remove");
+    json_writer_begin_array(w);
+    for (int i = 0; i < s_hub.removed_count; i++) {
+        uint8_t mac[6];
+        for (int b = 0; b < 6; b++) mac[b] = (uint8_t)(s_hub.removed[i] >> (8 * (5 - b)));
+        json_writer_mac(w, mac);
+    }
+    json_writer_end_array(w);
+    json_writer_end_object(w);
+}
+
+static ws_hub_result_t ws_send(const ws_hub_job_t *job, const portal_state_frame_t *f, uint32_t log_last) {
+    size_t count;
+    const portal_state_field_t *fields = portal_state_fields(&count);
+    ws_hub_send_t kind = job->kind;
+    uint8_t topics = job->topics;
+    ws_stream_t ws = { .fd = job->fd, .started = false, .backed_up = false };
+    json_writer_t w;
+    json_writer_init_stream(&w, ws_json_buf, sizeof(ws_json_buf), ws_fragment_sink, &ws);
+
+    json_writer_begin_object(&w);
+    json_writer_field_string(&w, "type", kind == WS_HUB_SEND_FULL ? "full" : "delta");
+    json_writer_field_uint(&w, "seq", s_hub.seq);
+    json_writer_field_uint(&w, "ts", (uint64_t)(f->now_us / 1000));
+    if (kind == WS_HUB_SEND_FULL) {
+        json_writer_key(&w, "topics");
+        json_writer_begin_array(&w);
+        for (int t = 0; t < PORTAL_TOPIC_COUNT; t++) {
+            if (topics & WS_TOPIC_BIT(t)) json_writer_string(&w, portal_topic_names[t]);
+        }
+        json_writer_end_array(&w);
+        json_writer_key(&w, "state");
+        json_writer_begin_object(&w);
+        for (size_t i = 0; i < count; i++) {
+            if (topics & WS_TOPIC_BIT(fields[i].topic)) fields[i].write(&w, f);
+        }
+        json_writer_end_object(&w);
+    } else {
+        json_writer_key(&w, "set");
+        json_writer_begin_object(&w);
+        for (size_t i = 0; i < count; i++) {
+            if ((topics & WS_TOPIC_BIT(fields[i].topic)) && ws_hub_field_changed(&s_hub, i)) {
+                fields[i].write(&w, f);
+            }
+        }
+        json_writer_end_object(&w);
+        if ((topics & s_hub.changed_topics) & WS_TOPIC_BIT(PORTAL_TOPIC_NODES)) {
+            ws_write_node_delta(&w, f);
+        }
+        if ((topics & s_hub.changed_topics) & WS_TOPIC_BIT(PORTAL_TOPIC_LOGS)) {
+            json_writer_key(&w, "monitor");
+            dashboard_write_monitor_range_json(&w, s_log_seq, log_last);
+        }
+    }
+    json_writer_end_object(&w);
+    if (json_writer_finish(&w) >= 0) return WS_HUB_SENT_OK;
+    return (ws.backed_up && !ws.started) ? WS_HUB_SENT_BACKED_UP : WS_HUB_SENT_FAILED;
+}
+
+// One diff-and-send pass. Nodes are diffed per node and monitor lines by
+// seq; every other member is diffed whole by the hash of its encoding.
+static void ws_push_pass(void) {
+    size_t count;
+    const portal_state_field_t *fields = portal_state_fields(&count);
+    portal_state_frame_t f;
+    portal_state_frame_begin(&f);
+
+    ws_hub_begin_pass(&s_hub);
+    for (size_t i = 0; i < count; i++) {
+        if (fields[i].per_frame || fields[i].topic == PORTAL_TOPIC_NODES || fields[i].topic == PORTAL_TOPIC_LOGS) {
+            continue;
+        }
+        ws_hub_update_field(&s_hub, i, fields[i].topic, ws_hash_field(&fields[i], &f));
+    }
+    portal_node_t n;
+    for (size_t i = 0; portal_state_get_node(i, &n); i++) {
+        ws_hub_update_item(&s_hub, ws_mac_key(n.mac), PORTAL_TOPIC_NODES, ws_hash_node(&n, f.now_us));
+    }
+    ws_hub_end_pass(&s_hub, PORTAL_TOPIC_NODES);
+    uint32_t log_last = dashboard_monitor_last_seq();
+    if (log_last != s_log_seq) ws_hub_mark_topic(&s_hub, PORTAL_TOPIC_LOGS);
+
+    ws_hub_job_t jobs[WS_HUB_MAX_CLIENTS];
+    int job_count = 0;
+    xSemaphoreTake(s_hub_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+        int fd = s_hub.clients[i].fd;
+        if (fd < 0) continue;
+        if (ws_hub_plan(&s_hub, i, ws_socket_writable(fd, 0), &jobs[job_count]) != WS_HUB_SEND_NONE) job_count++;
+    }
+    xSemaphoreGive(s_hub_lock);
+
+    for (int j = 0; j < job_count; j++) {
+        ws_hub_result_t result = ws_send(&jobs[j], &f, log_last);
+        if (result == WS_HUB_SENT_FAILED) {
+            ESP_LOGW(TAG, "WS: send to fd %d failed, closing session", jobs[j].fd);
+            httpd_sess_trigger_close(server, jobs[j].fd);
+        }
+        xSemaphoreTake(s_hub_lock, portMAX_DELAY);
+        ws_hub_sent(&s_hub, &jobs[j], result);
+        xSemaphoreGive(s_hub_lock);
+    }
+    s_log_seq = log_last;
+    portal_state_frame_end(&f);
 }
 
 static void ws_push_task(void *arg) {
+    uint32_t last_generation = 0;
+    while (1) {
+        // Woken early by a new client or subscription; otherwise paced by telemetry.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TELEMETRY_PUBLISH_INTERVAL_MS));
+        xSemaphoreTake(s_hub_lock, portMAX_DELAY);
+        for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+            int fd = s_hub.clients[i].fd;
+            if (fd >= 0 && httpd_ws_get_fd_info(server, fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+                ws_hub_remove_client(&s_hub, fd);
+            }
+        }
+        uint32_t generation = telemetry_generation();
+        bool due = ws_hub_client_count(&s_hub) > 0 &&
+                   (generation != last_generation || ws_hub_needs_full(&s_hub) ||
+                    dashboard_monitor_last_seq() != s_log_seq);
+        xSemaphoreGive(s_hub_lock);
+        if (due) {
+            last_generation = generation;
+            ws_push_pass();
+        }
+    }
+}
+
+// /ws/meters is a separate binary stream (see meter_frame.h) at the FFT update
+// rate. Frames are not queued: a subscriber whose socket is still busy skips
+// the frame and gets the next one, so a slow client only lowers its own rate.
+static int s_meter_fds[PORTAL_WS_MAX_CLIENTS];
+static SemaphoreHandle_t s_meter_lock = NULL;
+
+static void ws_meter_remove(int fd) {
+    xSemaphoreTake(s_meter_lock, portMAX_DELAY);
+    for (int i = 0; i < PORTAL_WS_MAX_CLIENTS; i++) {
+        if (s_meter_fds[i] == fd) s_meter_fds[i] = -1;
+    }
+    xSemaphoreGive(s_meter_lock);
+}
+
+static esp_err_t handle_ws_meters(httpd_req_t *req) {
+    int fd = httpd_req_to_sockfd(req);
+    if (req->method == HTTP_GET) {
+        bool added = false;
+        xSemaphoreTake(s_meter_lock, portMAX_DELAY);
+        for (int i = 0; i < PORTAL_WS_MAX_CLIENTS && !added; i++) {
+            if (s_meter_fds[i] < 0) {
+                s_meter_fds[i] = fd;
+                added = true;
+            }
+        }
+        xSemaphoreGive(s_meter_lock);
+        if (!added) {
+            ESP_LOGW(TAG, "WS meters: %d clients already connected, refusing fd %d", PORTAL_WS_MAX_CLIENTS, fd);
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    }
+
+    // Nothing is expected from the client; drain small frames, refuse large ones.
+    httpd_ws_frame_t pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    esp_err_t ret = httpd_ws_recv_frame(req, &pkt, 0);
+    if (ret != ESP_OK) return ret;
+    if (pkt.len > PORTAL_WS_MAX_RX_BYTES) return ESP_FAIL;
+    if (pkt.len == 0) return ESP_OK;
+    uint8_t body[PORTAL_WS_MAX_RX_BYTES];
+    pkt.payload = body;
+    return httpd_ws_recv_frame(req, &pkt, sizeof(body));
+}
+
+static size_t ws_meter_build(uint8_t *out, size_t out_size, uint16_t seq) {
+    meter_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.seq = seq;
+    frame.ts_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    float bins[FFT_PORTAL_BIN_COUNT];
+    bool bins_valid = false;
+    if (adf_pipeline_get_latest_fft_bins(bins, FFT_PORTAL_BIN_COUNT, &bins_valid) == ESP_OK && bins_valid) {
+        frame.flags |= METER_FRAME_F_BINS_VALID;
+        frame.bin_count = FFT_PORTAL_BIN_COUNT;
+        for (int i = 0; i < FFT_PORTAL_BIN_COUNT; i++) {
+            frame.bins[i] = meter_frame_quantize_bin(bins[i]);
+        }
+    }
+
+    adf_pipeline_levels_t levels;
+    if (adf_pipeline_take_latest_levels(&levels) == ESP_OK) {
+        if (levels.signal_present) frame.flags |= METER_FRAME_F_SIGNAL;
+        frame.buffer_fill_pct = levels.buffer_fill_percent;
+        frame.stream_count = 1;
+        frame.streams[0].id = METER_FRAME_STREAM_LOCAL;
+        frame.streams[0].peak_q15 = levels.peak_q15;
+        frame.streams[0].rms_q15 = levels.rms_q15;
+    }
+    return meter_frame_encode(&frame, out, out_size);
+}
+
+static void ws_meter_task(void *arg) {
+    static uint8_t buf[METER_FRAME_MAX_BYTES];
+    uint16_t seq = 0;
+    TickType_t last_wake = xTaskGetTickCount();
     while (1) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        if (ws_fd < 0) continue;
-        int len = portal_state_serialize_json(ws_json_buf, sizeof(ws_json_buf));
-        httpd_ws_frame_t pkt = { .type = HTTPD_WS_TYPE_TEXT, .payload = (uint8_t*)ws_json_buf, .len = len, .final = true };
-        if (httpd_ws_send_frame_async(server, ws_fd, &pkt) != ESP_OK) ws_fd = -1;
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(PORTAL_METER_INTERVAL_MS));
+
+        int fds[PORTAL_WS_MAX_CLIENTS];
+        int count = 0;
+        xSemaphoreTake(s_meter_lock, portMAX_DELAY);
+        for (int i = 0; i < PORTAL_WS_MAX_CLIENTS; i++) {
+            if (s_meter_fds[i] >= 0) fds[count++] = s_meter_fds[i];
+        }
+        xSemaphoreGive(s_meter_lock);
+        if (count == 0) continue;
+
+        size_t len = ws_meter_build(buf, sizeof(buf), seq++);
+        if (len == 0) continue;
+        httpd_ws_frame_t pkt = {
+            .type = HTTPD_WS_TYPE_BINARY,
+            .payload = buf,
+            .len = len,
+            .final = true,
+        };
+        for (int i = 0; i < count; i++) {
+            if (httpd_ws_get_fd_info(server, fds[i]) != HTTPD_WS_CLIENT_WEBSOCKET) {
+                ws_meter_remove(fds[i]);
+                continue;
+            }
+            if (!ws_socket_writable(fds[i], 0)) continue;
+            if (httpd_ws_send_frame_async(server, fds[i], &pkt) != ESP_OK) {
+                ESP_LOGW(TAG, "WS meters: send to fd %d failed, dropping client", fds[i]);
+                ws_meter_remove(fds[i]);
+            }
+        }
     }
 }
 #endif
 
 esp_err_t portal_http_start(void) {
-    init_spiffs();
+    esp_err_t err = portal_state_init();
+    if (err != ESP_OK) return err;
+    mount_assets();
+#if CONFIG_HTTPD_WS_SUPPORT
+    if (!s_hub_lock) s_hub_lock = xSemaphoreCreateMutex();
+    if (!s_hub_lock) return ESP_ERR_NO_MEM;
+    ws_hub_init(&s_hub);
+    s_log_seq = dashboard_monitor_last_seq();
+    if (!s_meter_lock) s_meter_lock = xSemaphoreCreateMutex();
+    if (!s_meter_lock) return ESP_ERR_NO_MEM;
+    for (int i = 0; i < PORTAL_WS_MAX_CLIENTS; i++) s_meter_fds[i] = -1;
+#endif
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.max_uri_handlers = 24;
     config.uri_match_fn = httpd_uri_match_wildcard;
@@ -238,7 +681,8 @@ esp_err_t portal_http_start(void) {
         {"/api/mesh/positions", HTTP_POST, handle_api_mesh_positions, NULL},
         {"/api/control/metrics", HTTP_GET, handle_api_control_metrics, NULL},
 #if CONFIG_HTTPD_WS_SUPPORT
-        {"/ws", HTTP_GET, handle_ws, NULL},
+        {.uri = "/ws", .method = HTTP_GET, .handler = handle_ws, .user_ctx = NULL, .is_websocket = true},
+        {.uri = "/ws/meters", .method = HTTP_GET, .handler = handle_ws_meters, .user_ctx = NULL, .is_websocket = true},
 #endif
         {"*", HTTP_GET, handle_captive_redirect, NULL}
     };
@@ -248,7 +692,8 @@ esp_err_t portal_http_start(void) {
     }
     
 #if CONFIG_HTTPD_WS_SUPPORT
-    xTaskCreate(ws_push_task, "ws_push", 4096, NULL, 3, &ws_push_task_handle);
+    xTaskCreate(ws_push_task, "ws_push", PORTAL_WS_PUSH_STACK_BYTES, NULL, 3, &ws_push_task_handle);
+    xTaskCreate(ws_meter_task, "ws_meter", PORTAL_METER_STACK_BYTES, NULL, 3, &ws_meter_task_handle);
 #endif
 
     return ESP_OK;
@@ -264,6 +709,10 @@ esp_err_t portal_http_stop(void) {
         vTaskDelete(ws_push_task_handle);
         ws_push_task_handle = NULL;
     }
+    if (ws_meter_task_handle) {
+        vTaskDelete(ws_meter_task_handle);
+        ws_meter_task_handle = NULL;
+    }
 #endif
     return ESP_OK;
 }
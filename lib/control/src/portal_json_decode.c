@@ -0,0 +1,135 @@
+#include "control/portal_json_decode.h"
+
+#include "control/json_extract.h"
+#include "config/build.h"
+
+#include <string.h>
+
+static bool decode_mixer_stream(const json_doc_t *doc, int obj, mixer_ctrl_stream_t *out)
+{
+    uint16_t id = 0;
+    uint16_t gain_pct = 0;
+    bool enabled = false;
+    bool muted = false;
+    bool solo = false;
+
+    if (doc->toks[obj].type != JSON_TOK_OBJECT || !json_get_uint16(doc, obj, "id", &id)) {
+        return false;
+    }
+    if (!json_get_uint16(doc, obj, "gainPct", &gain_pct) && !json_get_uint16(doc, obj, "gain", &gain_pct)) {
+        return false;
+    }
+    if (!json_get_bool(doc, obj, "enabled", &enabled) && !json_get_bool(doc, obj, "enable", &enabled)) {
+        return false;
+    }
+    if (!json_get_bool(doc, obj, "muted", &muted) && !json_get_bool(doc, obj, "mute", &muted)) {
+        return false;
+    }
+    if (!json_get_bool(doc, obj, "solo", &solo)) {
+        return false;
+    }
+    bool active = enabled && !muted;
+    if (json_object_get(doc, obj, "active") >= 0 && !json_get_bool(doc, obj, "active", &active)) {
+        return false;
+    }
+    if (id < MIXER_STREAM_ID_MIN || id > MIXER_STREAM_ID_MAX || gain_pct > MIXER_STREAM_GAIN_MAX_PCT) {
+        return false;
+    }
+
+    out->stream_id = (uint8_t)id;
+    out->gain_pct = gain_pct;
+    out->enabled = enabled;
+    out->muted = muted;
+    out->solo = solo;
+    out->active = active;
+    return true;
+}
+
+esp_err_t mixer_ctrl_decode_json(const char *json, mixer_ctrl_message_t *msg)
+{
+    if (!json || !msg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    json_doc_t doc;
+    json_tok_t toks[PORTAL_JSON_MAX_TOKENS];
+    if (json_parse(&doc, json, strlen(json), toks, PORTAL_JSON_MAX_TOKENS) < 0 ||
+        toks[0].type != JSON_TOK_OBJECT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t out_gain_pct = msg->out_gain_pct;
+    bool has_out_gain = json_object_get(&doc, 0, "outGainPct") >= 0;
+    if (has_out_gain &&
+        (!json_get_uint16(&doc, 0, "outGainPct", &out_gain_pct) || out_gain_pct > MIXER_OUT_GAIN_MAX_PCT)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t schema_version = MIXER_SCHEMA_VERSION;
+    if (json_object_get(&doc, 0, "schemaVersion") >= 0 &&
+        (!json_get_uint16(&doc, 0, "schemaVersion", &schema_version) || schema_version != MIXER_SCHEMA_VERSION)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mixer_ctrl_stream_t streams[MIXER_MAX_STREAMS];
+    uint8_t stream_count = 0;
+    int array = json_object_get(&doc, 0, "streams");
+    if (array >= 0) {
+        if (toks[array].type != JSON_TOK_ARRAY || toks[array].size == 0 || toks[array].size > MIXER_MAX_STREAMS) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        bool seen_ids[MIXER_MAX_STREAMS] = {false};
+        for (int obj = json_first_child(&doc, array); obj >= 0; obj = json_next_sibling(&doc, array, obj)) {
+            mixer_ctrl_stream_t *stream = &streams[stream_count];
+            if (!decode_mixer_stream(&doc, obj, stream) || seen_ids[stream->stream_id - 1]) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            seen_ids[stream->stream_id - 1] = true;
+            stream_count++;
+        }
+    }
+
+    if (!has_out_gain && stream_count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    msg->subtype = MIXER_CTRL_SET;
+    msg->version = MIXER_CTRL_VERSION;
+    msg->out_gain_pct = out_gain_pct;
+    msg->stream_count = stream_count;
+    memset(msg->streams, 0, sizeof(msg->streams));
+    memcpy(msg->streams, streams, stream_count * sizeof(streams[0]));
+    return ESP_OK;
+}
+
+esp_err_t uplink_ctrl_decode_json(const char *json, uplink_ctrl_message_t *msg)
+{
+    if (!json || !msg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    json_doc_t doc;
+    json_tok_t toks[PORTAL_JSON_MAX_TOKENS];
+    if (json_parse(&doc, json, strlen(json), toks, PORTAL_JSON_MAX_TOKENS) < 0 ||
+        toks[0].type != JSON_TOK_OBJECT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uplink_ctrl_message_t decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    if (!json_get_bool(&doc, 0, "enabled", &decoded.enabled)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (decoded.enabled) {
+        if (!json_get_string(&doc, 0, "ssid", decoded.ssid, sizeof(decoded.ssid)) || decoded.ssid[0] == '\0') {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (json_object_get(&doc, 0, "password") >= 0 &&
+            !json_get_string(&doc, 0, "password", decoded.password, sizeof(decoded.password))) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    decoded.subtype = decoded.enabled ? UPLINK_CTRL_SET : UPLINK_CTRL_CLEAR;
+    *msg = decoded;
+    return ESP_OK;
+}
@@ -0,0 +1,68 @@
+#include "control/portal_json_encode.h"
+
+void uplink_status_write_json(json_writer_t *w, const network_uplink_status_t *st)
+{
+    json_writer_begin_object(w);
+    json_writer_field_bool(w, "enabled", st->enabled);
+    json_writer_field_bool(w, "configured", st->configured);
+    json_writer_field_bool(w, "rootApplied", st->root_applied);
+    json_writer_field_bool(w, "pendingApply", st->pending_apply);
+    // The SSID is a credential hint: only whether one is set leaves the node.
+    json_writer_field_string(w, "ssid", st->configured ? "<configured>" : "");
+    json_writer_field_string(w, "lastError", st->last_error);
+    json_writer_field_uint(w, "updatedMs", st->updated_ms);
+    json_writer_end_object(w);
+}
+
+void mixer_status_write_json(json_writer_t *w, const network_mixer_status_t *st)
+{
+    uint8_t count = st->stream_count <= MIXER_MAX_STREAMS ? st->stream_count : MIXER_MAX_STREAMS;
+
+    json_writer_begin_object(w);
+    json_writer_field_uint(w, "schemaVersion", st->schema_version);
+    json_writer_field_uint(w, "outGainPct", st->out_gain_pct);
+    json_writer_field_uint(w, "streamCount", count);
+    json_writer_key(w, "streams");
+    json_writer_begin_array(w);
+    for (uint8_t i = 0; i < count; i++) {
+        const network_mixer_stream_status_t *s = &st->streams[i];
+        json_writer_begin_object(w);
+        json_writer_field_uint(w, "id", s->stream_id);
+        json_writer_field_uint(w, "gainPct", s->gain_pct);
+        json_writer_field_bool(w, "enabled", s->enabled);
+        json_writer_field_bool(w, "muted", s->muted);
+        json_writer_field_bool(w, "solo", s->solo);
+        json_writer_field_bool(w, "active", s->active);
+        json_writer_end_object(w);
+    }
+    json_writer_end_array(w);
+    json_writer_field_bool(w, "applied", st->applied);
+    json_writer_field_bool(w, "pendingApply", st->pending_apply);
+    json_writer_field_string(w, "lastError", st->last_error);
+    json_writer_field_uint(w, "updatedMs", st->updated_ms);
+    json_writer_end_object(w);
+}
+
+int uplink_ctrl_serialize_json(char *buf, size_t buf_len)
+{
+    network_uplink_status_t st;
+    if (!buf || buf_len == 0 || network_get_uplink_status(&st) != ESP_OK) {
+        return 0;
+    }
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, buf_len);
+    uplink_status_write_json(&w, &st);
+    return json_writer_finish(&w);
+}
+
+int mixer_ctrl_serialize_json(char *buf, size_t buf_len)
+{
+    network_mixer_status_t st;
+    if (!buf || buf_len == 0 || network_get_mixer_state(&st) != ESP_OK) {
+        return 0;
+    }
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, buf_len);
+    mixer_status_write_json(&w, &st);
+    return json_writer_finish(&w);
+}
@@ -106,18 +106,25 @@ bool portal_ota_in_progress(void) {
     return s_ota.in_progress;
 }
 
+void portal_ota_write_json(json_writer_t *w) {
+    json_writer_begin_object(w);
+    json_writer_field_bool(w, "enabled", true);
+    json_writer_field_bool(w, "inProgress", s_ota.in_progress);
+    json_writer_field_string(w, "phase", s_ota.phase);
+    json_writer_field_bool(w, "lastOk", s_ota.last_ok);
+    json_writer_field_int(w, "lastErr", s_ota.last_err);
+    json_writer_field_string(w, "lastUrl", ota_redacted_url());
+    json_writer_end_object(w);
+}
+
 int portal_ota_serialize_json(char *buf, size_t buf_size) {
     if (!buf || buf_size < 64) {
         return 0;
     }
-    return snprintf(buf, buf_size,
-                    "{\"enabled\":true,\"inProgress\":%s,\"phase\":\"%s\",\"lastOk\":%s,"
-                    "\"lastErr\":%d,\"lastUrl\":\"%s\"}",
-                    s_ota.in_progress ? "true" : "false",
-                    s_ota.phase,
-                    s_ota.last_ok ? "true" : "false",
-                    s_ota.last_err,
-                    ota_redacted_url());
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, buf_size);
+    portal_ota_write_json(&w);
+    return json_writer_finish(&w);
 }
 
 void portal_ota_confirm_running_image(void) {
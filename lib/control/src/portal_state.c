@@ -4,10 +4,14 @@
 #include "control/serial_dashboard.h"
 #include "audio/adf_pipeline.h"
 #include "network/mesh_net.h"
+#include "network/transport.h"
 #include "network/uplink_control.h"
 #include "network/mixer_control.h"
-#include "audio/usb_audio.h"
 #include "control/memory_monitor.h"
+#include "control/portal_json_encode.h"
+#include "control/portal_ota.h"
+#include "control/usb_portal.h"
+#include "control/telemetry.h"
 #include "config/build.h"
 #include "config/build_role.h"
 
@@ -15,96 +19,424 @@
 #include <esp_timer.h>
 #include <esp_system.h>
 #include <esp_mac.h>
-#include <esp_mesh.h>
+#include <esp_netif.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <string.h>
-#include <stdio.h>
 #include <stdlib.h>
 
 static const char *TAG = "portal_state";
-static portal_state_t state;
+
+// The table is written from the mesh RX task (heartbeats, positions) and read
+// by the HTTP and WebSocket tasks; every access holds s_lock. Until init runs
+// there is no lock and every entry point is a no-op.
+static node_table_t s_nodes;
+static SemaphoreHandle_t s_lock = NULL;
+static uint8_t s_self_mac[6];
+
+// Routing table snapshot for portal_state_sync_with_routing_table; held
+// under s_lock like the table.
+static network_node_addr_t s_route_addrs[NODE_TABLE_CAPACITY];
+static uint8_t s_route_macs[NODE_TABLE_CAPACITY][6];
 
 extern adf_pipeline_handle_t adf_pipeline_get_latest_pipeline(void);
 
+static int64_t now_ms(void) {
+    return esp_timer_get_time() / 1000;
+}
+
+static bool lock(void) {
+    return s_lock && xSemaphoreTake(s_lock, portMAX_DELAY) == pdTRUE;
+}
+
+static void unlock(void) {
+    xSemaphoreGive(s_lock);
+}
+
 esp_err_t portal_state_init(void) {
-    memset(&state, 0, sizeof(state));
-    esp_read_mac(state.self_mac, ESP_MAC_WIFI_STA);
-    ESP_LOGI(TAG, "Portal state initialized for self: " MACSTR, MAC2STR(state.self_mac));
+    if (s_lock) {
+        return ESP_OK;
+    }
+    node_table_init(&s_nodes, PORTAL_EXPIRE_TIMEOUT_MS);
+    esp_read_mac(s_self_mac, ESP_MAC_WIFI_STA);
+    node_table_pin(&s_nodes, node_table_touch(&s_nodes, s_self_mac, now_ms()));
+    s_lock = xSemaphoreCreateMutex();
+    if (!s_lock) {
+        return ESP_ERR_NO_MEM;
+    }
+    network_register_heartbeat_callback(portal_state_update_from_heartbeat);
+    ESP_LOGI(TAG, "Portal state initialized for self: " MACSTR, MAC2STR(s_self_mac));
     return ESP_OK;
 }
 
-static portal_node_t *find_node(const uint8_t *mac) {
-    for (int i = 0; i < state.node_count; i++) {
-        if (memcmp(state.nodes[i].mac, mac, 6) == 0) return &state.nodes[i];
+void portal_state_update_from_heartbeat(const uint8_t *sender_mac, const mesh_heartbeat_t *hb) {
+    if (!sender_mac || !hb || !lock()) {
+        return;
     }
-    return NULL;
+    int i = node_table_touch(&s_nodes, sender_mac, now_ms());
+    if (i >= 0) {
+        memcpy(s_nodes.parent_mac[i], hb->parent_mac, 6);
+        s_nodes.role[i] = hb->role;
+        s_nodes.is_root[i] = hb->is_root;
+        s_nodes.layer[i] = hb->layer;
+        s_nodes.rssi[i] = hb->rssi;
+        s_nodes.children[i] = hb->children_count;
+        s_nodes.stream_active[i] = hb->stream_active;
+        s_nodes.uptime_ms[i] = hb->uptime_ms;
+        s_nodes.flags[i] |= NODE_TABLE_F_HEARTBEAT;
+    }
+    unlock();
 }
 
-static portal_node_t *add_node(const uint8_t *mac) {
-    if (state.node_count >= PORTAL_MAX_NODES) return NULL;
-    portal_node_t *n = &state.nodes[state.node_count++];
-    memcpy(n->mac, mac, 6);
-    return n;
+void portal_state_update_position(const uint8_t *mac, float x, float y, float z) {
+    if (!mac || !lock()) {
+        return;
+    }
+    int i = node_table_touch(&s_nodes, mac, now_ms());
+    if (i >= 0) {
+        s_nodes.x[i] = x;
+        s_nodes.y[i] = y;
+        s_nodes.z[i] = z;
+    }
+    unlock();
+
+    if (memcmp(mac, s_self_mac, 6) == 0) {
+        adf_pipeline_set_position(adf_pipeline_get_latest_pipeline(), x, y, z);
+    }
 }
 
-void portal_state_update_position(const uint8_t *mac, float x, float y, float z) {
-    portal_node_t *node = find_node(mac);
-    if (!node) node = add_node(mac);
-    if (!node) return;
+static void update_self(const telemetry_snapshot_t *t) {
+    if (!lock()) {
+        return;
+    }
+    int i = node_table_touch(&s_nodes, s_self_mac, now_ms());
+    if (i >= 0) {
+        node_table_pin(&s_nodes, i);
+        s_nodes.role[i] = BUILD_IS_SOURCE ? 1 : 0;
+        s_nodes.is_root[i] = t->mesh_root ? 1 : 0;
+        s_nodes.layer[i] = t->mesh_layer;
+        s_nodes.rssi[i] = t->rssi;
+        s_nodes.children[i] = t->connected_nodes;
+        s_nodes.uptime_ms[i] = (uint32_t)(t->sampled_us / 1000);
+    }
+    unlock();
+}
 
-    node->x = x; node->y = y; node->z = z;
-    node->last_seen_us = esp_timer_get_time();
-    node->stale = false;
+void portal_state_frame_begin(portal_state_frame_t *f) {
+    f->telemetry = telemetry_acquire();
+    if (!f->telemetry) {
+        telemetry_sample(&f->scratch, adf_pipeline_get_latest_pipeline());
+        f->telemetry = &f->scratch;
+    }
+    update_self(f->telemetry);
+    portal_state_sync_with_routing_table();
+    portal_state_expire_stale();
+    f->now_us = esp_timer_get_time();
+}
 
-    if (memcmp(mac, state.self_mac, 6) == 0) {
-        adf_pipeline_set_position(adf_pipeline_get_latest_pipeline(), x, y, z);
+void portal_state_frame_end(portal_state_frame_t *f) {
+    if (f->telemetry && f->telemetry != &f->scratch) {
+        telemetry_release(f->telemetry);
     }
+    f->telemetry = NULL;
 }
 
 void portal_state_update_self(void) {
-    portal_node_t *node = find_node(state.self_mac);
-    if (!node) node = add_node(state.self_mac);
-    if (!node) return;
-
-    node->is_root = esp_mesh_is_root() ? 1 : 0;
-    node->layer = esp_mesh_get_layer();
-    node->rssi = network_get_rssi();
-    node->children_count = network_get_connected_nodes();
-    node->uptime_ms = (uint32_t)(esp_timer_get_time() / 1000);
-    node->last_seen_us = esp_timer_get_time();
-    node->stale = false;
+    portal_state_frame_t f;
+    portal_state_frame_begin(&f);
+    portal_state_frame_end(&f);
 }
 
 void portal_state_expire_stale(void) {
-    int64_t now_us = esp_timer_get_time();
-    for (int i = 0; i < state.node_count; i++) {
-        if (memcmp(state.nodes[i].mac, state.self_mac, 6) == 0) continue;
-        if ((now_us - state.nodes[i].last_seen_us) / 1000 > PORTAL_EXPIRE_TIMEOUT_MS) {
-            if (i < state.node_count - 1) {
-                memmove(&state.nodes[i], &state.nodes[i+1], (state.node_count - i - 1) * sizeof(portal_node_t));
-            }
-            state.node_count--;
-            i--;
+    if (!lock()) {
+        return;
+    }
+    node_table_expire(&s_nodes, now_ms());
+    unlock();
+}
+
+void portal_state_sync_with_routing_table(void) {
+    if (!lock()) {
+        return;
+    }
+    // Only the root holds the whole mesh; elsewhere the table is this node's
+    // subtree, so nodes missing from it are left to expire instead.
+    bool is_root = false;
+    int n = network_transport_topology(s_route_addrs, NODE_TABLE_CAPACITY, &is_root);
+    if (is_root) {
+        for (int i = 0; i < n; i++) {
+            memcpy(s_route_macs[i], s_route_addrs[i].addr, 6);
         }
+        node_table_sync_routes(&s_nodes, (const uint8_t (*)[6])s_route_macs, (size_t)n, now_ms());
+    }
+    unlock();
+}
+
+size_t portal_state_node_count(void) {
+    if (!lock()) {
+        return 0;
+    }
+    size_t count = s_nodes.count;
+    unlock();
+    return count;
+}
+
+bool portal_state_get_node(size_t i, portal_node_t *out) {
+    if (!lock()) {
+        return false;
+    }
+    bool found = i < s_nodes.count;
+    if (found) {
+        memcpy(out->mac, s_nodes.mac[i], 6);
+        memcpy(out->parent_mac, s_nodes.parent_mac[i], 6);
+        out->role = s_nodes.role[i];
+        out->has_heartbeat = (s_nodes.flags[i] & NODE_TABLE_F_HEARTBEAT) != 0;
+        out->is_root = s_nodes.is_root[i];
+        out->layer = s_nodes.layer[i];
+        out->rssi = s_nodes.rssi[i];
+        out->children_count = s_nodes.children[i];
+        out->stream_active = s_nodes.stream_active[i];
+        out->uptime_ms = s_nodes.uptime_ms[i];
+        out->x = s_nodes.x[i];
+        out->y = s_nodes.y[i];
+        out->z = s_nodes.z[i];
+        out->last_seen_us = s_nodes.last_seen_ms[i] * 1000;
+    }
+    unlock();
+    return found;
+}
+
+static const char *input_mode_label(adf_input_mode_t mode) {
+    return (mode == ADF_INPUT_MODE_USB) ? "USB" : (mode == ADF_INPUT_MODE_TONE) ? "TONE" : "AUX";
+}
+
+static bool mac_is_zero(const uint8_t *mac) {
+    static const uint8_t zero[6] = {0};
+    return memcmp(mac, zero, sizeof(zero)) == 0;
+}
+
+void portal_state_write_node(json_writer_t *w, const portal_node_t *n, int64_t now_us) {
+    json_writer_begin_object(w);
+    json_writer_field_mac(w, "mac", n->mac);
+    json_writer_field_string(w, "role", n->role ? "SRC" : "OUT");
+    json_writer_field_bool(w, "root", n->is_root);
+    json_writer_field_uint(w, "layer", n->layer);
+    json_writer_field_int(w, "rssi", n->rssi);
+    json_writer_field_uint(w, "children", n->children_count);
+    json_writer_field_bool(w, "streaming", n->stream_active);
+    json_writer_key(w, "parent");
+    if (!n->is_root && !mac_is_zero(n->parent_mac)) {
+        json_writer_mac(w, n->parent_mac);
+    } else {
+        json_writer_null(w);
+    }
+    json_writer_field_uint(w, "uptime", n->uptime_ms);
+    json_writer_field_bool(w, "stale", (now_us - n->last_seen_us) / 1000 > PORTAL_STALE_TIMEOUT_MS);
+    json_writer_end_object(w);
+}
+
+// ---- Status document members, one writer each ----
+
+static void write_schema_version(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    json_writer_field_uint(w, "schemaVersion", PORTAL_STATUS_SCHEMA_VERSION);
+}
+
+static void write_ts(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_field_uint(w, "ts", (uint64_t)(f->now_us / 1000));
+}
+
+static void write_self(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    json_writer_field_mac(w, "self", s_self_mac);
+}
+
+static void write_heap_kb(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_field_uint(w, "heapKb", f->telemetry->heap_free / 1024);
+}
+
+static void write_core0_load(json_writer_t *w, const portal_state_frame_t *f) {
+    const cpu_load_window_t *cpu = &f->telemetry->cpu.window[0];
+    json_writer_key(w, "core0LoadPct");
+    if (cpu->window_ms > 0) {
+        json_writer_uint(w, cpu->core_pct[0]);
+    } else {
+        json_writer_null(w);
+    }
+}
+
+static void write_latency(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_field_uint(w, "latencyMs", f->telemetry->latency_ms);
+}
+
+static void write_net_if(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    const esp_netif_ip_info_t *info = portal_get_ip_info();
+    if (!info) {
+        json_writer_field_string(w, "netIf", "mesh");
+        return;
+    }
+    char ip[16];
+    char label[32] = "usb_ncm (";
+    esp_ip4addr_ntoa(&info->ip, ip, sizeof(ip));
+    strlcat(label, ip, sizeof(label));
+    strlcat(label, ")", sizeof(label));
+    json_writer_field_string(w, "netIf", label);
+}
+
+static void write_build_label(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    json_writer_field_string(w, "buildLabel", BUILD_NODE_LABEL);
+}
+
+static void write_mesh_state(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_field_string(w, "meshState", f->telemetry->mesh_connected ? "Mesh OK" : "Mesh Degraded");
+}
+
+static void write_bpm(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    json_writer_key(w, "bpm");
+    json_writer_null(w);
+}
+
+static void write_fft_bins(json_writer_t *w, const portal_state_frame_t *f) {
+    const telemetry_snapshot_t *t = f->telemetry;
+    json_writer_key(w, "fftBins");
+    if (!t->fft_valid) {
+        json_writer_null(w);
+        return;
+    }
+    json_writer_begin_array(w);
+    for (int i = 0; i < FFT_PORTAL_BIN_COUNT; i++) {
+        json_writer_float(w, t->fft_bins[i], 3);
     }
+    json_writer_end_array(w);
+}
+
+static void write_mode(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_field_string(w, "mode", input_mode_label(f->telemetry->input_mode));
+}
+
+static void write_heap(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_field_uint(w, "heap", f->telemetry->heap_free);
+}
+
+static void write_meters(json_writer_t *w, const portal_state_frame_t *f) {
+    const telemetry_snapshot_t *t = f->telemetry;
+    json_writer_key(w, "meters");
+    if (!t->pipeline_valid) {
+        json_writer_null(w);
+        return;
+    }
+    json_writer_begin_object(w);
+    json_writer_field_uint(w, "inputPeak", t->pipeline.input_peak);
+    json_writer_field_bool(w, "signal", t->pipeline.input_signal_present);
+    json_writer_field_uint(w, "bufferPct", t->pipeline.buffer_fill_percent);
+    json_writer_field_uint(w, "txKbps", t->tx_kbps);
+    json_writer_field_bool(w, "rxAudio", t->receiving_audio);
+    json_writer_end_object(w);
+}
+
+static void write_nodes(json_writer_t *w, const portal_state_frame_t *f) {
+    json_writer_key(w, "nodes");
+    json_writer_begin_array(w);
+    portal_node_t n;
+    for (size_t i = 0; portal_state_get_node(i, &n); i++) {
+        portal_state_write_node(w, &n, f->now_us);
+    }
+    json_writer_end_array(w);
+}
+
+static void write_monitor(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    json_writer_key(w, "monitor");
+    dashboard_write_monitor_json(w);
+}
+
+static void write_ota(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    json_writer_key(w, "ota");
+    portal_ota_write_json(w);
+}
+
+static void write_uplink(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    network_uplink_status_t uplink;
+    if (network_get_uplink_status(&uplink) == ESP_OK) {
+        json_writer_key(w, "uplink");
+        uplink_status_write_json(w, &uplink);
+    }
+}
+
+static void write_mixer(json_writer_t *w, const portal_state_frame_t *f) {
+    (void)f;
+    network_mixer_status_t mixer;
+    if (network_get_mixer_state(&mixer) == ESP_OK) {
+        json_writer_key(w, "mixer");
+        mixer_status_write_json(w, &mixer);
+    }
+}
+
+static void write_usb(json_writer_t *w, const portal_state_frame_t *f) {
+    const telemetry_snapshot_t *t = f->telemetry;
+    json_writer_key(w, "usb");
+    json_writer_begin_object(w);
+    json_writer_field_string(w, "inputMode", input_mode_label(t->input_mode));
+    json_writer_field_bool(w, "ready", t->usb_ready);
+    json_writer_field_bool(w, "active", t->usb_active);
+    json_writer_end_object(w);
+}
+
+static const portal_state_field_t k_fields[] = {
+    { "schemaVersion", PORTAL_TOPIC_STATUS,   false, write_schema_version },
+    { "ts",            PORTAL_TOPIC_STATUS,   true,  write_ts },
+    { "self",          PORTAL_TOPIC_STATUS,   false, write_self },
+    { "heapKb",        PORTAL_TOPIC_STATUS,   false, write_heap_kb },
+    { "core0LoadPct",  PORTAL_TOPIC_STATUS,   false, write_core0_load },
+    { "latencyMs",     PORTAL_TOPIC_STATUS,   false, write_latency },
+    { "netIf",         PORTAL_TOPIC_STATUS,   false, write_net_if },
+    { "buildLabel",    PORTAL_TOPIC_STATUS,   false, write_build_label },
+    { "meshState",     PORTAL_TOPIC_STATUS,   false, write_mesh_state },
+    { "bpm",           PORTAL_TOPIC_STATUS,   false, write_bpm },
+    { "fftBins",       PORTAL_TOPIC_SPECTRUM, false, write_fft_bins },
+    { "mode",          PORTAL_TOPIC_STATUS,   false, write_mode },
+    { "heap",          PORTAL_TOPIC_STATUS,   false, write_heap },
+    { "meters",        PORTAL_TOPIC_METERS,   false, write_meters },
+    { "nodes",         PORTAL_TOPIC_NODES,    false, write_nodes },
+    { "monitor",       PORTAL_TOPIC_LOGS,     false, write_monitor },
+    { "ota",           PORTAL_TOPIC_STATUS,   false, write_ota },
+    { "uplink",        PORTAL_TOPIC_STATUS,   false, write_uplink },
+    { "mixer",         PORTAL_TOPIC_STATUS,   false, write_mixer },
+    { "usb",           PORTAL_TOPIC_STATUS,   false, write_usb },
+};
+
+const char *const portal_topic_names[PORTAL_TOPIC_COUNT] = {
+    [PORTAL_TOPIC_STATUS] = "status",
+    [PORTAL_TOPIC_NODES] = "nodes",
+    [PORTAL_TOPIC_METERS] = "meters",
+    [PORTAL_TOPIC_SPECTRUM] = "spectrum",
+    [PORTAL_TOPIC_LOGS] = "logs",
+};
+
+const portal_state_field_t *portal_state_fields(size_t *count) {
+    *count = sizeof(k_fields) / sizeof(k_fields[0]);
+    return k_fields;
+}
+
+void portal_state_write_json(json_writer_t *w) {
+    portal_state_frame_t f;
+    portal_state_frame_begin(&f);
+    json_writer_begin_object(w);
+    for (size_t i = 0; i < sizeof(k_fields) / sizeof(k_fields[0]); i++) {
+        k_fields[i].write(w, &f);
+    }
+    json_writer_end_object(w);
+    portal_state_frame_end(&f);
 }
 
 int portal_state_serialize_json(char *buf, size_t buf_size) {
-    portal_state_update_self();
-    portal_state_expire_stale();
-    
-    adf_pipeline_handle_t p = adf_pipeline_get_latest_pipeline();
-    adf_input_mode_t mode = adf_pipeline_get_input_mode(p);
-    
-    return snprintf(buf, buf_size, 
-        "{\"ts\":%llu,\"nodes\":%d,\"mode\":\"%s\",\"heap\":%lu}",
-        (unsigned long long)(esp_timer_get_time()/1000),
-        state.node_count,
-        (mode == ADF_INPUT_MODE_USB) ? "USB" : (mode == ADF_INPUT_MODE_TONE) ? "TONE" : "AUX",
-        (unsigned long)heap_caps_get_free_size(MALLOC_CAP_8BIT));
-}
-
-const portal_state_t *portal_state_get(void) { return &state; }
-void portal_state_expire_all(void) { state.node_count = 0; }
-void portal_state_update_core0_load(void) {}
-void portal_state_recompute_derived_fields(void) {}
-void portal_state_sync_with_routing_table(void) {}
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, buf_size);
+    portal_state_write_json(&w);
+    return json_writer_finish(&w);
+}
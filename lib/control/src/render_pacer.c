@@ -0,0 +1,34 @@
+#include "control/render_pacer.h"
+
+#include <string.h>
+
+void render_pacer_init(render_pacer_t *p, uint32_t dashboard_ms, uint32_t max_idle_ms)
+{
+    memset(p, 0, sizeof(*p));
+    p->dashboard_ms = dashboard_ms;
+    p->max_idle_ms = max_idle_ms;
+}
+
+uint8_t render_pacer_tick(render_pacer_t *p, int64_t now_ms, uint32_t generation, uint8_t view, bool animating)
+{
+    uint8_t due = 0;
+
+    bool changed = !p->drawn || generation != p->generation || view != p->view;
+    if (changed || animating || now_ms - p->last_draw_ms >= p->max_idle_ms) {
+        due |= RENDER_PACER_DISPLAY;
+        p->drawn = true;
+        p->generation = generation;
+        p->view = view;
+        p->last_draw_ms = now_ms;
+        p->frames_drawn++;
+    } else {
+        p->frames_skipped++;
+    }
+
+    if (!p->dashboard_drawn || now_ms - p->last_dashboard_ms >= p->dashboard_ms) {
+        due |= RENDER_PACER_DASHBOARD;
+        p->dashboard_drawn = true;
+        p->last_dashboard_ms = now_ms;
+    }
+    return due;
+}
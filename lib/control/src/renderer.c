@@ -0,0 +1,65 @@
+#include "control/renderer.h"
+#include "control/render_pacer.h"
+#include "config/build.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const char *TAG = "renderer";
+
+static const renderer_config_t *s_config = NULL;
+static render_pacer_t s_pacer;
+static TaskHandle_t s_task = NULL;
+
+static void renderer_task(void *arg)
+{
+    (void)arg;
+    uint32_t generation = 0;
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(RENDERER_FRAME_MS));
+
+        const telemetry_snapshot_t *t = telemetry_acquire();
+        if (t) {
+            if (t->generation != generation) {
+                s_config->update(t);
+                generation = t->generation;
+            }
+            telemetry_release(t);
+        }
+
+        display_view_t view = s_config->view;
+        uint8_t due = render_pacer_tick(&s_pacer, esp_timer_get_time() / 1000, generation, (uint8_t)view,
+                                        s_config->animating(view));
+        if (due & RENDER_PACER_DISPLAY) {
+            s_config->render_display(view);
+        }
+        if (due & RENDER_PACER_DASHBOARD) {
+            s_config->render_dashboard();
+        }
+    }
+}
+
+esp_err_t renderer_start(const renderer_config_t *config)
+{
+    if (s_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!config || !config->update || !config->render_display || !config->render_dashboard ||
+        !config->animating) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_config = config;
+    render_pacer_init(&s_pacer, RENDERER_DASHBOARD_MS, RENDERER_MAX_IDLE_MS);
+
+    if (xTaskCreatePinnedToCore(renderer_task, "renderer", RENDERER_TASK_STACK_BYTES, NULL,
+                                RENDERER_TASK_PRIO, &s_task, RENDERER_TASK_CORE) != pdPASS) {
+        s_task = NULL;
+        ESP_LOGE(TAG, "Failed to create renderer task");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Rendering every %d ms", RENDERER_FRAME_MS);
+    return ESP_OK;
+}
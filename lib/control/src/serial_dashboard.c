@@ -1,5 +1,6 @@
 #include "control/serial_dashboard.h"
 #include "config/build.h"
+#include "control/telemetry.h"
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
@@ -52,14 +53,50 @@ static void print_uptime(char *buf, size_t len) {
     snprintf(buf, len, "%luh%02lum%02lus", (unsigned long)h, (unsigned long)m, (unsigned long)s);
 }
 
-static void print_ram(char *buf, size_t len) {
+// Heap figures come from the published telemetry snapshot once it exists.
+static uint32_t heap_free_bytes(uint32_t *used_pct) {
+    const telemetry_snapshot_t *t = telemetry_acquire();
+    if (t) {
+        uint32_t free_mem = t->heap_free;
+        *used_pct = t->heap_used_pct;
+        telemetry_release(t);
+        return free_mem;
+    }
     uint32_t total = heap_caps_get_total_size(MALLOC_CAP_8BIT);
     uint32_t free_mem = heap_caps_get_free_size(MALLOC_CAP_8BIT);
-    uint32_t used_pct = (total > 0) ? ((total - free_mem) * 100 / total) : 0;
+    *used_pct = (total > 0) ? ((total - free_mem) * 100 / total) : 0;
+    return free_mem;
+}
+
+static void print_ram(char *buf, size_t len, uint32_t free_mem, uint32_t used_pct) {
     snprintf(buf, len, "%lu%% (%luK free)", (unsigned long)used_pct,
              (unsigned long)(free_mem / 1024));
 }
 
+// Per-core load over the last second (the long-window average in brackets)
+// and the busiest tasks over the long window, plus a plot line.
+static void print_cpu_load(void) {
+    const telemetry_snapshot_t *t = telemetry_acquire();
+    if (!t) {
+        return;
+    }
+    const cpu_load_window_t *now = &t->cpu.window[0];
+    const cpu_load_window_t *avg = &t->cpu.window[CPU_LOAD_WINDOW_COUNT - 1];
+    if (now->window_ms > 0) {
+        printf("  CPU:");
+        for (uint8_t c = 0; c < t->cpu.cores; c++) {
+            printf(" c%u %3u%% [%u%%]", (unsigned)c, (unsigned)now->core_pct[c], (unsigned)avg->core_pct[c]);
+        }
+        printf("\n  Top %lus:", (unsigned long)(avg->window_ms / 1000));
+        for (uint8_t i = 0; i < avg->top_count; i++) {
+            printf(" %s %u%%", avg->top[i].name, (unsigned)avg->top[i].pct);
+        }
+        printf("\n");
+        printf(">cpu0:%u,cpu1:%u\n", (unsigned)now->core_pct[0], (unsigned)now->core_pct[1]);
+    }
+    telemetry_release(t);
+}
+
 void dashboard_init(void) {
     if (!s_monitor_mutex) {
         s_monitor_mutex = xSemaphoreCreateMutex();
@@ -88,8 +125,10 @@ void dashboard_log(const char *fmt, ...) {
 
 void dashboard_render_src(const src_status_t *status) {
     char up[16], ram[24];
+    uint32_t used_pct;
+    uint32_t free_mem = heap_free_bytes(&used_pct);
     print_uptime(up, sizeof(up));
-    print_ram(ram, sizeof(ram));
+    print_ram(ram, sizeof(ram), free_mem, used_pct);
 
     const char *mode = "???";
     if (status->input_mode == INPUT_MODE_AUX) mode = "AUX";
@@ -120,6 +159,7 @@ void dashboard_render_src(const src_status_t *status) {
     if (status->input_mode == INPUT_MODE_TONE) {
         printf("  Tone: %lu Hz\n", (unsigned long)status->tone_freq_hz);
     }
+    print_cpu_load();
     printf("\n");
 
     // CSV for plotting
@@ -131,7 +171,7 @@ void dashboard_render_src(const src_status_t *status) {
            (unsigned)status->input_peak,
            status->output_volume,
            status->battery_pct,
-           (unsigned long)(heap_caps_get_free_size(MALLOC_CAP_8BIT) / 1024),
+           (unsigned long)(free_mem / 1024),
            status->usb_ready ? 1 : 0,
            status->usb_active ? 1 : 0,
            status->usb_fallback_to_aux ? 1 : 0);
@@ -141,8 +181,10 @@ void dashboard_render_src(const src_status_t *status) {
 
 void dashboard_render_out(const out_status_t *status) {
     char up[16], ram[24];
+    uint32_t used_pct;
+    uint32_t free_mem = heap_free_bytes(&used_pct);
     print_uptime(up, sizeof(up));
-    print_ram(ram, sizeof(ram));
+    print_ram(ram, sizeof(ram), free_mem, used_pct);
 
     const char *state = status->receiving_audio ? "RX" : "--";
     
@@ -166,6 +208,7 @@ void dashboard_render_out(const out_status_t *status) {
            (unsigned long)status->bandwidth_kbps,
            status->battery_pct, ram);
     printf("  Src:%s  %s\n", status->source_src_id, status->connection_state);
+    print_cpu_load();
     printf("\n");
 
     // CSV for plotting
@@ -174,55 +217,55 @@ void dashboard_render_out(const out_status_t *status) {
            status->loss_pct, status->buffer_pct,
            (unsigned long)status->bandwidth_kbps,
            status->battery_pct,
-           (unsigned long)(heap_caps_get_free_size(MALLOC_CAP_8BIT) / 1024));
+           (unsigned long)(free_mem / 1024));
 
     fflush(stdout);
 }
 
-int dashboard_serialize_recent_json(char *buf, size_t buf_size) {
-    if (!buf || buf_size < 32) {
-        return 0;
-    }
+uint32_t dashboard_write_monitor_range_json(json_writer_t *w, uint32_t after_seq, uint32_t last_seq) {
     if (!s_monitor_mutex) {
         s_monitor_mutex = xSemaphoreCreateMutex();
     }
 
-    int off = snprintf(buf, buf_size, "{\"monitor\":[");
-    if (off < 0 || off >= (int)buf_size) {
-        return 0;
+    uint32_t written = after_seq;
+    json_writer_begin_array(w);
+    if (s_monitor_mutex && xSemaphoreTake(s_monitor_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        uint16_t count = s_monitor_count;
+        uint16_t start = (uint16_t)((s_monitor_head + DASH_MONITOR_HISTORY_MAX - count) % DASH_MONITOR_HISTORY_MAX);
+        for (uint16_t i = 0; i < count; i++) {
+            uint16_t idx = (uint16_t)((start + i) % DASH_MONITOR_HISTORY_MAX);
+            if (s_monitor_seq[idx] <= after_seq || s_monitor_seq[idx] > last_seq) {
+                continue;
+            }
+            json_writer_begin_object(w);
+            json_writer_field_uint(w, "seq", s_monitor_seq[idx]);
+            json_writer_field_string(w, "line", s_monitor_lines[idx]);
+            json_writer_end_object(w);
+            written = s_monitor_seq[idx];
+        }
+        xSemaphoreGive(s_monitor_mutex);
     }
+    json_writer_end_array(w);
+    return written;
+}
 
-    if (!s_monitor_mutex || xSemaphoreTake(s_monitor_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-        off += snprintf(buf + off, buf_size - off, "]}");
-        return off;
-    }
+void dashboard_write_monitor_json(json_writer_t *w) {
+    dashboard_write_monitor_range_json(w, 0, UINT32_MAX);
+}
 
-    uint16_t count = s_monitor_count;
-    uint16_t start = (uint16_t)((s_monitor_head + DASH_MONITOR_HISTORY_MAX - count) % DASH_MONITOR_HISTORY_MAX);
+uint32_t dashboard_monitor_last_seq(void) {
+    return s_monitor_next_seq - 1;
+}
 
-    for (uint16_t i = 0; i < count && off < (int)buf_size - 32; i++) {
-        uint16_t idx = (uint16_t)((start + i) % DASH_MONITOR_HISTORY_MAX);
-        const char *line = s_monitor_lines[idx];
-        if (i > 0) {
-            off += snprintf(buf + off, buf_size - off, ",");
-        }
-        off += snprintf(buf + off, buf_size - off, "{\"seq\":%lu,\"line\":\"",
-                        (unsigned long)s_monitor_seq[idx]);
-
-        for (const char *p = line; *p && off < (int)buf_size - 8; p++) {
-            if (*p == '"' || *p == '\\') {
-                off += snprintf(buf + off, buf_size - off, "\\%c", *p);
-            } else if ((unsigned char)*p < 0x20) {
-                off += snprintf(buf + off, buf_size - off, " ");
-            } else {
-                buf[off++] = *p;
-                buf[off] = '\0';
-            }
-        }
-        off += snprintf(buf + off, buf_size - off, "\"}");
+int dashboard_serialize_recent_json(char *buf, size_t buf_size) {
+    if (!buf || buf_size < 32) {
+        return 0;
     }
-
-    xSemaphoreGive(s_monitor_mutex);
-    off += snprintf(buf + off, buf_size - off, "]}");
-    return off;
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, buf_size);
+    json_writer_begin_object(&w);
+    json_writer_key(&w, "monitor");
+    dashboard_write_monitor_json(&w);
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
 }
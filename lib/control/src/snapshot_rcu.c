@@ -0,0 +1,78 @@
+#include "control/snapshot_rcu.h"
+
+static int slot_index(const snapshot_rcu_t *rcu, const void *snapshot)
+{
+    size_t off = (size_t)((const uint8_t *)snapshot - rcu->storage);
+    return (int)(off / rcu->slot_size);
+}
+
+void snapshot_rcu_init(snapshot_rcu_t *rcu, void *storage, size_t slot_size)
+{
+    rcu->storage = (uint8_t *)storage;
+    rcu->slot_size = slot_size;
+    atomic_init(&rcu->current, -1);
+    atomic_init(&rcu->generation, 0);
+    for (int i = 0; i < SNAPSHOT_RCU_SLOTS; i++) {
+        atomic_init(&rcu->readers[i], 0);
+    }
+    rcu->writing = -1;
+    rcu->skipped = 0;
+}
+
+void *snapshot_rcu_write_begin(snapshot_rcu_t *rcu)
+{
+    int current = atomic_load(&rcu->current);
+    for (int i = 0; i < SNAPSHOT_RCU_SLOTS; i++) {
+        // A reader that raced onto a non-current slot backs off (see acquire),
+        // so a zero count here stays zero for as long as the slot is not current.
+        if (i != current && atomic_load(&rcu->readers[i]) == 0) {
+            rcu->writing = i;
+            return rcu->storage + (size_t)i * rcu->slot_size;
+        }
+    }
+    rcu->writing = -1;
+    rcu->skipped++;
+    return NULL;
+}
+
+uint32_t snapshot_rcu_write_commit(snapshot_rcu_t *rcu)
+{
+    if (rcu->writing < 0) {
+        return atomic_load(&rcu->generation);
+    }
+    atomic_store(&rcu->current, rcu->writing);
+    rcu->writing = -1;
+    return atomic_fetch_add(&rcu->generation, 1) + 1;
+}
+
+const void *snapshot_rcu_acquire(snapshot_rcu_t *rcu)
+{
+    while (1) {
+        int slot = atomic_load(&rcu->current);
+        if (slot < 0) {
+            return NULL;
+        }
+        atomic_fetch_add(&rcu->readers[slot], 1);
+        // Still current after taking the reference: the writer cannot pick
+        // this slot until the count drops. Otherwise a newer slot was
+        // published in between and the writer may already be refilling this
+        // one, so let go and take the newer one.
+        if (atomic_load(&rcu->current) == slot) {
+            return rcu->storage + (size_t)slot * rcu->slot_size;
+        }
+        atomic_fetch_sub(&rcu->readers[slot], 1);
+    }
+}
+
+void snapshot_rcu_release(snapshot_rcu_t *rcu, const void *snapshot)
+{
+    if (!snapshot) {
+        return;
+    }
+    atomic_fetch_sub(&rcu->readers[slot_index(rcu, snapshot)], 1);
+}
+
+uint32_t snapshot_rcu_generation(snapshot_rcu_t *rcu)
+{
+    return atomic_load(&rcu->generation);
+}
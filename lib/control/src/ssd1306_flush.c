@@ -0,0 +1,69 @@
+#include "control/ssd1306_flush.h"
+
+#include <string.h>
+
+#define SSD1306_CMD_SET_COLUMN_ADDR 0x21
+#define SSD1306_CMD_SET_PAGE_ADDR   0x22
+
+void ssd1306_flush_init(ssd1306_flush_t *f, uint8_t width, uint8_t pages)
+{
+    memset(f, 0, sizeof(*f));
+    f->width = width < SSD1306_FLUSH_MAX_WIDTH ? width : SSD1306_FLUSH_MAX_WIDTH;
+    f->pages = pages < SSD1306_FLUSH_MAX_PAGES ? pages : SSD1306_FLUSH_MAX_PAGES;
+}
+
+void ssd1306_flush_invalidate(ssd1306_flush_t *f)
+{
+    f->synced = 0;
+}
+
+static size_t put_command(uint8_t *out, size_t n, uint8_t cmd)
+{
+    out[n++] = SSD1306_CTRL_CMD_SINGLE;
+    out[n++] = cmd;
+    return n;
+}
+
+int ssd1306_flush(ssd1306_flush_t *f, const uint8_t *fb, ssd1306_write_fn write, void *ctx)
+{
+    int sent = 0;
+    for (uint8_t page = 0; page < f->pages; page++) {
+        const uint8_t *src = &fb[page * f->width];
+        uint8_t *shadow = &f->shadow[page * f->width];
+        uint8_t bit = (uint8_t)(1U << page);
+
+        uint8_t first = 0;
+        uint8_t last = (uint8_t)(f->width - 1);
+        if (f->synced & bit) {
+            while (first < f->width && src[first] == shadow[first]) {
+                first++;
+            }
+            if (first == f->width) {
+                continue;
+            }
+            while (src[last] == shadow[last]) {
+                last--;
+            }
+        }
+
+        size_t n = 0;
+        n = put_command(f->tx, n, SSD1306_CMD_SET_COLUMN_ADDR);
+        n = put_command(f->tx, n, first);
+        n = put_command(f->tx, n, last);
+        n = put_command(f->tx, n, SSD1306_CMD_SET_PAGE_ADDR);
+        n = put_command(f->tx, n, page);
+        n = put_command(f->tx, n, page);
+        f->tx[n++] = SSD1306_CTRL_DATA_STREAM;
+        size_t len = (size_t)(last - first) + 1;
+        memcpy(&f->tx[n], &src[first], len);
+
+        if (!write(ctx, f->tx, n + len)) {
+            f->synced &= (uint8_t)~bit;
+            continue;
+        }
+        memcpy(&shadow[first], &src[first], len);
+        f->synced |= bit;
+        sent++;
+    }
+    return sent;
+}
@@ -0,0 +1,210 @@
+#include "control/telemetry.h"
+#include "control/snapshot_rcu.h"
+#include "audio/usb_audio.h"
+#include "network/mesh_net.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "telemetry";
+
+static telemetry_snapshot_t s_slots[SNAPSHOT_RCU_SLOTS];
+static snapshot_rcu_t s_rcu;
+static bool s_rcu_ready = false;
+static adf_pipeline_handle_t s_pipeline = NULL;
+static TaskHandle_t s_task = NULL;
+
+// CPU accounting state, owned by the publishing task. The task arrays grow
+// with the task count; cpu_load itself tracks at most CPU_LOAD_MAX_TASKS.
+static cpu_load_t s_cpu;
+static TaskStatus_t *s_task_status = NULL;
+static cpu_load_task_sample_t *s_task_samples = NULL;
+static UBaseType_t s_task_capacity = 0;
+static uint32_t s_cpu_skipped = 0;
+
+_Static_assert(portNUM_PROCESSORS <= CPU_LOAD_MAX_CORES, "cpu_load must cover every core");
+#if CONFIG_FREERTOS_RUN_TIME_STATS_USING_CPU_CLK
+#error "cpu_load_init below assumes the esp_timer run-time stats clock"
+#endif
+
+static uint32_t rate_kbps(size_t stat)
+{
+    network_stat_rate_t rate;
+    if (network_get_transport_rate(stat, &rate) != ESP_OK) {
+        return 0;
+    }
+    return (uint32_t)(rate.per_sec_1s * 8.0f / 1000.0f);
+}
+
+void telemetry_sample(telemetry_snapshot_t *t, adf_pipeline_handle_t pipeline)
+{
+    memset(t, 0, sizeof(*t));
+    t->sampled_us = esp_timer_get_time();
+    t->uptime_s = (uint32_t)(t->sampled_us / 1000000);
+
+    t->heap_free = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    t->heap_total = (uint32_t)heap_caps_get_total_size(MALLOC_CAP_8BIT);
+    t->heap_min_free = (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    t->heap_used_pct = t->heap_total > 0
+        ? (uint8_t)((uint64_t)(t->heap_total - t->heap_free) * 100 / t->heap_total)
+        : 0;
+
+    t->mesh_connected = network_is_connected();
+    t->mesh_root = network_is_root();
+    t->mesh_layer = network_get_layer();
+    t->rssi = network_get_rssi();
+    t->connected_nodes = network_get_connected_nodes();
+    t->latency_ms = network_get_latency_ms();
+
+    t->tx_kbps = rate_kbps(NETWORK_TRANSPORT_STAT(tx_audio_bytes));
+    network_stat_rate_t rx_rate;
+    t->receiving_audio = network_get_transport_rate(NETWORK_TRANSPORT_STAT(rx_audio_forwarded), &rx_rate) == ESP_OK &&
+                         rx_rate.per_sec_1s > 0.0f;
+
+    if (pipeline) {
+        t->pipeline_valid = adf_pipeline_get_stats(pipeline, &t->pipeline) == ESP_OK;
+        t->input_mode = adf_pipeline_get_input_mode(pipeline);
+        bool fft_valid = false;
+        t->fft_valid = adf_pipeline_get_fft_bins(pipeline, t->fft_bins, FFT_PORTAL_BIN_COUNT, &fft_valid) == ESP_OK &&
+                       fft_valid;
+    }
+    t->usb_ready = usb_audio_is_ready();
+    t->usb_active = usb_audio_is_active();
+}
+
+// Feeds every task's run-time counter to the CPU accounting. FreeRTOS
+// charges run time at each context switch, so short audio bursts count in
+// full; each core's idle task gets exactly the time nothing else wanted.
+static bool reserve_task_status(UBaseType_t want)
+{
+    if (want <= s_task_capacity) {
+        return true;
+    }
+    TaskStatus_t *status = realloc(s_task_status, want * sizeof(*status));
+    if (!status) {
+        return false;
+    }
+    s_task_status = status;
+    cpu_load_task_sample_t *samples = realloc(s_task_samples, want * sizeof(*samples));
+    if (!samples) {
+        return false;
+    }
+    s_task_samples = samples;
+    s_task_capacity = want;
+    return true;
+}
+
+static void sample_cpu(void)
+{
+    uint32_t now = 0;
+    UBaseType_t n = 0;
+    if (reserve_task_status(uxTaskGetNumberOfTasks() + TELEMETRY_TASK_HEADROOM)) {
+        n = uxTaskGetSystemState(s_task_status, s_task_capacity, &now);
+    }
+    if (n == 0) {
+        // Out of memory, or more tasks appeared than the headroom covers.
+        // Nothing was written; the next interval retries with a fresh count.
+        if (s_cpu_skipped++ == 0) {
+            ESP_LOGW(TAG, "CPU sample skipped (%u tasks, %u slots)",
+                     (unsigned)uxTaskGetNumberOfTasks(), (unsigned)s_task_capacity);
+        }
+        return;
+    }
+    TaskHandle_t idle[portNUM_PROCESSORS];
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        idle[core] = xTaskGetIdleTaskHandleForCPU(core);
+    }
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *ts = &s_task_status[i];
+        cpu_load_task_sample_t *s = &s_task_samples[i];
+        BaseType_t affinity = xTaskGetAffinity(ts->xHandle);
+        s->id = (uint32_t)ts->xTaskNumber;
+        s->name = ts->pcTaskName;
+        s->core = affinity == tskNO_AFFINITY ? CPU_LOAD_CORE_ANY : (uint8_t)affinity;
+        s->idle = false;
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            s->idle = s->idle || ts->xHandle == idle[core];
+        }
+        s->runtime = (uint32_t)ts->ulRunTimeCounter;
+    }
+    cpu_load_sample(&s_cpu, now, s_task_samples, n);
+}
+
+// Only the telemetry task (and telemetry_start before creating it) publishes:
+// snapshot_rcu has a single writer.
+static void publish(void)
+{
+    telemetry_snapshot_t *slot = snapshot_rcu_write_begin(&s_rcu);
+    if (!slot) {
+        return;     // Every spare slot is still being read; try next interval
+    }
+    telemetry_sample(slot, s_pipeline);
+    sample_cpu();
+    cpu_load_report(&s_cpu, &slot->cpu);
+    slot->cpu_samples_skipped = s_cpu_skipped;
+    slot->generation = snapshot_rcu_generation(&s_rcu) + 1;
+    snapshot_rcu_write_commit(&s_rcu);
+}
+
+static void telemetry_task(void *arg)
+{
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TELEMETRY_PUBLISH_INTERVAL_MS));
+        publish();
+    }
+}
+
+esp_err_t telemetry_start(adf_pipeline_handle_t pipeline)
+{
+    if (s_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!s_rcu_ready) {
+        snapshot_rcu_init(&s_rcu, s_slots, sizeof(s_slots[0]));
+        s_rcu_ready = true;
+    }
+    cpu_load_init(&s_cpu, portNUM_PROCESSORS, 1000000);    // esp_timer microseconds
+    s_pipeline = pipeline;
+    publish();
+
+    if (xTaskCreate(telemetry_task, "telemetry", TELEMETRY_TASK_STACK_BYTES, NULL,
+                    TELEMETRY_TASK_PRIO, &s_task) != pdPASS) {
+        s_task = NULL;
+        ESP_LOGE(TAG, "Failed to create telemetry task");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Publishing every %d ms", TELEMETRY_PUBLISH_INTERVAL_MS);
+    return ESP_OK;
+}
+
+void telemetry_stop(void)
+{
+    if (s_task) {
+        vTaskDelete(s_task);
+        s_task = NULL;
+    }
+}
+
+const telemetry_snapshot_t *telemetry_acquire(void)
+{
+    return s_rcu_ready ? (const telemetry_snapshot_t *)snapshot_rcu_acquire(&s_rcu) : NULL;
+}
+
+void telemetry_release(const telemetry_snapshot_t *snapshot)
+{
+    if (s_rcu_ready) {
+        snapshot_rcu_release(&s_rcu, snapshot);
+    }
+}
+
+uint32_t telemetry_generation(void)
+{
+    return s_rcu_ready ? snapshot_rcu_generation(&s_rcu) : 0;
+}
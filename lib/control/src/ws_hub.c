@@ -0,0 +1,236 @@
+#include "control/ws_hub.h"
+
+#include <string.h>
+
+static ws_hub_client_t *find_client(ws_hub_t *hub, int fd)
+{
+    for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+        if (hub->clients[i].fd == fd) {
+            return &hub->clients[i];
+        }
+    }
+    return NULL;
+}
+
+void ws_hub_init(ws_hub_t *hub)
+{
+    memset(hub, 0, sizeof(*hub));
+    for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+        hub->clients[i].fd = -1;
+    }
+}
+
+bool ws_hub_add_client(ws_hub_t *hub, int fd, uint8_t topics)
+{
+    if (fd < 0) {
+        return false;
+    }
+    ws_hub_client_t *c = find_client(hub, fd);
+    if (!c) {
+        c = find_client(hub, -1);
+    }
+    if (!c) {
+        return false;
+    }
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+    c->topics = topics;
+    c->epoch = ++hub->next_epoch;
+    c->needs_full = true;
+    return true;
+}
+
+void ws_hub_remove_client(ws_hub_t *hub, int fd)
+{
+    ws_hub_client_t *c = fd >= 0 ? find_client(hub, fd) : NULL;
+    if (c) {
+        memset(c, 0, sizeof(*c));
+        c->fd = -1;
+    }
+}
+
+bool ws_hub_set_topics(ws_hub_t *hub, int fd, uint8_t topics)
+{
+    ws_hub_client_t *c = fd >= 0 ? find_client(hub, fd) : NULL;
+    if (!c) {
+        return false;
+    }
+    c->topics = topics;
+    c->epoch = ++hub->next_epoch;
+    c->needs_full = true;
+    return true;
+}
+
+int ws_hub_client_count(const ws_hub_t *hub)
+{
+    int n = 0;
+    for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+        n += hub->clients[i].fd >= 0;
+    }
+    return n;
+}
+
+bool ws_hub_needs_full(const ws_hub_t *hub)
+{
+    for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+        if (hub->clients[i].fd >= 0 && hub->clients[i].needs_full) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ws_hub_begin_pass(ws_hub_t *hub)
+{
+    hub->seq++;
+    hub->changed_fields = 0;
+    hub->changed_topics = 0;
+    hub->removed_count = 0;
+    for (int i = 0; i < hub->item_count; i++) {
+        hub->items[i].seen = false;
+        hub->items[i].changed = false;
+    }
+}
+
+bool ws_hub_update_field(ws_hub_t *hub, unsigned field, uint8_t topic, uint32_t hash)
+{
+    if (field >= WS_HUB_MAX_FIELDS) {
+        return false;
+    }
+    uint32_t bit = 1U << field;
+    if ((hub->known_fields & bit) && hub->field_hash[field] == hash) {
+        return false;
+    }
+    hub->known_fields |= bit;
+    hub->field_hash[field] = hash;
+    hub->changed_fields |= bit;
+    hub->changed_topics |= (uint8_t)(1U << topic);
+    return true;
+}
+
+bool ws_hub_update_item(ws_hub_t *hub, uint64_t key, uint8_t topic, uint32_t hash)
+{
+    ws_hub_item_t *item = NULL;
+    for (int i = 0; i < hub->item_count; i++) {
+        if (hub->items[i].key == key) {
+            item = &hub->items[i];
+            break;
+        }
+    }
+    if (!item && hub->item_count < WS_HUB_MAX_ITEMS) {
+        item = &hub->items[hub->item_count++];
+        item->key = key;
+        item->hash = hash ^ 1U;     // Differs from hash: new items are changes
+    }
+    if (!item) {
+        // Untracked past the table size: always resend rather than go stale.
+        hub->changed_topics |= (uint8_t)(1U << topic);
+        return true;
+    }
+    item->seen = true;
+    if (item->hash == hash) {
+        return false;
+    }
+    item->hash = hash;
+    item->changed = true;
+    hub->changed_topics |= (uint8_t)(1U << topic);
+    return true;
+}
+
+void ws_hub_mark_topic(ws_hub_t *hub, uint8_t topic)
+{
+    hub->changed_topics |= (uint8_t)(1U << topic);
+}
+
+void ws_hub_end_pass(ws_hub_t *hub, uint8_t item_topic)
+{
+    int kept = 0;
+    for (int i = 0; i < hub->item_count; i++) {
+        if (!hub->items[i].seen) {
+            hub->removed[hub->removed_count++] = hub->items[i].key;
+            continue;
+        }
+        hub->items[kept++] = hub->items[i];
+    }
+    hub->item_count = (uint8_t)kept;
+    if (hub->removed_count > 0) {
+        hub->changed_topics |= (uint8_t)(1U << item_topic);
+    }
+}
+
+bool ws_hub_field_changed(const ws_hub_t *hub, unsigned field)
+{
+    return field < WS_HUB_MAX_FIELDS && (hub->changed_fields & (1U << field)) != 0;
+}
+
+bool ws_hub_item_changed(const ws_hub_t *hub, uint64_t key)
+{
+    for (int i = 0; i < hub->item_count; i++) {
+        if (hub->items[i].key == key) {
+            return hub->items[i].changed;
+        }
+    }
+    return true;
+}
+
+ws_hub_send_t ws_hub_plan(ws_hub_t *hub, int i, bool writable, ws_hub_job_t *job)
+{
+    ws_hub_client_t *c = &hub->clients[i];
+    if (c->fd < 0) {
+        return WS_HUB_SEND_NONE;
+    }
+    ws_hub_send_t kind = c->needs_full ? WS_HUB_SEND_FULL
+                       : (hub->changed_topics & c->topics) ? WS_HUB_SEND_DELTA
+                       : WS_HUB_SEND_NONE;
+    if (kind == WS_HUB_SEND_NONE) {
+        return kind;
+    }
+    if (!writable) {
+        // Skipping a delta loses the client's baseline; skipping a full keeps it
+        // owed. Either way it is resynced from scratch once it drains.
+        c->dropped++;
+        c->needs_full = true;
+        return WS_HUB_SEND_NONE;
+    }
+    job->fd = c->fd;
+    job->topics = c->topics;
+    job->epoch = c->epoch;
+    job->kind = kind;
+    return kind;
+}
+
+void ws_hub_sent(ws_hub_t *hub, const ws_hub_job_t *job, ws_hub_result_t result)
+{
+    ws_hub_client_t *c = job->fd >= 0 ? find_client(hub, job->fd) : NULL;
+    if (!c || c->epoch != job->epoch) {
+        // A newer registration owns the slot and has its own full snapshot due.
+        return;
+    }
+    if (result == WS_HUB_SENT_FAILED) {
+        ws_hub_remove_client(hub, c->fd);
+        return;
+    }
+    if (result == WS_HUB_SENT_BACKED_UP) {
+        c->dropped++;
+        c->needs_full = true;
+        return;
+    }
+    if (job->kind == WS_HUB_SEND_FULL) {
+        c->needs_full = false;
+        c->sent_full++;
+    } else if (job->kind == WS_HUB_SEND_DELTA) {
+        c->sent_delta++;
+    }
+}
+
+bool ws_hub_hash_sink(void *ctx, const char *data, size_t len, bool final)
+{
+    (void)final;
+    uint32_t h = *(uint32_t *)ctx;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)data[i];
+        h *= 16777619u;
+    }
+    *(uint32_t *)ctx = h;
+    return true;
+}
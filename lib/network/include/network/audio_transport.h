@@ -1,6 +1,7 @@
 #pragma once
 
 #include <esp_err.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -8,15 +9,23 @@
 extern "C" {
 #endif
 
-// Build and send an audio packet from an Opus batch payload.
-// Payload format: repeated [uint16_be frame_len][frame_bytes...]
-// where frame_count specifies how many frames are encoded in the payload.
-esp_err_t network_send_audio_batch(const uint8_t *opus_batch_payload,
-                                   size_t payload_len,
-                                   uint16_t seq,
-                                   uint32_t timestamp_ms,
-                                   uint8_t frame_count,
-                                   uint8_t stream_id);
+// Zero-copy audio TX: the encoder writes each Opus frame straight into the outgoing
+// packet (header space is reserved up front), then network_audio_tx_send finalizes the
+// header in place and hands the same buffer to the mesh. Single producer only.
+//
+//   size_t cap;
+//   uint8_t *slot = network_audio_tx_frame_slot(&cap);
+//   int len = opus_encode(..., slot, cap);
+//   network_audio_tx_commit_frame(len);
+//   if (network_audio_tx_frame_count() >= MESH_FRAMES_PER_PACKET) network_audio_tx_send(...);
+uint8_t *network_audio_tx_frame_slot(size_t *capacity_out);
+esp_err_t network_audio_tx_commit_frame(size_t frame_len);
+uint8_t network_audio_tx_frame_count(void);
+void network_audio_tx_reset(void);
+esp_err_t network_audio_tx_send(uint16_t seq, uint32_t timestamp_ms, uint8_t stream_id);
+
+// Most recent stream_id/seq/timestamp handed to network_audio_tx_send.
+bool network_get_audio_tx_anchor(uint8_t *stream_id, uint16_t *seq, uint32_t *timestamp_ms);
 
 #ifdef __cplusplus
 }
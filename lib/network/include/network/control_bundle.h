@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Several control messages framed into one mesh packet:
+//   [type=NET_CTRL_BUNDLE_TYPE][count] then count x ([len_hi][len_lo][message])
+// Each message is an unmodified control packet (first byte is its own type), so
+// the receiver dispatches them exactly as if they had arrived one by one.
+#define NET_CTRL_BUNDLE_TYPE            0x13  // net_pkt_type_t NET_PKT_TYPE_CONTROL_BUNDLE
+#define NET_CTRL_BUNDLE_HEADER_SIZE     2
+#define NET_CTRL_BUNDLE_ENTRY_OVERHEAD  2
+#define NET_CTRL_BUNDLE_MAX_MESSAGES    255
+
+typedef struct {
+    uint8_t *buf;
+    size_t capacity;
+    size_t len;
+    uint8_t count;
+} network_ctrl_bundle_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t offset;
+    uint8_t remaining;
+} network_ctrl_bundle_reader_t;
+
+void network_ctrl_bundle_init(network_ctrl_bundle_t *bundle, uint8_t *buf, size_t capacity);
+void network_ctrl_bundle_reset(network_ctrl_bundle_t *bundle);
+bool network_ctrl_bundle_fits(const network_ctrl_bundle_t *bundle, size_t msg_len);
+bool network_ctrl_bundle_append(network_ctrl_bundle_t *bundle, const uint8_t *msg, size_t msg_len);
+// A bundle holding one message is sent as that message alone (no framing cost,
+// and still understood by nodes that predate bundles).
+bool network_ctrl_bundle_single(const network_ctrl_bundle_t *bundle, const uint8_t **msg, size_t *msg_len);
+
+bool network_ctrl_bundle_reader_init(network_ctrl_bundle_reader_t *reader, const uint8_t *data, size_t len);
+// Returns false at the end of the bundle or on a truncated/corrupt entry.
+bool network_ctrl_bundle_next(network_ctrl_bundle_reader_t *reader, const uint8_t **msg, size_t *msg_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,48 @@
 extern "C" {
 #endif
 
+// Audio frame wire constants (header structs live in mesh_net.h)
+#define NET_FRAME_MAGIC 0xA5
+#define NET_FRAME_VERSION 1
+#define NET_FRAME_VERSION_V2 2
+
+#define NET_FRAME_HEADER_SIZE     26  // v1 header with src_id
+#define NET_FRAME_HEADER_SIZE_V1  14  // Older v1 header format (no src_id)
+#define NET_FRAME_HEADER_SIZE_V2  11  // Compact v2 header (src_id via stream announce)
+#define NET_FRAME_LEGACY_FRAME_COUNT_OFFSET 13
+#define NET_FRAME_V2_TTL_MAX      0x0F
+#define NET_FRAME_V2_FRAMES_MAX   0x0F
+
+// Decoded view of a v1 or v2 audio header, in host byte order
+typedef struct {
+    uint8_t version;
+    uint8_t type;
+    uint8_t ttl;
+    uint8_t stream_id;
+    uint8_t frame_count;
+    uint16_t seq;
+    uint32_t timestamp;
+    uint16_t payload_len;
+    size_t header_size;
+} network_frame_info_t;
+
+// Per-stream anchor used to extend the v2 8-bit sequence delta and 24-bit timestamp
+typedef struct {
+    bool valid;
+    uint16_t seq;
+    uint32_t timestamp;
+} network_frame_ref_t;
+
+// In-place batch builder: header space is reserved up front and each frame is
+// written straight into the packet behind its [uint16_be len] prefix.
+typedef struct {
+    uint8_t *buf;
+    size_t capacity;
+    size_t header_size;
+    size_t len;             // header_size + committed payload bytes
+    uint8_t frame_count;
+} network_frame_builder_t;
+
 typedef void (*network_frame_iter_callback_t)(const uint8_t *frame,
                                               uint16_t frame_len,
                                               uint16_t seq,
@@ -26,6 +68,34 @@ uint8_t network_frame_extract_frame_count(const uint8_t *packet,
                                           uint8_t frame_count_current,
                                           size_t legacy_frame_count_offset);
 
+uint16_t network_frame_extend_seq(uint16_t ref_seq, uint8_t seq_delta);
+uint32_t network_frame_extend_timestamp(uint32_t ref_timestamp, uint32_t timestamp24);
+
+size_t network_frame_encode_header_v2(const network_frame_info_t *info, uint8_t *out, size_t out_size);
+
+// Decodes v1 (current or legacy) and v2 headers. ref may be NULL for v1; for v2 it
+// anchors sequence/timestamp extension and is advanced to the decoded values. A v2
+// header without a valid ref decodes only the low seq/timestamp bits and leaves ref
+// invalid; callers must not use those as stream positions.
+bool network_frame_decode_header(const uint8_t *packet,
+                                 size_t packet_size,
+                                 network_frame_ref_t *ref,
+                                 network_frame_info_t *out);
+
+void network_frame_decrement_ttl(uint8_t *packet, size_t packet_size);
+
+bool network_frame_builder_init(network_frame_builder_t *builder,
+                                uint8_t *buf,
+                                size_t capacity,
+                                size_t header_size);
+void network_frame_builder_reset(network_frame_builder_t *builder);
+// Returns where the next frame's bytes go (after its length prefix) and how many fit.
+uint8_t *network_frame_builder_frame_slot(network_frame_builder_t *builder,
+                                          size_t max_frame_len,
+                                          size_t *capacity_out);
+bool network_frame_builder_commit_frame(network_frame_builder_t *builder, size_t frame_len);
+size_t network_frame_builder_payload_len(const network_frame_builder_t *builder);
+
 size_t network_frame_unpack_batch(const uint8_t *payload,
                                   size_t payload_len,
                                   uint8_t frame_count,
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Root-side per-child link statistics, keyed by MAC in an open-addressed table.
+// Written by the mesh RX task; readers (fanout, portal, display) iterate in place
+// and may observe a partially updated entry, which is fine for telemetry.
+
+typedef enum {
+    NETWORK_LINK_SLOT_EMPTY = 0,
+    NETWORK_LINK_SLOT_USED,
+    NETWORK_LINK_SLOT_TOMBSTONE,
+} network_link_slot_state_t;
+
+typedef struct {
+    uint8_t mac[6];
+    uint8_t state;              // network_link_slot_state_t
+    uint8_t has_rssi;
+    int16_t rssi_ewma_q4;       // dBm * 16, EWMA alpha 1/8
+    uint16_t loss_pct_q8;       // Loss % * 256, EWMA alpha 1/4
+    uint32_t rtt_min_us;
+    uint32_t rtt_avg_us;        // EWMA alpha 1/8
+    uint32_t rtt_samples;
+    uint32_t lost_frames;       // Total frames reported missing
+    uint32_t interval_lost;     // Frames reported missing since the interval opened
+    uint32_t interval_base;     // Sender frame total when the interval opened
+    uint8_t interval_open;
+    int64_t first_seen_ms;
+    int64_t last_heartbeat_ms;
+    int64_t last_seen_ms;       // Any evidence (heartbeat, pong, loss report)
+} network_link_entry_t;
+
+typedef struct {
+    network_link_entry_t slots[MESH_LINK_TABLE_CAPACITY];
+    uint16_t count;
+    uint16_t tombstones;
+} network_link_table_t;
+
+typedef struct {
+    const network_link_table_t *table;
+    uint16_t index;
+} network_link_iter_t;
+
+void network_link_table_init(network_link_table_t *table);
+network_link_entry_t *network_link_table_find(network_link_table_t *table, const uint8_t mac[6]);
+network_link_entry_t *network_link_table_upsert(network_link_table_t *table, const uint8_t mac[6], int64_t now_ms);
+bool network_link_table_remove(network_link_table_t *table, const uint8_t mac[6]);
+size_t network_link_table_expire(network_link_table_t *table, int64_t now_ms, uint32_t max_age_ms);
+
+void network_link_table_record_heartbeat(network_link_table_t *table, const uint8_t mac[6],
+                                         int8_t rssi, int64_t now_ms);
+void network_link_table_record_rtt(network_link_table_t *table, const uint8_t mac[6],
+                                   uint32_t rtt_us, int64_t now_ms);
+// Loss is measured per interval: NACKed frames accumulate, and closing the interval
+// (once per heartbeat) turns them into a sample against the frames sent meanwhile.
+void network_link_table_record_loss(network_link_table_t *table, const uint8_t mac[6],
+                                    uint32_t lost_frames, int64_t now_ms);
+void network_link_table_close_loss_interval(network_link_table_t *table, const uint8_t mac[6],
+                                            uint32_t frames_sent_total, int64_t now_ms);
+
+int8_t network_link_rssi_dbm(const network_link_entry_t *entry);
+uint8_t network_link_loss_pct(const network_link_entry_t *entry);
+uint32_t network_link_heartbeat_age_ms(const network_link_entry_t *entry, int64_t now_ms);
+
+// Zero-copy iteration over used entries, in slot order.
+void network_link_iter_begin(network_link_iter_t *it, const network_link_table_t *table);
+const network_link_entry_t *network_link_iter_next(network_link_iter_t *it);
+
+#ifdef __cplusplus
+}
+#endif
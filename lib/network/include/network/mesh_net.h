@@ -10,6 +10,9 @@
 
 #include "network/uplink_control.h"
 #include "network/mixer_control.h"
+#include "network/stat_counters.h"
+#include "network/frame_codec.h"
+#include "network/control_bundle.h"
 
 // ============================================================================
 // ESP-WIFI-MESH Network API (v0.1)
@@ -49,9 +52,7 @@ typedef struct {
     uint32_t updated_ms;
 } network_mixer_status_t;
 
-// Network framing header (aligned with mesh-network-architecture.md)
-#define NET_FRAME_MAGIC 0xA5
-#define NET_FRAME_VERSION 1
+// Network framing constants (NET_FRAME_*) live in network/frame_codec.h
 
 typedef enum {
 	NET_PKT_TYPE_AUDIO_RAW = 1,
@@ -59,11 +60,16 @@ typedef enum {
 	NET_PKT_TYPE_STREAM_ANNOUNCE = 3,
 	NET_PKT_TYPE_CONTROL = 0x10,
 	NET_PKT_TYPE_AUDIO_OPUS = 0x11,  // Opus-compressed audio frame
+	NET_PKT_TYPE_NACK = 0x12,        // Selective retransmit request (OUT -> root)
+	NET_PKT_TYPE_CONTROL_BUNDLE = 0x13, // Several control messages in one packet (control_bundle.h)
+	NET_PKT_TYPE_MIXER_DELTA = 0x14,  // Versioned mixer state change (root -> nodes)
 	NET_PKT_TYPE_PING = 0x20,        // Latency measurement request
 	NET_PKT_TYPE_PONG = 0x21,        // Latency measurement response
 	NET_PKT_TYPE_POSITIONS = 0x30,   // Broadcast node (x, y, z) coordinates
 } net_pkt_type_t;
 
+_Static_assert(NET_PKT_TYPE_CONTROL_BUNDLE == NET_CTRL_BUNDLE_TYPE, "control bundle type mismatch");
+
 // Positional metadata for a single node
 typedef struct __attribute__((packed)) {
 	uint8_t mac[6];
@@ -87,10 +93,15 @@ typedef struct __attribute__((packed)) {
 	uint32_t ping_id;       // Sequence number (echoed back in PONG)
 } mesh_ping_t;
 
-// Audio frame header.
-#define NET_FRAME_HEADER_SIZE     26  // Current wire header size (used for TX)
-#define NET_FRAME_HEADER_SIZE_V1  14  // Older header format (no src_id)
+// Retransmit request for missed audio sequences (sent over the control path)
+typedef struct __attribute__((packed)) {
+	uint8_t type;           // 0x12 = NACK
+	uint8_t stream_id;      // Stream the missing frames belong to
+	uint16_t base_seq;      // First missing sequence number
+	uint32_t bitmap;        // Bit i set => base_seq + 1 + i is also missing
+} mesh_nack_t;
 
+// Audio frame header (v1).
 typedef struct __attribute__((packed)) {
 	uint8_t magic;          // 0xA5
 	uint8_t version;        // 1
@@ -104,6 +115,21 @@ typedef struct __attribute__((packed)) {
 	char src_id[NETWORK_SRC_ID_LEN]; // Source identifier
 } net_frame_header_t;
 
+// Compact audio frame header (v2). src_id is resolved from mesh_stream_announce_t.
+typedef struct __attribute__((packed)) {
+	uint8_t magic;          // 0xA5
+	uint8_t version;        // 2
+	uint8_t type;           // AUDIO_RAW / AUDIO_OPUS
+	uint8_t ttl_frames;     // ttl (high nibble) | frame_count (low nibble)
+	uint8_t stream_id;      // Stream index, resolved via STREAM_ANNOUNCE
+	uint8_t seq_delta;      // Low 8 bits of seq, extended against the last seen seq
+	uint8_t timestamp[3];   // 24-bit media timestamp (ms, big-endian)
+	uint16_t payload_len;   // Total bytes following header
+} net_frame_header_v2_t;
+
+_Static_assert(sizeof(net_frame_header_t) == NET_FRAME_HEADER_SIZE, "v1 header size mismatch");
+_Static_assert(sizeof(net_frame_header_v2_t) == NET_FRAME_HEADER_SIZE_V2, "v2 header size mismatch");
+
 // Heartbeat packet (sent to root by all nodes)
 typedef struct __attribute__((packed)) {
 	uint8_t type;           // 0x02 = HEARTBEAT
@@ -123,7 +149,7 @@ typedef struct __attribute__((packed)) {
 	char src_id[NETWORK_SRC_ID_LEN]; // Human-friendly ID
 } mesh_heartbeat_t;
 
-// Stream announcement (sent by root to announce active stream)
+// Stream announcement (sent periodically by the SRC to announce its active stream)
 typedef struct __attribute__((packed)) {
 	uint8_t type;           // 0x03 = STREAM_ANNOUNCE
 	uint8_t stream_id;      // Unique ID for this audio stream
@@ -131,6 +157,9 @@ typedef struct __attribute__((packed)) {
 	uint8_t channels;       // 1 (mono)
 	uint8_t bits_per_sample; // 16
 	uint16_t frame_size_ms; // 20
+	char src_id[NETWORK_SRC_ID_LEN]; // Resolves v2 stream_id -> src_id
+	uint16_t seq;           // Latest TX sequence (v2 extension anchor)
+	uint32_t timestamp;     // Latest TX media timestamp (v2 extension anchor)
 } mesh_stream_announce_t;
 
 // Network initialization
@@ -166,6 +195,7 @@ typedef struct {
     uint32_t rx_audio_invalid_header;
     uint32_t rx_audio_invalid_version;
     uint32_t rx_audio_invalid_payload;
+    uint32_t rx_audio_unanchored;   // v2 dropped before the stream's announce
     uint32_t rx_audio_forwarded;
     uint32_t rx_audio_burst_loss_events;
     uint32_t rx_audio_burst_loss_max;
@@ -185,11 +215,45 @@ typedef struct {
     uint32_t rejoin_blocked_events;
     uint32_t rejoin_circuit_breaker_events;
     uint32_t tx_audio_backpressure_level;
+    uint32_t tx_nack_packets;
+    uint32_t tx_nack_rate_limited;
+    uint32_t rx_nack_packets;
+    uint32_t tx_retransmit_packets;
+    uint32_t tx_retransmit_cache_miss;
+    uint32_t tx_retransmit_deadline_miss;
+    uint32_t tx_retransmit_rate_limited;
+    uint32_t pkt_pool_in_use;       // Packet buffers currently referenced
+    uint32_t pkt_pool_high_water;   // Peak buffers referenced since last reset
+    uint32_t pkt_pool_exhausted;    // Allocations that found the pool empty
+    uint32_t tx_control_bundles;    // Multi-message control packets sent
+    uint32_t tx_control_coalesced;  // Control messages that rode in a bundle
+    uint32_t rx_control_bundles;
+    uint32_t rx_control_digest_heartbeats; // Relay: subtree heartbeats folded into our own
+    uint32_t ping_timeouts;         // Pings with no pong within MESH_PING_TIMEOUT_MS
+    uint32_t rtt_up_samples;        // Sliding RTT window toward the root (us)
+    uint32_t rtt_up_min_us;
+    uint32_t rtt_up_p50_us;
+    uint32_t rtt_up_p95_us;
+    uint32_t rtt_down_samples;      // Sliding RTT window from the root to its children (us)
+    uint32_t rtt_down_min_us;
+    uint32_t rtt_down_p50_us;
+    uint32_t rtt_down_p95_us;
 } network_transport_stats_t;
 
+// Counters are sharded per writer task; snapshots are consistent per shard.
 esp_err_t network_get_transport_stats(network_transport_stats_t *out_stats);
 esp_err_t network_get_transport_stats_and_reset(network_transport_stats_t *out_stats);
 
+// Word index of a transport stats field, e.g. NETWORK_TRANSPORT_STAT(rx_audio_packets).
+#define NETWORK_TRANSPORT_STAT(field) NETWORK_STAT_WORD(network_transport_stats_t, field)
+#define NETWORK_TRANSPORT_STAT_WORDS  NETWORK_STAT_WORDS(network_transport_stats_t)
+_Static_assert(sizeof(network_transport_stats_t) % sizeof(uint32_t) == 0 &&
+               NETWORK_TRANSPORT_STAT_WORDS <= STAT_COUNTER_MAX_WORDS,
+               "network_transport_stats_t must be uint32_t words within STAT_COUNTER_MAX_WORDS");
+// Per-second rate of a transport counter over ~1 s / 10 s / 60 s (sampled every
+// STAT_RATE_TICK_MS). ESP_ERR_INVALID_STATE until two samples have been taken.
+esp_err_t network_get_transport_rate(size_t stat, network_stat_rate_t *out_rate);
+
 // Callbacks
 typedef void (*network_audio_callback_t)(const uint8_t *payload, size_t len, uint16_t seq, uint32_t timestamp, const char *src_id);
 typedef void (*network_heartbeat_callback_t)(const uint8_t *sender_mac, const mesh_heartbeat_t *hb);
@@ -204,6 +268,8 @@ esp_err_t network_get_uplink_status(network_uplink_status_t *out);
 esp_err_t network_set_uplink_config(const uplink_ctrl_message_t *cfg);
 esp_err_t network_get_mixer_state(network_mixer_status_t *out);
 esp_err_t network_set_mixer_state(const network_mixer_status_t *next);
+// Portal entry point: applies a decoded mixer message through network_set_mixer_state.
+esp_err_t mixer_ctrl_apply(const mixer_ctrl_message_t *msg);
 
 // Mesh topology queries
 bool network_is_root(void);
@@ -225,6 +291,14 @@ void network_set_jitter_override(int frames);
 int  network_get_jitter_override(void);
 uint32_t network_get_tx_bytes_and_reset(void);
 
+// Raw RX capture (network/rx_capture.h). Start allocates the ring on first use
+// (PSRAM when present) and clears it; dump freezes it and prints it to the
+// console as RXCAP lines from a low-priority task.
+esp_err_t network_rx_capture_start(void);
+void network_rx_capture_stop(void);
+bool network_rx_capture_active(void);
+esp_err_t network_rx_capture_dump_serial(void);
+
 int network_get_nearest_child_rssi(void);
 uint32_t network_get_nearest_child_latency_ms(void);
 esp_err_t network_ping_nearest_child(void);
@@ -54,5 +54,56 @@ typedef struct {
     mixer_ctrl_stream_t streams[MIXER_MAX_STREAMS];
 } mixer_ctrl_message_t;
 
+// Versioned delta replication (root -> nodes). Each change bumps a 16-bit state
+// version; a delta carries only the streams/fields that changed since base_version.
+// A node whose version is not base_version asks the root for a full state.
+// Version 0 means "never synced" and is never used for a published state.
+#define MIXER_DELTA_FLAG_FULL      0x01  // Carries every stream; applies regardless of base_version
+#define MIXER_DELTA_FLAG_OUT_GAIN  0x02  // out_gain_pct changed (always set on FULL)
+
+#define MIXER_DELTA_FIELD_GAIN     0x01
+#define MIXER_DELTA_FIELD_FLAGS    0x02
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;            // NET_PKT_TYPE_MIXER_DELTA
+    uint8_t version;         // MIXER_CTRL_VERSION
+    uint8_t flags;           // MIXER_DELTA_FLAG_*
+    uint8_t entry_count;
+    uint16_t base_version;   // State version the delta applies on top of
+    uint16_t state_version;  // State version after applying
+    uint16_t out_gain_pct;   // Valid with MIXER_DELTA_FLAG_OUT_GAIN
+} mixer_delta_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t stream_id;
+    uint8_t fields;          // MIXER_DELTA_FIELD_*
+    uint8_t flags;           // MIXER_CTRL_STREAM_FLAG_*, valid with MIXER_DELTA_FIELD_FLAGS
+    uint16_t gain_pct;       // Valid with MIXER_DELTA_FIELD_GAIN
+} mixer_delta_entry_t;
+
+typedef struct __attribute__((packed)) {
+    mixer_delta_header_t hdr;
+    mixer_delta_entry_t entries[MIXER_MAX_STREAMS];
+} mixer_delta_packet_t;
+
+typedef enum {
+    MIXER_DELTA_APPLIED = 0,
+    MIXER_DELTA_STALE,       // Duplicate: already at state_version
+    MIXER_DELTA_GAP,         // Missed an update: request a full sync
+    MIXER_DELTA_INVALID,
+} mixer_delta_result_t;
+
 bool mixer_ctrl_encode(const mixer_ctrl_message_t *msg, mixer_ctrl_packet_t *packet);
 bool mixer_ctrl_decode(const mixer_ctrl_packet_t *packet, size_t packet_len, mixer_ctrl_message_t *msg);
+
+// Encodes next against prev (prev NULL, or a different stream set, yields a full
+// state). Returns the bytes to send, or 0 when nothing changed or input is invalid.
+size_t mixer_delta_encode(const mixer_ctrl_message_t *prev, const mixer_ctrl_message_t *next,
+                          uint16_t base_version, uint16_t state_version, mixer_delta_packet_t *packet);
+// Version beacon: an empty delta at state_version. A node already there sees it
+// as STALE; any other version gets GAP and asks the root for a full state.
+size_t mixer_delta_encode_beacon(uint16_t state_version, mixer_delta_packet_t *packet);
+// Applies a delta to state/version in place; state is untouched unless APPLIED.
+// A full state always applies; a delta applies only on top of its base_version.
+mixer_delta_result_t mixer_delta_apply(const uint8_t *data, size_t len,
+                                       uint16_t *version, mixer_ctrl_message_t *state);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed pool of reference-counted mesh packet buffers. A buffer is handed out with
+// one reference; every holder (RX dispatch, audio callback, retransmit cache, ...)
+// takes its own with retain and drops it with release. The last release frees it.
+typedef struct {
+    atomic_uint refs;
+    size_t len;
+    uint8_t data[MESH_PKT_BUF_SIZE];
+} network_pkt_buf_t;
+
+typedef struct {
+    uint32_t capacity;
+    uint32_t in_use;
+    uint32_t high_water;
+    uint32_t exhausted;     // Allocations that found no free buffer
+} network_pkt_pool_stats_t;
+
+network_pkt_buf_t *network_pkt_alloc(void);
+void network_pkt_retain(network_pkt_buf_t *buf);
+void network_pkt_release(network_pkt_buf_t *buf);
+
+void network_pkt_pool_get_stats(network_pkt_pool_stats_t *out_stats);
+// Clears the exhaustion counter and restarts the high-water mark from current use.
+void network_pkt_pool_reset_stats(void);
+// Test hook: forgets every outstanding reference.
+void network_pkt_pool_reset(void);
+
+// Packet currently being dispatched by the mesh RX task, or NULL when it was received
+// into the fallback buffer. Only valid inside RX callbacks; retain it to keep the
+// payload past the callback instead of copying it.
+network_pkt_buf_t *network_rx_current_packet(void);
+
+#ifdef __cplusplus
+}
+#endif
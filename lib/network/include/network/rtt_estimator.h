@@ -0,0 +1,72 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Round-trip time over the last MESH_RTT_WINDOW_SAMPLES pings; min, median
+// and P95 are exact over the window. Times are passed in.
+
+typedef struct {
+    uint32_t ring[MESH_RTT_WINDOW_SAMPLES];     // Arrival order, oldest at head once full
+    uint32_t sorted[MESH_RTT_WINDOW_SAMPLES];   // Same samples, ascending
+    uint16_t head;
+    uint16_t count;
+    uint32_t total_samples;
+} network_rtt_window_t;
+
+typedef struct {
+    uint32_t samples;       // Samples currently in the window
+    uint32_t min_us;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t max_us;
+} network_rtt_summary_t;
+
+void network_rtt_window_init(network_rtt_window_t *window);
+void network_rtt_window_add(network_rtt_window_t *window, uint32_t rtt_us);
+// Nearest-rank quantile, pct in [0, 100]. Returns 0 for an empty window.
+uint32_t network_rtt_window_quantile(const network_rtt_window_t *window, uint8_t pct);
+bool network_rtt_window_summary(const network_rtt_window_t *window, network_rtt_summary_t *out);
+
+// Outstanding pings matched by ID, so several can be in flight per target.
+typedef enum {
+    NETWORK_PING_UPSTREAM = 0,  // Toward the root
+    NETWORK_PING_DOWNSTREAM,    // Root toward a child
+} network_ping_direction_t;
+
+typedef struct {
+    bool in_use;
+    uint8_t direction;          // network_ping_direction_t
+    uint8_t mac[6];
+    uint32_t id;
+    int64_t sent_us;
+} network_ping_slot_t;
+
+typedef struct {
+    network_ping_slot_t slots[MESH_PING_MAX_INFLIGHT];
+    uint32_t next_id;
+} network_ping_tracker_t;
+
+void network_ping_tracker_init(network_ping_tracker_t *tracker);
+// Returns the new ping ID, or 0 when every slot is in flight.
+uint32_t network_ping_tracker_start(network_ping_tracker_t *tracker, network_ping_direction_t direction,
+                                    const uint8_t mac[6], int64_t now_us);
+// Drops a slot whose send failed.
+void network_ping_tracker_cancel(network_ping_tracker_t *tracker, uint32_t id);
+// Matches a pong; on success fills the RTT and the slot it answered.
+bool network_ping_tracker_complete(network_ping_tracker_t *tracker, uint32_t id, int64_t now_us,
+                                   uint32_t *rtt_us_out, network_ping_slot_t *slot_out);
+// Frees pings older than timeout_us and returns how many timed out.
+size_t network_ping_tracker_expire(network_ping_tracker_t *tracker, int64_t now_us, int64_t timeout_us);
+size_t network_ping_tracker_inflight(const network_ping_tracker_t *tracker, network_ping_direction_t direction);
+
+#ifdef __cplusplus
+}
+#endif
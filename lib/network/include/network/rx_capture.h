@@ -0,0 +1,92 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Raw RX packet capture: a byte ring of compact records (arrival time, sender,
+// esp_mesh_recv flag, packet bytes) over caller-owned memory. When full, the
+// oldest whole records are overwritten, so the ring always holds the most
+// recent traffic leading up to a fault. The dump is a self-contained binary
+// file that the native replay (test/native/test_rx_replay) feeds back through
+// the RX pipeline with the original timing.
+//
+// Dump layout, little endian:
+//   file header: magic "RXCP", u16 version, u16 header size, i64 first arrival
+//                us, u32 record count, u32 records overwritten, u16 snaplen
+//   per record:  u32 us since the previous record, from[6], u8 flag,
+//                u16 original length, u16 captured length, bytes
+
+#define NET_RX_CAPTURE_MAGIC        0x50435852u  // "RXCP"
+#define NET_RX_CAPTURE_VERSION      1
+#define NET_RX_CAPTURE_FILE_HEADER  26
+#define NET_RX_CAPTURE_REC_HEADER   15
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t head;                // Next write offset
+    size_t tail;                // Oldest record
+    size_t used;
+    uint16_t snaplen;           // Bytes kept per packet; longer packets are truncated
+    uint32_t records;
+    uint32_t overwritten;
+    int64_t first_us;           // Arrival of the oldest record still held
+    int64_t last_us;
+} network_rx_capture_t;
+
+typedef struct {
+    int64_t arrival_us;
+    uint8_t from[6];
+    uint8_t flag;
+    uint16_t orig_len;
+    uint16_t len;
+    const uint8_t *data;
+} network_rx_capture_record_t;
+
+typedef bool (*network_rx_capture_write_fn)(void *ctx, const uint8_t *data, size_t len);
+
+// buf must outlive the capture. A snaplen of 0 keeps whole packets.
+void network_rx_capture_init(network_rx_capture_t *cap, uint8_t *buf, size_t size, uint16_t snaplen);
+void network_rx_capture_clear(network_rx_capture_t *cap);
+
+// Appends one packet, evicting the oldest records as needed. Returns false only
+// when the record cannot fit even in an empty ring.
+bool network_rx_capture_record(network_rx_capture_t *cap, int64_t arrival_us, const uint8_t from[6],
+                               uint8_t flag, const uint8_t *data, size_t len);
+
+// Bytes network_rx_capture_dump() will write.
+size_t network_rx_capture_dump_size(const network_rx_capture_t *cap);
+// Writes the file header and every record, oldest first, in chunks. Stops and
+// returns false when write does.
+bool network_rx_capture_dump(const network_rx_capture_t *cap, network_rx_capture_write_fn write, void *ctx);
+
+// Reads a dump back. Records point into the dump buffer.
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    uint32_t remaining;
+    int64_t arrival_us;
+    uint32_t records;
+    uint32_t overwritten;
+    uint16_t snaplen;
+} network_rx_capture_reader_t;
+
+// False when the header is missing, unknown or truncated.
+bool network_rx_capture_reader_init(network_rx_capture_reader_t *reader, const uint8_t *data, size_t len);
+// False at the end, or when a record is truncated.
+bool network_rx_capture_next(network_rx_capture_reader_t *reader, network_rx_capture_record_t *rec);
+
+// Running CRC-32 (IEEE, zlib-compatible); start with 0.
+uint32_t network_rx_capture_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
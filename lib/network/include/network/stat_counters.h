@@ -0,0 +1,94 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sharded statistics counters over a struct of uint32_t words. Each writer
+// task gets a private seqlock-guarded shard on first use; writers past the
+// first STAT_COUNTER_SHARDS - 1 share the last shard through atomic adds.
+// Snapshots sum the shards and never tear. Gauge words merge as the max over
+// shards updated since the last reset.
+
+typedef struct {
+    atomic_uint seq;            // Odd while the owner is mid-update
+    atomic_uintptr_t owner;     // Claiming writer, 0 while free
+    atomic_uint epoch;          // Reset epoch the shard's gauges belong to
+} network_stat_shard_t;
+
+typedef struct {
+    _Atomic uint32_t *words;    // STAT_COUNTER_SHARDS x word_count
+    uint32_t *baseline;         // Raw totals at the last reset
+    size_t word_count;
+    const uint16_t *gauges;     // Word indexes merged by max, not summed
+    size_t gauge_count;
+    atomic_uint epoch;
+    network_stat_shard_t shards[STAT_COUNTER_SHARDS];
+} network_stat_counters_t;
+
+#define NETWORK_STAT_WORDS(type) (sizeof(type) / sizeof(uint32_t))
+#define NETWORK_STAT_WORD(type, field) (offsetof(type, field) / sizeof(uint32_t))
+
+// Static storage for a counter set: words[STAT_COUNTER_SHARDS * word_count],
+// baseline[word_count].
+#define NETWORK_STAT_COUNTERS_INITIALIZER(words_, baseline_, word_count_, gauges_, gauge_count_) \
+    { .words = (words_), .baseline = (baseline_), .word_count = (word_count_),                \
+      .gauges = (gauges_), .gauge_count = (gauge_count_) }
+
+void network_stat_counters_init(network_stat_counters_t *counters, _Atomic uint32_t *words,
+                                uint32_t *baseline, size_t word_count,
+                                const uint16_t *gauges, size_t gauge_count);
+
+// Shard for this writer (claimed on first use). Never NULL for valid counters.
+network_stat_shard_t *network_stat_shard(network_stat_counters_t *counters, const void *owner);
+
+void network_stat_add(network_stat_counters_t *counters, network_stat_shard_t *shard,
+                      size_t word, uint32_t n);
+void network_stat_set(network_stat_counters_t *counters, network_stat_shard_t *shard,
+                      size_t word, uint32_t value);
+void network_stat_max(network_stat_counters_t *counters, network_stat_shard_t *shard,
+                      size_t word, uint32_t value);
+
+// Consistent totals since boot (counters) / current gauges, into out[word_count].
+void network_stat_totals(network_stat_counters_t *counters, uint32_t *out);
+// As totals, with counters relative to the last reset.
+void network_stat_snapshot(network_stat_counters_t *counters, uint32_t *out);
+// Snapshot, then start a new baseline (counters and gauges read 0 afterwards).
+void network_stat_snapshot_and_reset(network_stat_counters_t *counters, uint32_t *out);
+// Single word since the last reset, without cross-word consistency.
+uint32_t network_stat_read(network_stat_counters_t *counters, size_t word);
+
+// Per-second rates over ~1 s (last tick), 10 s and 60 s. The longer windows are
+// exponentially weighted (like a load average), so each costs one float per word.
+typedef struct {
+    float per_sec_1s;
+    float per_sec_10s;
+    float per_sec_60s;
+} network_stat_rate_t;
+
+typedef struct {
+    uint32_t *last;             // Totals at the previous tick, word_count entries
+    network_stat_rate_t *rates; // word_count entries
+    size_t word_count;
+    int64_t last_us;
+    bool primed;                // Has a previous sample
+    bool valid;                 // Has computed rates (two samples taken)
+} network_stat_rates_t;
+
+#define NETWORK_STAT_RATES_INITIALIZER(last_, rates_, word_count_) \
+    { .last = (last_), .rates = (rates_), .word_count = (word_count_) }
+
+// Feed totals from network_stat_totals (not snapshots, so resets do not skew rates).
+void network_stat_rates_update(network_stat_rates_t *rates, const uint32_t *totals, int64_t now_us);
+bool network_stat_rates_get(const network_stat_rates_t *rates, size_t word, network_stat_rate_t *out);
+
+#ifdef __cplusplus
+}
+#endif
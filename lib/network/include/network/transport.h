@@ -0,0 +1,58 @@
+#pragma once
+
+#include <esp_err.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transport backend: the datagram layer under the audio and control paths. The
+// firmware registers the ESP-WIFI-MESH backend at init; native tests register the
+// POSIX UDP backend (test/native/shared/transport_udp.h) so SRC and OUT logic
+// can run as processes over loopback. Backends are star-shaped from the caller's
+// view: the root reaches every descendant, everyone else reaches the root.
+
+#define NETWORK_TRANSPORT_WAIT_FOREVER UINT32_MAX
+
+typedef struct {
+    uint8_t addr[6];            // Node STA MAC (mesh) or synthetic id (host)
+} network_node_addr_t;
+
+typedef struct {
+    const char *name;
+    // Audio to one node, or along the default route when to is NULL (root fans
+    // out to all descendants, others uplink to the root). Non-blocking.
+    esp_err_t (*send_audio)(void *ctx, const network_node_addr_t *to, const uint8_t *data, size_t len);
+    // Control to one node, or along the default route when to is NULL.
+    esp_err_t (*send_control)(void *ctx, const network_node_addr_t *to, const uint8_t *data, size_t len);
+    // Next datagram into buf; *len is the capacity in and the payload size out.
+    // ESP_ERR_TIMEOUT when nothing arrives within timeout_ms.
+    esp_err_t (*recv)(void *ctx, network_node_addr_t *from, uint8_t *buf, size_t *len, uint32_t timeout_ms);
+    // Routing-table view: this node plus its reachable descendants. Returns the
+    // number of entries written (at most max_nodes).
+    int (*topology)(void *ctx, network_node_addr_t *nodes, int max_nodes, bool *is_root);
+} network_transport_ops_t;
+
+typedef struct {
+    const network_transport_ops_t *ops;
+    void *ctx;
+} network_transport_t;
+
+// Selects the backend for the calls below. Not synchronised: set it before the
+// RX task and any sender start.
+void network_transport_set(const network_transport_t *transport);
+const network_transport_t *network_transport_get(void);
+
+// Dispatch to the active backend; ESP_ERR_INVALID_STATE (or 0 nodes) without one.
+esp_err_t network_transport_send_audio(const network_node_addr_t *to, const uint8_t *data, size_t len);
+esp_err_t network_transport_send_control(const network_node_addr_t *to, const uint8_t *data, size_t len);
+esp_err_t network_transport_recv(network_node_addr_t *from, uint8_t *buf, size_t *len, uint32_t timeout_ms);
+int network_transport_topology(network_node_addr_t *nodes, int max_nodes, bool *is_root);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,41 +2,126 @@
 
 #include "config/build.h"
 #include "network/mesh_net.h"
+#include "network/packet_pool.h"
+#include "mesh/mesh_heartbeat.h"
+#include "mesh/mesh_retransmit.h"
 
 #include <arpa/inet.h>
+#include <esp_timer.h>
+#include <stdatomic.h>
 #include <string.h>
 
-esp_err_t network_send_audio_batch(const uint8_t *opus_batch_payload,
-                                   size_t payload_len,
-                                   uint16_t seq,
-                                   uint32_t timestamp_ms,
-                                   uint8_t frame_count,
-                                   uint8_t stream_id)
+// Latest TX position, advertised in the stream announce as the v2 extension anchor.
+// Packed into one word so the heartbeat task never reads a torn seq/timestamp:
+// bit 56 valid, 48..55 stream_id, 32..47 seq, 0..31 timestamp.
+#define TX_ANCHOR_VALID ((uint64_t)1 << 56)
+static _Atomic uint64_t s_tx_anchor;
+// Packets of the current stream start still to be announced (encode task only)
+static uint8_t s_tx_announce_left;
+
+static uint64_t tx_anchor_pack(uint8_t stream_id, uint16_t seq, uint32_t timestamp_ms)
 {
-    if (!opus_batch_payload || payload_len == 0 || payload_len > MESH_OPUS_BATCH_MAX_BYTES || frame_count == 0 ||
-        frame_count > MESH_FRAMES_PER_PACKET) {
-        return ESP_ERR_INVALID_ARG;
+    return TX_ANCHOR_VALID | ((uint64_t)stream_id << 48) | ((uint64_t)seq << 32) | timestamp_ms;
+}
+
+// A new stream, or a jump the v2 8-bit seq delta cannot carry.
+static bool tx_anchor_needs_announce(uint64_t prev, uint8_t stream_id, uint16_t seq)
+{
+    if (!(prev & TX_ANCHOR_VALID) || (uint8_t)(prev >> 48) != stream_id) {
+        return true;
     }
+    int16_t delta = (int16_t)(seq - (uint16_t)(prev >> 32));
+    return delta < 0 || delta > INT8_MAX;
+}
+
+#if NET_FRAME_TX_VERSION == NET_FRAME_VERSION_V2
+#define AUDIO_TX_HEADER_SIZE NET_FRAME_HEADER_SIZE_V2
+#else
+#define AUDIO_TX_HEADER_SIZE NET_FRAME_HEADER_SIZE
+#endif
+
+// Outgoing packet: a pool buffer the encoder writes frames into behind the reserved
+// header; the same buffer goes to esp_mesh_send and, on root, the retransmit cache.
+static network_pkt_buf_t *s_tx_buf;
+static network_frame_builder_t s_tx_builder;
 
-    size_t cursor = 0;
-    uint8_t parsed_frames = 0;
-    while (cursor < payload_len) {
-        if (cursor + 2 > payload_len) {
-            return ESP_ERR_INVALID_ARG;
+static network_frame_builder_t *audio_tx_builder(void)
+{
+    if (!s_tx_buf) {
+        s_tx_buf = network_pkt_alloc();
+        if (!s_tx_buf) {
+            return NULL;
         }
-        uint16_t frame_len = ((uint16_t)opus_batch_payload[cursor] << 8) | opus_batch_payload[cursor + 1];
-        cursor += 2;
-        if (frame_len == 0 || frame_len > OPUS_MAX_FRAME_BYTES || (cursor + frame_len) > payload_len) {
-            return ESP_ERR_INVALID_ARG;
+        network_frame_builder_init(&s_tx_builder, s_tx_buf->data,
+                                   AUDIO_TX_HEADER_SIZE + MESH_OPUS_BATCH_MAX_BYTES,
+                                   AUDIO_TX_HEADER_SIZE);
+    }
+    return &s_tx_builder;
+}
+
+uint8_t *network_audio_tx_frame_slot(size_t *capacity_out)
+{
+    network_frame_builder_t *builder = audio_tx_builder();
+    if (!builder || builder->frame_count >= MESH_FRAMES_PER_PACKET) {
+        if (capacity_out) {
+            *capacity_out = 0;
         }
-        cursor += frame_len;
-        parsed_frames++;
+        return NULL;
+    }
+    return network_frame_builder_frame_slot(builder, OPUS_MAX_FRAME_BYTES, capacity_out);
+}
+
+esp_err_t network_audio_tx_commit_frame(size_t frame_len)
+{
+    network_frame_builder_t *builder = audio_tx_builder();
+    if (!builder) {
+        return ESP_ERR_NO_MEM;
     }
-    if (cursor != payload_len || parsed_frames != frame_count) {
+    if (frame_len > OPUS_MAX_FRAME_BYTES || builder->frame_count >= MESH_FRAMES_PER_PACKET ||
+        !network_frame_builder_commit_frame(builder, frame_len)) {
         return ESP_ERR_INVALID_ARG;
     }
+    return ESP_OK;
+}
 
-    uint8_t packet[MAX_PACKET_SIZE] = {0};
+uint8_t network_audio_tx_frame_count(void)
+{
+    return s_tx_buf ? s_tx_builder.frame_count : 0;
+}
+
+void network_audio_tx_reset(void)
+{
+    if (s_tx_buf) {
+        network_frame_builder_reset(&s_tx_builder);
+    }
+}
+
+esp_err_t network_audio_tx_send(uint16_t seq, uint32_t timestamp_ms, uint8_t stream_id)
+{
+    if (!s_tx_buf || s_tx_builder.frame_count == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    network_frame_builder_t *builder = &s_tx_builder;
+    uint8_t *packet = s_tx_buf->data;
+    uint8_t frame_count = builder->frame_count;
+    size_t payload_len = network_frame_builder_payload_len(builder);
+
+#if NET_FRAME_TX_VERSION == NET_FRAME_VERSION_V2
+    network_frame_info_t info = {
+        .version = NET_FRAME_VERSION_V2,
+        .type = NET_PKT_TYPE_AUDIO_OPUS,
+        .ttl = 6,
+        .stream_id = stream_id,
+        .frame_count = frame_count,
+        .seq = seq,
+        .timestamp = timestamp_ms,
+        .payload_len = (uint16_t)payload_len,
+    };
+    if (network_frame_encode_header_v2(&info, packet, AUDIO_TX_HEADER_SIZE) == 0) {
+        network_frame_builder_reset(builder);
+        return ESP_ERR_INVALID_ARG;
+    }
+#else
     net_frame_header_t *hdr = (net_frame_header_t *)packet;
 
     hdr->magic = NET_FRAME_MAGIC;
@@ -49,7 +134,40 @@ esp_err_t network_send_audio_batch(const uint8_t *opus_batch_payload,
     hdr->ttl = 6;
     hdr->frame_count = frame_count;
     memcpy(hdr->src_id, network_get_src_id(), NETWORK_SRC_ID_LEN);
+#endif
 
-    memcpy(packet + NET_FRAME_HEADER_SIZE, opus_batch_payload, payload_len);
-    return network_send_audio(packet, NET_FRAME_HEADER_SIZE + payload_len);
+    // Receivers drop v2 audio until they are anchored, so a stream start goes out
+    // announced ahead of its first few packets; one lost announce costs a packet,
+    // not an announce interval.
+    uint64_t prev = atomic_exchange(&s_tx_anchor, tx_anchor_pack(stream_id, seq, timestamp_ms));
+    if (tx_anchor_needs_announce(prev, stream_id, seq)) {
+        s_tx_announce_left = STREAM_ANNOUNCE_START_PACKETS;
+    }
+    if (s_tx_announce_left > 0) {
+        s_tx_announce_left--;
+        mesh_heartbeat_announce_stream(true);
+    }
+
+    s_tx_buf->len = builder->len;
+    esp_err_t err = network_send_audio(packet, s_tx_buf->len);
+
+    if (err == ESP_OK && network_is_root()) {
+        mesh_retx_cache_store(s_tx_buf, stream_id, seq, frame_count, esp_timer_get_time());
+    }
+    // The cache holds its own reference; the next packet is built in a fresh buffer.
+    network_pkt_release(s_tx_buf);
+    s_tx_buf = NULL;
+    return err;
+}
+
+bool network_get_audio_tx_anchor(uint8_t *stream_id, uint16_t *seq, uint32_t *timestamp_ms)
+{
+    uint64_t anchor = atomic_load(&s_tx_anchor);
+    if (!(anchor & TX_ANCHOR_VALID) || !stream_id || !seq || !timestamp_ms) {
+        return false;
+    }
+    *stream_id = (uint8_t)(anchor >> 48);
+    *seq = (uint16_t)(anchor >> 32);
+    *timestamp_ms = (uint32_t)anchor;
+    return true;
 }
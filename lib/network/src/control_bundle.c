@@ -0,0 +1,103 @@
+#include "network/control_bundle.h"
+
+#include <string.h>
+
+void network_ctrl_bundle_init(network_ctrl_bundle_t *bundle, uint8_t *buf, size_t capacity)
+{
+    if (!bundle) {
+        return;
+    }
+    bundle->buf = buf;
+    bundle->capacity = capacity;
+    network_ctrl_bundle_reset(bundle);
+}
+
+void network_ctrl_bundle_reset(network_ctrl_bundle_t *bundle)
+{
+    if (!bundle) {
+        return;
+    }
+    bundle->len = 0;
+    bundle->count = 0;
+    if (bundle->buf && bundle->capacity >= NET_CTRL_BUNDLE_HEADER_SIZE) {
+        bundle->buf[0] = NET_CTRL_BUNDLE_TYPE;
+        bundle->buf[1] = 0;
+        bundle->len = NET_CTRL_BUNDLE_HEADER_SIZE;
+    }
+}
+
+bool network_ctrl_bundle_fits(const network_ctrl_bundle_t *bundle, size_t msg_len)
+{
+    if (!bundle || !bundle->buf || msg_len == 0 || msg_len > UINT16_MAX) {
+        return false;
+    }
+    if (bundle->count >= NET_CTRL_BUNDLE_MAX_MESSAGES) {
+        return false;
+    }
+    return bundle->len + NET_CTRL_BUNDLE_ENTRY_OVERHEAD + msg_len <= bundle->capacity;
+}
+
+bool network_ctrl_bundle_append(network_ctrl_bundle_t *bundle, const uint8_t *msg, size_t msg_len)
+{
+    if (!msg || !network_ctrl_bundle_fits(bundle, msg_len)) {
+        return false;
+    }
+    uint8_t *out = bundle->buf + bundle->len;
+    out[0] = (uint8_t)(msg_len >> 8);
+    out[1] = (uint8_t)(msg_len & 0xFF);
+    memcpy(out + NET_CTRL_BUNDLE_ENTRY_OVERHEAD, msg, msg_len);
+    bundle->len += NET_CTRL_BUNDLE_ENTRY_OVERHEAD + msg_len;
+    bundle->count++;
+    bundle->buf[1] = bundle->count;
+    return true;
+}
+
+bool network_ctrl_bundle_single(const network_ctrl_bundle_t *bundle, const uint8_t **msg, size_t *msg_len)
+{
+    if (!bundle || bundle->count != 1 || !msg || !msg_len) {
+        return false;
+    }
+    const uint8_t *entry = bundle->buf + NET_CTRL_BUNDLE_HEADER_SIZE;
+    *msg_len = ((size_t)entry[0] << 8) | entry[1];
+    *msg = entry + NET_CTRL_BUNDLE_ENTRY_OVERHEAD;
+    return true;
+}
+
+bool network_ctrl_bundle_reader_init(network_ctrl_bundle_reader_t *reader, const uint8_t *data, size_t len)
+{
+    if (!reader) {
+        return false;
+    }
+    memset(reader, 0, sizeof(*reader));
+    if (!data || len < NET_CTRL_BUNDLE_HEADER_SIZE || data[0] != NET_CTRL_BUNDLE_TYPE) {
+        return false;
+    }
+    reader->data = data;
+    reader->len = len;
+    reader->offset = NET_CTRL_BUNDLE_HEADER_SIZE;
+    reader->remaining = data[1];
+    return true;
+}
+
+bool network_ctrl_bundle_next(network_ctrl_bundle_reader_t *reader, const uint8_t **msg, size_t *msg_len)
+{
+    if (!reader || !reader->data || reader->remaining == 0 || !msg || !msg_len) {
+        return false;
+    }
+    if (reader->len - reader->offset < NET_CTRL_BUNDLE_ENTRY_OVERHEAD) {
+        reader->remaining = 0;
+        return false;
+    }
+    const uint8_t *entry = reader->data + reader->offset;
+    size_t entry_len = ((size_t)entry[0] << 8) | entry[1];
+    size_t available = reader->len - reader->offset - NET_CTRL_BUNDLE_ENTRY_OVERHEAD;
+    if (entry_len == 0 || entry_len > available) {
+        reader->remaining = 0;
+        return false;
+    }
+    *msg = entry + NET_CTRL_BUNDLE_ENTRY_OVERHEAD;
+    *msg_len = entry_len;
+    reader->offset += NET_CTRL_BUNDLE_ENTRY_OVERHEAD + entry_len;
+    reader->remaining--;
+    return true;
+}
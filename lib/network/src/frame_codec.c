@@ -40,6 +40,223 @@ uint8_t network_frame_extract_frame_count(const uint8_t *packet,
     return packet[legacy_frame_count_offset];
 }
 
+uint16_t network_frame_extend_seq(uint16_t ref_seq, uint8_t seq_delta)
+{
+    int8_t delta = (int8_t)(uint8_t)(seq_delta - (uint8_t)ref_seq);
+    return (uint16_t)(ref_seq + delta);
+}
+
+uint32_t network_frame_extend_timestamp(uint32_t ref_timestamp, uint32_t timestamp24)
+{
+    int32_t delta = (int32_t)((timestamp24 - ref_timestamp) & 0x00FFFFFFu);
+    if (delta & 0x00800000) {
+        delta -= 0x01000000;
+    }
+    return ref_timestamp + (uint32_t)delta;
+}
+
+size_t network_frame_encode_header_v2(const network_frame_info_t *info, uint8_t *out, size_t out_size)
+{
+    if (!info || !out || out_size < NET_FRAME_HEADER_SIZE_V2) {
+        return 0;
+    }
+    if (info->ttl > NET_FRAME_V2_TTL_MAX || info->frame_count > NET_FRAME_V2_FRAMES_MAX) {
+        return 0;
+    }
+
+    out[0] = NET_FRAME_MAGIC;
+    out[1] = NET_FRAME_VERSION_V2;
+    out[2] = info->type;
+    out[3] = (uint8_t)((info->ttl << 4) | info->frame_count);
+    out[4] = info->stream_id;
+    out[5] = (uint8_t)(info->seq & 0xFF);
+    out[6] = (uint8_t)((info->timestamp >> 16) & 0xFF);
+    out[7] = (uint8_t)((info->timestamp >> 8) & 0xFF);
+    out[8] = (uint8_t)(info->timestamp & 0xFF);
+    out[9] = (uint8_t)((info->payload_len >> 8) & 0xFF);
+    out[10] = (uint8_t)(info->payload_len & 0xFF);
+    return NET_FRAME_HEADER_SIZE_V2;
+}
+
+static bool decode_header_v2(const uint8_t *packet,
+                             size_t packet_size,
+                             network_frame_ref_t *ref,
+                             network_frame_info_t *out)
+{
+    if (packet_size < NET_FRAME_HEADER_SIZE_V2) {
+        return false;
+    }
+
+    uint16_t payload_len = (uint16_t)(((uint16_t)packet[9] << 8) | packet[10]);
+    size_t header_size = 0;
+    if (!network_frame_resolve_header_size(packet_size,
+                                           payload_len,
+                                           NET_FRAME_HEADER_SIZE_V2,
+                                           NET_FRAME_HEADER_SIZE_V2,
+                                           &header_size)) {
+        return false;
+    }
+
+    uint8_t seq_delta = packet[5];
+    uint32_t timestamp24 = ((uint32_t)packet[6] << 16) | ((uint32_t)packet[7] << 8) | packet[8];
+
+    out->version = NET_FRAME_VERSION_V2;
+    out->type = packet[2];
+    out->ttl = (uint8_t)(packet[3] >> 4);
+    out->frame_count = (uint8_t)(packet[3] & 0x0F);
+    out->stream_id = packet[4];
+    out->payload_len = payload_len;
+    out->header_size = header_size;
+
+    if (ref && ref->valid) {
+        out->seq = network_frame_extend_seq(ref->seq, seq_delta);
+        out->timestamp = network_frame_extend_timestamp(ref->timestamp, timestamp24);
+    } else {
+        // Unanchored: only the low bits are known and ref stays invalid.
+        out->seq = seq_delta;
+        out->timestamp = timestamp24;
+    }
+    return true;
+}
+
+static bool decode_header_v1(const uint8_t *packet, size_t packet_size, network_frame_info_t *out)
+{
+    if (packet_size < NET_FRAME_HEADER_SIZE_V1) {
+        return false;
+    }
+
+    uint16_t payload_len = (uint16_t)(((uint16_t)packet[10] << 8) | packet[11]);
+    size_t header_size = 0;
+    if (!network_frame_resolve_header_size(packet_size,
+                                           payload_len,
+                                           NET_FRAME_HEADER_SIZE,
+                                           NET_FRAME_HEADER_SIZE_V1,
+                                           &header_size)) {
+        return false;
+    }
+
+    out->version = NET_FRAME_VERSION;
+    out->type = packet[2];
+    out->ttl = packet[3];
+    out->seq = (uint16_t)(((uint16_t)packet[4] << 8) | packet[5]);
+    out->timestamp = ((uint32_t)packet[6] << 24) | ((uint32_t)packet[7] << 16) |
+                     ((uint32_t)packet[8] << 8) | packet[9];
+    out->payload_len = payload_len;
+    out->stream_id = packet[12];
+    out->frame_count = network_frame_extract_frame_count(packet,
+                                                         packet_size,
+                                                         NET_FRAME_HEADER_SIZE,
+                                                         header_size,
+                                                         packet[NET_FRAME_LEGACY_FRAME_COUNT_OFFSET],
+                                                         NET_FRAME_LEGACY_FRAME_COUNT_OFFSET);
+    out->header_size = header_size;
+    return true;
+}
+
+bool network_frame_decode_header(const uint8_t *packet,
+                                 size_t packet_size,
+                                 network_frame_ref_t *ref,
+                                 network_frame_info_t *out)
+{
+    if (!packet || !out || packet_size < 2 || packet[0] != NET_FRAME_MAGIC) {
+        return false;
+    }
+
+    bool ok = false;
+    if (packet[1] == NET_FRAME_VERSION_V2) {
+        ok = decode_header_v2(packet, packet_size, ref, out);
+    } else if (packet[1] == NET_FRAME_VERSION) {
+        ok = decode_header_v1(packet, packet_size, out);
+    }
+
+    // v1 carries the full seq/timestamp and anchors on its own; v2 only advances
+    // an anchor it already had.
+    if (ok && ref && (ref->valid || out->version == NET_FRAME_VERSION)) {
+        ref->valid = true;
+        ref->seq = out->seq;
+        ref->timestamp = out->timestamp;
+    }
+    return ok;
+}
+
+void network_frame_decrement_ttl(uint8_t *packet, size_t packet_size)
+{
+    if (!packet || packet_size < NET_FRAME_HEADER_SIZE_V2) {
+        return;
+    }
+    if (packet[1] == NET_FRAME_VERSION_V2) {
+        uint8_t ttl = (uint8_t)(packet[3] >> 4);
+        if (ttl > 0) {
+            packet[3] = (uint8_t)(((ttl - 1) << 4) | (packet[3] & 0x0F));
+        }
+    } else if (packet[3] > 0) {
+        packet[3]--;
+    }
+}
+
+bool network_frame_builder_init(network_frame_builder_t *builder,
+                                uint8_t *buf,
+                                size_t capacity,
+                                size_t header_size)
+{
+    if (!builder || !buf || header_size >= capacity) {
+        return false;
+    }
+    builder->buf = buf;
+    builder->capacity = capacity;
+    builder->header_size = header_size;
+    network_frame_builder_reset(builder);
+    return true;
+}
+
+void network_frame_builder_reset(network_frame_builder_t *builder)
+{
+    if (!builder) {
+        return;
+    }
+    builder->len = builder->header_size;
+    builder->frame_count = 0;
+}
+
+uint8_t *network_frame_builder_frame_slot(network_frame_builder_t *builder,
+                                          size_t max_frame_len,
+                                          size_t *capacity_out)
+{
+    if (!builder || !builder->buf || !capacity_out) {
+        return NULL;
+    }
+    if (builder->len + 2 >= builder->capacity) {
+        *capacity_out = 0;
+        return NULL;
+    }
+    size_t available = builder->capacity - builder->len - 2;
+    *capacity_out = available < max_frame_len ? available : max_frame_len;
+    return builder->buf + builder->len + 2;
+}
+
+bool network_frame_builder_commit_frame(network_frame_builder_t *builder, size_t frame_len)
+{
+    if (!builder || !builder->buf || frame_len == 0 || frame_len > 0xFFFF) {
+        return false;
+    }
+    if (builder->len + 2 + frame_len > builder->capacity) {
+        return false;
+    }
+    builder->buf[builder->len] = (uint8_t)((frame_len >> 8) & 0xFF);
+    builder->buf[builder->len + 1] = (uint8_t)(frame_len & 0xFF);
+    builder->len += 2 + frame_len;
+    builder->frame_count++;
+    return true;
+}
+
+size_t network_frame_builder_payload_len(const network_frame_builder_t *builder)
+{
+    if (!builder) {
+        return 0;
+    }
+    return builder->len - builder->header_size;
+}
+
 size_t network_frame_unpack_batch(const uint8_t *payload,
                                   size_t payload_len,
                                   uint8_t frame_count,
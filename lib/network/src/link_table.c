@@ -0,0 +1,263 @@
+#include "network/link_table.h"
+
+#include <string.h>
+
+#define LINK_TABLE_MASK (MESH_LINK_TABLE_CAPACITY - 1)
+
+static uint32_t link_hash(const uint8_t mac[6])
+{
+    // FNV-1a; the low MAC bytes carry most of the entropy within one vendor.
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 6; i++) {
+        h ^= mac[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Returns the slot holding mac, or NULL. *insert_at gets the first reusable slot
+// on the probe path (tombstone or empty) when the caller wants to insert.
+static network_link_entry_t *link_probe(network_link_table_t *table, const uint8_t mac[6],
+                                        network_link_entry_t **insert_at)
+{
+    network_link_entry_t *reusable = NULL;
+    uint32_t idx = link_hash(mac) & LINK_TABLE_MASK;
+
+    for (uint32_t probes = 0; probes < MESH_LINK_TABLE_CAPACITY; probes++) {
+        network_link_entry_t *slot = &table->slots[idx];
+        if (slot->state == NETWORK_LINK_SLOT_EMPTY) {
+            if (!reusable) {
+                reusable = slot;
+            }
+            break;
+        }
+        if (slot->state == NETWORK_LINK_SLOT_TOMBSTONE) {
+            if (!reusable) {
+                reusable = slot;
+            }
+        } else if (memcmp(slot->mac, mac, 6) == 0) {
+            return slot;
+        }
+        idx = (idx + 1) & LINK_TABLE_MASK;
+    }
+    if (insert_at) {
+        *insert_at = reusable;
+    }
+    return NULL;
+}
+
+static void link_rehash(network_link_table_t *table)
+{
+    static network_link_entry_t scratch[MESH_LINK_TABLE_CAPACITY];
+    memcpy(scratch, table->slots, sizeof(scratch));
+    memset(table->slots, 0, sizeof(table->slots));
+    table->tombstones = 0;
+
+    for (int i = 0; i < MESH_LINK_TABLE_CAPACITY; i++) {
+        if (scratch[i].state != NETWORK_LINK_SLOT_USED) {
+            continue;
+        }
+        network_link_entry_t *dst = NULL;
+        link_probe(table, scratch[i].mac, &dst);
+        if (dst) {
+            *dst = scratch[i];
+        }
+    }
+}
+
+void network_link_table_init(network_link_table_t *table)
+{
+    if (!table) {
+        return;
+    }
+    memset(table, 0, sizeof(*table));
+}
+
+network_link_entry_t *network_link_table_find(network_link_table_t *table, const uint8_t mac[6])
+{
+    if (!table || !mac) {
+        return NULL;
+    }
+    return link_probe(table, mac, NULL);
+}
+
+network_link_entry_t *network_link_table_upsert(network_link_table_t *table, const uint8_t mac[6], int64_t now_ms)
+{
+    if (!table || !mac) {
+        return NULL;
+    }
+    network_link_entry_t *insert_at = NULL;
+    network_link_entry_t *entry = link_probe(table, mac, &insert_at);
+    if (entry) {
+        return entry;
+    }
+    if (!insert_at || table->count >= MESH_ROUTE_TABLE_SIZE) {
+        return NULL;
+    }
+
+    if (insert_at->state == NETWORK_LINK_SLOT_TOMBSTONE) {
+        table->tombstones--;
+    }
+    memset(insert_at, 0, sizeof(*insert_at));
+    memcpy(insert_at->mac, mac, 6);
+    insert_at->state = NETWORK_LINK_SLOT_USED;
+    insert_at->first_seen_ms = now_ms;
+    insert_at->last_seen_ms = now_ms;
+    table->count++;
+    return insert_at;
+}
+
+bool network_link_table_remove(network_link_table_t *table, const uint8_t mac[6])
+{
+    network_link_entry_t *entry = network_link_table_find(table, mac);
+    if (!entry) {
+        return false;
+    }
+    entry->state = NETWORK_LINK_SLOT_TOMBSTONE;
+    table->count--;
+    table->tombstones++;
+    // Long probe chains of tombstones slow every lookup; compact once they pile up.
+    if (table->tombstones > MESH_LINK_TABLE_CAPACITY / 4) {
+        link_rehash(table);
+    }
+    return true;
+}
+
+size_t network_link_table_expire(network_link_table_t *table, int64_t now_ms, uint32_t max_age_ms)
+{
+    if (!table) {
+        return 0;
+    }
+    size_t removed = 0;
+    for (int i = 0; i < MESH_LINK_TABLE_CAPACITY; i++) {
+        network_link_entry_t *entry = &table->slots[i];
+        if (entry->state == NETWORK_LINK_SLOT_USED && (now_ms - entry->last_seen_ms) > (int64_t)max_age_ms) {
+            entry->state = NETWORK_LINK_SLOT_TOMBSTONE;
+            table->count--;
+            table->tombstones++;
+            removed++;
+        }
+    }
+    if (table->tombstones > MESH_LINK_TABLE_CAPACITY / 4) {
+        link_rehash(table);
+    }
+    return removed;
+}
+
+void network_link_table_record_heartbeat(network_link_table_t *table, const uint8_t mac[6],
+                                         int8_t rssi, int64_t now_ms)
+{
+    network_link_entry_t *entry = network_link_table_upsert(table, mac, now_ms);
+    if (!entry) {
+        return;
+    }
+    int16_t sample_q4 = (int16_t)(rssi * 16);
+    if (!entry->has_rssi) {
+        entry->rssi_ewma_q4 = sample_q4;
+        entry->has_rssi = 1;
+    } else {
+        entry->rssi_ewma_q4 += (int16_t)((sample_q4 - entry->rssi_ewma_q4) / 8);
+    }
+    entry->last_heartbeat_ms = now_ms;
+    entry->last_seen_ms = now_ms;
+}
+
+void network_link_table_record_rtt(network_link_table_t *table, const uint8_t mac[6],
+                                   uint32_t rtt_us, int64_t now_ms)
+{
+    network_link_entry_t *entry = network_link_table_upsert(table, mac, now_ms);
+    if (!entry) {
+        return;
+    }
+    if (entry->rtt_samples == 0) {
+        entry->rtt_min_us = rtt_us;
+        entry->rtt_avg_us = rtt_us;
+    } else {
+        if (rtt_us < entry->rtt_min_us) {
+            entry->rtt_min_us = rtt_us;
+        }
+        int64_t delta = (int64_t)rtt_us - (int64_t)entry->rtt_avg_us;
+        entry->rtt_avg_us = (uint32_t)((int64_t)entry->rtt_avg_us + delta / 8);
+    }
+    entry->rtt_samples++;
+    entry->last_seen_ms = now_ms;
+}
+
+void network_link_table_record_loss(network_link_table_t *table, const uint8_t mac[6],
+                                    uint32_t lost_frames, int64_t now_ms)
+{
+    network_link_entry_t *entry = network_link_table_upsert(table, mac, now_ms);
+    if (!entry) {
+        return;
+    }
+    entry->lost_frames += lost_frames;
+    entry->interval_lost += lost_frames;
+    entry->last_seen_ms = now_ms;
+}
+
+void network_link_table_close_loss_interval(network_link_table_t *table, const uint8_t mac[6],
+                                            uint32_t frames_sent_total, int64_t now_ms)
+{
+    network_link_entry_t *entry = network_link_table_upsert(table, mac, now_ms);
+    if (!entry) {
+        return;
+    }
+    uint32_t expected = frames_sent_total - entry->interval_base;
+    if (entry->interval_open && expected > 0) {
+        uint32_t lost = entry->interval_lost < expected ? entry->interval_lost : expected;
+        int32_t sample_q8 = (int32_t)(((uint64_t)lost * 100U * 256U) / expected);
+        int32_t current = entry->loss_pct_q8;
+        entry->loss_pct_q8 = (uint16_t)(current + (sample_q8 - current) / 4);
+    }
+    entry->interval_open = 1;
+    entry->interval_base = frames_sent_total;
+    entry->interval_lost = 0;
+}
+
+int8_t network_link_rssi_dbm(const network_link_entry_t *entry)
+{
+    if (!entry || !entry->has_rssi) {
+        return -100;
+    }
+    int16_t q4 = entry->rssi_ewma_q4;
+    return (int8_t)((q4 >= 0 ? q4 + 8 : q4 - 8) / 16);
+}
+
+uint8_t network_link_loss_pct(const network_link_entry_t *entry)
+{
+    if (!entry) {
+        return 0;
+    }
+    return (uint8_t)((entry->loss_pct_q8 + 128) / 256);
+}
+
+uint32_t network_link_heartbeat_age_ms(const network_link_entry_t *entry, int64_t now_ms)
+{
+    if (!entry || entry->last_heartbeat_ms == 0 || now_ms < entry->last_heartbeat_ms) {
+        return UINT32_MAX;
+    }
+    return (uint32_t)(now_ms - entry->last_heartbeat_ms);
+}
+
+void network_link_iter_begin(network_link_iter_t *it, const network_link_table_t *table)
+{
+    if (!it) {
+        return;
+    }
+    it->table = table;
+    it->index = 0;
+}
+
+const network_link_entry_t *network_link_iter_next(network_link_iter_t *it)
+{
+    if (!it || !it->table) {
+        return NULL;
+    }
+    while (it->index < MESH_LINK_TABLE_CAPACITY) {
+        const network_link_entry_t *entry = &it->table->slots[it->index++];
+        if (entry->state == NETWORK_LINK_SLOT_USED) {
+            return entry;
+        }
+    }
+    return NULL;
+}
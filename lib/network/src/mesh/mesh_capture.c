@@ -0,0 +1,151 @@
+#include "mesh/mesh_capture.h"
+#include "network/rx_capture.h"
+#include "config/build.h"
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "mesh_capture";
+
+#define CAPTURE_DUMP_LINE_BYTES 32
+
+typedef struct {
+    uint8_t line[CAPTURE_DUMP_LINE_BYTES];
+    size_t fill;
+    uint32_t lines;
+    uint32_t crc;
+} capture_dump_ctx_t;
+
+static network_rx_capture_t s_capture;
+static SemaphoreHandle_t s_capture_mutex = NULL;
+static volatile bool s_capture_on = false;
+static volatile bool s_dump_running = false;
+
+void mesh_capture_packet(const mesh_addr_t *from, int flag, const uint8_t *data, size_t len) {
+    if (!s_capture_on) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    if (xSemaphoreTake(s_capture_mutex, 0) != pdTRUE) {
+        return;
+    }
+    network_rx_capture_record(&s_capture, now_us, from->addr, (uint8_t)flag, data, len);
+    xSemaphoreGive(s_capture_mutex);
+}
+
+esp_err_t network_rx_capture_start(void) {
+    if (s_dump_running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!s_capture_mutex) {
+        s_capture_mutex = xSemaphoreCreateMutex();
+        if (!s_capture_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (!s_capture.buf) {
+        size_t size = RX_CAPTURE_RING_BYTES;
+        uint8_t *buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!buf) {
+            size = RX_CAPTURE_RING_BYTES_INTERNAL;
+            buf = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        }
+        if (!buf) {
+            ESP_LOGW(TAG, "RX capture: no memory for the ring");
+            return ESP_ERR_NO_MEM;
+        }
+        network_rx_capture_init(&s_capture, buf, size, RX_CAPTURE_SNAPLEN);
+        ESP_LOGI(TAG, "RX capture ring: %u bytes", (unsigned)size);
+    } else {
+        xSemaphoreTake(s_capture_mutex, portMAX_DELAY);
+        network_rx_capture_clear(&s_capture);
+        xSemaphoreGive(s_capture_mutex);
+    }
+    s_capture_on = true;
+    return ESP_OK;
+}
+
+void network_rx_capture_stop(void) {
+    s_capture_on = false;
+}
+
+bool network_rx_capture_active(void) {
+    return s_capture_on;
+}
+
+static void capture_dump_flush_line(capture_dump_ctx_t *ctx) {
+    if (ctx->fill == 0) {
+        return;
+    }
+    char hex[CAPTURE_DUMP_LINE_BYTES * 2 + 1];
+    for (size_t i = 0; i < ctx->fill; i++) {
+        snprintf(&hex[i * 2], 3, "%02x", ctx->line[i]);
+    }
+    printf("RXCAP %s\n", hex);
+    ctx->fill = 0;
+    // Let the console drain and lower-priority work run during long dumps.
+    if ((++ctx->lines % 64) == 0) {
+        vTaskDelay(1);
+    }
+}
+
+static bool capture_dump_write(void *arg, const uint8_t *data, size_t len) {
+    capture_dump_ctx_t *ctx = (capture_dump_ctx_t *)arg;
+    ctx->crc = network_rx_capture_crc32(ctx->crc, data, len);
+    while (len > 0) {
+        size_t n = CAPTURE_DUMP_LINE_BYTES - ctx->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(ctx->line + ctx->fill, data, n);
+        ctx->fill += n;
+        data += n;
+        len -= n;
+        if (ctx->fill == CAPTURE_DUMP_LINE_BYTES) {
+            capture_dump_flush_line(ctx);
+        }
+    }
+    return true;
+}
+
+// Framed hex on the console: tools/rx_capture_extract.py rebuilds the binary
+// dump from a serial log and checks length and CRC-32.
+static void capture_dump_task(void *arg) {
+    (void)arg;
+    capture_dump_ctx_t ctx = {0};
+
+    xSemaphoreTake(s_capture_mutex, portMAX_DELAY);
+    printf("RXCAP BEGIN %u records=%lu overwritten=%lu\n",
+           (unsigned)network_rx_capture_dump_size(&s_capture),
+           (unsigned long)s_capture.records,
+           (unsigned long)s_capture.overwritten);
+    network_rx_capture_dump(&s_capture, capture_dump_write, &ctx);
+    capture_dump_flush_line(&ctx);
+    printf("RXCAP END %08lx\n", (unsigned long)ctx.crc);
+    xSemaphoreGive(s_capture_mutex);
+
+    s_dump_running = false;
+    vTaskDelete(NULL);
+}
+
+esp_err_t network_rx_capture_dump_serial(void) {
+    if (!s_capture.buf || s_dump_running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Freeze the ring so the dump shows the traffic leading up to the trigger.
+    s_capture_on = false;
+    s_dump_running = true;
+    if (xTaskCreate(capture_dump_task, "rx_cap_dump", RX_CAPTURE_DUMP_TASK_STACK, NULL,
+                    RX_CAPTURE_DUMP_TASK_PRIO, NULL) != pdPASS) {
+        s_dump_running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGW(TAG, "RX capture: dumping %lu packets over serial",
+             (unsigned long)s_capture.records);
+    return ESP_OK;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <esp_mesh.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "network/mesh_net.h"
+
+// Records one received packet while capture is running. Called from the
+// transport recv path; never blocks (packets arriving during a dump are skipped).
+void mesh_capture_packet(const mesh_addr_t *from, int flag, const uint8_t *data, size_t len);
@@ -0,0 +1,262 @@
+#include "mesh/mesh_coalesce.h"
+#include "mesh/mesh_state.h"
+#include "mesh/mesh_tx.h"
+#include "mesh/mesh_transport.h"
+#include "network/control_bundle.h"
+#include "config/build.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/semphr.h>
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "network_mesh";
+
+typedef struct {
+    bool used;
+    int64_t held_ms;
+    mesh_heartbeat_t hb;
+} held_heartbeat_t;
+
+// coalesce_mutex guards the filling bundles and held heartbeats and is never
+// held across a send. A sender takes send_mutex, swaps a filling bundle with
+// its empty sealed twin under coalesce_mutex, and sends the sealed one after
+// releasing it. Lock order: send_mutex, then coalesce_mutex.
+static uint8_t bundle_bufs[MESH_CTRL_DEST_COUNT][2][CONTROL_BUNDLE_MAX_BYTES];
+static network_ctrl_bundle_t bundles[MESH_CTRL_DEST_COUNT];
+static network_ctrl_bundle_t sealed[MESH_CTRL_DEST_COUNT];     // Empty unless send_mutex is held
+static held_heartbeat_t held[CONTROL_DIGEST_MAX_NODES];
+static SemaphoreHandle_t coalesce_mutex = NULL;
+static SemaphoreHandle_t send_mutex = NULL;
+static esp_timer_handle_t flush_timer = NULL;
+static bool flush_armed = false;
+static _Atomic(TaskHandle_t) flush_task = NULL;
+
+static esp_err_t send_direct(mesh_ctrl_dest_t dest, const uint8_t *data, size_t len) {
+    if (dest == MESH_CTRL_DEST_PARENT) {
+        network_node_addr_t parent;
+        mesh_transport_to_node(&mesh_parent_addr, &parent);
+        return network_transport_send_control(&parent, data, len);
+    }
+    return network_transport_send_control(NULL, data, len);
+}
+
+// Caller holds send_mutex and coalesce_mutex. Returns true when there is
+// something to send.
+static bool seal_locked(mesh_ctrl_dest_t dest) {
+    if (bundles[dest].count == 0) {
+        return false;
+    }
+    network_ctrl_bundle_t empty = sealed[dest];
+    sealed[dest] = bundles[dest];
+    bundles[dest] = empty;
+    return true;
+}
+
+// Caller holds send_mutex only.
+static esp_err_t send_sealed(mesh_ctrl_dest_t dest) {
+    network_ctrl_bundle_t *bundle = &sealed[dest];
+    const uint8_t *data = bundle->buf;
+    size_t len = bundle->len;
+    if (!network_ctrl_bundle_single(bundle, &data, &len)) {
+        NET_STAT_INC(tx_control_bundles);
+        NET_STAT_ADD(tx_control_coalesced, bundle->count);
+    }
+    esp_err_t err = send_direct(dest, data, len);
+    network_ctrl_bundle_reset(bundle);
+    return err;
+}
+
+// False when the bundle is full. Sets *arm when the caller must arm the flush timer.
+static bool append_locked(mesh_ctrl_dest_t dest, const uint8_t *msg, size_t len, bool *arm) {
+    if (!network_ctrl_bundle_fits(&bundles[dest], len)) {
+        return false;
+    }
+    network_ctrl_bundle_append(&bundles[dest], msg, len);
+    if (!flush_armed) {
+        flush_armed = true;
+        *arm = true;
+    }
+    return true;
+}
+
+// Queues msg; a full bundle is sent first, from the calling task. Called
+// without either lock. Returns true when the caller must arm the flush timer.
+static bool enqueue(mesh_ctrl_dest_t dest, const uint8_t *msg, size_t len) {
+    bool arm = false;
+    xSemaphoreTake(coalesce_mutex, portMAX_DELAY);
+    bool queued = append_locked(dest, msg, len, &arm);
+    xSemaphoreGive(coalesce_mutex);
+    if (queued) {
+        return arm;
+    }
+
+    xSemaphoreTake(send_mutex, portMAX_DELAY);
+    xSemaphoreTake(coalesce_mutex, portMAX_DELAY);
+    // A flush may have emptied the bundle while we waited.
+    bool send = !network_ctrl_bundle_fits(&bundles[dest], len) && seal_locked(dest);
+    append_locked(dest, msg, len, &arm);
+    xSemaphoreGive(coalesce_mutex);
+    if (send) {
+        send_sealed(dest);
+    }
+    xSemaphoreGive(send_mutex);
+    return arm;
+}
+
+static void arm_flush_timer(void) {
+    esp_err_t err = esp_timer_start_once(flush_timer, (uint64_t)CONTROL_COALESCE_TICK_MS * 1000);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Control flush timer start failed: %s", esp_err_to_name(err));
+        mesh_coalesce_flush();
+    }
+}
+
+// A root flush is one send per route entry; it runs on the flush task so the
+// esp_timer task (mixer publish, other timers) is never held up by it.
+static void flush_timer_cb(void *arg) {
+    (void)arg;
+    TaskHandle_t task = atomic_load(&flush_task);
+    if (task) {
+        xTaskNotifyGive(task);
+    } else {
+        mesh_coalesce_flush();
+    }
+}
+
+esp_err_t mesh_coalesce_init(void) {
+    if (coalesce_mutex) {
+        return ESP_OK;
+    }
+    for (int i = 0; i < MESH_CTRL_DEST_COUNT; i++) {
+        network_ctrl_bundle_init(&bundles[i], bundle_bufs[i][0], sizeof(bundle_bufs[i][0]));
+        network_ctrl_bundle_init(&sealed[i], bundle_bufs[i][1], sizeof(bundle_bufs[i][1]));
+    }
+    memset(held, 0, sizeof(held));
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = flush_timer_cb,
+        .name = "ctrl_flush",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &flush_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (!send_mutex) {
+        send_mutex = xSemaphoreCreateMutex();
+    }
+    coalesce_mutex = send_mutex ? xSemaphoreCreateMutex() : NULL;
+    if (!coalesce_mutex) {
+        esp_timer_delete(flush_timer);
+        flush_timer = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void mesh_coalesce_set_flush_task(TaskHandle_t task) {
+    atomic_store(&flush_task, task);
+}
+
+esp_err_t mesh_coalesce_enqueue(mesh_ctrl_dest_t dest, const uint8_t *msg, size_t len) {
+    if (!msg || len == 0 || dest >= MESH_CTRL_DEST_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Too large to share a bundle, or the scheduler is not up yet: send as-is.
+    if (!coalesce_mutex ||
+        len + NET_CTRL_BUNDLE_HEADER_SIZE + NET_CTRL_BUNDLE_ENTRY_OVERHEAD > CONTROL_BUNDLE_MAX_BYTES) {
+        return send_direct(dest, msg, len);
+    }
+
+    if (enqueue(dest, msg, len)) {
+        arm_flush_timer();
+    }
+    return ESP_OK;
+}
+
+void mesh_coalesce_flush(void) {
+    if (!coalesce_mutex) {
+        return;
+    }
+    bool send[MESH_CTRL_DEST_COUNT];
+    xSemaphoreTake(send_mutex, portMAX_DELAY);
+    xSemaphoreTake(coalesce_mutex, portMAX_DELAY);
+    flush_armed = false;
+    for (int i = 0; i < MESH_CTRL_DEST_COUNT; i++) {
+        send[i] = seal_locked((mesh_ctrl_dest_t)i);
+    }
+    xSemaphoreGive(coalesce_mutex);
+    for (int i = 0; i < MESH_CTRL_DEST_COUNT; i++) {
+        if (send[i]) {
+            send_sealed((mesh_ctrl_dest_t)i);
+        }
+    }
+    xSemaphoreGive(send_mutex);
+}
+
+esp_err_t mesh_coalesce_send_heartbeat(const mesh_heartbeat_t *hb) {
+    if (!hb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!coalesce_mutex) {
+        return network_send_control((const uint8_t *)hb, sizeof(*hb));
+    }
+
+    // Layer 2 talks to the root directly; deeper nodes hand off to their parent,
+    // which forwards everything it holds with its own heartbeat.
+    mesh_ctrl_dest_t dest = mesh_layer > 2 ? MESH_CTRL_DEST_PARENT : MESH_CTRL_DEST_DEFAULT;
+    int64_t now_ms = esp_timer_get_time() / 1000;
+
+    bool arm = enqueue(dest, (const uint8_t *)hb, sizeof(*hb));
+    // One held heartbeat at a time, copied out, so the RX task can keep
+    // holding while a full bundle goes out.
+    for (int i = 0; i < CONTROL_DIGEST_MAX_NODES; i++) {
+        mesh_heartbeat_t relay;
+        xSemaphoreTake(coalesce_mutex, portMAX_DELAY);
+        bool fresh = held[i].used && now_ms - held[i].held_ms <= CONTROL_DIGEST_MAX_AGE_MS;
+        if (fresh) {
+            relay = held[i].hb;
+        }
+        held[i].used = false;
+        xSemaphoreGive(coalesce_mutex);
+        if (fresh) {
+            arm = enqueue(dest, (const uint8_t *)&relay, sizeof(relay)) || arm;
+        }
+    }
+
+    if (arm) {
+        arm_flush_timer();
+    }
+    return ESP_OK;
+}
+
+void mesh_coalesce_hold_heartbeat(const mesh_heartbeat_t *hb) {
+    if (!hb || !coalesce_mutex) {
+        return;
+    }
+    int64_t now_ms = esp_timer_get_time() / 1000;
+
+    xSemaphoreTake(coalesce_mutex, portMAX_DELAY);
+    held_heartbeat_t *slot = NULL;
+    held_heartbeat_t *oldest = &held[0];
+    for (int i = 0; i < CONTROL_DIGEST_MAX_NODES; i++) {
+        if (held[i].used && memcmp(held[i].hb.self_mac, hb->self_mac, 6) == 0) {
+            slot = &held[i];
+            break;
+        }
+        if (!slot && !held[i].used) {
+            slot = &held[i];
+        }
+        if (held[i].held_ms < oldest->held_ms) {
+            oldest = &held[i];
+        }
+    }
+    if (!slot) {
+        slot = oldest;
+    }
+    slot->used = true;
+    slot->held_ms = now_ms;
+    slot->hb = *hb;
+    NET_STAT_INC(rx_control_digest_heartbeats);
+    xSemaphoreGive(coalesce_mutex);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "network/mesh_net.h"
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Control-plane scheduler. Control messages queue per destination and go out as
+// one bundle per destination every CONTROL_COALESCE_TICK_MS, or as soon as a
+// bundle fills. Relays hold their descendants' heartbeats and forward them with
+// their own, so the root gets one upstream packet per subtree per interval.
+
+typedef enum {
+    MESH_CTRL_DEST_DEFAULT = 0,     // Root: every descendant. Other nodes: the root.
+    MESH_CTRL_DEST_PARENT,          // One hop up, for heartbeat aggregation
+    MESH_CTRL_DEST_COUNT,
+} mesh_ctrl_dest_t;
+
+esp_err_t mesh_coalesce_init(void);
+esp_err_t mesh_coalesce_enqueue(mesh_ctrl_dest_t dest, const uint8_t *msg, size_t len);
+void mesh_coalesce_flush(void);
+// The flush timer wakes task (xTaskNotifyGive), which then calls
+// mesh_coalesce_flush. Until one is set the timer flushes inline.
+void mesh_coalesce_set_flush_task(TaskHandle_t task);
+
+// Queues our heartbeat plus any held descendant heartbeats: straight to the root
+// at layer 2, through the parent deeper down.
+esp_err_t mesh_coalesce_send_heartbeat(const mesh_heartbeat_t *hb);
+// Relay: keep the latest heartbeat per descendant until our next heartbeat.
+void mesh_coalesce_hold_heartbeat(const mesh_heartbeat_t *hb);
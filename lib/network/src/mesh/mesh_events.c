@@ -1,4 +1,5 @@
 #include "mesh/mesh_events.h"
+#include "mesh/mesh_heartbeat.h"
 #include "mesh/mesh_state.h"
 #include "mesh/mesh_uplink.h"
 #include "mesh/mesh_mixer.h"
@@ -90,7 +91,7 @@ void mesh_event_handler(void *arg, esp_event_base_t event_base,
             mesh_layer = esp_mesh_get_layer();
             auth_expire_count = 0;
             parent_conn_count++;
-            g_transport_stats.parent_connect_events++;
+            NET_STAT_INC(parent_connect_events);
 
             ESP_LOGI(TAG, "Parent connected, layer: %d (stream ready)", mesh_layer);
             ESP_LOGI(TAG, "Parent BSSID: " MACSTR, MAC2STR(connected->connected.bssid));
@@ -121,7 +122,7 @@ void mesh_event_handler(void *arg, esp_event_base_t event_base,
             if (!esp_mesh_is_root()) {
                 bool was_connected = is_mesh_connected;
                 parent_disc_count++;
-                g_transport_stats.parent_disconnect_events++;
+                NET_STAT_INC(parent_disconnect_events);
                 ESP_LOGW(TAG, "Parent disconnected: reason=%d(%s), was_connected=%d, layer=%d",
                          disconnected->reason,
                          wifi_disconnect_reason_to_str(disconnected->reason),
@@ -156,6 +157,8 @@ void mesh_event_handler(void *arg, esp_event_base_t event_base,
             if (is_mesh_root) {
                 ESP_LOGI(TAG, "Root: child connected (self-org disabled, no scan/disconnect needed)");
             }
+            // The newcomer drops v2 audio until it has an anchor.
+            mesh_heartbeat_announce_stream(false);
             break;
         }
 
@@ -172,6 +175,10 @@ void mesh_event_handler(void *arg, esp_event_base_t event_base,
             ESP_LOGI(TAG, "Routing table changed: %d entries (descendants: %d)",
                      new_count, new_count > 0 ? new_count - 1 : 0);
             mesh_children_count = new_count;
+            // Descendants joining deeper only show up here on the root (the SRC).
+            if (event_id == MESH_EVENT_ROUTING_TABLE_ADD) {
+                mesh_heartbeat_announce_stream(false);
+            }
             break;
         }
 
@@ -225,7 +232,7 @@ void mesh_event_handler(void *arg, esp_event_base_t event_base,
 
         case MESH_EVENT_NO_PARENT_FOUND:
             no_parent_count++;
-            g_transport_stats.no_parent_events++;
+            NET_STAT_INC(no_parent_events);
             ESP_LOGW(TAG, "No parent found (attempt=%lu) — retrying scan (channel=%d, mesh_id=%s, src_id=%s)",
                      (unsigned long)no_parent_count, MESH_CHANNEL, MESH_ID, g_src_id);
             break;
@@ -244,7 +251,7 @@ void mesh_event_handler(void *arg, esp_event_base_t event_base,
         case MESH_EVENT_SCAN_DONE: {
             mesh_event_scan_done_t *scan = (mesh_event_scan_done_t *)event_data;
             scan_done_count++;
-            g_transport_stats.scan_done_events++;
+            NET_STAT_INC(scan_done_events);
             if (my_node_role == NODE_ROLE_OUT) {
                 ESP_LOGI(TAG, "Scan done #%lu: found %d APs (connected=%d, layer=%d)",
                          (unsigned long)scan_done_count, (int)scan->number, is_mesh_connected, esp_mesh_get_layer());
@@ -0,0 +1,186 @@
+#include "mesh/mesh_fanout.h"
+#include <string.h>
+
+static void fanout_switch(mesh_fanout_policy_t *policy,
+                          mesh_fanout_mode_t mode,
+                          mesh_fanout_reason_t reason,
+                          int64_t now_ms)
+{
+    if (policy->mode == MESH_FANOUT_P2P && reason == MESH_FANOUT_REASON_QUEUE_FULL) {
+        policy->p2p_cooldown_until_ms = now_ms + policy->cfg.p2p_cooldown_ms;
+    }
+    if (policy->mode != mode) {
+        policy->switches++;
+    }
+    policy->mode = mode;
+    policy->reason = reason;
+    policy->last_switch_ms = now_ms;
+    policy->pending_votes = 0;
+    policy->queue_full_streak = 0;
+}
+
+static bool fanout_dwell_elapsed(const mesh_fanout_policy_t *policy, int64_t now_ms)
+{
+    return (now_ms - policy->last_switch_ms) >= (int64_t)policy->cfg.min_dwell_ms;
+}
+
+static bool fanout_p2p_allowed(const mesh_fanout_policy_t *policy, uint16_t descendants, int64_t now_ms)
+{
+    return descendants <= policy->cfg.p2p_max_children && now_ms >= policy->p2p_cooldown_until_ms;
+}
+
+// Mode the last window's evidence argues for, or the current mode if none.
+static mesh_fanout_mode_t fanout_window_verdict(const mesh_fanout_policy_t *policy,
+                                                uint16_t descendants,
+                                                int64_t now_ms,
+                                                mesh_fanout_reason_t *reason_out)
+{
+    const mesh_fanout_window_t *w = &policy->window;
+
+    if (policy->mode == MESH_FANOUT_P2P) {
+        if (w->sends > 0 && mesh_fanout_window_pct(w->queue_full, w->sends) >= policy->cfg.qfull_enter_pct) {
+            *reason_out = MESH_FANOUT_REASON_QUEUE_FULL;
+            return MESH_FANOUT_GROUP;
+        }
+    } else if (policy->mode == MESH_FANOUT_GROUP && fanout_p2p_allowed(policy, descendants, now_ms)) {
+        if (w->frames > 0 && mesh_fanout_window_pct(w->lost_frames, w->frames) >= policy->cfg.loss_enter_pct) {
+            *reason_out = MESH_FANOUT_REASON_LOSS;
+            return MESH_FANOUT_P2P;
+        }
+        if (policy->reason == MESH_FANOUT_REASON_SIZE && descendants <= policy->cfg.p2p_return_children) {
+            *reason_out = MESH_FANOUT_REASON_SIZE;
+            return MESH_FANOUT_P2P;
+        }
+    }
+    return policy->mode;
+}
+
+void mesh_fanout_init(mesh_fanout_policy_t *policy, const mesh_fanout_config_t *cfg, int64_t now_ms)
+{
+    if (!policy) {
+        return;
+    }
+    memset(policy, 0, sizeof(*policy));
+    if (cfg) {
+        policy->cfg = *cfg;
+    } else {
+        policy->cfg = (mesh_fanout_config_t)MESH_FANOUT_CONFIG_DEFAULT();
+    }
+    if (policy->cfg.switch_windows == 0) {
+        policy->cfg.switch_windows = 1;
+    }
+    policy->mode = MESH_FANOUT_BROADCAST;
+    policy->reason = MESH_FANOUT_REASON_INIT;
+    policy->window_start_ms = now_ms;
+    policy->last_switch_ms = now_ms;
+}
+
+mesh_fanout_mode_t mesh_fanout_select(mesh_fanout_policy_t *policy, uint16_t descendants, int64_t now_ms)
+{
+    if (!policy) {
+        return MESH_FANOUT_BROADCAST;
+    }
+
+    // Topology changes are facts, not evidence: act on them immediately.
+    if (descendants == 0) {
+        if (policy->mode != MESH_FANOUT_BROADCAST) {
+            fanout_switch(policy, MESH_FANOUT_BROADCAST, MESH_FANOUT_REASON_NO_ROUTE, now_ms);
+        }
+        return policy->mode;
+    }
+    if (policy->mode == MESH_FANOUT_BROADCAST) {
+        mesh_fanout_mode_t mode = fanout_p2p_allowed(policy, descendants, now_ms) ? MESH_FANOUT_P2P : MESH_FANOUT_GROUP;
+        fanout_switch(policy, mode, MESH_FANOUT_REASON_SIZE, now_ms);
+        return policy->mode;
+    }
+    if (policy->mode == MESH_FANOUT_P2P && descendants > policy->cfg.p2p_max_children) {
+        fanout_switch(policy, MESH_FANOUT_GROUP, MESH_FANOUT_REASON_SIZE, now_ms);
+        return policy->mode;
+    }
+
+    // Sustained saturation skips the vote but still honours the dwell time.
+    if (policy->mode == MESH_FANOUT_P2P && policy->queue_full_streak >= policy->cfg.qfull_streak &&
+        fanout_dwell_elapsed(policy, now_ms)) {
+        fanout_switch(policy, MESH_FANOUT_GROUP, MESH_FANOUT_REASON_QUEUE_FULL, now_ms);
+        return policy->mode;
+    }
+
+    if ((now_ms - policy->window_start_ms) < (int64_t)policy->cfg.window_ms) {
+        return policy->mode;
+    }
+
+    mesh_fanout_reason_t reason = policy->reason;
+    mesh_fanout_mode_t verdict = fanout_window_verdict(policy, descendants, now_ms, &reason);
+    policy->last_window = policy->window;
+    memset(&policy->window, 0, sizeof(policy->window));
+    policy->window_start_ms = now_ms;
+
+    if (verdict == policy->mode) {
+        policy->pending_votes = 0;
+        return policy->mode;
+    }
+    if (policy->pending_votes == 0 || policy->pending_mode != verdict) {
+        policy->pending_mode = verdict;
+        policy->pending_votes = 0;
+    }
+    policy->pending_votes++;
+
+    if (policy->pending_votes >= policy->cfg.switch_windows && fanout_dwell_elapsed(policy, now_ms)) {
+        fanout_switch(policy, verdict, reason, now_ms);
+    }
+    return policy->mode;
+}
+
+void mesh_fanout_record_send(mesh_fanout_policy_t *policy, uint8_t frames, uint16_t sends, uint16_t queue_full)
+{
+    if (!policy) {
+        return;
+    }
+    policy->window.packets++;
+    policy->window.frames += frames;
+    policy->window.sends += sends;
+    policy->window.queue_full += queue_full;
+    if (queue_full > 0) {
+        policy->queue_full_streak++;
+    } else {
+        policy->queue_full_streak = 0;
+    }
+}
+
+void mesh_fanout_record_loss(mesh_fanout_policy_t *policy, uint16_t lost_frames)
+{
+    if (!policy) {
+        return;
+    }
+    policy->window.lost_frames += lost_frames;
+}
+
+uint32_t mesh_fanout_window_pct(uint32_t part, uint32_t whole)
+{
+    if (whole == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)part * 100U) / whole);
+}
+
+const char *mesh_fanout_mode_name(mesh_fanout_mode_t mode)
+{
+    switch (mode) {
+        case MESH_FANOUT_P2P: return "P2P";
+        case MESH_FANOUT_GROUP: return "GROUP";
+        case MESH_FANOUT_BROADCAST:
+        default: return "BCAST";
+    }
+}
+
+const char *mesh_fanout_reason_name(mesh_fanout_reason_t reason)
+{
+    switch (reason) {
+        case MESH_FANOUT_REASON_NO_ROUTE: return "noroute";
+        case MESH_FANOUT_REASON_SIZE: return "size";
+        case MESH_FANOUT_REASON_QUEUE_FULL: return "qfull";
+        case MESH_FANOUT_REASON_LOSS: return "loss";
+        case MESH_FANOUT_REASON_INIT:
+        default: return "init";
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "config/build.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Root audio fanout policy. Picks P2P, GROUP or broadcast from delivery evidence
+// (queue-full streaks, NACK-reported loss, sends per packet) with hysteresis.
+// Not thread-safe: only mesh_tx.c's send path touches it.
+
+typedef enum {
+    MESH_FANOUT_BROADCAST = 0,
+    MESH_FANOUT_P2P,
+    MESH_FANOUT_GROUP,
+} mesh_fanout_mode_t;
+
+typedef enum {
+    MESH_FANOUT_REASON_INIT = 0,
+    MESH_FANOUT_REASON_NO_ROUTE,
+    MESH_FANOUT_REASON_SIZE,
+    MESH_FANOUT_REASON_QUEUE_FULL,
+    MESH_FANOUT_REASON_LOSS,
+} mesh_fanout_reason_t;
+
+typedef struct {
+    uint16_t p2p_max_children;
+    uint16_t p2p_return_children;
+    uint32_t window_ms;
+    uint8_t switch_windows;
+    uint32_t min_dwell_ms;
+    uint8_t qfull_enter_pct;
+    uint32_t qfull_streak;
+    uint8_t loss_enter_pct;
+    uint32_t p2p_cooldown_ms;
+} mesh_fanout_config_t;
+
+#define MESH_FANOUT_CONFIG_DEFAULT() { \
+    .p2p_max_children = MESH_FANOUT_P2P_MAX_CHILDREN, \
+    .p2p_return_children = MESH_FANOUT_P2P_RETURN_CHILDREN, \
+    .window_ms = MESH_FANOUT_WINDOW_MS, \
+    .switch_windows = MESH_FANOUT_SWITCH_WINDOWS, \
+    .min_dwell_ms = MESH_FANOUT_MIN_DWELL_MS, \
+    .qfull_enter_pct = MESH_FANOUT_QFULL_ENTER_PCT, \
+    .qfull_streak = MESH_FANOUT_QFULL_STREAK, \
+    .loss_enter_pct = MESH_FANOUT_LOSS_ENTER_PCT, \
+    .p2p_cooldown_ms = MESH_FANOUT_P2P_COOLDOWN_MS \
+}
+
+typedef struct {
+    uint32_t packets;       // Audio packets sent
+    uint32_t frames;        // Audio frames carried by those packets
+    uint32_t sends;         // esp_mesh_send calls (airtime cost)
+    uint32_t queue_full;    // Sends rejected with QUEUE_FULL
+    uint32_t lost_frames;   // Frames NACKed by OUT nodes
+} mesh_fanout_window_t;
+
+typedef struct {
+    mesh_fanout_config_t cfg;
+    mesh_fanout_mode_t mode;
+    mesh_fanout_reason_t reason;
+    int64_t window_start_ms;
+    int64_t last_switch_ms;
+    int64_t p2p_cooldown_until_ms;
+    mesh_fanout_mode_t pending_mode;
+    uint8_t pending_votes;
+    uint32_t queue_full_streak;
+    uint32_t switches;
+    mesh_fanout_window_t window;
+    mesh_fanout_window_t last_window;   // Last completed window, for logging
+} mesh_fanout_policy_t;
+
+void mesh_fanout_init(mesh_fanout_policy_t *policy, const mesh_fanout_config_t *cfg, int64_t now_ms);
+mesh_fanout_mode_t mesh_fanout_select(mesh_fanout_policy_t *policy, uint16_t descendants, int64_t now_ms);
+void mesh_fanout_record_send(mesh_fanout_policy_t *policy, uint8_t frames, uint16_t sends, uint16_t queue_full);
+void mesh_fanout_record_loss(mesh_fanout_policy_t *policy, uint16_t lost_frames);
+
+uint32_t mesh_fanout_window_pct(uint32_t part, uint32_t whole);
+const char *mesh_fanout_mode_name(mesh_fanout_mode_t mode);
+const char *mesh_fanout_reason_name(mesh_fanout_reason_t reason);
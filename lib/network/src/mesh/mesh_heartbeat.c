@@ -1,6 +1,12 @@
 #include "mesh/mesh_heartbeat.h"
 #include "mesh/mesh_state.h"
+#include "mesh/mesh_ping.h"
+#include "mesh/mesh_coalesce.h"
+#include "mesh/mesh_queries.h"
+#include "mesh/mesh_mixer.h"
 #include "network/mesh_net.h"
+#include "network/audio_transport.h"
+#include "network/transport.h"
 #include <esp_log.h>
 #include <esp_system.h>
 #include <esp_timer.h>
@@ -38,40 +44,60 @@ static void send_heartbeat(void) {
     hb_count++;
     if ((hb_count % 5) == 1) {
         int rt_size = esp_mesh_get_routing_table_size();
-        ESP_LOGI(TAG, "Heartbeat #%lu: root=%d, connected=%d, route_table=%d, children=%d churn(pc=%lu pd=%lu ae=%lu np=%lu)",
+        network_rtt_summary_t rtt;
+        mesh_link_lock();
+        network_rtt_window_summary(&g_rtt_upstream, &rtt);
+        mesh_link_unlock();
+        ESP_LOGI(TAG, "Heartbeat #%lu: root=%d, connected=%d, route_table=%d, children=%d churn(pc=%lu pd=%lu ae=%lu np=%lu) "
+                 "rtt(n=%lu min=%lu p50=%lu p95=%lu us)",
                  hb_count, is_mesh_root, is_mesh_connected, rt_size, mesh_children_count,
                  (unsigned long)parent_conn_count, (unsigned long)parent_disc_count,
-                 (unsigned long)auth_expire_count, (unsigned long)no_parent_count);
+                 (unsigned long)auth_expire_count, (unsigned long)no_parent_count,
+                 (unsigned long)rtt.samples, (unsigned long)rtt.min_us,
+                 (unsigned long)rtt.p50_us, (unsigned long)rtt.p95_us);
     }
 
-    esp_err_t err = network_send_control((uint8_t *)&heartbeat, sizeof(heartbeat));
+    esp_err_t err = mesh_coalesce_send_heartbeat(&heartbeat);
     if (err != ESP_OK && err != ESP_ERR_MESH_NO_ROUTE_FOUND) {
         ESP_LOGD(TAG, "Failed to send heartbeat: %s", esp_err_to_name(err));
     }
 }
 
-static void send_stream_announcement(void) {
+void mesh_heartbeat_announce_stream(bool now) {
     if (my_node_role != NODE_ROLE_SRC) {
         return;
     }
 
-    if (is_mesh_root) {
+    // Periodic (root included) so receivers joining mid-stream can resolve v2
+    // stream_id -> src_id and anchor the compact seq/timestamp fields. Nothing is
+    // announced before the first packet: there is no position to anchor to yet.
+    uint8_t stream_id = 0;
+    uint16_t seq = 0;
+    uint32_t timestamp_ms = 0;
+    if (!network_get_audio_tx_anchor(&stream_id, &seq, &timestamp_ms)) {
         return;
     }
 
     mesh_stream_announce_t announce;
+    memset(&announce, 0, sizeof(announce));
     announce.type = NET_PKT_TYPE_STREAM_ANNOUNCE;
-    announce.stream_id = my_stream_id;
+    announce.stream_id = stream_id;
     announce.sample_rate = htonl(AUDIO_SAMPLE_RATE);
     announce.channels = AUDIO_CHANNELS_MONO;
     announce.bits_per_sample = AUDIO_BOUNDARY_BITS_PER_SAMPLE;
     announce.frame_size_ms = htons(AUDIO_FRAME_EFFECTIVE_MS);
+    memcpy(announce.src_id, g_src_id, NETWORK_SRC_ID_LEN);
+    announce.seq = htons(seq);
+    announce.timestamp = htonl(timestamp_ms);
 
-    esp_err_t err = network_send_control((uint8_t *)&announce, sizeof(announce));
+    // now: down the audio fanout, so it reaches each node in order with (and
+    // ahead of) the stream's first packet instead of as a burst of control sends.
+    esp_err_t err = now ? network_transport_send_audio(NULL, (uint8_t *)&announce, sizeof(announce))
+                        : network_send_control((uint8_t *)&announce, sizeof(announce));
     if (err != ESP_OK && err != ESP_ERR_MESH_NO_ROUTE_FOUND) {
         ESP_LOGD(TAG, "Failed to send stream announcement: %s", esp_err_to_name(err));
     } else {
-        ESP_LOGI(TAG,
+        ESP_LOGD(TAG,
                  "Stream announced: ID=%u, %uHz, boundary=%u-bit (internal=%u-bit), %uch, frame=%ums (target=%ums fallback=%d)",
                  announce.stream_id, (unsigned int)AUDIO_SAMPLE_RATE,
                  (unsigned int)AUDIO_BOUNDARY_BITS_PER_SAMPLE,
@@ -82,9 +108,46 @@ static void send_stream_announcement(void) {
     }
 }
 
+// The ping service shares the heartbeat task: it wakes every MESH_PING_INTERVAL_MS
+// and heartbeats go out whenever their jittered deadline has passed.
+uint32_t mesh_heartbeat_tick(void) {
+    const uint32_t HEARTBEAT_INTERVAL_MS = 5000;
+    static bool started = false;
+    static int64_t last_announce_us = 0;
+    static int64_t next_heartbeat_us = 0;
+
+    if (!started) {
+        mesh_heartbeat_announce_stream(false);
+        last_announce_us = esp_timer_get_time();
+        next_heartbeat_us = esp_timer_get_time();
+        started = true;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    if (now_us >= next_heartbeat_us) {
+        send_heartbeat();
+        const uint32_t heartbeatDelayMs = HEARTBEAT_INTERVAL_MS - CONTROL_TIMER_JITTER_MS +
+                                          (esp_random() % ((2 * CONTROL_TIMER_JITTER_MS) + 1));
+        next_heartbeat_us = now_us + (int64_t)heartbeatDelayMs * 1000;
+    }
+    if ((now_us - last_announce_us) >= (int64_t)STREAM_ANNOUNCE_INTERVAL_MS * 1000) {
+        mesh_heartbeat_announce_stream(false);
+        last_announce_us = now_us;
+    }
+    mesh_mixer_beacon_tick(now_us);
+    mesh_ping_service_tick();
+    mesh_queries_stats_tick(esp_timer_get_time());
+
+    int64_t until_heartbeat_ms = (next_heartbeat_us - esp_timer_get_time()) / 1000;
+    uint32_t delay_ms = MESH_PING_INTERVAL_MS;
+    if (until_heartbeat_ms < (int64_t)delay_ms) {
+        delay_ms = until_heartbeat_ms > 0 ? (uint32_t)until_heartbeat_ms : 1;
+    }
+    return delay_ms;
+}
+
 void mesh_heartbeat_task(void *arg) {
     (void)arg;
-    const uint32_t HEARTBEAT_INTERVAL_MS = 5000;
     const uint32_t OUT_RECOVERY_INTERVAL_MS = 120000;
 
     ESP_LOGI(TAG, "Heartbeat task started (will send once network is ready)");
@@ -108,12 +171,17 @@ void mesh_heartbeat_task(void *arg) {
     }
     ESP_LOGI(TAG, "Network ready - sending heartbeats");
 
-    send_stream_announcement();
-
+    // Between passes this task also sends the queued control bundles
+    // whenever the coalesce flush timer wakes it.
+    mesh_coalesce_set_flush_task(xTaskGetCurrentTaskHandle());
     while (1) {
-        send_heartbeat();
-        const uint32_t heartbeatDelayMs = HEARTBEAT_INTERVAL_MS - CONTROL_TIMER_JITTER_MS +
-                                          (esp_random() % ((2 * CONTROL_TIMER_JITTER_MS) + 1));
-        vTaskDelay(pdMS_TO_TICKS(heartbeatDelayMs));
+        int64_t next_pass_us = esp_timer_get_time() + (int64_t)mesh_heartbeat_tick() * 1000;
+        int64_t wait_us;
+        while ((wait_us = next_pass_us - esp_timer_get_time()) > 0) {
+            TickType_t ticks = pdMS_TO_TICKS((uint32_t)((wait_us + 999) / 1000));
+            if (ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1) > 0) {
+                mesh_coalesce_flush();
+            }
+        }
     }
 }
@@ -1,3 +1,14 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 void mesh_heartbeat_task(void *arg);
+// One heartbeat/announce/ping pass once the network is ready (the first call
+// announces the stream if audio is already flowing). Returns the delay in ms
+// until the next pass.
+uint32_t mesh_heartbeat_tick(void);
+// SRC only: announces the stream and its current TX anchor. now sends it on the
+// audio path (stream start, ahead of the first packet) instead of coalescing it;
+// a no-op before any audio.
+void mesh_heartbeat_announce_stream(bool now);
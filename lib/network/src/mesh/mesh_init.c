@@ -5,6 +5,11 @@
 #include "mesh/mesh_rx.h"
 #include "mesh/mesh_heartbeat.h"
 #include "mesh/mesh_dedupe.h"
+#include "mesh/mesh_coalesce.h"
+#include "mesh/mesh_mixer.h"
+#include "mesh/mesh_retransmit.h"
+#include "mesh/mesh_transport.h"
+#include "mesh/mesh_tx.h"
 #include "config/build.h"
 #include "config/build_role.h"
 #include "network/mesh_net.h"
@@ -165,6 +170,32 @@ esp_err_t network_init_mesh(void) {
 
     ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_NONE));
 
+    esp_err_t state_err = mesh_state_init();
+    if (state_err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create link state lock: %s", esp_err_to_name(state_err));
+        return state_err;
+    }
+    esp_err_t mixer_err = mesh_mixer_init();
+    if (mixer_err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create mixer lock: %s", esp_err_to_name(mixer_err));
+        return mixer_err;
+    }
+
+    esp_err_t coalesce_err = mesh_coalesce_init();
+    if (coalesce_err != ESP_OK) {
+        // Control messages still go out, just one packet each.
+        ESP_LOGW(TAG, "Control coalescing unavailable: %s", esp_err_to_name(coalesce_err));
+    }
+
+    mesh_tx_init();
+    esp_err_t retx_err = mesh_retx_cache_init();
+    if (retx_err != ESP_OK) {
+        // NACKs go unanswered; playout conceals the gaps instead.
+        ESP_LOGW(TAG, "Retransmit cache unavailable: %s", esp_err_to_name(retx_err));
+    }
+
+    network_transport_set(mesh_transport_backend());
+
     TaskHandle_t mesh_rx_handle = NULL;
     if (xTaskCreate(mesh_rx_task, "mesh_rx", MESH_RX_TASK_STACK, NULL, MESH_RX_TASK_PRIO, &mesh_rx_handle) != pdPASS ||
         mesh_rx_handle == NULL) {
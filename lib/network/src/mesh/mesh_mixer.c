@@ -1,13 +1,53 @@
 #include "mesh/mesh_mixer.h"
 #include "mesh/mesh_state.h"
+#include "mesh/mesh_tx.h"
+#include "config/build.h"
 
 #include <esp_log.h>
 #include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "network_mesh";
 
+// s_mixer and the replication state below are touched by the httpd task
+// (network_set_mixer_state), the RX task (control, deltas, sync requests),
+// the heartbeat task (beacons) and the publish timer. Every access holds
+// s_mixer_lock; packets are built under it and sent after it is released,
+// and the apply callback runs without it.
+static SemaphoreHandle_t s_mixer_lock = NULL;
+
+static void mixer_lock(void) {
+    if (s_mixer_lock) {
+        xSemaphoreTake(s_mixer_lock, portMAX_DELAY);
+    }
+}
+
+static void mixer_unlock(void) {
+    if (s_mixer_lock) {
+        xSemaphoreGive(s_mixer_lock);
+    }
+}
+
+esp_err_t mesh_mixer_init(void) {
+    if (!s_mixer_lock) {
+        s_mixer_lock = xSemaphoreCreateMutex();
+        if (!s_mixer_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+static network_mixer_status_t mixer_snapshot(void) {
+    mixer_lock();
+    network_mixer_status_t copy = s_mixer;
+    mixer_unlock();
+    return copy;
+}
+
 static void mixer_set_error(const char *err) {
     if (!err || !*err) {
         s_mixer.last_error[0] = '\0';
@@ -63,74 +103,229 @@ static esp_err_t mesh_mixer_apply_local(const network_mixer_status_t *next, bool
         return ESP_ERR_INVALID_ARG;
     }
 
+    mixer_lock();
     s_mixer.pending_apply = true;
     s_mixer.schema_version = MIXER_SCHEMA_VERSION;
     s_mixer.out_gain_pct = next->out_gain_pct;
     mixer_copy_streams(&s_mixer, next);
     s_mixer.updated_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    network_mixer_status_t applied = s_mixer;
+    mixer_unlock();
 
     esp_err_t err = ESP_OK;
     if (mixer_apply_callback) {
-        err = mixer_apply_callback(&s_mixer);
-        if (err != ESP_OK) {
-            mixer_set_error("apply_callback_failed");
-            return err;
+        err = mixer_apply_callback(&applied);
+    }
+
+    mixer_lock();
+    if (err != ESP_OK) {
+        mixer_set_error("apply_callback_failed");
+        mixer_unlock();
+        return err;
+    }
+    s_mixer.pending_apply = false;
+    s_mixer.applied = true;
+    mixer_set_error("");
+    mixer_unlock();
+
+    ESP_LOGI(TAG, "Mixer apply ok gain=%u%% (sync=%d)",
+             (unsigned)applied.out_gain_pct,
+             from_root_sync ? 1 : 0);
+    return err;
+}
+
+static void mixer_status_to_message(const network_mixer_status_t *status, mixer_ctrl_subtype_t subtype,
+                                    mixer_ctrl_message_t *msg) {
+    memset(msg, 0, sizeof(*msg));
+    msg->subtype = subtype;
+    msg->version = MIXER_CTRL_VERSION;
+    msg->out_gain_pct = status->out_gain_pct;
+    msg->stream_count = status->stream_count;
+    for (uint8_t i = 0; i < status->stream_count; i++) {
+        msg->streams[i].stream_id = status->streams[i].stream_id;
+        msg->streams[i].gain_pct = status->streams[i].gain_pct;
+        msg->streams[i].enabled = status->streams[i].enabled;
+        msg->streams[i].muted = status->streams[i].muted;
+        msg->streams[i].solo = status->streams[i].solo;
+        msg->streams[i].active = status->streams[i].active;
+    }
+}
+
+static void mixer_message_to_status(const mixer_ctrl_message_t *msg, network_mixer_status_t *next) {
+    next->schema_version = MIXER_SCHEMA_VERSION;
+    next->out_gain_pct = msg->out_gain_pct;
+    if (msg->stream_count > 0) {
+        memset(next->streams, 0, sizeof(next->streams));
+        next->stream_count = msg->stream_count;
+        for (uint8_t i = 0; i < msg->stream_count; i++) {
+            next->streams[i].stream_id = msg->streams[i].stream_id;
+            next->streams[i].gain_pct = msg->streams[i].gain_pct;
+            next->streams[i].enabled = msg->streams[i].enabled;
+            next->streams[i].muted = msg->streams[i].muted;
+            next->streams[i].solo = msg->streams[i].solo;
+            next->streams[i].active = msg->streams[i].active;
         }
     }
+}
 
+// Root: version of the last published state and the state itself, so the next
+// publish only carries what changed. Node: version of the last applied state.
+static uint16_t s_state_version = 0;
+static mixer_ctrl_message_t s_published;
+static bool s_published_valid = false;
+static esp_timer_handle_t s_publish_timer = NULL;
+static bool s_publish_armed = false;
+static int64_t s_last_sync_request_us = 0;
 
-    s_mixer.pending_apply = false;
-    s_mixer.applied = (err == ESP_OK);
-    if (err == ESP_OK) {
-        mixer_set_error("");
-    } else {
-        mixer_set_error(esp_err_to_name(err));
+static esp_err_t mesh_mixer_send_delta(const mesh_addr_t *to, const mixer_delta_packet_t *pkt, size_t len) {
+    if (to) {
+        return mesh_tx_send_control_to(to, (const uint8_t *)pkt, len);
+    }
+    return network_send_control((const uint8_t *)pkt, len);
+}
+
+// Root: encodes whatever changed since the last published version into pkt
+// and advances the version. Caller holds s_mixer_lock; 0 = nothing changed.
+static size_t mesh_mixer_publish_locked(mixer_delta_packet_t *pkt) {
+    mixer_ctrl_message_t current;
+    mixer_status_to_message(&s_mixer, MIXER_CTRL_SYNC, &current);
+
+    uint16_t next_version = (uint16_t)(s_state_version + 1);
+    if (next_version == 0) {
+        next_version = 1;
+    }
+    size_t len = mixer_delta_encode(s_published_valid ? &s_published : NULL, &current,
+                                    s_state_version, next_version, pkt);
+    if (len == 0) {
+        return 0;
     }
 
-    ESP_LOGI(TAG, "Mixer apply %s gain=%u%% (sync=%d)",
-             err == ESP_OK ? "ok" : "failed",
-             (unsigned)s_mixer.out_gain_pct,
-             from_root_sync ? 1 : 0);
+    // The version advances even if the send fails; nodes that miss it see a
+    // base mismatch on the next delta or version beacon and ask for a full state.
+    s_state_version = next_version;
+    s_published = current;
+    s_published_valid = true;
+    return len;
+}
+
+static esp_err_t mesh_mixer_publish_delta(void) {
+    mixer_delta_packet_t pkt;
+    mixer_lock();
+    size_t len = mesh_mixer_publish_locked(&pkt);
+    uint16_t version = s_state_version;
+    mixer_unlock();
+    if (len == 0) {
+        return ESP_OK;
+    }
+    esp_err_t err = mesh_mixer_send_delta(NULL, &pkt, len);
+    ESP_LOGD(TAG, "Mixer v%u published (%u bytes, %s)",
+             (unsigned)version, (unsigned)len,
+             (pkt.hdr.flags & MIXER_DELTA_FLAG_FULL) ? "full" : "delta");
     return err;
 }
 
-esp_err_t mesh_mixer_publish_sync(mixer_ctrl_subtype_t subtype) {
-    mixer_ctrl_message_t msg = {
-        .subtype = subtype,
-        .version = MIXER_CTRL_VERSION,
-        .out_gain_pct = s_mixer.out_gain_pct,
-        .stream_count = s_mixer.stream_count,
-    };
-    for (uint8_t i = 0; i < s_mixer.stream_count; i++) {
-        msg.streams[i].stream_id = s_mixer.streams[i].stream_id;
-        msg.streams[i].gain_pct = s_mixer.streams[i].gain_pct;
-        msg.streams[i].enabled = s_mixer.streams[i].enabled;
-        msg.streams[i].muted = s_mixer.streams[i].muted;
-        msg.streams[i].solo = s_mixer.streams[i].solo;
-        msg.streams[i].active = s_mixer.streams[i].active;
+// Root: full state at the current version, to one requester or everyone.
+// Before the first publish that is a publish, to everyone.
+static esp_err_t mesh_mixer_send_full(const mesh_addr_t *to) {
+    mixer_delta_packet_t pkt;
+    size_t len;
+    mixer_lock();
+    if (s_published_valid) {
+        len = mixer_delta_encode(NULL, &s_published, s_state_version, s_state_version, &pkt);
+    } else {
+        len = mesh_mixer_publish_locked(&pkt);
+        to = NULL;
     }
+    mixer_unlock();
+    if (len == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return mesh_mixer_send_delta(to, &pkt, len);
+}
+
+void mesh_mixer_beacon_tick(int64_t now_us) {
+    static int64_t last_beacon_us = 0;
+
+    if (!is_mesh_root || (now_us - last_beacon_us) < (int64_t)MIXER_VERSION_BEACON_MS * 1000) {
+        return;
+    }
+    mixer_lock();
+    uint16_t version = s_state_version;
+    mixer_unlock();
+    if (version == 0) {
+        return;
+    }
+    last_beacon_us = now_us;
+
+    mixer_delta_packet_t pkt;
+    size_t len = mixer_delta_encode_beacon(version, &pkt);
+    if (len > 0) {
+        (void)mesh_mixer_send_delta(NULL, &pkt, len);
+    }
+}
+
+static void mesh_mixer_send_set_to_root(void) {
+    network_mixer_status_t status = mixer_snapshot();
+    mixer_ctrl_message_t msg;
+    mixer_status_to_message(&status, MIXER_CTRL_SET, &msg);
     mixer_ctrl_packet_t pkt;
     if (!mixer_ctrl_encode(&msg, &pkt)) {
-        return ESP_ERR_INVALID_ARG;
+        return;
+    }
+    esp_err_t err = network_send_control((const uint8_t *)&pkt, sizeof(pkt));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Mixer set to root failed: %s", esp_err_to_name(err));
+    }
+}
+
+static void mixer_publish_timer_cb(void *arg) {
+    (void)arg;
+    mixer_lock();
+    s_publish_armed = false;
+    mixer_unlock();
+    if (is_mesh_root) {
+        (void)mesh_mixer_publish_delta();
+    } else {
+        mesh_mixer_send_set_to_root();
+    }
+}
+
+// Coalesces bursts of edits (slider drags) into one publish per MIXER_PUBLISH_COALESCE_MS.
+static void mesh_mixer_schedule_publish(void) {
+    if (!s_publish_timer) {
+        const esp_timer_create_args_t args = {
+            .callback = mixer_publish_timer_cb,
+            .name = "mixer_pub",
+        };
+        if (esp_timer_create(&args, &s_publish_timer) != ESP_OK) {
+            s_publish_timer = NULL;
+            mixer_publish_timer_cb(NULL);
+            return;
+        }
+    }
+    mixer_lock();
+    bool armed = s_publish_armed;
+    s_publish_armed = true;
+    mixer_unlock();
+    if (armed) {
+        return;
+    }
+    if (esp_timer_start_once(s_publish_timer, (uint64_t)MIXER_PUBLISH_COALESCE_MS * 1000) != ESP_OK) {
+        mixer_publish_timer_cb(NULL);
     }
-    return network_send_control((const uint8_t *)&pkt, sizeof(pkt));
 }
 
 void mesh_mixer_request_sync_from_root(void) {
-    mixer_ctrl_message_t msg = {
-        .subtype = MIXER_CTRL_REQUEST_SYNC,
-        .version = MIXER_CTRL_VERSION,
-        .out_gain_pct = s_mixer.out_gain_pct,
-        .stream_count = s_mixer.stream_count,
-    };
-    for (uint8_t i = 0; i < s_mixer.stream_count; i++) {
-        msg.streams[i].stream_id = s_mixer.streams[i].stream_id;
-        msg.streams[i].gain_pct = s_mixer.streams[i].gain_pct;
-        msg.streams[i].enabled = s_mixer.streams[i].enabled;
-        msg.streams[i].muted = s_mixer.streams[i].muted;
-        msg.streams[i].solo = s_mixer.streams[i].solo;
-        msg.streams[i].active = s_mixer.streams[i].active;
+    int64_t now_us = esp_timer_get_time();
+    if (s_last_sync_request_us != 0 &&
+        (now_us - s_last_sync_request_us) < (int64_t)MIXER_SYNC_REQUEST_MIN_MS * 1000) {
+        return;
     }
+    s_last_sync_request_us = now_us;
+
+    network_mixer_status_t status = mixer_snapshot();
+    mixer_ctrl_message_t msg;
+    mixer_status_to_message(&status, MIXER_CTRL_REQUEST_SYNC, &msg);
     mixer_ctrl_packet_t pkt;
     if (!mixer_ctrl_encode(&msg, &pkt)) {
         return;
@@ -141,42 +336,73 @@ void mesh_mixer_request_sync_from_root(void) {
     }
 }
 
-void mesh_mixer_handle_control(const mixer_ctrl_message_t *msg) {
+void mesh_mixer_handle_control(const mesh_addr_t *from, const mixer_ctrl_message_t *msg) {
     if (!msg) {
         return;
     }
 
     if (msg->subtype == MIXER_CTRL_REQUEST_SYNC) {
         if (is_mesh_root) {
-            (void)mesh_mixer_publish_sync(MIXER_CTRL_SYNC);
+            (void)mesh_mixer_send_full(from);
         }
         return;
     }
 
-    network_mixer_status_t next = s_mixer;
-    next.schema_version = MIXER_SCHEMA_VERSION;
-    next.out_gain_pct = msg->out_gain_pct;
-    if (msg->stream_count > 0) {
-        next.stream_count = msg->stream_count;
-        for (uint8_t i = 0; i < msg->stream_count; i++) {
-            next.streams[i].stream_id = msg->streams[i].stream_id;
-            next.streams[i].gain_pct = msg->streams[i].gain_pct;
-            next.streams[i].enabled = msg->streams[i].enabled;
-            next.streams[i].muted = msg->streams[i].muted;
-            next.streams[i].solo = msg->streams[i].solo;
-            next.streams[i].active = msg->streams[i].active;
-        }
-    }
-
+    // Legacy full SYNC (older roots) still applies; it carries no version.
+    network_mixer_status_t next = mixer_snapshot();
+    mixer_message_to_status(msg, &next);
     esp_err_t err = mesh_mixer_apply_local(&next, msg->subtype == MIXER_CTRL_SYNC);
     if (is_mesh_root) {
         if (err != ESP_OK) {
             ESP_LOGW(TAG, "Mixer apply failed on root: %s", esp_err_to_name(err));
         }
-        (void)mesh_mixer_publish_sync(MIXER_CTRL_SYNC);
+        mesh_mixer_schedule_publish();
     }
 }
 
+void mesh_mixer_handle_delta(const uint8_t *data, size_t len) {
+    if (is_mesh_root) {
+        return;
+    }
+
+    mixer_lock();
+    network_mixer_status_t next = s_mixer;
+    mixer_ctrl_message_t state;
+    mixer_status_to_message(&next, MIXER_CTRL_SYNC, &state);
+    uint16_t version = s_state_version;
+    mixer_delta_result_t result = mixer_delta_apply(data, len, &version, &state);
+    if (result == MIXER_DELTA_APPLIED) {
+        s_state_version = version;
+    }
+    mixer_unlock();
+
+    switch (result) {
+        case MIXER_DELTA_APPLIED:
+            mixer_message_to_status(&state, &next);
+            (void)mesh_mixer_apply_local(&next, true);
+            break;
+        case MIXER_DELTA_GAP:
+            ESP_LOGI(TAG, "Mixer delta gap at v%u, requesting full state", (unsigned)version);
+            mesh_mixer_request_sync_from_root();
+            break;
+        case MIXER_DELTA_INVALID:
+            ESP_LOGW(TAG, "Ignoring invalid mixer delta (%u bytes)", (unsigned)len);
+            break;
+        case MIXER_DELTA_STALE:
+        default:
+            break;
+    }
+}
+
+esp_err_t mixer_ctrl_apply(const mixer_ctrl_message_t *msg) {
+    if (!msg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    network_mixer_status_t next = mixer_snapshot();
+    mixer_message_to_status(msg, &next);
+    return network_set_mixer_state(&next);
+}
+
 esp_err_t network_register_mixer_apply_callback(network_mixer_apply_callback_t callback) {
     mixer_apply_callback = callback;
     return ESP_OK;
@@ -190,51 +416,28 @@ esp_err_t network_set_mixer_state(const network_mixer_status_t *mixer_state) {
     network_mixer_status_t next = *mixer_state;
     next.schema_version = MIXER_SCHEMA_VERSION;
     if (next.stream_count == 0) {
-        next.stream_count = s_mixer.stream_count;
-        for (uint8_t i = 0; i < s_mixer.stream_count; i++) {
-            next.streams[i] = s_mixer.streams[i];
-        }
+        network_mixer_status_t current = mixer_snapshot();
+        mixer_copy_streams(&next, &current);
     }
     if (!mixer_status_is_valid(&next)) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    mixer_ctrl_message_t msg = {
-        .subtype = MIXER_CTRL_SET,
-        .version = MIXER_CTRL_VERSION,
-        .out_gain_pct = next.out_gain_pct,
-        .stream_count = next.stream_count,
-    };
-    for (uint8_t i = 0; i < next.stream_count; i++) {
-        msg.streams[i].stream_id = next.streams[i].stream_id;
-        msg.streams[i].gain_pct = next.streams[i].gain_pct;
-        msg.streams[i].enabled = next.streams[i].enabled;
-        msg.streams[i].muted = next.streams[i].muted;
-        msg.streams[i].solo = next.streams[i].solo;
-        msg.streams[i].active = next.streams[i].active;
-    }
-
-    mixer_ctrl_packet_t pkt;
-    if (!mixer_ctrl_encode(&msg, &pkt)) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
+    // Applied locally right away; replication is coalesced behind a short timer
+    // (root publishes a delta, other nodes forward a SET to the root).
     esp_err_t apply_err = mesh_mixer_apply_local(&next, false);
     if (is_mesh_root) {
         if (apply_err != ESP_OK) {
             ESP_LOGW(TAG, "Mixer apply failed on root: %s", esp_err_to_name(apply_err));
         }
-        esp_err_t sync_err = mesh_mixer_publish_sync(MIXER_CTRL_SYNC);
-        if (sync_err == ESP_ERR_MESH_NO_ROUTE_FOUND) {
-            return apply_err == ESP_OK ? ESP_OK : apply_err;
-        }
-        return sync_err != ESP_OK ? sync_err : apply_err;
+        mesh_mixer_schedule_publish();
+        return apply_err;
     }
 
-    esp_err_t send_err = network_send_control((const uint8_t *)&pkt, sizeof(pkt));
-    if (send_err != ESP_OK) {
-        return send_err;
+    if (!is_mesh_connected) {
+        return ESP_ERR_INVALID_STATE;
     }
+    mesh_mixer_schedule_publish();
     return apply_err;
 }
 
@@ -242,7 +445,7 @@ esp_err_t network_set_mixer_config(uint16_t out_gain_pct) {
     if (out_gain_pct > MIXER_OUT_GAIN_MAX_PCT) {
         return ESP_ERR_INVALID_ARG;
     }
-    network_mixer_status_t next = s_mixer;
+    network_mixer_status_t next = mixer_snapshot();
     next.out_gain_pct = out_gain_pct;
     return network_set_mixer_state(&next);
 }
@@ -251,6 +454,6 @@ esp_err_t network_get_mixer_state(network_mixer_status_t *out) {
     if (!out) {
         return ESP_ERR_INVALID_ARG;
     }
-    *out = s_mixer;
+    *out = mixer_snapshot();
     return ESP_OK;
 }
@@ -3,7 +3,13 @@
 #include "network/mesh_net.h"
 
 #include <esp_err.h>
+#include <esp_mesh.h>
+#include <stddef.h>
+#include <stdint.h>
 
+esp_err_t mesh_mixer_init(void);
 void mesh_mixer_request_sync_from_root(void);
-esp_err_t mesh_mixer_publish_sync(mixer_ctrl_subtype_t subtype);
-void mesh_mixer_handle_control(const mixer_ctrl_message_t *msg);
+void mesh_mixer_handle_control(const mesh_addr_t *from, const mixer_ctrl_message_t *msg);
+void mesh_mixer_handle_delta(const uint8_t *data, size_t len);
+// Root: sends a version beacon every MIXER_VERSION_BEACON_MS.
+void mesh_mixer_beacon_tick(int64_t now_us);
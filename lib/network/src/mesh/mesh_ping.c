@@ -41,62 +41,43 @@ static void send_pong(const mesh_addr_t *dest, uint32_t ping_id) {
         }
         err = esp_mesh_send(root_addr, &mesh_data, MESH_DATA_P2P, NULL, 0);
     }
-    ESP_LOGI(TAG, "PONG sent (root=%d, id=%lu): %s", is_mesh_root, ping_id, esp_err_to_name(err));
+    ESP_LOGD(TAG, "PONG sent (root=%d, id=%lu): %s", is_mesh_root, ping_id, esp_err_to_name(err));
 }
 
 void mesh_ping_handle_ping(const mesh_addr_t *from, const mesh_ping_t *ping) {
     uint32_t id = ntohl(ping->ping_id);
-    ESP_LOGI(TAG, "PING from " MACSTR " id=%lu (root=%d)", MAC2STR(from->addr), id, is_mesh_root);
+    ESP_LOGD(TAG, "PING from " MACSTR " id=%lu (root=%d)", MAC2STR(from->addr), id, is_mesh_root);
     send_pong(from, id);
 }
 
-void mesh_ping_handle_pong(const mesh_ping_t *pong) {
-    int64_t now_us = esp_timer_get_time();
-    uint32_t id = ntohl(pong->ping_id);
+// Latency consumers read a one-way estimate from the window median, so one
+// delayed pong no longer swings the jitter prefill or retransmit deadlines.
+static uint32_t one_way_ms_from_window(const network_rtt_window_t *window) {
+    return (network_rtt_window_quantile(window, 50) + 1000) / 2000;
+}
 
-    if (ping_pending && id == pending_ping_id) {
-        int64_t rtt_us = now_us - last_ping_sent_us;
-        measured_latency_ms = (uint32_t)(rtt_us / 2000);
-        ping_pending = false;
-        ESP_LOGI(TAG, "Ping RTT: %lld us → %lu ms", rtt_us, measured_latency_ms);
-    } else if (child_ping_pending && id == pending_child_ping_id) {
-        int64_t rtt_us = now_us - last_child_ping_sent_us;
-        nearest_child_latency_ms = (uint32_t)(rtt_us / 2000);
-        child_ping_pending = false;
-        ESP_LOGI(TAG, "Child RTT: %lld us → %lu ms", rtt_us, nearest_child_latency_ms);
-    } else {
-        ESP_LOGW(TAG, "PONG unmatched id=%lu (expect ping=%lu child=%lu)", id, pending_ping_id, pending_child_ping_id);
-    }
+// Caller holds mesh_link_lock.
+static void expire_pings_locked(int64_t now_us) {
+    size_t expired = network_ping_tracker_expire(&g_ping_tracker, now_us, (int64_t)MESH_PING_TIMEOUT_MS * 1000);
+    NET_STAT_ADD(ping_timeouts, (uint32_t)expired);
 }
 
-esp_err_t network_send_ping(void) {
-    if (is_mesh_root || !is_mesh_connected) {
-        return ESP_ERR_INVALID_STATE;
-    }
-    if (!mesh_state_has_root_addr()) {
+static esp_err_t send_ping_to(const mesh_addr_t *dest, network_ping_direction_t direction) {
+    int64_t now_us = esp_timer_get_time();
+    mesh_link_lock();
+    expire_pings_locked(now_us);
+    uint32_t id = network_ping_tracker_start(&g_ping_tracker, direction, dest ? dest->addr : NULL, now_us);
+    mesh_link_unlock();
+    if (id == 0) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (ping_pending) {
-        int64_t elapsed_us = esp_timer_get_time() - last_ping_sent_us;
-        if (elapsed_us > 2000000) {
-            ping_pending = false;
-        } else {
-            return ESP_ERR_INVALID_STATE;
-        }
-    }
-
-    ping_seq++;
-    pending_ping_id = ping_seq;
-
     mesh_ping_t ping;
     ping.type = NET_PKT_TYPE_PING;
     ping.reserved[0] = 0;
     ping.reserved[1] = 0;
     ping.reserved[2] = 0;
-    ping.ping_id = htonl(ping_seq);
-
-    last_ping_sent_us = esp_timer_get_time();
+    ping.ping_id = htonl(id);
 
     mesh_data_t mesh_data = {
         .data = (uint8_t *)&ping,
@@ -105,30 +86,65 @@ esp_err_t network_send_ping(void) {
         .tos = MESH_TOS_DEF,
     };
 
-    ping_pending = true;
-    esp_err_t err = esp_mesh_send(NULL, &mesh_data, MESH_DATA_TODS | MESH_DATA_NONBLOCK, NULL, 0);
+    esp_err_t err;
+    if (direction == NETWORK_PING_UPSTREAM) {
+        err = esp_mesh_send(NULL, &mesh_data, MESH_DATA_TODS | MESH_DATA_NONBLOCK, NULL, 0);
+    } else {
+        err = esp_mesh_send(dest, &mesh_data, MESH_DATA_P2P | MESH_DATA_NONBLOCK, NULL, 0);
+    }
     if (err != ESP_OK) {
-        ping_pending = false;
-        ESP_LOGW(TAG, "Ping send failed: %s", esp_err_to_name(err));
+        mesh_link_lock();
+        network_ping_tracker_cancel(&g_ping_tracker, id);
+        mesh_link_unlock();
+        ESP_LOGD(TAG, "Ping send failed (dir=%d): %s", (int)direction, esp_err_to_name(err));
     } else {
-        ESP_LOGI(TAG, "PING sent to root id=%lu", ping_seq);
+        ESP_LOGD(TAG, "PING sent dir=%d id=%lu", (int)direction, id);
     }
-
     return err;
 }
 
-esp_err_t network_ping_nearest_child(void) {
-    if (!is_mesh_root) {
+void mesh_ping_handle_pong(const mesh_addr_t *from, const mesh_ping_t *pong) {
+    int64_t now_us = esp_timer_get_time();
+    uint32_t id = ntohl(pong->ping_id);
+    uint32_t rtt_us = 0;
+    network_ping_slot_t slot;
+
+    mesh_link_lock();
+    if (!network_ping_tracker_complete(&g_ping_tracker, id, now_us, &rtt_us, &slot)) {
+        mesh_link_unlock();
+        ESP_LOGD(TAG, "PONG unmatched id=%lu from " MACSTR " (late or duplicate)", id, MAC2STR(from->addr));
+        return;
+    }
+    if (slot.direction == NETWORK_PING_UPSTREAM) {
+        network_rtt_window_add(&g_rtt_upstream, rtt_us);
+        measured_latency_ms = one_way_ms_from_window(&g_rtt_upstream);
+    } else {
+        network_rtt_window_add(&g_rtt_downstream, rtt_us);
+        nearest_child_latency_ms = one_way_ms_from_window(&g_rtt_downstream);
+        network_link_table_record_rtt(&g_link_table, slot.mac, rtt_us, now_us / 1000);
+    }
+    mesh_link_unlock();
+
+    if (slot.direction == NETWORK_PING_UPSTREAM) {
+        ESP_LOGD(TAG, "Ping RTT: %lu us (p50=%lu ms)", rtt_us, measured_latency_ms * 2);
+    } else {
+        ESP_LOGD(TAG, "Child RTT " MACSTR ": %lu us", MAC2STR(slot.mac), rtt_us);
+    }
+}
+
+esp_err_t network_send_ping(void) {
+    if (is_mesh_root || !is_mesh_connected) {
         return ESP_ERR_INVALID_STATE;
     }
+    if (!mesh_state_has_root_addr()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return send_ping_to(NULL, NETWORK_PING_UPSTREAM);
+}
 
-    if (child_ping_pending) {
-        int64_t elapsed_us = esp_timer_get_time() - last_child_ping_sent_us;
-        if (elapsed_us > 2000000) {
-            child_ping_pending = false;
-        } else {
-            return ESP_ERR_INVALID_STATE;
-        }
+esp_err_t network_ping_nearest_child(void) {
+    if (!is_mesh_root) {
+        return ESP_ERR_INVALID_STATE;
     }
 
     mesh_addr_t route_table[MESH_ROUTE_TABLE_SIZE];
@@ -145,34 +161,42 @@ esp_err_t network_ping_nearest_child(void) {
     if (!target) {
         return ESP_ERR_NOT_FOUND;
     }
+    return send_ping_to(target, NETWORK_PING_DOWNSTREAM);
+}
 
-    child_ping_seq++;
-    pending_child_ping_id = child_ping_seq;
-
-    mesh_ping_t ping;
-    ping.type = NET_PKT_TYPE_PING;
-    ping.reserved[0] = 0;
-    ping.reserved[1] = 0;
-    ping.reserved[2] = 0;
-    ping.ping_id = htonl(child_ping_seq);
-
-    last_child_ping_sent_us = esp_timer_get_time();
-
-    mesh_data_t mesh_data = {
-        .data = (uint8_t *)&ping,
-        .size = sizeof(ping),
-        .proto = MESH_PROTO_BIN,
-        .tos = MESH_TOS_DEF,
-    };
+// Root: one child per tick, round-robin over the link table so every child
+// heard from recently is sampled. The MAC is copied out under the lock.
+static esp_err_t ping_next_child(void) {
+    static uint16_t cursor = 0;
+    mesh_addr_t target;
+    bool found = false;
+
+    mesh_link_lock();
+    for (uint16_t n = 0; n < MESH_LINK_TABLE_CAPACITY && !found; n++) {
+        uint16_t index = (uint16_t)((cursor + n) & (MESH_LINK_TABLE_CAPACITY - 1));
+        const network_link_entry_t *entry = &g_link_table.slots[index];
+        if (entry->state != NETWORK_LINK_SLOT_USED) {
+            continue;
+        }
+        cursor = (uint16_t)((index + 1) & (MESH_LINK_TABLE_CAPACITY - 1));
+        memcpy(target.addr, entry->mac, 6);
+        found = true;
+    }
+    mesh_link_unlock();
+    if (!found) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return send_ping_to(&target, NETWORK_PING_DOWNSTREAM);
+}
 
-    child_ping_pending = true;
-    esp_err_t err = esp_mesh_send(target, &mesh_data, MESH_DATA_P2P, NULL, 0);
-    if (err != ESP_OK) {
-        child_ping_pending = false;
-        ESP_LOGW(TAG, "Child ping failed: %s", esp_err_to_name(err));
+void mesh_ping_service_tick(void) {
+    if (is_mesh_root) {
+        ping_next_child();
+    } else if (is_mesh_connected && mesh_state_has_root_addr()) {
+        send_ping_to(NULL, NETWORK_PING_UPSTREAM);
     } else {
-        ESP_LOGI(TAG, "PING sent to child id=%lu", child_ping_seq);
+        mesh_link_lock();
+        expire_pings_locked(esp_timer_get_time());
+        mesh_link_unlock();
     }
-
-    return err;
 }
@@ -4,6 +4,10 @@
 #include "network/mesh_net.h"
 
 void mesh_ping_handle_ping(const mesh_addr_t *from, const mesh_ping_t *ping);
-void mesh_ping_handle_pong(const mesh_ping_t *pong);
+void mesh_ping_handle_pong(const mesh_addr_t *from, const mesh_ping_t *pong);
 esp_err_t network_send_ping(void);
 esp_err_t network_ping_nearest_child(void);
+
+// Called every MESH_PING_INTERVAL_MS: upstream ping on non-root nodes,
+// next child on the root. Timed-out pings are counted in transport stats.
+void mesh_ping_service_tick(void);
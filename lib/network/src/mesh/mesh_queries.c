@@ -1,5 +1,6 @@
 #include "mesh/mesh_queries.h"
 #include "mesh/mesh_state.h"
+#include "network/packet_pool.h"
 #include "config/build.h"
 #include <esp_log.h>
 #include <esp_mesh.h>
@@ -105,13 +106,13 @@ bool network_rejoin_allowed(void) {
 
 esp_err_t network_trigger_rejoin(void) {
     if (is_mesh_root) {
-        g_transport_stats.rejoin_blocked_events++;
+        NET_STAT_INC(rejoin_blocked_events);
         return ESP_ERR_INVALID_STATE;
     }
 
     uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
     if (now_ms < rejoin_cooldown_until_ms) {
-        g_transport_stats.rejoin_blocked_events++;
+        NET_STAT_INC(rejoin_blocked_events);
         ESP_LOGW(TAG, "Rejoin blocked by cooldown (%lums remaining)",
                  (unsigned long)(rejoin_cooldown_until_ms - now_ms));
         return ESP_ERR_INVALID_STATE;
@@ -121,14 +122,14 @@ esp_err_t network_trigger_rejoin(void) {
         rejoin_attempt_count = 0;
     }
     if (rejoin_attempt_count >= OUT_REJOIN_MAX_ATTEMPTS) {
-        g_transport_stats.rejoin_circuit_breaker_events++;
+        NET_STAT_INC(rejoin_circuit_breaker_events);
         rejoin_cooldown_until_ms = now_ms + OUT_REJOIN_COOLDOWN_MS;
         ESP_LOGW(TAG, "Rejoin circuit breaker tripped (attempts=%lu, cooldown=%lums)",
                  (unsigned long)rejoin_attempt_count, (unsigned long)OUT_REJOIN_COOLDOWN_MS);
         return ESP_ERR_INVALID_STATE;
     }
     rejoin_attempt_count++;
-    g_transport_stats.rejoin_trigger_events++;
+    NET_STAT_INC(rejoin_trigger_events);
 
     ESP_LOGW(TAG, "Triggering OUT rejoin: disconnect + reconnect");
     mesh_state_clear_root_addr();
@@ -159,12 +160,42 @@ uint32_t network_get_tx_bytes_and_reset(void) {
     return bytes;
 }
 
+static void fill_packet_pool_stats(network_transport_stats_t *out_stats)
+{
+    network_pkt_pool_stats_t pool;
+    network_pkt_pool_get_stats(&pool);
+    out_stats->pkt_pool_in_use = pool.in_use;
+    out_stats->pkt_pool_high_water = pool.high_water;
+    out_stats->pkt_pool_exhausted = pool.exhausted;
+}
+
+// RTT windows are sliding, so they are reported as-is and not cleared on reset.
+static void fill_rtt_stats(network_transport_stats_t *out_stats)
+{
+    network_rtt_summary_t up;
+    network_rtt_summary_t down;
+    mesh_link_lock();
+    network_rtt_window_summary(&g_rtt_upstream, &up);
+    network_rtt_window_summary(&g_rtt_downstream, &down);
+    mesh_link_unlock();
+    out_stats->rtt_up_samples = up.samples;
+    out_stats->rtt_up_min_us = up.min_us;
+    out_stats->rtt_up_p50_us = up.p50_us;
+    out_stats->rtt_up_p95_us = up.p95_us;
+    out_stats->rtt_down_samples = down.samples;
+    out_stats->rtt_down_min_us = down.min_us;
+    out_stats->rtt_down_p50_us = down.p50_us;
+    out_stats->rtt_down_p95_us = down.p95_us;
+}
+
 esp_err_t network_get_transport_stats(network_transport_stats_t *out_stats)
 {
     if (!out_stats) {
         return ESP_ERR_INVALID_ARG;
     }
-    *out_stats = g_transport_stats;
+    network_stat_snapshot(&g_transport_counters, (uint32_t *)out_stats);
+    fill_packet_pool_stats(out_stats);
+    fill_rtt_stats(out_stats);
     return ESP_OK;
 }
 
@@ -173,11 +204,39 @@ esp_err_t network_get_transport_stats_and_reset(network_transport_stats_t *out_s
     if (!out_stats) {
         return ESP_ERR_INVALID_ARG;
     }
-    *out_stats = g_transport_stats;
-    g_transport_stats = (network_transport_stats_t){0};
+    network_stat_snapshot_and_reset(&g_transport_counters, (uint32_t *)out_stats);
+    fill_packet_pool_stats(out_stats);
+    fill_rtt_stats(out_stats);
+    network_pkt_pool_reset_stats();
     return ESP_OK;
 }
 
+static uint32_t transport_rate_last[NETWORK_TRANSPORT_STAT_WORDS];
+static network_stat_rate_t transport_rate_values[NETWORK_TRANSPORT_STAT_WORDS];
+static network_stat_rates_t transport_rates = NETWORK_STAT_RATES_INITIALIZER(
+    transport_rate_last, transport_rate_values, NETWORK_TRANSPORT_STAT_WORDS);
+
+void mesh_queries_stats_tick(int64_t now_us)
+{
+    // Callers wake roughly once per tick; half a tick of slack keeps a slightly
+    // early wakeup from stretching the 1 s window to 2 s.
+    if (transport_rates.primed &&
+        (now_us - transport_rates.last_us) < (int64_t)STAT_RATE_TICK_MS * 500) {
+        return;
+    }
+    uint32_t totals[NETWORK_TRANSPORT_STAT_WORDS];
+    network_stat_totals(&g_transport_counters, totals);
+    network_stat_rates_update(&transport_rates, totals, now_us);
+}
+
+esp_err_t network_get_transport_rate(size_t stat, network_stat_rate_t *out_rate)
+{
+    if (!out_rate || stat >= NETWORK_TRANSPORT_STAT_WORDS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return network_stat_rates_get(&transport_rates, stat, out_rate) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
 int network_get_nearest_child_rssi(void) {
     if (!is_mesh_root) return -100;
 
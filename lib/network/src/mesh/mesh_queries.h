@@ -19,3 +19,5 @@ uint32_t network_get_connected_nodes(void);
 uint32_t network_get_tx_bytes_and_reset(void);
 int network_get_nearest_child_rssi(void);
 uint32_t network_get_nearest_child_latency_ms(void);
+// Samples transport counters for network_get_transport_rate(); call about every STAT_RATE_TICK_MS.
+void mesh_queries_stats_tick(int64_t now_us);
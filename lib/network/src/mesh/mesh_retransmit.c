@@ -0,0 +1,143 @@
+#include "mesh/mesh_retransmit.h"
+#include <arpa/inet.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static mesh_retx_entry_t retx_cache[MESH_RETX_CACHE_SLOTS];
+static int retx_index = 0;
+static SemaphoreHandle_t retx_mutex = NULL;
+
+esp_err_t mesh_retx_cache_init(void) {
+    if (!retx_mutex) {
+        retx_mutex = xSemaphoreCreateMutex();
+        if (!retx_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    mesh_retx_cache_reset();
+    return ESP_OK;
+}
+
+void mesh_retx_cache_reset(void) {
+    if (!retx_mutex) {
+        return;
+    }
+    xSemaphoreTake(retx_mutex, portMAX_DELAY);
+    for (int i = 0; i < MESH_RETX_CACHE_SLOTS; i++) {
+        if (retx_cache[i].valid) {
+            network_pkt_release(retx_cache[i].buf);
+        }
+    }
+    memset(retx_cache, 0, sizeof(retx_cache));
+    retx_index = 0;
+    xSemaphoreGive(retx_mutex);
+}
+
+bool mesh_retx_cache_store(network_pkt_buf_t *buf, uint8_t stream_id,
+                           uint16_t base_seq, uint8_t frame_count, int64_t now_us) {
+    if (!retx_mutex || !buf || buf->len == 0 || buf->len > MAX_PACKET_SIZE) {
+        return false;
+    }
+
+    network_pkt_retain(buf);
+    xSemaphoreTake(retx_mutex, portMAX_DELAY);
+    // Oldest slot is overwritten; the ring only needs to cover the playout budget.
+    mesh_retx_entry_t *entry = &retx_cache[retx_index];
+    network_pkt_buf_t *evicted = entry->valid ? entry->buf : NULL;
+    entry->valid = true;
+    entry->stream_id = stream_id;
+    entry->base_seq = base_seq;
+    entry->frame_count = frame_count > 0 ? frame_count : 1;
+    entry->sent_us = now_us;
+    entry->buf = buf;
+    retx_index = (retx_index + 1) % MESH_RETX_CACHE_SLOTS;
+    xSemaphoreGive(retx_mutex);
+    // A retransmit may still hold the evicted buffer; it goes back to the pool
+    // with the last reference.
+    network_pkt_release(evicted);
+    return true;
+}
+
+bool mesh_retx_cache_acquire(uint8_t stream_id, uint16_t seq, mesh_retx_entry_t *out) {
+    if (!retx_mutex || !out) {
+        return false;
+    }
+    bool found = false;
+    xSemaphoreTake(retx_mutex, portMAX_DELAY);
+    for (int i = 0; i < MESH_RETX_CACHE_SLOTS; i++) {
+        const mesh_retx_entry_t *entry = &retx_cache[i];
+        if (!entry->valid || entry->stream_id != stream_id) {
+            continue;
+        }
+        uint16_t offset = (uint16_t)(seq - entry->base_seq);
+        if (offset < entry->frame_count) {
+            *out = *entry;
+            network_pkt_retain(out->buf);
+            found = true;
+            break;
+        }
+    }
+    xSemaphoreGive(retx_mutex);
+    return found;
+}
+
+bool mesh_retx_deadline_ok(int64_t sent_us, int64_t now_us, uint32_t one_way_ms, uint32_t budget_ms) {
+    if (now_us < sent_us) {
+        return false;
+    }
+    int64_t arrival_us = now_us + (int64_t)one_way_ms * 1000;
+    int64_t deadline_us = sent_us + (int64_t)budget_ms * 1000;
+    return arrival_us <= deadline_us;
+}
+
+bool mesh_retx_rate_allow(mesh_retx_rate_limiter_t *limiter, int64_t now_us,
+                          uint32_t window_ms, uint32_t max_per_window) {
+    if (!limiter) {
+        return false;
+    }
+    int64_t window_us = (int64_t)window_ms * 1000;
+    if (limiter->window_start_us == 0 || (now_us - limiter->window_start_us) >= window_us) {
+        limiter->window_start_us = now_us;
+        limiter->count = 0;
+    }
+    if (limiter->count >= max_per_window) {
+        return false;
+    }
+    limiter->count++;
+    return true;
+}
+
+bool mesh_nack_build(uint8_t stream_id, uint16_t first_missing, uint16_t missing_count, mesh_nack_t *out) {
+    if (!out || missing_count == 0 || missing_count > MESH_NACK_MAX_GAP_FRAMES) {
+        return false;
+    }
+
+    uint32_t bitmap = 0;
+    for (uint16_t i = 1; i < missing_count; i++) {
+        bitmap |= (1UL << (i - 1));
+    }
+
+    out->type = NET_PKT_TYPE_NACK;
+    out->stream_id = stream_id;
+    out->base_seq = htons(first_missing);
+    out->bitmap = htonl(bitmap);
+    return true;
+}
+
+size_t mesh_nack_expand(const mesh_nack_t *nack, uint16_t *seqs_out, size_t max_seqs) {
+    if (!nack || !seqs_out || max_seqs == 0 || nack->type != NET_PKT_TYPE_NACK) {
+        return 0;
+    }
+
+    uint16_t base_seq = ntohs(nack->base_seq);
+    uint32_t bitmap = ntohl(nack->bitmap);
+    size_t count = 0;
+    seqs_out[count++] = base_seq;
+    for (uint16_t bit = 0; bit < 32 && count < max_seqs; bit++) {
+        if (bitmap & (1UL << bit)) {
+            seqs_out[count++] = (uint16_t)(base_seq + 1 + bit);
+        }
+    }
+    return count;
+}
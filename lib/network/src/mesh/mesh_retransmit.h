@@ -0,0 +1,44 @@
+#pragma once
+
+#include "network/mesh_net.h"
+#include "network/packet_pool.h"
+#include "config/build.h"
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Root-side cache of recently sent audio packets, looked up by sequence number
+// when an OUT node NACKs a gap. Entries hold a pool reference to the sent buffer
+// rather than a copy.
+
+typedef struct {
+    bool valid;
+    uint8_t stream_id;
+    uint16_t base_seq;
+    uint8_t frame_count;
+    int64_t sent_us;
+    network_pkt_buf_t *buf;
+} mesh_retx_entry_t;
+
+typedef struct {
+    int64_t window_start_us;
+    uint32_t count;
+} mesh_retx_rate_limiter_t;
+
+// The encode task stores and the RX task acquires, so the cache is locked;
+// both fail until mesh_retx_cache_init has run.
+esp_err_t mesh_retx_cache_init(void);
+void mesh_retx_cache_reset(void);
+bool mesh_retx_cache_store(network_pkt_buf_t *buf, uint8_t stream_id,
+                           uint16_t base_seq, uint8_t frame_count, int64_t now_us);
+// Copies the entry covering seq into *out with its buffer already retained;
+// the caller releases out->buf.
+bool mesh_retx_cache_acquire(uint8_t stream_id, uint16_t seq, mesh_retx_entry_t *out);
+
+bool mesh_retx_deadline_ok(int64_t sent_us, int64_t now_us, uint32_t one_way_ms, uint32_t budget_ms);
+bool mesh_retx_rate_allow(mesh_retx_rate_limiter_t *limiter, int64_t now_us,
+                          uint32_t window_ms, uint32_t max_per_window);
+
+bool mesh_nack_build(uint8_t stream_id, uint16_t first_missing, uint16_t missing_count, mesh_nack_t *out);
+size_t mesh_nack_expand(const mesh_nack_t *nack, uint16_t *seqs_out, size_t max_seqs);
@@ -4,99 +4,254 @@
 #include "mesh/mesh_ping.h"
 #include "mesh/mesh_uplink.h"
 #include "mesh/mesh_mixer.h"
+#include "mesh/mesh_retransmit.h"
+#include "mesh/mesh_tx.h"
+#include "mesh/mesh_coalesce.h"
+#include "mesh/mesh_transport.h"
 #include "network/uplink_control.h"
 #include "control/portal_state.h"
 #include "network/mixer_control.h"
 #include "network/frame_codec.h"
+#include "network/packet_pool.h"
+#include "network/control_bundle.h"
 #include "network/mesh_net.h"
+#include "network/transport.h"
 #include "config/build.h"
 #include <esp_timer.h>
 #include <esp_log.h>
 #include <esp_mesh.h>
+#include <stddef.h>
 #include <string.h>
 
 static const char *TAG = "network_mesh";
 
 static void mesh_rx_log_observability_snapshot(void)
 {
+    network_pkt_pool_stats_t pool;
+    network_pkt_pool_get_stats(&pool);
+    network_transport_stats_t stats;
+    network_get_transport_stats(&stats);
     ESP_LOGI(TAG,
-             "RX OBS: audio=%lu fwd=%lu dup=%lu ttl0=%lu inv={hdr:%lu ver:%lu pay:%lu} "
+             "RX OBS: audio=%lu fwd=%lu dup=%lu ttl0=%lu inv={hdr:%lu ver:%lu pay:%lu} unanch=%lu "
              "batch={pkts:%lu frames:%lu} cb_miss=%lu recv={err:%lu empty:%lu} "
              "burst_loss=%lu burst_max=%lu jitter_us=%lu ctrl={hb:%lu ctl:%lu ping:%lu pong:%lu ann:%lu} "
-             "churn={pc:%lu pd:%lu np:%lu sc:%lu rj:%lu/%lu/%lu}",
-             (unsigned long)g_transport_stats.rx_audio_packets,
-             (unsigned long)g_transport_stats.rx_audio_forwarded,
-             (unsigned long)g_transport_stats.rx_audio_duplicates,
-             (unsigned long)g_transport_stats.rx_audio_ttl_expired,
-             (unsigned long)g_transport_stats.rx_audio_invalid_header,
-             (unsigned long)g_transport_stats.rx_audio_invalid_version,
-             (unsigned long)g_transport_stats.rx_audio_invalid_payload,
-             (unsigned long)g_transport_stats.rx_audio_batches,
-             (unsigned long)g_transport_stats.rx_audio_batch_frames,
-             (unsigned long)g_transport_stats.rx_audio_callback_missing,
-             (unsigned long)g_transport_stats.mesh_recv_errors,
-             (unsigned long)g_transport_stats.mesh_recv_empty_packets,
-             (unsigned long)g_transport_stats.rx_audio_burst_loss_events,
-             (unsigned long)g_transport_stats.rx_audio_burst_loss_max,
-             (unsigned long)g_transport_stats.rx_audio_interarrival_jitter_us,
-             (unsigned long)g_transport_stats.rx_heartbeat_packets,
-             (unsigned long)g_transport_stats.rx_control_packets,
-             (unsigned long)g_transport_stats.rx_ping_packets,
-             (unsigned long)g_transport_stats.rx_pong_packets,
-             (unsigned long)g_transport_stats.rx_stream_announce_packets,
-             (unsigned long)g_transport_stats.parent_connect_events,
-             (unsigned long)g_transport_stats.parent_disconnect_events,
-             (unsigned long)g_transport_stats.no_parent_events,
-             (unsigned long)g_transport_stats.scan_done_events,
-             (unsigned long)g_transport_stats.rejoin_trigger_events,
-             (unsigned long)g_transport_stats.rejoin_blocked_events,
-             (unsigned long)g_transport_stats.rejoin_circuit_breaker_events);
+             "churn={pc:%lu pd:%lu np:%lu sc:%lu rj:%lu/%lu/%lu} pool={use:%lu hw:%lu ex:%lu}",
+             (unsigned long)stats.rx_audio_packets,
+             (unsigned long)stats.rx_audio_forwarded,
+             (unsigned long)stats.rx_audio_duplicates,
+             (unsigned long)stats.rx_audio_ttl_expired,
+             (unsigned long)stats.rx_audio_invalid_header,
+             (unsigned long)stats.rx_audio_invalid_version,
+             (unsigned long)stats.rx_audio_invalid_payload,
+             (unsigned long)stats.rx_audio_unanchored,
+             (unsigned long)stats.rx_audio_batches,
+             (unsigned long)stats.rx_audio_batch_frames,
+             (unsigned long)stats.rx_audio_callback_missing,
+             (unsigned long)stats.mesh_recv_errors,
+             (unsigned long)stats.mesh_recv_empty_packets,
+             (unsigned long)stats.rx_audio_burst_loss_events,
+             (unsigned long)stats.rx_audio_burst_loss_max,
+             (unsigned long)stats.rx_audio_interarrival_jitter_us,
+             (unsigned long)stats.rx_heartbeat_packets,
+             (unsigned long)stats.rx_control_packets,
+             (unsigned long)stats.rx_ping_packets,
+             (unsigned long)stats.rx_pong_packets,
+             (unsigned long)stats.rx_stream_announce_packets,
+             (unsigned long)stats.parent_connect_events,
+             (unsigned long)stats.parent_disconnect_events,
+             (unsigned long)stats.no_parent_events,
+             (unsigned long)stats.scan_done_events,
+             (unsigned long)stats.rejoin_trigger_events,
+             (unsigned long)stats.rejoin_blocked_events,
+             (unsigned long)stats.rejoin_circuit_breaker_events,
+             (unsigned long)pool.in_use,
+             (unsigned long)pool.high_water,
+             (unsigned long)pool.exhausted);
 }
 
-static void mesh_rx_update_audio_loss_and_jitter(uint16_t seq,
+static void mesh_rx_request_retransmit(uint8_t stream_id, uint16_t first_missing, uint32_t missing_frames)
+{
+    static mesh_retx_rate_limiter_t nack_limiter = {0};
+
+    if (is_mesh_root || my_node_role != NODE_ROLE_OUT || missing_frames > MESH_NACK_MAX_GAP_FRAMES) {
+        return;
+    }
+    if (!mesh_retx_rate_allow(&nack_limiter, esp_timer_get_time(),
+                              MESH_NACK_RATE_WINDOW_MS, MESH_NACK_MAX_PER_WINDOW)) {
+        NET_STAT_INC(tx_nack_rate_limited);
+        return;
+    }
+
+    mesh_nack_t nack;
+    if (!mesh_nack_build(stream_id, first_missing, (uint16_t)missing_frames, &nack)) {
+        return;
+    }
+    // NACKs race the playout deadline, so they skip control coalescing.
+    if (network_transport_send_control(NULL, (const uint8_t *)&nack, sizeof(nack)) == ESP_OK) {
+        NET_STAT_INC(tx_nack_packets);
+    }
+}
+
+static void mesh_rx_handle_nack(const mesh_addr_t *from, const mesh_nack_t *nack)
+{
+    static mesh_retx_rate_limiter_t retx_limiter = {0};
+
+    if (!is_mesh_root) {
+        return;
+    }
+
+    uint16_t seqs[MESH_NACK_MAX_GAP_FRAMES];
+    size_t count = mesh_nack_expand(nack, seqs, MESH_NACK_MAX_GAP_FRAMES);
+    mesh_tx_fanout_record_loss((uint16_t)count);
+    int64_t now_us = esp_timer_get_time();
+    // Prefer the NACKing child's own smoothed RTT over the aggregate child estimate.
+    uint32_t one_way_ms = MESH_RETX_DEFAULT_ONE_WAY_MS;
+    mesh_link_lock();
+    network_link_table_record_loss(&g_link_table, from->addr, (uint32_t)count, now_us / 1000);
+    const network_link_entry_t *link = network_link_table_find(&g_link_table, from->addr);
+    if (link && link->rtt_samples > 0) {
+        one_way_ms = (link->rtt_avg_us + 1000) / 2000;
+    } else if (nearest_child_latency_ms > 0) {
+        one_way_ms = nearest_child_latency_ms;
+    }
+    mesh_link_unlock();
+    bool have_last = false;
+    uint16_t last_base_seq = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        mesh_retx_entry_t entry;
+        if (!mesh_retx_cache_acquire(nack->stream_id, seqs[i], &entry)) {
+            NET_STAT_INC(tx_retransmit_cache_miss);
+            continue;
+        }
+        // Batched packets cover several sequences; resend each packet once.
+        if (have_last && entry.base_seq == last_base_seq) {
+            network_pkt_release(entry.buf);
+            continue;
+        }
+        have_last = true;
+        last_base_seq = entry.base_seq;
+
+        if (!mesh_retx_deadline_ok(entry.sent_us, now_us, one_way_ms, MESH_RETX_PLAYOUT_BUDGET_MS)) {
+            NET_STAT_INC(tx_retransmit_deadline_miss);
+        } else if (!mesh_retx_rate_allow(&retx_limiter, now_us, MESH_RETX_RATE_WINDOW_MS, MESH_RETX_MAX_PER_WINDOW)) {
+            NET_STAT_INC(tx_retransmit_rate_limited);
+        } else {
+            network_retransmit_audio(from, entry.buf->data, entry.buf->len);
+        }
+        network_pkt_release(entry.buf);
+    }
+}
+
+// v2 headers carry only stream_id; src_id and the seq/timestamp anchor come from
+// STREAM_ANNOUNCE (or from v1 headers, which still carry src_id inline).
+typedef struct {
+    bool used;
+    uint8_t stream_id;
+    char src_id[NETWORK_SRC_ID_LEN + 1];
+    network_frame_ref_t ref;
+    // Loss/jitter baseline; each stream's gaps are NACKed against its own.
+    bool seq_valid;
+    uint16_t expected_next_seq;
+    uint64_t last_arrival_us;
+    uint32_t last_sender_timestamp_ms;
+} mesh_rx_stream_t;
+
+static mesh_rx_stream_t rx_streams[NET_FRAME_V2_MAX_STREAMS];
+static int rx_stream_next_evict = 0;
+
+static mesh_rx_stream_t *mesh_rx_stream_find(uint8_t stream_id)
+{
+    for (int i = 0; i < NET_FRAME_V2_MAX_STREAMS; i++) {
+        if (rx_streams[i].used && rx_streams[i].stream_id == stream_id) {
+            return &rx_streams[i];
+        }
+    }
+    return NULL;
+}
+
+// Finds or claims a slot; only called for an announce or a decoded, anchored header.
+static mesh_rx_stream_t *mesh_rx_stream_lookup(uint8_t stream_id)
+{
+    mesh_rx_stream_t *found = mesh_rx_stream_find(stream_id);
+    if (found) {
+        return found;
+    }
+    mesh_rx_stream_t *free_slot = NULL;
+    for (int i = 0; i < NET_FRAME_V2_MAX_STREAMS; i++) {
+        if (!rx_streams[i].used) {
+            free_slot = &rx_streams[i];
+            break;
+        }
+    }
+    if (!free_slot) {
+        free_slot = &rx_streams[rx_stream_next_evict];
+        rx_stream_next_evict = (rx_stream_next_evict + 1) % NET_FRAME_V2_MAX_STREAMS;
+    }
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->used = true;
+    free_slot->stream_id = stream_id;
+    return free_slot;
+}
+
+static void mesh_rx_stream_set_src_id(mesh_rx_stream_t *stream, const char *src_id)
+{
+    memcpy(stream->src_id, src_id, NETWORK_SRC_ID_LEN);
+    stream->src_id[NETWORK_SRC_ID_LEN] = '\0';
+}
+
+static void mesh_rx_handle_stream_announce(const mesh_stream_announce_t *announce)
+{
+    mesh_rx_stream_t *stream = mesh_rx_stream_lookup(announce->stream_id);
+    mesh_rx_stream_set_src_id(stream, announce->src_id);
+    stream->ref.valid = true;
+    stream->ref.seq = ntohs(announce->seq);
+    stream->ref.timestamp = ntohl(announce->timestamp);
+}
+
+static void mesh_rx_update_audio_loss_and_jitter(mesh_rx_stream_t *stream,
+                                                 uint16_t seq,
                                                  uint8_t frame_count,
                                                  uint32_t sender_timestamp_ms)
 {
-    static bool initialized = false;
-    static uint16_t expected_next_seq = 0;
-    static uint64_t last_arrival_us = 0;
-    static uint32_t last_sender_timestamp_ms = 0;
-
     uint8_t effective_frame_count = frame_count > 0 ? frame_count : 1;
     uint64_t now_us = (uint64_t)esp_timer_get_time();
 
-    if (initialized) {
-        int16_t seq_delta = (int16_t)(seq - expected_next_seq);
+    if (stream->seq_valid) {
+        int16_t seq_delta = (int16_t)(seq - stream->expected_next_seq);
+        if (seq_delta < 0 && (uint16_t)(-seq_delta) <= RX_MAX_STALE_FRAMES_TO_DROP) {
+            // Late or retransmitted packet: keep the baseline where it is.
+            return;
+        }
         if (seq_delta > 0) {
             uint32_t missing_frames = (uint32_t)seq_delta;
             if (missing_frames >= RX_BURST_LOSS_THRESHOLD) {
-                g_transport_stats.rx_audio_burst_loss_events++;
-                if (missing_frames > g_transport_stats.rx_audio_burst_loss_max) {
-                    g_transport_stats.rx_audio_burst_loss_max = missing_frames;
-                }
+                NET_STAT_INC(rx_audio_burst_loss_events);
+                NET_STAT_MAX(rx_audio_burst_loss_max, missing_frames);
             }
+            mesh_rx_request_retransmit(stream->stream_id, stream->expected_next_seq, missing_frames);
         }
 
-        uint64_t arrival_delta_us = now_us - last_arrival_us;
-        uint32_t sender_delta_ms = sender_timestamp_ms - last_sender_timestamp_ms;
+        uint64_t arrival_delta_us = now_us - stream->last_arrival_us;
+        uint32_t sender_delta_ms = sender_timestamp_ms - stream->last_sender_timestamp_ms;
         uint64_t sender_delta_us = (uint64_t)sender_delta_ms * 1000ULL;
         int64_t transit_delta_us = (int64_t)arrival_delta_us - (int64_t)sender_delta_us;
         uint64_t abs_transit_delta_us =
             (transit_delta_us >= 0) ? (uint64_t)transit_delta_us : (uint64_t)(-transit_delta_us);
 
-        int64_t jitter_us = (int64_t)g_transport_stats.rx_audio_interarrival_jitter_us;
+        int64_t jitter_us = (int64_t)NET_STAT_GET(rx_audio_interarrival_jitter_us);
         jitter_us += ((int64_t)abs_transit_delta_us - jitter_us) / 16;
         if (jitter_us < 0) {
             jitter_us = 0;
         }
-        g_transport_stats.rx_audio_interarrival_jitter_us = (uint32_t)jitter_us;
+        NET_STAT_SET(rx_audio_interarrival_jitter_us, (uint32_t)jitter_us);
     } else {
-        initialized = true;
+        stream->seq_valid = true;
     }
 
-    expected_next_seq = (uint16_t)(seq + effective_frame_count);
-    last_arrival_us = now_us;
-    last_sender_timestamp_ms = sender_timestamp_ms;
+    stream->expected_next_seq = (uint16_t)(seq + effective_frame_count);
+    stream->last_arrival_us = now_us;
+    stream->last_sender_timestamp_ms = sender_timestamp_ms;
 }
 
 typedef struct {
@@ -112,203 +267,311 @@ static void on_audio_batch_frame(const uint8_t *frame,
         return;
     }
     audio_batch_callback_ctx_t *batch = (audio_batch_callback_ctx_t *)ctx;
-    g_transport_stats.rx_audio_forwarded++;
+    NET_STAT_INC(rx_audio_forwarded);
     audio_rx_callback(frame, frame_len, frame_seq, batch->timestamp, batch->src_id);
 }
 
-void mesh_rx_task(void *arg) {
-    (void)arg;
-    esp_err_t err;
-    mesh_addr_t from;
-    mesh_data_t data;
-    int flag = 0;
-
-    ESP_LOGI(TAG, "Mesh RX task started");
+// Root: fold a child heartbeat into the link table and re-pick the nearest child
+// (best smoothed RSSI) from it. Returns the number of links.
+static uint16_t mesh_rx_update_child_link(const uint8_t mac[6], const mesh_heartbeat_t *hb)
+{
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    mesh_link_lock();
+    network_link_table_expire(&g_link_table, now_ms, MESH_LINK_STALE_MS);
+    network_link_table_record_heartbeat(&g_link_table, mac, hb->rssi, now_ms);
+    network_link_table_close_loss_interval(&g_link_table, mac,
+                                           total_sent * MESH_FRAMES_PER_PACKET, now_ms);
 
-    while (!is_mesh_root_ready && !is_mesh_connected) {
-        vTaskDelay(pdMS_TO_TICKS(100));
+    network_link_iter_t it;
+    const network_link_entry_t *entry;
+    const network_link_entry_t *best = NULL;
+    network_link_iter_begin(&it, &g_link_table);
+    while ((entry = network_link_iter_next(&it)) != NULL) {
+        if (entry->has_rssi && (!best || entry->rssi_ewma_q4 > best->rssi_ewma_q4)) {
+            best = entry;
+        }
     }
-    ESP_LOGI(TAG, "Mesh RX task: network ready, entering recv loop (root=%d, connected=%d)",
-             is_mesh_root, is_mesh_connected);
+    if (best) {
+        memcpy(nearest_child_addr.addr, best->mac, 6);
+        nearest_child_rssi = network_link_rssi_dbm(best);
+    }
+    uint16_t links = g_link_table.count;
+    mesh_link_unlock();
+    return links;
+}
 
-    while (1) {
-        data.data = mesh_rx_buffer;
-        data.size = MESH_RX_BUFFER_SIZE;
+// Everything except audio. Bundled messages are dispatched through here one by one.
+static void mesh_rx_handle_control_message(const mesh_addr_t *from, const uint8_t *data, size_t size)
+{
+    uint8_t first_byte = data[0];
+
+    if (first_byte == NET_PKT_TYPE_HEARTBEAT) {
+        NET_STAT_INC(rx_heartbeat_packets);
+        
+        // Periodic self-heal: ensure we are still subscribed to the group
+        if (my_node_role == NODE_ROLE_OUT && (NET_STAT_GET(rx_heartbeat_packets) % 5 == 0)) {
+            esp_mesh_set_group_id((mesh_addr_t *)&audio_multicast_group, 1);
+        }
 
-        err = esp_mesh_recv(&from, &data, portMAX_DELAY, &flag, NULL, 0);
+        if (size < sizeof(mesh_heartbeat_t)) {
+            return;
+        }
+        const mesh_heartbeat_t *hb = (const mesh_heartbeat_t *)data;
+        if (esp_mesh_is_root()) {
+            // Keyed by self_mac: heartbeats relayed in a bundle arrive from the relay.
+            uint16_t links = mesh_rx_update_child_link(hb->self_mac, hb);
+            ESP_LOGI(TAG, "Child heartbeat: %s RSSI=%d dBm (nearest=%d links=%u)",
+                     hb->src_id, hb->rssi, nearest_child_rssi, (unsigned)links);
 
-        if (err != ESP_OK) {
-            g_transport_stats.mesh_recv_errors++;
-            if (err == ESP_ERR_MESH_NOT_START) {
-                vTaskDelay(pdMS_TO_TICKS(100));
+            if (heartbeat_rx_callback) {
+                heartbeat_rx_callback(hb->self_mac, hb);
+            }
+        } else {
+            mesh_coalesce_hold_heartbeat(hb);
+        }
+    } else if (first_byte == NET_PKT_TYPE_PING) {
+        NET_STAT_INC(rx_ping_packets);
+        if (size >= sizeof(mesh_ping_t)) {
+            const mesh_ping_t *ping = (const mesh_ping_t *)data;
+            mesh_ping_handle_ping(from, ping);
+        }
+    } else if (first_byte == NET_PKT_TYPE_PONG) {
+        NET_STAT_INC(rx_pong_packets);
+        if (size >= sizeof(mesh_ping_t)) {
+            const mesh_ping_t *pong = (const mesh_ping_t *)data;
+            mesh_ping_handle_pong(from, pong);
+        }
+    } else if (first_byte == NET_PKT_TYPE_NACK) {
+        NET_STAT_INC(rx_nack_packets);
+        if (size >= sizeof(mesh_nack_t)) {
+            mesh_rx_handle_nack(from, (const mesh_nack_t *)data);
+        }
+    } else if (first_byte == NET_PKT_TYPE_STREAM_ANNOUNCE) {
+        NET_STAT_INC(rx_stream_announce_packets);
+        if (size >= sizeof(mesh_stream_announce_t)) {
+            mesh_rx_handle_stream_announce((const mesh_stream_announce_t *)data);
+        }
+        ESP_LOGD(TAG, "Stream announcement received");
+    } else if (first_byte == NET_PKT_TYPE_POSITIONS) {
+        if (size >= 2) {
+            uint8_t count = data[1];
+            if (size >= 2 + count * sizeof(mesh_node_position_t)) {
+                const mesh_node_position_t *pos_list = (const mesh_node_position_t *)&data[2];
+                for (uint8_t i = 0; i < count; i++) {
+                    portal_state_update_position(pos_list[i].mac, pos_list[i].x, pos_list[i].y, pos_list[i].z);
+                }
+            }
+        }
+    } else if (first_byte == NET_PKT_TYPE_CONTROL) {
+        NET_STAT_INC(rx_control_packets);
+        if (size == sizeof(uplink_ctrl_packet_t)) {
+            uplink_ctrl_message_t uplink_msg;
+            if (uplink_ctrl_decode((const uplink_ctrl_packet_t *)data, size, &uplink_msg)) {
+                mesh_uplink_handle_control(&uplink_msg);
             } else {
-                ESP_LOGW(TAG, "Mesh receive error: %s", esp_err_to_name(err));
+                ESP_LOGW(TAG, "Ignoring invalid uplink control packet");
             }
-            continue;
+        } else if (size == sizeof(mixer_ctrl_packet_t)) {
+            mixer_ctrl_message_t mixer_msg;
+            if (mixer_ctrl_decode((const mixer_ctrl_packet_t *)data, size, &mixer_msg)) {
+                mesh_mixer_handle_control(from, &mixer_msg);
+            } else {
+                ESP_LOGW(TAG, "Ignoring invalid mixer control packet");
+            }
+        } else {
+            ESP_LOGW(TAG, "Ignoring unknown control packet size=%u", (unsigned)size);
         }
+    } else if (first_byte == NET_PKT_TYPE_MIXER_DELTA) {
+        NET_STAT_INC(rx_control_packets);
+        mesh_mixer_handle_delta(data, size);
+    }
+}
 
-        if (!data.data || data.size == 0) {
-            g_transport_stats.mesh_recv_empty_packets++;
-            ESP_LOGW(TAG, "Ignoring empty mesh packet");
-            continue;
-        }
+static network_pkt_buf_t *rx_current_packet = NULL;
 
-        uint8_t first_byte = data.data[0];
+network_pkt_buf_t *network_rx_current_packet(void)
+{
+    return rx_current_packet;
+}
 
-        if (first_byte == NET_PKT_TYPE_HEARTBEAT) {
-            g_transport_stats.rx_heartbeat_packets++;
-            
-            // Periodic self-heal: ensure we are still subscribed to the group
-            if (my_node_role == NODE_ROLE_OUT && (g_transport_stats.rx_heartbeat_packets % 5 == 0)) {
-                esp_mesh_set_group_id((mesh_addr_t *)&audio_multicast_group, 1);
-            }
+// One received datagram: control (bundled or not) or audio. The RX task calls
+// this per packet; the native mesh simulator drives it directly.
+void mesh_rx_dispatch(const mesh_addr_t *from, uint8_t *data, size_t size)
+{
+    if (!data || size == 0) {
+        NET_STAT_INC(mesh_recv_empty_packets);
+        ESP_LOGW(TAG, "Ignoring empty mesh packet");
+        return;
+    }
 
-            if (esp_mesh_is_root() && data.size >= sizeof(mesh_heartbeat_t)) {
-                mesh_heartbeat_t *hb = (mesh_heartbeat_t *)data.data;
-                bool same_child = (memcmp(&from, &nearest_child_addr, 6) == 0);
-                bool uninit = (nearest_child_rssi == -100);
-                bool better = (hb->rssi > nearest_child_rssi);
-
-                if (uninit || better) {
-                    memcpy(&nearest_child_addr, &from, sizeof(mesh_addr_t));
-                    nearest_child_rssi = hb->rssi;
-                } else if (same_child) {
-                    nearest_child_rssi = hb->rssi;
-                }
-                ESP_LOGI(TAG, "Child heartbeat: %s RSSI=%d dBm", hb->src_id, nearest_child_rssi);
+    uint8_t first_byte = data[0];
 
-                if (heartbeat_rx_callback) {
-                    heartbeat_rx_callback(from.addr, hb);
-                }
+    if (first_byte == NET_PKT_TYPE_CONTROL_BUNDLE) {
+        NET_STAT_INC(rx_control_bundles);
+        network_ctrl_bundle_reader_t reader;
+        const uint8_t *msg;
+        size_t msg_len;
+        if (!network_ctrl_bundle_reader_init(&reader, data, size)) {
+            return;
+        }
+        while (network_ctrl_bundle_next(&reader, &msg, &msg_len)) {
+            // No nesting, and audio never rides in a control bundle.
+            if (msg[0] == NET_PKT_TYPE_CONTROL_BUNDLE || msg[0] == NET_FRAME_MAGIC) {
+                continue;
+            }
+            mesh_rx_handle_control_message(from, msg, msg_len);
+        }
+    } else if (first_byte != NET_FRAME_MAGIC) {
+        mesh_rx_handle_control_message(from, data, size);
+    } else {
+        if (size < NET_FRAME_HEADER_SIZE_V2) {
+            NET_STAT_INC(rx_audio_invalid_header);
+            return;
+        }
+
+        uint8_t version = data[1];
+        size_t stream_id_offset;
+        if (version == NET_FRAME_VERSION_V2) {
+            stream_id_offset = offsetof(net_frame_header_v2_t, stream_id);
+        } else if (version == NET_FRAME_VERSION) {
+            if (size < NET_FRAME_HEADER_SIZE_V1) {
+                NET_STAT_INC(rx_audio_invalid_header);
+                return;
             }
-        } else if (first_byte == NET_PKT_TYPE_PING) {
-            g_transport_stats.rx_ping_packets++;
-            if (data.size >= sizeof(mesh_ping_t)) {
-                mesh_ping_t *ping = (mesh_ping_t *)data.data;
-                mesh_ping_handle_ping(&from, ping);
+            stream_id_offset = offsetof(net_frame_header_t, stream_id);
+        } else {
+            NET_STAT_INC(rx_audio_invalid_version);
+            return;
+        }
+
+        // Decode against a copy so a malformed or unanchored header never claims
+        // (or evicts) a stream slot.
+        mesh_rx_stream_t *stream = mesh_rx_stream_find(data[stream_id_offset]);
+        network_frame_ref_t ref = {0};
+        if (stream) {
+            ref = stream->ref;
+        }
+        network_frame_info_t info;
+        if (!network_frame_decode_header(data, size, &ref, &info)) {
+            NET_STAT_INC(rx_audio_invalid_payload);
+            return;
+        }
+        if (!ref.valid) {
+            // v2 before its STREAM_ANNOUNCE: seq/timestamp are only low bits.
+            NET_STAT_INC(rx_audio_unanchored);
+            return;
+        }
+        if (!stream) {
+            stream = mesh_rx_stream_lookup(info.stream_id);
+        }
+        stream->ref = ref;
+        if (info.header_size == NET_FRAME_HEADER_SIZE) {
+            mesh_rx_stream_set_src_id(stream, ((const net_frame_header_t *)data)->src_id);
+        }
+
+        uint16_t seq = info.seq;
+
+        if (info.type == NET_PKT_TYPE_AUDIO_RAW || info.type == NET_PKT_TYPE_AUDIO_OPUS) {
+            NET_STAT_INC(rx_audio_packets);
+            static uint64_t last_obs_log_us = 0;
+            uint64_t now_us = (uint64_t)esp_timer_get_time();
+            uint64_t telemetry_interval_us = (uint64_t)CONTROL_TELEMETRY_RATE_MS * 1000ULL;
+            if (last_obs_log_us == 0 || (now_us - last_obs_log_us) >= telemetry_interval_us) {
+                ESP_LOGI(TAG, "Audio frame RX #%lu: seq=%u size=%d",
+                         (unsigned long)NET_STAT_GET(rx_audio_packets), seq, (int)size);
+                mesh_rx_log_observability_snapshot();
+                last_obs_log_us = now_us;
             }
-        } else if (first_byte == NET_PKT_TYPE_PONG) {
-            g_transport_stats.rx_pong_packets++;
-            if (data.size >= sizeof(mesh_ping_t)) {
-                mesh_ping_t *pong = (mesh_ping_t *)data.data;
-                mesh_ping_handle_pong(pong);
+
+            if (mesh_dedupe_is_duplicate(info.stream_id, seq)) {
+                NET_STAT_INC(rx_audio_duplicates);
+                return;
             }
-        } else if (first_byte == NET_PKT_TYPE_STREAM_ANNOUNCE) {
-            g_transport_stats.rx_stream_announce_packets++;
-            ESP_LOGD(TAG, "Stream announcement received");
-        } else if (first_byte == NET_PKT_TYPE_POSITIONS) {
-            if (data.size >= 2) {
-                uint8_t count = data.data[1];
-                if (data.size >= 2 + count * sizeof(mesh_node_position_t)) {
-                    mesh_node_position_t *pos_list = (mesh_node_position_t *)&data.data[2];
-                    for (uint8_t i = 0; i < count; i++) {
-                        portal_state_update_position(pos_list[i].mac, pos_list[i].x, pos_list[i].y, pos_list[i].z);
-                    }
-                }
+            mesh_dedupe_mark_seen(info.stream_id, seq);
+
+            if (info.ttl == 0) {
+                NET_STAT_INC(rx_audio_ttl_expired);
+                return;
             }
-        } else if (first_byte == NET_PKT_TYPE_CONTROL) {
-            g_transport_stats.rx_control_packets++;
-            if (data.size == sizeof(uplink_ctrl_packet_t)) {
-                uplink_ctrl_message_t uplink_msg;
-                if (uplink_ctrl_decode((const uplink_ctrl_packet_t *)data.data, data.size, &uplink_msg)) {
-                    mesh_uplink_handle_control(&uplink_msg);
-                } else {
-                    ESP_LOGW(TAG, "Ignoring invalid uplink control packet");
-                }
-            } else if (data.size == sizeof(mixer_ctrl_packet_t)) {
-                mixer_ctrl_message_t mixer_msg;
-                if (mixer_ctrl_decode((const mixer_ctrl_packet_t *)data.data, data.size, &mixer_msg)) {
-                    mesh_mixer_handle_control(&mixer_msg);
+
+            network_frame_decrement_ttl(data, size);
+
+            if (audio_rx_callback) {
+                uint16_t total_payload_len = info.payload_len;
+                uint8_t *payload = data + info.header_size;
+                uint32_t timestamp = info.timestamp;
+                uint8_t effective_frame_count = info.frame_count > 0 ? info.frame_count : 1;
+                const char *src_id = stream->src_id;
+                mesh_rx_update_audio_loss_and_jitter(stream, seq, effective_frame_count, timestamp);
+
+                if (effective_frame_count <= 1) {
+                    NET_STAT_INC(rx_audio_forwarded);
+                    audio_rx_callback(payload, total_payload_len, seq, timestamp, src_id);
                 } else {
-                    ESP_LOGW(TAG, "Ignoring invalid mixer control packet");
+                    audio_batch_callback_ctx_t cb_ctx = {.timestamp = timestamp, .src_id = src_id};
+                    NET_STAT_INC(rx_audio_batches);
+                    NET_STAT_ADD(rx_audio_batch_frames, effective_frame_count);
+                    network_frame_unpack_batch(payload,
+                                               total_payload_len,
+                                               effective_frame_count,
+                                               seq,
+                                               on_audio_batch_frame,
+                                               &cb_ctx);
                 }
             } else {
-                ESP_LOGW(TAG, "Ignoring unknown control packet size=%d", data.size);
-            }
-        } else if (first_byte == NET_FRAME_MAGIC) {
-            if (data.size < NET_FRAME_HEADER_SIZE_V1) {
-                g_transport_stats.rx_audio_invalid_header++;
-                continue;
+                NET_STAT_INC(rx_audio_callback_missing);
+                if ((NET_STAT_GET(rx_audio_callback_missing) % 200) == 1) {
+                    ESP_LOGW(TAG, "Audio frame received but audio_rx_callback is NULL");
+                }
             }
+        }
+    }
+}
 
-            net_frame_header_t *hdr = (net_frame_header_t *)data.data;
-            if (hdr->version != NET_FRAME_VERSION) {
-                g_transport_stats.rx_audio_invalid_version++;
-                continue;
-            }
+void mesh_rx_task(void *arg) {
+    (void)arg;
+    esp_err_t err;
+    mesh_addr_t from;
+    network_node_addr_t from_node;
+    mesh_data_t data;
 
-            uint16_t seq = ntohs(hdr->seq);
-
-            if (hdr->type == NET_PKT_TYPE_AUDIO_RAW || hdr->type == NET_PKT_TYPE_AUDIO_OPUS) {
-                g_transport_stats.rx_audio_packets++;
-                static uint64_t last_obs_log_us = 0;
-                uint64_t now_us = (uint64_t)esp_timer_get_time();
-                uint64_t telemetry_interval_us = (uint64_t)CONTROL_TELEMETRY_RATE_MS * 1000ULL;
-                if (last_obs_log_us == 0 || (now_us - last_obs_log_us) >= telemetry_interval_us) {
-                    ESP_LOGI(TAG, "Audio frame RX #%lu: seq=%u size=%d",
-                             (unsigned long)g_transport_stats.rx_audio_packets, seq, data.size);
-                    mesh_rx_log_observability_snapshot();
-                    last_obs_log_us = now_us;
-                }
+    ESP_LOGI(TAG, "Mesh RX task started");
 
-                if (mesh_dedupe_is_duplicate(hdr->stream_id, seq)) {
-                    g_transport_stats.rx_audio_duplicates++;
-                    continue;
-                }
-                mesh_dedupe_mark_seen(hdr->stream_id, seq);
+    while (!is_mesh_root_ready && !is_mesh_connected) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    ESP_LOGI(TAG, "Mesh RX task: network ready, entering recv loop (root=%d, connected=%d)",
+             is_mesh_root, is_mesh_connected);
 
-                if (hdr->ttl == 0) {
-                    g_transport_stats.rx_audio_ttl_expired++;
-                    continue;
-                }
+    while (1) {
+        // Drop the dispatch reference from the previous packet; anyone who retained it keeps it.
+        network_pkt_release(rx_current_packet);
+        rx_current_packet = network_pkt_alloc();
 
-                hdr->ttl--;
-
-                if (audio_rx_callback) {
-                    uint16_t total_payload_len = ntohs(hdr->payload_len);
-                    size_t hdr_size = 0;
-                    if (!network_frame_resolve_header_size(data.size,
-                                                           total_payload_len,
-                                                           NET_FRAME_HEADER_SIZE,
-                                                           NET_FRAME_HEADER_SIZE_V1,
-                                                           &hdr_size)) {
-                        g_transport_stats.rx_audio_invalid_payload++;
-                        continue;
-                    }
-
-                    uint8_t *payload = data.data + hdr_size;
-                    uint32_t timestamp = ntohl(hdr->timestamp);
-                    uint8_t frame_count = network_frame_extract_frame_count(data.data,
-                                                                            data.size,
-                                                                            NET_FRAME_HEADER_SIZE,
-                                                                            hdr_size,
-                                                                            hdr->frame_count,
-                                                                            13);
-                    uint8_t effective_frame_count = frame_count > 0 ? frame_count : 1;
-                    const char *src_id = (hdr_size == NET_FRAME_HEADER_SIZE) ? hdr->src_id : "";
-                    mesh_rx_update_audio_loss_and_jitter(seq, effective_frame_count, timestamp);
-
-                    if (effective_frame_count <= 1) {
-                        g_transport_stats.rx_audio_forwarded++;
-                        audio_rx_callback(payload, total_payload_len, seq, timestamp, src_id);
-                    } else {
-                        audio_batch_callback_ctx_t cb_ctx = {.timestamp = timestamp, .src_id = src_id};
-                        g_transport_stats.rx_audio_batches++;
-                        g_transport_stats.rx_audio_batch_frames += effective_frame_count;
-                        network_frame_unpack_batch(payload,
-                                                   total_payload_len,
-                                                   effective_frame_count,
-                                                   seq,
-                                                   on_audio_batch_frame,
-                                                   &cb_ctx);
-                    }
-                } else {
-                    g_transport_stats.rx_audio_callback_missing++;
-                    if ((g_transport_stats.rx_audio_callback_missing % 200) == 1) {
-                        ESP_LOGW(TAG, "Audio frame received but audio_rx_callback is NULL");
-                    }
-                }
+        // Pool exhausted: still drain the mesh queue, consumers just cannot hold a reference.
+        data.data = rx_current_packet ? rx_current_packet->data : mesh_rx_buffer;
+        data.size = MESH_RX_BUFFER_SIZE;
+
+        size_t rx_len = MESH_RX_BUFFER_SIZE;
+        err = network_transport_recv(&from_node, data.data, &rx_len, NETWORK_TRANSPORT_WAIT_FOREVER);
+        if (err == ESP_OK) {
+            data.size = (uint16_t)rx_len;
+            mesh_transport_from_node(&from_node, &from);
+        }
+        if (rx_current_packet) {
+            rx_current_packet->len = (err == ESP_OK) ? data.size : 0;
+        }
+
+        if (err != ESP_OK) {
+            NET_STAT_INC(mesh_recv_errors);
+            if (err == ESP_ERR_MESH_NOT_START) {
+                vTaskDelay(pdMS_TO_TICKS(100));
+            } else {
+                ESP_LOGW(TAG, "Mesh receive error: %s", esp_err_to_name(err));
             }
+            continue;
         }
+
+        mesh_rx_dispatch(&from, data.data, data.size);
     }
 }
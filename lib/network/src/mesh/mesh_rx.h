@@ -1,3 +1,9 @@
 #pragma once
 
+#include <esp_mesh.h>
+#include <stddef.h>
+#include <stdint.h>
+
 void mesh_rx_task(void *arg);
+// Handles one received datagram; the RX task calls it for every packet.
+void mesh_rx_dispatch(const mesh_addr_t *from, uint8_t *data, size_t size);
@@ -1,5 +1,7 @@
 #include "mesh/mesh_state.h"
 #include <esp_log.h>
+#include <freertos/semphr.h>
+#include <string.h>
 
 node_role_t my_node_role = NODE_ROLE_OUT;
 uint8_t my_stream_id = 1;
@@ -17,21 +19,13 @@ mesh_addr_t mesh_parent_addr;
 
 uint32_t measured_latency_ms = 0;
 int8_t mesh_parent_rssi = -100;
-bool ping_pending = false;
 int8_t nearest_child_rssi = -100;
 uint32_t nearest_child_latency_ms = 0;
 mesh_addr_t nearest_child_addr;
-bool child_ping_pending = false;
-int64_t last_ping_sent_us = 0;
-int64_t last_child_ping_sent_us = 0;
 
 static mesh_addr_t cached_root_addr;
 static bool have_root_addr = false;
 
-uint32_t ping_seq = 0;
-uint32_t child_ping_seq = 0;
-uint32_t pending_ping_id = 0;
-uint32_t pending_child_ping_id = 0;
 uint32_t no_parent_count = 0;
 uint32_t scan_done_count = 0;
 uint32_t join_fail_count = 0;
@@ -81,13 +75,49 @@ network_heartbeat_callback_t heartbeat_rx_callback = NULL;
 uint32_t total_drops = 0;
 uint32_t total_sent = 0;
 volatile uint32_t tx_bytes_counter = 0;
-network_transport_stats_t g_transport_stats = {0};
+static _Atomic uint32_t transport_stat_words[STAT_COUNTER_SHARDS * NETWORK_TRANSPORT_STAT_WORDS];
+static uint32_t transport_stat_baseline[NETWORK_TRANSPORT_STAT_WORDS];
+static const uint16_t transport_stat_gauges[] = {
+    NETWORK_TRANSPORT_STAT(tx_audio_backpressure_level),
+    NETWORK_TRANSPORT_STAT(rx_audio_burst_loss_max),
+    NETWORK_TRANSPORT_STAT(rx_audio_interarrival_jitter_us),
+};
+network_stat_counters_t g_transport_counters = NETWORK_STAT_COUNTERS_INITIALIZER(
+    transport_stat_words, transport_stat_baseline, NETWORK_TRANSPORT_STAT_WORDS,
+    transport_stat_gauges, sizeof(transport_stat_gauges) / sizeof(transport_stat_gauges[0]));
+network_link_table_t g_link_table;
+network_ping_tracker_t g_ping_tracker;
+network_rtt_window_t g_rtt_upstream;
+network_rtt_window_t g_rtt_downstream;
+static SemaphoreHandle_t link_mutex = NULL;
 
 uint8_t mesh_rx_buffer[MESH_RX_BUFFER_SIZE];
 const mesh_addr_t audio_multicast_group = {
     .addr = {0x01, 0x00, 0x5E, 'A', 'U', 'D'}
 };
 
+esp_err_t mesh_state_init(void) {
+    if (!link_mutex) {
+        link_mutex = xSemaphoreCreateMutex();
+        if (!link_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+void mesh_link_lock(void) {
+    if (link_mutex) {
+        xSemaphoreTake(link_mutex, portMAX_DELAY);
+    }
+}
+
+void mesh_link_unlock(void) {
+    if (link_mutex) {
+        xSemaphoreGive(link_mutex);
+    }
+}
+
 bool mesh_state_has_root_addr(void) {
     return have_root_addr;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "network/mesh_net.h"
+#include "network/link_table.h"
+#include "network/rtt_estimator.h"
 #include "config/build.h"
 #include <esp_mesh.h>
 #include <freertos/FreeRTOS.h>
@@ -29,18 +31,10 @@ extern mesh_addr_t mesh_parent_addr;
 
 extern uint32_t measured_latency_ms;
 extern int8_t mesh_parent_rssi;
-extern bool ping_pending;
 extern int8_t nearest_child_rssi;
 extern uint32_t nearest_child_latency_ms;
 extern mesh_addr_t nearest_child_addr;
-extern bool child_ping_pending;
-extern int64_t last_ping_sent_us;
-extern int64_t last_child_ping_sent_us;
-
-extern uint32_t ping_seq;
-extern uint32_t child_ping_seq;
-extern uint32_t pending_ping_id;
-extern uint32_t pending_child_ping_id;
+
 extern uint32_t no_parent_count;
 extern uint32_t scan_done_count;
 extern uint32_t join_fail_count;
@@ -67,11 +61,37 @@ extern network_heartbeat_callback_t heartbeat_rx_callback;
 extern uint32_t total_drops;
 extern uint32_t total_sent;
 extern volatile uint32_t tx_bytes_counter;
-extern network_transport_stats_t g_transport_stats;
+extern network_stat_counters_t g_transport_counters;
+// Link state: the heartbeat task starts and expires pings, the RX task
+// completes them and updates the link table, and queries read the RTT windows
+// from any task. Every access holds mesh_link_lock; nothing is sent under it.
+extern network_link_table_t g_link_table;
+extern network_ping_tracker_t g_ping_tracker;
+extern network_rtt_window_t g_rtt_upstream;
+extern network_rtt_window_t g_rtt_downstream;
 
 extern uint8_t mesh_rx_buffer[MESH_RX_BUFFER_SIZE];
 extern const mesh_addr_t audio_multicast_group;
 
+// Transport stats writes land in the calling task's shard (network/stat_counters.h).
+static inline network_stat_shard_t *mesh_stats_shard(void)
+{
+    return network_stat_shard(&g_transport_counters, xTaskGetCurrentTaskHandle());
+}
+
+#define NET_STAT_ADD(field, n) \
+    network_stat_add(&g_transport_counters, mesh_stats_shard(), NETWORK_TRANSPORT_STAT(field), (uint32_t)(n))
+#define NET_STAT_INC(field) NET_STAT_ADD(field, 1)
+#define NET_STAT_SET(field, v) \
+    network_stat_set(&g_transport_counters, mesh_stats_shard(), NETWORK_TRANSPORT_STAT(field), (uint32_t)(v))
+#define NET_STAT_MAX(field, v) \
+    network_stat_max(&g_transport_counters, mesh_stats_shard(), NETWORK_TRANSPORT_STAT(field), (uint32_t)(v))
+#define NET_STAT_GET(field) network_stat_read(&g_transport_counters, NETWORK_TRANSPORT_STAT(field))
+
+esp_err_t mesh_state_init(void);
+void mesh_link_lock(void);
+void mesh_link_unlock(void);
+
 bool mesh_state_has_root_addr(void);
 const mesh_addr_t *mesh_state_get_root_addr(void);
 void mesh_state_set_root_addr(const mesh_addr_t *root_addr);
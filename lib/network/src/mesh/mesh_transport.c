@@ -0,0 +1,95 @@
+#include "mesh/mesh_transport.h"
+#include "mesh/mesh_capture.h"
+#include "mesh/mesh_tx.h"
+#include "config/build.h"
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+
+void mesh_transport_to_node(const mesh_addr_t *addr, network_node_addr_t *node) {
+    memcpy(node->addr, addr->addr, sizeof(node->addr));
+}
+
+void mesh_transport_from_node(const network_node_addr_t *node, mesh_addr_t *addr) {
+    memset(addr, 0, sizeof(*addr));
+    memcpy(addr->addr, node->addr, sizeof(node->addr));
+}
+
+static esp_err_t mesh_transport_send_audio(void *ctx, const network_node_addr_t *to,
+                                           const uint8_t *data, size_t len) {
+    (void)ctx;
+    if (!to) {
+        return mesh_tx_send_audio(data, len);
+    }
+    mesh_addr_t addr;
+    mesh_transport_from_node(to, &addr);
+    return mesh_tx_send_audio_to(&addr, data, len);
+}
+
+static esp_err_t mesh_transport_send_control(void *ctx, const network_node_addr_t *to,
+                                             const uint8_t *data, size_t len) {
+    (void)ctx;
+    if (!to) {
+        return mesh_tx_send_control_now(data, len);
+    }
+    mesh_addr_t addr;
+    mesh_transport_from_node(to, &addr);
+    return mesh_tx_send_control_to(&addr, data, len);
+}
+
+static esp_err_t mesh_transport_recv(void *ctx, network_node_addr_t *from, uint8_t *buf,
+                                     size_t *len, uint32_t timeout_ms) {
+    (void)ctx;
+    mesh_addr_t addr;
+    mesh_data_t data = {
+        .data = buf,
+        .size = (uint16_t)(*len > MESH_RX_BUFFER_SIZE ? MESH_RX_BUFFER_SIZE : *len),
+    };
+    int flag = 0;
+    // esp_mesh_recv takes milliseconds, with portMAX_DELAY for no timeout.
+    int timeout = (timeout_ms == NETWORK_TRANSPORT_WAIT_FOREVER) ? (int)portMAX_DELAY
+                                                                : (int)timeout_ms;
+
+    esp_err_t err = esp_mesh_recv(&addr, &data, timeout, &flag, NULL, 0);
+    if (err == ESP_ERR_MESH_TIMEOUT) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    mesh_capture_packet(&addr, flag, buf, data.size);
+    mesh_transport_to_node(&addr, from);
+    *len = data.size;
+    return ESP_OK;
+}
+
+static int mesh_transport_topology(void *ctx, network_node_addr_t *nodes, int max_nodes, bool *is_root) {
+    (void)ctx;
+    if (is_root) {
+        *is_root = esp_mesh_is_root();
+    }
+    mesh_addr_t route_table[MESH_ROUTE_TABLE_SIZE];
+    int route_table_size = 0;
+    esp_mesh_get_routing_table(route_table, sizeof(route_table), &route_table_size);
+    int count = route_table_size < max_nodes ? route_table_size : max_nodes;
+    for (int i = 0; i < count; i++) {
+        mesh_transport_to_node(&route_table[i], &nodes[i]);
+    }
+    return count;
+}
+
+static const network_transport_ops_t mesh_transport_ops = {
+    .name = "esp-mesh",
+    .send_audio = mesh_transport_send_audio,
+    .send_control = mesh_transport_send_control,
+    .recv = mesh_transport_recv,
+    .topology = mesh_transport_topology,
+};
+
+static const network_transport_t mesh_transport = {
+    .ops = &mesh_transport_ops,
+    .ctx = NULL,
+};
+
+const network_transport_t *mesh_transport_backend(void) {
+    return &mesh_transport;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "network/transport.h"
+#include <esp_mesh.h>
+
+// ESP-WIFI-MESH transport backend: audio goes through mesh_tx's fanout policy,
+// control through its P2P/uplink sends, and receive wraps esp_mesh_recv.
+const network_transport_t *mesh_transport_backend(void);
+
+void mesh_transport_to_node(const mesh_addr_t *addr, network_node_addr_t *node);
+void mesh_transport_from_node(const network_node_addr_t *node, mesh_addr_t *addr);
@@ -1,8 +1,14 @@
 #include "mesh/mesh_tx.h"
 #include "mesh/mesh_state.h"
+#include "mesh/mesh_fanout.h"
+#include "mesh/mesh_coalesce.h"
+#include "mesh/mesh_transport.h"
+#include "network/transport.h"
 #include "config/build.h"
 #include <esp_log.h>
 #include <esp_mesh.h>
+#include <esp_timer.h>
+#include <stdatomic.h>
 #include <string.h>
 
 static const char *TAG = "network_mesh";
@@ -27,40 +33,60 @@ static void transport_record_audio_tx_result(esp_err_t err, size_t len)
 {
     static uint32_t queue_full_streak = 0;
     if (err == ESP_OK) {
-        g_transport_stats.tx_audio_packets++;
-        g_transport_stats.tx_audio_bytes += (uint32_t)len;
+        NET_STAT_INC(tx_audio_packets);
+        NET_STAT_ADD(tx_audio_bytes, (uint32_t)len);
         if (queue_full_streak > 0) {
             queue_full_streak--;
         }
     } else {
-        g_transport_stats.tx_audio_send_failures++;
+        NET_STAT_INC(tx_audio_send_failures);
         if (err == ESP_ERR_MESH_QUEUE_FULL) {
-            g_transport_stats.tx_audio_queue_full++;
+            NET_STAT_INC(tx_audio_queue_full);
             queue_full_streak++;
         } else if (err == ESP_ERR_MESH_NO_ROUTE_FOUND) {
-            g_transport_stats.tx_audio_no_route++;
+            NET_STAT_INC(tx_audio_no_route);
         } else if (err == ESP_ERR_INVALID_STATE || err == ESP_ERR_MESH_DISCONNECTED) {
-            g_transport_stats.tx_audio_invalid_state++;
+            NET_STAT_INC(tx_audio_invalid_state);
         }
     }
-    g_transport_stats.tx_audio_backpressure_level = transport_backpressure_level(queue_full_streak);
+    NET_STAT_SET(tx_audio_backpressure_level, transport_backpressure_level(queue_full_streak));
+}
+
+// Owned by the audio send path. The RX task reports NACKed loss through
+// fanout_pending_loss, which the send path drains before each decision.
+static mesh_fanout_policy_t fanout_policy;
+static atomic_uint fanout_pending_loss;
+
+void mesh_tx_init(void)
+{
+    mesh_fanout_config_t cfg = MESH_FANOUT_CONFIG_DEFAULT();
+    mesh_fanout_init(&fanout_policy, &cfg, esp_timer_get_time() / 1000);
+    atomic_store(&fanout_pending_loss, 0);
+}
+
+void mesh_tx_fanout_record_loss(uint16_t lost_frames)
+{
+    if (!is_mesh_root) {
+        return;
+    }
+    atomic_fetch_add(&fanout_pending_loss, lost_frames);
 }
 
 static void transport_record_control_tx_result(esp_err_t err)
 {
     if (err == ESP_OK) {
-        g_transport_stats.tx_control_packets++;
+        NET_STAT_INC(tx_control_packets);
         return;
     }
-    g_transport_stats.tx_control_send_failures++;
+    NET_STAT_INC(tx_control_send_failures);
     if (err == ESP_ERR_MESH_NO_ROUTE_FOUND) {
-        g_transport_stats.tx_control_no_route++;
+        NET_STAT_INC(tx_control_no_route);
     } else if (err == ESP_ERR_INVALID_STATE || err == ESP_ERR_MESH_DISCONNECTED) {
-        g_transport_stats.tx_control_invalid_state++;
+        NET_STAT_INC(tx_control_invalid_state);
     }
 }
 
-esp_err_t network_send_audio(const uint8_t *data, size_t len) {
+esp_err_t mesh_tx_send_audio(const uint8_t *data, size_t len) {
     if (!is_mesh_connected && !(is_mesh_root && is_mesh_root_ready)) {
         transport_record_audio_tx_result(ESP_ERR_INVALID_STATE, len);
         return ESP_ERR_INVALID_STATE;
@@ -84,7 +110,23 @@ esp_err_t network_send_audio(const uint8_t *data, size_t len) {
         esp_mesh_get_routing_table(route_table, sizeof(route_table), &route_table_size);
         int descendant_count = route_table_size > 1 ? route_table_size - 1 : 0;
 
-        if (descendant_count > 0 && descendant_count <= 10) {
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        mesh_fanout_policy_t *policy = &fanout_policy;
+        unsigned int lost_frames = atomic_exchange(&fanout_pending_loss, 0);
+        if (lost_frames > 0) {
+            mesh_fanout_record_loss(policy, (uint16_t)(lost_frames > UINT16_MAX ? UINT16_MAX : lost_frames));
+        }
+        mesh_fanout_mode_t prev_mode = policy->mode;
+        mesh_fanout_mode_t mode = mesh_fanout_select(policy, (uint16_t)descendant_count, now_ms);
+        if (mode != prev_mode) {
+            ESP_LOGI(TAG, "Fanout %s -> %s (%s, descendants=%d)",
+                     mesh_fanout_mode_name(prev_mode), mesh_fanout_mode_name(mode),
+                     mesh_fanout_reason_name(policy->reason), descendant_count);
+        }
+        uint16_t sends = 0;
+        uint16_t queue_full = 0;
+
+        if (mode == MESH_FANOUT_P2P) {
             // HIGH RELIABILITY MODE: Send individual P2P packets with hardware ACKs
             int sent_ok = 0;
             esp_err_t first_err = ESP_OK;
@@ -93,29 +135,40 @@ esp_err_t network_send_audio(const uint8_t *data, size_t len) {
                 
                 esp_err_t perr = esp_mesh_send(&route_table[i], &mesh_data,
                                                MESH_DATA_P2P | MESH_DATA_NONBLOCK, NULL, 0);
+                sends++;
                 if (perr == ESP_OK) {
                     sent_ok++;
-                } else if (first_err == ESP_OK) {
-                    first_err = perr;
+                } else {
+                    if (perr == ESP_ERR_MESH_QUEUE_FULL) {
+                        queue_full++;
+                    }
+                    if (first_err == ESP_OK) {
+                        first_err = perr;
+                    }
                 }
                 
                 // Yield to prevent watchdog on CPU 1 during multi-child fanout
                 vTaskDelay(1);
             }
             err = (sent_ok > 0) ? ESP_OK : (first_err != ESP_OK ? first_err : ESP_ERR_MESH_NO_ROUTE_FOUND);
-        } else if (descendant_count > 10) {
-            // SCALABILITY MODE: Use Multicast Group for large meshes
+        } else if (mode == MESH_FANOUT_GROUP) {
+            // SCALABILITY MODE: one multicast send, no per-child airtime
             err = esp_mesh_send((mesh_addr_t *)&audio_multicast_group, &mesh_data,
                                 kAudioRootFanoutFlags, NULL, 0);
+            sends = 1;
+            queue_full = (err == ESP_ERR_MESH_QUEUE_FULL) ? 1 : 0;
         } else {
             // DISCOVERY MODE: Last-resort global broadcast to all FFs
             static const mesh_addr_t broadcast_addr = {{0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
             err = esp_mesh_send((mesh_addr_t *)&broadcast_addr, &mesh_data,
                                 MESH_DATA_GROUP | MESH_DATA_NONBLOCK, NULL, 0);
+            sends = 1;
+            queue_full = (err == ESP_ERR_MESH_QUEUE_FULL) ? 1 : 0;
             if (should_log) {
                 ESP_LOGW(TAG, "Audio broadcast: empty routing table, using GLOBAL BROADCAST (err=%s)", esp_err_to_name(err));
             }
         }
+        mesh_fanout_record_send(policy, MESH_FRAMES_PER_PACKET, sends, queue_full);
 
         transport_record_audio_tx_result(err, len);
         if (err == ESP_OK) {
@@ -134,19 +187,35 @@ esp_err_t network_send_audio(const uint8_t *data, size_t len) {
             int target_packets_per_second = 1000 / (AUDIO_FRAME_TARGET_MS * MESH_FRAMES_PER_PACKET);
             ESP_LOGI(TAG,
                      "Mesh TX %s: descendants=%d batch=%d pps=%d (target=%d fallback=%d) total_sent=%lu drops=%lu (%.1f%%)",
-                     (descendant_count > 0 && descendant_count <= 10) ? "P2P-HYBRID" : TRANSPORT_ROOT_FANOUT_MODE,
+                     mode == MESH_FANOUT_P2P ? "P2P-HYBRID" : TRANSPORT_ROOT_FANOUT_MODE,
                      descendant_count, MESH_FRAMES_PER_PACKET,
                      packets_per_second, target_packets_per_second, AUDIO_FRAME_FALLBACK_ACTIVE ? 1 : 0,
                      total_sent, total_drops,
                      (total_sent + total_drops) > 0 ? (100.0f * total_drops / (total_sent + total_drops)) : 0.0f);
+            network_transport_stats_t stats;
+            network_get_transport_stats(&stats);
             ESP_LOGI(TAG,
-                     "TX OBS: audio_ok=%lu fail=%lu qfull=%lu noroute=%lu inv=%lu bp=%lu",
-                     (unsigned long)g_transport_stats.tx_audio_packets,
-                     (unsigned long)g_transport_stats.tx_audio_send_failures,
-                     (unsigned long)g_transport_stats.tx_audio_queue_full,
-                     (unsigned long)g_transport_stats.tx_audio_no_route,
-                     (unsigned long)g_transport_stats.tx_audio_invalid_state,
-                     (unsigned long)g_transport_stats.tx_audio_backpressure_level);
+                     "TX OBS: audio_ok=%lu fail=%lu qfull=%lu noroute=%lu inv=%lu bp=%lu "
+                     "retx={nack:%lu sent:%lu miss:%lu late:%lu rl:%lu} "
+                     "fanout={mode:%s why:%s sw:%lu qf:%lu%% loss:%lu%% air:%lu}",
+                     (unsigned long)stats.tx_audio_packets,
+                     (unsigned long)stats.tx_audio_send_failures,
+                     (unsigned long)stats.tx_audio_queue_full,
+                     (unsigned long)stats.tx_audio_no_route,
+                     (unsigned long)stats.tx_audio_invalid_state,
+                     (unsigned long)stats.tx_audio_backpressure_level,
+                     (unsigned long)stats.rx_nack_packets,
+                     (unsigned long)stats.tx_retransmit_packets,
+                     (unsigned long)stats.tx_retransmit_cache_miss,
+                     (unsigned long)stats.tx_retransmit_deadline_miss,
+                     (unsigned long)stats.tx_retransmit_rate_limited,
+                     mesh_fanout_mode_name(policy->mode),
+                     mesh_fanout_reason_name(policy->reason),
+                     (unsigned long)policy->switches,
+                     (unsigned long)mesh_fanout_window_pct(policy->last_window.queue_full, policy->last_window.sends),
+                     (unsigned long)mesh_fanout_window_pct(policy->last_window.lost_frames, policy->last_window.frames),
+                     (unsigned long)(policy->last_window.packets > 0
+                                         ? policy->last_window.sends / policy->last_window.packets : 0));
         }
     } else {
         err = esp_mesh_send(NULL, &mesh_data, kAudioToRootFlags, NULL, 0);
@@ -162,6 +231,37 @@ esp_err_t network_send_audio(const uint8_t *data, size_t len) {
     return err;
 }
 
+esp_err_t mesh_tx_send_audio_to(const mesh_addr_t *to, const uint8_t *data, size_t len) {
+    mesh_data_t mesh_data = {
+        .data = (uint8_t *)data,
+        .size = len,
+        .proto = MESH_PROTO_BIN,
+        .tos = MESH_TOS_DEF,
+    };
+    return esp_mesh_send(to, &mesh_data, MESH_DATA_P2P | MESH_DATA_NONBLOCK, NULL, 0);
+}
+
+esp_err_t network_send_audio(const uint8_t *data, size_t len) {
+    return network_transport_send_audio(NULL, data, len);
+}
+
+esp_err_t network_retransmit_audio(const mesh_addr_t *to, const uint8_t *data, size_t len) {
+    if (!to || !data || len == 0 || !is_mesh_root) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    network_node_addr_t node;
+    mesh_transport_to_node(to, &node);
+    esp_err_t err = network_transport_send_audio(&node, data, len);
+    if (err == ESP_OK) {
+        NET_STAT_INC(tx_retransmit_packets);
+        tx_bytes_counter += len;
+    } else {
+        ESP_LOGD(TAG, "Retransmit P2P send failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
 esp_err_t network_broadcast_positions(const mesh_positions_t *pos) {
     if (!is_mesh_root || !is_mesh_root_ready) {
         return ESP_ERR_INVALID_STATE;
@@ -178,7 +278,7 @@ esp_err_t network_broadcast_positions(const mesh_positions_t *pos) {
                         kAudioRootFanoutFlags, NULL, 0);
 }
 
-esp_err_t network_send_control(const uint8_t *data, size_t len) {
+esp_err_t mesh_tx_send_control_now(const uint8_t *data, size_t len) {
     if (!is_mesh_connected && !(is_mesh_root && is_mesh_root_ready)) {
         transport_record_control_tx_result(ESP_ERR_INVALID_STATE);
         return ESP_ERR_INVALID_STATE;
@@ -237,3 +337,33 @@ esp_err_t network_send_control(const uint8_t *data, size_t len) {
 
     return err;
 }
+
+esp_err_t mesh_tx_send_control_to(const mesh_addr_t *to, const uint8_t *data, size_t len) {
+    if (!to || (!is_mesh_connected && !(is_mesh_root && is_mesh_root_ready))) {
+        transport_record_control_tx_result(ESP_ERR_INVALID_STATE);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mesh_data_t mesh_data = {
+        .data = (uint8_t *)data,
+        .size = len,
+        .proto = MESH_PROTO_BIN,
+        .tos = MESH_TOS_DEF,
+    };
+    esp_err_t err = esp_mesh_send(to, &mesh_data, MESH_DATA_P2P | MESH_DATA_NONBLOCK, NULL, 0);
+    transport_record_control_tx_result(err);
+    if (err != ESP_OK && err != ESP_ERR_MESH_NO_ROUTE_FOUND) {
+        ESP_LOGD(TAG, "Control P2P send failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+// Queued for the next coalescing tick; the send result is recorded in the
+// control TX stats when the bundle goes out.
+esp_err_t network_send_control(const uint8_t *data, size_t len) {
+    if (!is_mesh_connected && !(is_mesh_root && is_mesh_root_ready)) {
+        transport_record_control_tx_result(ESP_ERR_INVALID_STATE);
+        return ESP_ERR_INVALID_STATE;
+    }
+    return mesh_coalesce_enqueue(MESH_CTRL_DEST_DEFAULT, data, len);
+}
@@ -1,8 +1,25 @@
 #pragma once
 
 #include <esp_err.h>
+#include <esp_mesh.h>
 #include <stddef.h>
 #include <stdint.h>
 
+// Public entry points; both dispatch through the active transport backend.
 esp_err_t network_send_audio(const uint8_t *data, size_t len);
 esp_err_t network_send_control(const uint8_t *data, size_t len);
+// Mesh backend implementations behind the transport vtable: root fanout (or
+// uplink to the root), and one non-blocking P2P audio send.
+esp_err_t mesh_tx_send_audio(const uint8_t *data, size_t len);
+esp_err_t mesh_tx_send_audio_to(const mesh_addr_t *to, const uint8_t *data, size_t len);
+// Bypass control coalescing: for latency-sensitive messages (NACKs) and for
+// flushing bundles. _now keeps network_send_control routing, _to is one P2P hop.
+esp_err_t mesh_tx_send_control_now(const uint8_t *data, size_t len);
+esp_err_t mesh_tx_send_control_to(const mesh_addr_t *to, const uint8_t *data, size_t len);
+esp_err_t network_retransmit_audio(const mesh_addr_t *to, const uint8_t *data, size_t len);
+
+// Sets up the root fanout policy; called once before the mesh tasks start.
+void mesh_tx_init(void);
+// Root only: feeds OUT-reported (NACKed) frame loss into the fanout policy.
+// Safe from any task; the audio send path applies it before its next decision.
+void mesh_tx_fanout_record_loss(uint16_t lost_frames);
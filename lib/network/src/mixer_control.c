@@ -21,6 +21,32 @@ static bool mixer_ctrl_stream_gain_is_valid(uint16_t gain_pct)
     return gain_pct <= MIXER_STREAM_GAIN_MAX_PCT;
 }
 
+static uint8_t mixer_stream_flags(const mixer_ctrl_stream_t *stream)
+{
+    uint8_t flags = 0;
+    if (stream->enabled) {
+        flags |= MIXER_CTRL_STREAM_FLAG_ENABLED;
+    }
+    if (stream->muted) {
+        flags |= MIXER_CTRL_STREAM_FLAG_MUTED;
+    }
+    if (stream->solo) {
+        flags |= MIXER_CTRL_STREAM_FLAG_SOLO;
+    }
+    if (stream->active) {
+        flags |= MIXER_CTRL_STREAM_FLAG_ACTIVE;
+    }
+    return flags;
+}
+
+static void mixer_stream_set_flags(mixer_ctrl_stream_t *stream, uint8_t flags)
+{
+    stream->enabled = (flags & MIXER_CTRL_STREAM_FLAG_ENABLED) != 0;
+    stream->muted = (flags & MIXER_CTRL_STREAM_FLAG_MUTED) != 0;
+    stream->solo = (flags & MIXER_CTRL_STREAM_FLAG_SOLO) != 0;
+    stream->active = (flags & MIXER_CTRL_STREAM_FLAG_ACTIVE) != 0;
+}
+
 bool mixer_ctrl_encode(const mixer_ctrl_message_t *msg, mixer_ctrl_packet_t *packet) {
     if (!msg || !packet) {
         return false;
@@ -56,18 +82,7 @@ bool mixer_ctrl_encode(const mixer_ctrl_message_t *msg, mixer_ctrl_packet_t *pac
         mixer_ctrl_stream_entry_t *dst = &packet->streams[i];
         dst->stream_id = src->stream_id;
         dst->gain_pct = htons(src->gain_pct);
-        if (src->enabled) {
-            dst->flags |= MIXER_CTRL_STREAM_FLAG_ENABLED;
-        }
-        if (src->muted) {
-            dst->flags |= MIXER_CTRL_STREAM_FLAG_MUTED;
-        }
-        if (src->solo) {
-            dst->flags |= MIXER_CTRL_STREAM_FLAG_SOLO;
-        }
-        if (src->active) {
-            dst->flags |= MIXER_CTRL_STREAM_FLAG_ACTIVE;
-        }
+        dst->flags = mixer_stream_flags(src);
     }
     return true;
 }
@@ -101,10 +116,7 @@ bool mixer_ctrl_decode(const mixer_ctrl_packet_t *packet, size_t packet_len, mix
         mixer_ctrl_stream_t *dst = &msg->streams[i];
         dst->stream_id = src->stream_id;
         dst->gain_pct = ntohs(src->gain_pct);
-        dst->enabled = (src->flags & MIXER_CTRL_STREAM_FLAG_ENABLED) != 0;
-        dst->muted = (src->flags & MIXER_CTRL_STREAM_FLAG_MUTED) != 0;
-        dst->solo = (src->flags & MIXER_CTRL_STREAM_FLAG_SOLO) != 0;
-        dst->active = (src->flags & MIXER_CTRL_STREAM_FLAG_ACTIVE) != 0;
+        mixer_stream_set_flags(dst, src->flags);
         if (!mixer_ctrl_stream_id_is_valid(dst->stream_id) ||
             !mixer_ctrl_stream_gain_is_valid(dst->gain_pct)) {
             return false;
@@ -112,3 +124,164 @@ bool mixer_ctrl_decode(const mixer_ctrl_packet_t *packet, size_t packet_len, mix
     }
     return true;
 }
+
+static bool mixer_same_stream_set(const mixer_ctrl_message_t *a, const mixer_ctrl_message_t *b)
+{
+    if (a->stream_count != b->stream_count) {
+        return false;
+    }
+    for (uint8_t i = 0; i < a->stream_count; i++) {
+        if (a->streams[i].stream_id != b->streams[i].stream_id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool mixer_message_is_valid(const mixer_ctrl_message_t *msg)
+{
+    if (msg->out_gain_pct > MIXER_OUT_GAIN_MAX_PCT || msg->stream_count > MIXER_MAX_STREAMS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < msg->stream_count; i++) {
+        if (!mixer_ctrl_stream_id_is_valid(msg->streams[i].stream_id) ||
+            !mixer_ctrl_stream_gain_is_valid(msg->streams[i].gain_pct)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t mixer_delta_encode(const mixer_ctrl_message_t *prev, const mixer_ctrl_message_t *next,
+                          uint16_t base_version, uint16_t state_version, mixer_delta_packet_t *packet)
+{
+    if (!next || !packet || !mixer_message_is_valid(next)) {
+        return 0;
+    }
+
+    bool full = !prev || !mixer_same_stream_set(prev, next);
+    memset(packet, 0, sizeof(*packet));
+    packet->hdr.type = NET_PKT_TYPE_MIXER_DELTA;
+    packet->hdr.version = MIXER_CTRL_VERSION;
+    packet->hdr.base_version = htons(base_version);
+    packet->hdr.state_version = htons(state_version);
+    packet->hdr.out_gain_pct = htons(next->out_gain_pct);
+    if (full) {
+        packet->hdr.flags = MIXER_DELTA_FLAG_FULL | MIXER_DELTA_FLAG_OUT_GAIN;
+    } else if (prev->out_gain_pct != next->out_gain_pct) {
+        packet->hdr.flags = MIXER_DELTA_FLAG_OUT_GAIN;
+    }
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < next->stream_count; i++) {
+        const mixer_ctrl_stream_t *stream = &next->streams[i];
+        uint8_t fields = MIXER_DELTA_FIELD_GAIN | MIXER_DELTA_FIELD_FLAGS;
+        if (!full) {
+            const mixer_ctrl_stream_t *old = &prev->streams[i];
+            fields = 0;
+            if (old->gain_pct != stream->gain_pct) {
+                fields |= MIXER_DELTA_FIELD_GAIN;
+            }
+            if (mixer_stream_flags(old) != mixer_stream_flags(stream)) {
+                fields |= MIXER_DELTA_FIELD_FLAGS;
+            }
+            if (fields == 0) {
+                continue;
+            }
+        }
+        mixer_delta_entry_t *entry = &packet->entries[count++];
+        entry->stream_id = stream->stream_id;
+        entry->fields = fields;
+        entry->flags = mixer_stream_flags(stream);
+        entry->gain_pct = htons(stream->gain_pct);
+    }
+    packet->hdr.entry_count = count;
+
+    if (!full && count == 0 && !(packet->hdr.flags & MIXER_DELTA_FLAG_OUT_GAIN)) {
+        return 0;
+    }
+    return sizeof(mixer_delta_header_t) + (size_t)count * sizeof(mixer_delta_entry_t);
+}
+
+size_t mixer_delta_encode_beacon(uint16_t state_version, mixer_delta_packet_t *packet)
+{
+    if (!packet || state_version == 0) {
+        return 0;
+    }
+    memset(packet, 0, sizeof(*packet));
+    packet->hdr.type = NET_PKT_TYPE_MIXER_DELTA;
+    packet->hdr.version = MIXER_CTRL_VERSION;
+    packet->hdr.base_version = htons(state_version);
+    packet->hdr.state_version = htons(state_version);
+    return sizeof(mixer_delta_header_t);
+}
+
+mixer_delta_result_t mixer_delta_apply(const uint8_t *data, size_t len,
+                                       uint16_t *version, mixer_ctrl_message_t *state)
+{
+    if (!data || !version || !state || len < sizeof(mixer_delta_header_t)) {
+        return MIXER_DELTA_INVALID;
+    }
+    const mixer_delta_header_t *hdr = (const mixer_delta_header_t *)data;
+    if (hdr->type != NET_PKT_TYPE_MIXER_DELTA || hdr->version != MIXER_CTRL_VERSION ||
+        hdr->entry_count > MIXER_MAX_STREAMS ||
+        len < sizeof(*hdr) + (size_t)hdr->entry_count * sizeof(mixer_delta_entry_t)) {
+        return MIXER_DELTA_INVALID;
+    }
+
+    uint16_t base_version = ntohs(hdr->base_version);
+    uint16_t state_version = ntohs(hdr->state_version);
+    bool full = (hdr->flags & MIXER_DELTA_FLAG_FULL) != 0;
+    // Full states are authoritative (they also resync nodes after a root reboot
+    // restarts the version counter). Deltas need an exact base match.
+    if (!full) {
+        if (*version != 0 && state_version == *version) {
+            return MIXER_DELTA_STALE;
+        }
+        if (*version == 0 || base_version != *version) {
+            return MIXER_DELTA_GAP;
+        }
+    }
+
+    mixer_ctrl_message_t next = *state;
+    if (full) {
+        next.stream_count = 0;
+        memset(next.streams, 0, sizeof(next.streams));
+    }
+    if (hdr->flags & MIXER_DELTA_FLAG_OUT_GAIN) {
+        next.out_gain_pct = ntohs(hdr->out_gain_pct);
+    }
+
+    const mixer_delta_entry_t *entries = (const mixer_delta_entry_t *)(data + sizeof(*hdr));
+    for (uint8_t i = 0; i < hdr->entry_count; i++) {
+        const mixer_delta_entry_t *entry = &entries[i];
+        mixer_ctrl_stream_t *stream = NULL;
+        for (uint8_t j = 0; j < next.stream_count; j++) {
+            if (next.streams[j].stream_id == entry->stream_id) {
+                stream = &next.streams[j];
+                break;
+            }
+        }
+        if (!stream) {
+            // A delta never adds streams; stream set changes are always sent full.
+            if (!full || next.stream_count >= MIXER_MAX_STREAMS) {
+                return MIXER_DELTA_INVALID;
+            }
+            stream = &next.streams[next.stream_count++];
+            stream->stream_id = entry->stream_id;
+        }
+        if (entry->fields & MIXER_DELTA_FIELD_GAIN) {
+            stream->gain_pct = ntohs(entry->gain_pct);
+        }
+        if (entry->fields & MIXER_DELTA_FIELD_FLAGS) {
+            mixer_stream_set_flags(stream, entry->flags);
+        }
+    }
+    if (!mixer_message_is_valid(&next)) {
+        return MIXER_DELTA_INVALID;
+    }
+
+    *state = next;
+    *version = state_version;
+    return MIXER_DELTA_APPLIED;
+}
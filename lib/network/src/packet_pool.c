@@ -0,0 +1,78 @@
+#include "network/packet_pool.h"
+
+#include <string.h>
+
+static network_pkt_buf_t s_pool[MESH_PKT_POOL_SIZE];
+static atomic_uint s_in_use;
+static atomic_uint s_high_water;
+static atomic_uint s_exhausted;
+
+static void update_high_water(unsigned int in_use)
+{
+    unsigned int seen = atomic_load(&s_high_water);
+    while (in_use > seen && !atomic_compare_exchange_weak(&s_high_water, &seen, in_use)) {
+    }
+}
+
+network_pkt_buf_t *network_pkt_alloc(void)
+{
+    for (int i = 0; i < MESH_PKT_POOL_SIZE; i++) {
+        unsigned int expected = 0;
+        if (atomic_compare_exchange_strong(&s_pool[i].refs, &expected, 1)) {
+            s_pool[i].len = 0;
+            update_high_water(atomic_fetch_add(&s_in_use, 1) + 1);
+            return &s_pool[i];
+        }
+    }
+    atomic_fetch_add(&s_exhausted, 1);
+    return NULL;
+}
+
+void network_pkt_retain(network_pkt_buf_t *buf)
+{
+    if (!buf) {
+        return;
+    }
+    atomic_fetch_add(&buf->refs, 1);
+}
+
+void network_pkt_release(network_pkt_buf_t *buf)
+{
+    if (!buf) {
+        return;
+    }
+    unsigned int refs = atomic_load(&buf->refs);
+    while (refs > 0 && !atomic_compare_exchange_weak(&buf->refs, &refs, refs - 1)) {
+    }
+    if (refs == 1) {
+        atomic_fetch_sub(&s_in_use, 1);
+    }
+}
+
+void network_pkt_pool_get_stats(network_pkt_pool_stats_t *out_stats)
+{
+    if (!out_stats) {
+        return;
+    }
+    out_stats->capacity = MESH_PKT_POOL_SIZE;
+    out_stats->in_use = atomic_load(&s_in_use);
+    out_stats->high_water = atomic_load(&s_high_water);
+    out_stats->exhausted = atomic_load(&s_exhausted);
+}
+
+void network_pkt_pool_reset_stats(void)
+{
+    atomic_store(&s_high_water, atomic_load(&s_in_use));
+    atomic_store(&s_exhausted, 0);
+}
+
+void network_pkt_pool_reset(void)
+{
+    for (int i = 0; i < MESH_PKT_POOL_SIZE; i++) {
+        atomic_store(&s_pool[i].refs, 0);
+        s_pool[i].len = 0;
+    }
+    atomic_store(&s_in_use, 0);
+    atomic_store(&s_high_water, 0);
+    atomic_store(&s_exhausted, 0);
+}
@@ -0,0 +1,193 @@
+#include "network/rtt_estimator.h"
+
+#include <string.h>
+
+// First index whose value is >= rtt_us.
+static uint16_t sorted_lower_bound(const network_rtt_window_t *window, uint32_t rtt_us)
+{
+    uint16_t lo = 0;
+    uint16_t hi = window->count;
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (window->sorted[mid] < rtt_us) {
+            lo = (uint16_t)(mid + 1);
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void network_rtt_window_init(network_rtt_window_t *window)
+{
+    if (!window) {
+        return;
+    }
+    memset(window, 0, sizeof(*window));
+}
+
+void network_rtt_window_add(network_rtt_window_t *window, uint32_t rtt_us)
+{
+    if (!window) {
+        return;
+    }
+
+    if (window->count == MESH_RTT_WINDOW_SAMPLES) {
+        // Retire the oldest sample from the sorted copy before reusing its ring slot.
+        uint32_t oldest = window->ring[window->head];
+        uint16_t at = sorted_lower_bound(window, oldest);
+        memmove(&window->sorted[at], &window->sorted[at + 1],
+                (size_t)(window->count - at - 1) * sizeof(window->sorted[0]));
+        window->count--;
+    }
+
+    uint16_t at = sorted_lower_bound(window, rtt_us);
+    memmove(&window->sorted[at + 1], &window->sorted[at],
+            (size_t)(window->count - at) * sizeof(window->sorted[0]));
+    window->sorted[at] = rtt_us;
+    window->count++;
+
+    window->ring[window->head] = rtt_us;
+    window->head = (uint16_t)((window->head + 1) % MESH_RTT_WINDOW_SAMPLES);
+    window->total_samples++;
+}
+
+uint32_t network_rtt_window_quantile(const network_rtt_window_t *window, uint8_t pct)
+{
+    if (!window || window->count == 0) {
+        return 0;
+    }
+    if (pct > 100) {
+        pct = 100;
+    }
+    // Nearest rank: ceil(pct/100 * n), 1-based.
+    uint32_t rank = ((uint32_t)pct * window->count + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    return window->sorted[rank - 1];
+}
+
+bool network_rtt_window_summary(const network_rtt_window_t *window, network_rtt_summary_t *out)
+{
+    if (!out) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!window || window->count == 0) {
+        return false;
+    }
+    out->samples = window->count;
+    out->min_us = window->sorted[0];
+    out->p50_us = network_rtt_window_quantile(window, 50);
+    out->p95_us = network_rtt_window_quantile(window, 95);
+    out->max_us = window->sorted[window->count - 1];
+    return true;
+}
+
+void network_ping_tracker_init(network_ping_tracker_t *tracker)
+{
+    if (!tracker) {
+        return;
+    }
+    memset(tracker, 0, sizeof(*tracker));
+}
+
+uint32_t network_ping_tracker_start(network_ping_tracker_t *tracker, network_ping_direction_t direction,
+                                    const uint8_t mac[6], int64_t now_us)
+{
+    if (!tracker) {
+        return 0;
+    }
+    for (int i = 0; i < MESH_PING_MAX_INFLIGHT; i++) {
+        network_ping_slot_t *slot = &tracker->slots[i];
+        if (slot->in_use) {
+            continue;
+        }
+        // ID 0 is reserved for "no slot".
+        if (++tracker->next_id == 0) {
+            tracker->next_id = 1;
+        }
+        slot->in_use = true;
+        slot->direction = (uint8_t)direction;
+        if (mac) {
+            memcpy(slot->mac, mac, sizeof(slot->mac));
+        } else {
+            memset(slot->mac, 0, sizeof(slot->mac));
+        }
+        slot->id = tracker->next_id;
+        slot->sent_us = now_us;
+        return slot->id;
+    }
+    return 0;
+}
+
+void network_ping_tracker_cancel(network_ping_tracker_t *tracker, uint32_t id)
+{
+    if (!tracker || id == 0) {
+        return;
+    }
+    for (int i = 0; i < MESH_PING_MAX_INFLIGHT; i++) {
+        if (tracker->slots[i].in_use && tracker->slots[i].id == id) {
+            tracker->slots[i].in_use = false;
+            return;
+        }
+    }
+}
+
+bool network_ping_tracker_complete(network_ping_tracker_t *tracker, uint32_t id, int64_t now_us,
+                                   uint32_t *rtt_us_out, network_ping_slot_t *slot_out)
+{
+    if (!tracker || id == 0) {
+        return false;
+    }
+    for (int i = 0; i < MESH_PING_MAX_INFLIGHT; i++) {
+        network_ping_slot_t *slot = &tracker->slots[i];
+        if (!slot->in_use || slot->id != id) {
+            continue;
+        }
+        int64_t rtt_us = now_us - slot->sent_us;
+        if (rtt_us < 0) {
+            rtt_us = 0;
+        }
+        if (rtt_us_out) {
+            *rtt_us_out = rtt_us > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt_us;
+        }
+        if (slot_out) {
+            *slot_out = *slot;
+        }
+        slot->in_use = false;
+        return true;
+    }
+    return false;
+}
+
+size_t network_ping_tracker_expire(network_ping_tracker_t *tracker, int64_t now_us, int64_t timeout_us)
+{
+    if (!tracker) {
+        return 0;
+    }
+    size_t expired = 0;
+    for (int i = 0; i < MESH_PING_MAX_INFLIGHT; i++) {
+        network_ping_slot_t *slot = &tracker->slots[i];
+        if (slot->in_use && (now_us - slot->sent_us) > timeout_us) {
+            slot->in_use = false;
+            expired++;
+        }
+    }
+    return expired;
+}
+
+size_t network_ping_tracker_inflight(const network_ping_tracker_t *tracker, network_ping_direction_t direction)
+{
+    if (!tracker) {
+        return 0;
+    }
+    size_t inflight = 0;
+    for (int i = 0; i < MESH_PING_MAX_INFLIGHT; i++) {
+        if (tracker->slots[i].in_use && tracker->slots[i].direction == (uint8_t)direction) {
+            inflight++;
+        }
+    }
+    return inflight;
+}
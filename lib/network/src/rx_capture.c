@@ -0,0 +1,248 @@
+#include "network/rx_capture.h"
+
+#include <string.h>
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+// Ring copies; every record is written and read through these so one may wrap.
+static void ring_put(network_rx_capture_t *cap, size_t off, const uint8_t *src, size_t len)
+{
+    size_t first = cap->size - off;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(cap->buf + off, src, first);
+    memcpy(cap->buf, src + first, len - first);
+}
+
+static void ring_get(const network_rx_capture_t *cap, size_t off, uint8_t *dst, size_t len)
+{
+    size_t first = cap->size - off;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(dst, cap->buf + off, first);
+    memcpy(dst + first, cap->buf, len - first);
+}
+
+static size_t ring_advance(const network_rx_capture_t *cap, size_t off, size_t len)
+{
+    off += len;
+    return off >= cap->size ? off - cap->size : off;
+}
+
+static size_t record_size_at(const network_rx_capture_t *cap, size_t off)
+{
+    uint8_t hdr[NET_RX_CAPTURE_REC_HEADER];
+    ring_get(cap, off, hdr, sizeof(hdr));
+    return NET_RX_CAPTURE_REC_HEADER + get_u16(hdr + 13);
+}
+
+void network_rx_capture_init(network_rx_capture_t *cap, uint8_t *buf, size_t size, uint16_t snaplen)
+{
+    if (!cap) {
+        return;
+    }
+    memset(cap, 0, sizeof(*cap));
+    cap->buf = buf;
+    cap->size = buf ? size : 0;
+    cap->snaplen = snaplen;
+}
+
+void network_rx_capture_clear(network_rx_capture_t *cap)
+{
+    if (!cap) {
+        return;
+    }
+    network_rx_capture_init(cap, cap->buf, cap->size, cap->snaplen);
+}
+
+static void evict_oldest(network_rx_capture_t *cap)
+{
+    size_t rec_size = record_size_at(cap, cap->tail);
+    cap->tail = ring_advance(cap, cap->tail, rec_size);
+    cap->used -= rec_size;
+    cap->records--;
+    cap->overwritten++;
+    if (cap->records > 0) {
+        // The next record becomes the time base; its delta folds into first_us.
+        uint8_t dt[4];
+        ring_get(cap, cap->tail, dt, sizeof(dt));
+        cap->first_us += get_u32(dt);
+    }
+}
+
+bool network_rx_capture_record(network_rx_capture_t *cap, int64_t arrival_us, const uint8_t from[6],
+                               uint8_t flag, const uint8_t *data, size_t len)
+{
+    if (!cap || !cap->buf || (!data && len > 0)) {
+        return false;
+    }
+    size_t keep = len;
+    if (keep > UINT16_MAX) {
+        keep = UINT16_MAX;
+    }
+    if (cap->snaplen > 0 && keep > cap->snaplen) {
+        keep = cap->snaplen;
+    }
+    size_t rec_size = NET_RX_CAPTURE_REC_HEADER + keep;
+    if (rec_size > cap->size) {
+        return false;
+    }
+    while (cap->size - cap->used < rec_size) {
+        evict_oldest(cap);
+    }
+
+    uint32_t dt = 0;
+    if (cap->records == 0) {
+        cap->first_us = arrival_us;
+        cap->last_us = arrival_us;
+    } else if (arrival_us > cap->last_us) {
+        // Gaps beyond ~71 minutes are clamped; replay timing after them is approximate.
+        int64_t delta = arrival_us - cap->last_us;
+        dt = delta > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)delta;
+        cap->last_us = arrival_us;
+    }
+
+    uint8_t hdr[NET_RX_CAPTURE_REC_HEADER];
+    put_u32(hdr, dt);
+    if (from) {
+        memcpy(hdr + 4, from, 6);
+    } else {
+        memset(hdr + 4, 0, 6);
+    }
+    hdr[10] = flag;
+    put_u16(hdr + 11, (uint16_t)(len > UINT16_MAX ? UINT16_MAX : len));
+    put_u16(hdr + 13, (uint16_t)keep);
+
+    ring_put(cap, cap->head, hdr, sizeof(hdr));
+    ring_put(cap, ring_advance(cap, cap->head, sizeof(hdr)), data, keep);
+    cap->head = ring_advance(cap, cap->head, rec_size);
+    cap->used += rec_size;
+    cap->records++;
+    return true;
+}
+
+size_t network_rx_capture_dump_size(const network_rx_capture_t *cap)
+{
+    return NET_RX_CAPTURE_FILE_HEADER + (cap ? cap->used : 0);
+}
+
+bool network_rx_capture_dump(const network_rx_capture_t *cap, network_rx_capture_write_fn write, void *ctx)
+{
+    if (!cap || !write) {
+        return false;
+    }
+    uint8_t hdr[NET_RX_CAPTURE_FILE_HEADER];
+    put_u32(hdr, NET_RX_CAPTURE_MAGIC);
+    put_u16(hdr + 4, NET_RX_CAPTURE_VERSION);
+    put_u16(hdr + 6, NET_RX_CAPTURE_FILE_HEADER);
+    put_u32(hdr + 8, (uint32_t)(uint64_t)cap->first_us);
+    put_u32(hdr + 12, (uint32_t)((uint64_t)cap->first_us >> 32));
+    put_u32(hdr + 16, cap->records);
+    put_u32(hdr + 20, cap->overwritten);
+    put_u16(hdr + 24, cap->snaplen);
+    if (!write(ctx, hdr, sizeof(hdr))) {
+        return false;
+    }
+
+    size_t off = cap->tail;
+    for (uint32_t i = 0; i < cap->records; i++) {
+        uint8_t rec[NET_RX_CAPTURE_REC_HEADER];
+        ring_get(cap, off, rec, sizeof(rec));
+        if (i == 0) {
+            // Relative to first_us in the file header.
+            put_u32(rec, 0);
+        }
+        size_t len = get_u16(rec + 13);
+        size_t data_off = ring_advance(cap, off, sizeof(rec));
+        size_t first = cap->size - data_off;
+        if (first > len) {
+            first = len;
+        }
+        if (!write(ctx, rec, sizeof(rec)) ||
+            (first > 0 && !write(ctx, cap->buf + data_off, first)) ||
+            (len > first && !write(ctx, cap->buf, len - first))) {
+            return false;
+        }
+        off = ring_advance(cap, data_off, len);
+    }
+    return true;
+}
+
+bool network_rx_capture_reader_init(network_rx_capture_reader_t *reader, const uint8_t *data, size_t len)
+{
+    if (!reader || !data || len < NET_RX_CAPTURE_FILE_HEADER) {
+        return false;
+    }
+    uint16_t header_size = get_u16(data + 6);
+    if (get_u32(data) != NET_RX_CAPTURE_MAGIC || get_u16(data + 4) != NET_RX_CAPTURE_VERSION ||
+        header_size < NET_RX_CAPTURE_FILE_HEADER || header_size > len) {
+        return false;
+    }
+    memset(reader, 0, sizeof(*reader));
+    reader->data = data;
+    reader->len = len;
+    reader->pos = header_size;
+    reader->arrival_us = (int64_t)((uint64_t)get_u32(data + 8) | ((uint64_t)get_u32(data + 12) << 32));
+    reader->records = get_u32(data + 16);
+    reader->overwritten = get_u32(data + 20);
+    reader->snaplen = get_u16(data + 24);
+    reader->remaining = reader->records;
+    return true;
+}
+
+bool network_rx_capture_next(network_rx_capture_reader_t *reader, network_rx_capture_record_t *rec)
+{
+    if (!reader || !rec || reader->remaining == 0 ||
+        reader->len - reader->pos < NET_RX_CAPTURE_REC_HEADER) {
+        return false;
+    }
+    const uint8_t *p = reader->data + reader->pos;
+    uint16_t cap_len = get_u16(p + 13);
+    if (reader->len - reader->pos - NET_RX_CAPTURE_REC_HEADER < cap_len) {
+        return false;
+    }
+    reader->arrival_us += get_u32(p);
+    rec->arrival_us = reader->arrival_us;
+    memcpy(rec->from, p + 4, 6);
+    rec->flag = p[10];
+    rec->orig_len = get_u16(p + 11);
+    rec->len = cap_len;
+    rec->data = p + NET_RX_CAPTURE_REC_HEADER;
+    reader->pos += NET_RX_CAPTURE_REC_HEADER + cap_len;
+    reader->remaining--;
+    return true;
+}
+
+uint32_t network_rx_capture_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
@@ -0,0 +1,322 @@
+#include "network/stat_counters.h"
+
+#include <string.h>
+
+#define SHARED_SHARD (STAT_COUNTER_SHARDS - 1)
+
+static _Atomic uint32_t *shard_words(const network_stat_counters_t *counters, size_t index)
+{
+    return counters->words + index * counters->word_count;
+}
+
+static size_t shard_index(const network_stat_counters_t *counters, const network_stat_shard_t *shard)
+{
+    return (size_t)(shard - counters->shards);
+}
+
+static bool shard_is_shared(const network_stat_counters_t *counters, const network_stat_shard_t *shard)
+{
+    return shard_index(counters, shard) == SHARED_SHARD;
+}
+
+static bool stat_word_valid(const network_stat_counters_t *counters, const network_stat_shard_t *shard, size_t word)
+{
+    return counters && shard && word < counters->word_count &&
+           shard >= counters->shards && shard <= &counters->shards[SHARED_SHARD];
+}
+
+void network_stat_counters_init(network_stat_counters_t *counters, _Atomic uint32_t *words,
+                                uint32_t *baseline, size_t word_count,
+                                const uint16_t *gauges, size_t gauge_count)
+{
+    if (!counters) {
+        return;
+    }
+    memset(counters, 0, sizeof(*counters));
+    counters->words = words;
+    counters->baseline = baseline;
+    counters->word_count = word_count;
+    counters->gauges = gauges;
+    counters->gauge_count = gauge_count;
+    if (words) {
+        for (size_t i = 0; i < (size_t)STAT_COUNTER_SHARDS * word_count; i++) {
+            atomic_init(&words[i], 0);
+        }
+    }
+    if (baseline) {
+        memset(baseline, 0, word_count * sizeof(uint32_t));
+    }
+}
+
+network_stat_shard_t *network_stat_shard(network_stat_counters_t *counters, const void *owner)
+{
+    if (!counters) {
+        return NULL;
+    }
+    uintptr_t id = (uintptr_t)owner;
+    if (id == 0) {
+        return &counters->shards[SHARED_SHARD];
+    }
+    for (size_t i = 0; i < SHARED_SHARD; i++) {
+        if (atomic_load_explicit(&counters->shards[i].owner, memory_order_relaxed) == id) {
+            return &counters->shards[i];
+        }
+    }
+    for (size_t i = 0; i < SHARED_SHARD; i++) {
+        uintptr_t expected = 0;
+        if (atomic_compare_exchange_strong(&counters->shards[i].owner, &expected, id)) {
+            return &counters->shards[i];
+        }
+    }
+    return &counters->shards[SHARED_SHARD];
+}
+
+// Owner-only: mark the shard busy and clear its gauges if a reset happened since
+// its last update.
+static unsigned shard_write_begin(network_stat_counters_t *counters, network_stat_shard_t *shard)
+{
+    unsigned seq = atomic_load_explicit(&shard->seq, memory_order_relaxed);
+    atomic_store_explicit(&shard->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    unsigned epoch = atomic_load_explicit(&counters->epoch, memory_order_relaxed);
+    if (atomic_load_explicit(&shard->epoch, memory_order_relaxed) != epoch) {
+        _Atomic uint32_t *words = shard_words(counters, shard_index(counters, shard));
+        for (size_t g = 0; g < counters->gauge_count; g++) {
+            atomic_store_explicit(&words[counters->gauges[g]], 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&shard->epoch, epoch, memory_order_relaxed);
+    }
+    return seq;
+}
+
+static void shard_write_end(network_stat_shard_t *shard, unsigned seq)
+{
+    atomic_store_explicit(&shard->seq, seq + 2, memory_order_release);
+}
+
+void network_stat_add(network_stat_counters_t *counters, network_stat_shard_t *shard,
+                      size_t word, uint32_t n)
+{
+    if (!stat_word_valid(counters, shard, word)) {
+        return;
+    }
+    _Atomic uint32_t *slot = &shard_words(counters, shard_index(counters, shard))[word];
+    if (shard_is_shared(counters, shard)) {
+        atomic_fetch_add_explicit(slot, n, memory_order_relaxed);
+        return;
+    }
+    unsigned seq = shard_write_begin(counters, shard);
+    atomic_store_explicit(slot, atomic_load_explicit(slot, memory_order_relaxed) + n, memory_order_relaxed);
+    shard_write_end(shard, seq);
+}
+
+void network_stat_set(network_stat_counters_t *counters, network_stat_shard_t *shard,
+                      size_t word, uint32_t value)
+{
+    if (!stat_word_valid(counters, shard, word)) {
+        return;
+    }
+    _Atomic uint32_t *slot = &shard_words(counters, shard_index(counters, shard))[word];
+    if (shard_is_shared(counters, shard)) {
+        atomic_store_explicit(slot, value, memory_order_relaxed);
+        return;
+    }
+    unsigned seq = shard_write_begin(counters, shard);
+    atomic_store_explicit(slot, value, memory_order_relaxed);
+    shard_write_end(shard, seq);
+}
+
+void network_stat_max(network_stat_counters_t *counters, network_stat_shard_t *shard,
+                      size_t word, uint32_t value)
+{
+    if (!stat_word_valid(counters, shard, word)) {
+        return;
+    }
+    _Atomic uint32_t *slot = &shard_words(counters, shard_index(counters, shard))[word];
+    if (shard_is_shared(counters, shard)) {
+        uint32_t cur = atomic_load_explicit(slot, memory_order_relaxed);
+        while (value > cur &&
+               !atomic_compare_exchange_weak_explicit(slot, &cur, value,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+        }
+        return;
+    }
+    unsigned seq = shard_write_begin(counters, shard);
+    if (value > atomic_load_explicit(slot, memory_order_relaxed)) {
+        atomic_store_explicit(slot, value, memory_order_relaxed);
+    }
+    shard_write_end(shard, seq);
+}
+
+// Copies one shard. Retries are bounded: a reader that preempted the owner
+// mid-update on the same core would otherwise spin forever; after the last
+// retry it keeps the copy, which is off by at most that one update.
+static bool shard_read(network_stat_counters_t *counters, size_t index, unsigned epoch, uint32_t *dst)
+{
+    network_stat_shard_t *shard = &counters->shards[index];
+    const _Atomic uint32_t *words = shard_words(counters, index);
+    bool gauges_current = true;
+
+    for (int attempt = 0;; attempt++) {
+        unsigned seq_before = atomic_load_explicit(&shard->seq, memory_order_acquire);
+        if ((seq_before & 1u) && attempt < STAT_SNAPSHOT_RETRIES) {
+            continue;
+        }
+        for (size_t w = 0; w < counters->word_count; w++) {
+            dst[w] = atomic_load_explicit(&words[w], memory_order_relaxed);
+        }
+        if (index != SHARED_SHARD) {
+            gauges_current = atomic_load_explicit(&shard->epoch, memory_order_relaxed) == epoch;
+        }
+        atomic_thread_fence(memory_order_acquire);
+        unsigned seq_after = atomic_load_explicit(&shard->seq, memory_order_relaxed);
+        if (seq_before == seq_after || attempt >= STAT_SNAPSHOT_RETRIES) {
+            break;
+        }
+    }
+    return gauges_current;
+}
+
+void network_stat_totals(network_stat_counters_t *counters, uint32_t *out)
+{
+    if (!counters || !out || counters->word_count > STAT_COUNTER_MAX_WORDS) {
+        return;
+    }
+    uint32_t copy[STAT_COUNTER_MAX_WORDS];
+    unsigned epoch = atomic_load_explicit(&counters->epoch, memory_order_relaxed);
+
+    memset(out, 0, counters->word_count * sizeof(uint32_t));
+    for (size_t i = 0; i < STAT_COUNTER_SHARDS; i++) {
+        if (i != SHARED_SHARD && atomic_load_explicit(&counters->shards[i].owner, memory_order_relaxed) == 0) {
+            continue;
+        }
+        bool gauges_current = shard_read(counters, i, epoch, copy);
+        uint32_t saved[STAT_COUNTER_MAX_GAUGES];
+        for (size_t g = 0; g < counters->gauge_count && g < STAT_COUNTER_MAX_GAUGES; g++) {
+            saved[g] = out[counters->gauges[g]];
+        }
+        for (size_t w = 0; w < counters->word_count; w++) {
+            out[w] += copy[w];
+        }
+        for (size_t g = 0; g < counters->gauge_count && g < STAT_COUNTER_MAX_GAUGES; g++) {
+            uint16_t w = counters->gauges[g];
+            uint32_t value = gauges_current ? copy[w] : 0;
+            out[w] = value > saved[g] ? value : saved[g];
+        }
+    }
+}
+
+void network_stat_snapshot(network_stat_counters_t *counters, uint32_t *out)
+{
+    if (!counters || !out) {
+        return;
+    }
+    network_stat_totals(counters, out);
+    if (counters->baseline) {
+        for (size_t w = 0; w < counters->word_count; w++) {
+            out[w] -= counters->baseline[w];
+        }
+    }
+}
+
+void network_stat_snapshot_and_reset(network_stat_counters_t *counters, uint32_t *out)
+{
+    if (!counters || !out || !counters->baseline || counters->word_count > STAT_COUNTER_MAX_WORDS) {
+        return;
+    }
+    uint32_t totals[STAT_COUNTER_MAX_WORDS];
+    network_stat_totals(counters, totals);
+    for (size_t w = 0; w < counters->word_count; w++) {
+        out[w] = totals[w] - counters->baseline[w];
+        counters->baseline[w] = totals[w];
+    }
+
+    // Gauges are never baselined: bumping the epoch makes every owned shard
+    // clear its gauges on its next update and hides them from readers until then.
+    _Atomic uint32_t *shared = shard_words(counters, SHARED_SHARD);
+    for (size_t g = 0; g < counters->gauge_count; g++) {
+        counters->baseline[counters->gauges[g]] = 0;
+        atomic_store_explicit(&shared[counters->gauges[g]], 0, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&counters->epoch, 1, memory_order_relaxed);
+}
+
+uint32_t network_stat_read(network_stat_counters_t *counters, size_t word)
+{
+    if (!counters || word >= counters->word_count) {
+        return 0;
+    }
+    bool gauge = false;
+    for (size_t g = 0; g < counters->gauge_count; g++) {
+        if (counters->gauges[g] == word) {
+            gauge = true;
+            break;
+        }
+    }
+
+    unsigned epoch = atomic_load_explicit(&counters->epoch, memory_order_relaxed);
+    uint32_t total = 0;
+    for (size_t i = 0; i < STAT_COUNTER_SHARDS; i++) {
+        uint32_t value = atomic_load_explicit(&shard_words(counters, i)[word], memory_order_relaxed);
+        if (!gauge) {
+            total += value;
+        } else if ((i == SHARED_SHARD ||
+                    atomic_load_explicit(&counters->shards[i].epoch, memory_order_relaxed) == epoch) &&
+                   value > total) {
+            total = value;
+        }
+    }
+    if (!gauge && counters->baseline) {
+        total -= counters->baseline[word];
+    }
+    return total;
+}
+
+static void rate_ewma(float *rate, float instant, float elapsed_s, float window_s)
+{
+    float alpha = elapsed_s / window_s;
+    if (alpha > 1.0f) {
+        alpha = 1.0f;
+    }
+    *rate += alpha * (instant - *rate);
+}
+
+void network_stat_rates_update(network_stat_rates_t *rates, const uint32_t *totals, int64_t now_us)
+{
+    if (!rates || !totals || !rates->last || !rates->rates) {
+        return;
+    }
+    if (!rates->primed) {
+        memcpy(rates->last, totals, rates->word_count * sizeof(uint32_t));
+        memset(rates->rates, 0, rates->word_count * sizeof(network_stat_rate_t));
+        rates->last_us = now_us;
+        rates->primed = true;
+        return;
+    }
+    if (now_us <= rates->last_us) {
+        return;
+    }
+
+    float elapsed_s = (float)(now_us - rates->last_us) / 1000000.0f;
+    for (size_t w = 0; w < rates->word_count; w++) {
+        uint32_t delta = totals[w] - rates->last[w];
+        float instant = (float)delta / elapsed_s;
+        network_stat_rate_t *rate = &rates->rates[w];
+        rate->per_sec_1s = instant;
+        rate_ewma(&rate->per_sec_10s, instant, elapsed_s, 10.0f);
+        rate_ewma(&rate->per_sec_60s, instant, elapsed_s, 60.0f);
+        rates->last[w] = totals[w];
+    }
+    rates->last_us = now_us;
+    rates->valid = true;
+}
+
+bool network_stat_rates_get(const network_stat_rates_t *rates, size_t word, network_stat_rate_t *out)
+{
+    if (!rates || !out || !rates->rates || word >= rates->word_count || !rates->valid) {
+        return false;
+    }
+    *out = rates->rates[word];
+    return true;
+}
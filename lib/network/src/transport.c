@@ -0,0 +1,63 @@
+#include "network/transport.h"
+
+#include <stddef.h>
+
+static const network_transport_t *active_transport = NULL;
+
+void network_transport_set(const network_transport_t *transport)
+{
+    active_transport = (transport && transport->ops) ? transport : NULL;
+}
+
+const network_transport_t *network_transport_get(void)
+{
+    return active_transport;
+}
+
+esp_err_t network_transport_send_audio(const network_node_addr_t *to, const uint8_t *data, size_t len)
+{
+    const network_transport_t *t = active_transport;
+    if (!t || !t->ops->send_audio) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return t->ops->send_audio(t->ctx, to, data, len);
+}
+
+esp_err_t network_transport_send_control(const network_node_addr_t *to, const uint8_t *data, size_t len)
+{
+    const network_transport_t *t = active_transport;
+    if (!t || !t->ops->send_control) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return t->ops->send_control(t->ctx, to, data, len);
+}
+
+esp_err_t network_transport_recv(network_node_addr_t *from, uint8_t *buf, size_t *len, uint32_t timeout_ms)
+{
+    const network_transport_t *t = active_transport;
+    if (!t || !t->ops->recv) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!from || !buf || !len || *len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return t->ops->recv(t->ctx, from, buf, len, timeout_ms);
+}
+
+int network_transport_topology(network_node_addr_t *nodes, int max_nodes, bool *is_root)
+{
+    const network_transport_t *t = active_transport;
+    if (is_root) {
+        *is_root = false;
+    }
+    if (!t || !t->ops->topology || !nodes || max_nodes <= 0) {
+        return 0;
+    }
+    return t->ops->topology(t->ctx, nodes, max_nodes, is_root);
+}
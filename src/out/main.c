@@ -20,6 +20,8 @@
 #include "network/mesh_net.h"
 #include "control/serial_dashboard.h"
 #include "control/memory_monitor.h"
+#include "control/telemetry.h"
+#include "control/renderer.h"
 
 #ifdef CONFIG_USE_ES8388
 #include "audio/es8388_audio.h"
@@ -39,9 +41,7 @@ static out_status_t status = {
     .battery_pct = 0
 };
 
-static display_view_t current_view = DISPLAY_VIEW_AUDIO;
 static adf_pipeline_handle_t rx_pipeline = NULL;
-static uint32_t last_rx_audio_forwarded = 0;
 
 static void on_audio_rx(const uint8_t *payload, size_t len, uint16_t seq, uint32_t ts, const char *src_id) {
     if (rx_pipeline) {
@@ -49,6 +49,63 @@ static void on_audio_rx(const uint8_t *payload, size_t len, uint16_t seq, uint32
     }
 }
 
+// Renderer callbacks: status is only touched on the renderer task.
+static void update_status_from_telemetry(const telemetry_snapshot_t *t) {
+    status.rssi = t->rssi;
+    status.latency_ms = t->latency_ms;
+    status.receiving_audio = t->receiving_audio;
+    if (t->pipeline_valid) {
+        status.buffer_pct = t->pipeline.buffer_fill_percent;
+    }
+}
+
+static void render_display(display_view_t view) {
+    display_render_out(view, &status);
+}
+
+static void render_dashboard(void) {
+    dashboard_render_out(&status);
+}
+
+static bool display_animating(display_view_t view) {
+    return display_animating_out(view, &status);
+}
+
+static const renderer_config_t render_config = {
+    .view = DISPLAY_VIEW_AUDIO,
+    .update = update_status_from_telemetry,
+    .render_display = render_display,
+    .render_dashboard = render_dashboard,
+    .animating = display_animating,
+};
+
+#if RX_CAPTURE_ENABLED
+// Flight recorder: once the ring has filled for RX_CAPTURE_ARM_MS, the first
+// burst loss freezes it and dumps it over serial for host replay.
+static void rx_capture_poll(int64_t now_ms) {
+    static int64_t armed_at_ms = 0;
+    static uint32_t last_burst_events = 0;
+
+    if (!network_rx_capture_active()) {
+        return;
+    }
+    network_transport_stats_t stats;
+    if (network_get_transport_stats(&stats) != ESP_OK) {
+        return;
+    }
+    bool burst = stats.rx_audio_burst_loss_events != last_burst_events;
+    last_burst_events = stats.rx_audio_burst_loss_events;
+    if (armed_at_ms == 0) {
+        armed_at_ms = now_ms + RX_CAPTURE_ARM_MS;
+        return;
+    }
+    if (burst && now_ms >= armed_at_ms) {
+        ESP_LOGW(TAG, "Burst loss: freezing RX capture");
+        network_rx_capture_dump_serial();
+    }
+}
+#endif
+
 void app_main(void) {
     ESP_LOGI(TAG, "======================================");
     ESP_LOGI(TAG, "MeshNet Audio OUT starting (Zero Portal)...");
@@ -86,6 +143,12 @@ void app_main(void) {
     // Register callback so mesh packets reach the pipeline
     network_register_audio_callback(on_audio_rx);
 
+#if RX_CAPTURE_ENABLED
+    if (network_rx_capture_start() != ESP_OK) {
+        ESP_LOGW(TAG, "RX capture unavailable");
+    }
+#endif
+
     esp_task_wdt_init(&(esp_task_wdt_config_t){
         .timeout_ms = 5000,
         .idle_core_mask = 0,
@@ -95,36 +158,19 @@ void app_main(void) {
 
     dashboard_init();
     memory_monitor_start_periodic(10000);
-    int64_t last_status_ms = 0;
-    int64_t last_display_ms = 0;
+    if (telemetry_start(rx_pipeline) != ESP_OK) {
+        ESP_LOGW(TAG, "Telemetry publisher failed to start");
+    }
+    if (renderer_start(&render_config) != ESP_OK) {
+        ESP_LOGW(TAG, "Renderer failed to start");
+    }
 
     while (1) {
         esp_task_wdt_reset();
-        vTaskDelay(pdMS_TO_TICKS(10));
-        
-        int64_t now_ms = esp_timer_get_time() / 1000;
-        
-        if (last_status_ms == 0 || (now_ms - last_status_ms) >= 1000) {
-            status.rssi = network_get_rssi();
-            
-            adf_pipeline_stats_t stats;
-            if (adf_pipeline_get_stats(rx_pipeline, &stats) == ESP_OK) {
-                status.buffer_pct = stats.buffer_fill_percent;
-            }
-            
-            network_transport_stats_t tstats;
-            if (network_get_transport_stats(&tstats) == ESP_OK) {
-                status.receiving_audio = (tstats.rx_audio_forwarded > last_rx_audio_forwarded);
-                last_rx_audio_forwarded = tstats.rx_audio_forwarded;
-            }
-            dashboard_render_out(&status);
-            last_status_ms = now_ms;
-        }
-
-        if (last_display_ms == 0 || (now_ms - last_display_ms) >= 100) {
-            display_render_out(current_view, &status);
-            last_display_ms = now_ms;
-        }
+        vTaskDelay(pdMS_TO_TICKS(MAIN_LOOP_PERIOD_MS));
+#if RX_CAPTURE_ENABLED
+        rx_capture_poll(esp_timer_get_time() / 1000);
+#endif
     }
 }
 
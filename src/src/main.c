@@ -26,6 +26,8 @@
 #include "network/mesh_net.h"
 #include "control/serial_dashboard.h"
 #include "control/memory_monitor.h"
+#include "control/telemetry.h"
+#include "control/renderer.h"
 
 #ifdef CONFIG_USE_ES8388
 #include "audio/es8388_audio.h"
@@ -50,7 +52,6 @@ static src_status_t status = {
     .nearest_rssi = -100
 };
 
-static display_view_t current_view = DISPLAY_VIEW_AUDIO;
 static adf_pipeline_handle_t tx_pipeline = NULL;
 
 static input_mode_t status_input_mode_from_adf(adf_input_mode_t mode) {
@@ -59,13 +60,39 @@ static input_mode_t status_input_mode_from_adf(adf_input_mode_t mode) {
     return INPUT_MODE_AUX;
 }
 
-static void update_status_from_pipeline_stats(const adf_pipeline_stats_t *stats) {
-    if (!stats) return;
-    status.input_mode = status_input_mode_from_adf(adf_pipeline_get_input_mode(tx_pipeline));
-    status.audio_active = stats->input_signal_present;
-    status.input_peak = stats->input_peak;
+// Renderer callbacks: status is only touched on the renderer task.
+static void update_status_from_telemetry(const telemetry_snapshot_t *t) {
+    status.connected_nodes = t->connected_nodes;
+    status.input_mode = status_input_mode_from_adf(t->input_mode);
+    status.usb_ready = t->usb_ready;
+    status.usb_active = t->usb_active;
+    if (t->pipeline_valid) {
+        status.audio_active = t->pipeline.input_signal_present;
+        status.input_peak = t->pipeline.input_peak;
+        status.bandwidth_kbps = t->tx_kbps;
+    }
+}
+
+static void render_display(display_view_t view) {
+    display_render_src(view, &status);
 }
 
+static void render_dashboard(void) {
+    dashboard_render_src(&status);
+}
+
+static bool display_animating(display_view_t view) {
+    return display_animating_src(view, &status);
+}
+
+static const renderer_config_t render_config = {
+    .view = DISPLAY_VIEW_AUDIO,
+    .update = update_status_from_telemetry,
+    .render_display = render_display,
+    .render_dashboard = render_dashboard,
+    .animating = display_animating,
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "======================================");
     ESP_LOGI(TAG, "MeshNet Audio SRC starting (Zero Portal)...");
@@ -120,31 +147,16 @@ void app_main(void) {
     }
 
     memory_monitor_start_periodic(10000);
-    int64_t last_status_ms = 0;
-    int64_t last_display_ms = 0;
+    if (telemetry_start(tx_pipeline) != ESP_OK) {
+        ESP_LOGW(TAG, "Telemetry publisher failed to start");
+    }
+    if (renderer_start(&render_config) != ESP_OK) {
+        ESP_LOGW(TAG, "Renderer failed to start");
+    }
 
     while (1) {
         esp_task_wdt_reset();
-        vTaskDelay(pdMS_TO_TICKS(10));
-        
-        int64_t now_ms = esp_timer_get_time() / 1000;
-        
-        if (last_status_ms == 0 || (now_ms - last_status_ms) >= 1000) {
-            status.connected_nodes = network_get_connected_nodes();
-            adf_pipeline_stats_t stats;
-            if (adf_pipeline_get_stats(tx_pipeline, &stats) == ESP_OK) {
-                update_status_from_pipeline_stats(&stats);
-                uint32_t tx_bytes = network_get_tx_bytes_and_reset();
-                status.bandwidth_kbps = (tx_bytes * 8) / 1000;
-            }
-            dashboard_render_src(&status);
-            last_status_ms = now_ms;
-        }
-
-        if (last_display_ms == 0 || (now_ms - last_display_ms) >= 100) {
-            display_render_src(current_view, &status);
-            last_display_ms = now_ms;
-        }
+        vTaskDelay(pdMS_TO_TICKS(MAIN_LOOP_PERIOD_MS));
     }
 }
 
@@ -7,10 +7,18 @@ extern "C" {
 typedef int esp_err_t;
 
 #define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
 #define ESP_ERR_INVALID_ARG 0x102
 #define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_TIMEOUT 0x107
 #define ESP_ERR_MESH_DISCONNECTED 0x4001
 #define ESP_ERR_MESH_NO_ROUTE_FOUND 0x4002
+#define ESP_ERR_MESH_NOT_START 0x4003
+#define ESP_ERR_MESH_TIMEOUT 0x4004
+#define ESP_ERR_MESH_QUEUE_FULL 0x4005
 
 static inline const char *esp_err_to_name(esp_err_t err)
 {
@@ -21,7 +21,44 @@ typedef struct {
     uint8_t bssid[6];
 } mesh_router_t;
 
+typedef enum {
+    MESH_PROTO_BIN = 0,
+} mesh_proto_t;
+
+typedef enum {
+    MESH_TOS_P2P = 0,
+    MESH_TOS_E2E,
+    MESH_TOS_DEF,
+} mesh_tos_t;
+
+typedef struct {
+    uint8_t *data;
+    uint16_t size;
+    mesh_proto_t proto;
+    mesh_tos_t tos;
+} mesh_data_t;
+
+typedef struct {
+    uint8_t type;
+    uint16_t len;
+    uint8_t *val;
+} mesh_opt_t;
+
+#define MESH_DATA_ENC (0x01)
+#define MESH_DATA_P2P (0x02)
+#define MESH_DATA_FROMDS (0x04)
+#define MESH_DATA_TODS (0x08)
+#define MESH_DATA_NONBLOCK (0x10)
+#define MESH_DATA_DROP (0x20)
+#define MESH_DATA_GROUP (0x40)
+
 bool esp_mesh_is_root(void);
+esp_err_t esp_mesh_send(const mesh_addr_t *to, const mesh_data_t *data, int flag,
+                        const mesh_opt_t opt[], int opt_count);
+esp_err_t esp_mesh_recv(mesh_addr_t *from, mesh_data_t *data, int timeout_ms, int *flag,
+                        mesh_opt_t opt[], int opt_count);
+esp_err_t esp_mesh_get_routing_table(mesh_addr_t *mac, int len, int *size);
+esp_err_t esp_mesh_set_group_id(const mesh_addr_t *addr, int num);
 uint8_t esp_mesh_get_layer(void);
 int esp_mesh_get_routing_table_size(void);
 esp_err_t esp_mesh_disconnect(void);
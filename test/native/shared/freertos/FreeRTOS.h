@@ -3,5 +3,12 @@
 #include <stdint.h>
 
 typedef uint32_t StackType_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
 
 #define pdMS_TO_TICKS(ms) (ms)
@@ -2,6 +2,15 @@
 
 #include <stdint.h>
 
+#include "FreeRTOS.h"
+
 typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
 
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                       uint32_t priority, TaskHandle_t *out_handle);
+void vTaskDelete(TaskHandle_t task);
 void vTaskDelay(uint32_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
@@ -0,0 +1,521 @@
+#include "impairment.h"
+#include "control/json_extract.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t impair_rand(network_impair_t *imp)
+{
+    // xorshift32: cheap, and the same seed replays the same impairment run.
+    uint32_t x = imp->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    imp->rng = x;
+    return x;
+}
+
+// Uniform in [0, 1).
+static float impair_uniform(network_impair_t *imp)
+{
+    return (float)(impair_rand(imp) >> 8) * (1.0f / 16777216.0f);
+}
+
+static bool impair_chance(network_impair_t *imp, float p)
+{
+    return p > 0.0f && impair_uniform(imp) < p;
+}
+
+void network_impair_profile_default(network_impair_profile_t *profile)
+{
+    if (!profile) {
+        return;
+    }
+    memset(profile, 0, sizeof(*profile));
+    profile->seed = 1;
+    profile->jitter.shape = 2.0f;
+}
+
+void network_impair_set_profile(network_impair_t *imp, const network_impair_profile_t *profile)
+{
+    if (!imp) {
+        return;
+    }
+    if (profile) {
+        imp->profile = *profile;
+    } else {
+        network_impair_profile_default(&imp->profile);
+    }
+    imp->rng = imp->profile.seed ? imp->profile.seed : 0x9E3779B9u;
+    imp->gilbert_bad = false;
+    imp->spike_left = 0;
+}
+
+void network_impair_init(network_impair_t *imp, const network_impair_profile_t *profile)
+{
+    if (!imp) {
+        return;
+    }
+    memset(imp, 0, sizeof(*imp));
+    network_impair_set_profile(imp, profile);
+}
+
+static bool impair_lost(network_impair_t *imp)
+{
+    const network_impair_profile_t *p = &imp->profile;
+    switch (p->loss.model) {
+        case NETWORK_IMPAIR_LOSS_BERNOULLI:
+            return impair_chance(imp, p->loss.rate);
+        case NETWORK_IMPAIR_LOSS_GILBERT:
+            if (imp->gilbert_bad) {
+                if (impair_chance(imp, p->loss.p_exit_bad)) {
+                    imp->gilbert_bad = false;
+                }
+            } else if (impair_chance(imp, p->loss.p_enter_bad)) {
+                imp->gilbert_bad = true;
+            }
+            return impair_chance(imp, imp->gilbert_bad ? p->loss.loss_bad : p->loss.loss_good);
+        default:
+            return false;
+    }
+}
+
+static int64_t impair_delay_us(network_impair_t *imp, bool count_spike)
+{
+    const network_impair_profile_t *p = &imp->profile;
+    float jitter_ms = 0.0f;
+
+    if (p->jitter.model == NETWORK_IMPAIR_JITTER_PARETO && p->jitter.scale_ms > 0.0f && p->jitter.shape > 0.0f) {
+        // Lomax (Pareto II): scale * (U^(-1/shape) - 1), U in (0, 1].
+        float u = 1.0f - impair_uniform(imp);
+        jitter_ms = p->jitter.scale_ms * (powf(u, -1.0f / p->jitter.shape) - 1.0f);
+    } else if (p->jitter.model == NETWORK_IMPAIR_JITTER_EMPIRICAL && p->jitter.sample_count > 0) {
+        jitter_ms = (float)p->jitter.samples_ms[impair_rand(imp) % p->jitter.sample_count];
+    }
+    if (p->jitter.max_ms > 0 && jitter_ms > (float)p->jitter.max_ms) {
+        jitter_ms = (float)p->jitter.max_ms;
+    }
+
+    int64_t delay_us = (int64_t)p->jitter.base_ms * 1000 + (int64_t)(jitter_ms * 1000.0f);
+    if (!count_spike) {
+        return delay_us;
+    }
+    if (imp->spike_left == 0 && p->spike.packets > 0 && impair_chance(imp, p->spike.rate)) {
+        imp->spike_left = p->spike.packets;
+    }
+    if (imp->spike_left > 0) {
+        imp->spike_left--;
+        imp->stats.spiked++;
+        delay_us += (int64_t)p->spike.extra_ms * 1000;
+    }
+    return delay_us;
+}
+
+static network_impair_slot_t *impair_queue(network_impair_t *imp, const uint8_t *data, size_t len, int64_t due_us)
+{
+    for (size_t i = 0; i < NET_IMPAIR_MAX_INFLIGHT; i++) {
+        network_impair_slot_t *slot = &imp->slots[i];
+        if (slot->used) {
+            continue;
+        }
+        // FIFO floor: a later packet never arrives before an earlier one.
+        if (due_us < imp->last_due_us) {
+            due_us = imp->last_due_us;
+        }
+        imp->last_due_us = due_us;
+        slot->used = true;
+        slot->hold = 0;
+        slot->order = imp->next_order++;
+        slot->due_us = due_us;
+        slot->len = len;
+        memcpy(slot->data, data, len);
+        return slot;
+    }
+    imp->stats.overflow++;
+    return NULL;
+}
+
+// A successor was queued at due_us: held packets count it, and those released
+// now land just behind it.
+static void impair_pass_held(network_impair_t *imp, const network_impair_slot_t *successor)
+{
+    for (size_t i = 0; i < NET_IMPAIR_MAX_INFLIGHT; i++) {
+        network_impair_slot_t *slot = &imp->slots[i];
+        if (!slot->used || slot->hold == 0 || slot == successor) {
+            continue;
+        }
+        if (--slot->hold == 0) {
+            slot->due_us = successor->due_us + 1;
+            slot->order = imp->next_order++;
+            imp->last_due_us = slot->due_us;
+        }
+    }
+}
+
+bool network_impair_submit(network_impair_t *imp, const uint8_t *data, size_t len, int64_t now_us)
+{
+    if (!imp || !data || len == 0 || len > MESH_RX_BUFFER_SIZE) {
+        return false;
+    }
+    imp->stats.submitted++;
+
+    if (impair_lost(imp)) {
+        imp->stats.lost++;
+        return false;
+    }
+
+    network_impair_slot_t *slot = impair_queue(imp, data, len, now_us + impair_delay_us(imp, true));
+    if (!slot) {
+        return false;
+    }
+    impair_pass_held(imp, slot);
+
+    const network_impair_profile_t *p = &imp->profile;
+    if (p->reorder.max_depth > 0 && impair_chance(imp, p->reorder.rate)) {
+        slot->hold = (uint8_t)(1 + impair_rand(imp) % p->reorder.max_depth);
+        imp->stats.reordered++;
+    }
+
+    if (impair_chance(imp, p->duplicate.rate)) {
+        network_impair_slot_t *dup = impair_queue(imp, data, len, now_us + impair_delay_us(imp, false));
+        if (dup) {
+            imp->stats.duplicated++;
+        }
+    }
+    return true;
+}
+
+static network_impair_slot_t *impair_next_due(network_impair_t *imp, int64_t now_us, bool ignore_time)
+{
+    network_impair_slot_t *best = NULL;
+    for (size_t i = 0; i < NET_IMPAIR_MAX_INFLIGHT; i++) {
+        network_impair_slot_t *slot = &imp->slots[i];
+        if (!slot->used || slot->hold > 0 || (!ignore_time && slot->due_us > now_us)) {
+            continue;
+        }
+        if (!best || slot->due_us < best->due_us ||
+            (slot->due_us == best->due_us && (int32_t)(slot->order - best->order) < 0)) {
+            best = slot;
+        }
+    }
+    return best;
+}
+
+static size_t impair_deliver(network_impair_t *imp, int64_t now_us, bool ignore_time,
+                             network_impair_deliver_fn deliver, void *ctx)
+{
+    size_t count = 0;
+    network_impair_slot_t *slot;
+    while ((slot = impair_next_due(imp, now_us, ignore_time)) != NULL) {
+        if (deliver) {
+            deliver(ctx, slot->data, slot->len);
+        }
+        slot->used = false;
+        imp->stats.delivered++;
+        count++;
+    }
+    return count;
+}
+
+size_t network_impair_poll(network_impair_t *imp, int64_t now_us,
+                           network_impair_deliver_fn deliver, void *ctx)
+{
+    if (!imp) {
+        return 0;
+    }
+    return impair_deliver(imp, now_us, false, deliver, ctx);
+}
+
+size_t network_impair_drain(network_impair_t *imp, network_impair_deliver_fn deliver, void *ctx)
+{
+    if (!imp) {
+        return 0;
+    }
+    for (size_t i = 0; i < NET_IMPAIR_MAX_INFLIGHT; i++) {
+        imp->slots[i].hold = 0;
+    }
+    return impair_deliver(imp, 0, true, deliver, ctx);
+}
+
+// ---------------------------------------------------------------------------
+// Fault schedule parsing
+// ---------------------------------------------------------------------------
+
+// json_extract matches compact "key":value pairs; schedules are pretty-printed,
+// so strip whitespace outside strings first.
+static char *impair_json_compact(const char *start, size_t len)
+{
+    char *out = malloc(len + 1);
+    if (!out) {
+        return NULL;
+    }
+    size_t n = 0;
+    bool in_string = false;
+    bool escape = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = start[i];
+        if (in_string) {
+            if (escape) {
+                escape = false;
+            } else if (c == '\\') {
+                escape = true;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            continue;
+        }
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return out;
+}
+
+// Copies the object value of field into a NUL-terminated string (free it), or
+// returns NULL when absent.
+static char *impair_object_field(const char *body, const char *field)
+{
+    const char *start;
+    const char *end;
+    if (!json_extract_object_field_span(body, field, &start, &end)) {
+        return NULL;
+    }
+    return impair_json_compact(start, (size_t)(end - start) + 1);
+}
+
+static bool impair_probability(const char *body, const char *field, float *out)
+{
+    float value;
+    if (!json_extract_float_field(body, field, &value)) {
+        return true;    // Optional: keep the default
+    }
+    if (!(value >= 0.0f && value <= 1.0f)) {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+static bool impair_uint(const char *body, const char *field, uint32_t max, uint32_t *out)
+{
+    int value;
+    if (!json_extract_int_field(body, field, &value)) {
+        return true;
+    }
+    if (value < 0 || (uint32_t)value > max) {
+        return false;
+    }
+    *out = (uint32_t)value;
+    return true;
+}
+
+static bool impair_parse_loss(const char *body, network_impair_profile_t *p)
+{
+    char model[16];
+    if (!json_extract_string_field(body, "model", model, sizeof(model))) {
+        return false;
+    }
+    if (strcmp(model, "none") == 0) {
+        p->loss.model = NETWORK_IMPAIR_LOSS_NONE;
+        return true;
+    }
+    if (strcmp(model, "bernoulli") == 0) {
+        p->loss.model = NETWORK_IMPAIR_LOSS_BERNOULLI;
+        return impair_probability(body, "rate", &p->loss.rate);
+    }
+    if (strcmp(model, "gilbert") == 0) {
+        p->loss.model = NETWORK_IMPAIR_LOSS_GILBERT;
+        return impair_probability(body, "p_enter_bad", &p->loss.p_enter_bad) &&
+               impair_probability(body, "p_exit_bad", &p->loss.p_exit_bad) &&
+               impair_probability(body, "loss_good", &p->loss.loss_good) &&
+               impair_probability(body, "loss_bad", &p->loss.loss_bad);
+    }
+    return false;
+}
+
+static bool impair_parse_samples(const char *body, network_impair_profile_t *p)
+{
+    const char *start;
+    const char *end;
+    if (!json_extract_array_field_span(body, "samples_ms", &start, &end)) {
+        return false;
+    }
+    const char *cursor = start + 1;
+    while (cursor < end) {
+        char *next;
+        long value = strtol(cursor, &next, 10);
+        if (next == cursor || value < 0 || value > UINT16_MAX ||
+            p->jitter.sample_count >= NET_IMPAIR_MAX_JITTER_SAMPLES) {
+            return false;
+        }
+        p->jitter.samples_ms[p->jitter.sample_count++] = (uint16_t)value;
+        cursor = next;
+        if (*cursor == ',') {
+            cursor++;
+        }
+    }
+    return p->jitter.sample_count > 0;
+}
+
+static bool impair_parse_jitter(const char *body, network_impair_profile_t *p)
+{
+    char model[16];
+    if (!impair_uint(body, "base_ms", 10000, &p->jitter.base_ms) ||
+        !impair_uint(body, "max_ms", 10000, &p->jitter.max_ms)) {
+        return false;
+    }
+    if (!json_extract_string_field(body, "model", model, sizeof(model)) || strcmp(model, "none") == 0) {
+        p->jitter.model = NETWORK_IMPAIR_JITTER_NONE;
+        return true;
+    }
+    if (strcmp(model, "pareto") == 0) {
+        p->jitter.model = NETWORK_IMPAIR_JITTER_PARETO;
+        json_extract_float_field(body, "scale_ms", &p->jitter.scale_ms);
+        json_extract_float_field(body, "shape", &p->jitter.shape);
+        return p->jitter.scale_ms >= 0.0f && p->jitter.shape > 0.0f;
+    }
+    if (strcmp(model, "empirical") == 0) {
+        p->jitter.model = NETWORK_IMPAIR_JITTER_EMPIRICAL;
+        return impair_parse_samples(body, p);
+    }
+    return false;
+}
+
+static bool impair_parse_profile(const char *body, network_impair_profile_t *p)
+{
+    network_impair_profile_default(p);
+
+    uint32_t seed = p->seed;
+    if (!impair_uint(body, "seed", UINT32_MAX >> 1, &seed)) {
+        return false;
+    }
+    p->seed = seed;
+
+    bool ok = true;
+    char *section;
+    if (ok && (section = impair_object_field(body, "loss")) != NULL) {
+        ok = impair_parse_loss(section, p);
+        free(section);
+    }
+    if (ok && (section = impair_object_field(body, "jitter")) != NULL) {
+        ok = impair_parse_jitter(section, p);
+        free(section);
+    }
+    if (ok && (section = impair_object_field(body, "reorder")) != NULL) {
+        uint32_t depth = 0;
+        ok = impair_probability(section, "rate", &p->reorder.rate) &&
+             impair_uint(section, "max_depth", UINT8_MAX, &depth);
+        p->reorder.max_depth = (uint8_t)depth;
+        free(section);
+    }
+    if (ok && (section = impair_object_field(body, "duplicate")) != NULL) {
+        ok = impair_probability(section, "rate", &p->duplicate.rate);
+        free(section);
+    }
+    if (ok && (section = impair_object_field(body, "spike")) != NULL) {
+        uint32_t packets = 0;
+        ok = impair_probability(section, "rate", &p->spike.rate) &&
+             impair_uint(section, "extra_ms", 10000, &p->spike.extra_ms) &&
+             impair_uint(section, "packets", UINT16_MAX, &packets);
+        p->spike.packets = (uint16_t)packets;
+        free(section);
+    }
+    return ok;
+}
+
+static bool impair_parse_step(const char *entry, const char *target,
+                              network_impair_schedule_t *out)
+{
+    char action[16];
+    if (!json_extract_string_field(entry, "action", action, sizeof(action))) {
+        return false;
+    }
+    if (strcmp(action, "impair") != 0) {
+        return true;
+    }
+
+    network_impair_step_t step;
+    memset(&step, 0, sizeof(step));
+    if (!json_extract_float_field(entry, "at_seconds", &step.at_seconds) || step.at_seconds < 0.0f ||
+        !json_extract_string_field(entry, "target", step.target, sizeof(step.target))) {
+        return false;
+    }
+    json_extract_string_field(entry, "label", step.label, sizeof(step.label));
+
+    char *profile = impair_object_field(entry, "profile");
+    if (!profile) {
+        return false;
+    }
+    bool ok = impair_parse_profile(profile, &step.profile);
+    free(profile);
+    if (!ok) {
+        return false;
+    }
+
+    if (target && strcmp(step.target, target) != 0 && strcmp(step.target, "BOTH") != 0) {
+        return true;
+    }
+    if (out->count >= NET_IMPAIR_MAX_SCHEDULE_STEPS) {
+        return false;
+    }
+    out->steps[out->count++] = step;
+    return true;
+}
+
+bool network_impair_schedule_parse(const char *json, const char *target,
+                                   network_impair_schedule_t *out)
+{
+    if (!json || !out) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+
+    char *compact = impair_json_compact(json, strlen(json));
+    if (!compact) {
+        return false;
+    }
+    size_t len = strlen(compact);
+    bool ok = len >= 2 && compact[0] == '[' && compact[len - 1] == ']';
+
+    const char *array_end = compact + len - 1;
+    const char *cursor = NULL;
+    while (ok) {
+        const char *obj_start;
+        const char *obj_end;
+        if (!json_extract_next_array_object_span(compact, array_end, &cursor, &obj_start, &obj_end)) {
+            ok = false;
+            break;
+        }
+        if (!obj_start) {
+            break;
+        }
+        // Copy so the entry is NUL-terminated for the json_extract lookups.
+        size_t obj_len = (size_t)(obj_end - obj_start) + 1;
+        char *entry = impair_json_compact(obj_start, obj_len);
+        ok = entry && impair_parse_step(entry, target, out);
+        free(entry);
+    }
+    free(compact);
+    return ok;
+}
+
+const network_impair_profile_t *network_impair_schedule_at(const network_impair_schedule_t *schedule,
+                                                           float t_seconds)
+{
+    if (!schedule) {
+        return NULL;
+    }
+    const network_impair_profile_t *active = NULL;
+    float active_at = -1.0f;
+    for (size_t i = 0; i < schedule->count; i++) {
+        const network_impair_step_t *step = &schedule->steps[i];
+        if (step->at_seconds <= t_seconds && step->at_seconds >= active_at) {
+            active = &step->profile;
+            active_at = step->at_seconds;
+        }
+    }
+    return active;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Seedable network impairment emulator for host runs. Packets go in with their
+// send time and come out of network_impair_poll() once due, after loss,
+// jitter, latency spikes, bounded reorder and duplication. It sits between any
+// producer (frame_codec output, a transport backend) and an RX entry point, so
+// native tests can replay field conditions deterministically.
+//
+// Delivery stays FIFO (multi-hop mesh paths do not overtake) except for packets
+// the reorder model deliberately holds back behind up to max_depth successors.
+// Profiles come from the "impair" steps of tools/fault_schedules/*.json. Host-only:
+// it sits with the native test support code, so firmware never links it (or
+// its control/json_extract dependency).
+
+typedef enum {
+    NETWORK_IMPAIR_LOSS_NONE = 0,
+    NETWORK_IMPAIR_LOSS_BERNOULLI,
+    NETWORK_IMPAIR_LOSS_GILBERT,        // Gilbert-Elliott two-state burst loss
+} network_impair_loss_model_t;
+
+typedef enum {
+    NETWORK_IMPAIR_JITTER_NONE = 0,
+    NETWORK_IMPAIR_JITTER_PARETO,       // Heavy-tailed (Lomax) around base_ms
+    NETWORK_IMPAIR_JITTER_EMPIRICAL,    // Uniform pick from measured samples
+} network_impair_jitter_model_t;
+
+typedef struct {
+    uint32_t seed;
+    struct {
+        network_impair_loss_model_t model;
+        float rate;             // Bernoulli loss probability
+        float p_enter_bad;      // Gilbert: good -> bad per packet
+        float p_exit_bad;       // Gilbert: bad -> good per packet
+        float loss_good;        // Gilbert: loss probability in each state
+        float loss_bad;
+    } loss;
+    struct {
+        network_impair_jitter_model_t model;
+        uint32_t base_ms;       // Fixed one-way delay
+        float scale_ms;         // Pareto scale
+        float shape;            // Pareto shape (alpha); > 1 for a finite mean
+        uint32_t max_ms;        // Cap on the random part, 0 = uncapped
+        uint16_t samples_ms[NET_IMPAIR_MAX_JITTER_SAMPLES];
+        uint8_t sample_count;
+    } jitter;
+    struct {
+        float rate;             // Probability a packet is held back
+        uint8_t max_depth;      // Successors it may fall behind (1..max_depth)
+    } reorder;
+    struct {
+        float rate;
+    } duplicate;
+    struct {
+        float rate;             // Probability a spike starts at a packet
+        uint32_t extra_ms;
+        uint16_t packets;       // Packets delayed per spike
+    } spike;
+} network_impair_profile_t;
+
+typedef struct {
+    uint32_t submitted;
+    uint32_t delivered;
+    uint32_t lost;
+    uint32_t duplicated;
+    uint32_t reordered;
+    uint32_t spiked;
+    uint32_t overflow;          // Dropped because NET_IMPAIR_MAX_INFLIGHT was reached
+} network_impair_stats_t;
+
+typedef struct {
+    bool used;
+    uint8_t hold;               // Successors still to pass before it is released
+    uint32_t order;             // Submission order, tie-break among equal due times
+    int64_t due_us;
+    size_t len;
+    uint8_t data[MESH_RX_BUFFER_SIZE];
+} network_impair_slot_t;
+
+typedef struct {
+    network_impair_profile_t profile;
+    network_impair_stats_t stats;
+    uint32_t rng;
+    bool gilbert_bad;
+    uint16_t spike_left;
+    uint32_t next_order;
+    int64_t last_due_us;        // FIFO floor for the next packet
+    network_impair_slot_t slots[NET_IMPAIR_MAX_INFLIGHT];
+} network_impair_t;
+
+typedef void (*network_impair_deliver_fn)(void *ctx, const uint8_t *data, size_t len);
+
+// A profile with every model off: packets pass through unchanged.
+void network_impair_profile_default(network_impair_profile_t *profile);
+
+void network_impair_init(network_impair_t *imp, const network_impair_profile_t *profile);
+// Swaps models mid-run (schedule step). Packets in flight keep their timing.
+void network_impair_set_profile(network_impair_t *imp, const network_impair_profile_t *profile);
+
+// Queues (or drops) one packet sent at now_us. Returns false when it was lost
+// or did not fit; the copy is taken before returning.
+bool network_impair_submit(network_impair_t *imp, const uint8_t *data, size_t len, int64_t now_us);
+// Delivers every packet due at now_us, in arrival order. Returns the count.
+size_t network_impair_poll(network_impair_t *imp, int64_t now_us,
+                           network_impair_deliver_fn deliver, void *ctx);
+// Delivers everything still queued (end of run), releasing held packets.
+size_t network_impair_drain(network_impair_t *imp, network_impair_deliver_fn deliver, void *ctx);
+
+// Fault schedule "impair" steps, in file order.
+typedef struct {
+    float at_seconds;
+    char target[8];             // "SRC", "OUT" or "BOTH"
+    char label[32];
+    network_impair_profile_t profile;
+} network_impair_step_t;
+
+typedef struct {
+    network_impair_step_t steps[NET_IMPAIR_MAX_SCHEDULE_STEPS];
+    size_t count;
+} network_impair_schedule_t;
+
+// Parses a fault schedule JSON array, keeping "impair" steps for target (or
+// "BOTH"); a NULL target keeps all. Other actions are skipped. An empty
+// "profile" object clears impairment. Returns false on malformed input.
+bool network_impair_schedule_parse(const char *json, const char *target,
+                                   network_impair_schedule_t *out);
+// Profile in force at t_seconds (the last step at or before it), or NULL.
+const network_impair_profile_t *network_impair_schedule_at(const network_impair_schedule_t *schedule,
+                                                           float t_seconds);
+
+#ifdef __cplusplus
+}
+#endif
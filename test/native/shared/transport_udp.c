@@ -0,0 +1,309 @@
+#include "transport_udp.h"
+
+#include <esp_mesh.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+static bool udp_same_node(const network_node_addr_t *a, const network_node_addr_t *b)
+{
+    return memcmp(a->addr, b->addr, sizeof(a->addr)) == 0;
+}
+
+static bool udp_same_sockaddr(const struct sockaddr_in *a, const struct sockaddr_in *b)
+{
+    return a->sin_addr.s_addr == b->sin_addr.s_addr && a->sin_port == b->sin_port;
+}
+
+static int64_t udp_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void udp_envelope(const network_transport_udp_t *udp, uint8_t hdr[NETWORK_TRANSPORT_UDP_HEADER_SIZE])
+{
+    hdr[0] = (uint8_t)(NETWORK_TRANSPORT_UDP_MAGIC >> 8);
+    hdr[1] = (uint8_t)(NETWORK_TRANSPORT_UDP_MAGIC & 0xFF);
+    memcpy(&hdr[2], udp->self.addr, sizeof(udp->self.addr));
+}
+
+static esp_err_t udp_send_one(network_transport_udp_t *udp, const struct sockaddr_in *sa,
+                              const uint8_t *data, size_t len)
+{
+    uint8_t hdr[NETWORK_TRANSPORT_UDP_HEADER_SIZE];
+    udp_envelope(udp, hdr);
+
+    struct iovec iov[2] = {
+        { .iov_base = hdr, .iov_len = sizeof(hdr) },
+        { .iov_base = (void *)data, .iov_len = len },
+    };
+    struct msghdr msg = {
+        .msg_name = (void *)sa,
+        .msg_namelen = sizeof(*sa),
+        .msg_iov = iov,
+        .msg_iovlen = len > 0 ? 2 : 1,
+    };
+
+    if (sendmsg(udp->fd, &msg, MSG_DONTWAIT) >= 0) {
+        return ESP_OK;
+    }
+    // A full socket buffer is the host analogue of the mesh TX queue filling:
+    // report it the same way so backpressure and fanout stats see it.
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+        return ESP_ERR_MESH_QUEUE_FULL;
+    }
+    return ESP_FAIL;
+}
+
+static network_transport_udp_peer_t *udp_find_peer(network_transport_udp_t *udp, const network_node_addr_t *node)
+{
+    for (int i = 0; i < udp->peer_count; i++) {
+        if (udp_same_node(&udp->peers[i].node, node)) {
+            return &udp->peers[i];
+        }
+    }
+    return NULL;
+}
+
+// Root: record (or re-point) a child. A new child gets an envelope-only reply so
+// it learns the root's node address without waiting for traffic.
+static void udp_learn_peer(network_transport_udp_t *udp, const network_node_addr_t *node,
+                           const struct sockaddr_in *sa)
+{
+    network_transport_udp_peer_t *peer = udp_find_peer(udp, node);
+    if (peer) {
+        peer->sa = *sa;
+        return;
+    }
+    if (udp->peer_count >= UDP_TRANSPORT_MAX_PEERS) {
+        udp->peers_dropped++;
+        return;
+    }
+    peer = &udp->peers[udp->peer_count++];
+    peer->node = *node;
+    peer->sa = *sa;
+    udp_send_one(udp, sa, NULL, 0);
+}
+
+static esp_err_t udp_send(void *ctx, const network_node_addr_t *to, const uint8_t *data, size_t len)
+{
+    network_transport_udp_t *udp = (network_transport_udp_t *)ctx;
+    if (udp->fd < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (len > MESH_RX_BUFFER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (!udp->is_root) {
+        if (to && !(udp->root_known && udp_same_node(to, &udp->root.node))) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        return udp_send_one(udp, &udp->root.sa, data, len);
+    }
+
+    if (to) {
+        network_transport_udp_peer_t *peer = udp_find_peer(udp, to);
+        return peer ? udp_send_one(udp, &peer->sa, data, len) : ESP_ERR_NOT_FOUND;
+    }
+
+    // Default route from the root: unicast to every child, like mesh P2P fanout.
+    int sent_ok = 0;
+    esp_err_t first_err = ESP_OK;
+    for (int i = 0; i < udp->peer_count; i++) {
+        esp_err_t err = udp_send_one(udp, &udp->peers[i].sa, data, len);
+        if (err == ESP_OK) {
+            sent_ok++;
+        } else if (first_err == ESP_OK) {
+            first_err = err;
+        }
+    }
+    if (sent_ok > 0) {
+        return ESP_OK;
+    }
+    return first_err != ESP_OK ? first_err : ESP_ERR_NOT_FOUND;
+}
+
+static esp_err_t udp_recv(void *ctx, network_node_addr_t *from, uint8_t *buf, size_t *len, uint32_t timeout_ms)
+{
+    network_transport_udp_t *udp = (network_transport_udp_t *)ctx;
+    if (udp->fd < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t deadline_ms = udp_now_ms() + timeout_ms;
+    while (true) {
+        int wait_ms = -1;
+        if (timeout_ms != NETWORK_TRANSPORT_WAIT_FOREVER) {
+            int64_t left = deadline_ms - udp_now_ms();
+            wait_ms = left > 0 ? (int)left : 0;
+        }
+        struct pollfd pfd = { .fd = udp->fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, wait_ms);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ESP_FAIL;
+        }
+        if (ready == 0) {
+            return ESP_ERR_TIMEOUT;
+        }
+
+        uint8_t hdr[NETWORK_TRANSPORT_UDP_HEADER_SIZE];
+        struct sockaddr_in sa;
+        struct iovec iov[2] = {
+            { .iov_base = hdr, .iov_len = sizeof(hdr) },
+            { .iov_base = buf, .iov_len = *len },
+        };
+        struct msghdr msg = {
+            .msg_name = &sa,
+            .msg_namelen = sizeof(sa),
+            .msg_iov = iov,
+            .msg_iovlen = 2,
+        };
+        ssize_t n = recvmsg(udp->fd, &msg, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNREFUSED) {
+                continue;
+            }
+            return ESP_FAIL;
+        }
+        if ((size_t)n < sizeof(hdr) ||
+            hdr[0] != (uint8_t)(NETWORK_TRANSPORT_UDP_MAGIC >> 8) ||
+            hdr[1] != (uint8_t)(NETWORK_TRANSPORT_UDP_MAGIC & 0xFF)) {
+            udp->rx_invalid++;
+            continue;
+        }
+
+        network_node_addr_t sender;
+        memcpy(sender.addr, &hdr[2], sizeof(sender.addr));
+        if (udp->is_root) {
+            udp_learn_peer(udp, &sender, &sa);
+        } else if (udp_same_sockaddr(&sa, &udp->root.sa)) {
+            udp->root.node = sender;
+            udp->root_known = true;
+        } else {
+            // Children only talk to the root.
+            udp->rx_invalid++;
+            continue;
+        }
+
+        if ((size_t)n == sizeof(hdr)) {
+            continue;   // Announce: no payload for the caller
+        }
+        if (msg.msg_flags & MSG_TRUNC) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        *from = sender;
+        *len = (size_t)n - sizeof(hdr);
+        return ESP_OK;
+    }
+}
+
+static int udp_topology(void *ctx, network_node_addr_t *nodes, int max_nodes, bool *is_root)
+{
+    network_transport_udp_t *udp = (network_transport_udp_t *)ctx;
+    if (is_root) {
+        *is_root = udp->is_root;
+    }
+    int count = 0;
+    nodes[count++] = udp->self;
+    if (udp->is_root) {
+        for (int i = 0; i < udp->peer_count && count < max_nodes; i++) {
+            nodes[count++] = udp->peers[i].node;
+        }
+    }
+    return count;
+}
+
+static const network_transport_ops_t udp_ops = {
+    .name = "udp",
+    .send_audio = udp_send,
+    .send_control = udp_send,
+    .recv = udp_recv,
+    .topology = udp_topology,
+};
+
+esp_err_t network_transport_udp_open(network_transport_udp_t *udp, const network_transport_udp_config_t *cfg)
+{
+    if (!udp || !cfg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(udp, 0, sizeof(*udp));
+    udp->fd = -1;
+    udp->self = cfg->self;
+    udp->is_root = cfg->is_root;
+    udp->transport.ops = &udp_ops;
+    udp->transport.ctx = udp;
+
+    if (!cfg->is_root) {
+        if (!cfg->root_host || cfg->root_port == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        udp->root.sa.sin_family = AF_INET;
+        udp->root.sa.sin_port = htons(cfg->root_port);
+        if (inet_pton(AF_INET, cfg->root_host, &udp->root.sa.sin_addr) != 1) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return ESP_FAIL;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in local = {
+        .sin_family = AF_INET,
+        .sin_port = htons(cfg->bind_port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(fd, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        close(fd);
+        return ESP_FAIL;
+    }
+    udp->fd = fd;
+
+    if (!cfg->is_root) {
+        // Announce so the root can route to us before we send anything.
+        udp_send_one(udp, &udp->root.sa, NULL, 0);
+    }
+    return ESP_OK;
+}
+
+void network_transport_udp_close(network_transport_udp_t *udp)
+{
+    if (!udp || udp->fd < 0) {
+        return;
+    }
+    close(udp->fd);
+    udp->fd = -1;
+}
+
+const network_transport_t *network_transport_udp(network_transport_udp_t *udp)
+{
+    return udp ? &udp->transport : NULL;
+}
+
+uint16_t network_transport_udp_port(const network_transport_udp_t *udp)
+{
+    if (!udp || udp->fd < 0) {
+        return 0;
+    }
+    struct sockaddr_in local;
+    socklen_t len = sizeof(local);
+    if (getsockname(udp->fd, (struct sockaddr *)&local, &len) != 0) {
+        return 0;
+    }
+    return ntohs(local.sin_port);
+}
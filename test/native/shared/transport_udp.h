@@ -0,0 +1,64 @@
+#pragma once
+
+#include "config/build.h"
+#include "network/transport.h"
+
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// POSIX UDP transport backend for host builds (Linux processes over loopback or
+// a LAN). One socket per node. The root binds a known port (UDP_PORT) and learns
+// children from their datagrams; a child announces itself on open so the root
+// can reach it before it sends any audio. Each datagram carries an 8-byte
+// envelope (magic + sender node address) so receivers see node addresses, not
+// socket addresses, exactly as with the mesh backend.
+//
+// Children only reach the root: there is no relaying, so the topology is one
+// layer deep. Host-only (POSIX sockets), so it lives with the native test
+// support code rather than in lib/network.
+
+#define NETWORK_TRANSPORT_UDP_MAGIC       0x534Du   // "SM"
+#define NETWORK_TRANSPORT_UDP_HEADER_SIZE 8
+
+typedef struct {
+    network_node_addr_t self;
+    bool is_root;
+    uint16_t bind_port;         // 0 = ephemeral (children)
+    const char *root_host;      // Children: root's IPv4 address ("127.0.0.1")
+    uint16_t root_port;         // Children: root's port (UDP_PORT)
+} network_transport_udp_config_t;
+
+typedef struct {
+    network_node_addr_t node;
+    struct sockaddr_in sa;
+} network_transport_udp_peer_t;
+
+typedef struct {
+    int fd;
+    network_node_addr_t self;
+    bool is_root;
+    bool root_known;            // Children: root node address seen
+    network_transport_udp_peer_t root;
+    network_transport_udp_peer_t peers[UDP_TRANSPORT_MAX_PEERS];
+    int peer_count;
+    uint32_t peers_dropped;     // Root: senders refused with the table full
+    uint32_t rx_invalid;        // Datagrams without a valid envelope
+    network_transport_t transport;
+} network_transport_udp_t;
+
+esp_err_t network_transport_udp_open(network_transport_udp_t *udp, const network_transport_udp_config_t *cfg);
+void network_transport_udp_close(network_transport_udp_t *udp);
+
+// Backend handle for network_transport_set(); valid while udp is open.
+const network_transport_t *network_transport_udp(network_transport_udp_t *udp);
+// Bound local port (useful with bind_port 0), or 0 when closed.
+uint16_t network_transport_udp_port(const network_transport_udp_t *udp);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,171 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "control/asset_bundle.h"
+
+#include "../../../lib/control/src/asset_bundle.c"
+
+// Builds bundles the way tools/portal_bundle.py lays them out.
+typedef struct {
+    const char *path;
+    const char *type;
+    const char *etag;
+    const char *cache;
+    const char *body;
+    uint32_t flags;
+} fixture_asset_t;
+
+static uint8_t s_buf[1024];
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t append(size_t *off, const void *data, size_t len)
+{
+    uint32_t at = (uint32_t)*off;
+    memcpy(s_buf + *off, data, len);
+    *off += len;
+    return at;
+}
+
+static size_t build_bundle(const fixture_asset_t *assets, uint16_t count)
+{
+    memset(s_buf, 0, sizeof(s_buf));
+    size_t off = ASSET_BUNDLE_HEADER_BYTES + (size_t)count * ASSET_BUNDLE_ENTRY_BYTES;
+    for (uint16_t i = 0; i < count; i++) {
+        const fixture_asset_t *a = &assets[i];
+        uint8_t *e = s_buf + ASSET_BUNDLE_HEADER_BYTES + i * ASSET_BUNDLE_ENTRY_BYTES;
+        put_u32(e + 0, append(&off, a->path, strlen(a->path) + 1));
+        put_u32(e + 4, append(&off, a->type, strlen(a->type) + 1));
+        put_u32(e + 8, append(&off, a->etag, strlen(a->etag) + 1));
+        put_u32(e + 12, append(&off, a->cache, strlen(a->cache) + 1));
+        put_u32(e + 16, append(&off, a->body, strlen(a->body)));
+        put_u32(e + 20, (uint32_t)strlen(a->body));
+        put_u32(e + 24, a->flags);
+    }
+
+    memcpy(s_buf, ASSET_BUNDLE_MAGIC, 4);
+    s_buf[4] = ASSET_BUNDLE_VERSION;
+    s_buf[6] = (uint8_t)count;
+    put_u32(s_buf + 8, (uint32_t)off);
+    uint32_t hash = 2166136261U;
+    for (size_t i = ASSET_BUNDLE_HEADER_BYTES; i < off; i++) {
+        hash = (hash ^ s_buf[i]) * 16777619U;
+    }
+    put_u32(s_buf + 12, hash);
+    return off;
+}
+
+static const fixture_asset_t k_assets[] = {
+    { "/app.css", "text/css", "\"c55\"", "public, max-age=31536000, immutable", "body{}", ASSET_BUNDLE_F_GZIP },
+    { "/app.js", "application/javascript", "\"a11\"", "public, max-age=31536000, immutable", "x=1", ASSET_BUNDLE_F_GZIP },
+    { "/index.html", "text/html; charset=utf-8", "\"1dx\"", "no-cache", "<html></html>", 0 },
+};
+#define ASSET_COUNT ((uint16_t)(sizeof(k_assets) / sizeof(k_assets[0])))
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_open_and_find_every_asset(void)
+{
+    size_t size = build_bundle(k_assets, ASSET_COUNT);
+    asset_bundle_t b;
+    TEST_ASSERT_EQUAL_UINT32(size, asset_bundle_size(s_buf, ASSET_BUNDLE_HEADER_BYTES));
+    TEST_ASSERT_TRUE(asset_bundle_open(&b, s_buf, size));
+    TEST_ASSERT_EQUAL_UINT16(ASSET_COUNT, b.count);
+
+    for (uint16_t i = 0; i < ASSET_COUNT; i++) {
+        asset_bundle_entry_t e;
+        TEST_ASSERT_TRUE(asset_bundle_find(&b, k_assets[i].path, &e));
+        TEST_ASSERT_EQUAL_STRING(k_assets[i].type, e.content_type);
+        TEST_ASSERT_EQUAL_STRING(k_assets[i].etag, e.etag);
+        TEST_ASSERT_EQUAL_STRING(k_assets[i].cache, e.cache_control);
+        TEST_ASSERT_EQUAL_UINT32(strlen(k_assets[i].body), e.len);
+        TEST_ASSERT_EQUAL_MEMORY(k_assets[i].body, e.data, e.len);
+        TEST_ASSERT_EQUAL_UINT32(k_assets[i].flags, e.flags);
+        // Zero-copy: the body points into the mapping.
+        TEST_ASSERT_TRUE(e.data > s_buf && e.data + e.len <= s_buf + size);
+    }
+}
+
+static void test_find_misses_unknown_paths(void)
+{
+    size_t size = build_bundle(k_assets, ASSET_COUNT);
+    asset_bundle_t b;
+    asset_bundle_entry_t e;
+    TEST_ASSERT_TRUE(asset_bundle_open(&b, s_buf, size));
+    TEST_ASSERT_FALSE(asset_bundle_find(&b, "/", &e));
+    TEST_ASSERT_FALSE(asset_bundle_find(&b, "/app", &e));
+    TEST_ASSERT_FALSE(asset_bundle_find(&b, "/generate_204", &e));
+    TEST_ASSERT_FALSE(asset_bundle_find(&b, "/zzz", &e));
+}
+
+static void test_open_rejects_erased_or_corrupt_flash(void)
+{
+    asset_bundle_t b;
+    size_t size = build_bundle(k_assets, ASSET_COUNT);
+
+    uint8_t erased[64];
+    memset(erased, 0xFF, sizeof(erased));
+    TEST_ASSERT_EQUAL_UINT32(0, asset_bundle_size(erased, sizeof(erased)));
+    TEST_ASSERT_FALSE(asset_bundle_open(&b, erased, sizeof(erased)));
+
+    TEST_ASSERT_FALSE(asset_bundle_open(&b, s_buf, size - 1));     // Partition shorter than the bundle
+
+    s_buf[size - 1] ^= 0x01;                                        // One flipped bit in a body
+    TEST_ASSERT_FALSE(asset_bundle_open(&b, s_buf, size));
+
+    build_bundle(k_assets, ASSET_COUNT);
+    s_buf[4] = ASSET_BUNDLE_VERSION + 1;
+    TEST_ASSERT_FALSE(asset_bundle_open(&b, s_buf, size));
+}
+
+static void test_open_rejects_out_of_order_index(void)
+{
+    const fixture_asset_t swapped[] = { k_assets[1], k_assets[0] };
+    asset_bundle_t b;
+    size_t size = build_bundle(swapped, 2);
+    TEST_ASSERT_FALSE(asset_bundle_open(&b, s_buf, size));
+}
+
+static void test_open_rejects_offsets_past_the_end(void)
+{
+    asset_bundle_t b;
+    size_t size = build_bundle(k_assets, 1);
+    // Grow data_len by one and re-seal the checksum so only the bounds check can catch it.
+    put_u32(s_buf + ASSET_BUNDLE_HEADER_BYTES + 20, (uint32_t)strlen(k_assets[0].body) + 1);
+    uint32_t hash = 2166136261U;
+    for (size_t i = ASSET_BUNDLE_HEADER_BYTES; i < size; i++) {
+        hash = (hash ^ s_buf[i]) * 16777619U;
+    }
+    put_u32(s_buf + 12, hash);
+    TEST_ASSERT_FALSE(asset_bundle_open(&b, s_buf, size));
+}
+
+static void test_etag_matching_follows_if_none_match_rules(void)
+{
+    TEST_ASSERT_TRUE(asset_bundle_etag_matches("\"a11\"", "\"a11\""));
+    TEST_ASSERT_TRUE(asset_bundle_etag_matches("W/\"a11\"", "\"a11\""));
+    TEST_ASSERT_TRUE(asset_bundle_etag_matches("\"old\", \"a11\"", "\"a11\""));
+    TEST_ASSERT_TRUE(asset_bundle_etag_matches("*", "\"a11\""));
+    TEST_ASSERT_FALSE(asset_bundle_etag_matches("\"a1\"", "\"a11\""));
+    TEST_ASSERT_FALSE(asset_bundle_etag_matches("\"a111\"", "\"a11\""));
+    TEST_ASSERT_FALSE(asset_bundle_etag_matches("", "\"a11\""));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_open_and_find_every_asset);
+    RUN_TEST(test_find_misses_unknown_paths);
+    RUN_TEST(test_open_rejects_erased_or_corrupt_flash);
+    RUN_TEST(test_open_rejects_out_of_order_index);
+    RUN_TEST(test_open_rejects_offsets_past_the_end);
+    RUN_TEST(test_etag_matching_follows_if_none_match_rules);
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "network/control_bundle.h"
+
+#include "../../../lib/network/src/control_bundle.c"
+
+static uint8_t buf[64];
+static network_ctrl_bundle_t bundle;
+
+void setUp(void)
+{
+    memset(buf, 0xEE, sizeof(buf));
+    network_ctrl_bundle_init(&bundle, buf, sizeof(buf));
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty_bundle_has_header_only(void)
+{
+    TEST_ASSERT_EQUAL_size_t(NET_CTRL_BUNDLE_HEADER_SIZE, bundle.len);
+    TEST_ASSERT_EQUAL_UINT8(NET_CTRL_BUNDLE_TYPE, buf[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, buf[1]);
+}
+
+void test_messages_roundtrip_in_order(void)
+{
+    const uint8_t heartbeat[] = {0x02, 1, 2, 3, 4, 5};
+    const uint8_t control[] = {0x10, 0xAA, 0xBB};
+    const uint8_t announce[] = {0x03, 9, 8, 7, 6, 5, 4, 3, 2};
+
+    TEST_ASSERT_TRUE(network_ctrl_bundle_append(&bundle, heartbeat, sizeof(heartbeat)));
+    TEST_ASSERT_TRUE(network_ctrl_bundle_append(&bundle, control, sizeof(control)));
+    TEST_ASSERT_TRUE(network_ctrl_bundle_append(&bundle, announce, sizeof(announce)));
+    TEST_ASSERT_EQUAL_UINT8(3, buf[1]);
+
+    network_ctrl_bundle_reader_t reader;
+    const uint8_t *msg;
+    size_t msg_len;
+    TEST_ASSERT_TRUE(network_ctrl_bundle_reader_init(&reader, buf, bundle.len));
+
+    TEST_ASSERT_TRUE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+    TEST_ASSERT_EQUAL_size_t(sizeof(heartbeat), msg_len);
+    TEST_ASSERT_EQUAL_MEMORY(heartbeat, msg, msg_len);
+    TEST_ASSERT_TRUE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+    TEST_ASSERT_EQUAL_MEMORY(control, msg, sizeof(control));
+    TEST_ASSERT_TRUE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+    TEST_ASSERT_EQUAL_MEMORY(announce, msg, sizeof(announce));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+}
+
+void test_append_refuses_message_that_does_not_fit(void)
+{
+    uint8_t big[40];
+    memset(big, 0x10, sizeof(big));
+
+    TEST_ASSERT_TRUE(network_ctrl_bundle_append(&bundle, big, sizeof(big)));
+    size_t len_before = bundle.len;
+    TEST_ASSERT_FALSE(network_ctrl_bundle_fits(&bundle, 20));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_append(&bundle, big, 20));
+    TEST_ASSERT_EQUAL_size_t(len_before, bundle.len);
+    TEST_ASSERT_EQUAL_UINT8(1, bundle.count);
+
+    // Exactly filling the buffer is allowed.
+    size_t room = sizeof(buf) - bundle.len - NET_CTRL_BUNDLE_ENTRY_OVERHEAD;
+    TEST_ASSERT_TRUE(network_ctrl_bundle_append(&bundle, big, room));
+    TEST_ASSERT_EQUAL_size_t(sizeof(buf), bundle.len);
+}
+
+void test_append_rejects_empty_message(void)
+{
+    const uint8_t msg[] = {0x02};
+    TEST_ASSERT_FALSE(network_ctrl_bundle_append(&bundle, msg, 0));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_append(&bundle, NULL, 1));
+    TEST_ASSERT_EQUAL_UINT8(0, bundle.count);
+}
+
+void test_single_message_bundle_unwraps_to_raw_message(void)
+{
+    const uint8_t control[] = {0x10, 0x01, 0x02, 0x03};
+    const uint8_t *msg = NULL;
+    size_t msg_len = 0;
+
+    TEST_ASSERT_FALSE(network_ctrl_bundle_single(&bundle, &msg, &msg_len));
+    network_ctrl_bundle_append(&bundle, control, sizeof(control));
+    TEST_ASSERT_TRUE(network_ctrl_bundle_single(&bundle, &msg, &msg_len));
+    TEST_ASSERT_EQUAL_size_t(sizeof(control), msg_len);
+    TEST_ASSERT_EQUAL_MEMORY(control, msg, msg_len);
+
+    network_ctrl_bundle_append(&bundle, control, sizeof(control));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_single(&bundle, &msg, &msg_len));
+}
+
+void test_reset_clears_messages(void)
+{
+    const uint8_t control[] = {0x10, 0x01};
+    network_ctrl_bundle_append(&bundle, control, sizeof(control));
+    network_ctrl_bundle_reset(&bundle);
+
+    TEST_ASSERT_EQUAL_UINT8(0, bundle.count);
+    TEST_ASSERT_EQUAL_size_t(NET_CTRL_BUNDLE_HEADER_SIZE, bundle.len);
+    TEST_ASSERT_EQUAL_UINT8(0, buf[1]);
+}
+
+void test_reader_rejects_wrong_type_and_short_input(void)
+{
+    network_ctrl_bundle_reader_t reader;
+    const uint8_t not_bundle[] = {0x02, 0x01, 0x00, 0x01, 0x02};
+    const uint8_t too_short[] = {NET_CTRL_BUNDLE_TYPE};
+
+    TEST_ASSERT_FALSE(network_ctrl_bundle_reader_init(&reader, not_bundle, sizeof(not_bundle)));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_reader_init(&reader, too_short, sizeof(too_short)));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_reader_init(&reader, NULL, 4));
+}
+
+void test_reader_stops_at_truncated_entry(void)
+{
+    // Count claims 2 messages; the second length runs past the end.
+    const uint8_t wire[] = {NET_CTRL_BUNDLE_TYPE, 2, 0x00, 0x02, 0x10, 0x11, 0x00, 0x09, 0x02};
+    network_ctrl_bundle_reader_t reader;
+    const uint8_t *msg;
+    size_t msg_len;
+
+    TEST_ASSERT_TRUE(network_ctrl_bundle_reader_init(&reader, wire, sizeof(wire)));
+    TEST_ASSERT_TRUE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+    TEST_ASSERT_EQUAL_size_t(2, msg_len);
+    TEST_ASSERT_FALSE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+}
+
+void test_reader_rejects_zero_length_entry_and_missing_length(void)
+{
+    const uint8_t zero_len[] = {NET_CTRL_BUNDLE_TYPE, 1, 0x00, 0x00};
+    const uint8_t no_len[] = {NET_CTRL_BUNDLE_TYPE, 1, 0x00};
+    network_ctrl_bundle_reader_t reader;
+    const uint8_t *msg;
+    size_t msg_len;
+
+    TEST_ASSERT_TRUE(network_ctrl_bundle_reader_init(&reader, zero_len, sizeof(zero_len)));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+    TEST_ASSERT_TRUE(network_ctrl_bundle_reader_init(&reader, no_len, sizeof(no_len)));
+    TEST_ASSERT_FALSE(network_ctrl_bundle_next(&reader, &msg, &msg_len));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_bundle_has_header_only);
+    RUN_TEST(test_messages_roundtrip_in_order);
+    RUN_TEST(test_append_refuses_message_that_does_not_fit);
+    RUN_TEST(test_append_rejects_empty_message);
+    RUN_TEST(test_single_message_bundle_unwraps_to_raw_message);
+    RUN_TEST(test_reset_clears_messages);
+    RUN_TEST(test_reader_rejects_wrong_type_and_short_input);
+    RUN_TEST(test_reader_stops_at_truncated_entry);
+    RUN_TEST(test_reader_rejects_zero_length_entry_and_missing_length);
+    return UNITY_END();
+}
@@ -72,6 +72,7 @@ esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, ssize_t buf_len)
     return ESP_OK;
 }
 
+#include "../../../lib/control/src/json_writer.c"
 #include "../../../lib/control/src/portal_control_plane.c"
 
 void test_metrics_json_baseline_exceeds_legacy_256_buffer(void)
@@ -0,0 +1,256 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "control/cpu_load.h"
+
+#include "../../../lib/control/src/cpu_load.c"
+
+// A fake 160 MHz cycle counter and a scheduler that hands each core's cycles
+// to its tasks in fixed shares; whatever is left goes to that core's idle task.
+#define FAKE_HZ         160000000u
+#define FAKE_PER_MS     (FAKE_HZ / 1000u)
+#define FAKE_MAX_TASKS  40
+
+typedef struct {
+    cpu_load_task_sample_t s;
+    uint8_t share_pct;          // Of its core, per step
+    bool alive;
+} fake_task_t;
+
+static cpu_load_t s_cpu;
+static fake_task_t s_tasks[FAKE_MAX_TASKS];
+static int s_task_count;
+static uint32_t s_now;
+static uint32_t s_next_id;
+static char s_names[FAKE_MAX_TASKS][CPU_LOAD_NAME_LEN];
+
+static int fake_add(const char *name, uint8_t core, uint8_t share_pct, bool idle)
+{
+    int i = s_task_count++;
+    fake_task_t *t = &s_tasks[i];
+    memset(t, 0, sizeof(*t));
+    strncpy(s_names[i], name, CPU_LOAD_NAME_LEN - 1);
+    t->s.id = ++s_next_id;
+    t->s.name = s_names[i];
+    t->s.core = core;
+    t->s.idle = idle;
+    t->share_pct = share_pct;
+    t->alive = true;
+    return i;
+}
+
+static void fake_sample(void)
+{
+    cpu_load_task_sample_t samples[FAKE_MAX_TASKS];
+    size_t n = 0;
+    for (int i = 0; i < s_task_count; i++) {
+        if (s_tasks[i].alive) {
+            samples[n++] = s_tasks[i].s;
+        }
+    }
+    cpu_load_sample(&s_cpu, s_now, samples, n);
+}
+
+// Runs every core for ms and samples at the end, as the telemetry task does.
+static void fake_run(uint32_t ms)
+{
+    uint32_t cycles = ms * FAKE_PER_MS;
+    for (uint8_t core = 0; core < CPU_LOAD_MAX_CORES; core++) {
+        uint32_t busy = 0;
+        fake_task_t *idle = NULL;
+        for (int i = 0; i < s_task_count; i++) {
+            fake_task_t *t = &s_tasks[i];
+            if (!t->alive || t->s.core != core) {
+                continue;
+            }
+            if (t->s.idle) {
+                idle = t;
+                continue;
+            }
+            uint32_t run = (uint32_t)((uint64_t)cycles * t->share_pct / 100);
+            t->s.runtime += run;
+            busy += run;
+        }
+        if (idle) {
+            idle->s.runtime += cycles - busy;
+        }
+    }
+    s_now += cycles;
+    fake_sample();
+}
+
+static void run_seconds(int seconds)
+{
+    for (int i = 0; i < seconds * 4; i++) {
+        fake_run(250);
+    }
+}
+
+void setUp(void)
+{
+    s_task_count = 0;
+    s_now = 0;
+    s_next_id = 0;
+    cpu_load_init(&s_cpu, 2, FAKE_HZ);
+    fake_add("IDLE0", 0, 0, true);
+    fake_add("IDLE1", 1, 0, true);
+}
+
+void tearDown(void) {}
+
+static void test_no_window_until_a_bucket_closes(void)
+{
+    fake_add("wifi", 0, 30, false);
+    fake_sample();
+    fake_run(250);
+    fake_run(250);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT8(2, r.cores);
+    TEST_ASSERT_EQUAL_UINT32(0, r.window[0].window_ms);
+    TEST_ASSERT_EQUAL_UINT8(0, r.window[0].top_count);
+}
+
+static void test_core_load_is_what_idle_did_not_get(void)
+{
+    fake_add("wifi", 0, 20, false);
+    fake_add("httpd", 0, 5, false);
+    fake_add("adf_enc", 1, 60, false);
+    fake_add("adf_cap", 1, 30, false);
+    fake_sample();
+    run_seconds(2);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT32(CPU_LOAD_BUCKET_MS, r.window[0].window_ms);
+    TEST_ASSERT_EQUAL_UINT8(25, r.window[0].core_pct[0]);
+    TEST_ASSERT_EQUAL_UINT8(90, r.window[0].core_pct[1]);
+    TEST_ASSERT_EQUAL_UINT32(2 * CPU_LOAD_BUCKET_MS, r.window[1].window_ms);
+    TEST_ASSERT_EQUAL_UINT8(90, r.window[1].core_pct[1]);
+}
+
+static void test_top_tasks_are_sorted_and_skip_idle(void)
+{
+    fake_add("wifi", 0, 20, false);
+    fake_add("httpd", 0, 5, false);
+    fake_add("adf_enc", 1, 60, false);
+    fake_add("adf_cap", 1, 30, false);
+    fake_add("telemetry", 0, 1, false);
+    fake_add("dns", 0, 0, false);
+    fake_sample();
+    run_seconds(1);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    const cpu_load_window_t *w = &r.window[0];
+    TEST_ASSERT_EQUAL_UINT8(CPU_LOAD_TOP_TASKS, w->top_count);
+    TEST_ASSERT_EQUAL_STRING("adf_enc", w->top[0].name);
+    TEST_ASSERT_EQUAL_UINT8(60, w->top[0].pct);
+    TEST_ASSERT_EQUAL_UINT8(1, w->top[0].core);
+    TEST_ASSERT_EQUAL_STRING("adf_cap", w->top[1].name);
+    TEST_ASSERT_EQUAL_STRING("wifi", w->top[2].name);
+    TEST_ASSERT_EQUAL_STRING("httpd", w->top[3].name);
+    TEST_ASSERT_EQUAL_UINT8(5, w->top[3].pct);
+}
+
+static void test_short_window_follows_a_spike_the_long_window_smooths(void)
+{
+    int wifi = fake_add("wifi", 0, 10, false);
+    fake_sample();
+    run_seconds(CPU_LOAD_HISTORY - 1);
+    s_tasks[wifi].share_pct = 100;
+    run_seconds(1);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT8(100, r.window[0].core_pct[0]);
+    TEST_ASSERT_EQUAL_UINT32(CPU_LOAD_HISTORY * CPU_LOAD_BUCKET_MS, r.window[1].window_ms);
+    TEST_ASSERT_EQUAL_UINT8(19, r.window[1].core_pct[0]);
+
+    // The spike slides out of the long window once HISTORY more buckets close.
+    s_tasks[wifi].share_pct = 10;
+    run_seconds(CPU_LOAD_HISTORY);
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT8(10, r.window[0].core_pct[0]);
+    TEST_ASSERT_EQUAL_UINT8(10, r.window[1].core_pct[0]);
+}
+
+static void test_counters_wrap(void)
+{
+    s_now = UINT32_MAX - 100 * FAKE_PER_MS;
+    s_tasks[0].s.runtime = UINT32_MAX - 50;
+    int enc = fake_add("adf_enc", 1, 40, false);
+    s_tasks[enc].s.runtime = UINT32_MAX - 7;
+    fake_sample();
+    run_seconds(2);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT8(0, r.window[0].core_pct[0]);
+    TEST_ASSERT_EQUAL_UINT8(40, r.window[0].core_pct[1]);
+    TEST_ASSERT_EQUAL_UINT8(40, r.window[1].top[0].pct);
+}
+
+static void test_created_and_deleted_tasks(void)
+{
+    int ota = fake_add("ota", 0, 50, false);
+    fake_sample();
+    run_seconds(1);
+
+    // Deleted: forgotten, and its cycles go back to idle.
+    s_tasks[ota].alive = false;
+    // Created between samples: all of its run time counts.
+    int late = fake_add("late", 1, 0, false);
+    s_tasks[late].s.runtime = 100 * FAKE_PER_MS;
+    s_tasks[1].s.runtime -= 100 * FAKE_PER_MS;
+    run_seconds(1);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT8(0, r.window[0].core_pct[0]);
+    TEST_ASSERT_EQUAL_UINT8(10, r.window[0].core_pct[1]);
+    TEST_ASSERT_EQUAL_UINT8(1, r.window[0].top_count);
+    TEST_ASSERT_EQUAL_STRING("late", r.window[0].top[0].name);
+    TEST_ASSERT_EQUAL_UINT8(10, r.window[0].top[0].pct);
+    for (int i = 0; i < s_cpu.task_count; i++) {
+        TEST_ASSERT_TRUE(s_cpu.tasks[i].id != s_tasks[ota].s.id);
+    }
+}
+
+static void test_untracked_tasks_never_spike_when_they_get_a_slot(void)
+{
+    for (int i = s_task_count; i < CPU_LOAD_MAX_TASKS; i++) {
+        fake_add("filler", 0, 1, false);
+    }
+    int extra = fake_add("extra", 1, 50, false);
+    fake_sample();
+    run_seconds(2);
+    TEST_ASSERT_EQUAL_UINT8(CPU_LOAD_MAX_TASKS, s_cpu.task_count);
+
+    // A slot frees up; the extra task's long history must not land in one bucket.
+    s_tasks[2].alive = false;
+    run_seconds(1);
+    run_seconds(1);
+
+    cpu_load_report_t r;
+    cpu_load_report(&s_cpu, &r);
+    TEST_ASSERT_EQUAL_UINT8(50, r.window[0].core_pct[1]);
+    TEST_ASSERT_EQUAL_STRING(s_names[extra], r.window[0].top[0].name);
+    TEST_ASSERT_EQUAL_UINT8(50, r.window[0].top[0].pct);
+    TEST_ASSERT_TRUE(r.window[1].top[0].pct <= 50);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_window_until_a_bucket_closes);
+    RUN_TEST(test_core_load_is_what_idle_did_not_get);
+    RUN_TEST(test_top_tasks_are_sorted_and_skip_idle);
+    RUN_TEST(test_short_window_follows_a_spike_the_long_window_smooths);
+    RUN_TEST(test_counters_wrap);
+    RUN_TEST(test_created_and_deleted_tasks);
+    RUN_TEST(test_untracked_tasks_never_spike_when_they_get_a_slot);
+    return UNITY_END();
+}
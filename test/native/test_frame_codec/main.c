@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include <unity.h>
 
 #include "network/frame_codec.h"
@@ -260,6 +262,242 @@ void test_unpack_batch_single_frame_empty_payload_still_records_call(void)
     TEST_ASSERT_EQUAL_UINT16(0, capture.lens[0]);
 }
 
+static size_t build_v1_header(uint8_t *packet, uint16_t seq, uint32_t ts, uint16_t payload_len)
+{
+    memset(packet, 0, CURRENT_HEADER_SIZE);
+    packet[0] = NET_FRAME_MAGIC;
+    packet[1] = NET_FRAME_VERSION;
+    packet[2] = 0x11;
+    packet[3] = 6;
+    packet[4] = (uint8_t)(seq >> 8);
+    packet[5] = (uint8_t)seq;
+    packet[6] = (uint8_t)(ts >> 24);
+    packet[7] = (uint8_t)(ts >> 16);
+    packet[8] = (uint8_t)(ts >> 8);
+    packet[9] = (uint8_t)ts;
+    packet[10] = (uint8_t)(payload_len >> 8);
+    packet[11] = (uint8_t)payload_len;
+    packet[12] = 3;
+    packet[13] = 2;
+    return CURRENT_HEADER_SIZE;
+}
+
+void test_extend_seq_handles_forward_backward_and_wrap(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0x1234, network_frame_extend_seq(0x1230, 0x34));
+    TEST_ASSERT_EQUAL_UINT16(0x122E, network_frame_extend_seq(0x1230, 0x2E));
+    TEST_ASSERT_EQUAL_UINT16(0x0001, network_frame_extend_seq(0xFFFE, 0x01));
+    TEST_ASSERT_EQUAL_UINT16(0xFFFE, network_frame_extend_seq(0x0001, 0xFE));
+    TEST_ASSERT_EQUAL_UINT16(0x12AF, network_frame_extend_seq(0x1230, 0xAF));
+}
+
+void test_extend_timestamp_handles_24bit_wrap(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0x01000010u, network_frame_extend_timestamp(0x00FFFFF0u, 0x000010u));
+    TEST_ASSERT_EQUAL_UINT32(0x00FFFFF0u, network_frame_extend_timestamp(0x01000010u, 0xFFFFF0u));
+    TEST_ASSERT_EQUAL_UINT32(0x12345678u + 40, network_frame_extend_timestamp(0x12345678u, 0x345678u + 40));
+}
+
+void test_v2_header_round_trip_with_anchor(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2 + 5] = {0};
+    network_frame_info_t in = {
+        .type = 0x11,
+        .ttl = 6,
+        .stream_id = 1,
+        .frame_count = 2,
+        .seq = 0x0102,
+        .timestamp = 0x01ABCDEFu,
+        .payload_len = 5,
+    };
+    TEST_ASSERT_EQUAL_size_t(NET_FRAME_HEADER_SIZE_V2, network_frame_encode_header_v2(&in, packet, sizeof(packet)));
+
+    network_frame_ref_t ref = {.valid = true, .seq = 0x00F8, .timestamp = 0x01ABCD00u};
+    network_frame_info_t out;
+    TEST_ASSERT_TRUE(network_frame_decode_header(packet, sizeof(packet), &ref, &out));
+    TEST_ASSERT_EQUAL_UINT8(NET_FRAME_VERSION_V2, out.version);
+    TEST_ASSERT_EQUAL_UINT8(0x11, out.type);
+    TEST_ASSERT_EQUAL_UINT8(6, out.ttl);
+    TEST_ASSERT_EQUAL_UINT8(1, out.stream_id);
+    TEST_ASSERT_EQUAL_UINT8(2, out.frame_count);
+    TEST_ASSERT_EQUAL_UINT16(0x0102, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x01ABCDEFu, out.timestamp);
+    TEST_ASSERT_EQUAL_UINT16(5, out.payload_len);
+    TEST_ASSERT_EQUAL_size_t(NET_FRAME_HEADER_SIZE_V2, out.header_size);
+    TEST_ASSERT_EQUAL_UINT16(0x0102, ref.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x01ABCDEFu, ref.timestamp);
+}
+
+void test_v2_decode_without_anchor_leaves_ref_invalid(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2] = {0};
+    network_frame_info_t in = {.type = 0x11, .ttl = 1, .frame_count = 1, .seq = 0x0345, .timestamp = 0x02000010u};
+    network_frame_encode_header_v2(&in, packet, sizeof(packet));
+
+    network_frame_ref_t ref = {0};
+    network_frame_info_t out;
+    TEST_ASSERT_TRUE(network_frame_decode_header(packet, sizeof(packet), &ref, &out));
+    TEST_ASSERT_EQUAL_UINT16(0x0045, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x000010u, out.timestamp);
+    TEST_ASSERT_FALSE(ref.valid);
+}
+
+void test_v1_decode_anchors_ref_for_following_v2_headers(void)
+{
+    uint8_t packet[CURRENT_HEADER_SIZE + 4];
+    build_v1_header(packet, 0x0340, 0x02000000u, 4);
+
+    network_frame_ref_t ref = {0};
+    network_frame_info_t out;
+    TEST_ASSERT_TRUE(network_frame_decode_header(packet, sizeof(packet), &ref, &out));
+    TEST_ASSERT_TRUE(ref.valid);
+    TEST_ASSERT_EQUAL_UINT16(0x0340, ref.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x02000000u, ref.timestamp);
+
+    uint8_t v2[NET_FRAME_HEADER_SIZE_V2] = {0};
+    network_frame_info_t in = {.type = 0x11, .ttl = 1, .frame_count = 1, .seq = 0x0345, .timestamp = 0x02000010u};
+    network_frame_encode_header_v2(&in, v2, sizeof(v2));
+    TEST_ASSERT_TRUE(network_frame_decode_header(v2, sizeof(v2), &ref, &out));
+    TEST_ASSERT_EQUAL_UINT16(0x0345, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x02000010u, out.timestamp);
+}
+
+void test_v2_encode_rejects_nibble_overflow(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2];
+    network_frame_info_t in = {.ttl = NET_FRAME_V2_TTL_MAX + 1, .frame_count = 1};
+    TEST_ASSERT_EQUAL_size_t(0, network_frame_encode_header_v2(&in, packet, sizeof(packet)));
+    in.ttl = 1;
+    in.frame_count = NET_FRAME_V2_FRAMES_MAX + 1;
+    TEST_ASSERT_EQUAL_size_t(0, network_frame_encode_header_v2(&in, packet, sizeof(packet)));
+    in.frame_count = 1;
+    TEST_ASSERT_EQUAL_size_t(0, network_frame_encode_header_v2(&in, packet, NET_FRAME_HEADER_SIZE_V2 - 1));
+}
+
+void test_v2_decode_rejects_payload_length_mismatch(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2 + 4] = {0};
+    network_frame_info_t in = {.type = 0x11, .ttl = 1, .frame_count = 1, .payload_len = 8};
+    network_frame_encode_header_v2(&in, packet, sizeof(packet));
+
+    network_frame_info_t out;
+    TEST_ASSERT_FALSE(network_frame_decode_header(packet, sizeof(packet), NULL, &out));
+}
+
+void test_decode_header_accepts_v1_current_and_legacy(void)
+{
+    uint8_t packet[CURRENT_HEADER_SIZE + 4];
+    build_v1_header(packet, 0xBEEF, 0x11223344u, 4);
+
+    network_frame_info_t out;
+    TEST_ASSERT_TRUE(network_frame_decode_header(packet, sizeof(packet), NULL, &out));
+    TEST_ASSERT_EQUAL_UINT8(NET_FRAME_VERSION, out.version);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x11223344u, out.timestamp);
+    TEST_ASSERT_EQUAL_UINT8(3, out.stream_id);
+    TEST_ASSERT_EQUAL_UINT8(2, out.frame_count);
+    TEST_ASSERT_EQUAL_size_t(CURRENT_HEADER_SIZE, out.header_size);
+
+    TEST_ASSERT_TRUE(network_frame_decode_header(packet, LEGACY_HEADER_SIZE + 4, NULL, &out));
+    TEST_ASSERT_EQUAL_size_t(LEGACY_HEADER_SIZE, out.header_size);
+    TEST_ASSERT_EQUAL_UINT8(2, out.frame_count);
+}
+
+void test_decode_header_rejects_unknown_version_and_magic(void)
+{
+    uint8_t packet[CURRENT_HEADER_SIZE + 4];
+    build_v1_header(packet, 1, 1, 4);
+    network_frame_info_t out;
+
+    packet[1] = 9;
+    TEST_ASSERT_FALSE(network_frame_decode_header(packet, sizeof(packet), NULL, &out));
+    packet[1] = NET_FRAME_VERSION;
+    packet[0] = 0x00;
+    TEST_ASSERT_FALSE(network_frame_decode_header(packet, sizeof(packet), NULL, &out));
+    TEST_ASSERT_FALSE(network_frame_decode_header(NULL, sizeof(packet), NULL, &out));
+}
+
+void test_decrement_ttl_updates_v1_and_v2_in_place(void)
+{
+    uint8_t v2[NET_FRAME_HEADER_SIZE_V2] = {0};
+    network_frame_info_t in = {.type = 0x11, .ttl = 3, .frame_count = 2};
+    network_frame_encode_header_v2(&in, v2, sizeof(v2));
+    network_frame_decrement_ttl(v2, sizeof(v2));
+    TEST_ASSERT_EQUAL_HEX8(0x22, v2[3]);
+
+    uint8_t v1[CURRENT_HEADER_SIZE];
+    build_v1_header(v1, 1, 1, 0);
+    network_frame_decrement_ttl(v1, sizeof(v1));
+    TEST_ASSERT_EQUAL_UINT8(5, v1[3]);
+
+    v2[3] = 0x02;
+    network_frame_decrement_ttl(v2, sizeof(v2));
+    TEST_ASSERT_EQUAL_HEX8(0x02, v2[3]);
+}
+
+void test_builder_writes_frames_in_place_behind_reserved_header(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2 + 16] = {0};
+    network_frame_builder_t builder;
+    TEST_ASSERT_TRUE(network_frame_builder_init(&builder, packet, sizeof(packet), NET_FRAME_HEADER_SIZE_V2));
+
+    size_t cap = 0;
+    uint8_t *slot = network_frame_builder_frame_slot(&builder, 8, &cap);
+    TEST_ASSERT_TRUE(slot == packet + NET_FRAME_HEADER_SIZE_V2 + 2);
+    TEST_ASSERT_EQUAL_size_t(8, cap);
+    slot[0] = 0xAA;
+    slot[1] = 0xBB;
+    slot[2] = 0xCC;
+    TEST_ASSERT_TRUE(network_frame_builder_commit_frame(&builder, 3));
+
+    slot = network_frame_builder_frame_slot(&builder, 64, &cap);
+    TEST_ASSERT_TRUE(slot == packet + NET_FRAME_HEADER_SIZE_V2 + 7);
+    TEST_ASSERT_EQUAL_size_t(9, cap);
+    slot[0] = 0xDD;
+    TEST_ASSERT_TRUE(network_frame_builder_commit_frame(&builder, 1));
+
+    TEST_ASSERT_EQUAL_UINT8(2, builder.frame_count);
+    TEST_ASSERT_EQUAL_size_t(8, network_frame_builder_payload_len(&builder));
+
+    frame_capture_t capture = {0};
+    size_t consumed = network_frame_unpack_batch(packet + NET_FRAME_HEADER_SIZE_V2,
+                                                 network_frame_builder_payload_len(&builder),
+                                                 builder.frame_count, 40, capture_frame, &capture);
+    TEST_ASSERT_EQUAL_size_t(8, consumed);
+    TEST_ASSERT_EQUAL_INT(2, capture.calls);
+    TEST_ASSERT_EQUAL_UINT16(3, capture.lens[0]);
+    TEST_ASSERT_EQUAL_UINT16(1, capture.lens[1]);
+    TEST_ASSERT_EQUAL_UINT16(41, capture.seqs[1]);
+}
+
+void test_builder_rejects_frames_that_overflow_capacity(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2 + 6];
+    network_frame_builder_t builder;
+    TEST_ASSERT_TRUE(network_frame_builder_init(&builder, packet, sizeof(packet), NET_FRAME_HEADER_SIZE_V2));
+
+    TEST_ASSERT_FALSE(network_frame_builder_commit_frame(&builder, 0));
+    TEST_ASSERT_FALSE(network_frame_builder_commit_frame(&builder, 5));
+    TEST_ASSERT_TRUE(network_frame_builder_commit_frame(&builder, 4));
+
+    size_t cap = 99;
+    TEST_ASSERT_NULL(network_frame_builder_frame_slot(&builder, 8, &cap));
+    TEST_ASSERT_EQUAL_size_t(0, cap);
+
+    network_frame_builder_reset(&builder);
+    TEST_ASSERT_EQUAL_UINT8(0, builder.frame_count);
+    TEST_ASSERT_EQUAL_size_t(0, network_frame_builder_payload_len(&builder));
+}
+
+void test_builder_init_rejects_header_without_payload_room(void)
+{
+    uint8_t packet[NET_FRAME_HEADER_SIZE_V2];
+    network_frame_builder_t builder;
+    TEST_ASSERT_FALSE(network_frame_builder_init(&builder, packet, sizeof(packet), NET_FRAME_HEADER_SIZE_V2));
+    TEST_ASSERT_FALSE(network_frame_builder_init(&builder, NULL, 64, NET_FRAME_HEADER_SIZE_V2));
+    TEST_ASSERT_FALSE(network_frame_builder_init(NULL, packet, sizeof(packet), 0));
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -281,5 +519,18 @@ int main(void)
     RUN_TEST(test_unpack_batch_all_truncated_frames_produces_no_callbacks);
     RUN_TEST(test_unpack_batch_single_frame_passthrough);
     RUN_TEST(test_unpack_batch_single_frame_empty_payload_still_records_call);
+    RUN_TEST(test_extend_seq_handles_forward_backward_and_wrap);
+    RUN_TEST(test_extend_timestamp_handles_24bit_wrap);
+    RUN_TEST(test_v2_header_round_trip_with_anchor);
+    RUN_TEST(test_v2_decode_without_anchor_leaves_ref_invalid);
+    RUN_TEST(test_v1_decode_anchors_ref_for_following_v2_headers);
+    RUN_TEST(test_v2_encode_rejects_nibble_overflow);
+    RUN_TEST(test_v2_decode_rejects_payload_length_mismatch);
+    RUN_TEST(test_decode_header_accepts_v1_current_and_legacy);
+    RUN_TEST(test_decode_header_rejects_unknown_version_and_magic);
+    RUN_TEST(test_decrement_ttl_updates_v1_and_v2_in_place);
+    RUN_TEST(test_builder_writes_frames_in_place_behind_reserved_header);
+    RUN_TEST(test_builder_rejects_frames_that_overflow_capacity);
+    RUN_TEST(test_builder_init_rejects_header_without_payload_room);
     return UNITY_END();
 }
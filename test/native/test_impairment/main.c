@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity.h>
+
+#define ADC_CHANNEL_3 3
+
+#include "config/build.h"
+#include "audio/sequence_tracker.h"
+#include "impairment.h"
+
+#include "../../../lib/control/src/json_extract.c"
+#include "../../../lib/audio/src/sequence_tracker.c"
+#include "../shared/impairment.c"
+
+#define PACKET_INTERVAL_US 20000
+
+static network_impair_t imp;
+static network_impair_profile_t profile;
+
+typedef struct {
+    uint16_t seqs[4096];
+    int64_t times[4096];
+    size_t count;
+    int64_t now_us;
+} arrivals_t;
+
+static arrivals_t arrivals;
+
+static void record_arrival(void *ctx, const uint8_t *data, size_t len)
+{
+    arrivals_t *a = (arrivals_t *)ctx;
+    TEST_ASSERT_EQUAL(2, len);
+    if (a->count < 4096) {
+        a->seqs[a->count] = (uint16_t)((data[0] << 8) | data[1]);
+        a->times[a->count] = a->now_us;
+        a->count++;
+    }
+}
+
+// Sends packets 0..n-1 every 20 ms, polling at 1 ms resolution, then drains.
+static void run_stream(uint16_t n)
+{
+    int64_t now_us = 0;
+    for (uint16_t seq = 0; seq < n; seq++) {
+        uint8_t pkt[2] = { (uint8_t)(seq >> 8), (uint8_t)seq };
+        network_impair_submit(&imp, pkt, sizeof(pkt), now_us);
+        for (int step = 0; step < PACKET_INTERVAL_US / 1000; step++) {
+            arrivals.now_us = now_us;
+            network_impair_poll(&imp, now_us, record_arrival, &arrivals);
+            now_us += 1000;
+        }
+    }
+    arrivals.now_us = now_us;
+    network_impair_drain(&imp, record_arrival, &arrivals);
+}
+
+static char *read_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc((size_t)size + 1);
+    TEST_ASSERT_EQUAL((size_t)size, fread(buf, 1, (size_t)size, f));
+    buf[size] = '\0';
+    fclose(f);
+    return buf;
+}
+
+void setUp(void)
+{
+    memset(&arrivals, 0, sizeof(arrivals));
+    network_impair_profile_default(&profile);
+}
+
+void tearDown(void)
+{
+}
+
+void test_default_profile_passes_packets_through_in_order(void)
+{
+    network_impair_init(&imp, &profile);
+    run_stream(100);
+
+    TEST_ASSERT_EQUAL(100, arrivals.count);
+    for (size_t i = 0; i < arrivals.count; i++) {
+        TEST_ASSERT_EQUAL_UINT16(i, arrivals.seqs[i]);
+        TEST_ASSERT_EQUAL_INT64((int64_t)i * PACKET_INTERVAL_US, arrivals.times[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, imp.stats.delivered);
+}
+
+void test_same_seed_replays_same_run(void)
+{
+    profile.seed = 42;
+    profile.loss.model = NETWORK_IMPAIR_LOSS_BERNOULLI;
+    profile.loss.rate = 0.2f;
+    profile.jitter.model = NETWORK_IMPAIR_JITTER_PARETO;
+    profile.jitter.scale_ms = 5.0f;
+
+    network_impair_init(&imp, &profile);
+    run_stream(500);
+    static arrivals_t first;
+    first = arrivals;
+
+    memset(&arrivals, 0, sizeof(arrivals));
+    network_impair_init(&imp, &profile);
+    run_stream(500);
+    TEST_ASSERT_EQUAL(first.count, arrivals.count);
+    TEST_ASSERT_EQUAL_MEMORY(first.seqs, arrivals.seqs, first.count * sizeof(uint16_t));
+    TEST_ASSERT_EQUAL_MEMORY(first.times, arrivals.times, first.count * sizeof(int64_t));
+
+    memset(&arrivals, 0, sizeof(arrivals));
+    profile.seed = 43;
+    network_impair_init(&imp, &profile);
+    run_stream(500);
+    TEST_ASSERT_TRUE(first.count != arrivals.count ||
+                     memcmp(first.seqs, arrivals.seqs, first.count * sizeof(uint16_t)) != 0);
+}
+
+void test_bernoulli_loss_matches_rate(void)
+{
+    profile.loss.model = NETWORK_IMPAIR_LOSS_BERNOULLI;
+    profile.loss.rate = 0.1f;
+    network_impair_init(&imp, &profile);
+
+    uint8_t pkt[2] = { 0, 0 };
+    for (int i = 0; i < 20000; i++) {
+        network_impair_submit(&imp, pkt, sizeof(pkt), 0);
+        network_impair_poll(&imp, 0, NULL, NULL);
+    }
+    TEST_ASSERT_UINT32_WITHIN(300, 2000, imp.stats.lost);
+}
+
+void test_gilbert_loss_arrives_in_bursts(void)
+{
+    profile.loss.model = NETWORK_IMPAIR_LOSS_GILBERT;
+    profile.loss.p_enter_bad = 0.01f;
+    profile.loss.p_exit_bad = 0.25f;
+    profile.loss.loss_good = 0.0f;
+    profile.loss.loss_bad = 1.0f;
+    network_impair_init(&imp, &profile);
+
+    uint8_t pkt[2] = { 0, 0 };
+    uint32_t bursts = 0;
+    bool prev_lost = false;
+    for (int i = 0; i < 40000; i++) {
+        bool lost = !network_impair_submit(&imp, pkt, sizeof(pkt), 0);
+        if (lost && !prev_lost) {
+            bursts++;
+        }
+        prev_lost = lost;
+        network_impair_poll(&imp, 0, NULL, NULL);
+    }
+    // Mean bad-state sojourn is 1 / p_exit_bad = 4 packets.
+    TEST_ASSERT_TRUE(bursts > 0);
+    float mean_burst = (float)imp.stats.lost / (float)bursts;
+    TEST_ASSERT_FLOAT_WITHIN(0.6f, 4.0f, mean_burst);
+}
+
+void test_pareto_jitter_keeps_fifo_and_cap(void)
+{
+    profile.jitter.model = NETWORK_IMPAIR_JITTER_PARETO;
+    profile.jitter.base_ms = 5;
+    profile.jitter.scale_ms = 10.0f;
+    profile.jitter.shape = 1.5f;
+    profile.jitter.max_ms = 60;
+    network_impair_init(&imp, &profile);
+    run_stream(1000);
+
+    TEST_ASSERT_EQUAL(1000, arrivals.count);
+    int64_t max_delay = 0;
+    for (size_t i = 0; i < arrivals.count; i++) {
+        TEST_ASSERT_EQUAL_UINT16(i, arrivals.seqs[i]);
+        int64_t delay = arrivals.times[i] - (int64_t)i * PACKET_INTERVAL_US;
+        TEST_ASSERT_TRUE(delay >= 5000);
+        if (delay > max_delay) {
+            max_delay = delay;
+        }
+    }
+    // Head-of-line blocking can add at most one more cap behind a late packet.
+    TEST_ASSERT_TRUE(max_delay <= 5000 + 60000 + 1000);
+    TEST_ASSERT_TRUE(max_delay > 20000);
+}
+
+void test_reorder_is_bounded_by_depth(void)
+{
+    profile.reorder.rate = 0.1f;
+    profile.reorder.max_depth = 3;
+    network_impair_init(&imp, &profile);
+    run_stream(2000);
+
+    TEST_ASSERT_EQUAL(2000, arrivals.count);
+    TEST_ASSERT_TRUE(imp.stats.reordered > 100);
+    uint32_t out_of_order = 0;
+    for (size_t i = 0; i < arrivals.count; i++) {
+        int displacement = (int)i - (int)arrivals.seqs[i];
+        TEST_ASSERT_TRUE(displacement >= -3 && displacement <= 3);
+        if (i > 0 && arrivals.seqs[i] < arrivals.seqs[i - 1]) {
+            out_of_order++;
+        }
+    }
+    TEST_ASSERT_TRUE(out_of_order > 0);
+}
+
+void test_duplicates_and_spikes_are_counted(void)
+{
+    profile.duplicate.rate = 0.05f;
+    profile.spike.rate = 0.01f;
+    profile.spike.extra_ms = 100;
+    profile.spike.packets = 4;
+    network_impair_init(&imp, &profile);
+    run_stream(2000);
+
+    TEST_ASSERT_EQUAL(2000 + imp.stats.duplicated, arrivals.count);
+    TEST_ASSERT_TRUE(imp.stats.duplicated > 50);
+    TEST_ASSERT_TRUE(imp.stats.spiked >= 4);
+
+    bool saw_spike = false;
+    for (size_t i = 0; i < arrivals.count; i++) {
+        if (arrivals.times[i] - (int64_t)arrivals.seqs[i] * PACKET_INTERVAL_US >= 100000) {
+            saw_spike = true;
+        }
+    }
+    TEST_ASSERT_TRUE(saw_spike);
+}
+
+void test_sequence_tracker_counts_emulated_loss(void)
+{
+    profile.loss.model = NETWORK_IMPAIR_LOSS_GILBERT;
+    profile.loss.p_enter_bad = 0.02f;
+    profile.loss.p_exit_bad = 0.3f;
+    profile.loss.loss_good = 0.002f;
+    profile.loss.loss_bad = 0.5f;
+    profile.jitter.model = NETWORK_IMPAIR_JITTER_EMPIRICAL;
+    profile.jitter.samples_ms[0] = 1;
+    profile.jitter.samples_ms[1] = 4;
+    profile.jitter.samples_ms[2] = 30;
+    profile.jitter.sample_count = 3;
+    network_impair_init(&imp, &profile);
+    run_stream(3000);
+
+    uint32_t dropped = 0;
+    bool first = true;
+    uint16_t last_seq = 0;
+    for (size_t i = 0; i < arrivals.count; i++) {
+        sequence_tracker_result_t r = sequence_tracker_update(first, last_seq, arrivals.seqs[i],
+                                                              RX_PLC_MAX_FRAMES_PER_GAP, 24);
+        first = r.first_packet;
+        last_seq = r.last_seq;
+        dropped += r.dropped_frames;
+    }
+    // Packet 0 anchors the tracker; a loss there is invisible to it.
+    uint32_t expected = imp.stats.lost - (arrivals.seqs[0] != 0 ? arrivals.seqs[0] : 0);
+    TEST_ASSERT_TRUE(imp.stats.lost > 0);
+    TEST_ASSERT_EQUAL_UINT32(expected, dropped);
+}
+
+void test_schedule_loads_impair_steps_for_target(void)
+{
+    char *json = read_file("tools/fault_schedules/nightly-6h.json");
+    static network_impair_schedule_t schedule;
+
+    TEST_ASSERT_TRUE(network_impair_schedule_parse(json, "OUT", &schedule));
+    TEST_ASSERT_EQUAL(4, schedule.count);
+    TEST_ASSERT_EQUAL_STRING("30m-burst-loss", schedule.steps[0].label);
+
+    const network_impair_profile_t *p = &schedule.steps[0].profile;
+    TEST_ASSERT_EQUAL(NETWORK_IMPAIR_LOSS_GILBERT, p->loss.model);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.3f, p->loss.p_exit_bad);
+    TEST_ASSERT_EQUAL(NETWORK_IMPAIR_JITTER_PARETO, p->jitter.model);
+    TEST_ASSERT_EQUAL_UINT32(120, p->jitter.max_ms);
+
+    p = &schedule.steps[2].profile;
+    TEST_ASSERT_EQUAL(NETWORK_IMPAIR_JITTER_EMPIRICAL, p->jitter.model);
+    TEST_ASSERT_EQUAL_UINT8(12, p->jitter.sample_count);
+    TEST_ASSERT_EQUAL_UINT16(40, p->jitter.samples_ms[11]);
+    TEST_ASSERT_EQUAL_UINT8(3, p->reorder.max_depth);
+    TEST_ASSERT_EQUAL_UINT16(8, p->spike.packets);
+
+    TEST_ASSERT_NULL(network_impair_schedule_at(&schedule, 100.0f));
+    TEST_ASSERT_TRUE(network_impair_schedule_at(&schedule, 2000.0f) == &schedule.steps[0].profile);
+    const network_impair_profile_t *cleared = network_impair_schedule_at(&schedule, 3000.0f);
+    TEST_ASSERT_EQUAL(NETWORK_IMPAIR_LOSS_NONE, cleared->loss.model);
+    TEST_ASSERT_EQUAL(NETWORK_IMPAIR_JITTER_NONE, cleared->jitter.model);
+
+    TEST_ASSERT_TRUE(network_impair_schedule_parse(json, "SRC", &schedule));
+    TEST_ASSERT_EQUAL(0, schedule.count);
+    free(json);
+
+    json = read_file("tools/fault_schedules/prerelease-24h.json");
+    TEST_ASSERT_TRUE(network_impair_schedule_parse(json, NULL, &schedule));
+    TEST_ASSERT_EQUAL(4, schedule.count);
+    free(json);
+}
+
+void test_schedule_rejects_bad_profiles(void)
+{
+    static network_impair_schedule_t schedule;
+
+    TEST_ASSERT_FALSE(network_impair_schedule_parse(
+        "[{\"at_seconds\": 1, \"action\": \"impair\", \"target\": \"OUT\", "
+        "\"profile\": {\"loss\": {\"model\": \"bernoulli\", \"rate\": 1.5}}}]", NULL, &schedule));
+    TEST_ASSERT_FALSE(network_impair_schedule_parse(
+        "[{\"at_seconds\": 1, \"action\": \"impair\", \"target\": \"OUT\", "
+        "\"profile\": {\"jitter\": {\"model\": \"gaussian\"}}}]", NULL, &schedule));
+    TEST_ASSERT_FALSE(network_impair_schedule_parse(
+        "[{\"at_seconds\": 1, \"action\": \"impair\", \"target\": \"OUT\"}]", NULL, &schedule));
+    TEST_ASSERT_FALSE(network_impair_schedule_parse("{}", NULL, &schedule));
+
+    TEST_ASSERT_TRUE(network_impair_schedule_parse(
+        "[{\"at_seconds\": 5, \"action\": \"log_marker\", \"target\": \"BOTH\"}]", NULL, &schedule));
+    TEST_ASSERT_EQUAL(0, schedule.count);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_default_profile_passes_packets_through_in_order);
+    RUN_TEST(test_same_seed_replays_same_run);
+    RUN_TEST(test_bernoulli_loss_matches_rate);
+    RUN_TEST(test_gilbert_loss_arrives_in_bursts);
+    RUN_TEST(test_pareto_jitter_keeps_fifo_and_cap);
+    RUN_TEST(test_reorder_is_bounded_by_depth);
+    RUN_TEST(test_duplicates_and_spikes_are_counted);
+    RUN_TEST(test_sequence_tracker_counts_emulated_loss);
+    RUN_TEST(test_schedule_loads_impair_steps_for_target);
+    RUN_TEST(test_schedule_rejects_bad_profiles);
+    return UNITY_END();
+}
@@ -0,0 +1,303 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "control/json_extract.h"
+#include "control/portal_json_decode.h"
+#include "../../../lib/control/src/json_extract.c"
+#include "../../../lib/control/src/portal_json_decode.c"
+
+// A mixer POST as the portal UI sends it: every stream, pretty-printed.
+static const char *k_mixer_body =
+    "{\n"
+    "  \"schemaVersion\": 2,\n"
+    "  \"outGainPct\": 180,\n"
+    "  \"streams\": [\n"
+    "    {\"id\": 1, \"gainPct\": 100, \"enabled\": true, \"muted\": false, \"solo\": false, \"active\": true},\n"
+    "    {\"id\": 2, \"gainPct\": 250, \"enabled\": true, \"muted\": true, \"solo\": false},\n"
+    "    {\"id\": 3, \"gain\": 0, \"enable\": false, \"mute\": false, \"solo\": false},\n"
+    "    {\"id\": 4, \"gainPct\": 400, \"enabled\": true, \"muted\": false, \"solo\": true, \"active\": false}\n"
+    "  ]\n"
+    "}";
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_tokens_index_nested_document_in_order(void)
+{
+    const char *js = "{\"a\":[1,{\"b\":null},\"x\"],\"c\":true}";
+    json_doc_t doc;
+    json_tok_t toks[16];
+    TEST_ASSERT_EQUAL_INT(10, json_parse(&doc, js, strlen(js), toks, 16));
+
+    TEST_ASSERT_EQUAL_UINT8(JSON_TOK_OBJECT, toks[0].type);
+    TEST_ASSERT_EQUAL_UINT16(2, toks[0].size);
+    TEST_ASSERT_EQUAL_UINT16(10, toks[0].next);
+    TEST_ASSERT_EQUAL_UINT16(strlen(js), toks[0].end);
+
+    int arr = json_object_get(&doc, 0, "a");
+    TEST_ASSERT_EQUAL_INT(2, arr);
+    TEST_ASSERT_EQUAL_UINT8(JSON_TOK_ARRAY, toks[arr].type);
+    TEST_ASSERT_EQUAL_UINT16(3, toks[arr].size);
+
+    int el = json_first_child(&doc, arr);
+    int uv = 0;
+    TEST_ASSERT_TRUE(json_tok_int(&doc, el, &uv));
+    TEST_ASSERT_EQUAL_INT(1, uv);
+    el = json_next_sibling(&doc, arr, el);
+    TEST_ASSERT_EQUAL_UINT8(JSON_TOK_OBJECT, toks[el].type);
+    el = json_next_sibling(&doc, arr, el);
+    TEST_ASSERT_TRUE(json_tok_equals(&doc, el, "x"));
+    TEST_ASSERT_EQUAL_INT(-1, json_next_sibling(&doc, arr, el));
+
+    bool c = false;
+    TEST_ASSERT_TRUE(json_get_bool(&doc, 0, "c", &c));
+    TEST_ASSERT_TRUE(c);
+    TEST_ASSERT_EQUAL_INT(-1, json_object_get(&doc, 0, "b"));
+}
+
+void test_parse_errors_are_distinguished(void)
+{
+    json_doc_t doc;
+    json_tok_t toks[4];
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_PART, json_parse(&doc, "{\"a\":\"x", 7, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_PART, json_parse(&doc, "{\"a\":1", 6, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_INVAL, json_parse(&doc, "{\"a\" 1}", 7, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_INVAL, json_parse(&doc, "{\"a\":tru}", 9, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_INVAL, json_parse(&doc, "[1,]", 4, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_INVAL, json_parse(&doc, "{} {}", 5, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_INVAL, json_parse(&doc, "  ", 2, toks, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_NOMEM, json_parse(&doc, "[1,2,3,4]", 9, toks, 4));
+
+    char deep[2 * JSON_MAX_DEPTH + 3];
+    memset(deep, '[', JSON_MAX_DEPTH + 1);
+    memset(deep + JSON_MAX_DEPTH + 1, ']', JSON_MAX_DEPTH + 1);
+    json_tok_t many[64];
+    TEST_ASSERT_EQUAL_INT(JSON_ERR_NOMEM, json_parse(&doc, deep, 2 * JSON_MAX_DEPTH + 2, many, 64));
+}
+
+void test_parse_stops_at_nul_terminator(void)
+{
+    const char body[] = "{\"a\":1}\0garbage";
+    json_doc_t doc;
+    json_tok_t toks[4];
+    TEST_ASSERT_EQUAL_INT(3, json_parse(&doc, body, sizeof(body), toks, 4));
+}
+
+void test_escaped_quotes_do_not_end_strings(void)
+{
+    const char *js = "{\"note\":\"say \\\"enabled\\\":false\",\"enabled\":true,\"ssid\":\"Mesh \\\"Net\\\"\"}";
+    bool enabled = false;
+    TEST_ASSERT_TRUE(json_extract_bool_field(js, "enabled", &enabled));
+    TEST_ASSERT_TRUE(enabled);
+
+    char ssid[16];
+    TEST_ASSERT_TRUE(json_extract_string_field(js, "ssid", ssid, sizeof(ssid)));
+    TEST_ASSERT_EQUAL_STRING("Mesh \"Net\"", ssid);
+}
+
+void test_string_escapes_decode_to_utf8(void)
+{
+    const char *js = "[\"a\\\\b\\/c\\n\\u00e9\\u20ac\\ud83d\\ude00\"]";
+    json_doc_t doc;
+    json_tok_t toks[4];
+    TEST_ASSERT_EQUAL_INT(2, json_parse(&doc, js, strlen(js), toks, 4));
+    char out[32];
+    TEST_ASSERT_TRUE(json_tok_string(&doc, 1, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("a\\b/c\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", out);
+    TEST_ASSERT_FALSE(json_tok_string(&doc, 1, out, 8));
+}
+
+void test_numeric_readers_check_type_and_range(void)
+{
+    const char *js = "{\"u\":65535,\"big\":65536,\"neg\":-12,\"f\":-1.5e2,\"s\":\"7\",\"frac\":1.5}";
+    json_doc_t doc;
+    json_tok_t toks[16];
+    TEST_ASSERT_TRUE(json_parse(&doc, js, strlen(js), toks, 16) > 0);
+
+    uint16_t u = 0;
+    int i = 0;
+    float f = 0.0f;
+    TEST_ASSERT_TRUE(json_get_uint16(&doc, 0, "u", &u));
+    TEST_ASSERT_EQUAL_UINT16(65535, u);
+    TEST_ASSERT_FALSE(json_get_uint16(&doc, 0, "big", &u));
+    TEST_ASSERT_FALSE(json_get_uint16(&doc, 0, "neg", &u));
+    TEST_ASSERT_FALSE(json_get_uint16(&doc, 0, "s", &u));
+    TEST_ASSERT_TRUE(json_get_int(&doc, 0, "neg", &i));
+    TEST_ASSERT_EQUAL_INT(-12, i);
+    TEST_ASSERT_FALSE(json_get_int(&doc, 0, "frac", &i));
+    TEST_ASSERT_TRUE(json_get_float(&doc, 0, "f", &f));
+    TEST_ASSERT_EQUAL_FLOAT(-150.0f, f);
+    TEST_ASSERT_FALSE(json_get_float(&doc, 0, "s", &f));
+    TEST_ASSERT_EQUAL_INT(-1, json_object_get_type(&doc, 0, "s", JSON_TOK_PRIMITIVE));
+}
+
+void test_mixer_decode_reads_all_streams_from_one_index(void)
+{
+    mixer_ctrl_message_t msg = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, mixer_ctrl_decode_json(k_mixer_body, &msg));
+    TEST_ASSERT_EQUAL_INT(MIXER_CTRL_SET, msg.subtype);
+    TEST_ASSERT_EQUAL_UINT16(180, msg.out_gain_pct);
+    TEST_ASSERT_EQUAL_UINT8(4, msg.stream_count);
+
+    TEST_ASSERT_EQUAL_UINT8(2, msg.streams[1].stream_id);
+    TEST_ASSERT_EQUAL_UINT16(250, msg.streams[1].gain_pct);
+    TEST_ASSERT_TRUE(msg.streams[1].muted);
+    TEST_ASSERT_FALSE(msg.streams[1].active);
+    TEST_ASSERT_FALSE(msg.streams[2].enabled);
+    TEST_ASSERT_EQUAL_UINT16(0, msg.streams[2].gain_pct);
+    TEST_ASSERT_TRUE(msg.streams[3].solo);
+    TEST_ASSERT_FALSE(msg.streams[3].active);
+}
+
+void test_mixer_decode_keeps_out_gain_when_absent(void)
+{
+    mixer_ctrl_message_t msg = {.out_gain_pct = 90};
+    const char *body = "{\"streams\":[{\"id\":2,\"gainPct\":50,\"enabled\":true,\"muted\":false,\"solo\":false}]}";
+    TEST_ASSERT_EQUAL_INT(ESP_OK, mixer_ctrl_decode_json(body, &msg));
+    TEST_ASSERT_EQUAL_UINT16(90, msg.out_gain_pct);
+    TEST_ASSERT_EQUAL_UINT8(1, msg.stream_count);
+    TEST_ASSERT_TRUE(msg.streams[0].active);
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, mixer_ctrl_decode_json("{\"outGainPct\":0}", &msg));
+    TEST_ASSERT_EQUAL_UINT16(0, msg.out_gain_pct);
+    TEST_ASSERT_EQUAL_UINT8(0, msg.stream_count);
+}
+
+void test_mixer_decode_rejects_invalid_bodies(void)
+{
+    static const char *bad[] = {
+        "{}",
+        "{\"outGainPct\":401}",
+        "{\"outGainPct\":\"100\"}",
+        "{\"outGainPct\":100,\"schemaVersion\":1}",
+        "{\"streams\":[]}",
+        "{\"streams\":[{\"id\":1,\"gainPct\":100,\"enabled\":true,\"muted\":false}]}",
+        "{\"streams\":[{\"id\":5,\"gainPct\":100,\"enabled\":true,\"muted\":false,\"solo\":false}]}",
+        "{\"streams\":[{\"id\":1,\"gainPct\":100,\"enabled\":true,\"muted\":false,\"solo\":false},"
+        "{\"id\":1,\"gainPct\":100,\"enabled\":true,\"muted\":false,\"solo\":false}]}",
+        "{\"streams\":[{\"id\":1,\"gainPct\":100,\"enabled\":true,\"muted\":false,\"solo\":false,\"active\":1}]}",
+        "{\"streams\":[1]}",
+        "{\"outGainPct\":100",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        mixer_ctrl_message_t msg = {.out_gain_pct = 77};
+        TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, mixer_ctrl_decode_json(bad[i], &msg));
+        TEST_ASSERT_EQUAL_UINT16(77, msg.out_gain_pct);
+    }
+}
+
+void test_uplink_decode(void)
+{
+    uplink_ctrl_message_t msg;
+    TEST_ASSERT_EQUAL_INT(ESP_OK,
+                          uplink_ctrl_decode_json("{\"enabled\": true, \"ssid\": \"Mesh\", \"password\": \"p\\\"w\"}", &msg));
+    TEST_ASSERT_EQUAL_INT(UPLINK_CTRL_SET, msg.subtype);
+    TEST_ASSERT_EQUAL_STRING("Mesh", msg.ssid);
+    TEST_ASSERT_EQUAL_STRING("p\"w", msg.password);
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, uplink_ctrl_decode_json("{\"enabled\":false}", &msg));
+    TEST_ASSERT_EQUAL_INT(UPLINK_CTRL_CLEAR, msg.subtype);
+
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, uplink_ctrl_decode_json("{\"enabled\":true,\"ssid\":\"\"}", &msg));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, uplink_ctrl_decode_json("{\"enabled\":1}", &msg));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG,
+                          uplink_ctrl_decode_json("{\"enabled\":true,\"ssid\":\"012345678901234567890123456789012\"}", &msg));
+}
+
+// The per-field path the portal used: span the streams array, copy each stream
+// out, then look every field up with a one-shot json_extract_* call.
+static bool decode_mixer_per_field(const char *body, mixer_ctrl_message_t *msg)
+{
+    const char *array_start, *array_end, *cursor = NULL;
+    if (!json_extract_uint16_field(body, "outGainPct", &msg->out_gain_pct) ||
+        !json_extract_array_field_span(body, "streams", &array_start, &array_end)) {
+        return false;
+    }
+    msg->stream_count = 0;
+    while (1) {
+        const char *obj_start, *obj_end;
+        if (!json_extract_next_array_object_span(array_start, array_end, &cursor, &obj_start, &obj_end)) {
+            return false;
+        }
+        if (!obj_start) {
+            break;
+        }
+        char stream_json[192];
+        size_t len = (size_t)(obj_end - obj_start + 1);
+        memcpy(stream_json, obj_start, len);
+        stream_json[len] = '\0';
+
+        mixer_ctrl_stream_t *s = &msg->streams[msg->stream_count++];
+        uint16_t id = 0;
+        json_extract_uint16_field(stream_json, "id", &id);
+        s->stream_id = (uint8_t)id;
+        if (!json_extract_uint16_field(stream_json, "gainPct", &s->gain_pct)) {
+            json_extract_uint16_field(stream_json, "gain", &s->gain_pct);
+        }
+        if (!json_extract_bool_field(stream_json, "enabled", &s->enabled)) {
+            json_extract_bool_field(stream_json, "enable", &s->enabled);
+        }
+        if (!json_extract_bool_field(stream_json, "muted", &s->muted)) {
+            json_extract_bool_field(stream_json, "mute", &s->muted);
+        }
+        json_extract_bool_field(stream_json, "solo", &s->solo);
+        s->active = s->enabled && !s->muted;
+        json_extract_bool_field(stream_json, "active", &s->active);
+    }
+    return true;
+}
+
+static double bench_ns_per_op(bool indexed, int iterations)
+{
+    struct timespec t0, t1;
+    volatile uint32_t sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < iterations; i++) {
+        mixer_ctrl_message_t msg = {0};
+        bool ok = indexed ? mixer_ctrl_decode_json(k_mixer_body, &msg) == ESP_OK
+                          : decode_mixer_per_field(k_mixer_body, &msg);
+        sink += ok ? msg.streams[3].gain_pct : 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    (void)sink;
+    double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+    return ns / iterations;
+}
+
+void test_benchmark_mixer_payload_index_vs_per_field(void)
+{
+    mixer_ctrl_message_t indexed = {0}, per_field = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, mixer_ctrl_decode_json(k_mixer_body, &indexed));
+    TEST_ASSERT_TRUE(decode_mixer_per_field(k_mixer_body, &per_field));
+    TEST_ASSERT_EQUAL_UINT8(indexed.stream_count, per_field.stream_count);
+    for (uint8_t i = 0; i < indexed.stream_count; i++) {
+        TEST_ASSERT_EQUAL_UINT16(indexed.streams[i].gain_pct, per_field.streams[i].gain_pct);
+        TEST_ASSERT_EQUAL(indexed.streams[i].active, per_field.streams[i].active);
+    }
+
+    const int iterations = 20000;
+    double per_field_ns = bench_ns_per_op(false, iterations);
+    double indexed_ns = bench_ns_per_op(true, iterations);
+    printf("mixer POST (%u bytes, 4 streams): per-field %.0f ns, one index %.0f ns (%.1fx)\n",
+           (unsigned)strlen(k_mixer_body), per_field_ns, indexed_ns, per_field_ns / indexed_ns);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tokens_index_nested_document_in_order);
+    RUN_TEST(test_parse_errors_are_distinguished);
+    RUN_TEST(test_parse_stops_at_nul_terminator);
+    RUN_TEST(test_escaped_quotes_do_not_end_strings);
+    RUN_TEST(test_string_escapes_decode_to_utf8);
+    RUN_TEST(test_numeric_readers_check_type_and_range);
+    RUN_TEST(test_mixer_decode_reads_all_streams_from_one_index);
+    RUN_TEST(test_mixer_decode_keeps_out_gain_when_absent);
+    RUN_TEST(test_mixer_decode_rejects_invalid_bodies);
+    RUN_TEST(test_uplink_decode);
+    RUN_TEST(test_benchmark_mixer_payload_index_vs_per_field);
+    return UNITY_END();
+}
@@ -0,0 +1,287 @@
+#include <unity.h>
+
+#include <math.h>
+#include <string.h>
+
+#include "network/mesh_net.h"
+#include "control/json_writer.h"
+#include "control/json_extract.h"
+#include "control/portal_json_decode.h"
+#include "control/portal_json_encode.h"
+
+#include "../../../lib/control/src/json_writer.c"
+#include "../../../lib/control/src/json_extract.c"
+#include "../../../lib/control/src/portal_json_decode.c"
+#include "../../../lib/control/src/portal_json_encode.c"
+
+static network_mixer_status_t s_mixer;
+static network_uplink_status_t s_uplink;
+
+esp_err_t network_get_mixer_state(network_mixer_status_t *out)
+{
+    *out = s_mixer;
+    return ESP_OK;
+}
+
+esp_err_t network_get_uplink_status(network_uplink_status_t *out)
+{
+    *out = s_uplink;
+    return ESP_OK;
+}
+
+typedef struct {
+    char out[2048];
+    size_t len;
+    int calls;
+    int finals;
+    size_t max_chunk;
+    int fail_after;     // Fail on this call (1-based); 0 never fails
+} sink_capture_t;
+
+static bool capture_sink(void *ctx, const char *data, size_t len, bool final)
+{
+    sink_capture_t *cap = (sink_capture_t *)ctx;
+    cap->calls++;
+    if (cap->fail_after && cap->calls >= cap->fail_after) {
+        return false;
+    }
+    memcpy(cap->out + cap->len, data, len);
+    cap->len += len;
+    cap->out[cap->len] = '\0';
+    cap->finals += final ? 1 : 0;
+    if (len > cap->max_chunk) {
+        cap->max_chunk = len;
+    }
+    return true;
+}
+
+static void write_sample(json_writer_t *w)
+{
+    json_writer_begin_object(w);
+    json_writer_field_uint(w, "a", 1);
+    json_writer_key(w, "list");
+    json_writer_begin_array(w);
+    json_writer_int(w, -2);
+    json_writer_bool(w, true);
+    json_writer_null(w);
+    json_writer_begin_object(w);
+    json_writer_end_object(w);
+    json_writer_begin_array(w);
+    json_writer_end_array(w);
+    json_writer_end_array(w);
+    json_writer_field_string(w, "s", "x");
+    json_writer_end_object(w);
+}
+
+static const char *k_sample = "{\"a\":1,\"list\":[-2,true,null,{},[]],\"s\":\"x\"}";
+
+void setUp(void)
+{
+    memset(&s_mixer, 0, sizeof(s_mixer));
+    memset(&s_uplink, 0, sizeof(s_uplink));
+}
+
+void tearDown(void) {}
+
+void test_buffer_mode_places_commas_and_nesting(void)
+{
+    char buf[128];
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    write_sample(&w);
+    TEST_ASSERT_EQUAL_INT((int)strlen(k_sample), json_writer_finish(&w));
+    TEST_ASSERT_EQUAL_STRING(k_sample, buf);
+}
+
+void test_strings_are_escaped_and_round_trip(void)
+{
+    const char *raw = "q\"b\\s/n\nt\tc\x01\x1f" "\xc3\xa9";
+    char buf[128];
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_array(&w);
+    json_writer_string(&w, raw);
+    json_writer_end_array(&w);
+    TEST_ASSERT_TRUE(json_writer_finish(&w) > 0);
+    TEST_ASSERT_EQUAL_STRING("[\"q\\\"b\\\\s/n\\nt\\tc\\u0001\\u001F\xc3\xa9\"]", buf);
+
+    json_doc_t doc;
+    json_tok_t toks[4];
+    TEST_ASSERT_EQUAL_INT(2, json_parse(&doc, buf, strlen(buf), toks, 4));
+    char back[32];
+    TEST_ASSERT_TRUE(json_tok_string(&doc, 1, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_STRING(raw, back);
+}
+
+void test_numbers_format_without_printf(void)
+{
+    char buf[256];
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_array(&w);
+    json_writer_uint(&w, 0);
+    json_writer_uint(&w, UINT64_MAX);
+    json_writer_int(&w, INT64_MIN);
+    json_writer_float(&w, 1.5f, 2);
+    json_writer_float(&w, -1.25f, 2);
+    json_writer_float(&w, -0.004f, 2);
+    json_writer_float(&w, 0.05f, 1);
+    json_writer_float(&w, 2.999f, 0);
+    json_writer_float(&w, NAN, 2);
+    json_writer_float(&w, INFINITY, 2);
+    json_writer_end_array(&w);
+    TEST_ASSERT_TRUE(json_writer_finish(&w) > 0);
+    TEST_ASSERT_EQUAL_STRING("[0,18446744073709551615,-9223372036854775808,1.50,-1.25,0.00,0.1,3,null,null]", buf);
+}
+
+void test_mac_is_colon_separated_hex(void)
+{
+    const uint8_t mac[6] = {0xA3, 0xF2, 0x01, 0x02, 0x0b, 0xff};
+    char buf[64];
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w);
+    json_writer_field_mac(&w, "mac", mac);
+    json_writer_end_object(&w);
+    TEST_ASSERT_TRUE(json_writer_finish(&w) > 0);
+    TEST_ASSERT_EQUAL_STRING("{\"mac\":\"A3:F2:01:02:0B:FF\"}", buf);
+}
+
+void test_truncation_reports_full_length_like_snprintf(void)
+{
+    char buf[10];
+    json_writer_t w;
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    write_sample(&w);
+    TEST_ASSERT_EQUAL_INT((int)strlen(k_sample), json_writer_finish(&w));
+    TEST_ASSERT_TRUE(w.truncated);
+    TEST_ASSERT_EQUAL_UINT(9, strlen(buf));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(buf, k_sample, 9));
+}
+
+void test_stream_mode_flushes_small_chunks_into_same_document(void)
+{
+    sink_capture_t cap = {0};
+    char chunk[8];
+    json_writer_t w;
+    json_writer_init_stream(&w, chunk, sizeof(chunk), capture_sink, &cap);
+    write_sample(&w);
+    TEST_ASSERT_EQUAL_INT((int)strlen(k_sample), json_writer_finish(&w));
+    TEST_ASSERT_EQUAL_STRING(k_sample, cap.out);
+    TEST_ASSERT_EQUAL_INT(1, cap.finals);
+    TEST_ASSERT_TRUE(cap.calls >= (int)(strlen(k_sample) / sizeof(chunk)));
+    TEST_ASSERT_TRUE(cap.max_chunk <= sizeof(chunk));
+}
+
+void test_stream_mode_stops_after_sink_error(void)
+{
+    sink_capture_t cap = {.fail_after = 2};
+    char chunk[8];
+    json_writer_t w;
+    json_writer_init_stream(&w, chunk, sizeof(chunk), capture_sink, &cap);
+    write_sample(&w);
+    TEST_ASSERT_EQUAL_INT(-1, json_writer_finish(&w));
+    TEST_ASSERT_EQUAL_INT(2, cap.calls);
+    TEST_ASSERT_EQUAL_INT(0, cap.finals);
+}
+
+void test_misuse_fails_the_document(void)
+{
+    char buf[64];
+    json_writer_t w;
+
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w);
+    TEST_ASSERT_EQUAL_INT(-1, json_writer_finish(&w));
+
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w);
+    json_writer_uint(&w, 1);
+    json_writer_end_object(&w);
+    TEST_ASSERT_EQUAL_INT(-1, json_writer_finish(&w));
+
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_array(&w);
+    json_writer_key(&w, "k");
+    json_writer_end_array(&w);
+    TEST_ASSERT_EQUAL_INT(-1, json_writer_finish(&w));
+
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    json_writer_begin_array(&w);
+    json_writer_end_object(&w);
+    TEST_ASSERT_EQUAL_INT(-1, json_writer_finish(&w));
+
+    json_writer_init_buf(&w, buf, sizeof(buf));
+    for (int i = 0; i <= JSON_WRITER_MAX_DEPTH; i++) {
+        json_writer_begin_array(&w);
+    }
+    TEST_ASSERT_EQUAL_INT(-1, json_writer_finish(&w));
+}
+
+void test_mixer_status_round_trips_through_decoder(void)
+{
+    s_mixer.schema_version = MIXER_SCHEMA_VERSION;
+    s_mixer.out_gain_pct = 175;
+    s_mixer.stream_count = MIXER_MAX_STREAMS;
+    for (uint8_t i = 0; i < MIXER_MAX_STREAMS; i++) {
+        s_mixer.streams[i].stream_id = (uint8_t)(MIXER_STREAM_ID_MIN + i);
+        s_mixer.streams[i].gain_pct = (uint16_t)(50 * (i + 1));
+        s_mixer.streams[i].enabled = (i % 2) == 0;
+        s_mixer.streams[i].muted = i == 1;
+        s_mixer.streams[i].solo = i == 2;
+        s_mixer.streams[i].active = s_mixer.streams[i].enabled;
+    }
+    strcpy(s_mixer.last_error, "bad \"gain\"");
+
+    char buf[1024];
+    int len = mixer_ctrl_serialize_json(buf, sizeof(buf));
+    TEST_ASSERT_TRUE(len > 0 && len < (int)sizeof(buf));
+
+    mixer_ctrl_message_t msg = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, mixer_ctrl_decode_json(buf, &msg));
+    TEST_ASSERT_EQUAL_UINT16(175, msg.out_gain_pct);
+    TEST_ASSERT_EQUAL_UINT8(MIXER_MAX_STREAMS, msg.stream_count);
+    for (uint8_t i = 0; i < MIXER_MAX_STREAMS; i++) {
+        TEST_ASSERT_EQUAL_UINT8(s_mixer.streams[i].stream_id, msg.streams[i].stream_id);
+        TEST_ASSERT_EQUAL_UINT16(s_mixer.streams[i].gain_pct, msg.streams[i].gain_pct);
+        TEST_ASSERT_EQUAL(s_mixer.streams[i].muted, msg.streams[i].muted);
+        TEST_ASSERT_EQUAL(s_mixer.streams[i].solo, msg.streams[i].solo);
+    }
+
+    char err[64];
+    TEST_ASSERT_TRUE(json_extract_string_field(buf, "lastError", err, sizeof(err)));
+    TEST_ASSERT_EQUAL_STRING("bad \"gain\"", err);
+}
+
+void test_uplink_status_redacts_ssid(void)
+{
+    s_uplink.enabled = true;
+    s_uplink.configured = true;
+    s_uplink.root_applied = true;
+    strcpy(s_uplink.ssid, "VenueNet");
+    strcpy(s_uplink.last_error, "join C:\\ failed");
+    s_uplink.updated_ms = 4000000000U;
+
+    char buf[256];
+    int len = uplink_ctrl_serialize_json(buf, sizeof(buf));
+    TEST_ASSERT_TRUE(len > 0 && len < (int)sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("{\"enabled\":true,\"configured\":true,\"rootApplied\":true,\"pendingApply\":false,"
+                             "\"ssid\":\"<configured>\",\"lastError\":\"join C:\\\\ failed\",\"updatedMs\":4000000000}",
+                             buf);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_buffer_mode_places_commas_and_nesting);
+    RUN_TEST(test_strings_are_escaped_and_round_trip);
+    RUN_TEST(test_numbers_format_without_printf);
+    RUN_TEST(test_mac_is_colon_separated_hex);
+    RUN_TEST(test_truncation_reports_full_length_like_snprintf);
+    RUN_TEST(test_stream_mode_flushes_small_chunks_into_same_document);
+    RUN_TEST(test_stream_mode_stops_after_sink_error);
+    RUN_TEST(test_misuse_fails_the_document);
+    RUN_TEST(test_mixer_status_round_trips_through_decoder);
+    RUN_TEST(test_uplink_status_redacts_ssid);
+    return UNITY_END();
+}
@@ -0,0 +1,273 @@
+#include <unity.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/latency_queue.h"
+#include "../../../lib/audio/src/latency_queue.c"
+
+#define FRAME_US 20000
+
+static uint8_t s_buf[1024];
+static latency_queue_t s_q;
+
+static void fill(uint8_t *p, size_t len, uint8_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        p[i] = (uint8_t)(seed + i);
+    }
+}
+
+void setUp(void)
+{
+    memset(s_buf, 0xEE, sizeof(s_buf));
+    latency_queue_init(&s_q, s_buf, sizeof(s_buf), 0);
+}
+
+void tearDown(void) {}
+
+void test_items_come_out_in_order_with_their_age(void)
+{
+    uint8_t a[10], b[30];
+    fill(a, sizeof(a), 1);
+    fill(b, sizeof(b), 100);
+    TEST_ASSERT_TRUE(latency_queue_push(&s_q, a, sizeof(a), 1000));
+    TEST_ASSERT_TRUE(latency_queue_push(&s_q, b, sizeof(b), 2000));
+    TEST_ASSERT_EQUAL_UINT32(40, latency_queue_available(&s_q));
+
+    size_t len = 0;
+    const uint8_t *item = latency_queue_peek(&s_q, &len, 5000);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(a), len);
+    TEST_ASSERT_EQUAL_MEMORY(a, item, sizeof(a));
+    latency_queue_release(&s_q, 5000);
+
+    item = latency_queue_peek(&s_q, &len, 6000);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(b), len);
+    TEST_ASSERT_EQUAL_MEMORY(b, item, sizeof(b));
+    latency_queue_release(&s_q, 6000);
+    TEST_ASSERT_NULL(latency_queue_peek(&s_q, &len, 7000));
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(2, st.enqueued);
+    TEST_ASSERT_EQUAL_UINT32(2, st.dequeued);
+    TEST_ASSERT_EQUAL_UINT32(4000, st.age_last_us);
+    TEST_ASSERT_EQUAL_UINT32(4000, st.age_max_us);
+    TEST_ASSERT_EQUAL_UINT64(8000, st.age_total_us);
+    TEST_ASSERT_EQUAL_UINT32(2, st.items_peak);
+    TEST_ASSERT_EQUAL_UINT32(40, st.bytes_peak);
+}
+
+void test_stream_read_spans_and_splits_items(void)
+{
+    uint8_t src[64], out[64];
+    fill(src, sizeof(src), 7);
+    TEST_ASSERT_TRUE(latency_queue_push(&s_q, src, 24, 0));
+    TEST_ASSERT_TRUE(latency_queue_push(&s_q, src + 24, 40, 0));
+
+    TEST_ASSERT_FALSE(latency_queue_read(&s_q, out, 65, 0));
+    TEST_ASSERT_TRUE(latency_queue_read(&s_q, out, 16, 0));
+    TEST_ASSERT_EQUAL_UINT32(48, latency_queue_available(&s_q));
+    TEST_ASSERT_TRUE(latency_queue_read(&s_q, out + 16, 20, 0));
+    TEST_ASSERT_TRUE(latency_queue_read(&s_q, out + 36, 28, 0));
+    TEST_ASSERT_EQUAL_MEMORY(src, out, sizeof(src));
+    TEST_ASSERT_EQUAL_UINT32(0, latency_queue_available(&s_q));
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(2, st.dequeued);
+    TEST_ASSERT_EQUAL_UINT32(0, st.items);
+}
+
+void test_full_queue_evicts_oldest_instead_of_rejecting_newest(void)
+{
+    // 1024 bytes hold eight 112-byte items (16-byte header each).
+    uint8_t item[112];
+    for (uint8_t i = 0; i < 12; i++) {
+        fill(item, sizeof(item), i);
+        TEST_ASSERT_TRUE(latency_queue_push(&s_q, item, sizeof(item), i));
+    }
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(8, st.items);
+    TEST_ASSERT_EQUAL_UINT32(4, st.evicted);
+    TEST_ASSERT_EQUAL_UINT32(0, st.rejected);
+
+    for (uint8_t i = 4; i < 12; i++) {
+        size_t len = 0;
+        const uint8_t *got = latency_queue_peek(&s_q, &len, 100);
+        TEST_ASSERT_NOT_NULL(got);
+        TEST_ASSERT_EQUAL_UINT8(i, got[0]);
+        latency_queue_release(&s_q, 100);
+    }
+}
+
+void test_consumer_drops_items_past_the_budget(void)
+{
+    latency_queue_set_max_age(&s_q, 50000);
+    uint8_t item[8];
+    for (uint8_t i = 0; i < 5; i++) {
+        fill(item, sizeof(item), i);
+        latency_queue_push(&s_q, item, sizeof(item), (int64_t)i * FRAME_US);
+    }
+
+    // At 100 ms the items stamped 0, 20 and 40 ms are older than 50 ms.
+    size_t len = 0;
+    const uint8_t *got = latency_queue_peek(&s_q, &len, 100000);
+    TEST_ASSERT_NOT_NULL(got);
+    TEST_ASSERT_EQUAL_UINT8(3, got[0]);
+    latency_queue_release(&s_q, 100000);
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(3, st.expired);
+    TEST_ASSERT_EQUAL_UINT32(40000, st.age_max_us);
+    TEST_ASSERT_EQUAL_UINT32(1, st.items);
+
+    TEST_ASSERT_EQUAL_UINT32(1, latency_queue_expire(&s_q, 200000));
+    TEST_ASSERT_EQUAL_UINT32(0, latency_queue_available(&s_q));
+}
+
+void test_held_item_is_never_evicted(void)
+{
+    uint8_t item[240];
+    fill(item, sizeof(item), 0);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(latency_queue_push(&s_q, item, sizeof(item), 0));
+    }
+    size_t len = 0;
+    const uint8_t *held = latency_queue_peek(&s_q, &len, 0);
+    TEST_ASSERT_NOT_NULL(held);
+
+    TEST_ASSERT_FALSE(latency_queue_push(&s_q, item, sizeof(item), 0));
+    TEST_ASSERT_EQUAL_MEMORY(item, held, sizeof(item));
+    latency_queue_release(&s_q, 0);
+    TEST_ASSERT_TRUE(latency_queue_push(&s_q, item, sizeof(item), 0));
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(1, st.rejected);
+    TEST_ASSERT_EQUAL_UINT32(4, st.items);
+}
+
+void test_oversize_and_empty_items_are_rejected(void)
+{
+    static uint8_t big[1024];
+    TEST_ASSERT_FALSE(latency_queue_push(&s_q, big, sizeof(big) - LATENCY_QUEUE_ITEM_OVERHEAD + 1, 0));
+    TEST_ASSERT_FALSE(latency_queue_push(&s_q, big, 0, 0));
+    TEST_ASSERT_TRUE(latency_queue_push(&s_q, big, sizeof(big) - LATENCY_QUEUE_ITEM_OVERHEAD, 0));
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(2, st.rejected);
+    TEST_ASSERT_EQUAL_UINT32(1, st.items);
+}
+
+// Random sizes and interleavings against a plain FIFO of sequence numbers:
+// whatever survives eviction must come out whole and in order across wraps.
+void test_wraparound_matches_reference_fifo(void)
+{
+    uint32_t ref[512];
+    size_t ref_head = 0, ref_tail = 0;
+    uint8_t item[200], out[200];
+    uint32_t next = 0;
+    srand(1234);
+
+    for (int step = 0; step < 20000; step++) {
+        if (rand() % 3 != 0) {
+            size_t len = 4 + (size_t)(rand() % 190);
+            memcpy(item, &next, sizeof(next));
+            fill(item + 4, len - 4, (uint8_t)next);
+            uint32_t evicted_before = s_q.stats.evicted;
+            TEST_ASSERT_TRUE(latency_queue_push(&s_q, item, len, step));
+            ref_tail += s_q.stats.evicted - evicted_before;
+            ref[ref_head++ % 512] = next++;
+        } else {
+            size_t len = 0;
+            const uint8_t *got = latency_queue_peek(&s_q, &len, step);
+            if (ref_tail == ref_head) {
+                TEST_ASSERT_NULL(got);
+                continue;
+            }
+            TEST_ASSERT_NOT_NULL(got);
+            uint32_t seq;
+            memcpy(&seq, got, sizeof(seq));
+            TEST_ASSERT_EQUAL_UINT32(ref[ref_tail++ % 512], seq);
+            fill(out, len - 4, (uint8_t)seq);
+            TEST_ASSERT_EQUAL_MEMORY(out, got + 4, len - 4);
+            latency_queue_release(&s_q, step);
+        }
+        TEST_ASSERT_EQUAL_UINT32(ref_head - ref_tail, s_q.stats.items);
+    }
+}
+
+void test_reset_stats_keeps_occupancy(void)
+{
+    uint8_t item[16] = {0};
+    latency_queue_push(&s_q, item, sizeof(item), 0);
+    latency_queue_push(&s_q, item, sizeof(item), 0);
+    latency_queue_release(&s_q, 0);
+    size_t len;
+    latency_queue_peek(&s_q, &len, 10);
+    latency_queue_release(&s_q, 10);
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&s_q, &st, true);
+    TEST_ASSERT_EQUAL_UINT32(2, st.items_peak);
+    latency_queue_get_stats(&s_q, &st, false);
+    TEST_ASSERT_EQUAL_UINT32(0, st.enqueued);
+    TEST_ASSERT_EQUAL_UINT32(0, st.dequeued);
+    TEST_ASSERT_EQUAL_UINT32(0, st.age_max_us);
+    TEST_ASSERT_EQUAL_UINT32(1, st.items);
+    TEST_ASSERT_EQUAL_UINT32(1, st.items_peak);
+    TEST_ASSERT_EQUAL_UINT32(16, st.bytes_peak);
+}
+
+// The ceiling argument: a producer at one frame per 20 ms and a consumer that
+// stalls for 600 ms, then takes one frame per tick again. Without a budget the
+// stall would leave a full queue (320 ms) behind every later frame; with a
+// 100 ms budget no frame is ever played older than the budget and the backlog
+// left behind by the stall shrinks to what the budget covers.
+void test_stalled_consumer_cannot_ratchet_latency(void)
+{
+    static uint8_t buf[16 * (40 + LATENCY_QUEUE_ITEM_OVERHEAD)];
+    latency_queue_t q;
+    latency_queue_init(&q, buf, sizeof(buf), 100000);
+
+    uint8_t frame[40] = {0}, out[40];
+    for (int tick = 0; tick < 200; tick++) {
+        int64_t now = (int64_t)tick * FRAME_US;
+        TEST_ASSERT_TRUE(latency_queue_push(&q, frame, sizeof(frame), now));
+        bool stalled = tick >= 50 && tick < 80;
+        if (!stalled) {
+            int64_t play_at = now + FRAME_US / 2;
+            if (latency_queue_read(&q, out, sizeof(out), play_at)) {
+                TEST_ASSERT_TRUE(q.stats.age_last_us <= 100000);
+            }
+        }
+    }
+
+    latency_queue_stats_t st;
+    latency_queue_get_stats(&q, &st, false);
+    TEST_ASSERT_TRUE(st.age_max_us <= 100000);
+    TEST_ASSERT_TRUE(st.expired > 0);
+    TEST_ASSERT_EQUAL_UINT32(16, st.items_peak);
+    TEST_ASSERT_TRUE(st.items <= 100000 / FRAME_US + 1);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_items_come_out_in_order_with_their_age);
+    RUN_TEST(test_stream_read_spans_and_splits_items);
+    RUN_TEST(test_full_queue_evicts_oldest_instead_of_rejecting_newest);
+    RUN_TEST(test_consumer_drops_items_past_the_budget);
+    RUN_TEST(test_held_item_is_never_evicted);
+    RUN_TEST(test_oversize_and_empty_items_are_rejected);
+    RUN_TEST(test_wraparound_matches_reference_fifo);
+    RUN_TEST(test_reset_stats_keeps_occupancy);
+    RUN_TEST(test_stalled_consumer_cannot_ratchet_latency);
+    return UNITY_END();
+}
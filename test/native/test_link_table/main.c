@@ -0,0 +1,179 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "network/link_table.h"
+
+#include "../../../lib/network/src/link_table.c"
+
+static network_link_table_t table;
+
+static void make_mac(uint8_t mac[6], uint8_t n)
+{
+    const uint8_t base[6] = {0x24, 0x0A, 0xC4, 0x10, 0x20, 0x00};
+    memcpy(mac, base, 6);
+    mac[5] = n;
+}
+
+void setUp(void)
+{
+    network_link_table_init(&table);
+}
+
+void tearDown(void)
+{
+}
+
+void test_upsert_and_find_by_mac(void)
+{
+    uint8_t a[6], b[6];
+    make_mac(a, 1);
+    make_mac(b, 2);
+
+    network_link_entry_t *ea = network_link_table_upsert(&table, a, 100);
+    TEST_ASSERT_NOT_NULL(ea);
+    TEST_ASSERT_TRUE(ea == network_link_table_upsert(&table, a, 200));
+    TEST_ASSERT_TRUE(ea == network_link_table_find(&table, a));
+    TEST_ASSERT_NULL(network_link_table_find(&table, b));
+    TEST_ASSERT_EQUAL_UINT16(1, table.count);
+    TEST_ASSERT_EQUAL_INT64(100, ea->first_seen_ms);
+}
+
+void test_full_route_table_fits_and_every_node_is_found(void)
+{
+    uint8_t mac[6];
+    for (int i = 0; i < MESH_ROUTE_TABLE_SIZE; i++) {
+        make_mac(mac, (uint8_t)i);
+        mac[4] = (uint8_t)(i * 7);
+        TEST_ASSERT_NOT_NULL(network_link_table_upsert(&table, mac, 0));
+    }
+    make_mac(mac, 0xEE);
+    TEST_ASSERT_NULL(network_link_table_upsert(&table, mac, 0));
+
+    for (int i = 0; i < MESH_ROUTE_TABLE_SIZE; i++) {
+        make_mac(mac, (uint8_t)i);
+        mac[4] = (uint8_t)(i * 7);
+        network_link_entry_t *entry = network_link_table_find(&table, mac);
+        TEST_ASSERT_NOT_NULL(entry);
+        TEST_ASSERT_EQUAL_MEMORY(mac, entry->mac, 6);
+    }
+}
+
+void test_remove_keeps_probe_chains_intact(void)
+{
+    uint8_t mac[6];
+    for (int i = 0; i < 20; i++) {
+        make_mac(mac, (uint8_t)i);
+        network_link_table_upsert(&table, mac, 0);
+    }
+    for (int i = 0; i < 20; i += 2) {
+        make_mac(mac, (uint8_t)i);
+        TEST_ASSERT_TRUE(network_link_table_remove(&table, mac));
+    }
+    TEST_ASSERT_EQUAL_UINT16(10, table.count);
+    for (int i = 1; i < 20; i += 2) {
+        make_mac(mac, (uint8_t)i);
+        TEST_ASSERT_NOT_NULL(network_link_table_find(&table, mac));
+    }
+    make_mac(mac, 0);
+    TEST_ASSERT_FALSE(network_link_table_remove(&table, mac));
+    TEST_ASSERT_TRUE(table.tombstones <= MESH_LINK_TABLE_CAPACITY / 4);
+}
+
+void test_heartbeat_rssi_is_smoothed(void)
+{
+    uint8_t mac[6];
+    make_mac(mac, 1);
+
+    network_link_table_record_heartbeat(&table, mac, -60, 1000);
+    network_link_entry_t *entry = network_link_table_find(&table, mac);
+    TEST_ASSERT_EQUAL_INT8(-60, network_link_rssi_dbm(entry));
+
+    network_link_table_record_heartbeat(&table, mac, -80, 2000);
+    int8_t smoothed = network_link_rssi_dbm(entry);
+    TEST_ASSERT_TRUE(smoothed < -60 && smoothed > -70);
+    TEST_ASSERT_EQUAL_UINT32(500, network_link_heartbeat_age_ms(entry, 2500));
+}
+
+void test_rtt_tracks_min_and_average(void)
+{
+    uint8_t mac[6];
+    make_mac(mac, 1);
+
+    network_link_table_record_rtt(&table, mac, 8000, 0);
+    network_link_table_record_rtt(&table, mac, 4000, 0);
+    network_link_table_record_rtt(&table, mac, 16000, 0);
+
+    network_link_entry_t *entry = network_link_table_find(&table, mac);
+    TEST_ASSERT_EQUAL_UINT32(4000, entry->rtt_min_us);
+    TEST_ASSERT_EQUAL_UINT32(3, entry->rtt_samples);
+    TEST_ASSERT_TRUE(entry->rtt_avg_us > 7000 && entry->rtt_avg_us < 9000);
+}
+
+void test_loss_is_measured_per_heartbeat_interval(void)
+{
+    uint8_t mac[6];
+    make_mac(mac, 1);
+
+    network_link_table_close_loss_interval(&table, mac, 1000, 0);
+    network_link_table_record_loss(&table, mac, 10, 100);
+    network_link_table_record_loss(&table, mac, 10, 200);
+    network_link_table_close_loss_interval(&table, mac, 1100, 5000);
+
+    network_link_entry_t *entry = network_link_table_find(&table, mac);
+    TEST_ASSERT_EQUAL_UINT32(20, entry->lost_frames);
+    // 20% sample with EWMA alpha 1/4 from 0.
+    TEST_ASSERT_EQUAL_UINT8(5, network_link_loss_pct(entry));
+
+    network_link_table_close_loss_interval(&table, mac, 1200, 10000);
+    TEST_ASSERT_TRUE(network_link_loss_pct(entry) < 5);
+}
+
+void test_expire_drops_silent_nodes(void)
+{
+    uint8_t a[6], b[6];
+    make_mac(a, 1);
+    make_mac(b, 2);
+    network_link_table_record_heartbeat(&table, a, -50, 1000);
+    network_link_table_record_heartbeat(&table, b, -50, 20000);
+
+    TEST_ASSERT_EQUAL_size_t(1, network_link_table_expire(&table, 32000, 30000));
+    TEST_ASSERT_NULL(network_link_table_find(&table, a));
+    TEST_ASSERT_NOT_NULL(network_link_table_find(&table, b));
+}
+
+void test_iterator_yields_each_used_entry_in_place(void)
+{
+    uint8_t mac[6];
+    for (int i = 0; i < 5; i++) {
+        make_mac(mac, (uint8_t)i);
+        network_link_table_upsert(&table, mac, 0);
+    }
+    make_mac(mac, 2);
+    network_link_table_remove(&table, mac);
+
+    network_link_iter_t it;
+    const network_link_entry_t *entry;
+    int seen = 0;
+    network_link_iter_begin(&it, &table);
+    while ((entry = network_link_iter_next(&it)) != NULL) {
+        TEST_ASSERT_TRUE(entry >= &table.slots[0] && entry < &table.slots[MESH_LINK_TABLE_CAPACITY]);
+        TEST_ASSERT_TRUE(entry->mac[5] != 2);
+        seen++;
+    }
+    TEST_ASSERT_EQUAL_INT(4, seen);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_upsert_and_find_by_mac);
+    RUN_TEST(test_full_route_table_fits_and_every_node_is_found);
+    RUN_TEST(test_remove_keeps_probe_chains_intact);
+    RUN_TEST(test_heartbeat_rssi_is_smoothed);
+    RUN_TEST(test_rtt_tracks_min_and_average);
+    RUN_TEST(test_loss_is_measured_per_heartbeat_interval);
+    RUN_TEST(test_expire_drops_silent_nodes);
+    RUN_TEST(test_iterator_yields_each_used_entry_in_place);
+    return UNITY_END();
+}
@@ -0,0 +1,195 @@
+#include <unity.h>
+
+#include "mesh/mesh_fanout.h"
+
+#include "../../../lib/network/src/mesh/mesh_fanout.c"
+
+static mesh_fanout_policy_t policy;
+static mesh_fanout_config_t cfg;
+
+static void run_window(uint16_t descendants, int64_t *now_ms, uint16_t sends_per_packet,
+                       uint16_t queue_full_per_packet, uint16_t lost_frames)
+{
+    for (int i = 0; i < 25; i++) {
+        mesh_fanout_select(&policy, descendants, *now_ms);
+        // Alternate saturated/clean packets so the streak shortcut stays out of the way.
+        uint16_t qf = (i % 2 == 0) ? queue_full_per_packet : 0;
+        mesh_fanout_record_send(&policy, 2, sends_per_packet, qf);
+        *now_ms += 40;
+    }
+    mesh_fanout_record_loss(&policy, lost_frames);
+    *now_ms = ((*now_ms / cfg.window_ms) + 1) * cfg.window_ms;
+    mesh_fanout_select(&policy, descendants, *now_ms);
+}
+
+void setUp(void)
+{
+    cfg = (mesh_fanout_config_t)MESH_FANOUT_CONFIG_DEFAULT();
+    cfg.p2p_max_children = 10;
+    cfg.p2p_return_children = 8;
+    cfg.window_ms = 1000;
+    cfg.switch_windows = 3;
+    cfg.min_dwell_ms = 2000;
+    cfg.qfull_enter_pct = 10;
+    cfg.qfull_streak = 8;
+    cfg.loss_enter_pct = 5;
+    cfg.p2p_cooldown_ms = 30000;
+    mesh_fanout_init(&policy, &cfg, 0);
+}
+
+void tearDown(void)
+{
+}
+
+void test_starts_in_broadcast_and_picks_mode_by_size(void)
+{
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_BROADCAST, mesh_fanout_select(&policy, 0, 0));
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, mesh_fanout_select(&policy, 3, 10));
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_REASON_SIZE, policy.reason);
+
+    mesh_fanout_init(&policy, &cfg, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, mesh_fanout_select(&policy, 11, 10));
+}
+
+void test_losing_all_routes_falls_back_to_broadcast_immediately(void)
+{
+    mesh_fanout_select(&policy, 3, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_BROADCAST, mesh_fanout_select(&policy, 0, 10));
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_REASON_NO_ROUTE, policy.reason);
+}
+
+void test_p2p_moves_to_group_only_after_sustained_queue_full(void)
+{
+    int64_t now = 0;
+    mesh_fanout_select(&policy, 4, now);
+
+    run_window(4, &now, 4, 2, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, policy.mode);
+    run_window(4, &now, 4, 2, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, policy.mode);
+    run_window(4, &now, 4, 2, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, policy.mode);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_REASON_QUEUE_FULL, policy.reason);
+}
+
+void test_single_noisy_window_does_not_switch(void)
+{
+    int64_t now = 0;
+    mesh_fanout_select(&policy, 4, now);
+
+    run_window(4, &now, 4, 2, 0);
+    run_window(4, &now, 4, 0, 0);
+    run_window(4, &now, 4, 2, 0);
+    run_window(4, &now, 4, 0, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, policy.mode);
+    TEST_ASSERT_EQUAL_UINT32(1, policy.switches);
+}
+
+void test_queue_full_streak_switches_without_waiting_for_windows(void)
+{
+    mesh_fanout_select(&policy, 4, 0);
+    int64_t now = cfg.min_dwell_ms;
+    for (uint32_t i = 0; i < cfg.qfull_streak; i++) {
+        mesh_fanout_record_send(&policy, 2, 4, 1);
+    }
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, mesh_fanout_select(&policy, 4, now));
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_REASON_QUEUE_FULL, policy.reason);
+}
+
+void test_queue_full_streak_respects_min_dwell(void)
+{
+    mesh_fanout_select(&policy, 4, 0);
+    for (uint32_t i = 0; i < cfg.qfull_streak; i++) {
+        mesh_fanout_record_send(&policy, 2, 4, 1);
+    }
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, mesh_fanout_select(&policy, 4, cfg.min_dwell_ms - 1));
+}
+
+void test_group_loss_returns_to_p2p_for_small_mesh(void)
+{
+    int64_t now = 0;
+    mesh_fanout_select(&policy, 12, now);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, policy.mode);
+
+    // Shrinks to 9 children: above the return threshold, so only loss can move it.
+    run_window(9, &now, 1, 0, 0);
+    run_window(9, &now, 1, 0, 0);
+    run_window(9, &now, 1, 0, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, policy.mode);
+
+    run_window(9, &now, 1, 0, 5);
+    run_window(9, &now, 1, 0, 5);
+    run_window(9, &now, 1, 0, 5);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, policy.mode);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_REASON_LOSS, policy.reason);
+}
+
+void test_group_from_size_returns_to_p2p_below_hysteresis_band(void)
+{
+    int64_t now = 0;
+    mesh_fanout_select(&policy, 12, now);
+
+    run_window(8, &now, 1, 0, 0);
+    run_window(8, &now, 1, 0, 0);
+    run_window(8, &now, 1, 0, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, policy.mode);
+}
+
+void test_group_after_saturation_waits_for_p2p_cooldown(void)
+{
+    int64_t now = 0;
+    mesh_fanout_select(&policy, 4, now);
+    run_window(4, &now, 4, 2, 0);
+    run_window(4, &now, 4, 2, 0);
+    run_window(4, &now, 4, 2, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, policy.mode);
+
+    run_window(4, &now, 1, 0, 10);
+    run_window(4, &now, 1, 0, 10);
+    run_window(4, &now, 1, 0, 10);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, policy.mode);
+
+    now += cfg.p2p_cooldown_ms;
+    run_window(4, &now, 1, 0, 10);
+    run_window(4, &now, 1, 0, 10);
+    run_window(4, &now, 1, 0, 10);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_P2P, policy.mode);
+}
+
+void test_growth_past_p2p_limit_forces_group(void)
+{
+    mesh_fanout_select(&policy, 4, 0);
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_GROUP, mesh_fanout_select(&policy, 11, 10));
+    TEST_ASSERT_EQUAL_INT(MESH_FANOUT_REASON_SIZE, policy.reason);
+}
+
+void test_window_stats_are_exposed_for_logging(void)
+{
+    int64_t now = 0;
+    mesh_fanout_select(&policy, 4, now);
+    run_window(4, &now, 4, 2, 5);
+
+    TEST_ASSERT_EQUAL_UINT32(25, policy.last_window.packets);
+    TEST_ASSERT_EQUAL_UINT32(100, policy.last_window.sends);
+    TEST_ASSERT_EQUAL_UINT32(26, policy.last_window.queue_full);
+    TEST_ASSERT_EQUAL_UINT32(10, mesh_fanout_window_pct(policy.last_window.lost_frames, policy.last_window.frames));
+    TEST_ASSERT_EQUAL_STRING("P2P", mesh_fanout_mode_name(policy.mode));
+    TEST_ASSERT_EQUAL_STRING("size", mesh_fanout_reason_name(policy.reason));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_in_broadcast_and_picks_mode_by_size);
+    RUN_TEST(test_losing_all_routes_falls_back_to_broadcast_immediately);
+    RUN_TEST(test_p2p_moves_to_group_only_after_sustained_queue_full);
+    RUN_TEST(test_single_noisy_window_does_not_switch);
+    RUN_TEST(test_queue_full_streak_switches_without_waiting_for_windows);
+    RUN_TEST(test_queue_full_streak_respects_min_dwell);
+    RUN_TEST(test_group_loss_returns_to_p2p_for_small_mesh);
+    RUN_TEST(test_group_from_size_returns_to_p2p_below_hysteresis_band);
+    RUN_TEST(test_group_after_saturation_waits_for_p2p_cooldown);
+    RUN_TEST(test_growth_past_p2p_limit_forces_group);
+    RUN_TEST(test_window_stats_are_exposed_for_logging);
+    return UNITY_END();
+}
@@ -7,6 +7,9 @@
 #define ADC_CHANNEL_3 3
 
 #include "../../../lib/network/src/mesh/mesh_queries.c"
+#include "../../../lib/network/src/packet_pool.c"
+#include "../../../lib/network/src/rtt_estimator.c"
+#include "../../../lib/network/src/stat_counters.c"
 
 static bool stub_mesh_root = false;
 static uint8_t stub_mesh_layer = 0;
@@ -38,21 +41,13 @@ mesh_addr_t mesh_parent_addr = {{0}};
 
 uint32_t measured_latency_ms = 0;
 int8_t mesh_parent_rssi = -100;
-bool ping_pending = false;
 int8_t nearest_child_rssi = -100;
 uint32_t nearest_child_latency_ms = 0;
 mesh_addr_t nearest_child_addr = {{0}};
-bool child_ping_pending = false;
-int64_t last_ping_sent_us = 0;
-int64_t last_child_ping_sent_us = 0;
 
 static mesh_addr_t stub_cached_root_addr = {{0}};
 static bool stub_have_root_addr = false;
 
-uint32_t ping_seq = 0;
-uint32_t child_ping_seq = 0;
-uint32_t pending_ping_id = 0;
-uint32_t pending_child_ping_id = 0;
 uint32_t no_parent_count = 0;
 uint32_t scan_done_count = 0;
 uint32_t join_fail_count = 0;
@@ -77,7 +72,13 @@ network_heartbeat_callback_t heartbeat_rx_callback = NULL;
 uint32_t total_drops = 0;
 uint32_t total_sent = 0;
 volatile uint32_t tx_bytes_counter = 0;
-network_transport_stats_t g_transport_stats = {0};
+static _Atomic uint32_t transport_stat_words[STAT_COUNTER_SHARDS * NETWORK_TRANSPORT_STAT_WORDS];
+static uint32_t transport_stat_baseline[NETWORK_TRANSPORT_STAT_WORDS];
+static const uint16_t transport_stat_gauges[] = { NETWORK_TRANSPORT_STAT(rx_audio_burst_loss_max) };
+network_stat_counters_t g_transport_counters;
+network_ping_tracker_t g_ping_tracker;
+network_rtt_window_t g_rtt_upstream;
+network_rtt_window_t g_rtt_downstream;
 
 uint8_t mesh_rx_buffer[MESH_RX_BUFFER_SIZE] = {0};
 const mesh_addr_t audio_multicast_group = {{0}};
@@ -135,10 +136,23 @@ void vTaskDelay(uint32_t ticks)
     stub_last_delay_ticks = ticks;
 }
 
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)&stub_time_us;
+}
+
 void mesh_state_notify_waiting_tasks(void)
 {
 }
 
+void mesh_link_lock(void)
+{
+}
+
+void mesh_link_unlock(void)
+{
+}
+
 bool mesh_state_has_root_addr(void)
 {
     return stub_have_root_addr;
@@ -196,7 +210,12 @@ static void reset_state(void)
     rejoin_window_start_ms = 0;
     rejoin_cooldown_until_ms = 0;
     memset(nearest_child_addr.addr, 0, sizeof(nearest_child_addr.addr));
-    memset(&g_transport_stats, 0, sizeof(g_transport_stats));
+    network_stat_counters_init(&g_transport_counters, transport_stat_words, transport_stat_baseline,
+                               NETWORK_TRANSPORT_STAT_WORDS, transport_stat_gauges, 1);
+    transport_rates.primed = false;
+    transport_rates.valid = false;
+    network_rtt_window_init(&g_rtt_upstream);
+    network_rtt_window_init(&g_rtt_downstream);
 }
 
 void setUp(void)
@@ -316,7 +335,7 @@ void test_trigger_rejoin_resets_state_and_reconnects_child(void)
     TEST_ASSERT_EQUAL_INT(1, stub_connect_calls);
     TEST_ASSERT_EQUAL_UINT32(50, stub_last_delay_ticks);
     TEST_ASSERT_EQUAL_UINT32(1, rejoin_attempt_count);
-    TEST_ASSERT_EQUAL_UINT32(1, g_transport_stats.rejoin_trigger_events);
+    TEST_ASSERT_EQUAL_UINT32(1, NET_STAT_GET(rejoin_trigger_events));
 }
 
 void test_trigger_rejoin_surfaces_connect_failure(void)
@@ -352,7 +371,7 @@ void test_trigger_rejoin_blocked_during_cooldown(void)
     TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_STATE, network_trigger_rejoin());
     TEST_ASSERT_EQUAL_INT(0, stub_disconnect_calls);
     TEST_ASSERT_EQUAL_INT(0, stub_connect_calls);
-    TEST_ASSERT_EQUAL_UINT32(1, g_transport_stats.rejoin_blocked_events);
+    TEST_ASSERT_EQUAL_UINT32(1, NET_STAT_GET(rejoin_blocked_events));
 }
 
 void test_trigger_rejoin_trips_circuit_breaker_at_attempt_limit(void)
@@ -366,7 +385,7 @@ void test_trigger_rejoin_trips_circuit_breaker_at_attempt_limit(void)
     TEST_ASSERT_TRUE(rejoin_cooldown_until_ms > 1500);
     TEST_ASSERT_EQUAL_INT(0, stub_disconnect_calls);
     TEST_ASSERT_EQUAL_INT(0, stub_connect_calls);
-    TEST_ASSERT_EQUAL_UINT32(1, g_transport_stats.rejoin_circuit_breaker_events);
+    TEST_ASSERT_EQUAL_UINT32(1, NET_STAT_GET(rejoin_circuit_breaker_events));
 }
 
 void test_trigger_rejoin_resets_attempt_window_after_timeout(void)
@@ -382,15 +401,15 @@ void test_trigger_rejoin_resets_attempt_window_after_timeout(void)
     TEST_ASSERT_EQUAL_UINT32(1, rejoin_attempt_count);
     TEST_ASSERT_EQUAL_INT(1, stub_disconnect_calls);
     TEST_ASSERT_EQUAL_INT(1, stub_connect_calls);
-    TEST_ASSERT_EQUAL_UINT32(1, g_transport_stats.rejoin_trigger_events);
+    TEST_ASSERT_EQUAL_UINT32(1, NET_STAT_GET(rejoin_trigger_events));
 }
 
 void test_transport_stats_snapshot_and_reset_roundtrip(void)
 {
-    g_transport_stats.tx_audio_packets = 11;
-    g_transport_stats.tx_audio_send_failures = 3;
-    g_transport_stats.rx_audio_duplicates = 7;
-    g_transport_stats.rejoin_trigger_events = 2;
+    NET_STAT_ADD(tx_audio_packets, 11);
+    NET_STAT_ADD(tx_audio_send_failures, 3);
+    NET_STAT_ADD(rx_audio_duplicates, 7);
+    NET_STAT_ADD(rejoin_trigger_events, 2);
 
     network_transport_stats_t snapshot = {0};
     TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats(&snapshot));
@@ -414,6 +433,89 @@ void test_transport_stats_snapshot_and_reset_roundtrip(void)
     TEST_ASSERT_EQUAL_UINT32(0, after_reset.rejoin_trigger_events);
 }
 
+void test_transport_stats_reset_clears_gauges_until_next_update(void)
+{
+    NET_STAT_MAX(rx_audio_burst_loss_max, 9);
+    NET_STAT_MAX(rx_audio_burst_loss_max, 4);
+
+    network_transport_stats_t snapshot = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats_and_reset(&snapshot));
+    TEST_ASSERT_EQUAL_UINT32(9, snapshot.rx_audio_burst_loss_max);
+
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats(&snapshot));
+    TEST_ASSERT_EQUAL_UINT32(0, snapshot.rx_audio_burst_loss_max);
+
+    NET_STAT_MAX(rx_audio_burst_loss_max, 3);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats(&snapshot));
+    TEST_ASSERT_EQUAL_UINT32(3, snapshot.rx_audio_burst_loss_max);
+}
+
+void test_transport_rate_tracks_counter_per_second(void)
+{
+    network_stat_rate_t rate;
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, network_get_transport_rate(NETWORK_TRANSPORT_STAT_WORDS, &rate));
+
+    mesh_queries_stats_tick(1000000);
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_STATE,
+                          network_get_transport_rate(NETWORK_TRANSPORT_STAT(rx_audio_packets), &rate));
+
+    NET_STAT_ADD(rx_audio_packets, 25);
+    mesh_queries_stats_tick(1200000);  // Too early: ignored
+    mesh_queries_stats_tick(2000000);
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_rate(NETWORK_TRANSPORT_STAT(rx_audio_packets), &rate));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, rate.per_sec_1s);
+    TEST_ASSERT_TRUE(rate.per_sec_10s > 0.0f && rate.per_sec_10s < rate.per_sec_1s);
+
+    // A reset does not disturb rates, which are computed from raw totals.
+    network_transport_stats_t drained;
+    network_get_transport_stats_and_reset(&drained);
+    NET_STAT_ADD(rx_audio_packets, 10);
+    mesh_queries_stats_tick(3000000);
+    network_get_transport_rate(NETWORK_TRANSPORT_STAT(rx_audio_packets), &rate);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, rate.per_sec_1s);
+}
+
+void test_transport_stats_export_packet_pool_usage(void)
+{
+    network_pkt_pool_reset();
+    network_pkt_buf_t *held = network_pkt_alloc();
+    network_pkt_buf_t *freed = network_pkt_alloc();
+    network_pkt_release(freed);
+
+    network_transport_stats_t snapshot = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats_and_reset(&snapshot));
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.pkt_pool_in_use);
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.pkt_pool_high_water);
+
+    network_transport_stats_t after_reset = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats(&after_reset));
+    TEST_ASSERT_EQUAL_UINT32(1, after_reset.pkt_pool_high_water);
+
+    network_pkt_release(held);
+    network_pkt_pool_reset();
+}
+
+void test_transport_stats_export_rtt_windows_across_reset(void)
+{
+    for (uint32_t i = 1; i <= 20; i++) {
+        network_rtt_window_add(&g_rtt_upstream, i * 1000);
+    }
+    network_rtt_window_add(&g_rtt_downstream, 4000);
+
+    network_transport_stats_t snapshot = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats_and_reset(&snapshot));
+    TEST_ASSERT_EQUAL_UINT32(20, snapshot.rtt_up_samples);
+    TEST_ASSERT_EQUAL_UINT32(1000, snapshot.rtt_up_min_us);
+    TEST_ASSERT_EQUAL_UINT32(10000, snapshot.rtt_up_p50_us);
+    TEST_ASSERT_EQUAL_UINT32(19000, snapshot.rtt_up_p95_us);
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.rtt_down_samples);
+    TEST_ASSERT_EQUAL_UINT32(4000, snapshot.rtt_down_p95_us);
+
+    network_transport_stats_t after_reset = {0};
+    TEST_ASSERT_EQUAL_INT(ESP_OK, network_get_transport_stats(&after_reset));
+    TEST_ASSERT_EQUAL_UINT32(20, after_reset.rtt_up_samples);
+}
+
 void test_transport_stats_reject_null_output(void)
 {
     TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, network_get_transport_stats(NULL));
@@ -493,6 +595,10 @@ int main(void)
     RUN_TEST(test_trigger_rejoin_trips_circuit_breaker_at_attempt_limit);
     RUN_TEST(test_trigger_rejoin_resets_attempt_window_after_timeout);
     RUN_TEST(test_transport_stats_snapshot_and_reset_roundtrip);
+    RUN_TEST(test_transport_stats_reset_clears_gauges_until_next_update);
+    RUN_TEST(test_transport_rate_tracks_counter_per_second);
+    RUN_TEST(test_transport_stats_export_packet_pool_usage);
+    RUN_TEST(test_transport_stats_export_rtt_windows_across_reset);
     RUN_TEST(test_transport_stats_reject_null_output);
     RUN_TEST(test_get_tx_bytes_and_reset_clears_counter);
     RUN_TEST(test_get_rssi_returns_default_on_wifi_error);
@@ -0,0 +1,258 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "mesh/mesh_retransmit.h"
+
+#include "../../../lib/network/src/mesh/mesh_retransmit.c"
+#include "../../../lib/network/src/packet_pool.c"
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    static int mutex;
+    return &mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem;
+    (void)ticks;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+static network_pkt_buf_t *build_audio_packet(uint8_t stream_id, uint16_t seq, uint8_t frame_count)
+{
+    network_pkt_buf_t *buf = network_pkt_alloc();
+    TEST_ASSERT_NOT_NULL(buf);
+    memset(buf->data, 0, MAX_PACKET_SIZE);
+    net_frame_header_t *hdr = (net_frame_header_t *)buf->data;
+    hdr->magic = NET_FRAME_MAGIC;
+    hdr->version = NET_FRAME_VERSION;
+    hdr->type = NET_PKT_TYPE_AUDIO_OPUS;
+    hdr->ttl = 6;
+    hdr->seq = htons(seq);
+    hdr->stream_id = stream_id;
+    hdr->frame_count = frame_count;
+    hdr->payload_len = htons(4);
+    buf->data[NET_FRAME_HEADER_SIZE] = 0xAB;
+    buf->len = NET_FRAME_HEADER_SIZE + 4;
+    return buf;
+}
+
+// Mirrors the TX path: the cache takes its own reference, the sender drops its one.
+static bool store_audio_packet(uint8_t stream_id, uint16_t seq, uint8_t frame_count, int64_t now_us)
+{
+    network_pkt_buf_t *buf = build_audio_packet(stream_id, seq, frame_count);
+    bool stored = mesh_retx_cache_store(buf, stream_id, seq, frame_count, now_us);
+    network_pkt_release(buf);
+    return stored;
+}
+
+static bool cached(uint8_t stream_id, uint16_t seq)
+{
+    mesh_retx_entry_t entry;
+    if (!mesh_retx_cache_acquire(stream_id, seq, &entry)) {
+        return false;
+    }
+    network_pkt_release(entry.buf);
+    return true;
+}
+
+void setUp(void)
+{
+    mesh_retx_cache_init();
+    network_pkt_pool_reset();
+}
+
+void tearDown(void)
+{
+}
+
+void test_lookup_finds_every_sequence_in_batched_packet(void)
+{
+    TEST_ASSERT_TRUE(store_audio_packet(1, 100, 2, 5000));
+
+    mesh_retx_entry_t first;
+    mesh_retx_entry_t second;
+    TEST_ASSERT_TRUE(mesh_retx_cache_acquire(1, 100, &first));
+    TEST_ASSERT_TRUE(mesh_retx_cache_acquire(1, 101, &second));
+    TEST_ASSERT_TRUE(first.buf == second.buf);
+    TEST_ASSERT_EQUAL_UINT16(100, second.base_seq);
+    TEST_ASSERT_EQUAL_size_t(NET_FRAME_HEADER_SIZE + 4, first.buf->len);
+    TEST_ASSERT_EQUAL_INT64(5000, first.sent_us);
+    TEST_ASSERT_EQUAL_UINT8(0xAB, first.buf->data[NET_FRAME_HEADER_SIZE]);
+    // The cache's reference plus one per acquire.
+    TEST_ASSERT_EQUAL_UINT(3, atomic_load(&first.buf->refs));
+    network_pkt_release(first.buf);
+    network_pkt_release(second.buf);
+    TEST_ASSERT_FALSE(cached(1, 102));
+    TEST_ASSERT_FALSE(cached(2, 100));
+}
+
+void test_acquired_buffer_survives_eviction(void)
+{
+    store_audio_packet(1, 0, 2, 0);
+    mesh_retx_entry_t entry;
+    TEST_ASSERT_TRUE(mesh_retx_cache_acquire(1, 0, &entry));
+
+    // The encode task overwrites the whole ring while the RX task still sends.
+    for (int i = 1; i <= MESH_RETX_CACHE_SLOTS; i++) {
+        store_audio_packet(1, (uint16_t)(i * 2), 2, 0);
+    }
+    TEST_ASSERT_FALSE(cached(1, 0));
+    TEST_ASSERT_EQUAL_UINT(1, atomic_load(&entry.buf->refs));
+
+    // Nothing the pool hands out can alias the buffer until it is released.
+    network_pkt_buf_t *fresh[MESH_PKT_POOL_SIZE];
+    int allocated = 0;
+    while (allocated < MESH_PKT_POOL_SIZE && (fresh[allocated] = network_pkt_alloc()) != NULL) {
+        TEST_ASSERT_TRUE(fresh[allocated] != entry.buf);
+        allocated++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(0xAB, entry.buf->data[NET_FRAME_HEADER_SIZE]);
+    for (int i = 0; i < allocated; i++) {
+        network_pkt_release(fresh[i]);
+    }
+    network_pkt_release(entry.buf);
+    TEST_ASSERT_EQUAL_UINT(0, atomic_load(&entry.buf->refs));
+}
+
+void test_store_rejects_invalid_packets(void)
+{
+    network_pkt_buf_t *buf = network_pkt_alloc();
+
+    TEST_ASSERT_FALSE(mesh_retx_cache_store(NULL, 1, 7, 1, 0));
+    buf->len = 0;
+    TEST_ASSERT_FALSE(mesh_retx_cache_store(buf, 1, 7, 1, 0));
+    buf->len = MAX_PACKET_SIZE + 1;
+    TEST_ASSERT_FALSE(mesh_retx_cache_store(buf, 1, 7, 1, 0));
+    TEST_ASSERT_FALSE(cached(1, 7));
+    TEST_ASSERT_EQUAL_UINT(1, atomic_load(&buf->refs));
+}
+
+void test_zero_frame_count_is_stored_as_single_frame(void)
+{
+    TEST_ASSERT_TRUE(store_audio_packet(4, 50, 0, 0));
+
+    TEST_ASSERT_TRUE(cached(4, 50));
+    TEST_ASSERT_FALSE(cached(4, 51));
+}
+
+void test_cache_eviction_overwrites_oldest_packet(void)
+{
+    for (int i = 0; i < MESH_RETX_CACHE_SLOTS; i++) {
+        store_audio_packet(1, (uint16_t)(i * 2), 2, i * 40000);
+    }
+    TEST_ASSERT_TRUE(cached(1, 0));
+
+    store_audio_packet(1, (uint16_t)(MESH_RETX_CACHE_SLOTS * 2), 2, MESH_RETX_CACHE_SLOTS * 40000);
+
+    TEST_ASSERT_FALSE(cached(1, 0));
+    TEST_ASSERT_FALSE(cached(1, 1));
+    TEST_ASSERT_TRUE(cached(1, 2));
+    TEST_ASSERT_TRUE(cached(1, (uint16_t)(MESH_RETX_CACHE_SLOTS * 2 + 1)));
+}
+
+void test_cache_holds_pool_references_and_releases_on_eviction(void)
+{
+    network_pkt_pool_stats_t pool;
+
+    for (int i = 0; i < MESH_RETX_CACHE_SLOTS; i++) {
+        store_audio_packet(1, (uint16_t)(i * 2), 2, 0);
+    }
+    network_pkt_pool_get_stats(&pool);
+    TEST_ASSERT_EQUAL_UINT32(MESH_RETX_CACHE_SLOTS, pool.in_use);
+
+    store_audio_packet(1, (uint16_t)(MESH_RETX_CACHE_SLOTS * 2), 2, 0);
+    network_pkt_pool_get_stats(&pool);
+    TEST_ASSERT_EQUAL_UINT32(MESH_RETX_CACHE_SLOTS, pool.in_use);
+
+    mesh_retx_cache_reset();
+    network_pkt_pool_get_stats(&pool);
+    TEST_ASSERT_EQUAL_UINT32(0, pool.in_use);
+}
+
+void test_lookup_handles_sequence_wraparound(void)
+{
+    store_audio_packet(3, 0xFFFF, 2, 0);
+
+    TEST_ASSERT_TRUE(cached(3, 0xFFFF));
+    TEST_ASSERT_TRUE(cached(3, 0x0000));
+    TEST_ASSERT_FALSE(cached(3, 0x0001));
+}
+
+void test_deadline_allows_retransmit_inside_playout_budget(void)
+{
+    TEST_ASSERT_TRUE(mesh_retx_deadline_ok(1000000, 1000000 + 50000, 20, 120));
+    TEST_ASSERT_TRUE(mesh_retx_deadline_ok(1000000, 1000000 + 100000, 20, 120));
+}
+
+void test_deadline_rejects_retransmit_that_would_arrive_late(void)
+{
+    TEST_ASSERT_FALSE(mesh_retx_deadline_ok(1000000, 1000000 + 100001, 20, 120));
+    TEST_ASSERT_FALSE(mesh_retx_deadline_ok(1000000, 1000000 + 10000, 200, 120));
+    TEST_ASSERT_FALSE(mesh_retx_deadline_ok(1000000, 999999, 0, 120));
+}
+
+void test_rate_limiter_caps_requests_per_window(void)
+{
+    mesh_retx_rate_limiter_t limiter = {0};
+
+    TEST_ASSERT_TRUE(mesh_retx_rate_allow(&limiter, 1000, 1000, 2));
+    TEST_ASSERT_TRUE(mesh_retx_rate_allow(&limiter, 2000, 1000, 2));
+    TEST_ASSERT_FALSE(mesh_retx_rate_allow(&limiter, 3000, 1000, 2));
+
+    TEST_ASSERT_TRUE(mesh_retx_rate_allow(&limiter, 1001000, 1000, 2));
+    TEST_ASSERT_FALSE(mesh_retx_rate_allow(NULL, 0, 1000, 2));
+}
+
+void test_nack_build_and_expand_roundtrip(void)
+{
+    mesh_nack_t nack;
+    uint16_t seqs[MESH_NACK_MAX_GAP_FRAMES];
+
+    TEST_ASSERT_TRUE(mesh_nack_build(2, 0xFFFE, 4, &nack));
+    TEST_ASSERT_EQUAL_UINT8(NET_PKT_TYPE_NACK, nack.type);
+    TEST_ASSERT_EQUAL_UINT8(2, nack.stream_id);
+
+    size_t count = mesh_nack_expand(&nack, seqs, MESH_NACK_MAX_GAP_FRAMES);
+    TEST_ASSERT_EQUAL_size_t(4, count);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFE, seqs[0]);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, seqs[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x0000, seqs[2]);
+    TEST_ASSERT_EQUAL_UINT16(0x0001, seqs[3]);
+}
+
+void test_nack_build_rejects_oversized_gap(void)
+{
+    mesh_nack_t nack;
+
+    TEST_ASSERT_TRUE(mesh_nack_build(1, 10, MESH_NACK_MAX_GAP_FRAMES, &nack));
+    TEST_ASSERT_FALSE(mesh_nack_build(1, 10, MESH_NACK_MAX_GAP_FRAMES + 1, &nack));
+    TEST_ASSERT_FALSE(mesh_nack_build(1, 10, 0, &nack));
+    TEST_ASSERT_FALSE(mesh_nack_build(1, 10, 1, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_lookup_finds_every_sequence_in_batched_packet);
+    RUN_TEST(test_acquired_buffer_survives_eviction);
+    RUN_TEST(test_store_rejects_invalid_packets);
+    RUN_TEST(test_zero_frame_count_is_stored_as_single_frame);
+    RUN_TEST(test_cache_eviction_overwrites_oldest_packet);
+    RUN_TEST(test_cache_holds_pool_references_and_releases_on_eviction);
+    RUN_TEST(test_lookup_handles_sequence_wraparound);
+    RUN_TEST(test_deadline_allows_retransmit_inside_playout_budget);
+    RUN_TEST(test_deadline_rejects_retransmit_that_would_arrive_late);
+    RUN_TEST(test_rate_limiter_caps_requests_per_window);
+    RUN_TEST(test_nack_build_and_expand_roundtrip);
+    RUN_TEST(test_nack_build_rejects_oversized_gap);
+    return UNITY_END();
+}
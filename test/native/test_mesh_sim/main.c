@@ -0,0 +1,175 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "mesh_sim.h"
+
+#include "mesh/mesh_fanout.h"
+
+static mesh_sim_result_t result;
+
+static void run(const mesh_sim_config_t *cfg)
+{
+    TEST_ASSERT_TRUE(mesh_sim_run(cfg, &result));
+    mesh_sim_print(cfg, &result);
+    TEST_ASSERT_TRUE(result.frames_sent > 0);
+}
+
+void setUp(void)
+{
+    memset(&result, 0, sizeof(result));
+}
+
+void tearDown(void)
+{
+}
+
+void test_star_delivers_every_frame_without_loss(void)
+{
+    mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+    cfg.node_count = 6;
+    cfg.branching = 5;
+    run(&cfg);
+
+    TEST_ASSERT_EQUAL(1, result.depth);
+    TEST_ASSERT_EQUAL_UINT32(cfg.audio_ms / AUDIO_FRAME_EFFECTIVE_MS, result.frames_sent);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, result.delivery_min);
+    TEST_ASSERT_EQUAL_UINT32(0, result.hops_lost);
+    TEST_ASSERT_EQUAL_UINT32(0, result.root_retransmits);
+    TEST_ASSERT_EQUAL(MESH_FANOUT_P2P, result.root_fanout_mode);
+    for (int i = 1; i < result.node_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, result.nodes[i].duplicates);
+        TEST_ASSERT_EQUAL_UINT32(0, result.nodes[i].nacks_sent);
+    }
+    // One hop: airtime + hop delay, plus queueing behind the other children.
+    TEST_ASSERT_TRUE(result.latency_max_us < 10000);
+}
+
+void test_deep_tree_heartbeats_reach_root_through_relays(void)
+{
+    mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+    cfg.node_count = 15;
+    cfg.branching = 2;
+    run(&cfg);
+
+    TEST_ASSERT_EQUAL(3, result.depth);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, result.delivery_min);
+    // Layer 3+ heartbeats ride in their parents' bundles; the root still learns
+    // every node.
+    TEST_ASSERT_EQUAL_UINT32(cfg.node_count - 1, result.root_links);
+    TEST_ASSERT_TRUE(result.root_heartbeats >= (cfg.node_count - 1) * (cfg.audio_ms / 6000));
+
+    uint32_t layer2_p50 = result.nodes[1].latency_p50_us;
+    uint32_t layer4_p50 = result.nodes[cfg.node_count - 1].latency_p50_us;
+    TEST_ASSERT_EQUAL(4, result.nodes[cfg.node_count - 1].layer);
+    TEST_ASSERT_TRUE(layer4_p50 > layer2_p50 + 2 * cfg.hop_delay_us);
+}
+
+void test_large_mesh_switches_to_group_fanout(void)
+{
+    mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+    cfg.node_count = 21;
+    cfg.branching = 4;
+    run(&cfg);
+
+    TEST_ASSERT_EQUAL(MESH_FANOUT_GROUP, result.root_fanout_mode);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, result.delivery_min);
+    for (int i = 1; i < result.node_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, result.nodes[i].duplicates);
+    }
+}
+
+void test_residual_loss_is_repaired_by_nack_retransmit(void)
+{
+    mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+    cfg.node_count = 6;
+    cfg.branching = 5;
+    cfg.hop_loss = 0.04f;
+    cfg.mac_retries = 0;
+    run(&cfg);
+
+    TEST_ASSERT_TRUE(result.hops_lost > 0);
+    TEST_ASSERT_TRUE(result.root_retransmits > 0);
+    uint32_t nacks = 0;
+    for (int i = 1; i < result.node_count; i++) {
+        nacks += result.nodes[i].nacks_sent;
+    }
+    TEST_ASSERT_TRUE(nacks > 0);
+    // Better than the raw per-hop loss would allow.
+    TEST_ASSERT_TRUE(result.delivery_mean > 1.0f - cfg.hop_loss / 2);
+}
+
+void test_mixer_edit_replicates_to_every_node(void)
+{
+    mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+    cfg.node_count = 13;
+    cfg.branching = 3;
+    cfg.audio_ms = 4000;
+    cfg.mixer_change_at_ms = 3000;
+    run(&cfg);
+
+    for (int i = 0; i < result.node_count; i++) {
+        TEST_ASSERT_TRUE(result.nodes[i].mixer_synced);
+        TEST_ASSERT_EQUAL_UINT16(cfg.mixer_gain_pct, result.nodes[i].mixer_gain_pct);
+        TEST_ASSERT_TRUE(result.nodes[i].mixer_sync_ms <= MIXER_PUBLISH_COALESCE_MS + 2 * CONTROL_COALESCE_TICK_MS + 20);
+    }
+}
+
+void test_same_seed_is_deterministic(void)
+{
+    mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+    cfg.node_count = 10;
+    cfg.hop_loss = 0.1f;
+    cfg.audio_ms = 3000;
+    run(&cfg);
+    mesh_sim_result_t first = result;
+
+    run(&cfg);
+    TEST_ASSERT_EQUAL_UINT32(first.frames_sent, result.frames_sent);
+    TEST_ASSERT_EQUAL_UINT32(first.transmissions, result.transmissions);
+    TEST_ASSERT_EQUAL_UINT32(first.latency_p95_us, result.latency_p95_us);
+    TEST_ASSERT_EQUAL_UINT64(first.airtime_us, result.airtime_us);
+    for (int i = 1; i < result.node_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(first.nodes[i].frames_received, result.nodes[i].frames_received);
+    }
+}
+
+// Scaling sweep: airtime and tail latency as node count and depth grow.
+void test_airtime_and_latency_scale_with_size_and_depth(void)
+{
+    static const struct {
+        uint16_t nodes;
+        uint8_t branching;
+    } sweep[] = {
+        {4, 3}, {10, 3}, {22, 3}, {40, 3}, {40, 2},
+    };
+    uint64_t prev_airtime = 0;
+
+    for (size_t i = 0; i < sizeof(sweep) / sizeof(sweep[0]); i++) {
+        mesh_sim_config_t cfg = MESH_SIM_CONFIG_DEFAULT();
+        cfg.node_count = sweep[i].nodes;
+        cfg.branching = sweep[i].branching;
+        cfg.audio_ms = 5000;
+        run(&cfg);
+
+        TEST_ASSERT_TRUE(result.channel_utilization < 1.0f);
+        TEST_ASSERT_TRUE(result.delivery_min > 0.99f);
+        if (i < 4) {
+            TEST_ASSERT_TRUE(result.airtime_us > prev_airtime);
+            prev_airtime = result.airtime_us;
+        }
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_star_delivers_every_frame_without_loss);
+    RUN_TEST(test_deep_tree_heartbeats_reach_root_through_relays);
+    RUN_TEST(test_large_mesh_switches_to_group_fanout);
+    RUN_TEST(test_residual_loss_is_repaired_by_nack_retransmit);
+    RUN_TEST(test_mixer_edit_replicates_to_every_node);
+    RUN_TEST(test_same_seed_is_deterministic);
+    RUN_TEST(test_airtime_and_latency_scale_with_size_and_depth);
+    return UNITY_END();
+}
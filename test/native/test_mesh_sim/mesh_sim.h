@@ -0,0 +1,166 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Host mesh simulator: N virtual nodes, each a forked process with its own copy
+// of the mesh state, running the real RX dispatch, dedupe, heartbeat/ping,
+// control coalescing, mixer replication, fanout and retransmit code. Their
+// esp_mesh_send calls are routed through a simulated ESP-WIFI-MESH tree by the
+// coordinator, which advances a shared simulated clock in lockstep.
+//
+// Medium model: one channel shared by every node. Each hop is a unicast frame
+// that waits for the channel (FIFO), occupies it for overhead + bytes/rate per
+// attempt, is lost per attempt with hop_loss and retried up to mac_retries
+// times. Group traffic is forwarded parent -> child over every tree edge that
+// leads to members (as ESP-WIFI-MESH does), or as one link broadcast per parent
+// with group_link_broadcast. A node whose TX queue holds queue_limit frames
+// rejects local sends with ESP_ERR_MESH_QUEUE_FULL and drops forwarded ones.
+
+#define MESH_SIM_MAX_NODES MESH_ROUTE_TABLE_SIZE
+
+typedef struct {
+    uint32_t seed;
+    uint16_t node_count;        // Including the root (SRC, node 0)
+    uint8_t branching;          // Children per node, filled breadth-first
+    uint32_t audio_ms;          // Audio runs this long, then the mesh drains
+    uint32_t hop_delay_us;      // Per-hop processing/forwarding delay
+    float hop_loss;             // Per attempt, independent
+    uint8_t mac_retries;
+    uint32_t phy_rate_kbps;
+    uint32_t frame_overhead_us; // Preamble, IFS, backoff and ACK per attempt
+    uint16_t mesh_header_bytes;
+    uint16_t queue_limit;
+    bool group_link_broadcast;
+    uint16_t opus_frame_bytes;
+    uint32_t mixer_change_at_ms; // 0 = no mixer edit
+    uint16_t mixer_gain_pct;
+} mesh_sim_config_t;
+
+#define MESH_SIM_CONFIG_DEFAULT() {         \
+    .seed = 1,                              \
+    .node_count = 8,                        \
+    .branching = 3,                         \
+    .audio_ms = 10000,                      \
+    .hop_delay_us = 1500,                   \
+    .hop_loss = 0.0f,                       \
+    .mac_retries = 3,                       \
+    .phy_rate_kbps = 24000,                 \
+    .frame_overhead_us = 160,               \
+    .mesh_header_bytes = 48,                \
+    .queue_limit = 32,                      \
+    .group_link_broadcast = false,          \
+    .opus_frame_bytes = OPUS_BITRATE / 8 * AUDIO_FRAME_EFFECTIVE_MS / 1000, \
+    .mixer_change_at_ms = 0,                \
+    .mixer_gain_pct = 73,                   \
+}
+
+typedef struct {
+    uint8_t layer;
+    uint32_t frames_received;   // Unique frames handed to the audio callback
+    float delivery;             // frames_received / frames_sent
+    uint32_t latency_p50_us;
+    uint32_t latency_p95_us;
+    uint32_t latency_max_us;
+    uint32_t duplicates;
+    uint32_t nacks_sent;
+    bool mixer_synced;
+    uint32_t mixer_sync_ms;     // After the edit reached the root
+    uint16_t mixer_gain_pct;
+} mesh_sim_node_result_t;
+
+typedef struct {
+    uint16_t node_count;
+    uint8_t depth;              // Deepest layer below the root
+    uint32_t frames_sent;
+    float delivery_min;
+    float delivery_mean;
+    uint32_t latency_p50_us;
+    uint32_t latency_p95_us;
+    uint32_t latency_p99_us;
+    uint32_t latency_max_us;
+    uint64_t airtime_us;
+    uint64_t audio_airtime_us;
+    uint64_t control_airtime_us;
+    float channel_utilization;  // Airtime over the simulated run
+    uint32_t transmissions;     // Attempts, retries included
+    uint32_t hops_lost;         // Hops that exhausted their retries
+    uint32_t queue_drops;       // Local QUEUE_FULL plus forwarded drops
+    uint32_t root_heartbeats;
+    uint32_t root_links;        // Root link-table entries at the end
+    uint32_t root_retransmits;
+    uint8_t root_fanout_mode;   // mesh_fanout_mode_t
+    uint32_t root_fanout_switches;
+    mesh_sim_node_result_t nodes[MESH_SIM_MAX_NODES];
+} mesh_sim_result_t;
+
+// Runs one scenario to completion. False when the node processes could not be
+// started or a node stopped responding.
+bool mesh_sim_run(const mesh_sim_config_t *cfg, mesh_sim_result_t *out);
+void mesh_sim_print(const mesh_sim_config_t *cfg, const mesh_sim_result_t *res);
+
+// Coordinator <-> node protocol, length-prefixed over a stream socketpair.
+typedef enum {
+    MESH_SIM_CMD_WAKE = 1,      // Run due timers, heartbeat tick, audio producer
+    MESH_SIM_CMD_DELIVER,       // mesh_rx_dispatch(addr, data)
+    MESH_SIM_CMD_SET_GAIN,      // network_set_mixer_config(arg)
+    MESH_SIM_CMD_REPORT,
+    MESH_SIM_CMD_EXIT,
+    MESH_SIM_REC_SEND,          // esp_mesh_send; the node waits for MESH_SIM_STATUS
+    MESH_SIM_STATUS,
+    MESH_SIM_REC_AUDIO_TX,      // arg = first seq, flag = frame count
+    MESH_SIM_REC_AUDIO_RX,      // arg = frame seq
+    MESH_SIM_REC_MIXER,         // arg = applied gain
+    MESH_SIM_REC_REPORT,        // data = mesh_sim_node_report_t
+    MESH_SIM_REC_DONE,          // time_us = next wake
+} mesh_sim_msg_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t has_addr;
+    uint16_t len;
+    int32_t flag;               // esp_mesh_send flags, or the reply status
+    int32_t arg;
+    int64_t time_us;
+    uint8_t addr[6];
+    uint8_t data[MESH_RX_BUFFER_SIZE];
+} mesh_sim_msg_t;
+
+#define MESH_SIM_MSG_HEADER_SIZE offsetof(mesh_sim_msg_t, data)
+
+typedef struct {
+    uint32_t rx_duplicates;
+    uint32_t tx_nacks;
+    uint32_t rx_heartbeats;
+    uint32_t tx_retransmits;
+    uint32_t link_count;
+    uint8_t fanout_mode;
+    uint32_t fanout_switches;
+    uint16_t mixer_gain_pct;
+} mesh_sim_node_report_t;
+
+// Everything a node needs before its first command; inherited across fork().
+typedef struct {
+    uint8_t index;
+    uint8_t layer;
+    uint8_t mac[6];
+    uint8_t parent_mac[6];
+    uint8_t root_mac[6];
+    uint8_t route[MESH_SIM_MAX_NODES][6];   // Self first, then descendants
+    int route_count;
+    int children;
+    uint32_t seed;
+    uint16_t opus_frame_bytes;
+    int64_t start_us;           // First heartbeat tick
+    int64_t audio_start_us;
+    int64_t audio_end_us;
+} mesh_sim_node_init_t;
+
+// Node process body: serves commands on fd until EXIT or EOF, then _exit()s.
+void mesh_sim_node_main(int fd, const mesh_sim_node_init_t *init);
+
+bool mesh_sim_write_msg(int fd, const mesh_sim_msg_t *msg);
+bool mesh_sim_read_msg(int fd, mesh_sim_msg_t *msg);
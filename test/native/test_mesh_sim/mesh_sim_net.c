@@ -0,0 +1,779 @@
+// Coordinator: tree topology, shared-channel medium and the lockstep event loop
+// that drives the node processes (mesh_sim_node.c).
+
+#include "mesh_sim.h"
+
+#include "mesh/mesh_fanout.h"
+#include "network/frame_codec.h"
+
+#include <esp_err.h>
+#include <esp_mesh.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define SIM_TX_QUEUE_MAX 256
+#define SIM_SEQ_SPACE 65536
+#define SIM_STARTUP_SPREAD_MS 1000
+#define SIM_AUDIO_START_MS 1500
+#define SIM_DRAIN_MS 1000
+
+typedef struct {
+    uint32_t refs;              // Hop events still carrying it
+    uint8_t src;
+    bool audio;
+    uint16_t len;
+    uint8_t data[];
+} sim_packet_t;
+
+typedef struct {
+    int64_t at_us;
+    uint32_t order;             // Tie-break: scheduling order
+    uint8_t node;               // Receiver of this hop
+    uint8_t dst;                // Final node (unicast)
+    bool group;
+    sim_packet_t *pkt;
+} sim_event_t;
+
+typedef struct {
+    int fd;
+    pid_t pid;
+    int parent;
+    uint8_t layer;
+    int64_t wake_us;
+    int64_t tx_end_us[SIM_TX_QUEUE_MAX];    // Frames queued or on air, by end time
+    int tx_count;
+    uint8_t seen[SIM_SEQ_SPACE / 8];
+    uint32_t frames_received;
+    uint32_t *latency_us;
+    uint32_t latency_count;
+    bool mixer_synced;
+    int64_t mixer_us;
+    mesh_sim_node_report_t report;
+} sim_node_t;
+
+typedef struct {
+    const mesh_sim_config_t *cfg;
+    int n;
+    sim_node_t *nodes;
+    int64_t now_us;
+    int64_t medium_free_us;
+    uint32_t rng;
+
+    sim_event_t *events;
+    size_t event_count;
+    size_t event_cap;
+    uint32_t next_order;
+
+    int64_t *frame_tx_us;       // Send time by seq, -1 = not sent
+    uint32_t frames_sent;
+    uint32_t frame_cap;
+
+    int64_t mixer_edit_us;
+    bool mixer_edit_pending;
+
+    uint64_t audio_airtime_us;
+    uint64_t control_airtime_us;
+    uint32_t transmissions;
+    uint32_t hops_lost;
+    uint32_t queue_drops;
+
+    mesh_sim_msg_t cmd;
+    mesh_sim_msg_t rec;
+} sim_t;
+
+// --- Framing ---
+
+static bool sim_io(int fd, void *buf, size_t len, bool writing)
+{
+    uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = writing ? write(fd, p, len) : read(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+bool mesh_sim_write_msg(int fd, const mesh_sim_msg_t *msg)
+{
+    if (msg->len > sizeof(msg->data)) {
+        return false;
+    }
+    return sim_io(fd, (void *)msg, MESH_SIM_MSG_HEADER_SIZE + msg->len, true);
+}
+
+bool mesh_sim_read_msg(int fd, mesh_sim_msg_t *msg)
+{
+    if (!sim_io(fd, msg, MESH_SIM_MSG_HEADER_SIZE, false) || msg->len > sizeof(msg->data)) {
+        return false;
+    }
+    return sim_io(fd, msg->data, msg->len, false);
+}
+
+// --- Topology ---
+
+static void sim_node_mac(int index, uint8_t mac[6])
+{
+    const uint8_t base[6] = {0x02, 'S', 'I', 'M', 0x00, 0x00};
+    memcpy(mac, base, 6);
+    mac[5] = (uint8_t)index;
+}
+
+static int sim_node_by_mac(const sim_t *sim, const uint8_t mac[6])
+{
+    uint8_t expect[6];
+    sim_node_mac(mac[5], expect);
+    if (memcmp(mac, expect, 6) != 0 || mac[5] >= sim->n) {
+        return -1;
+    }
+    return mac[5];
+}
+
+static bool sim_is_ancestor(const sim_t *sim, int ancestor, int node)
+{
+    for (int cur = node; cur >= 0; cur = sim->nodes[cur].parent) {
+        if (cur == ancestor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tree routing: down towards dst when it is below cur, otherwise up.
+static int sim_next_hop(const sim_t *sim, int cur, int dst)
+{
+    if (!sim_is_ancestor(sim, cur, dst)) {
+        return sim->nodes[cur].parent;
+    }
+    int hop = dst;
+    while (sim->nodes[hop].parent != cur) {
+        hop = sim->nodes[hop].parent;
+    }
+    return hop;
+}
+
+// --- Events ---
+
+static uint32_t sim_rand(sim_t *sim)
+{
+    sim->rng ^= sim->rng << 13;
+    sim->rng ^= sim->rng >> 17;
+    sim->rng ^= sim->rng << 5;
+    return sim->rng;
+}
+
+static bool sim_chance(sim_t *sim, float p)
+{
+    return p > 0.0f && (float)(sim_rand(sim) >> 8) / (float)(1u << 24) < p;
+}
+
+static bool sim_event_before(const sim_event_t *a, const sim_event_t *b)
+{
+    return a->at_us < b->at_us || (a->at_us == b->at_us && a->order < b->order);
+}
+
+static void sim_event_push(sim_t *sim, sim_event_t ev)
+{
+    if (sim->event_count == sim->event_cap) {
+        sim->event_cap = sim->event_cap ? sim->event_cap * 2 : 256;
+        sim->events = realloc(sim->events, sim->event_cap * sizeof(*sim->events));
+    }
+    ev.order = sim->next_order++;
+    ev.pkt->refs++;
+    size_t i = sim->event_count++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!sim_event_before(&ev, &sim->events[parent])) {
+            break;
+        }
+        sim->events[i] = sim->events[parent];
+        i = parent;
+    }
+    sim->events[i] = ev;
+}
+
+static sim_event_t sim_event_pop(sim_t *sim)
+{
+    sim_event_t top = sim->events[0];
+    sim_event_t last = sim->events[--sim->event_count];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= sim->event_count) {
+            break;
+        }
+        if (child + 1 < sim->event_count && sim_event_before(&sim->events[child + 1], &sim->events[child])) {
+            child++;
+        }
+        if (!sim_event_before(&sim->events[child], &last)) {
+            break;
+        }
+        sim->events[i] = sim->events[child];
+        i = child;
+    }
+    if (sim->event_count > 0) {
+        sim->events[i] = last;
+    }
+    return top;
+}
+
+static void sim_packet_release(sim_packet_t *pkt)
+{
+    if (pkt->refs == 0) {
+        free(pkt);
+    }
+}
+
+// --- Medium ---
+
+static bool sim_queue_full(sim_t *sim, int node)
+{
+    sim_node_t *n = &sim->nodes[node];
+    int kept = 0;
+    for (int i = 0; i < n->tx_count; i++) {
+        if (n->tx_end_us[i] > sim->now_us) {
+            n->tx_end_us[kept++] = n->tx_end_us[i];
+        }
+    }
+    n->tx_count = kept;
+    return n->tx_count >= sim->cfg->queue_limit || n->tx_count >= SIM_TX_QUEUE_MAX;
+}
+
+static int64_t sim_airtime_us(const sim_t *sim, const sim_packet_t *pkt)
+{
+    uint32_t bits = (uint32_t)(pkt->len + sim->cfg->mesh_header_bytes) * 8;
+    return (int64_t)sim->cfg->frame_overhead_us + (int64_t)bits * 1000 / sim->cfg->phy_rate_kbps;
+}
+
+// Occupies the channel from the first moment it is free, attempt by attempt.
+// Returns the end of the last attempt.
+static int64_t sim_occupy(sim_t *sim, int from, const sim_packet_t *pkt, int attempts)
+{
+    int64_t start = sim->now_us > sim->medium_free_us ? sim->now_us : sim->medium_free_us;
+    int64_t end = start + sim_airtime_us(sim, pkt) * attempts;
+    sim->medium_free_us = end;
+    sim->transmissions += (uint32_t)attempts;
+    if (pkt->audio) {
+        sim->audio_airtime_us += (uint64_t)(end - start);
+    } else {
+        sim->control_airtime_us += (uint64_t)(end - start);
+    }
+    sim_node_t *n = &sim->nodes[from];
+    if (n->tx_count < SIM_TX_QUEUE_MAX) {
+        n->tx_end_us[n->tx_count++] = end;
+    }
+    return end;
+}
+
+static void sim_unicast(sim_t *sim, int from, int to, int dst, bool group, sim_packet_t *pkt)
+{
+    int attempts = 0;
+    bool delivered = false;
+    while (attempts <= sim->cfg->mac_retries && !delivered) {
+        attempts++;
+        delivered = !sim_chance(sim, sim->cfg->hop_loss);
+    }
+    int64_t end = sim_occupy(sim, from, pkt, attempts);
+    if (!delivered) {
+        sim->hops_lost++;
+        return;
+    }
+    sim_event_push(sim, (sim_event_t){
+        .at_us = end + sim->cfg->hop_delay_us,
+        .node = (uint8_t)to,
+        .dst = (uint8_t)dst,
+        .group = group,
+        .pkt = pkt,
+    });
+}
+
+// Group data leaves a node once per child, or once in total as a link broadcast
+// (no ACK, so no retries; each child hears it independently).
+static void sim_forward_group(sim_t *sim, int from, sim_packet_t *pkt)
+{
+    if (sim->cfg->group_link_broadcast) {
+        bool any_child = false;
+        for (int c = 0; c < sim->n; c++) {
+            any_child = any_child || sim->nodes[c].parent == from;
+        }
+        if (!any_child) {
+            return;
+        }
+        if (sim_queue_full(sim, from)) {
+            sim->queue_drops++;
+            return;
+        }
+        int64_t end = sim_occupy(sim, from, pkt, 1);
+        for (int c = 0; c < sim->n; c++) {
+            if (sim->nodes[c].parent != from) {
+                continue;
+            }
+            if (sim_chance(sim, sim->cfg->hop_loss)) {
+                sim->hops_lost++;
+                continue;
+            }
+            sim_event_push(sim, (sim_event_t){
+                .at_us = end + sim->cfg->hop_delay_us,
+                .node = (uint8_t)c,
+                .group = true,
+                .pkt = pkt,
+            });
+        }
+        return;
+    }
+    for (int c = 0; c < sim->n; c++) {
+        if (sim->nodes[c].parent != from) {
+            continue;
+        }
+        if (sim_queue_full(sim, from)) {
+            sim->queue_drops++;
+            continue;
+        }
+        sim_unicast(sim, from, c, c, true, pkt);
+    }
+}
+
+// esp_mesh_send from node src, as the mesh stack would accept or reject it.
+static esp_err_t sim_route_send(sim_t *sim, int src, const mesh_sim_msg_t *msg)
+{
+    static const uint8_t broadcast[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    bool group = (msg->flag & MESH_DATA_GROUP) != 0;
+    int dst = 0;
+
+    if (!group && msg->has_addr) {
+        dst = sim_node_by_mac(sim, msg->addr);
+        if (dst < 0) {
+            return memcmp(msg->addr, broadcast, 6) == 0 ? ESP_ERR_INVALID_ARG : ESP_ERR_MESH_NO_ROUTE_FOUND;
+        }
+    }
+    if (!group && dst == src) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (sim_queue_full(sim, src)) {
+        sim->queue_drops++;
+        return ESP_ERR_MESH_QUEUE_FULL;
+    }
+
+    sim_packet_t *pkt = malloc(sizeof(*pkt) + msg->len);
+    pkt->refs = 0;
+    pkt->src = (uint8_t)src;
+    pkt->audio = msg->len > 0 && msg->data[0] == NET_FRAME_MAGIC;
+    pkt->len = msg->len;
+    memcpy(pkt->data, msg->data, msg->len);
+
+    if (group) {
+        sim_forward_group(sim, src, pkt);
+    } else {
+        sim_unicast(sim, src, sim_next_hop(sim, src, dst), dst, false, pkt);
+    }
+    sim_packet_release(pkt);
+    return ESP_OK;
+}
+
+// --- Node commands ---
+
+static void sim_record_audio_rx(sim_t *sim, int node, uint16_t seq)
+{
+    sim_node_t *n = &sim->nodes[node];
+    if (sim->frame_tx_us[seq] < 0 || (n->seen[seq / 8] & (1u << (seq % 8)))) {
+        return;
+    }
+    n->seen[seq / 8] |= (uint8_t)(1u << (seq % 8));
+    n->frames_received++;
+    if (n->latency_count < sim->frame_cap) {
+        n->latency_us[n->latency_count++] = (uint32_t)(sim->now_us - sim->frame_tx_us[seq]);
+    }
+}
+
+static bool sim_command(sim_t *sim, int node, uint8_t type, int32_t arg, const sim_packet_t *pkt)
+{
+    sim_node_t *n = &sim->nodes[node];
+    mesh_sim_msg_t *cmd = &sim->cmd;
+    mesh_sim_msg_t *rec = &sim->rec;
+
+    cmd->type = type;
+    cmd->arg = arg;
+    cmd->time_us = sim->now_us;
+    cmd->has_addr = pkt ? 1 : 0;
+    cmd->len = pkt ? pkt->len : 0;
+    if (pkt) {
+        sim_node_mac(pkt->src, cmd->addr);
+        memcpy(cmd->data, pkt->data, pkt->len);
+    }
+    if (!mesh_sim_write_msg(n->fd, cmd)) {
+        return false;
+    }
+
+    while (mesh_sim_read_msg(n->fd, rec)) {
+        switch (rec->type) {
+            case MESH_SIM_REC_SEND:
+                cmd->type = MESH_SIM_STATUS;
+                cmd->len = 0;
+                cmd->flag = sim_route_send(sim, node, rec);
+                if (!mesh_sim_write_msg(n->fd, cmd)) {
+                    return false;
+                }
+                break;
+            case MESH_SIM_REC_AUDIO_TX:
+                for (int32_t f = 0; f < rec->flag; f++) {
+                    uint16_t seq = (uint16_t)(rec->arg + f);
+                    if (sim->frame_tx_us[seq] < 0 && sim->frames_sent < sim->frame_cap) {
+                        sim->frame_tx_us[seq] = sim->now_us;
+                        sim->frames_sent++;
+                    }
+                }
+                break;
+            case MESH_SIM_REC_AUDIO_RX:
+                sim_record_audio_rx(sim, node, (uint16_t)rec->arg);
+                break;
+            case MESH_SIM_REC_MIXER:
+                if (!n->mixer_synced && rec->arg == sim->cfg->mixer_gain_pct) {
+                    n->mixer_synced = true;
+                    n->mixer_us = sim->now_us;
+                }
+                break;
+            case MESH_SIM_REC_REPORT:
+                memcpy(&n->report, rec->data, sizeof(n->report));
+                break;
+            case MESH_SIM_REC_DONE:
+                n->wake_us = rec->time_us > sim->now_us ? rec->time_us : sim->now_us + 1;
+                return true;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+static bool sim_handle_event(sim_t *sim, const sim_event_t *ev)
+{
+    int node = ev->node;
+    bool ok = true;
+
+    if (ev->group) {
+        sim_forward_group(sim, node, ev->pkt);
+        ok = sim_command(sim, node, MESH_SIM_CMD_DELIVER, 0, ev->pkt);
+    } else if (node == ev->dst) {
+        ok = sim_command(sim, node, MESH_SIM_CMD_DELIVER, 0, ev->pkt);
+    } else if (sim_queue_full(sim, node)) {
+        sim->queue_drops++;
+    } else {
+        sim_unicast(sim, node, sim_next_hop(sim, node, ev->dst), ev->dst, false, ev->pkt);
+    }
+    ev->pkt->refs--;
+    sim_packet_release(ev->pkt);
+    return ok;
+}
+
+// --- Run ---
+
+static bool sim_spawn(sim_t *sim, mesh_sim_node_init_t *init)
+{
+    const mesh_sim_config_t *cfg = sim->cfg;
+    uint8_t root_mac[6];
+    sim_node_mac(0, root_mac);
+
+    for (int i = 0; i < sim->n; i++) {
+        sim_node_t *n = &sim->nodes[i];
+        memset(init, 0, sizeof(*init));
+        init->index = (uint8_t)i;
+        init->layer = n->layer;
+        sim_node_mac(i, init->mac);
+        if (n->parent >= 0) {
+            sim_node_mac(n->parent, init->parent_mac);
+        }
+        memcpy(init->root_mac, root_mac, 6);
+        for (int d = 0; d < sim->n; d++) {
+            if (sim_is_ancestor(sim, i, d)) {
+                sim_node_mac(d, init->route[init->route_count++]);
+            }
+            if (sim->nodes[d].parent == i) {
+                init->children++;
+            }
+        }
+        init->seed = cfg->seed;
+        init->opus_frame_bytes = cfg->opus_frame_bytes;
+        init->start_us = (int64_t)(sim_rand(sim) % SIM_STARTUP_SPREAD_MS) * 1000;
+        init->audio_start_us = (int64_t)SIM_AUDIO_START_MS * 1000;
+        init->audio_end_us = init->audio_start_us + (int64_t)cfg->audio_ms * 1000;
+        n->wake_us = init->start_us;
+
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+            return false;
+        }
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(sv[0]);
+            close(sv[1]);
+            return false;
+        }
+        if (pid == 0) {
+            close(sv[0]);
+            for (int j = 0; j < i; j++) {
+                close(sim->nodes[j].fd);
+            }
+            mesh_sim_node_main(sv[1], init);
+        }
+        close(sv[1]);
+        n->fd = sv[0];
+        n->pid = pid;
+    }
+    return true;
+}
+
+static bool sim_loop(sim_t *sim)
+{
+    int64_t end_us = (int64_t)(SIM_AUDIO_START_MS + sim->cfg->audio_ms + SIM_DRAIN_MS) * 1000;
+
+    for (;;) {
+        int64_t next_us = sim->event_count > 0 ? sim->events[0].at_us : INT64_MAX;
+        int wake = -1;
+        for (int i = 0; i < sim->n; i++) {
+            if (sim->nodes[i].wake_us < next_us) {
+                next_us = sim->nodes[i].wake_us;
+                wake = i;
+            }
+        }
+        bool mixer = sim->mixer_edit_pending && sim->mixer_edit_us < next_us;
+        if (mixer) {
+            next_us = sim->mixer_edit_us;
+        }
+        if (next_us > end_us) {
+            return true;
+        }
+        sim->now_us = next_us;
+
+        bool ok;
+        if (mixer) {
+            sim->mixer_edit_pending = false;
+            ok = sim_command(sim, 0, MESH_SIM_CMD_SET_GAIN, sim->cfg->mixer_gain_pct, NULL);
+        } else if (wake >= 0) {
+            ok = sim_command(sim, wake, MESH_SIM_CMD_WAKE, 0, NULL);
+        } else {
+            sim_event_t ev = sim_event_pop(sim);
+            ok = sim_handle_event(sim, &ev);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+}
+
+static int sim_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t sim_quantile(const uint32_t *sorted, size_t count, unsigned pct)
+{
+    if (count == 0) {
+        return 0;
+    }
+    size_t idx = (count - 1) * pct / 100;
+    return sorted[idx];
+}
+
+static void sim_collect(sim_t *sim, mesh_sim_result_t *out)
+{
+    const mesh_sim_config_t *cfg = sim->cfg;
+    size_t total = 0;
+    for (int i = 1; i < sim->n; i++) {
+        total += sim->nodes[i].latency_count;
+    }
+    uint32_t *all = malloc((total + 1) * sizeof(uint32_t));
+    size_t all_count = 0;
+
+    memset(out, 0, sizeof(*out));
+    out->node_count = (uint16_t)sim->n;
+    out->frames_sent = sim->frames_sent;
+    out->delivery_min = sim->n > 1 ? 1.0f : 0.0f;
+
+    for (int i = 0; i < sim->n; i++) {
+        sim_node_t *n = &sim->nodes[i];
+        mesh_sim_node_result_t *r = &out->nodes[i];
+        r->layer = n->layer;
+        if (n->layer - 1 > out->depth) {
+            out->depth = (uint8_t)(n->layer - 1);
+        }
+        r->duplicates = n->report.rx_duplicates;
+        r->nacks_sent = n->report.tx_nacks;
+        r->mixer_gain_pct = n->report.mixer_gain_pct;
+        r->mixer_synced = n->mixer_synced;
+        if (n->mixer_synced && cfg->mixer_change_at_ms > 0) {
+            r->mixer_sync_ms = (uint32_t)((n->mixer_us - sim->mixer_edit_us) / 1000);
+        }
+        if (i == 0) {
+            continue;
+        }
+        r->frames_received = n->frames_received;
+        r->delivery = sim->frames_sent ? (float)n->frames_received / (float)sim->frames_sent : 0.0f;
+        if (r->delivery < out->delivery_min) {
+            out->delivery_min = r->delivery;
+        }
+        out->delivery_mean += r->delivery / (float)(sim->n - 1);
+
+        memcpy(&all[all_count], n->latency_us, n->latency_count * sizeof(uint32_t));
+        all_count += n->latency_count;
+        qsort(n->latency_us, n->latency_count, sizeof(uint32_t), sim_cmp_u32);
+        r->latency_p50_us = sim_quantile(n->latency_us, n->latency_count, 50);
+        r->latency_p95_us = sim_quantile(n->latency_us, n->latency_count, 95);
+        r->latency_max_us = sim_quantile(n->latency_us, n->latency_count, 100);
+    }
+
+    qsort(all, all_count, sizeof(uint32_t), sim_cmp_u32);
+    out->latency_p50_us = sim_quantile(all, all_count, 50);
+    out->latency_p95_us = sim_quantile(all, all_count, 95);
+    out->latency_p99_us = sim_quantile(all, all_count, 99);
+    out->latency_max_us = sim_quantile(all, all_count, 100);
+    free(all);
+
+    out->audio_airtime_us = sim->audio_airtime_us;
+    out->control_airtime_us = sim->control_airtime_us;
+    out->airtime_us = sim->audio_airtime_us + sim->control_airtime_us;
+    out->channel_utilization = sim->now_us > 0 ? (float)out->airtime_us / (float)sim->now_us : 0.0f;
+    out->transmissions = sim->transmissions;
+    out->hops_lost = sim->hops_lost;
+    out->queue_drops = sim->queue_drops;
+
+    const mesh_sim_node_report_t *root = &sim->nodes[0].report;
+    out->root_heartbeats = root->rx_heartbeats;
+    out->root_links = root->link_count;
+    out->root_retransmits = root->tx_retransmits;
+    out->root_fanout_mode = root->fanout_mode;
+    out->root_fanout_switches = root->fanout_switches;
+}
+
+static void sim_shutdown(sim_t *sim)
+{
+    for (int i = 0; i < sim->n; i++) {
+        sim_node_t *n = &sim->nodes[i];
+        if (n->pid <= 0) {
+            continue;
+        }
+        sim->cmd.type = MESH_SIM_CMD_EXIT;
+        sim->cmd.len = 0;
+        mesh_sim_write_msg(n->fd, &sim->cmd);
+        close(n->fd);
+        int status;
+        waitpid(n->pid, &status, 0);
+        n->pid = 0;
+    }
+}
+
+bool mesh_sim_run(const mesh_sim_config_t *cfg, mesh_sim_result_t *out)
+{
+    if (!cfg || !out || cfg->node_count < 1 || cfg->node_count > MESH_SIM_MAX_NODES ||
+        cfg->branching == 0 || cfg->phy_rate_kbps == 0) {
+        return false;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    sim_t *sim = calloc(1, sizeof(*sim));
+    mesh_sim_node_init_t *init = malloc(sizeof(*init));
+    sim->cfg = cfg;
+    sim->n = cfg->node_count;
+    sim->nodes = calloc((size_t)sim->n, sizeof(sim_node_t));
+    sim->rng = cfg->seed ? cfg->seed : 1;
+    sim->frame_cap = cfg->audio_ms / AUDIO_FRAME_EFFECTIVE_MS + MESH_FRAMES_PER_PACKET;
+    if (sim->frame_cap > SIM_SEQ_SPACE) {
+        sim->frame_cap = SIM_SEQ_SPACE;
+    }
+    sim->frame_tx_us = malloc(SIM_SEQ_SPACE * sizeof(int64_t));
+    for (int i = 0; i < SIM_SEQ_SPACE; i++) {
+        sim->frame_tx_us[i] = -1;
+    }
+    sim->mixer_edit_pending = cfg->mixer_change_at_ms > 0;
+    sim->mixer_edit_us = (int64_t)cfg->mixer_change_at_ms * 1000;
+
+    // Breadth-first fill: node i hangs under (i - 1) / branching.
+    for (int i = 0; i < sim->n; i++) {
+        sim_node_t *n = &sim->nodes[i];
+        n->parent = i == 0 ? -1 : (i - 1) / cfg->branching;
+        n->layer = i == 0 ? 1 : (uint8_t)(sim->nodes[n->parent].layer + 1);
+        n->latency_us = malloc(sim->frame_cap * sizeof(uint32_t));
+    }
+
+    bool ok = sim_spawn(sim, init) && sim_loop(sim);
+    for (int i = 0; ok && i < sim->n; i++) {
+        ok = sim_command(sim, i, MESH_SIM_CMD_REPORT, 0, NULL);
+    }
+    sim_shutdown(sim);
+    if (ok) {
+        sim_collect(sim, out);
+    }
+
+    while (sim->event_count > 0) {
+        sim_event_t ev = sim_event_pop(sim);
+        ev.pkt->refs--;
+        sim_packet_release(ev.pkt);
+    }
+    for (int i = 0; i < sim->n; i++) {
+        free(sim->nodes[i].latency_us);
+    }
+    free(sim->events);
+    free(sim->frame_tx_us);
+    free(sim->nodes);
+    free(init);
+    free(sim);
+    return ok;
+}
+
+void mesh_sim_print(const mesh_sim_config_t *cfg, const mesh_sim_result_t *res)
+{
+    printf("mesh-sim nodes=%u depth=%u branching=%u loss=%.1f%% retries=%u frames=%lu\n",
+           (unsigned)res->node_count, (unsigned)res->depth, (unsigned)cfg->branching,
+           cfg->hop_loss * 100.0f, (unsigned)cfg->mac_retries, (unsigned long)res->frames_sent);
+    printf("  delivery min=%.1f%% mean=%.1f%%  latency p50=%.1fms p95=%.1fms p99=%.1fms max=%.1fms\n",
+           res->delivery_min * 100.0f, res->delivery_mean * 100.0f,
+           res->latency_p50_us / 1000.0, res->latency_p95_us / 1000.0,
+           res->latency_p99_us / 1000.0, res->latency_max_us / 1000.0);
+    printf("  airtime=%.1fms (audio %.1fms, control %.1fms) util=%.1f%% tx=%lu lost=%lu qdrop=%lu\n",
+           res->airtime_us / 1000.0, res->audio_airtime_us / 1000.0, res->control_airtime_us / 1000.0,
+           res->channel_utilization * 100.0f, (unsigned long)res->transmissions,
+           (unsigned long)res->hops_lost, (unsigned long)res->queue_drops);
+    printf("  root: fanout=%s switches=%lu links=%lu heartbeats=%lu retransmits=%lu\n",
+           mesh_fanout_mode_name((mesh_fanout_mode_t)res->root_fanout_mode),
+           (unsigned long)res->root_fanout_switches, (unsigned long)res->root_links,
+           (unsigned long)res->root_heartbeats, (unsigned long)res->root_retransmits);
+
+    printf("  layer nodes delivery  p50      p95      max\n");
+    for (uint8_t layer = 2; layer <= res->depth + 1; layer++) {
+        unsigned count = 0;
+        float delivery = 0.0f;
+        uint32_t p50 = 0, p95 = 0, max = 0;
+        for (int i = 1; i < res->node_count; i++) {
+            const mesh_sim_node_result_t *r = &res->nodes[i];
+            if (r->layer != layer) {
+                continue;
+            }
+            count++;
+            delivery += r->delivery;
+            p50 = r->latency_p50_us > p50 ? r->latency_p50_us : p50;
+            p95 = r->latency_p95_us > p95 ? r->latency_p95_us : p95;
+            max = r->latency_max_us > max ? r->latency_max_us : max;
+        }
+        if (count > 0) {
+            printf("  %-5u %-5u %6.1f%%  %5.1fms  %5.1fms  %5.1fms\n", (unsigned)layer, count,
+                   delivery * 100.0f / (float)count, p50 / 1000.0, p95 / 1000.0, max / 1000.0);
+        }
+    }
+}
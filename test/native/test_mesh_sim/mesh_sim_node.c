@@ -0,0 +1,549 @@
+// Virtual node: the real mesh modules plus the IDF/FreeRTOS surface they call,
+// backed by the coordinator's clock and medium. Each node runs in its own
+// process, so every module global below is per node.
+
+#include "mesh_sim.h"
+
+// Every mesh module defines its own static TAG; rename it per include so they
+// can share this translation unit.
+#define TAG TAG_mesh_state
+#include "../../../lib/network/src/mesh/mesh_state.c"
+#undef TAG
+#define TAG TAG_mesh_dedupe
+#include "../../../lib/network/src/mesh/mesh_dedupe.c"
+#undef TAG
+#define TAG TAG_mesh_fanout
+#include "../../../lib/network/src/mesh/mesh_fanout.c"
+#undef TAG
+#define TAG TAG_mesh_retransmit
+#include "../../../lib/network/src/mesh/mesh_retransmit.c"
+#undef TAG
+#define TAG TAG_mesh_coalesce
+#include "../../../lib/network/src/mesh/mesh_coalesce.c"
+#undef TAG
+#define TAG TAG_mesh_tx
+#include "../../../lib/network/src/mesh/mesh_tx.c"
+#undef TAG
+#define TAG TAG_mesh_rx
+#include "../../../lib/network/src/mesh/mesh_rx.c"
+#undef TAG
+#define TAG TAG_mesh_heartbeat
+#include "../../../lib/network/src/mesh/mesh_heartbeat.c"
+#undef TAG
+#define TAG TAG_mesh_ping
+#include "../../../lib/network/src/mesh/mesh_ping.c"
+#undef TAG
+#define TAG TAG_mesh_mixer
+#include "../../../lib/network/src/mesh/mesh_mixer.c"
+#undef TAG
+#define TAG TAG_mesh_uplink
+#include "../../../lib/network/src/mesh/mesh_uplink.c"
+#undef TAG
+#define TAG TAG_mesh_queries
+#include "../../../lib/network/src/mesh/mesh_queries.c"
+#undef TAG
+#define TAG TAG_mesh_capture
+#include "../../../lib/network/src/mesh/mesh_capture.c"
+#undef TAG
+#include "../../../lib/network/src/mesh/mesh_transport.c"
+#define CONFIG_OUT_BUILD
+#include "../../../lib/network/src/mesh/mesh_identity.c"
+
+#include "../../../lib/network/src/audio_transport.c"
+#include "../../../lib/network/src/control_bundle.c"
+#include "../../../lib/network/src/frame_codec.c"
+#include "../../../lib/network/src/link_table.c"
+#include "../../../lib/network/src/mesh_net.c"
+#include "../../../lib/network/src/mixer_control.c"
+#include "../../../lib/network/src/packet_pool.c"
+#include "../../../lib/network/src/rtt_estimator.c"
+#include "../../../lib/network/src/rx_capture.c"
+#include "../../../lib/network/src/stat_counters.c"
+#include "../../../lib/network/src/transport.c"
+#include "../../../lib/network/src/uplink_control.c"
+
+#include <esp_heap_caps.h>
+#include <esp_mac.h>
+#include <esp_system.h>
+#include <esp_wifi.h>
+#include <unistd.h>
+
+#define SIM_NODE_MAX_TIMERS 8
+
+struct esp_timer {
+    bool created;
+    bool active;
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t due_us;
+    uint64_t period_us;
+};
+
+static int s_fd = -1;
+static const mesh_sim_node_init_t *s_init;
+static int64_t s_now_us;
+static uint32_t s_rng;
+static struct esp_timer s_timers[SIM_NODE_MAX_TIMERS];
+static int64_t s_next_tick_us;
+static int64_t s_next_audio_us;
+static uint16_t s_audio_seq;
+static mesh_sim_msg_t s_cmd;
+static mesh_sim_msg_t s_out;
+static mesh_sim_msg_t s_reply;
+
+static void node_record(uint8_t type, int32_t arg, int32_t flag)
+{
+    s_out.type = type;
+    s_out.has_addr = 0;
+    s_out.len = 0;
+    s_out.arg = arg;
+    s_out.flag = flag;
+    s_out.time_us = s_now_us;
+    if (!mesh_sim_write_msg(s_fd, &s_out)) {
+        _exit(1);
+    }
+}
+
+// --- IDF / FreeRTOS surface ---
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    for (int i = 0; i < SIM_NODE_MAX_TIMERS; i++) {
+        if (!s_timers[i].created) {
+            s_timers[i] = (struct esp_timer){
+                .created = true,
+                .callback = create_args->callback,
+                .arg = create_args->arg,
+            };
+            *out_handle = &s_timers[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = true;
+    timer->due_us = s_now_us + (int64_t)timeout_us;
+    timer->period_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    esp_err_t err = esp_timer_start_once(timer, period);
+    timer->period_us = period;
+    return err;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    timer->active = false;
+    timer->created = false;
+    return ESP_OK;
+}
+
+uint32_t esp_random(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// RX capture is never started in the simulator.
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)size;
+    (void)caps;
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                       uint32_t priority, TaskHandle_t *out_handle)
+{
+    (void)fn;
+    (void)name;
+    (void)stack_bytes;
+    (void)arg;
+    (void)priority;
+    (void)out_handle;
+    return pdFALSE;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(uint32_t ticks)
+{
+    (void)ticks;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    (void)clear_on_exit;
+    (void)ticks;
+    return 1;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+    return pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    static int mutex;
+    return &mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem;
+    (void)ticks;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+bool esp_mesh_is_root(void)
+{
+    return is_mesh_root;
+}
+
+uint8_t esp_mesh_get_layer(void)
+{
+    return mesh_layer;
+}
+
+int esp_mesh_get_routing_table_size(void)
+{
+    return s_init->route_count;
+}
+
+esp_err_t esp_mesh_get_routing_table(mesh_addr_t *mac, int len, int *size)
+{
+    int count = s_init->route_count;
+    if (count > len / (int)sizeof(mesh_addr_t)) {
+        count = len / (int)sizeof(mesh_addr_t);
+    }
+    for (int i = 0; i < count; i++) {
+        memcpy(mac[i].addr, s_init->route[i], 6);
+    }
+    *size = count;
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_set_group_id(const mesh_addr_t *addr, int num)
+{
+    (void)addr;
+    (void)num;
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_send(const mesh_addr_t *to, const mesh_data_t *data, int flag,
+                        const mesh_opt_t opt[], int opt_count)
+{
+    (void)opt;
+    (void)opt_count;
+    if (!data || data->size == 0 || data->size > MESH_RX_BUFFER_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_out.type = MESH_SIM_REC_SEND;
+    s_out.has_addr = to ? 1 : 0;
+    if (to) {
+        memcpy(s_out.addr, to->addr, 6);
+    }
+    s_out.flag = flag;
+    s_out.len = data->size;
+    s_out.time_us = s_now_us;
+    memcpy(s_out.data, data->data, data->size);
+    if (!mesh_sim_write_msg(s_fd, &s_out) || !mesh_sim_read_msg(s_fd, &s_reply) ||
+        s_reply.type != MESH_SIM_STATUS) {
+        _exit(1);
+    }
+    return s_reply.flag;
+}
+
+// Packets reach the node through MESH_SIM_CMD_DELIVER, never a blocking recv.
+esp_err_t esp_mesh_recv(mesh_addr_t *from, mesh_data_t *data, int timeout_ms, int *flag,
+                        mesh_opt_t opt[], int opt_count)
+{
+    (void)from;
+    (void)data;
+    (void)timeout_ms;
+    (void)flag;
+    (void)opt;
+    (void)opt_count;
+    return ESP_ERR_MESH_NOT_START;
+}
+
+esp_err_t esp_mesh_connect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_disconnect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_set_router(const mesh_router_t *router)
+{
+    (void)router;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    if (is_mesh_root) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ap_info->rssi = (int8_t)(-40 - 6 * mesh_layer);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t *sta_list)
+{
+    sta_list->num = 0;
+    return ESP_OK;
+}
+
+void portal_state_update_position(const uint8_t *mac, float x, float y, float z)
+{
+    (void)mac;
+    (void)x;
+    (void)y;
+    (void)z;
+}
+
+// --- Node runtime ---
+
+static void node_on_audio(const uint8_t *payload, size_t len, uint16_t seq, uint32_t timestamp, const char *src_id)
+{
+    (void)payload;
+    (void)len;
+    (void)timestamp;
+    (void)src_id;
+    node_record(MESH_SIM_REC_AUDIO_RX, seq, 0);
+}
+
+static esp_err_t node_on_mixer(const network_mixer_status_t *status)
+{
+    node_record(MESH_SIM_REC_MIXER, status->out_gain_pct, 0);
+    return ESP_OK;
+}
+
+static void node_run_due_timers(void)
+{
+    for (;;) {
+        struct esp_timer *due = NULL;
+        for (int i = 0; i < SIM_NODE_MAX_TIMERS; i++) {
+            struct esp_timer *t = &s_timers[i];
+            if (t->active && t->due_us <= s_now_us && (!due || t->due_us < due->due_us)) {
+                due = t;
+            }
+        }
+        if (!due) {
+            return;
+        }
+        if (due->period_us > 0) {
+            due->due_us += (int64_t)due->period_us;
+        } else {
+            due->active = false;
+        }
+        due->callback(due->arg);
+    }
+}
+
+// SRC pipeline stand-in: one packet of MESH_FRAMES_PER_PACKET fixed-size frames
+// through the zero-copy TX path, stamped with the sim clock.
+static void node_produce_audio(void)
+{
+    for (int i = 0; i < MESH_FRAMES_PER_PACKET; i++) {
+        size_t capacity = 0;
+        uint8_t *slot = network_audio_tx_frame_slot(&capacity);
+        if (!slot) {
+            break;
+        }
+        size_t len = s_init->opus_frame_bytes < capacity ? s_init->opus_frame_bytes : capacity;
+        memset(slot, (uint8_t)(s_audio_seq + i), len);
+        network_audio_tx_commit_frame(len);
+    }
+    uint8_t frames = network_audio_tx_frame_count();
+    if (frames == 0) {
+        return;
+    }
+    uint16_t seq = s_audio_seq;
+    network_audio_tx_send(seq, (uint32_t)(s_now_us / 1000), my_stream_id);
+    node_record(MESH_SIM_REC_AUDIO_TX, seq, frames);
+    s_audio_seq = (uint16_t)(s_audio_seq + frames);
+}
+
+static void node_wake(void)
+{
+    if (s_now_us >= s_next_tick_us) {
+        s_next_tick_us = s_now_us + (int64_t)mesh_heartbeat_tick() * 1000;
+    }
+    if (my_node_role == NODE_ROLE_SRC && s_now_us >= s_next_audio_us &&
+        s_next_audio_us < s_init->audio_end_us) {
+        node_produce_audio();
+        s_next_audio_us += (int64_t)MESH_FRAMES_PER_PACKET * AUDIO_FRAME_EFFECTIVE_MS * 1000;
+    }
+}
+
+static int64_t node_next_wake(void)
+{
+    int64_t next = s_next_tick_us;
+    if (my_node_role == NODE_ROLE_SRC && s_next_audio_us < s_init->audio_end_us && s_next_audio_us < next) {
+        next = s_next_audio_us;
+    }
+    for (int i = 0; i < SIM_NODE_MAX_TIMERS; i++) {
+        if (s_timers[i].active && s_timers[i].due_us < next) {
+            next = s_timers[i].due_us;
+        }
+    }
+    return next;
+}
+
+static void node_report(void)
+{
+    network_transport_stats_t stats;
+    network_get_transport_stats(&stats);
+
+    mesh_sim_node_report_t report = {
+        .rx_duplicates = stats.rx_audio_duplicates,
+        .tx_nacks = stats.tx_nack_packets,
+        .rx_heartbeats = stats.rx_heartbeat_packets,
+        .tx_retransmits = stats.tx_retransmit_packets,
+        .link_count = g_link_table.count,
+        .fanout_mode = (uint8_t)fanout_policy.mode,
+        .fanout_switches = fanout_policy.switches,
+        .mixer_gain_pct = s_mixer.out_gain_pct,
+    };
+    s_out.type = MESH_SIM_REC_REPORT;
+    s_out.has_addr = 0;
+    s_out.len = sizeof(report);
+    s_out.time_us = s_now_us;
+    memcpy(s_out.data, &report, sizeof(report));
+    if (!mesh_sim_write_msg(s_fd, &s_out)) {
+        _exit(1);
+    }
+}
+
+// What mesh_init and the mesh events would have set up by the time the node
+// has joined its parent.
+static void node_setup(void)
+{
+    bool root = s_init->index == 0;
+
+    my_node_role = root ? NODE_ROLE_SRC : NODE_ROLE_OUT;
+    memcpy(my_sta_mac, s_init->mac, 6);
+    my_stream_id = my_sta_mac[0] ^ my_sta_mac[1] ^ my_sta_mac[2] ^
+                   my_sta_mac[3] ^ my_sta_mac[4] ^ my_sta_mac[5];
+    snprintf(g_src_id, NETWORK_SRC_ID_LEN, "%s_%02X%02X%02X", root ? "SRC" : "OUT",
+             my_sta_mac[3], my_sta_mac[4], my_sta_mac[5]);
+
+    is_mesh_root = root;
+    is_mesh_root_ready = true;
+    is_mesh_connected = !root;
+    mesh_layer = s_init->layer;
+    mesh_children_count = s_init->children;
+    memcpy(mesh_parent_addr.addr, s_init->parent_mac, 6);
+    mesh_addr_t root_addr;
+    memcpy(root_addr.addr, s_init->root_mac, 6);
+    mesh_state_set_root_addr(&root_addr);
+
+    mesh_dedupe_reset();
+    mesh_state_init();
+    mesh_mixer_init();
+    mesh_coalesce_init();
+    mesh_tx_init();
+    mesh_retx_cache_init();
+    network_transport_set(mesh_transport_backend());
+    network_register_mixer_apply_callback(node_on_mixer);
+    if (!root) {
+        network_register_audio_callback(node_on_audio);
+        esp_mesh_set_group_id(&audio_multicast_group, 1);
+    }
+
+    s_next_tick_us = s_init->start_us;
+    s_next_audio_us = s_init->audio_start_us;
+}
+
+void mesh_sim_node_main(int fd, const mesh_sim_node_init_t *init)
+{
+    s_fd = fd;
+    s_init = init;
+    s_rng = (init->seed * 2654435761u) ^ (0x9E3779B9u + init->index);
+    if (s_rng == 0) {
+        s_rng = 1;
+    }
+    s_now_us = 0;
+    node_setup();
+
+    while (mesh_sim_read_msg(fd, &s_cmd)) {
+        s_now_us = s_cmd.time_us;
+        node_run_due_timers();
+
+        switch (s_cmd.type) {
+            case MESH_SIM_CMD_WAKE:
+                node_wake();
+                break;
+            case MESH_SIM_CMD_DELIVER: {
+                mesh_addr_t from;
+                memcpy(from.addr, s_cmd.addr, 6);
+                mesh_rx_dispatch(&from, s_cmd.data, s_cmd.len);
+                break;
+            }
+            case MESH_SIM_CMD_SET_GAIN:
+                network_set_mixer_config((uint16_t)s_cmd.arg);
+                break;
+            case MESH_SIM_CMD_REPORT:
+                node_report();
+                break;
+            case MESH_SIM_CMD_EXIT:
+            default:
+                _exit(0);
+        }
+
+        s_out.type = MESH_SIM_REC_DONE;
+        s_out.has_addr = 0;
+        s_out.len = 0;
+        s_out.time_us = node_next_wake();
+        if (!mesh_sim_write_msg(fd, &s_out)) {
+            _exit(1);
+        }
+    }
+    _exit(0);
+}
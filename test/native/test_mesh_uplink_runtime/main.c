@@ -25,18 +25,10 @@ mesh_addr_t mesh_parent_addr = {{0}};
 
 uint32_t measured_latency_ms = 0;
 int8_t mesh_parent_rssi = -100;
-bool ping_pending = false;
 int8_t nearest_child_rssi = -100;
 uint32_t nearest_child_latency_ms = 0;
 mesh_addr_t nearest_child_addr = {{0}};
-bool child_ping_pending = false;
-int64_t last_ping_sent_us = 0;
-int64_t last_child_ping_sent_us = 0;
-
-uint32_t ping_seq = 0;
-uint32_t child_ping_seq = 0;
-uint32_t pending_ping_id = 0;
-uint32_t pending_child_ping_id = 0;
+
 uint32_t no_parent_count = 0;
 uint32_t scan_done_count = 0;
 uint32_t join_fail_count = 0;
@@ -64,7 +56,6 @@ network_heartbeat_callback_t heartbeat_rx_callback = NULL;
 uint32_t total_drops = 0;
 uint32_t total_sent = 0;
 volatile uint32_t tx_bytes_counter = 0;
-network_transport_stats_t g_transport_stats = {0};
 
 uint8_t mesh_rx_buffer[MESH_RX_BUFFER_SIZE] = {0};
 const mesh_addr_t audio_multicast_group = {{0}};
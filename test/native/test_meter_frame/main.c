@@ -0,0 +1,177 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "audio/level_meter.h"
+#include "control/meter_frame.h"
+
+#include "../../../lib/audio/src/level_meter.c"
+#include "../../../lib/control/src/meter_frame.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void fill_frame(meter_frame_t *f)
+{
+    memset(f, 0, sizeof(*f));
+    f->flags = METER_FRAME_F_BINS_VALID | METER_FRAME_F_SIGNAL;
+    f->seq = 0xBEEF;
+    f->ts_ms = 0x12345678;
+    f->buffer_fill_pct = 42;
+    f->bin_count = METER_FRAME_MAX_BINS;
+    for (int i = 0; i < METER_FRAME_MAX_BINS; i++) {
+        f->bins[i] = (uint8_t)(i * 9);
+    }
+    f->stream_count = 2;
+    f->streams[0] = (meter_frame_stream_t){ METER_FRAME_STREAM_LOCAL, 32767, 12000 };
+    f->streams[1] = (meter_frame_stream_t){ 3, 1, 0 };
+}
+
+static void test_round_trip_preserves_every_field(void)
+{
+    meter_frame_t in, out;
+    uint8_t buf[METER_FRAME_MAX_BYTES];
+    fill_frame(&in);
+
+    size_t len = meter_frame_encode(&in, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(METER_FRAME_HEADER_BYTES + METER_FRAME_MAX_BINS + 2 * METER_FRAME_STREAM_BYTES, len);
+    TEST_ASSERT_TRUE(meter_frame_decode(buf, len, &out));
+
+    TEST_ASSERT_EQUAL_UINT8(METER_FRAME_VERSION, out.version);
+    TEST_ASSERT_EQUAL_UINT8(in.flags, out.flags);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(0x12345678, out.ts_ms);
+    TEST_ASSERT_EQUAL_UINT8(42, out.buffer_fill_pct);
+    TEST_ASSERT_EQUAL_UINT8(METER_FRAME_MAX_BINS, out.bin_count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in.bins, out.bins, METER_FRAME_MAX_BINS);
+    TEST_ASSERT_EQUAL_UINT8(2, out.stream_count);
+    TEST_ASSERT_EQUAL_UINT8(METER_FRAME_STREAM_LOCAL, out.streams[0].id);
+    TEST_ASSERT_EQUAL_UINT16(32767, out.streams[0].peak_q15);
+    TEST_ASSERT_EQUAL_UINT16(12000, out.streams[0].rms_q15);
+    TEST_ASSERT_EQUAL_UINT8(3, out.streams[1].id);
+    TEST_ASSERT_EQUAL_UINT16(1, out.streams[1].peak_q15);
+}
+
+static void test_header_is_little_endian_and_fixed(void)
+{
+    meter_frame_t in;
+    uint8_t buf[METER_FRAME_MAX_BYTES];
+    fill_frame(&in);
+    in.bin_count = 0;
+    in.stream_count = 1;
+
+    size_t len = meter_frame_encode(&in, buf, sizeof(buf));
+    const uint8_t expected[] = {
+        'M', METER_FRAME_VERSION, 0x03, 0, 0xEF, 0xBE, 0x78, 0x56, 0x34, 0x12, 42, 1,
+        0, 0xFF, 0x7F, 0xE0, 0x2E,
+    };
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(expected));
+}
+
+static void test_full_frame_fits_max_bytes(void)
+{
+    meter_frame_t in;
+    uint8_t buf[METER_FRAME_MAX_BYTES];
+    fill_frame(&in);
+    in.stream_count = METER_FRAME_MAX_STREAMS;
+
+    TEST_ASSERT_EQUAL_size_t(METER_FRAME_MAX_BYTES, meter_frame_encode(&in, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_size_t(0, meter_frame_encode(&in, buf, sizeof(buf) - 1));
+    in.stream_count = METER_FRAME_MAX_STREAMS + 1;
+    TEST_ASSERT_EQUAL_size_t(0, meter_frame_encode(&in, buf, sizeof(buf)));
+}
+
+static void test_decode_rejects_bad_input(void)
+{
+    meter_frame_t in, out;
+    uint8_t buf[METER_FRAME_MAX_BYTES];
+    fill_frame(&in);
+    size_t len = meter_frame_encode(&in, buf, sizeof(buf));
+
+    TEST_ASSERT_FALSE(meter_frame_decode(buf, METER_FRAME_HEADER_BYTES - 1, &out));
+    TEST_ASSERT_FALSE(meter_frame_decode(buf, len - 1, &out));
+
+    buf[0] = '{';
+    TEST_ASSERT_FALSE(meter_frame_decode(buf, len, &out));
+    buf[0] = METER_FRAME_MAGIC;
+    buf[1] = 0;
+    TEST_ASSERT_FALSE(meter_frame_decode(buf, len, &out));
+    buf[1] = METER_FRAME_VERSION;
+    buf[3] = METER_FRAME_MAX_BINS + 1;
+    TEST_ASSERT_FALSE(meter_frame_decode(buf, sizeof(buf), &out));
+}
+
+static void test_decode_ignores_fields_appended_by_newer_versions(void)
+{
+    meter_frame_t in, out;
+    uint8_t buf[METER_FRAME_MAX_BYTES + 8];
+    fill_frame(&in);
+    size_t len = meter_frame_encode(&in, buf, sizeof(buf));
+    buf[1] = METER_FRAME_VERSION + 1;
+    memset(buf + len, 0xAA, 8);
+
+    TEST_ASSERT_TRUE(meter_frame_decode(buf, len + 8, &out));
+    TEST_ASSERT_EQUAL_UINT8(METER_FRAME_VERSION + 1, out.version);
+    TEST_ASSERT_EQUAL_UINT16(12000, out.streams[0].rms_q15);
+}
+
+static void test_quantize_bin_clamps_and_rounds(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(0, meter_frame_quantize_bin(-0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0, meter_frame_quantize_bin(0.0f));
+    TEST_ASSERT_EQUAL_UINT8(0, meter_frame_quantize_bin(NAN));
+    TEST_ASSERT_EQUAL_UINT8(128, meter_frame_quantize_bin(0.5f));
+    TEST_ASSERT_EQUAL_UINT8(255, meter_frame_quantize_bin(1.0f));
+    TEST_ASSERT_EQUAL_UINT8(255, meter_frame_quantize_bin(7.0f));
+}
+
+static void test_level_meter_holds_max_until_taken(void)
+{
+    level_meter_t m;
+    level_meter_reset(&m);
+    const int16_t loud[4] = { 16384, -16384, 16384, -16384 };
+    const int16_t quiet[4] = { 100, -100, 100, -100 };
+    uint16_t peak, rms;
+
+    level_meter_feed_s16(&m, loud, 4);
+    level_meter_feed_s16(&m, quiet, 4);
+    level_meter_take(&m, &peak, &rms);
+    TEST_ASSERT_EQUAL_UINT16(16384, peak);
+    TEST_ASSERT_EQUAL_UINT16(16384, rms);
+
+    level_meter_feed_s16(&m, quiet, 4);
+    level_meter_take(&m, &peak, &rms);
+    TEST_ASSERT_EQUAL_UINT16(100, peak);
+    TEST_ASSERT_EQUAL_UINT16(100, rms);
+
+    level_meter_take(&m, &peak, &rms);
+    TEST_ASSERT_EQUAL_UINT16(0, peak);
+}
+
+static void test_level_meter_clamps_negative_full_scale(void)
+{
+    level_meter_t m;
+    level_meter_reset(&m);
+    const int16_t clip[2] = { -32768, -32768 };
+    uint16_t peak, rms;
+
+    level_meter_feed_s16(&m, clip, 2);
+    level_meter_take(&m, &peak, &rms);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_METER_Q15_MAX, peak);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_METER_Q15_MAX, rms);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_preserves_every_field);
+    RUN_TEST(test_header_is_little_endian_and_fixed);
+    RUN_TEST(test_full_frame_fits_max_bytes);
+    RUN_TEST(test_decode_rejects_bad_input);
+    RUN_TEST(test_decode_ignores_fields_appended_by_newer_versions);
+    RUN_TEST(test_quantize_bin_clamps_and_rounds);
+    RUN_TEST(test_level_meter_holds_max_until_taken);
+    RUN_TEST(test_level_meter_clamps_negative_full_scale);
+    return UNITY_END();
+}
@@ -218,6 +218,204 @@ void test_mixer_decode_rejects_invalid_stream_entries(void)
     TEST_ASSERT_FALSE(mixer_ctrl_decode(&packet, sizeof(packet), &msg));
 }
 
+static mixer_ctrl_message_t make_mixer_state(uint16_t out_gain, uint16_t gain1, uint16_t gain2)
+{
+    mixer_ctrl_message_t msg = {
+        .subtype = MIXER_CTRL_SYNC,
+        .version = MIXER_CTRL_VERSION,
+        .out_gain_pct = out_gain,
+        .stream_count = 2,
+    };
+    msg.streams[0].stream_id = 1;
+    msg.streams[0].gain_pct = gain1;
+    msg.streams[0].enabled = true;
+    msg.streams[1].stream_id = 2;
+    msg.streams[1].gain_pct = gain2;
+    msg.streams[1].enabled = true;
+    return msg;
+}
+
+void test_mixer_delta_encode_full_without_previous_state(void)
+{
+    mixer_ctrl_message_t next = make_mixer_state(100, 80, 90);
+    mixer_delta_packet_t packet;
+
+    size_t len = mixer_delta_encode(NULL, &next, 0, 1, &packet);
+
+    TEST_ASSERT_EQUAL_size_t(sizeof(mixer_delta_header_t) + 2 * sizeof(mixer_delta_entry_t), len);
+    TEST_ASSERT_EQUAL_UINT8(NET_PKT_TYPE_MIXER_DELTA, packet.hdr.type);
+    TEST_ASSERT_EQUAL_UINT8(MIXER_DELTA_FLAG_FULL | MIXER_DELTA_FLAG_OUT_GAIN, packet.hdr.flags);
+    TEST_ASSERT_EQUAL_UINT16(1, ntohs(packet.hdr.state_version));
+    TEST_ASSERT_EQUAL_UINT16(100, ntohs(packet.hdr.out_gain_pct));
+}
+
+void test_mixer_delta_encode_carries_only_changed_fields(void)
+{
+    mixer_ctrl_message_t prev = make_mixer_state(100, 80, 90);
+    mixer_ctrl_message_t next = prev;
+    mixer_delta_packet_t packet;
+
+    TEST_ASSERT_EQUAL_size_t(0, mixer_delta_encode(&prev, &next, 1, 2, &packet));
+
+    next.streams[1].gain_pct = 120;
+    size_t len = mixer_delta_encode(&prev, &next, 1, 2, &packet);
+    TEST_ASSERT_EQUAL_size_t(sizeof(mixer_delta_header_t) + sizeof(mixer_delta_entry_t), len);
+    TEST_ASSERT_EQUAL_UINT8(0, packet.hdr.flags);
+    TEST_ASSERT_EQUAL_UINT8(1, packet.hdr.entry_count);
+    TEST_ASSERT_EQUAL_UINT8(2, packet.entries[0].stream_id);
+    TEST_ASSERT_EQUAL_UINT8(MIXER_DELTA_FIELD_GAIN, packet.entries[0].fields);
+
+    next = prev;
+    next.out_gain_pct = 150;
+    len = mixer_delta_encode(&prev, &next, 1, 2, &packet);
+    TEST_ASSERT_EQUAL_size_t(sizeof(mixer_delta_header_t), len);
+    TEST_ASSERT_EQUAL_UINT8(MIXER_DELTA_FLAG_OUT_GAIN, packet.hdr.flags);
+}
+
+void test_mixer_delta_encode_stream_set_change_is_full(void)
+{
+    mixer_ctrl_message_t prev = make_mixer_state(100, 80, 90);
+    mixer_ctrl_message_t next = prev;
+    mixer_delta_packet_t packet;
+
+    next.streams[1].stream_id = 3;
+    mixer_delta_encode(&prev, &next, 4, 5, &packet);
+    TEST_ASSERT_TRUE(packet.hdr.flags & MIXER_DELTA_FLAG_FULL);
+    TEST_ASSERT_EQUAL_UINT8(2, packet.hdr.entry_count);
+}
+
+void test_mixer_delta_apply_full_then_delta(void)
+{
+    mixer_ctrl_message_t root = make_mixer_state(100, 80, 90);
+    mixer_ctrl_message_t node = {0};
+    uint16_t node_version = 0;
+    mixer_delta_packet_t packet;
+
+    size_t len = mixer_delta_encode(NULL, &root, 0, 1, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_APPLIED,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(1, node_version);
+    TEST_ASSERT_EQUAL_UINT8(2, node.stream_count);
+    TEST_ASSERT_EQUAL_UINT16(90, node.streams[1].gain_pct);
+
+    mixer_ctrl_message_t next = root;
+    next.streams[0].muted = true;
+    len = mixer_delta_encode(&root, &next, 1, 2, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_APPLIED,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(2, node_version);
+    TEST_ASSERT_TRUE(node.streams[0].muted);
+    TEST_ASSERT_TRUE(node.streams[0].enabled);
+    TEST_ASSERT_EQUAL_UINT16(80, node.streams[0].gain_pct);
+
+    TEST_ASSERT_EQUAL(MIXER_DELTA_STALE,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+}
+
+void test_mixer_delta_apply_reports_gap_and_leaves_state(void)
+{
+    mixer_ctrl_message_t prev = make_mixer_state(100, 80, 90);
+    mixer_ctrl_message_t next = prev;
+    mixer_ctrl_message_t node = prev;
+    uint16_t node_version = 3;
+    mixer_delta_packet_t packet;
+
+    next.streams[0].gain_pct = 10;
+    size_t len = mixer_delta_encode(&prev, &next, 4, 5, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_GAP,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(3, node_version);
+    TEST_ASSERT_EQUAL_UINT16(80, node.streams[0].gain_pct);
+
+    // A node that never synced cannot take a delta either.
+    node_version = 0;
+    TEST_ASSERT_EQUAL(MIXER_DELTA_GAP,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+}
+
+void test_mixer_delta_full_state_resyncs_any_version(void)
+{
+    mixer_ctrl_message_t root = make_mixer_state(60, 70, 80);
+    mixer_ctrl_message_t node = make_mixer_state(100, 80, 90);
+    uint16_t node_version = 57;
+    mixer_delta_packet_t packet;
+
+    // e.g. the root rebooted and restarted its version counter.
+    size_t len = mixer_delta_encode(NULL, &root, 0, 1, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_APPLIED,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(1, node_version);
+    TEST_ASSERT_EQUAL_UINT16(60, node.out_gain_pct);
+}
+
+void test_mixer_delta_apply_handles_version_wraparound(void)
+{
+    mixer_ctrl_message_t prev = make_mixer_state(100, 80, 90);
+    mixer_ctrl_message_t next = prev;
+    mixer_ctrl_message_t node = prev;
+    uint16_t node_version = 0xFFFF;
+    mixer_delta_packet_t packet;
+
+    next.out_gain_pct = 110;
+    size_t len = mixer_delta_encode(&prev, &next, 0xFFFF, 1, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_APPLIED,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(1, node_version);
+    TEST_ASSERT_EQUAL_UINT16(110, node.out_gain_pct);
+}
+
+void test_mixer_version_beacon_flags_only_stale_nodes(void)
+{
+    mixer_ctrl_message_t node = make_mixer_state(100, 80, 90);
+    uint16_t node_version = 7;
+    mixer_delta_packet_t packet;
+
+    size_t len = mixer_delta_encode_beacon(7, &packet);
+    TEST_ASSERT_EQUAL_size_t(sizeof(mixer_delta_header_t), len);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_STALE,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+
+    // The node missed the last delta of a burst: the beacon reveals it.
+    len = mixer_delta_encode_beacon(8, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_GAP,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(7, node_version);
+    TEST_ASSERT_EQUAL_UINT16(100, node.out_gain_pct);
+
+    TEST_ASSERT_EQUAL_size_t(0, mixer_delta_encode_beacon(0, &packet));
+}
+
+void test_mixer_delta_apply_rejects_invalid_packets(void)
+{
+    mixer_ctrl_message_t root = make_mixer_state(100, 80, 90);
+    mixer_ctrl_message_t node = {0};
+    uint16_t node_version = 0;
+    mixer_delta_packet_t packet;
+
+    size_t len = mixer_delta_encode(NULL, &root, 0, 1, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_INVALID,
+                      mixer_delta_apply((const uint8_t *)&packet, len - 1, &node_version, &node));
+    TEST_ASSERT_EQUAL(MIXER_DELTA_INVALID,
+                      mixer_delta_apply((const uint8_t *)&packet, 3, &node_version, &node));
+    TEST_ASSERT_EQUAL(MIXER_DELTA_INVALID, mixer_delta_apply(NULL, len, &node_version, &node));
+
+    packet.entries[0].gain_pct = htons(MIXER_STREAM_GAIN_MAX_PCT + 1);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_INVALID,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+    TEST_ASSERT_EQUAL_UINT16(0, node_version);
+    TEST_ASSERT_EQUAL_UINT8(0, node.stream_count);
+
+    // A non-full delta naming an unknown stream is rejected.
+    mixer_ctrl_message_t next = root;
+    next.streams[0].gain_pct = 5;
+    node = root;
+    node.streams[0].stream_id = 9;
+    node_version = 1;
+    len = mixer_delta_encode(&root, &next, 1, 2, &packet);
+    TEST_ASSERT_EQUAL(MIXER_DELTA_INVALID,
+                      mixer_delta_apply((const uint8_t *)&packet, len, &node_version, &node));
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -231,5 +429,14 @@ int main(void)
     RUN_TEST(test_mixer_decode_happy_path_legacy_zero_streams);
     RUN_TEST(test_mixer_decode_rejects_out_of_range);
     RUN_TEST(test_mixer_decode_rejects_invalid_stream_entries);
+    RUN_TEST(test_mixer_delta_encode_full_without_previous_state);
+    RUN_TEST(test_mixer_delta_encode_carries_only_changed_fields);
+    RUN_TEST(test_mixer_delta_encode_stream_set_change_is_full);
+    RUN_TEST(test_mixer_delta_apply_full_then_delta);
+    RUN_TEST(test_mixer_delta_apply_reports_gap_and_leaves_state);
+    RUN_TEST(test_mixer_delta_full_state_resyncs_any_version);
+    RUN_TEST(test_mixer_delta_apply_handles_version_wraparound);
+    RUN_TEST(test_mixer_version_beacon_flags_only_stale_nodes);
+    RUN_TEST(test_mixer_delta_apply_rejects_invalid_packets);
     return UNITY_END();
 }
@@ -0,0 +1,253 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "control/node_table.h"
+
+#include "../../../lib/control/src/node_table.c"
+
+#define EXPIRE_MS 30000
+
+static node_table_t s_table;
+
+void setUp(void)
+{
+    node_table_init(&s_table, EXPIRE_MS);
+}
+
+void tearDown(void) {}
+
+static void mac_for(uint8_t mac[6], uint32_t n)
+{
+    const uint8_t base[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x00 };
+    memcpy(mac, base, 6);
+    mac[3] = (uint8_t)(n >> 16);
+    mac[4] = (uint8_t)(n >> 8);
+    mac[5] = (uint8_t)n;
+}
+
+static int touch_n(uint32_t n, int64_t now_ms)
+{
+    uint8_t mac[6];
+    mac_for(mac, n);
+    return node_table_touch(&s_table, mac, now_ms);
+}
+
+static int find_n(uint32_t n)
+{
+    uint8_t mac[6];
+    mac_for(mac, n);
+    return node_table_find(&s_table, mac);
+}
+
+// Index, dense array and wheel all describe the same set of nodes.
+static void check_invariants(void)
+{
+    const node_table_t *t = &s_table;
+    int indexed = 0;
+    for (int s = 0; s < NODE_TABLE_INDEX_SLOTS; s++) {
+        if (t->index[s] != NODE_TABLE_NONE) {
+            indexed++;
+            TEST_ASSERT_TRUE(t->index[s] < t->count);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(t->count, indexed);
+
+    int unpinned = 0;
+    for (int i = 0; i < t->count; i++) {
+        TEST_ASSERT_EQUAL_INT(i, node_table_find(t, t->mac[i]));
+        if (!(t->flags[i] & NODE_TABLE_F_PINNED)) {
+            unpinned++;
+        }
+    }
+
+    int linked = 0;
+    for (int b = 0; b < NODE_TABLE_WHEEL_SLOTS; b++) {
+        uint8_t prev = NODE_TABLE_NONE;
+        for (uint8_t i = t->wheel_head[b]; i != NODE_TABLE_NONE; i = t->wheel_next[i]) {
+            TEST_ASSERT_TRUE(i < t->count);
+            TEST_ASSERT_FALSE(t->flags[i] & NODE_TABLE_F_PINNED);
+            TEST_ASSERT_EQUAL_UINT8(b, t->wheel_slot[i]);
+            TEST_ASSERT_EQUAL_UINT8(prev, t->wheel_prev[i]);
+            prev = i;
+            linked++;
+            TEST_ASSERT_TRUE(linked <= t->count);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(unpinned, linked);
+}
+
+static void test_touch_adds_once_and_find_uses_the_index(void)
+{
+    int a = touch_n(1, 1000);
+    int b = touch_n(2, 1000);
+    TEST_ASSERT_EQUAL_INT(0, a);
+    TEST_ASSERT_EQUAL_INT(1, b);
+    TEST_ASSERT_EQUAL_INT(a, touch_n(1, 2000));
+    TEST_ASSERT_EQUAL_INT(2, s_table.count);
+    TEST_ASSERT_EQUAL_INT64(2000, s_table.last_seen_ms[a]);
+    TEST_ASSERT_EQUAL_INT(b, find_n(2));
+    TEST_ASSERT_EQUAL_INT(-1, find_n(3));
+    check_invariants();
+}
+
+static void test_table_holds_the_routing_limit(void)
+{
+    for (uint32_t n = 0; n < NODE_TABLE_CAPACITY; n++) {
+        TEST_ASSERT_EQUAL_INT((int)n, touch_n(n, 0));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, touch_n(NODE_TABLE_CAPACITY, 0));
+    TEST_ASSERT_EQUAL_INT(NODE_TABLE_CAPACITY, s_table.count);
+    for (uint32_t n = 0; n < NODE_TABLE_CAPACITY; n++) {
+        TEST_ASSERT_EQUAL_INT((int)n, find_n(n));
+    }
+    check_invariants();
+}
+
+static void test_remove_keeps_index_and_dense_array_consistent(void)
+{
+    for (uint32_t n = 0; n < NODE_TABLE_CAPACITY; n++) {
+        touch_n(n * 7919u, 0);
+    }
+    // Remove every third node from the front, which exercises both the
+    // swap-from-end and backward-shift paths.
+    for (uint32_t n = 0; n < NODE_TABLE_CAPACITY; n += 3) {
+        int idx = find_n(n * 7919u);
+        TEST_ASSERT_TRUE(idx >= 0);
+        node_table_remove(&s_table, idx);
+        TEST_ASSERT_EQUAL_INT(-1, find_n(n * 7919u));
+        check_invariants();
+    }
+    for (uint32_t n = 0; n < NODE_TABLE_CAPACITY; n++) {
+        TEST_ASSERT_EQUAL((n % 3) != 0, find_n(n * 7919u) >= 0);
+    }
+}
+
+static void test_silent_nodes_expire_on_their_tick(void)
+{
+    touch_n(1, 0);
+    touch_n(2, 10000);
+    TEST_ASSERT_EQUAL_size_t(0, node_table_expire(&s_table, 29000));
+    TEST_ASSERT_EQUAL_size_t(1, node_table_expire(&s_table, 30000));
+    TEST_ASSERT_EQUAL_INT(-1, find_n(1));
+    TEST_ASSERT_TRUE(find_n(2) >= 0);
+    TEST_ASSERT_EQUAL_size_t(0, node_table_expire(&s_table, 39000));
+    TEST_ASSERT_EQUAL_size_t(1, node_table_expire(&s_table, 40000));
+    TEST_ASSERT_EQUAL_INT(0, s_table.count);
+    check_invariants();
+}
+
+static void test_touch_defers_expiry(void)
+{
+    touch_n(1, 0);
+    for (int64_t now = 2000; now <= 120000; now += 2000) {
+        touch_n(1, now);
+        TEST_ASSERT_EQUAL_size_t(0, node_table_expire(&s_table, now));
+    }
+    TEST_ASSERT_EQUAL_size_t(1, node_table_expire(&s_table, 150000));
+    check_invariants();
+}
+
+static void test_long_gap_expires_everything_due(void)
+{
+    for (uint32_t n = 0; n < 20; n++) {
+        touch_n(n, (int64_t)n * 500);
+    }
+    node_table_expire(&s_table, 1000);
+    TEST_ASSERT_EQUAL_size_t(20, node_table_expire(&s_table, 10 * 60 * 1000));
+    TEST_ASSERT_EQUAL_INT(0, s_table.count);
+    check_invariants();
+}
+
+static void test_pinned_node_never_expires(void)
+{
+    node_table_pin(&s_table, touch_n(0xAA, 0));
+    touch_n(1, 0);
+    check_invariants();
+    TEST_ASSERT_EQUAL_size_t(1, node_table_expire(&s_table, 60000));
+    TEST_ASSERT_EQUAL_INT(0, find_n(0xAA));
+    check_invariants();
+}
+
+static void test_route_sync_is_an_incremental_diff(void)
+{
+    uint8_t routes[4][6];
+    for (int i = 0; i < 4; i++) {
+        mac_for(routes[i], 100 + i);
+    }
+    touch_n(7, 0);          // Heartbeat-only node, never in the routing table
+
+    TEST_ASSERT_EQUAL_size_t(3, node_table_sync_routes(&s_table, routes, 3, 0));
+    TEST_ASSERT_EQUAL_size_t(0, node_table_sync_routes(&s_table, routes, 3, 500));
+    TEST_ASSERT_EQUAL_INT(4, s_table.count);
+
+    // 100 leaves, 103 joins.
+    TEST_ASSERT_EQUAL_size_t(2, node_table_sync_routes(&s_table, routes + 1, 3, 1000));
+    TEST_ASSERT_EQUAL_INT(-1, find_n(100));
+    TEST_ASSERT_TRUE(find_n(103) >= 0);
+    TEST_ASSERT_TRUE(find_n(7) >= 0);
+    check_invariants();
+
+    // Routed nodes are held by the routing table; the unrouted one expires.
+    TEST_ASSERT_EQUAL_size_t(1, node_table_expire(&s_table, 90000));
+    TEST_ASSERT_EQUAL_INT(-1, find_n(7));
+    TEST_ASSERT_EQUAL_INT(3, s_table.count);
+
+    TEST_ASSERT_EQUAL_size_t(3, node_table_sync_routes(&s_table, routes, 0, 91000));
+    TEST_ASSERT_EQUAL_INT(0, s_table.count);
+    check_invariants();
+}
+
+static void test_sync_keeps_pinned_self_when_it_leaves_the_routes(void)
+{
+    uint8_t routes[2][6];
+    mac_for(routes[0], 0xAA);
+    mac_for(routes[1], 1);
+    node_table_pin(&s_table, touch_n(0xAA, 0));
+
+    TEST_ASSERT_EQUAL_size_t(1, node_table_sync_routes(&s_table, routes, 2, 0));
+    TEST_ASSERT_EQUAL_size_t(1, node_table_sync_routes(&s_table, routes, 0, 1000));
+    TEST_ASSERT_EQUAL_INT(0, find_n(0xAA));
+    TEST_ASSERT_FALSE(s_table.flags[0] & NODE_TABLE_F_ROUTED);
+    check_invariants();
+}
+
+static void test_churn_at_capacity_stays_consistent(void)
+{
+    uint32_t seed = 12345;
+    int64_t now = 0;
+    for (int step = 0; step < 4000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t n = (seed >> 16) % (NODE_TABLE_CAPACITY * 2);
+        now += 97;
+        if ((seed & 7) == 0) {
+            int idx = find_n(n);
+            if (idx >= 0) {
+                node_table_remove(&s_table, idx);
+            }
+        } else {
+            touch_n(n, now);
+        }
+        node_table_expire(&s_table, now);
+        if ((step % 50) == 0) {
+            check_invariants();
+        }
+    }
+    check_invariants();
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_touch_adds_once_and_find_uses_the_index);
+    RUN_TEST(test_table_holds_the_routing_limit);
+    RUN_TEST(test_remove_keeps_index_and_dense_array_consistent);
+    RUN_TEST(test_silent_nodes_expire_on_their_tick);
+    RUN_TEST(test_touch_defers_expiry);
+    RUN_TEST(test_long_gap_expires_everything_due);
+    RUN_TEST(test_pinned_node_never_expires);
+    RUN_TEST(test_route_sync_is_an_incremental_diff);
+    RUN_TEST(test_sync_keeps_pinned_self_when_it_leaves_the_routes);
+    RUN_TEST(test_churn_at_capacity_stays_consistent);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#include <unity.h>
+
+#include "network/packet_pool.h"
+
+#include "../../../lib/network/src/packet_pool.c"
+
+void setUp(void)
+{
+    network_pkt_pool_reset();
+}
+
+void tearDown(void)
+{
+}
+
+void test_alloc_hands_out_distinct_buffers_with_one_reference(void)
+{
+    network_pkt_buf_t *a = network_pkt_alloc();
+    network_pkt_buf_t *b = network_pkt_alloc();
+
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_TRUE(a != b);
+    TEST_ASSERT_EQUAL_UINT(1, atomic_load(&a->refs));
+    TEST_ASSERT_EQUAL_size_t(0, a->len);
+}
+
+void test_buffer_returns_to_pool_after_last_release(void)
+{
+    network_pkt_pool_stats_t stats;
+    network_pkt_buf_t *buf = network_pkt_alloc();
+    network_pkt_retain(buf);
+
+    network_pkt_release(buf);
+    network_pkt_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.in_use);
+
+    network_pkt_release(buf);
+    network_pkt_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.in_use);
+    TEST_ASSERT_EQUAL_UINT(0, atomic_load(&buf->refs));
+}
+
+void test_over_release_is_ignored(void)
+{
+    network_pkt_pool_stats_t stats;
+    network_pkt_buf_t *buf = network_pkt_alloc();
+
+    network_pkt_release(buf);
+    network_pkt_release(buf);
+    network_pkt_release(NULL);
+    network_pkt_retain(NULL);
+
+    network_pkt_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.in_use);
+    TEST_ASSERT_EQUAL_UINT(0, atomic_load(&buf->refs));
+}
+
+void test_exhaustion_and_high_water_are_counted(void)
+{
+    network_pkt_buf_t *held[MESH_PKT_POOL_SIZE];
+    network_pkt_pool_stats_t stats;
+
+    for (int i = 0; i < MESH_PKT_POOL_SIZE; i++) {
+        held[i] = network_pkt_alloc();
+        TEST_ASSERT_NOT_NULL(held[i]);
+    }
+    TEST_ASSERT_NULL(network_pkt_alloc());
+    TEST_ASSERT_NULL(network_pkt_alloc());
+
+    network_pkt_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(MESH_PKT_POOL_SIZE, stats.capacity);
+    TEST_ASSERT_EQUAL_UINT32(MESH_PKT_POOL_SIZE, stats.high_water);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.exhausted);
+
+    network_pkt_release(held[3]);
+    network_pkt_buf_t *reused = network_pkt_alloc();
+    TEST_ASSERT_TRUE(reused == held[3]);
+
+    for (int i = 0; i < MESH_PKT_POOL_SIZE; i++) {
+        network_pkt_release(held[i]);
+    }
+}
+
+void test_reset_stats_restarts_high_water_from_current_use(void)
+{
+    network_pkt_pool_stats_t stats;
+    network_pkt_buf_t *a = network_pkt_alloc();
+    network_pkt_buf_t *b = network_pkt_alloc();
+    network_pkt_release(b);
+
+    network_pkt_pool_reset_stats();
+    network_pkt_pool_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.in_use);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.high_water);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.exhausted);
+
+    network_pkt_release(a);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_alloc_hands_out_distinct_buffers_with_one_reference);
+    RUN_TEST(test_buffer_returns_to_pool_after_last_release);
+    RUN_TEST(test_over_release_is_ignored);
+    RUN_TEST(test_exhaustion_and_high_water_are_counted);
+    RUN_TEST(test_reset_stats_restarts_high_water_from_current_use);
+    return UNITY_END();
+}
@@ -504,6 +504,44 @@ static bool validate_usb_status_contract(const char *json)
            strcmp(input_mode, "USB") == 0;
 }
 
+// Optional; null until the pipeline reports stats.
+static bool validate_meters_field(const char *json)
+{
+    const char *start = NULL;
+    const char *end = NULL;
+    bool is_null = false;
+    double unused = 0;
+    if (field_null_or_number(json, "meters", &is_null, &unused)) {
+        return is_null;
+    }
+    if (!field_object_span(json, "meters", &start, &end)) {
+        const char *value_start = NULL;
+        return !find_key_value_start(json, "meters", &value_start);
+    }
+
+    char meters_json[160];
+    size_t len = (size_t)(end - start + 1);
+    if (len >= sizeof(meters_json)) {
+        return false;
+    }
+    memcpy(meters_json, start, len);
+    meters_json[len] = '\0';
+
+    long input_peak = -1;
+    long buffer_pct = -1;
+    long tx_kbps = -1;
+    bool signal = false;
+    bool rx_audio = false;
+    if (!field_int(meters_json, "inputPeak", &input_peak) ||
+        !field_bool(meters_json, "signal", &signal) ||
+        !field_int(meters_json, "bufferPct", &buffer_pct) ||
+        !field_int(meters_json, "txKbps", &tx_kbps) ||
+        !field_bool(meters_json, "rxAudio", &rx_audio)) {
+        return false;
+    }
+    return input_peak >= 0 && input_peak <= 65535 && buffer_pct >= 0 && buffer_pct <= 100 && tx_kbps >= 0;
+}
+
 static bool validate_status_contract(const char *json)
 {
     long schema_version = -1;
@@ -538,7 +576,7 @@ static bool validate_status_contract(const char *json)
         return false;
     }
 
-    if (!validate_fft_bins_field(json)) {
+    if (!validate_fft_bins_field(json) || !validate_meters_field(json)) {
         return false;
     }
 
@@ -1035,6 +1073,7 @@ static const char *VALID_STATUS_JSON =
     "\"meshState\":\"Mesh OK\","
     "\"bpm\":null,"
     "\"fftBins\":[0.1,1.25,2.5],"
+    "\"meters\":{\"inputPeak\":1200,\"signal\":true,\"bufferPct\":40,\"txKbps\":96,\"rxAudio\":false},"
     "\"nodes\":["
       "{"
       "\"mac\":\"AA:BB:CC:DD:EE:FF\",\"role\":\"SRC\",\"root\":true,\"layer\":0,\"rssi\":-30,"
@@ -1097,6 +1136,22 @@ void test_status_allows_additional_fields(void)
     TEST_ASSERT_TRUE(validate_status_contract(STATUS_WITH_ADDITIONAL_FIELDS));
 }
 
+void test_status_rejects_malformed_meters(void)
+{
+    const char *json =
+        "{"
+        "\"schemaVersion\":1,\"ts\":1,\"self\":\"AA:BB:CC:DD:EE:FF\",\"heapKb\":1,\"core0LoadPct\":10,"
+        "\"latencyMs\":1,\"netIf\":\"n\",\"buildLabel\":\"SRC\",\"meshState\":\"Mesh OK\","
+        "\"bpm\":null,\"fftBins\":null,\"meters\":{\"inputPeak\":1,\"signal\":true,\"bufferPct\":140,"
+        "\"txKbps\":0,\"rxAudio\":false},"
+        "\"nodes\":["
+        "{\"mac\":\"AA:BB:CC:DD:EE:FF\",\"role\":\"SRC\",\"root\":true,\"layer\":0,\"rssi\":-1,\"children\":0,\"streaming\":true,\"parent\":null,\"uptime\":1,\"stale\":false}"
+        "],"
+        "\"usb\":{\"inputMode\":\"AUX\",\"ready\":true,\"active\":true}"
+        "}";
+    TEST_ASSERT_FALSE(validate_status_contract(json));
+}
+
 void test_status_rejects_invalid_usb_status_fields(void)
 {
     const char *json =
@@ -1540,6 +1595,7 @@ int main(void)
     UNITY_BEGIN();
     RUN_TEST(test_status_required_fields_types_and_invariants);
     RUN_TEST(test_status_allows_additional_fields);
+    RUN_TEST(test_status_rejects_malformed_meters);
     RUN_TEST(test_status_rejects_invalid_usb_status_fields);
     RUN_TEST(test_status_rejects_duplicate_node_mac);
     RUN_TEST(test_status_rejects_root_node_nonzero_layer);
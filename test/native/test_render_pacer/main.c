@@ -0,0 +1,82 @@
+#include <unity.h>
+
+#include "control/render_pacer.h"
+
+#include "../../../lib/control/src/render_pacer.c"
+
+#define FRAME_MS        100
+#define DASHBOARD_MS    1000
+#define MAX_IDLE_MS     1000
+
+static render_pacer_t s_pacer;
+
+void setUp(void)
+{
+    render_pacer_init(&s_pacer, DASHBOARD_MS, MAX_IDLE_MS);
+}
+
+void tearDown(void) {}
+
+static void test_first_frame_draws_everything(void)
+{
+    uint8_t due = render_pacer_tick(&s_pacer, 5000, 0, 0, false);
+    TEST_ASSERT_EQUAL_HEX8(RENDER_PACER_DISPLAY | RENDER_PACER_DASHBOARD, due);
+}
+
+static void test_unchanged_frames_are_skipped(void)
+{
+    render_pacer_tick(&s_pacer, 0, 1, 0, false);
+    for (int64_t t = FRAME_MS; t < MAX_IDLE_MS; t += FRAME_MS) {
+        TEST_ASSERT_EQUAL_HEX8(0, render_pacer_tick(&s_pacer, t, 1, 0, false));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, s_pacer.frames_drawn);
+    TEST_ASSERT_EQUAL_UINT32(MAX_IDLE_MS / FRAME_MS - 1, s_pacer.frames_skipped);
+}
+
+static void test_new_generation_or_view_draws(void)
+{
+    render_pacer_tick(&s_pacer, 0, 1, 0, false);
+    TEST_ASSERT_EQUAL_HEX8(RENDER_PACER_DISPLAY, render_pacer_tick(&s_pacer, 100, 2, 0, false));
+    TEST_ASSERT_EQUAL_HEX8(0, render_pacer_tick(&s_pacer, 200, 2, 0, false));
+    TEST_ASSERT_EQUAL_HEX8(RENDER_PACER_DISPLAY, render_pacer_tick(&s_pacer, 300, 2, 1, false));
+}
+
+static void test_animation_draws_every_frame(void)
+{
+    render_pacer_tick(&s_pacer, 0, 1, 0, true);
+    for (int64_t t = FRAME_MS; t < 900; t += FRAME_MS) {
+        TEST_ASSERT_EQUAL_HEX8(RENDER_PACER_DISPLAY, render_pacer_tick(&s_pacer, t, 1, 0, true));
+    }
+}
+
+static void test_idle_screen_still_refreshes(void)
+{
+    render_pacer_tick(&s_pacer, 0, 1, 0, false);
+    TEST_ASSERT_EQUAL_HEX8(0, render_pacer_tick(&s_pacer, MAX_IDLE_MS - 1, 1, 0, false));
+    TEST_ASSERT_TRUE(render_pacer_tick(&s_pacer, MAX_IDLE_MS, 1, 0, false) & RENDER_PACER_DISPLAY);
+}
+
+static void test_dashboard_keeps_its_own_cadence(void)
+{
+    int dashboards = 0;
+    for (int64_t t = 0; t < 10 * DASHBOARD_MS; t += FRAME_MS) {
+        if (render_pacer_tick(&s_pacer, t, (uint32_t)(t / 250), 0, false) & RENDER_PACER_DASHBOARD) {
+            dashboards++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(10, dashboards);
+    // Telemetry at 4 Hz: 40 of the 100 frames had anything new to draw.
+    TEST_ASSERT_EQUAL_UINT32(40, s_pacer.frames_drawn);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_draws_everything);
+    RUN_TEST(test_unchanged_frames_are_skipped);
+    RUN_TEST(test_new_generation_or_view_draws);
+    RUN_TEST(test_animation_draws_every_frame);
+    RUN_TEST(test_idle_screen_still_refreshes);
+    RUN_TEST(test_dashboard_keeps_its_own_cadence);
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "network/rtt_estimator.h"
+
+#include "../../../lib/network/src/rtt_estimator.c"
+
+static network_rtt_window_t window;
+static network_ping_tracker_t tracker;
+
+static const uint8_t child_mac[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01};
+
+void setUp(void)
+{
+    network_rtt_window_init(&window);
+    network_ping_tracker_init(&tracker);
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty_window_reports_nothing(void)
+{
+    network_rtt_summary_t summary;
+
+    TEST_ASSERT_FALSE(network_rtt_window_summary(&window, &summary));
+    TEST_ASSERT_EQUAL_UINT32(0, summary.samples);
+    TEST_ASSERT_EQUAL_UINT32(0, network_rtt_window_quantile(&window, 50));
+}
+
+void test_quantiles_use_nearest_rank(void)
+{
+    const uint32_t samples[] = {9000, 1000, 5000, 3000, 7000};
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        network_rtt_window_add(&window, samples[i]);
+    }
+
+    network_rtt_summary_t summary;
+    TEST_ASSERT_TRUE(network_rtt_window_summary(&window, &summary));
+    TEST_ASSERT_EQUAL_UINT32(5, summary.samples);
+    TEST_ASSERT_EQUAL_UINT32(1000, summary.min_us);
+    TEST_ASSERT_EQUAL_UINT32(5000, summary.p50_us);
+    TEST_ASSERT_EQUAL_UINT32(9000, summary.p95_us);
+    TEST_ASSERT_EQUAL_UINT32(9000, summary.max_us);
+    TEST_ASSERT_EQUAL_UINT32(1000, network_rtt_window_quantile(&window, 0));
+}
+
+void test_single_outlier_does_not_move_median(void)
+{
+    for (int i = 0; i < 19; i++) {
+        network_rtt_window_add(&window, 8000);
+    }
+    network_rtt_window_add(&window, 250000);
+
+    TEST_ASSERT_EQUAL_UINT32(8000, network_rtt_window_quantile(&window, 50));
+    TEST_ASSERT_EQUAL_UINT32(8000, network_rtt_window_quantile(&window, 95));
+    TEST_ASSERT_EQUAL_UINT32(250000, network_rtt_window_quantile(&window, 100));
+}
+
+void test_window_slides_out_oldest_samples(void)
+{
+    network_rtt_window_add(&window, 100);
+    network_rtt_window_add(&window, 100);
+    for (int i = 0; i < MESH_RTT_WINDOW_SAMPLES; i++) {
+        network_rtt_window_add(&window, 5000 + (uint32_t)i);
+    }
+
+    network_rtt_summary_t summary;
+    network_rtt_window_summary(&window, &summary);
+    TEST_ASSERT_EQUAL_UINT32(MESH_RTT_WINDOW_SAMPLES, summary.samples);
+    TEST_ASSERT_EQUAL_UINT32(5000, summary.min_us);
+    TEST_ASSERT_EQUAL_UINT32(5000 + MESH_RTT_WINDOW_SAMPLES - 1, summary.max_us);
+    TEST_ASSERT_EQUAL_UINT32(MESH_RTT_WINDOW_SAMPLES + 2, window.total_samples);
+
+    for (uint16_t i = 1; i < window.count; i++) {
+        TEST_ASSERT_TRUE(window.sorted[i - 1] <= window.sorted[i]);
+    }
+}
+
+void test_window_handles_duplicate_values_when_sliding(void)
+{
+    for (int i = 0; i < MESH_RTT_WINDOW_SAMPLES * 3; i++) {
+        network_rtt_window_add(&window, (uint32_t)(i % 3) * 1000);
+    }
+    TEST_ASSERT_EQUAL_UINT16(MESH_RTT_WINDOW_SAMPLES, window.count);
+    for (uint16_t i = 1; i < window.count; i++) {
+        TEST_ASSERT_TRUE(window.sorted[i - 1] <= window.sorted[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, window.sorted[0]);
+    TEST_ASSERT_EQUAL_UINT32(2000, window.sorted[window.count - 1]);
+}
+
+void test_tracker_keeps_several_pings_in_flight(void)
+{
+    uint32_t first = network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 1000);
+    uint32_t second = network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 2000);
+    uint32_t child = network_ping_tracker_start(&tracker, NETWORK_PING_DOWNSTREAM, child_mac, 2500);
+
+    TEST_ASSERT_TRUE(first != 0 && second != 0 && first != second);
+    TEST_ASSERT_EQUAL_size_t(2, network_ping_tracker_inflight(&tracker, NETWORK_PING_UPSTREAM));
+    TEST_ASSERT_EQUAL_size_t(1, network_ping_tracker_inflight(&tracker, NETWORK_PING_DOWNSTREAM));
+
+    // Pongs may come back out of order.
+    uint32_t rtt_us = 0;
+    network_ping_slot_t slot;
+    TEST_ASSERT_TRUE(network_ping_tracker_complete(&tracker, second, 9000, &rtt_us, &slot));
+    TEST_ASSERT_EQUAL_UINT32(7000, rtt_us);
+    TEST_ASSERT_TRUE(network_ping_tracker_complete(&tracker, child, 4500, &rtt_us, &slot));
+    TEST_ASSERT_EQUAL_UINT32(2000, rtt_us);
+    TEST_ASSERT_EQUAL_UINT8(NETWORK_PING_DOWNSTREAM, slot.direction);
+    TEST_ASSERT_EQUAL_MEMORY(child_mac, slot.mac, 6);
+    TEST_ASSERT_TRUE(network_ping_tracker_complete(&tracker, first, 10000, &rtt_us, &slot));
+    TEST_ASSERT_EQUAL_UINT32(9000, rtt_us);
+
+    TEST_ASSERT_FALSE(network_ping_tracker_complete(&tracker, first, 11000, &rtt_us, &slot));
+}
+
+void test_tracker_refuses_when_full_and_cancel_frees_slot(void)
+{
+    uint32_t ids[MESH_PING_MAX_INFLIGHT];
+    for (int i = 0; i < MESH_PING_MAX_INFLIGHT; i++) {
+        ids[i] = network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 0);
+        TEST_ASSERT_TRUE(ids[i] != 0);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 0));
+
+    network_ping_tracker_cancel(&tracker, ids[1]);
+    TEST_ASSERT_TRUE(network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 0) != 0);
+}
+
+void test_tracker_expires_only_stale_pings(void)
+{
+    uint32_t old_id = network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 0);
+    uint32_t fresh_id = network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 1500000);
+
+    TEST_ASSERT_EQUAL_size_t(1, network_ping_tracker_expire(&tracker, 2500000, 2000000));
+    TEST_ASSERT_FALSE(network_ping_tracker_complete(&tracker, old_id, 2600000, NULL, NULL));
+    TEST_ASSERT_TRUE(network_ping_tracker_complete(&tracker, fresh_id, 2600000, NULL, NULL));
+}
+
+void test_tracker_skips_zero_id_on_wrap(void)
+{
+    tracker.next_id = UINT32_MAX;
+    TEST_ASSERT_EQUAL_UINT32(1, network_ping_tracker_start(&tracker, NETWORK_PING_UPSTREAM, NULL, 0));
+    TEST_ASSERT_FALSE(network_ping_tracker_complete(&tracker, 0, 0, NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_window_reports_nothing);
+    RUN_TEST(test_quantiles_use_nearest_rank);
+    RUN_TEST(test_single_outlier_does_not_move_median);
+    RUN_TEST(test_window_slides_out_oldest_samples);
+    RUN_TEST(test_window_handles_duplicate_values_when_sliding);
+    RUN_TEST(test_tracker_keeps_several_pings_in_flight);
+    RUN_TEST(test_tracker_refuses_when_full_and_cancel_frees_slot);
+    RUN_TEST(test_tracker_expires_only_stale_pings);
+    RUN_TEST(test_tracker_skips_zero_id_on_wrap);
+    return UNITY_END();
+}
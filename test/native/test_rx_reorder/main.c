@@ -0,0 +1,152 @@
+#include <unity.h>
+
+#include "config/build.h"
+#include "audio/rx_reorder.h"
+#include "../../../lib/audio/src/rx_reorder.c"
+
+#define HOLD_MS     80
+#define MAX_CONCEAL 5
+#define MAX_STALE   24
+
+static rx_reorder_t s_reorder;
+static uint8_t s_payload[4];
+
+// One pop result, rendered as seq for frames and ~seq (negative) for concealment.
+static int pop_one(int64_t now_ms)
+{
+    uint16_t seq;
+    const uint8_t *data;
+    uint16_t len;
+    rx_reorder_pop_t due = rx_reorder_pop(&s_reorder, now_ms, &seq, &data, &len);
+    if (due == RX_REORDER_NONE) {
+        return INT32_MIN;
+    }
+    if (due == RX_REORDER_CONCEAL) {
+        TEST_ASSERT_NULL(data);
+        return -(int)seq - 1;
+    }
+    TEST_ASSERT_EQUAL_UINT16(sizeof(s_payload), len);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)seq, data[0]);
+    return seq;
+}
+
+static rx_reorder_push_t push(uint16_t seq, int64_t now_ms)
+{
+    s_payload[0] = (uint8_t)seq;
+    return rx_reorder_push(&s_reorder, seq, s_payload, sizeof(s_payload), now_ms);
+}
+
+void setUp(void)
+{
+    rx_reorder_init(&s_reorder, HOLD_MS, MAX_CONCEAL, MAX_STALE);
+}
+
+void tearDown(void) {}
+
+static void test_in_order_frames_pass_straight_through(void)
+{
+    for (uint16_t seq = 100; seq < 110; seq++) {
+        TEST_ASSERT_EQUAL(RX_REORDER_ACCEPTED, push(seq, seq * 20));
+        TEST_ASSERT_EQUAL_INT(seq, pop_one(seq * 20));
+        TEST_ASSERT_EQUAL_INT(INT32_MIN, pop_one(seq * 20));
+    }
+}
+
+static void test_retransmit_fills_gap_within_hold(void)
+{
+    push(10, 0);
+    TEST_ASSERT_EQUAL_INT(10, pop_one(0));
+    // 11 lost; 12 and 13 wait for it.
+    push(12, 40);
+    push(13, 40);
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, pop_one(40));
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, pop_one(40 + HOLD_MS - 1));
+
+    TEST_ASSERT_EQUAL(RX_REORDER_ACCEPTED, push(11, 90));
+    TEST_ASSERT_EQUAL_INT(11, pop_one(90));
+    TEST_ASSERT_EQUAL_INT(12, pop_one(90));
+    TEST_ASSERT_EQUAL_INT(13, pop_one(90));
+    TEST_ASSERT_EQUAL_UINT32(1, s_reorder.stats.repaired);
+    TEST_ASSERT_EQUAL_UINT32(0, s_reorder.stats.concealed);
+}
+
+static void test_expired_gap_is_concealed_and_late_repair_dropped(void)
+{
+    push(10, 0);
+    pop_one(0);
+    push(12, 40);
+    TEST_ASSERT_EQUAL_INT(-11 - 1, pop_one(40 + HOLD_MS));
+    TEST_ASSERT_EQUAL_INT(12, pop_one(40 + HOLD_MS));
+
+    // The retransmit shows up after its slot was concealed: never played.
+    TEST_ASSERT_EQUAL(RX_REORDER_LATE, push(11, 200));
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, pop_one(200));
+    TEST_ASSERT_EQUAL_UINT16(13, s_reorder.next_seq);
+
+    // And the next in-order frame plays with no second round of PLC.
+    push(13, 220);
+    TEST_ASSERT_EQUAL_INT(13, pop_one(220));
+    TEST_ASSERT_EQUAL_UINT32(1, s_reorder.stats.concealed);
+}
+
+static void test_duplicates_are_dropped(void)
+{
+    push(5, 0);
+    push(7, 0);
+    TEST_ASSERT_EQUAL(RX_REORDER_DUPLICATE, push(7, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, s_reorder.stats.duplicates);
+}
+
+static void test_frame_past_the_window_flushes_the_gap(void)
+{
+    push(0, 0);
+    pop_one(0);
+    push(2, 10);
+    // 1 is still within its hold, but 20 cannot fit behind it.
+    TEST_ASSERT_EQUAL(RX_REORDER_FULL, push(20, 20));
+
+    TEST_ASSERT_EQUAL_INT(-1 - 1, pop_one(20));
+    TEST_ASSERT_EQUAL_INT(2, pop_one(20));
+    for (int seq = 3; seq < 3 + MAX_CONCEAL; seq++) {
+        TEST_ASSERT_EQUAL_INT(-seq - 1, pop_one(20));
+    }
+    // Past the conceal cap the rest of the gap is skipped, not concealed.
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, pop_one(20));
+    TEST_ASSERT_EQUAL(RX_REORDER_ACCEPTED, push(20, 20));
+    TEST_ASSERT_EQUAL_INT(20, pop_one(20));
+    TEST_ASSERT_EQUAL_UINT32(1 + MAX_CONCEAL, s_reorder.stats.concealed);
+    TEST_ASSERT_EQUAL_UINT32(20 - 3 - MAX_CONCEAL, s_reorder.stats.skipped);
+}
+
+static void test_far_behind_is_a_sender_restart(void)
+{
+    push(1000, 0);
+    pop_one(0);
+    TEST_ASSERT_EQUAL(RX_REORDER_ACCEPTED, push(5, 20));
+    TEST_ASSERT_EQUAL_INT(5, pop_one(20));
+    TEST_ASSERT_EQUAL_UINT32(1, s_reorder.stats.resets);
+}
+
+static void test_sequence_wrap(void)
+{
+    push(65534, 0);
+    TEST_ASSERT_EQUAL_INT(65534, pop_one(0));
+    push(0, 40);
+    push(65535, 50);
+    TEST_ASSERT_EQUAL_INT(65535, pop_one(50));
+    TEST_ASSERT_EQUAL_INT(0, pop_one(50));
+    TEST_ASSERT_EQUAL(RX_REORDER_LATE, push(65535, 60));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_in_order_frames_pass_straight_through);
+    RUN_TEST(test_retransmit_fills_gap_within_hold);
+    RUN_TEST(test_expired_gap_is_concealed_and_late_repair_dropped);
+    RUN_TEST(test_duplicates_are_dropped);
+    RUN_TEST(test_frame_past_the_window_flushes_the_gap);
+    RUN_TEST(test_far_behind_is_a_sender_restart);
+    RUN_TEST(test_sequence_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,337 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity.h>
+
+#include "rx_replay.h"
+
+#include <esp_mesh.h>
+
+#include "network/mesh_net.h"
+#include "network/rx_capture.h"
+
+#define FRAME_BYTES  160
+#define PACKET_US    ((int64_t)MESH_FRAMES_PER_PACKET * AUDIO_FRAME_MS * 1000)
+
+static const uint8_t parent_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static uint8_t ring_buf[256 * 1024];
+static uint8_t dump_buf[256 * 1024 + NET_RX_CAPTURE_FILE_HEADER];
+static network_rx_capture_t cap;
+static rx_replay_result_t result;
+
+typedef struct {
+    uint8_t *out;
+    size_t size;
+    size_t len;
+} dump_sink_t;
+
+static bool sink_write(void *ctx, const uint8_t *data, size_t len)
+{
+    dump_sink_t *sink = (dump_sink_t *)ctx;
+    if (sink->size - sink->len < len) {
+        return false;
+    }
+    memcpy(sink->out + sink->len, data, len);
+    sink->len += len;
+    return true;
+}
+
+static size_t dump_capture(void)
+{
+    dump_sink_t sink = {.out = dump_buf, .size = sizeof(dump_buf), .len = 0};
+    TEST_ASSERT_TRUE(network_rx_capture_dump(&cap, sink_write, &sink));
+    TEST_ASSERT_EQUAL_UINT32(network_rx_capture_dump_size(&cap), sink.len);
+    return sink.len;
+}
+
+static rx_replay_audio_packet_t audio_packet(uint16_t seq)
+{
+    rx_replay_audio_packet_t pkt = {
+        .seq = seq,
+        .timestamp_ms = (uint32_t)(seq * AUDIO_FRAME_MS),
+        .frames = MESH_FRAMES_PER_PACKET,
+        .frame_bytes = FRAME_BYTES,
+        .ttl = 4,
+        .stream_id = 0x5A,
+    };
+    return pkt;
+}
+
+// One packet of MESH_FRAMES_PER_PACKET frames, as the SRC sends every PACKET_US.
+static void record_audio(int64_t arrival_us, uint16_t seq)
+{
+    uint8_t packet[MESH_RX_BUFFER_SIZE];
+    rx_replay_audio_packet_t pkt = audio_packet(seq);
+    size_t len = rx_replay_build_audio(&pkt, packet, sizeof(packet));
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_TRUE(network_rx_capture_record(&cap, arrival_us, parent_mac, MESH_DATA_P2P, packet, len));
+}
+
+// The SRC announces a stream ahead of its first packet.
+static void record_announce(int64_t arrival_us, uint16_t seq)
+{
+    uint8_t packet[64];
+    rx_replay_audio_packet_t pkt = audio_packet(seq);
+    size_t len = rx_replay_build_announce(&pkt, packet, sizeof(packet));
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_TRUE(network_rx_capture_record(&cap, arrival_us, parent_mac, MESH_DATA_P2P, packet, len));
+}
+
+// A steady stream from start_us with +-jitter_us of arrival noise.
+static void record_stream(uint16_t first_seq, int packets, int64_t start_us, uint32_t jitter_us)
+{
+    record_announce(start_us - (int64_t)jitter_us, first_seq);
+    uint32_t rng = 7;
+    for (int i = 0; i < packets; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int64_t noise = jitter_us ? (int64_t)((rng >> 8) % (2 * jitter_us)) - jitter_us : 0;
+        record_audio(start_us + i * PACKET_US + noise,
+                     (uint16_t)(first_seq + i * MESH_FRAMES_PER_PACKET));
+    }
+}
+
+static void replay(size_t len)
+{
+    rx_replay_config_t cfg = RX_REPLAY_CONFIG_DEFAULT();
+    TEST_ASSERT_TRUE(rx_replay_run(dump_buf, len, &cfg, &result));
+    rx_replay_print(&result);
+}
+
+void setUp(void)
+{
+    network_rx_capture_init(&cap, ring_buf, sizeof(ring_buf), RX_CAPTURE_SNAPLEN);
+    memset(&result, 0, sizeof(result));
+}
+
+void tearDown(void)
+{
+}
+
+void test_dump_round_trip_keeps_timing_sender_flag_and_bytes(void)
+{
+    uint8_t payload[64];
+    const int64_t arrivals[] = {5000000123LL, 5000000123LL, 5000020456LL, 5001000000LL};
+    for (size_t i = 0; i < 4; i++) {
+        uint8_t from[6] = {0x02, 0, 0, 0, 0, (uint8_t)i};
+        memset(payload, (int)(0x10 + i), sizeof(payload));
+        TEST_ASSERT_TRUE(network_rx_capture_record(&cap, arrivals[i], from, (uint8_t)(i + 1),
+                                                   payload, 16 + i * 8));
+    }
+    size_t len = dump_capture();
+
+    network_rx_capture_reader_t reader;
+    network_rx_capture_record_t rec;
+    TEST_ASSERT_TRUE(network_rx_capture_reader_init(&reader, dump_buf, len));
+    TEST_ASSERT_EQUAL_UINT32(4, reader.records);
+    TEST_ASSERT_EQUAL_UINT32(0, reader.overwritten);
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(network_rx_capture_next(&reader, &rec));
+        TEST_ASSERT_EQUAL_INT64(arrivals[i], rec.arrival_us);
+        TEST_ASSERT_EQUAL_UINT8(i, rec.from[5]);
+        TEST_ASSERT_EQUAL_UINT8(i + 1, rec.flag);
+        TEST_ASSERT_EQUAL_UINT16(16 + i * 8, rec.len);
+        TEST_ASSERT_EQUAL_UINT16(rec.orig_len, rec.len);
+        TEST_ASSERT_EQUAL_UINT8(0x10 + i, rec.data[rec.len - 1]);
+    }
+    TEST_ASSERT_FALSE(network_rx_capture_next(&reader, &rec));
+
+    // Corrupt magic and a cut-off record are both refused.
+    dump_buf[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(network_rx_capture_reader_init(&reader, dump_buf, len));
+    dump_buf[0] ^= 0xFF;
+    TEST_ASSERT_TRUE(network_rx_capture_reader_init(&reader, dump_buf, len - 1));
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(network_rx_capture_next(&reader, &rec));
+    }
+    TEST_ASSERT_FALSE(network_rx_capture_next(&reader, &rec));
+
+    // The serial framing's CRC must match zlib.crc32 in tools/rx_capture_extract.py.
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, network_rx_capture_crc32(0, (const uint8_t *)"123456789", 9));
+}
+
+void test_full_ring_overwrites_oldest_whole_records_and_keeps_time_base(void)
+{
+    static uint8_t small[200];
+    uint8_t payload[40] = {0};
+    network_rx_capture_init(&cap, small, sizeof(small), 32);
+
+    // 15-byte header + 32 snapped bytes = 47 per record: 4 fit, wrapping mid-record.
+    for (int i = 0; i < 11; i++) {
+        payload[0] = (uint8_t)i;
+        TEST_ASSERT_TRUE(network_rx_capture_record(&cap, 1000 + i * 777, parent_mac, 0, payload, sizeof(payload)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, cap.records);
+    TEST_ASSERT_EQUAL_UINT32(7, cap.overwritten);
+
+    size_t len = dump_capture();
+    network_rx_capture_reader_t reader;
+    network_rx_capture_record_t rec;
+    TEST_ASSERT_TRUE(network_rx_capture_reader_init(&reader, dump_buf, len));
+    TEST_ASSERT_EQUAL_UINT32(7, reader.overwritten);
+    for (int i = 7; i < 11; i++) {
+        TEST_ASSERT_TRUE(network_rx_capture_next(&reader, &rec));
+        TEST_ASSERT_EQUAL_INT64(1000 + i * 777, rec.arrival_us);
+        TEST_ASSERT_EQUAL_UINT8(i, rec.data[0]);
+        TEST_ASSERT_EQUAL_UINT16(sizeof(payload), rec.orig_len);
+        TEST_ASSERT_EQUAL_UINT16(32, rec.len);
+    }
+
+    // A record larger than the whole ring is refused without disturbing it.
+    network_rx_capture_init(&cap, small, 40, 0);
+    TEST_ASSERT_FALSE(network_rx_capture_record(&cap, 0, parent_mac, 0, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_UINT32(0, cap.records);
+}
+
+void test_transport_recv_feeds_the_firmware_capture_ring(void)
+{
+    uint8_t packet[MESH_RX_BUFFER_SIZE];
+    rx_replay_audio_packet_t pkt = {.seq = 2, .frames = 2, .frame_bytes = 40, .ttl = 3, .stream_id = 1};
+    size_t len = rx_replay_build_audio(&pkt, packet, sizeof(packet));
+
+    // Not running: nothing recorded.
+    TEST_ASSERT_TRUE(rx_replay_transport_recv(parent_mac, MESH_DATA_P2P, packet, len, 1000));
+    TEST_ASSERT_EQUAL_UINT32(ESP_OK, network_rx_capture_start());
+    TEST_ASSERT_TRUE(network_rx_capture_active());
+    TEST_ASSERT_TRUE(rx_replay_transport_recv(parent_mac, MESH_DATA_P2P, packet, len, 2000));
+    TEST_ASSERT_TRUE(rx_replay_transport_recv(parent_mac, MESH_DATA_GROUP, packet, 12, 2500));
+    network_rx_capture_stop();
+    TEST_ASSERT_TRUE(rx_replay_transport_recv(parent_mac, MESH_DATA_P2P, packet, len, 3000));
+
+    size_t dump_len = rx_replay_dump_firmware_ring(dump_buf, sizeof(dump_buf));
+    network_rx_capture_reader_t reader;
+    network_rx_capture_record_t rec;
+    TEST_ASSERT_TRUE(network_rx_capture_reader_init(&reader, dump_buf, dump_len));
+    TEST_ASSERT_EQUAL_UINT32(2, reader.records);
+    TEST_ASSERT_TRUE(network_rx_capture_next(&reader, &rec));
+    TEST_ASSERT_EQUAL_INT64(2000, rec.arrival_us);
+    TEST_ASSERT_EQUAL_UINT8(MESH_DATA_P2P, rec.flag);
+    TEST_ASSERT_EQUAL_MEMORY(parent_mac, rec.from, 6);
+    TEST_ASSERT_EQUAL_MEMORY(packet, rec.data, len);
+    TEST_ASSERT_TRUE(network_rx_capture_next(&reader, &rec));
+    TEST_ASSERT_EQUAL_INT64(2500, rec.arrival_us);
+    TEST_ASSERT_EQUAL_UINT8(MESH_DATA_GROUP, rec.flag);
+    TEST_ASSERT_EQUAL_UINT16(12, rec.len);
+}
+
+void test_clean_stream_replays_without_underruns(void)
+{
+    record_stream(0, 250, 1000000, 4000);
+    replay(dump_capture());
+
+    TEST_ASSERT_EQUAL_UINT32(250, result.audio_packets);
+    TEST_ASSERT_EQUAL_UINT32(250 * MESH_FRAMES_PER_PACKET, result.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, result.lost_frames);
+    TEST_ASSERT_EQUAL_UINT32(0, result.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, result.underruns);
+    TEST_ASSERT_EQUAL_UINT32(result.frames, result.played_frames);
+    TEST_ASSERT_EQUAL(-1, result.first_underrun_ms);
+}
+
+// v2 headers only carry the low seq/timestamp bits; until the announce lands
+// nothing is played from a guess.
+void test_audio_before_the_announce_is_dropped_and_counted(void)
+{
+    const int64_t t0 = 1000000;
+    const uint16_t first_seq = 0x1230;
+    for (int i = 0; i < 3; i++) {
+        record_audio(t0 + i * PACKET_US, (uint16_t)(first_seq + i * MESH_FRAMES_PER_PACKET));
+    }
+    record_stream((uint16_t)(first_seq + 3 * MESH_FRAMES_PER_PACKET), 50, t0 + 3 * PACKET_US, 0);
+    replay(dump_capture());
+
+    TEST_ASSERT_EQUAL_UINT32(53, result.audio_packets);
+    TEST_ASSERT_EQUAL_UINT32(3, result.unanchored);
+    TEST_ASSERT_EQUAL_UINT32(50 * MESH_FRAMES_PER_PACKET, result.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, result.lost_frames);
+}
+
+// Field failure: a 400 ms stall that drains the buffer, a duplicated packet and
+// one that arrives too late to play.
+void test_field_stall_reproduces_underrun_loss_and_duplicates(void)
+{
+    const int before = 100;
+    const int64_t t0 = 1000000;
+    record_stream(0, before, t0, 2000);
+
+    int64_t resume_us = t0 + before * PACKET_US + 400000;
+    uint16_t seq = (uint16_t)(before * MESH_FRAMES_PER_PACKET);
+    for (int i = 0; i < 100; i++, seq += MESH_FRAMES_PER_PACKET) {
+        int64_t at = resume_us + i * PACKET_US;
+        if (i == 30) {
+            continue;
+        }
+        record_audio(at, seq);
+        if (i == 35) {
+            // Straggler: packet 30 shows up after playout moved past it.
+            record_audio(at + 100, (uint16_t)(seq - 5 * MESH_FRAMES_PER_PACKET));
+        }
+        if (i == 50) {
+            record_audio(at + 300, seq);   // Duplicate
+        }
+    }
+    replay(dump_capture());
+
+    TEST_ASSERT_EQUAL_UINT32(1, result.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(MESH_FRAMES_PER_PACKET, result.lost_frames);
+    TEST_ASSERT_EQUAL_UINT32(1, result.gap_events);
+    TEST_ASSERT_TRUE(result.nacks_sent >= 1);
+    TEST_ASSERT_TRUE(result.late_frames >= 1);
+    TEST_ASSERT_TRUE(result.max_audio_gap_ms >= 400);
+    TEST_ASSERT_TRUE(result.underruns > 0);
+    // Playout runs dry inside the stall, once the prefill is spent.
+    const int64_t stall_ms = before * PACKET_US / 1000;
+    TEST_ASSERT_TRUE(result.first_underrun_ms >= stall_ms);
+    TEST_ASSERT_TRUE(result.first_underrun_ms <= stall_ms + 400);
+}
+
+void test_same_capture_replays_identically(void)
+{
+    record_stream(0, 150, 1000000, 15000);
+    size_t len = dump_capture();
+    replay(len);
+    rx_replay_result_t first = result;
+
+    replay(len);
+    first.wall_ns = result.wall_ns;
+    TEST_ASSERT_EQUAL_MEMORY(&first, &result, sizeof(result));
+}
+
+// Field captures: RX_REPLAY_FILE=out_0.rxcap (from tools/rx_capture_extract.py).
+void test_replay_capture_file_from_environment(void)
+{
+    const char *path = getenv("RX_REPLAY_FILE");
+    if (!path) {
+        TEST_IGNORE();
+    }
+    FILE *f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(size > 0 ? (size_t)size : 1);
+    TEST_ASSERT_NOT_NULL(data);
+    size_t len = fread(data, 1, (size_t)size, f);
+    fclose(f);
+
+    rx_replay_config_t cfg = RX_REPLAY_CONFIG_DEFAULT();
+    bool ok = rx_replay_run(data, len, &cfg, &result);
+    free(data);
+    TEST_ASSERT_TRUE(ok);
+    rx_replay_print(&result);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dump_round_trip_keeps_timing_sender_flag_and_bytes);
+    RUN_TEST(test_full_ring_overwrites_oldest_whole_records_and_keeps_time_base);
+    RUN_TEST(test_transport_recv_feeds_the_firmware_capture_ring);
+    RUN_TEST(test_clean_stream_replays_without_underruns);
+    RUN_TEST(test_audio_before_the_announce_is_dropped_and_counted);
+    RUN_TEST(test_field_stall_reproduces_underrun_loss_and_duplicates);
+    RUN_TEST(test_same_capture_replays_identically);
+    RUN_TEST(test_replay_capture_file_from_environment);
+    return UNITY_END();
+}
@@ -0,0 +1,693 @@
+// Replay engine: the real mesh RX modules plus the IDF/FreeRTOS surface they
+// call, driven by a simulated clock that follows the capture's arrival times.
+
+#include "rx_replay.h"
+
+// Every mesh module defines its own static TAG; rename it per include so they
+// can share this translation unit.
+#define TAG TAG_mesh_state
+#include "../../../lib/network/src/mesh/mesh_state.c"
+#undef TAG
+#define TAG TAG_mesh_dedupe
+#include "../../../lib/network/src/mesh/mesh_dedupe.c"
+#undef TAG
+#define TAG TAG_mesh_fanout
+#include "../../../lib/network/src/mesh/mesh_fanout.c"
+#undef TAG
+#define TAG TAG_mesh_retransmit
+#include "../../../lib/network/src/mesh/mesh_retransmit.c"
+#undef TAG
+#define TAG TAG_mesh_coalesce
+#include "../../../lib/network/src/mesh/mesh_coalesce.c"
+#undef TAG
+#define TAG TAG_mesh_tx
+#include "../../../lib/network/src/mesh/mesh_tx.c"
+#undef TAG
+#define TAG TAG_mesh_rx
+#include "../../../lib/network/src/mesh/mesh_rx.c"
+#undef TAG
+#define TAG TAG_mesh_heartbeat
+#include "../../../lib/network/src/mesh/mesh_heartbeat.c"
+#undef TAG
+#define TAG TAG_mesh_ping
+#include "../../../lib/network/src/mesh/mesh_ping.c"
+#undef TAG
+#define TAG TAG_mesh_mixer
+#include "../../../lib/network/src/mesh/mesh_mixer.c"
+#undef TAG
+#define TAG TAG_mesh_uplink
+#include "../../../lib/network/src/mesh/mesh_uplink.c"
+#undef TAG
+#define TAG TAG_mesh_queries
+#include "../../../lib/network/src/mesh/mesh_queries.c"
+#undef TAG
+#define TAG TAG_mesh_capture
+#include "../../../lib/network/src/mesh/mesh_capture.c"
+#undef TAG
+#include "../../../lib/network/src/mesh/mesh_transport.c"
+#define CONFIG_OUT_BUILD
+#include "../../../lib/network/src/mesh/mesh_identity.c"
+
+#include "../../../lib/network/src/audio_transport.c"
+#include "../../../lib/network/src/control_bundle.c"
+#include "../../../lib/network/src/frame_codec.c"
+#include "../../../lib/network/src/link_table.c"
+#include "../../../lib/network/src/mesh_net.c"
+#include "../../../lib/network/src/mixer_control.c"
+#include "../../../lib/network/src/packet_pool.c"
+#include "../../../lib/network/src/rtt_estimator.c"
+#include "../../../lib/network/src/rx_capture.c"
+#include "../../../lib/network/src/stat_counters.c"
+#include "../../../lib/network/src/transport.c"
+#include "../../../lib/network/src/uplink_control.c"
+
+#include "../../../lib/audio/src/rx_underrun_concealment.c"
+#include "../../../lib/audio/src/sequence_tracker.c"
+
+#include <esp_heap_caps.h>
+#include <esp_mac.h>
+#include <esp_system.h>
+#include <esp_wifi.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_MAX_TIMERS 8
+#define REPLAY_FRAME_US   ((int64_t)AUDIO_FRAME_MS * 1000)
+
+struct esp_timer {
+    bool created;
+    bool active;
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t due_us;
+    uint64_t period_us;
+};
+
+typedef struct {
+    bool first;
+    uint16_t last_seq;
+    bool prefilling;
+    uint32_t depth;
+    rx_underrun_state_t underrun;
+} replay_playout_t;
+
+static int64_t s_now_us;
+static uint32_t s_rng = 1;
+static struct esp_timer s_timers[REPLAY_MAX_TIMERS];
+static replay_playout_t s_playout;
+static rx_replay_result_t *s_result;
+static int64_t s_start_us;
+
+// One packet waiting for esp_mesh_recv (rx_replay_transport_recv).
+static struct {
+    bool ready;
+    mesh_addr_t from;
+    int flag;
+    size_t len;
+    uint8_t data[MESH_RX_BUFFER_SIZE];
+} s_pending;
+
+// --- IDF / FreeRTOS surface ---
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    for (int i = 0; i < REPLAY_MAX_TIMERS; i++) {
+        if (!s_timers[i].created) {
+            s_timers[i] = (struct esp_timer){
+                .created = true,
+                .callback = create_args->callback,
+                .arg = create_args->arg,
+            };
+            *out_handle = &s_timers[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = true;
+    timer->due_us = s_now_us + (int64_t)timeout_us;
+    timer->period_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    esp_err_t err = esp_timer_start_once(timer, period);
+    timer->period_us = period;
+    return err;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    timer->active = false;
+    timer->created = false;
+    return ESP_OK;
+}
+
+uint32_t esp_random(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                       uint32_t priority, TaskHandle_t *out_handle)
+{
+    (void)fn;
+    (void)name;
+    (void)stack_bytes;
+    (void)arg;
+    (void)priority;
+    (void)out_handle;
+    return pdFALSE;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(uint32_t ticks)
+{
+    (void)ticks;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    (void)clear_on_exit;
+    (void)ticks;
+    return 1;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+    return pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    static int mutex;
+    return &mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem;
+    (void)ticks;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+bool esp_mesh_is_root(void)
+{
+    return is_mesh_root;
+}
+
+uint8_t esp_mesh_get_layer(void)
+{
+    return mesh_layer;
+}
+
+int esp_mesh_get_routing_table_size(void)
+{
+    return 1;
+}
+
+esp_err_t esp_mesh_get_routing_table(mesh_addr_t *mac, int len, int *size)
+{
+    (void)len;
+    memcpy(mac[0].addr, my_sta_mac, 6);
+    *size = 1;
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_set_group_id(const mesh_addr_t *addr, int num)
+{
+    (void)addr;
+    (void)num;
+    return ESP_OK;
+}
+
+// Replies (NACKs, pongs, heartbeats) leave through here; the counters see them.
+esp_err_t esp_mesh_send(const mesh_addr_t *to, const mesh_data_t *data, int flag,
+                        const mesh_opt_t opt[], int opt_count)
+{
+    (void)to;
+    (void)flag;
+    (void)opt;
+    (void)opt_count;
+    if (!data || data->size == 0 || data->size > MESH_RX_BUFFER_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_recv(mesh_addr_t *from, mesh_data_t *data, int timeout_ms, int *flag,
+                        mesh_opt_t opt[], int opt_count)
+{
+    (void)timeout_ms;
+    (void)opt;
+    (void)opt_count;
+    if (!s_pending.ready) {
+        return ESP_ERR_MESH_TIMEOUT;
+    }
+    s_pending.ready = false;
+    size_t len = s_pending.len < data->size ? s_pending.len : data->size;
+    memcpy(data->data, s_pending.data, len);
+    data->size = (uint16_t)len;
+    *from = s_pending.from;
+    *flag = s_pending.flag;
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_connect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_disconnect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_set_router(const mesh_router_t *router)
+{
+    (void)router;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    ap_info->rssi = -50;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t *sta_list)
+{
+    sta_list->num = 0;
+    return ESP_OK;
+}
+
+void portal_state_update_position(const uint8_t *mac, float x, float y, float z)
+{
+    (void)mac;
+    (void)x;
+    (void)y;
+    (void)z;
+}
+
+// --- Playout model ---
+
+static void playout_push(uint32_t frames)
+{
+    s_playout.depth += frames;
+    if (s_playout.depth > PCM_BUFFER_FRAMES) {
+        s_result->overflow_frames += s_playout.depth - PCM_BUFFER_FRAMES;
+        s_playout.depth = PCM_BUFFER_FRAMES;
+    }
+    if (s_playout.depth > s_result->depth_max) {
+        s_result->depth_max = s_playout.depth;
+    }
+}
+
+// OUT decode stage: same sequence_tracker limits as the firmware.
+static void replay_on_audio(const uint8_t *payload, size_t len, uint16_t seq, uint32_t timestamp, const char *src_id)
+{
+    (void)payload;
+    (void)len;
+    (void)timestamp;
+    (void)src_id;
+    s_result->frames++;
+
+    sequence_tracker_result_t r = sequence_tracker_update(s_playout.first, s_playout.last_seq, seq,
+                                                          RX_PLC_MAX_FRAMES_PER_GAP,
+                                                          RX_MAX_STALE_FRAMES_TO_DROP);
+    s_playout.first = false;
+    if (r.late_or_duplicate) {
+        s_result->late_frames++;
+        return;
+    }
+    if (r.hard_reset) {
+        s_result->hard_resets++;
+    }
+    if (r.dropped_frames > 0) {
+        s_result->gap_events++;
+        s_result->lost_frames += r.dropped_frames;
+        s_result->plc_frames += r.plc_frames_to_inject;
+        playout_push(r.plc_frames_to_inject);
+    }
+    s_playout.last_seq = r.last_seq;
+    playout_push(1);
+}
+
+// OUT playback stage: one frame per AUDIO_FRAME_MS once prefilled.
+static void playout_tick(void)
+{
+    if (s_playout.prefilling) {
+        if (s_playout.depth < s_result->prefill_frames) {
+            return;
+        }
+        s_playout.prefilling = false;
+    }
+    if (s_playout.depth > 0) {
+        s_playout.depth--;
+        s_result->played_frames++;
+        rx_underrun_reset(&s_playout.underrun);
+        return;
+    }
+    s_result->underruns++;
+    if (s_result->first_underrun_ms < 0) {
+        s_result->first_underrun_ms = (s_now_us - s_start_us) / 1000;
+    }
+    rx_underrun_action_t action = rx_underrun_on_miss(&s_playout.underrun);
+    if (action.force_rebuffer) {
+        s_result->rebuffers++;
+        s_playout.prefilling = true;
+        rx_underrun_reset(&s_playout.underrun);
+    }
+}
+
+static void replay_run_due_timers(void)
+{
+    for (;;) {
+        struct esp_timer *due = NULL;
+        for (int i = 0; i < REPLAY_MAX_TIMERS; i++) {
+            struct esp_timer *t = &s_timers[i];
+            if (t->active && t->due_us <= s_now_us && (!due || t->due_us < due->due_us)) {
+                due = t;
+            }
+        }
+        if (!due) {
+            return;
+        }
+        if (due->period_us > 0) {
+            due->due_us += (int64_t)due->period_us;
+        } else {
+            due->active = false;
+        }
+        due->callback(due->arg);
+    }
+}
+
+// Moves the clock to t_us, running playout ticks and timers on the way.
+static void replay_advance(int64_t t_us, int64_t *next_tick_us)
+{
+    while (*next_tick_us <= t_us) {
+        s_now_us = *next_tick_us;
+        replay_run_due_timers();
+        playout_tick();
+        *next_tick_us += REPLAY_FRAME_US;
+    }
+    s_now_us = t_us;
+    replay_run_due_timers();
+}
+
+// What mesh_init and the mesh events leave behind on a joined OUT node.
+static void replay_setup(const rx_replay_config_t *cfg, const network_rx_capture_reader_t *reader)
+{
+    static const uint8_t mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    static const uint8_t root_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    my_node_role = NODE_ROLE_OUT;
+    memcpy(my_sta_mac, mac, 6);
+    my_stream_id = 0x01;
+    snprintf(g_src_id, NETWORK_SRC_ID_LEN, "OUT_%02X%02X%02X", mac[3], mac[4], mac[5]);
+    is_mesh_root = false;
+    is_mesh_root_ready = true;
+    is_mesh_connected = true;
+    mesh_layer = cfg->layer ? cfg->layer : 1;
+    memcpy(mesh_parent_addr.addr, root_mac, 6);
+    mesh_addr_t root_addr;
+    memcpy(root_addr.addr, root_mac, 6);
+    mesh_state_set_root_addr(&root_addr);
+
+    mesh_dedupe_reset();
+    mesh_state_init();
+    mesh_mixer_init();
+    mesh_coalesce_init();
+    mesh_tx_init();
+    mesh_retx_cache_init();
+    network_transport_set(mesh_transport_backend());
+    network_register_audio_callback(replay_on_audio);
+
+    s_now_us = reader->arrival_us;
+    s_start_us = reader->arrival_us;
+    s_playout = (replay_playout_t){.first = true, .prefilling = true};
+    rx_underrun_reset(&s_playout.underrun);
+    s_result->prefill_frames = cfg->prefill_frames ? cfg->prefill_frames
+                                                   : network_get_jitter_prefill_frames();
+    s_result->first_underrun_ms = -1;
+}
+
+static void replay_child(const uint8_t *dump, size_t len, const rx_replay_config_t *cfg, rx_replay_result_t *out)
+{
+    static uint8_t packet[MESH_RX_BUFFER_SIZE];
+    network_rx_capture_reader_t reader;
+    network_rx_capture_record_t rec;
+    struct timespec t0, t1;
+
+    network_rx_capture_reader_init(&reader, dump, len);
+    s_result = out;
+    out->records = reader.records;
+    out->overwritten = reader.overwritten;
+    replay_setup(cfg, &reader);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int64_t next_tick_us = s_now_us + REPLAY_FRAME_US;
+    int64_t last_audio_us = -1;
+    while (network_rx_capture_next(&reader, &rec)) {
+        replay_advance(rec.arrival_us, &next_tick_us);
+        out->duration_us = rec.arrival_us - s_start_us;
+        if (rec.len < rec.orig_len || rec.len == 0 || rec.len > sizeof(packet)) {
+            out->truncated++;
+            continue;
+        }
+        if (rec.data[0] == NET_FRAME_MAGIC) {
+            out->audio_packets++;
+            if (last_audio_us >= 0) {
+                uint32_t gap_ms = (uint32_t)((rec.arrival_us - last_audio_us) / 1000);
+                if (gap_ms > out->max_audio_gap_ms) {
+                    out->max_audio_gap_ms = gap_ms;
+                }
+            }
+            last_audio_us = rec.arrival_us;
+        } else {
+            out->control_packets++;
+        }
+        // Dispatch edits the packet in place (TTL), so hand it a copy.
+        memcpy(packet, rec.data, rec.len);
+        mesh_addr_t from;
+        memcpy(from.addr, rec.from, 6);
+        mesh_rx_dispatch(&from, packet, rec.len);
+    }
+    // Play out whatever is still queued; the end of the capture is not an underrun.
+    while (s_playout.depth > 0 && !s_playout.prefilling) {
+        replay_advance(next_tick_us, &next_tick_us);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    out->wall_ns = (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000ULL + (uint64_t)t1.tv_nsec - (uint64_t)t0.tv_nsec;
+
+    network_transport_stats_t stats;
+    network_get_transport_stats(&stats);
+    out->duplicates = stats.rx_audio_duplicates;
+    out->invalid = stats.rx_audio_invalid_header + stats.rx_audio_invalid_version +
+                   stats.rx_audio_invalid_payload;
+    out->unanchored = stats.rx_audio_unanchored;
+    out->burst_loss_events = stats.rx_audio_burst_loss_events;
+    out->nacks_sent = stats.tx_nack_packets;
+    out->jitter_us = stats.rx_audio_interarrival_jitter_us;
+}
+
+bool rx_replay_run(const uint8_t *dump, size_t len, const rx_replay_config_t *cfg, rx_replay_result_t *out)
+{
+    network_rx_capture_reader_t reader;
+    int fds[2];
+
+    if (!cfg || !out || !network_rx_capture_reader_init(&reader, dump, len) || pipe(fds) != 0) {
+        return false;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        rx_replay_result_t res;
+        memset(&res, 0, sizeof(res));
+        replay_child(dump, len, cfg, &res);
+        ssize_t n = write(fds[1], &res, sizeof(res));
+        _exit(n == (ssize_t)sizeof(res) ? 0 : 1);
+    }
+    close(fds[1]);
+    size_t got = 0;
+    while (got < sizeof(*out)) {
+        ssize_t n = read(fds[0], (uint8_t *)out + got, sizeof(*out) - got);
+        if (n <= 0) {
+            break;
+        }
+        got += (size_t)n;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return got == sizeof(*out) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void rx_replay_print(const rx_replay_result_t *res)
+{
+    printf("rx-replay records=%lu (overwritten %lu, truncated %lu) span=%.1fs audio=%lu control=%lu max_gap=%lums\n",
+           (unsigned long)res->records, (unsigned long)res->overwritten, (unsigned long)res->truncated,
+           res->duration_us / 1e6, (unsigned long)res->audio_packets, (unsigned long)res->control_packets,
+           (unsigned long)res->max_audio_gap_ms);
+    printf("  transport: dup=%lu invalid=%lu unanchored=%lu burst_loss=%lu nacks=%lu jitter=%.1fms\n",
+           (unsigned long)res->duplicates, (unsigned long)res->invalid, (unsigned long)res->unanchored,
+           (unsigned long)res->burst_loss_events, (unsigned long)res->nacks_sent, res->jitter_us / 1000.0);
+    printf("  playout: prefill=%u frames=%lu late=%lu gaps=%lu lost=%lu plc=%lu resets=%lu overflow=%lu\n",
+           (unsigned)res->prefill_frames, (unsigned long)res->frames, (unsigned long)res->late_frames,
+           (unsigned long)res->gap_events, (unsigned long)res->lost_frames, (unsigned long)res->plc_frames,
+           (unsigned long)res->hard_resets, (unsigned long)res->overflow_frames);
+    printf("  played=%lu underruns=%lu rebuffers=%lu depth_max=%lu first_underrun=%lldms wall=%.2fms (%.2fus/pkt)\n",
+           (unsigned long)res->played_frames, (unsigned long)res->underruns, (unsigned long)res->rebuffers,
+           (unsigned long)res->depth_max, (long long)res->first_underrun_ms, res->wall_ns / 1e6,
+           res->records ? res->wall_ns / 1e3 / res->records : 0.0);
+}
+
+// --- Test helpers ---
+
+size_t rx_replay_build_audio(const rx_replay_audio_packet_t *pkt, uint8_t *out, size_t out_size)
+{
+    network_frame_builder_t builder;
+    if (!network_frame_builder_init(&builder, out, out_size, NET_FRAME_HEADER_SIZE_V2)) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < pkt->frames; i++) {
+        size_t capacity = 0;
+        uint8_t *slot = network_frame_builder_frame_slot(&builder, pkt->frame_bytes, &capacity);
+        if (!slot || capacity < pkt->frame_bytes) {
+            return 0;
+        }
+        memset(slot, (uint8_t)(pkt->seq + i), pkt->frame_bytes);
+        network_frame_builder_commit_frame(&builder, pkt->frame_bytes);
+    }
+    network_frame_info_t info = {
+        .version = NET_FRAME_VERSION_V2,
+        .type = NET_PKT_TYPE_AUDIO_OPUS,
+        .ttl = pkt->ttl,
+        .stream_id = pkt->stream_id,
+        .frame_count = pkt->frames,
+        .seq = pkt->seq,
+        .timestamp = pkt->timestamp_ms,
+        .payload_len = (uint16_t)network_frame_builder_payload_len(&builder),
+    };
+    if (network_frame_encode_header_v2(&info, out, out_size) == 0) {
+        return 0;
+    }
+    return builder.len;
+}
+
+size_t rx_replay_build_announce(const rx_replay_audio_packet_t *pkt, uint8_t *out, size_t out_size)
+{
+    mesh_stream_announce_t announce;
+    if (out_size < sizeof(announce)) {
+        return 0;
+    }
+    memset(&announce, 0, sizeof(announce));
+    announce.type = NET_PKT_TYPE_STREAM_ANNOUNCE;
+    announce.stream_id = pkt->stream_id;
+    announce.sample_rate = htonl(AUDIO_SAMPLE_RATE);
+    announce.channels = AUDIO_CHANNELS_MONO;
+    announce.frame_size_ms = htons(AUDIO_FRAME_MS);
+    strncpy(announce.src_id, "SRC_REPLAY", sizeof(announce.src_id));
+    announce.seq = htons(pkt->seq);
+    announce.timestamp = htonl(pkt->timestamp_ms);
+    memcpy(out, &announce, sizeof(announce));
+    return sizeof(announce);
+}
+
+bool rx_replay_transport_recv(const uint8_t from[6], int flag, const uint8_t *data, size_t len,
+                              int64_t now_us)
+{
+    if (len > sizeof(s_pending.data)) {
+        return false;
+    }
+    s_now_us = now_us;
+    memcpy(s_pending.from.addr, from, 6);
+    s_pending.flag = flag;
+    s_pending.len = len;
+    memcpy(s_pending.data, data, len);
+    s_pending.ready = true;
+
+    static uint8_t buf[MESH_RX_BUFFER_SIZE];
+    network_node_addr_t node;
+    size_t rx_len = sizeof(buf);
+    const network_transport_t *transport = mesh_transport_backend();
+    esp_err_t err = transport->ops->recv(transport->ctx, &node, buf, &rx_len, 0);
+    return err == ESP_OK && rx_len == len && memcmp(buf, data, len) == 0 && memcmp(node.addr, from, 6) == 0;
+}
+
+typedef struct {
+    uint8_t *out;
+    size_t size;
+    size_t len;
+} replay_dump_buf_t;
+
+static bool replay_dump_write(void *ctx, const uint8_t *data, size_t len)
+{
+    replay_dump_buf_t *buf = (replay_dump_buf_t *)ctx;
+    if (buf->size - buf->len < len) {
+        return false;
+    }
+    memcpy(buf->out + buf->len, data, len);
+    buf->len += len;
+    return true;
+}
+
+size_t rx_replay_dump_firmware_ring(uint8_t *out, size_t out_size)
+{
+    replay_dump_buf_t buf = {.out = out, .size = out_size, .len = 0};
+    return network_rx_capture_dump(&s_capture, replay_dump_write, &buf) ? buf.len : 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "config/build.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Host replay of an RX capture dump (network/rx_capture.h). Every record is
+// handed to the real mesh_rx_dispatch (frame_codec, dedupe, TTL, NACK requests,
+// control handling) at its original arrival time on a simulated clock. Audio
+// frames then enter a playout model built from the OUT pipeline's own pieces:
+// sequence_tracker for late/gap/PLC decisions, a PCM queue capped at
+// PCM_BUFFER_FRAMES, prefill from network_get_jitter_prefill_frames() and
+// rx_underrun_on_miss() for concealment and rebuffering, drained one frame
+// every AUDIO_FRAME_MS.
+//
+// Each run happens in a forked child so module state (dedupe cache, stream
+// anchors, counters) starts fresh and the same dump always gives the same result.
+
+typedef struct {
+    uint8_t layer;              // mesh_layer the node sat at (feeds the auto prefill)
+    uint8_t prefill_frames;     // 0 = network_get_jitter_prefill_frames()
+} rx_replay_config_t;
+
+#define RX_REPLAY_CONFIG_DEFAULT() { \
+    .layer = 1,                      \
+    .prefill_frames = 0,             \
+}
+
+typedef struct {
+    uint32_t records;
+    uint32_t overwritten;       // Records the ring lost before the dump
+    uint32_t truncated;         // Snapped records, skipped
+    int64_t duration_us;        // First to last arrival
+    uint32_t audio_packets;
+    uint32_t control_packets;
+    uint32_t max_audio_gap_ms;  // Longest silence between audio packets
+    // Transport layer, from the RX counters
+    uint32_t duplicates;
+    uint32_t invalid;           // Bad header/version/payload
+    uint32_t unanchored;        // v2 audio ahead of its stream announce
+    uint32_t burst_loss_events;
+    uint32_t nacks_sent;
+    uint32_t jitter_us;         // Smoothed interarrival jitter at the end
+    // Playout model
+    uint8_t prefill_frames;
+    uint32_t frames;            // Handed to the audio callback
+    uint32_t late_frames;
+    uint32_t gap_events;
+    uint32_t lost_frames;
+    uint32_t plc_frames;
+    uint32_t hard_resets;
+    uint32_t overflow_frames;   // Dropped at PCM_BUFFER_FRAMES
+    uint32_t played_frames;
+    uint32_t underruns;         // Playout ticks with nothing queued
+    uint32_t rebuffers;
+    uint32_t depth_max;
+    int64_t first_underrun_ms;  // From the first record, -1 when none
+    uint64_t wall_ns;           // Host time spent replaying, for profiling
+} rx_replay_result_t;
+
+// False when the dump does not parse or the child fails.
+bool rx_replay_run(const uint8_t *dump, size_t len, const rx_replay_config_t *cfg, rx_replay_result_t *out);
+void rx_replay_print(const rx_replay_result_t *res);
+
+// Synthetic captures for the tests: audio packets built with frame_codec as a
+// SRC would send them.
+typedef struct {
+    uint16_t seq;
+    uint32_t timestamp_ms;
+    uint8_t frames;
+    uint16_t frame_bytes;
+    uint8_t ttl;
+    uint8_t stream_id;
+} rx_replay_audio_packet_t;
+
+size_t rx_replay_build_audio(const rx_replay_audio_packet_t *pkt, uint8_t *out, size_t out_size);
+// The STREAM_ANNOUNCE that anchors pkt's stream at pkt's seq/timestamp.
+size_t rx_replay_build_announce(const rx_replay_audio_packet_t *pkt, uint8_t *out, size_t out_size);
+
+// The transport hook: queues one packet for the next esp_mesh_recv, receives
+// it through mesh_transport's recv (so mesh_capture sees it) and returns what
+// the transport delivered. Used to check capture from the real RX entry point.
+bool rx_replay_transport_recv(const uint8_t from[6], int flag, const uint8_t *data, size_t len,
+                              int64_t now_us);
+// Dumps the firmware capture ring (mesh_capture) into out; returns the length.
+size_t rx_replay_dump_firmware_ring(uint8_t *out, size_t out_size);
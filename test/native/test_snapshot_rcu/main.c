@@ -0,0 +1,150 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "control/snapshot_rcu.h"
+
+#include "../../../lib/control/src/snapshot_rcu.c"
+
+typedef struct {
+    uint32_t generation;
+    uint32_t payload[8];
+} test_snapshot_t;
+
+static test_snapshot_t s_slots[SNAPSHOT_RCU_SLOTS];
+static snapshot_rcu_t s_rcu;
+
+static uint32_t publish(uint32_t value)
+{
+    test_snapshot_t *slot = snapshot_rcu_write_begin(&s_rcu);
+    if (!slot) {
+        return 0;
+    }
+    slot->generation = snapshot_rcu_generation(&s_rcu) + 1;
+    for (size_t i = 0; i < 8; i++) {
+        slot->payload[i] = value;
+    }
+    return snapshot_rcu_write_commit(&s_rcu);
+}
+
+static const test_snapshot_t *acquire(void)
+{
+    return (const test_snapshot_t *)snapshot_rcu_acquire(&s_rcu);
+}
+
+void setUp(void)
+{
+    memset(s_slots, 0, sizeof(s_slots));
+    snapshot_rcu_init(&s_rcu, s_slots, sizeof(s_slots[0]));
+}
+
+void tearDown(void) {}
+
+static void test_nothing_to_read_before_first_publish(void)
+{
+    TEST_ASSERT_NULL(acquire());
+    TEST_ASSERT_EQUAL_UINT32(0, snapshot_rcu_generation(&s_rcu));
+    snapshot_rcu_release(&s_rcu, NULL);
+}
+
+static void test_generation_counts_publications(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1, publish(10));
+    TEST_ASSERT_EQUAL_UINT32(2, publish(20));
+    TEST_ASSERT_EQUAL_UINT32(3, publish(30));
+
+    const test_snapshot_t *t = acquire();
+    TEST_ASSERT_NOT_NULL(t);
+    TEST_ASSERT_EQUAL_UINT32(3, t->generation);
+    TEST_ASSERT_EQUAL_UINT32(30, t->payload[7]);
+    snapshot_rcu_release(&s_rcu, t);
+}
+
+static void test_held_snapshot_is_never_rewritten(void)
+{
+    publish(1);
+    const test_snapshot_t *held = acquire();
+    TEST_ASSERT_NOT_NULL(held);
+
+    // Many publications later the held copy still reads as it did.
+    for (uint32_t v = 2; v < 50; v++) {
+        TEST_ASSERT_TRUE(publish(v) > 0);
+        for (size_t i = 0; i < 8; i++) {
+            TEST_ASSERT_EQUAL_UINT32(1, held->payload[i]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, held->generation);
+
+    const test_snapshot_t *latest = acquire();
+    TEST_ASSERT_EQUAL_UINT32(49, latest->payload[0]);
+    TEST_ASSERT_TRUE(latest != held);
+    snapshot_rcu_release(&s_rcu, latest);
+    snapshot_rcu_release(&s_rcu, held);
+    TEST_ASSERT_EQUAL_UINT32(0, s_rcu.skipped);
+}
+
+static void test_writer_skips_when_every_spare_slot_is_held(void)
+{
+    publish(1);
+    const test_snapshot_t *a = acquire();
+    publish(2);
+    const test_snapshot_t *b = acquire();
+    publish(3);
+    const test_snapshot_t *c = acquire();
+
+    // All three slots are referenced: the writer gives up instead of waiting.
+    TEST_ASSERT_NULL(snapshot_rcu_write_begin(&s_rcu));
+    TEST_ASSERT_EQUAL_UINT32(1, s_rcu.skipped);
+    TEST_ASSERT_EQUAL_UINT32(3, snapshot_rcu_write_commit(&s_rcu));
+    TEST_ASSERT_EQUAL_UINT32(1, a->payload[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, b->payload[0]);
+
+    // Releasing a non-current slot frees it for the next publication.
+    snapshot_rcu_release(&s_rcu, a);
+    TEST_ASSERT_EQUAL_UINT32(4, publish(4));
+    TEST_ASSERT_EQUAL_UINT32(2, b->payload[0]);
+    TEST_ASSERT_EQUAL_UINT32(3, c->payload[0]);
+
+    snapshot_rcu_release(&s_rcu, b);
+    snapshot_rcu_release(&s_rcu, c);
+}
+
+static void test_current_slot_is_not_handed_to_writer(void)
+{
+    publish(1);
+    int current = atomic_load(&s_rcu.current);
+    for (int i = 0; i < 10; i++) {
+        test_snapshot_t *slot = snapshot_rcu_write_begin(&s_rcu);
+        TEST_ASSERT_NOT_NULL(slot);
+        TEST_ASSERT_TRUE(slot != &s_slots[current]);
+        snapshot_rcu_write_commit(&s_rcu);
+        current = atomic_load(&s_rcu.current);
+    }
+}
+
+static void test_reader_counts_return_to_zero(void)
+{
+    publish(1);
+    const test_snapshot_t *x = acquire();
+    const test_snapshot_t *y = acquire();
+    TEST_ASSERT_TRUE(x == y);
+    int slot = atomic_load(&s_rcu.current);
+    TEST_ASSERT_EQUAL_UINT32(2, atomic_load(&s_rcu.readers[slot]));
+    snapshot_rcu_release(&s_rcu, x);
+    snapshot_rcu_release(&s_rcu, y);
+    for (int i = 0; i < SNAPSHOT_RCU_SLOTS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&s_rcu.readers[i]));
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_to_read_before_first_publish);
+    RUN_TEST(test_generation_counts_publications);
+    RUN_TEST(test_held_snapshot_is_never_rewritten);
+    RUN_TEST(test_writer_skips_when_every_spare_slot_is_held);
+    RUN_TEST(test_current_slot_is_not_handed_to_writer);
+    RUN_TEST(test_reader_counts_return_to_zero);
+    return UNITY_END();
+}
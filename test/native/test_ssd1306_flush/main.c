@@ -0,0 +1,156 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "control/ssd1306_flush.h"
+
+#include "../../../lib/control/src/ssd1306_flush.c"
+
+// 128x32 panel, as fitted.
+#define WIDTH       128
+#define PAGES       4
+#define I2C_ADDR_BYTES 1            // Address byte on the wire per transaction
+
+// Old per-page cost: six single-command transactions (control + command) and
+// one data transaction (control + 128 bytes), each with its address byte.
+#define LEGACY_PAGE_BYTES (6 * (I2C_ADDR_BYTES + 2) + I2C_ADDR_BYTES + 1 + WIDTH)
+
+typedef struct {
+    int transactions;
+    size_t bytes;                   // Including address bytes
+    int fail_next;                  // Transactions left to fail
+    uint8_t last[SSD1306_FLUSH_HEADER_BYTES + WIDTH];
+    size_t last_len;
+} mock_i2c_t;
+
+static ssd1306_flush_t s_flush;
+static uint8_t s_fb[WIDTH * PAGES];
+static mock_i2c_t s_bus;
+
+static bool mock_write(void *ctx, const uint8_t *data, size_t len)
+{
+    mock_i2c_t *bus = (mock_i2c_t *)ctx;
+    if (bus->fail_next > 0) {
+        bus->fail_next--;
+        return false;
+    }
+    bus->transactions++;
+    bus->bytes += I2C_ADDR_BYTES + len;
+    memcpy(bus->last, data, len);
+    bus->last_len = len;
+    return true;
+}
+
+static int flush_frame(void)
+{
+    memset(&s_bus, 0, sizeof(s_bus));
+    return ssd1306_flush(&s_flush, s_fb, mock_write, &s_bus);
+}
+
+static void draw_text_row(uint8_t page, uint8_t x, uint8_t chars, uint8_t seed)
+{
+    for (uint8_t i = 0; i < chars * 6; i++) {
+        s_fb[page * WIDTH + x + i] = (uint8_t)(seed * 31 + i * 7 + 1);
+    }
+}
+
+void setUp(void)
+{
+    memset(s_fb, 0, sizeof(s_fb));
+    ssd1306_flush_init(&s_flush, WIDTH, PAGES);
+}
+
+void tearDown(void) {}
+
+static void test_first_frame_sends_each_page_in_one_transaction(void)
+{
+    TEST_ASSERT_EQUAL_INT(PAGES, flush_frame());
+    TEST_ASSERT_EQUAL_INT(PAGES, s_bus.transactions);
+    TEST_ASSERT_EQUAL_UINT32(PAGES * (I2C_ADDR_BYTES + SSD1306_FLUSH_HEADER_BYTES + WIDTH), s_bus.bytes);
+
+    const uint8_t header[SSD1306_FLUSH_HEADER_BYTES] = {
+        0x80, 0x21, 0x80, 0, 0x80, WIDTH - 1,
+        0x80, 0x22, 0x80, PAGES - 1, 0x80, PAGES - 1,
+        0x40,
+    };
+    TEST_ASSERT_EQUAL_UINT32(SSD1306_FLUSH_HEADER_BYTES + WIDTH, s_bus.last_len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(header, s_bus.last, sizeof(header));
+}
+
+static void test_unchanged_frame_sends_nothing(void)
+{
+    draw_text_row(0, 0, 10, 1);
+    flush_frame();
+    TEST_ASSERT_EQUAL_INT(0, flush_frame());
+    TEST_ASSERT_EQUAL_UINT32(0, s_bus.bytes);
+}
+
+static void test_changed_columns_are_trimmed(void)
+{
+    flush_frame();
+    s_fb[2 * WIDTH + 40] = 0x7F;
+    s_fb[2 * WIDTH + 44] = 0x41;
+
+    TEST_ASSERT_EQUAL_INT(1, flush_frame());
+    TEST_ASSERT_EQUAL_INT(1, s_bus.transactions);
+    TEST_ASSERT_EQUAL_UINT32(SSD1306_FLUSH_HEADER_BYTES + 5, s_bus.last_len);
+    TEST_ASSERT_EQUAL_UINT8(40, s_bus.last[3]);
+    TEST_ASSERT_EQUAL_UINT8(44, s_bus.last[5]);
+    TEST_ASSERT_EQUAL_UINT8(2, s_bus.last[9]);
+    TEST_ASSERT_EQUAL_UINT8(0x7F, s_bus.last[SSD1306_FLUSH_HEADER_BYTES]);
+    TEST_ASSERT_EQUAL_UINT8(0x41, s_bus.last[SSD1306_FLUSH_HEADER_BYTES + 4]);
+}
+
+static void test_failed_page_is_resent_whole(void)
+{
+    flush_frame();
+    s_fb[1 * WIDTH + 10] = 0xFF;
+    s_bus.fail_next = 1;
+    TEST_ASSERT_EQUAL_INT(0, ssd1306_flush(&s_flush, s_fb, mock_write, &s_bus));
+
+    // What reached the panel is unknown, so the retry covers the full page.
+    TEST_ASSERT_EQUAL_INT(1, flush_frame());
+    TEST_ASSERT_EQUAL_UINT32(SSD1306_FLUSH_HEADER_BYTES + WIDTH, s_bus.last_len);
+    TEST_ASSERT_EQUAL_INT(0, flush_frame());
+}
+
+static void test_invalidate_repaints_everything(void)
+{
+    draw_text_row(3, 0, 21, 4);
+    flush_frame();
+    ssd1306_flush_invalidate(&s_flush);
+    TEST_ASSERT_EQUAL_INT(PAGES, flush_frame());
+}
+
+// A status screen ticking once a second: an uptime counter changes a few
+// characters on one row, the other rows stay put.
+static void test_status_frame_costs_a_fraction_of_a_full_push(void)
+{
+    for (uint8_t page = 0; page < PAGES; page++) {
+        draw_text_row(page, 0, 18, page);
+    }
+    flush_frame();
+
+    size_t total = 0;
+    for (int frame = 0; frame < 10; frame++) {
+        draw_text_row(1, 13 * 6, 3, (uint8_t)(frame + 10));
+        flush_frame();
+        TEST_ASSERT_EQUAL_INT(1, s_bus.transactions);
+        total += s_bus.bytes;
+    }
+    size_t per_frame = total / 10;
+    TEST_ASSERT_EQUAL_UINT32(I2C_ADDR_BYTES + SSD1306_FLUSH_HEADER_BYTES + 3 * 6, per_frame);
+    TEST_ASSERT_TRUE(per_frame * 10 < (size_t)PAGES * LEGACY_PAGE_BYTES);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_sends_each_page_in_one_transaction);
+    RUN_TEST(test_unchanged_frame_sends_nothing);
+    RUN_TEST(test_changed_columns_are_trimmed);
+    RUN_TEST(test_failed_page_is_resent_whole);
+    RUN_TEST(test_invalidate_repaints_everything);
+    RUN_TEST(test_status_frame_costs_a_fraction_of_a_full_push);
+    return UNITY_END();
+}
@@ -0,0 +1,215 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "network/stat_counters.h"
+
+#include "../../../lib/network/src/stat_counters.c"
+
+typedef struct {
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t peak;
+    uint32_t level;
+} test_stats_t;
+
+#define TEST_WORDS NETWORK_STAT_WORDS(test_stats_t)
+#define W(field) NETWORK_STAT_WORD(test_stats_t, field)
+
+static _Atomic uint32_t words[STAT_COUNTER_SHARDS * TEST_WORDS];
+static uint32_t baseline[TEST_WORDS];
+static const uint16_t gauges[] = { W(peak), W(level) };
+static network_stat_counters_t counters;
+
+static int writer_a;
+static int writer_b;
+
+void setUp(void)
+{
+    network_stat_counters_init(&counters, words, baseline, TEST_WORDS, gauges, 2);
+}
+
+void tearDown(void)
+{
+}
+
+void test_writers_claim_distinct_shards(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    network_stat_shard_t *b = network_stat_shard(&counters, &writer_b);
+
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_TRUE(a != b);
+    TEST_ASSERT_TRUE(a == network_stat_shard(&counters, &writer_a));
+    TEST_ASSERT_TRUE(network_stat_shard(&counters, NULL) == &counters.shards[STAT_COUNTER_SHARDS - 1]);
+}
+
+void test_extra_writers_share_the_last_shard(void)
+{
+    int owners[STAT_COUNTER_SHARDS + 2];
+    network_stat_shard_t *shared = &counters.shards[STAT_COUNTER_SHARDS - 1];
+
+    for (int i = 0; i < STAT_COUNTER_SHARDS - 1; i++) {
+        TEST_ASSERT_TRUE(network_stat_shard(&counters, &owners[i]) != shared);
+    }
+    TEST_ASSERT_TRUE(network_stat_shard(&counters, &owners[STAT_COUNTER_SHARDS - 1]) == shared);
+    TEST_ASSERT_TRUE(network_stat_shard(&counters, &owners[STAT_COUNTER_SHARDS]) == shared);
+
+    network_stat_add(&counters, shared, W(packets), 2);
+    network_stat_add(&counters, network_stat_shard(&counters, &owners[0]), W(packets), 3);
+    TEST_ASSERT_EQUAL_UINT32(5, network_stat_read(&counters, W(packets)));
+}
+
+void test_snapshot_sums_counters_across_shards(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    network_stat_shard_t *b = network_stat_shard(&counters, &writer_b);
+    test_stats_t snap;
+
+    network_stat_add(&counters, a, W(packets), 1);
+    network_stat_add(&counters, a, W(bytes), 100);
+    network_stat_add(&counters, b, W(packets), 2);
+    network_stat_add(&counters, b, W(bytes), 250);
+    network_stat_snapshot(&counters, (uint32_t *)&snap);
+
+    TEST_ASSERT_EQUAL_UINT32(3, snap.packets);
+    TEST_ASSERT_EQUAL_UINT32(350, snap.bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.peak);
+}
+
+void test_gauges_merge_as_max_and_set_overwrites(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    network_stat_shard_t *b = network_stat_shard(&counters, &writer_b);
+    test_stats_t snap;
+
+    network_stat_max(&counters, a, W(peak), 7);
+    network_stat_max(&counters, a, W(peak), 3);
+    network_stat_max(&counters, b, W(peak), 5);
+    network_stat_set(&counters, a, W(level), 9);
+    network_stat_set(&counters, a, W(level), 2);
+    network_stat_set(&counters, b, W(level), 1);
+    network_stat_snapshot(&counters, (uint32_t *)&snap);
+
+    TEST_ASSERT_EQUAL_UINT32(7, snap.peak);
+    TEST_ASSERT_EQUAL_UINT32(2, snap.level);
+    TEST_ASSERT_EQUAL_UINT32(7, network_stat_read(&counters, W(peak)));
+}
+
+void test_reset_rebaselines_counters_and_hides_stale_gauges(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    test_stats_t snap;
+
+    network_stat_add(&counters, a, W(packets), 10);
+    network_stat_max(&counters, a, W(peak), 8);
+    network_stat_snapshot_and_reset(&counters, (uint32_t *)&snap);
+    TEST_ASSERT_EQUAL_UINT32(10, snap.packets);
+    TEST_ASSERT_EQUAL_UINT32(8, snap.peak);
+
+    network_stat_snapshot(&counters, (uint32_t *)&snap);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.packets);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.peak);
+
+    // The writer's next update clears its stale gauges before applying.
+    network_stat_add(&counters, a, W(packets), 4);
+    network_stat_max(&counters, a, W(peak), 2);
+    network_stat_snapshot(&counters, (uint32_t *)&snap);
+    TEST_ASSERT_EQUAL_UINT32(4, snap.packets);
+    TEST_ASSERT_EQUAL_UINT32(2, snap.peak);
+
+    // Totals are not affected by resets.
+    uint32_t totals[TEST_WORDS];
+    network_stat_totals(&counters, totals);
+    TEST_ASSERT_EQUAL_UINT32(14, totals[W(packets)]);
+}
+
+void test_counters_wrap_modulo_32_bits_across_reset(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    test_stats_t snap;
+
+    network_stat_add(&counters, a, W(bytes), 0xFFFFFFF0u);
+    network_stat_snapshot_and_reset(&counters, (uint32_t *)&snap);
+    network_stat_add(&counters, a, W(bytes), 0x20);
+    network_stat_snapshot(&counters, (uint32_t *)&snap);
+    TEST_ASSERT_EQUAL_UINT32(0x20, snap.bytes);
+}
+
+void test_reader_does_not_spin_on_writer_mid_update(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    test_stats_t snap;
+
+    network_stat_add(&counters, a, W(packets), 6);
+    // Simulate the owner preempted inside its update (sequence left odd).
+    atomic_fetch_add(&a->seq, 1);
+    network_stat_snapshot(&counters, (uint32_t *)&snap);
+    TEST_ASSERT_EQUAL_UINT32(6, snap.packets);
+    TEST_ASSERT_TRUE(atomic_load(&a->seq) & 1u);
+}
+
+void test_invalid_arguments_are_ignored(void)
+{
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+
+    network_stat_add(&counters, a, TEST_WORDS, 1);
+    network_stat_add(&counters, NULL, W(packets), 1);
+    network_stat_add(NULL, a, W(packets), 1);
+    TEST_ASSERT_EQUAL_UINT32(0, network_stat_read(&counters, W(packets)));
+    TEST_ASSERT_EQUAL_UINT32(0, network_stat_read(&counters, TEST_WORDS));
+    TEST_ASSERT_NULL(network_stat_shard(NULL, &writer_a));
+}
+
+void test_rates_need_two_samples_then_track_per_second(void)
+{
+    uint32_t last[TEST_WORDS];
+    network_stat_rate_t values[TEST_WORDS];
+    network_stat_rates_t rates = NETWORK_STAT_RATES_INITIALIZER(last, values, TEST_WORDS);
+    network_stat_shard_t *a = network_stat_shard(&counters, &writer_a);
+    uint32_t totals[TEST_WORDS];
+    network_stat_rate_t rate;
+
+    network_stat_totals(&counters, totals);
+    network_stat_rates_update(&rates, totals, 0);
+    TEST_ASSERT_FALSE(network_stat_rates_get(&rates, W(packets), &rate));
+
+    network_stat_add(&counters, a, W(packets), 50);
+    network_stat_totals(&counters, totals);
+    network_stat_rates_update(&rates, totals, 500000);
+    TEST_ASSERT_TRUE(network_stat_rates_get(&rates, W(packets), &rate));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, rate.per_sec_1s);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, rate.per_sec_10s);
+
+    // Steady input converges the long windows toward the instant rate.
+    for (int i = 2; i <= 240; i++) {
+        network_stat_add(&counters, a, W(packets), 20);
+        network_stat_totals(&counters, totals);
+        network_stat_rates_update(&rates, totals, (int64_t)i * 1000000);
+    }
+    network_stat_rates_get(&rates, W(packets), &rate);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, rate.per_sec_1s);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 20.0f, rate.per_sec_10s);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 20.0f, rate.per_sec_60s);
+
+    // A stale or repeated timestamp is ignored.
+    network_stat_rates_update(&rates, totals, 240000000);
+    network_stat_rates_get(&rates, W(packets), &rate);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, rate.per_sec_1s);
+    TEST_ASSERT_FALSE(network_stat_rates_get(&rates, TEST_WORDS, &rate));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_writers_claim_distinct_shards);
+    RUN_TEST(test_extra_writers_share_the_last_shard);
+    RUN_TEST(test_snapshot_sums_counters_across_shards);
+    RUN_TEST(test_gauges_merge_as_max_and_set_overwrites);
+    RUN_TEST(test_reset_rebaselines_counters_and_hides_stale_gauges);
+    RUN_TEST(test_counters_wrap_modulo_32_bits_across_reset);
+    RUN_TEST(test_reader_does_not_spin_on_writer_mid_update);
+    RUN_TEST(test_invalid_arguments_are_ignored);
+    RUN_TEST(test_rates_need_two_samples_then_track_per_second);
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "network/transport.h"
+#include "transport_udp.h"
+
+#include "../../../lib/network/src/transport.c"
+#include "../shared/transport_udp.c"
+
+static network_transport_udp_t root;
+static network_transport_udp_t child_a;
+static network_transport_udp_t child_b;
+
+static const network_node_addr_t root_node = { { 0x02, 0, 0, 0, 0, 0x01 } };
+static const network_node_addr_t node_a = { { 0x02, 0, 0, 0, 0, 0x0A } };
+static const network_node_addr_t node_b = { { 0x02, 0, 0, 0, 0, 0x0B } };
+
+static void open_root(void)
+{
+    network_transport_udp_config_t cfg = { .self = root_node, .is_root = true, .bind_port = 0 };
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_udp_open(&root, &cfg));
+    TEST_ASSERT_TRUE(network_transport_udp_port(&root) != 0);
+}
+
+static void open_child(network_transport_udp_t *child, const network_node_addr_t *self)
+{
+    network_transport_udp_config_t cfg = {
+        .self = *self,
+        .root_host = "127.0.0.1",
+        .root_port = network_transport_udp_port(&root),
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_udp_open(child, &cfg));
+}
+
+static esp_err_t recv_on(network_transport_udp_t *udp, network_node_addr_t *from,
+                         uint8_t *buf, size_t *len, uint32_t timeout_ms)
+{
+    network_transport_set(network_transport_udp(udp));
+    return network_transport_recv(from, buf, len, timeout_ms);
+}
+
+// The root only learns a child while receiving; drain the announces.
+static void root_learn_children(void)
+{
+    network_node_addr_t from;
+    uint8_t buf[16];
+    size_t len = sizeof(buf);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, recv_on(&root, &from, buf, &len, 20));
+}
+
+void setUp(void)
+{
+    network_transport_set(NULL);
+    child_a.fd = -1;
+    child_b.fd = -1;
+    open_root();
+}
+
+void tearDown(void)
+{
+    network_transport_udp_close(&child_b);
+    network_transport_udp_close(&child_a);
+    network_transport_udp_close(&root);
+    network_transport_set(NULL);
+}
+
+void test_calls_without_backend_are_rejected(void)
+{
+    network_node_addr_t nodes[4];
+    bool is_root = true;
+    uint8_t byte = 1;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, network_transport_send_audio(NULL, &byte, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, network_transport_send_control(NULL, &byte, 1));
+    TEST_ASSERT_EQUAL(0, network_transport_topology(nodes, 4, &is_root));
+    TEST_ASSERT_FALSE(is_root);
+}
+
+void test_children_announce_and_appear_in_root_topology(void)
+{
+    network_node_addr_t nodes[4];
+    bool is_root = false;
+
+    open_child(&child_a, &node_a);
+    open_child(&child_b, &node_b);
+    root_learn_children();
+
+    network_transport_set(network_transport_udp(&root));
+    TEST_ASSERT_EQUAL(3, network_transport_topology(nodes, 4, &is_root));
+    TEST_ASSERT_TRUE(is_root);
+    TEST_ASSERT_EQUAL_MEMORY(root_node.addr, nodes[0].addr, 6);
+    TEST_ASSERT_EQUAL_MEMORY(node_a.addr, nodes[1].addr, 6);
+    TEST_ASSERT_EQUAL_MEMORY(node_b.addr, nodes[2].addr, 6);
+
+    network_transport_set(network_transport_udp(&child_a));
+    TEST_ASSERT_EQUAL(1, network_transport_topology(nodes, 4, &is_root));
+    TEST_ASSERT_FALSE(is_root);
+}
+
+void test_root_audio_fans_out_to_every_child(void)
+{
+    const uint8_t frame[] = { 0xA5, 0x02, 0x10, 0x20, 0x30 };
+    network_node_addr_t from;
+    uint8_t buf[64];
+    size_t len;
+
+    open_child(&child_a, &node_a);
+    open_child(&child_b, &node_b);
+    root_learn_children();
+
+    network_transport_set(network_transport_udp(&root));
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_send_audio(NULL, frame, sizeof(frame)));
+
+    network_transport_udp_t *children[] = { &child_a, &child_b };
+    for (int i = 0; i < 2; i++) {
+        len = sizeof(buf);
+        TEST_ASSERT_EQUAL(ESP_OK, recv_on(children[i], &from, buf, &len, 200));
+        TEST_ASSERT_EQUAL(sizeof(frame), len);
+        TEST_ASSERT_EQUAL_MEMORY(frame, buf, sizeof(frame));
+        TEST_ASSERT_EQUAL_MEMORY(root_node.addr, from.addr, 6);
+    }
+}
+
+void test_child_uplink_and_directed_control(void)
+{
+    const uint8_t ctrl[] = { 0x07, 0x01 };
+    const uint8_t reply[] = { 0x08 };
+    network_node_addr_t from;
+    uint8_t buf[64];
+    size_t len;
+
+    open_child(&child_a, &node_a);
+    open_child(&child_b, &node_b);
+    root_learn_children();
+
+    network_transport_set(network_transport_udp(&child_a));
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_send_control(NULL, ctrl, sizeof(ctrl)));
+    len = sizeof(buf);
+    TEST_ASSERT_EQUAL(ESP_OK, recv_on(&root, &from, buf, &len, 200));
+    TEST_ASSERT_EQUAL(sizeof(ctrl), len);
+    TEST_ASSERT_EQUAL_MEMORY(node_a.addr, from.addr, 6);
+
+    // Reply to the sender only.
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_send_control(&from, reply, sizeof(reply)));
+    len = sizeof(buf);
+    TEST_ASSERT_EQUAL(ESP_OK, recv_on(&child_a, &from, buf, &len, 200));
+    TEST_ASSERT_EQUAL(1, len);
+    TEST_ASSERT_EQUAL_HEX8(0x08, buf[0]);
+    len = sizeof(buf);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, recv_on(&child_b, &from, buf, &len, 20));
+
+    // Child a has learned the root's address and can address it explicitly.
+    network_transport_set(network_transport_udp(&child_a));
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_send_control(&root_node, ctrl, sizeof(ctrl)));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, network_transport_send_control(&node_b, ctrl, sizeof(ctrl)));
+}
+
+void test_unknown_destinations_and_empty_fanout(void)
+{
+    const uint8_t byte = 0x01;
+
+    network_transport_set(network_transport_udp(&root));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, network_transport_send_audio(NULL, &byte, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, network_transport_send_audio(&node_a, &byte, 1));
+}
+
+void test_oversized_datagram_is_reported_not_truncated(void)
+{
+    uint8_t big[64];
+    network_node_addr_t from;
+    uint8_t buf[8];
+    size_t len = sizeof(buf);
+
+    memset(big, 0x5A, sizeof(big));
+    open_child(&child_a, &node_a);
+    network_transport_set(network_transport_udp(&child_a));
+    TEST_ASSERT_EQUAL(ESP_OK, network_transport_send_audio(NULL, big, sizeof(big)));
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, recv_on(&root, &from, buf, &len, 200));
+    TEST_ASSERT_EQUAL(sizeof(buf), len);
+}
+
+void test_foreign_datagrams_are_ignored(void)
+{
+    network_node_addr_t from;
+    uint8_t buf[16];
+    size_t len = sizeof(buf);
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in to = {
+        .sin_family = AF_INET,
+        .sin_port = htons(network_transport_udp_port(&root)),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    const char junk[] = "not-a-node";
+    sendto(fd, junk, sizeof(junk), 0, (struct sockaddr *)&to, sizeof(to));
+    close(fd);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, recv_on(&root, &from, buf, &len, 50));
+    TEST_ASSERT_EQUAL_UINT32(1, root.rx_invalid);
+    TEST_ASSERT_EQUAL(0, root.peer_count);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_calls_without_backend_are_rejected);
+    RUN_TEST(test_children_announce_and_appear_in_root_topology);
+    RUN_TEST(test_root_audio_fans_out_to_every_child);
+    RUN_TEST(test_child_uplink_and_directed_control);
+    RUN_TEST(test_unknown_destinations_and_empty_fanout);
+    RUN_TEST(test_oversized_datagram_is_reported_not_truncated);
+    RUN_TEST(test_foreign_datagrams_are_ignored);
+    return UNITY_END();
+}
@@ -0,0 +1,75 @@
+#include <string.h>
+
+#include <unity.h>
+
+#include "udp_loopback.h"
+
+static udp_loopback_result_t result;
+
+static void run(const udp_loopback_config_t *cfg)
+{
+    TEST_ASSERT_TRUE(udp_loopback_run(cfg, &result));
+    udp_loopback_print(cfg, &result);
+    TEST_ASSERT_EQUAL_UINT32(cfg->frames, result.frames_sent);
+    TEST_ASSERT_EQUAL_UINT32(0, result.frames_corrupt);
+}
+
+void setUp(void)
+{
+    memset(&result, 0, sizeof(result));
+}
+
+void tearDown(void)
+{
+}
+
+void test_paced_stream_decodes_every_frame(void)
+{
+    udp_loopback_config_t cfg = UDP_LOOPBACK_CONFIG_DEFAULT();
+    run(&cfg);
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, result.delivery);
+    TEST_ASSERT_EQUAL_UINT32(0, result.frames_concealed);
+    TEST_ASSERT_EQUAL_UINT32(0, result.nacks_sent);
+    TEST_ASSERT_EQUAL_UINT32(0, result.tx_queue_full);
+    // Loopback plus two processes: nowhere near a frame of delay.
+    TEST_ASSERT_TRUE(result.latency_p95_us < AUDIO_FRAME_MS * 1000);
+}
+
+void test_dropped_packets_are_retransmitted_into_the_hold(void)
+{
+    udp_loopback_config_t cfg = UDP_LOOPBACK_CONFIG_DEFAULT();
+    cfg.frames = 150;
+    cfg.drop_every = 10;
+    run(&cfg);
+
+    TEST_ASSERT_TRUE(result.packets_dropped > 0);
+    TEST_ASSERT_TRUE(result.nacks_sent >= result.packets_dropped);
+    TEST_ASSERT_TRUE(result.retransmits >= result.packets_dropped);
+    TEST_ASSERT_EQUAL_UINT32(result.packets_dropped * MESH_FRAMES_PER_PACKET, result.frames_repaired);
+    TEST_ASSERT_EQUAL_UINT32(0, result.frames_concealed);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, result.delivery);
+    // A repaired frame waits one packet for the gap to show, then a round trip.
+    TEST_ASSERT_TRUE(result.latency_max_us < MESH_RETX_PLAYOUT_BUDGET_MS * 1000);
+}
+
+void test_unpaced_throughput_far_exceeds_real_time(void)
+{
+    udp_loopback_config_t cfg = UDP_LOOPBACK_CONFIG_DEFAULT();
+    cfg.frames = 4000;
+    cfg.paced = false;
+    run(&cfg);
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, result.delivery);
+    TEST_ASSERT_EQUAL_UINT32(0, result.frames_concealed);
+    TEST_ASSERT_TRUE(result.frames_per_s > 10.0f * 1000 / AUDIO_FRAME_EFFECTIVE_MS);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_paced_stream_decodes_every_frame);
+    RUN_TEST(test_dropped_packets_are_retransmitted_into_the_hold);
+    RUN_TEST(test_unpaced_throughput_far_exceeds_real_time);
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+// Runner: opens the root socket, forks the SRC and OUT processes and turns the
+// shared send/decode timestamps into latency and throughput.
+
+#include "udp_loopback.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int loop_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t loop_quantile(const uint32_t *sorted, uint32_t count, uint32_t pct)
+{
+    if (count == 0) {
+        return 0;
+    }
+    uint32_t idx = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+    return sorted[idx > 0 ? idx - 1 : 0];
+}
+
+static pid_t loop_spawn(udp_loopback_shared_t *shared, network_transport_udp_t *root)
+{
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (root) {
+            udp_loopback_src_main(shared, root);
+        }
+        udp_loopback_out_main(shared);
+    }
+    return pid;
+}
+
+static bool loop_wait(pid_t pid)
+{
+    int status;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void loop_collect(udp_loopback_shared_t *shared, udp_loopback_result_t *out)
+{
+    *out = shared->res;
+
+    uint32_t *latency = malloc(UDP_LOOPBACK_MAX_FRAMES * sizeof(uint32_t));
+    uint32_t count = 0;
+    int64_t first_us = -1;
+    int64_t last_us = -1;
+    for (uint32_t seq = 0; seq < shared->cfg.frames; seq++) {
+        int64_t sent = shared->sent_us[seq];
+        int64_t decoded = shared->decoded_us[seq];
+        if (sent >= 0 && (first_us < 0 || sent < first_us)) {
+            first_us = sent;
+        }
+        if (sent < 0 || decoded < 0) {
+            continue;
+        }
+        latency[count++] = (uint32_t)(decoded - sent);
+        if (decoded > last_us) {
+            last_us = decoded;
+        }
+    }
+    qsort(latency, count, sizeof(uint32_t), loop_cmp_u32);
+    out->latency_p50_us = loop_quantile(latency, count, 50);
+    out->latency_p95_us = loop_quantile(latency, count, 95);
+    out->latency_p99_us = loop_quantile(latency, count, 99);
+    out->latency_max_us = loop_quantile(latency, count, 100);
+    free(latency);
+
+    out->delivery = out->frames_sent > 0 ? (float)out->frames_decoded / (float)out->frames_sent : 0.0f;
+    out->elapsed_us = (first_us >= 0 && last_us > first_us) ? (uint64_t)(last_us - first_us) : 0;
+    if (out->elapsed_us > 0) {
+        double seconds = (double)out->elapsed_us / 1e6;
+        out->frames_per_s = (float)(out->frames_decoded / seconds);
+        out->throughput_kbps = (float)((double)out->frames_decoded * shared->cfg.frame_bytes * 8.0 / 1000.0 / seconds);
+    }
+}
+
+bool udp_loopback_run(const udp_loopback_config_t *cfg, udp_loopback_result_t *out)
+{
+    if (!cfg || !out || cfg->frames == 0 || cfg->frames > UDP_LOOPBACK_MAX_FRAMES ||
+        cfg->frames % MESH_FRAMES_PER_PACKET != 0 || cfg->frame_bytes == 0 ||
+        (!cfg->paced && cfg->window == 0)) {
+        return false;
+    }
+
+    udp_loopback_shared_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        return false;
+    }
+    memset(shared, 0, sizeof(*shared));
+    shared->cfg = *cfg;
+    for (int i = 0; i < UDP_LOOPBACK_MAX_FRAMES; i++) {
+        shared->sent_us[i] = -1;
+        shared->decoded_us[i] = -1;
+    }
+
+    // The SRC inherits this socket; the port is known before either process runs.
+    network_transport_udp_t root;
+    network_transport_udp_config_t root_cfg = {
+        .self = UDP_LOOPBACK_SRC_NODE,
+        .is_root = true,
+        .bind_port = 0,
+    };
+    bool ok = network_transport_udp_open(&root, &root_cfg) == ESP_OK;
+    pid_t src = -1;
+    pid_t dst = -1;
+    if (ok) {
+        shared->root_port = network_transport_udp_port(&root);
+        src = loop_spawn(shared, &root);
+        network_transport_udp_close(&root);
+        dst = loop_spawn(shared, NULL);
+    }
+    bool src_ok = loop_wait(src);
+    bool dst_ok = loop_wait(dst);
+    ok = ok && src_ok && dst_ok;
+    if (ok) {
+        loop_collect(shared, out);
+    }
+    munmap(shared, sizeof(*shared));
+    return ok;
+}
+
+void udp_loopback_print(const udp_loopback_config_t *cfg, const udp_loopback_result_t *res)
+{
+    printf("udp-loopback %s frames=%lu bytes=%u drop_every=%u\n",
+           cfg->paced ? "paced" : "unpaced", (unsigned long)res->frames_sent,
+           (unsigned)cfg->frame_bytes, (unsigned)cfg->drop_every);
+    printf("  delivery=%.1f%% latency p50=%.2fms p95=%.2fms p99=%.2fms max=%.2fms\n",
+           res->delivery * 100.0f, res->latency_p50_us / 1000.0, res->latency_p95_us / 1000.0,
+           res->latency_p99_us / 1000.0, res->latency_max_us / 1000.0);
+    printf("  throughput=%.0f frames/s %.1f kbps over %.1fms\n",
+           res->frames_per_s, res->throughput_kbps, res->elapsed_us / 1000.0);
+    printf("  dropped=%lu nacks=%lu retx=%lu repaired=%lu concealed=%lu late=%lu qfull=%lu corrupt=%lu\n",
+           (unsigned long)res->packets_dropped, (unsigned long)res->nacks_sent,
+           (unsigned long)res->retransmits, (unsigned long)res->frames_repaired,
+           (unsigned long)res->frames_concealed, (unsigned long)res->frames_late,
+           (unsigned long)res->tx_queue_full, (unsigned long)res->frames_corrupt);
+}
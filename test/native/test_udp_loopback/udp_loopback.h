@@ -0,0 +1,84 @@
+#pragma once
+
+#include "config/build.h"
+#include "transport_udp.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Two-process loopback over the POSIX UDP transport (test/native/shared/transport_udp.h).
+// The SRC process is the root: it builds packets through network_audio_tx_* and
+// answers NACKs from the retransmit cache. The OUT process runs the real
+// mesh_rx_dispatch and hands every frame to the rx_reorder hold and a decode
+// stage, where the Opus call is replaced by a payload check. Both processes run
+// on the wall clock, so the numbers include real socket and scheduler costs.
+//
+// Paced runs send one packet every MESH_FRAMES_PER_PACKET frames, as the SRC
+// pipeline does, and measure latency. Unpaced runs keep at most `window`
+// packets ahead of the decoder and measure throughput.
+
+#define UDP_LOOPBACK_MAX_FRAMES 8192
+#define UDP_LOOPBACK_SRC_NODE   { { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 } }
+#define UDP_LOOPBACK_OUT_NODE   { { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 } }
+
+typedef struct {
+    uint32_t frames;            // Multiple of MESH_FRAMES_PER_PACKET
+    uint16_t frame_bytes;
+    bool paced;
+    uint16_t window;            // Unpaced: packets in flight ahead of decode
+    uint16_t drop_every;        // Drop the first send of every Nth packet; 0 = none
+} udp_loopback_config_t;
+
+#define UDP_LOOPBACK_CONFIG_DEFAULT() {     \
+    .frames = 100,                          \
+    .frame_bytes = OPUS_BITRATE / 8 * AUDIO_FRAME_EFFECTIVE_MS / 1000, \
+    .paced = true,                          \
+    .window = 16,                           \
+    .drop_every = 0,                        \
+}
+
+typedef struct {
+    // SRC
+    uint32_t frames_sent;
+    uint32_t packets_sent;
+    uint32_t packets_dropped;   // By drop_every
+    uint32_t tx_queue_full;     // Socket buffer full (ESP_ERR_MESH_QUEUE_FULL)
+    uint32_t retransmits;
+    // OUT
+    uint32_t nacks_sent;
+    uint32_t frames_decoded;
+    uint32_t frames_concealed;
+    uint32_t frames_repaired;   // Filled by a retransmit within the hold
+    uint32_t frames_late;
+    uint32_t frames_corrupt;    // Payload did not match its seq
+    // Runner
+    float delivery;             // frames_decoded / frames_sent
+    uint32_t latency_p50_us;    // network_audio_tx_send to the decode stage
+    uint32_t latency_p95_us;
+    uint32_t latency_p99_us;
+    uint32_t latency_max_us;
+    uint64_t elapsed_us;        // First send to last decode
+    float frames_per_s;
+    float throughput_kbps;      // Decoded payload
+} udp_loopback_result_t;
+
+// False when a process could not be started or did not finish in time.
+bool udp_loopback_run(const udp_loopback_config_t *cfg, udp_loopback_result_t *out);
+void udp_loopback_print(const udp_loopback_config_t *cfg, const udp_loopback_result_t *res);
+
+// Shared by the runner and both processes: mapped MAP_SHARED before fork().
+typedef struct {
+    udp_loopback_config_t cfg;
+    uint16_t root_port;
+    atomic_bool out_done;
+    atomic_uint frames_out;     // Decoded or concealed: the unpaced SRC's window
+    int64_t sent_us[UDP_LOOPBACK_MAX_FRAMES];
+    int64_t decoded_us[UDP_LOOPBACK_MAX_FRAMES];   // -1 = never decoded
+    udp_loopback_result_t res;
+} udp_loopback_shared_t;
+
+// Process bodies; both _exit(). The SRC inherits the root socket opened by the
+// runner, so OUT can be started against its port right away.
+void udp_loopback_src_main(udp_loopback_shared_t *shared, network_transport_udp_t *udp);
+void udp_loopback_out_main(udp_loopback_shared_t *shared);
@@ -0,0 +1,591 @@
+// SRC and OUT process bodies: the real mesh modules over the UDP backend, plus
+// the IDF/FreeRTOS surface they call, backed by the host's monotonic clock.
+// Each runs in its own process, so every module global below is per node.
+
+#include "udp_loopback.h"
+
+// Every mesh module defines its own static TAG; rename it per include so they
+// can share this translation unit.
+#define TAG TAG_mesh_state
+#include "../../../lib/network/src/mesh/mesh_state.c"
+#undef TAG
+#define TAG TAG_mesh_dedupe
+#include "../../../lib/network/src/mesh/mesh_dedupe.c"
+#undef TAG
+#define TAG TAG_mesh_fanout
+#include "../../../lib/network/src/mesh/mesh_fanout.c"
+#undef TAG
+#define TAG TAG_mesh_retransmit
+#include "../../../lib/network/src/mesh/mesh_retransmit.c"
+#undef TAG
+#define TAG TAG_mesh_coalesce
+#include "../../../lib/network/src/mesh/mesh_coalesce.c"
+#undef TAG
+#define TAG TAG_mesh_tx
+#include "../../../lib/network/src/mesh/mesh_tx.c"
+#undef TAG
+#define TAG TAG_mesh_rx
+#include "../../../lib/network/src/mesh/mesh_rx.c"
+#undef TAG
+#define TAG TAG_mesh_heartbeat
+#include "../../../lib/network/src/mesh/mesh_heartbeat.c"
+#undef TAG
+#define TAG TAG_mesh_ping
+#include "../../../lib/network/src/mesh/mesh_ping.c"
+#undef TAG
+#define TAG TAG_mesh_mixer
+#include "../../../lib/network/src/mesh/mesh_mixer.c"
+#undef TAG
+#define TAG TAG_mesh_uplink
+#include "../../../lib/network/src/mesh/mesh_uplink.c"
+#undef TAG
+#define TAG TAG_mesh_queries
+#include "../../../lib/network/src/mesh/mesh_queries.c"
+#undef TAG
+#define TAG TAG_mesh_capture
+#include "../../../lib/network/src/mesh/mesh_capture.c"
+#undef TAG
+#include "../../../lib/network/src/mesh/mesh_transport.c"
+#define CONFIG_OUT_BUILD
+#include "../../../lib/network/src/mesh/mesh_identity.c"
+
+#include "../../../lib/network/src/audio_transport.c"
+#include "../../../lib/network/src/control_bundle.c"
+#include "../../../lib/network/src/frame_codec.c"
+#include "../../../lib/network/src/link_table.c"
+#include "../../../lib/network/src/mesh_net.c"
+#include "../../../lib/network/src/mixer_control.c"
+#include "../../../lib/network/src/packet_pool.c"
+#include "../../../lib/network/src/rtt_estimator.c"
+#include "../../../lib/network/src/rx_capture.c"
+#include "../../../lib/network/src/stat_counters.c"
+#include "../../../lib/network/src/transport.c"
+#include "../../../lib/network/src/uplink_control.c"
+
+#include "../../../lib/audio/src/rx_reorder.c"
+
+#include "../shared/transport_udp.c"
+
+#include <esp_heap_caps.h>
+#include <esp_mac.h>
+#include <esp_system.h>
+#include <esp_wifi.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NODE_MAX_TIMERS      8
+#define NODE_PEER_WAIT_US    2000000
+#define NODE_DRAIN_US        2000000
+#define NODE_IDLE_US         1000000
+#define NODE_PACKET_US       ((int64_t)MESH_FRAMES_PER_PACKET * AUDIO_FRAME_EFFECTIVE_MS * 1000)
+
+struct esp_timer {
+    bool created;
+    bool active;
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t due_us;
+    uint64_t period_us;
+};
+
+static udp_loopback_shared_t *s_shared;
+static uint32_t s_rng = 1;
+static struct esp_timer s_timers[NODE_MAX_TIMERS];
+static uint8_t s_rx_buf[MESH_RX_BUFFER_SIZE];
+
+// SRC: the UDP backend with a lossy default route.
+static network_transport_udp_t *s_udp;
+static network_transport_ops_t s_lossy_ops;
+static network_transport_t s_lossy;
+
+// OUT: the hold ahead of the decode stage.
+static rx_reorder_t s_reorder;
+
+// --- IDF / FreeRTOS surface ---
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    for (int i = 0; i < NODE_MAX_TIMERS; i++) {
+        if (!s_timers[i].created) {
+            s_timers[i] = (struct esp_timer){
+                .created = true,
+                .callback = create_args->callback,
+                .arg = create_args->arg,
+            };
+            *out_handle = &s_timers[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = true;
+    timer->due_us = esp_timer_get_time() + (int64_t)timeout_us;
+    timer->period_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    esp_err_t err = esp_timer_start_once(timer, period);
+    timer->period_us = period;
+    return err;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    timer->active = false;
+    timer->created = false;
+    return ESP_OK;
+}
+
+uint32_t esp_random(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// RX capture is never started here.
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)size;
+    (void)caps;
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                       uint32_t priority, TaskHandle_t *out_handle)
+{
+    (void)fn;
+    (void)name;
+    (void)stack_bytes;
+    (void)arg;
+    (void)priority;
+    (void)out_handle;
+    return pdFALSE;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(uint32_t ticks)
+{
+    (void)ticks;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    (void)clear_on_exit;
+    (void)ticks;
+    return 1;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+    return pdTRUE;
+}
+
+// One thread per process: the locks never contend.
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    static int mutex;
+    return &mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem;
+    (void)ticks;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+bool esp_mesh_is_root(void)
+{
+    return is_mesh_root;
+}
+
+uint8_t esp_mesh_get_layer(void)
+{
+    return mesh_layer;
+}
+
+// The routing table is whatever the UDP backend has learned.
+esp_err_t esp_mesh_get_routing_table(mesh_addr_t *mac, int len, int *size)
+{
+    network_node_addr_t nodes[MESH_ROUTE_TABLE_SIZE];
+    int max = len / (int)sizeof(mesh_addr_t);
+    int count = network_transport_topology(nodes, max < MESH_ROUTE_TABLE_SIZE ? max : MESH_ROUTE_TABLE_SIZE, NULL);
+    for (int i = 0; i < count; i++) {
+        mesh_transport_from_node(&nodes[i], &mac[i]);
+    }
+    *size = count;
+    return ESP_OK;
+}
+
+int esp_mesh_get_routing_table_size(void)
+{
+    network_node_addr_t nodes[MESH_ROUTE_TABLE_SIZE];
+    return network_transport_topology(nodes, MESH_ROUTE_TABLE_SIZE, NULL);
+}
+
+esp_err_t esp_mesh_set_group_id(const mesh_addr_t *addr, int num)
+{
+    (void)addr;
+    (void)num;
+    return ESP_OK;
+}
+
+// Everything goes through the UDP backend; the mesh stack is never started.
+esp_err_t esp_mesh_send(const mesh_addr_t *to, const mesh_data_t *data, int flag,
+                        const mesh_opt_t opt[], int opt_count)
+{
+    (void)to;
+    (void)data;
+    (void)flag;
+    (void)opt;
+    (void)opt_count;
+    return ESP_ERR_MESH_NOT_START;
+}
+
+esp_err_t esp_mesh_recv(mesh_addr_t *from, mesh_data_t *data, int timeout_ms, int *flag,
+                        mesh_opt_t opt[], int opt_count)
+{
+    (void)from;
+    (void)data;
+    (void)timeout_ms;
+    (void)flag;
+    (void)opt;
+    (void)opt_count;
+    return ESP_ERR_MESH_NOT_START;
+}
+
+esp_err_t esp_mesh_connect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_disconnect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_mesh_set_router(const mesh_router_t *router)
+{
+    (void)router;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    if (is_mesh_root) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ap_info->rssi = -40;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t *sta_list)
+{
+    sta_list->num = 0;
+    return ESP_OK;
+}
+
+void portal_state_update_position(const uint8_t *mac, float x, float y, float z)
+{
+    (void)mac;
+    (void)x;
+    (void)y;
+    (void)z;
+}
+
+// --- Shared node runtime ---
+
+static void node_run_due_timers(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    for (;;) {
+        struct esp_timer *due = NULL;
+        for (int i = 0; i < NODE_MAX_TIMERS; i++) {
+            struct esp_timer *t = &s_timers[i];
+            if (t->active && t->due_us <= now_us && (!due || t->due_us < due->due_us)) {
+                due = t;
+            }
+        }
+        if (!due) {
+            return;
+        }
+        if (due->period_us > 0) {
+            due->due_us += (int64_t)due->period_us;
+        } else {
+            due->active = false;
+        }
+        due->callback(due->arg);
+    }
+}
+
+// One pass of mesh_rx_task: the next datagram, if any, into mesh_rx_dispatch.
+static bool node_service(uint32_t timeout_ms)
+{
+    network_node_addr_t from_node;
+    size_t len = sizeof(s_rx_buf);
+
+    node_run_due_timers();
+    if (network_transport_recv(&from_node, s_rx_buf, &len, timeout_ms) != ESP_OK) {
+        return false;
+    }
+    mesh_addr_t from;
+    mesh_transport_from_node(&from_node, &from);
+    mesh_rx_dispatch(&from, s_rx_buf, len);
+    return true;
+}
+
+// What mesh_init and the mesh events would have set up once the node joined.
+static void node_setup(bool root, const network_node_addr_t *self)
+{
+    my_node_role = root ? NODE_ROLE_SRC : NODE_ROLE_OUT;
+    memcpy(my_sta_mac, self->addr, 6);
+    my_stream_id = my_sta_mac[0] ^ my_sta_mac[1] ^ my_sta_mac[2] ^
+                   my_sta_mac[3] ^ my_sta_mac[4] ^ my_sta_mac[5];
+    snprintf(g_src_id, NETWORK_SRC_ID_LEN, "%s_%02X%02X%02X", root ? "SRC" : "OUT",
+             my_sta_mac[3], my_sta_mac[4], my_sta_mac[5]);
+
+    is_mesh_root = root;
+    is_mesh_root_ready = true;
+    is_mesh_connected = !root;
+    mesh_layer = root ? 1 : 2;
+
+    mesh_dedupe_reset();
+    mesh_state_init();
+    mesh_mixer_init();
+    mesh_coalesce_init();
+    mesh_tx_init();
+    mesh_retx_cache_init();
+}
+
+// --- SRC ---
+
+// The first send of every drop_every-th packet vanishes on the wire, as far as
+// the sender can tell; addressed sends (retransmits) always go out.
+static esp_err_t src_send_audio(void *ctx, const network_node_addr_t *to, const uint8_t *data, size_t len)
+{
+    uint16_t drop_every = s_shared->cfg.drop_every;
+    if (!to && drop_every > 0 && (s_shared->res.packets_sent + 1) % drop_every == 0) {
+        s_shared->res.packets_dropped++;
+        return ESP_OK;
+    }
+    return s_udp->transport.ops->send_audio(ctx, to, data, len);
+}
+
+// SRC pipeline stand-in: one packet of MESH_FRAMES_PER_PACKET frames, each
+// filled with its seq so OUT can check what it decodes.
+static void src_send_packet(uint16_t seq)
+{
+    int64_t now_us = esp_timer_get_time();
+    for (int i = 0; i < MESH_FRAMES_PER_PACKET; i++) {
+        size_t capacity = 0;
+        uint8_t *slot = network_audio_tx_frame_slot(&capacity);
+        if (!slot) {
+            break;
+        }
+        size_t len = s_shared->cfg.frame_bytes < capacity ? s_shared->cfg.frame_bytes : capacity;
+        memset(slot, (uint8_t)(seq + i), len);
+        network_audio_tx_commit_frame(len);
+        s_shared->sent_us[seq + i] = now_us;
+    }
+    uint8_t frames = network_audio_tx_frame_count();
+    if (frames == 0) {
+        return;
+    }
+    esp_err_t err = network_audio_tx_send(seq, (uint32_t)(now_us / 1000), my_stream_id);
+    if (err == ESP_ERR_MESH_QUEUE_FULL) {
+        s_shared->res.tx_queue_full++;
+    }
+    s_shared->res.packets_sent++;
+    s_shared->res.frames_sent += frames;
+}
+
+void udp_loopback_src_main(udp_loopback_shared_t *shared, network_transport_udp_t *udp)
+{
+    const udp_loopback_config_t *cfg = &shared->cfg;
+    s_shared = shared;
+    s_udp = udp;
+    node_setup(true, &udp->self);
+
+    s_lossy_ops = *udp->transport.ops;
+    s_lossy_ops.send_audio = src_send_audio;
+    s_lossy.ops = &s_lossy_ops;
+    s_lossy.ctx = udp;
+    network_transport_set(&s_lossy);
+
+    // OUT announces itself on open; until the root has seen it audio has nowhere to go.
+    int64_t give_up_us = esp_timer_get_time() + NODE_PEER_WAIT_US;
+    while (udp->peer_count == 0) {
+        if (esp_timer_get_time() > give_up_us) {
+            _exit(1);
+        }
+        node_service(10);
+    }
+
+    int64_t next_us = esp_timer_get_time();
+    for (uint32_t seq = 0; seq < cfg->frames; seq += MESH_FRAMES_PER_PACKET) {
+        if (cfg->paced) {
+            // Answer NACKs until the next packet is due.
+            int64_t now_us;
+            while ((now_us = esp_timer_get_time()) < next_us) {
+                node_service((uint32_t)((next_us - now_us + 999) / 1000));
+            }
+            next_us += NODE_PACKET_US;
+        } else {
+            while (seq - atomic_load(&shared->frames_out) >= (uint32_t)cfg->window * MESH_FRAMES_PER_PACKET) {
+                node_service(1);
+            }
+        }
+        src_send_packet((uint16_t)seq);
+    }
+
+    // Keep answering NACKs until OUT has drained.
+    give_up_us = esp_timer_get_time() + NODE_DRAIN_US;
+    while (!atomic_load(&shared->out_done) && esp_timer_get_time() < give_up_us) {
+        node_service(5);
+    }
+
+    network_transport_stats_t stats;
+    network_get_transport_stats(&stats);
+    shared->res.retransmits = stats.tx_retransmit_packets;
+    network_transport_udp_close(udp);
+    _exit(0);
+}
+
+// --- OUT ---
+
+static bool out_payload_ok(uint16_t seq, const uint8_t *data, uint16_t len)
+{
+    if (len != s_shared->cfg.frame_bytes) {
+        return false;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        if (data[i] != (uint8_t)seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The OUT decode task's drain (adf_pipeline_rx.c), with the Opus call replaced
+// by a payload check.
+static void out_decode_drain(int64_t now_ms)
+{
+    uint16_t seq;
+    const uint8_t *payload;
+    uint16_t payload_len;
+    rx_reorder_pop_t due;
+
+    while ((due = rx_reorder_pop(&s_reorder, now_ms, &seq, &payload, &payload_len)) != RX_REORDER_NONE) {
+        if (due == RX_REORDER_CONCEAL) {
+            s_shared->res.frames_concealed++;
+        } else if (!out_payload_ok(seq, payload, payload_len)) {
+            s_shared->res.frames_corrupt++;
+        } else {
+            s_shared->res.frames_decoded++;
+            if (seq < UDP_LOOPBACK_MAX_FRAMES) {
+                s_shared->decoded_us[seq] = esp_timer_get_time();
+            }
+        }
+        atomic_fetch_add(&s_shared->frames_out, 1);
+    }
+}
+
+static void out_on_audio(const uint8_t *payload, size_t len, uint16_t seq, uint32_t timestamp, const char *src_id)
+{
+    (void)timestamp;
+    (void)src_id;
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    rx_reorder_push_t pushed = rx_reorder_push(&s_reorder, seq, payload, (uint16_t)len, now_ms);
+    if (pushed == RX_REORDER_FULL) {
+        out_decode_drain(now_ms);
+        rx_reorder_push(&s_reorder, seq, payload, (uint16_t)len, now_ms);
+    }
+    out_decode_drain(now_ms);
+}
+
+void udp_loopback_out_main(udp_loopback_shared_t *shared)
+{
+    static network_transport_udp_t udp;
+    const udp_loopback_config_t *cfg = &shared->cfg;
+    network_transport_udp_config_t udp_cfg = {
+        .self = UDP_LOOPBACK_OUT_NODE,
+        .root_host = "127.0.0.1",
+        .root_port = shared->root_port,
+    };
+
+    s_shared = shared;
+    if (network_transport_udp_open(&udp, &udp_cfg) != ESP_OK) {
+        _exit(1);
+    }
+    node_setup(false, &udp_cfg.self);
+    network_transport_set(network_transport_udp(&udp));
+    network_register_audio_callback(out_on_audio);
+    rx_reorder_init(&s_reorder, RX_REORDER_HOLD_MS, RX_PLC_MAX_FRAMES_PER_GAP, RX_MAX_STALE_FRAMES_TO_DROP);
+
+    // A lost final packet leaves no later frame to expose its gap; stop once
+    // the stream has gone quiet.
+    int64_t give_up_us = esp_timer_get_time() + (int64_t)cfg->frames * AUDIO_FRAME_EFFECTIVE_MS * 1000 + NODE_DRAIN_US;
+    int64_t last_rx_us = esp_timer_get_time();
+    while (atomic_load(&shared->frames_out) < cfg->frames) {
+        int64_t now_us = esp_timer_get_time();
+        if (now_us > give_up_us || now_us - last_rx_us > NODE_IDLE_US) {
+            break;
+        }
+        if (node_service(2)) {
+            last_rx_us = esp_timer_get_time();
+        }
+        // Gaps whose hold ran out while nothing new arrived.
+        out_decode_drain(esp_timer_get_time() / 1000);
+    }
+
+    network_transport_stats_t stats;
+    network_get_transport_stats(&stats);
+    shared->res.nacks_sent = stats.tx_nack_packets;
+    shared->res.frames_repaired = s_reorder.stats.repaired;
+    shared->res.frames_late = s_reorder.stats.late;
+    atomic_store(&shared->out_done, true);
+    network_transport_udp_close(&udp);
+    _exit(0);
+}
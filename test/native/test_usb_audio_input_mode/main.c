@@ -101,6 +101,23 @@ size_t ring_buffer_available(ring_buffer_t *rb)
     return rb ? rb->used : 0;
 }
 
+void ring_buffer_set_latency_budget(ring_buffer_t *rb, uint32_t budget_ms)
+{
+    (void)rb;
+    (void)budget_ms;
+}
+
+esp_err_t ring_buffer_get_stats(ring_buffer_t *rb, latency_queue_stats_t *stats, bool reset)
+{
+    (void)reset;
+    if (!rb || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->bytes = (uint32_t)rb->used;
+    return ESP_OK;
+}
+
 esp_err_t uac_device_init(uac_device_config_t *config)
 {
     if (config) {
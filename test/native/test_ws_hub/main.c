@@ -0,0 +1,275 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "control/json_writer.h"
+#include "control/ws_hub.h"
+
+#include "../../../lib/control/src/json_writer.c"
+#include "../../../lib/control/src/ws_hub.c"
+
+enum { TOPIC_STATUS = 0, TOPIC_NODES, TOPIC_METERS };
+
+#define BIT(t) ((uint8_t)(1U << (t)))
+
+static ws_hub_t s_hub;
+static ws_hub_job_t s_job;
+
+void setUp(void)
+{
+    ws_hub_init(&s_hub);
+    memset(&s_job, 0, sizeof(s_job));
+    s_job.fd = -1;
+}
+
+void tearDown(void) {}
+
+static uint32_t hash_uint(uint32_t value)
+{
+    uint32_t h = WS_HUB_HASH_SEED;
+    char scratch[8];
+    json_writer_t w;
+    json_writer_init_stream(&w, scratch, sizeof(scratch), ws_hub_hash_sink, &h);
+    json_writer_begin_object(&w);
+    json_writer_field_uint(&w, "heapKb", value);
+    json_writer_end_object(&w);
+    TEST_ASSERT_TRUE(json_writer_finish(&w) > 0);
+    return h;
+}
+
+// Two fields (0: status, 1: meters) and a set of node items keyed by id.
+static void pass(uint32_t heap, uint32_t meter, const uint32_t *nodes, const uint32_t *node_vals, int node_count)
+{
+    ws_hub_begin_pass(&s_hub);
+    ws_hub_update_field(&s_hub, 0, TOPIC_STATUS, hash_uint(heap));
+    ws_hub_update_field(&s_hub, 1, TOPIC_METERS, hash_uint(meter));
+    for (int i = 0; i < node_count; i++) {
+        ws_hub_update_item(&s_hub, nodes[i], TOPIC_NODES, hash_uint(node_vals[i]));
+    }
+    ws_hub_end_pass(&s_hub, TOPIC_NODES);
+}
+
+static ws_hub_send_t plan(int i, bool writable)
+{
+    return ws_hub_plan(&s_hub, i, writable, &s_job);
+}
+
+static void sent(ws_hub_result_t result)
+{
+    ws_hub_sent(&s_hub, &s_job, result);
+}
+
+// Plans slot i and reports the send as delivered.
+static void deliver(int i)
+{
+    TEST_ASSERT_TRUE(plan(i, true) != WS_HUB_SEND_NONE);
+    sent(WS_HUB_SENT_OK);
+}
+
+static void test_hash_sink_separates_values(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(hash_uint(120), hash_uint(120));
+    TEST_ASSERT_TRUE(hash_uint(120) != hash_uint(121));
+}
+
+static void test_new_client_gets_full_then_nothing_until_change(void)
+{
+    TEST_ASSERT_TRUE(ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS) | BIT(TOPIC_NODES)));
+    pass(100, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+    sent(WS_HUB_SENT_OK);
+
+    pass(100, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_NONE, plan(0, true));
+
+    pass(101, 5, NULL, NULL, 0);
+    TEST_ASSERT_TRUE(ws_hub_field_changed(&s_hub, 0));
+    TEST_ASSERT_FALSE(ws_hub_field_changed(&s_hub, 1));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(0, true));
+    sent(WS_HUB_SENT_OK);
+    TEST_ASSERT_EQUAL_UINT32(1, s_hub.clients[0].sent_full);
+    TEST_ASSERT_EQUAL_UINT32(1, s_hub.clients[0].sent_delta);
+}
+
+static void test_changes_outside_subscribed_topics_send_nothing(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS));
+    pass(100, 5, NULL, NULL, 0);
+    deliver(0);
+
+    pass(100, 6, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_NONE, plan(0, true));
+
+    // Subscribing to meters resyncs with a full snapshot.
+    TEST_ASSERT_TRUE(ws_hub_set_topics(&s_hub, 7, BIT(TOPIC_STATUS) | BIT(TOPIC_METERS)));
+    pass(100, 6, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+}
+
+static void test_clients_are_tracked_independently(void)
+{
+    TEST_ASSERT_TRUE(ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS)));
+    pass(100, 5, NULL, NULL, 0);
+    deliver(0);
+
+    // A second tab joins; the first keeps getting deltas, not a takeover.
+    TEST_ASSERT_TRUE(ws_hub_add_client(&s_hub, 9, BIT(TOPIC_STATUS)));
+    TEST_ASSERT_EQUAL_INT(2, ws_hub_client_count(&s_hub));
+    pass(101, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(0, true));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(1, true));
+}
+
+static void test_client_table_is_bounded(void)
+{
+    for (int i = 0; i < WS_HUB_MAX_CLIENTS; i++) {
+        TEST_ASSERT_TRUE(ws_hub_add_client(&s_hub, 10 + i, BIT(TOPIC_STATUS)));
+    }
+    TEST_ASSERT_FALSE(ws_hub_add_client(&s_hub, 99, BIT(TOPIC_STATUS)));
+    // Re-registering a known fd reuses its slot.
+    TEST_ASSERT_TRUE(ws_hub_add_client(&s_hub, 10, BIT(TOPIC_NODES)));
+    ws_hub_remove_client(&s_hub, 11);
+    TEST_ASSERT_TRUE(ws_hub_add_client(&s_hub, 99, BIT(TOPIC_STATUS)));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_MAX_CLIENTS, ws_hub_client_count(&s_hub));
+}
+
+static void test_backed_up_client_is_dropped_then_resynced(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS));
+    ws_hub_add_client(&s_hub, 9, BIT(TOPIC_STATUS));
+    pass(100, 5, NULL, NULL, 0);
+    deliver(0);
+    deliver(1);
+
+    // Client 0's socket is full: its delta is skipped, client 1 is unaffected.
+    pass(101, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_NONE, plan(0, false));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(1, true));
+    TEST_ASSERT_EQUAL_UINT32(1, s_hub.clients[0].dropped);
+
+    // Nothing changes, but the dropped client still owes a resync.
+    pass(101, 5, NULL, NULL, 0);
+    TEST_ASSERT_TRUE(ws_hub_needs_full(&s_hub));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_NONE, plan(1, true));
+}
+
+static void test_failed_send_removes_client(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS));
+    pass(100, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+    sent(WS_HUB_SENT_FAILED);
+    TEST_ASSERT_EQUAL_INT(0, ws_hub_client_count(&s_hub));
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_NONE, plan(0, true));
+}
+
+static void test_backed_up_send_keeps_client_and_resyncs(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS));
+    pass(100, 5, NULL, NULL, 0);
+    deliver(0);
+
+    // Writable when planned, full by the time the send started.
+    pass(101, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(0, true));
+    sent(WS_HUB_SENT_BACKED_UP);
+    TEST_ASSERT_EQUAL_INT(1, ws_hub_client_count(&s_hub));
+    TEST_ASSERT_EQUAL_UINT32(1, s_hub.clients[0].dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, s_hub.clients[0].sent_delta);
+
+    pass(101, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+}
+
+static void test_resubscribe_during_send_keeps_its_resync(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS));
+    pass(100, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+
+    // The httpd task handles a subscribe while the status snapshot is in flight.
+    ws_hub_set_topics(&s_hub, 7, BIT(TOPIC_STATUS) | BIT(TOPIC_METERS));
+    sent(WS_HUB_SENT_OK);
+    TEST_ASSERT_TRUE(s_hub.clients[0].needs_full);
+    TEST_ASSERT_EQUAL_UINT32(0, s_hub.clients[0].sent_full);
+
+    // A stale failure does not remove the new subscription either.
+    sent(WS_HUB_SENT_FAILED);
+    TEST_ASSERT_EQUAL_INT(1, ws_hub_client_count(&s_hub));
+    pass(100, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+}
+
+static void test_job_for_reused_fd_is_ignored(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_STATUS));
+    pass(100, 5, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_FULL, plan(0, true));
+
+    // The session closes and lwIP hands the fd to a new one mid-send.
+    ws_hub_remove_client(&s_hub, 7);
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_NODES));
+    sent(WS_HUB_SENT_OK);
+    TEST_ASSERT_TRUE(s_hub.clients[0].needs_full);
+    TEST_ASSERT_EQUAL_UINT32(0, s_hub.clients[0].sent_full);
+}
+
+static void test_items_report_upserts_and_removals(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_NODES));
+    const uint32_t keys[3] = { 0xA1, 0xB2, 0xC3 };
+    uint32_t vals[3] = { 1, 2, 3 };
+    pass(100, 5, keys, vals, 3);
+    TEST_ASSERT_TRUE(ws_hub_item_changed(&s_hub, 0xA1));
+    deliver(0);
+
+    // Only 0xB2 changes and 0xC3 disappears.
+    vals[1] = 20;
+    pass(100, 5, keys, vals, 2);
+    TEST_ASSERT_FALSE(ws_hub_item_changed(&s_hub, 0xA1));
+    TEST_ASSERT_TRUE(ws_hub_item_changed(&s_hub, 0xB2));
+    TEST_ASSERT_EQUAL_UINT8(1, s_hub.removed_count);
+    TEST_ASSERT_TRUE(s_hub.removed[0] == 0xC3);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(0, true));
+
+    // A removal alone is still a change for node subscribers.
+    pass(100, 5, keys, vals, 1);
+    TEST_ASSERT_EQUAL_UINT8(1, s_hub.removed_count);
+    TEST_ASSERT_TRUE(s_hub.removed[0] == 0xB2);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(0, true));
+
+    pass(100, 5, keys, vals, 1);
+    TEST_ASSERT_EQUAL_UINT8(0, s_hub.removed_count);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_NONE, plan(0, true));
+}
+
+static void test_marked_topic_triggers_delta(void)
+{
+    ws_hub_add_client(&s_hub, 7, BIT(TOPIC_METERS));
+    pass(100, 5, NULL, NULL, 0);
+    deliver(0);
+
+    ws_hub_begin_pass(&s_hub);
+    ws_hub_mark_topic(&s_hub, TOPIC_METERS);
+    ws_hub_end_pass(&s_hub, TOPIC_NODES);
+    TEST_ASSERT_EQUAL_INT(WS_HUB_SEND_DELTA, plan(0, true));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hash_sink_separates_values);
+    RUN_TEST(test_new_client_gets_full_then_nothing_until_change);
+    RUN_TEST(test_changes_outside_subscribed_topics_send_nothing);
+    RUN_TEST(test_clients_are_tracked_independently);
+    RUN_TEST(test_client_table_is_bounded);
+    RUN_TEST(test_backed_up_client_is_dropped_then_resynced);
+    RUN_TEST(test_failed_send_removes_client);
+    RUN_TEST(test_backed_up_send_keeps_client_and_resyncs);
+    RUN_TEST(test_resubscribe_during_send_keeps_its_resync);
+    RUN_TEST(test_job_for_reused_fd_is_ignored);
+    RUN_TEST(test_items_report_upserts_and_removals);
+    RUN_TEST(test_marked_topic_triggers_delta);
+    return UNITY_END();
+}
@@ -63,8 +63,12 @@ def load_fault_schedule(path: str | None) -> list[dict]:
         target = raw.get("target")
         if not isinstance(at_seconds, (int, float)) or at_seconds < 0:
             raise SystemExit(f"fault schedule entry #{idx} invalid at_seconds")
-        if action not in ("serial_reset", "log_marker"):
+        if action not in ("serial_reset", "log_marker", "impair"):
             raise SystemExit(f"fault schedule entry #{idx} invalid action '{action}'")
+        # impair profiles drive the native impairment emulator (test/native/shared/impairment.h);
+        # on hardware the step is only logged as a marker.
+        if action == "impair" and not isinstance(raw.get("profile"), dict):
+            raise SystemExit(f"fault schedule entry #{idx} impair step needs a profile object")
         if target not in ("SRC", "OUT", "BOTH"):
             raise SystemExit(f"fault schedule entry #{idx} invalid target '{target}'")
         label = raw.get("label", "")
@@ -159,6 +163,10 @@ def read_port(
                     result.tail.append(f"[fault] fired {label} at {elapsed:0.2f}s ({node_name})")
             elif action == "log_marker":
                 result.tail.append(f"[fault] marker {label} at {elapsed:0.2f}s ({node_name})")
+            elif action == "impair":
+                result.tail.append(
+                    f"[fault] impair {label} at {elapsed:0.2f}s ({node_name}, emulated in native runs only)"
+                )
             if len(result.tail) > tail_lines:
                 result.tail = result.tail[-tail_lines:]
 
@@ -1,41 +1,39 @@
 Import("env")
 
+import sys
 from pathlib import Path
-import gzip
-
 
 ROOT = Path(env["PROJECT_DIR"])
+sys.path.insert(0, str(ROOT / "tools"))
+
+import portal_bundle  # noqa: E402
+
 DIST = ROOT / "lib" / "control" / "portal-ui" / "dist"
-DATA = ROOT / "data"
-FILES = ("index.html", "app.js", "app.css")
+PARTITION = "portal"
 
 
-def should_sync_portal():
-    pio_env = env["PIOENV"]
-    return pio_env in ("src", "out")
+def find_partition(name):
+    table = ROOT / env.GetProjectOption("board_build.partitions", "partitions.csv")
+    for line in table.read_text().splitlines():
+        cols = [c.strip() for c in line.split("#", 1)[0].split(",")]
+        if len(cols) >= 5 and cols[0] == name:
+            return cols[3], int(cols[4], 0)
+    raise RuntimeError(f"[portal-bundle] no '{name}' partition in {table}")
 
 
-def sync_portal_assets():
+def add_portal_bundle():
     if not DIST.exists():
-        print("[portal-sync] lib/control/portal-ui/dist missing, keeping existing data/ assets")
+        print("[portal-bundle] lib/control/portal-ui/dist missing, portal partition left as flashed")
         return
-
-    DATA.mkdir(parents=True, exist_ok=True)
-    for path in DATA.glob("*"):
-        if path.is_file():
-            path.unlink()
-
-    for filename in FILES:
-        src = DIST / filename
-        if not src.exists():
-            raise RuntimeError(f"[portal-sync] missing {src}")
-        dst = DATA / f"{filename}.gz"
-        with src.open("rb") as fsrc:
-            raw = fsrc.read()
-        with gzip.open(dst, "wb", compresslevel=9) as fdst:
-            fdst.write(raw)
-        print(f"[portal-sync] wrote {dst.name} ({dst.stat().st_size} bytes)")
-
-
-if should_sync_portal():
-    sync_portal_assets()
+    offset, size = find_partition(PARTITION)
+    out = Path(env.subst("$BUILD_DIR")) / "portal_assets.bin"
+    bundle = portal_bundle.build(DIST, out)
+    if len(bundle) > size:
+        raise RuntimeError(f"[portal-bundle] {len(bundle)} bytes exceed the {size}-byte partition")
+    print(f"[portal-bundle] {out.name}: {len(bundle)} bytes at {offset}")
+    # Flashed together with the app by `pio run -t upload`.
+    env.Append(FLASH_EXTRA_IMAGES=[(offset, str(out))])
+
+
+if env["PIOENV"] in ("src", "out"):
+    add_portal_bundle()
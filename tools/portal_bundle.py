@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Pack the portal UI into one flash-mapped asset bundle.
+
+The firmware memory-maps the `portal` data partition and serves each asset
+straight from it, so everything a response needs is computed here: the gzip
+body, content type, ETag and Cache-Control. The layout must match
+lib/control/include/control/asset_bundle.h.
+
+Layout (little-endian):
+  header   magic "SMPB", u16 version, u16 count, u32 total_size, u32 checksum
+  entries  count x { u32 path, u32 type, u32 etag, u32 cache, u32 data,
+                     u32 data_len, u32 flags }, sorted by path bytes
+  strings  NUL-terminated, referenced by offset
+  data     asset bodies, 4-byte aligned
+
+Offsets are from the start of the bundle. checksum is FNV-1a over
+bytes [16, total_size).
+
+HTML is revalidated on every load. Other assets are referenced from the HTML
+with ?v=<etag>, so the browser may keep them forever: a new build changes the
+URL.
+"""
+
+from __future__ import annotations
+
+import argparse
+import gzip
+import hashlib
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = b"SMPB"
+VERSION = 1
+HEADER = struct.Struct("<4sHHII")
+ENTRY = struct.Struct("<IIIIIII")
+FLAG_GZIP = 0x01
+
+CONTENT_TYPES = {
+    ".html": "text/html; charset=utf-8",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".png": "image/png",
+    ".ico": "image/x-icon",
+}
+CACHE_REVALIDATE = "no-cache"
+CACHE_IMMUTABLE = "public, max-age=31536000, immutable"
+
+
+def fnv1a(data: bytes) -> int:
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def etag_of(body: bytes) -> str:
+    return hashlib.sha256(body).hexdigest()[:16]
+
+
+def compress(raw: bytes) -> tuple[bytes, int]:
+    # mtime=0 keeps the output, and so the ETag, stable across builds.
+    gz = gzip.compress(raw, compresslevel=9, mtime=0)
+    return (gz, FLAG_GZIP) if len(gz) < len(raw) else (raw, 0)
+
+
+def collect(dist: Path) -> dict[str, bytes]:
+    assets = {}
+    for path in sorted(dist.rglob("*")):
+        if path.is_file() and path.suffix in CONTENT_TYPES:
+            assets["/" + path.relative_to(dist).as_posix()] = path.read_bytes()
+    if "/index.html" not in assets:
+        raise RuntimeError(f"{dist}/index.html missing")
+    return assets
+
+
+def fingerprint_html(raw: bytes, versions: dict[str, str]) -> bytes:
+    for url, tag in versions.items():
+        for quote in (b'"', b"'"):
+            raw = raw.replace(b"=" + quote + url.encode() + quote,
+                              b"=" + quote + f"{url}?v={tag}".encode() + quote)
+    return raw
+
+
+def pack(assets: dict[str, bytes]) -> bytes:
+    bodies = {}
+    versions = {}
+    for url, raw in assets.items():
+        if not url.endswith(".html"):
+            bodies[url] = compress(raw)
+            versions[url] = etag_of(bodies[url][0])[:8]
+    for url, raw in assets.items():
+        if url.endswith(".html"):
+            bodies[url] = compress(fingerprint_html(raw, versions))
+
+    urls = sorted(bodies, key=lambda u: u.encode())
+    strings = bytearray()
+    string_offsets = {}
+    base = HEADER.size + ENTRY.size * len(urls)
+
+    def intern(s: str) -> int:
+        if s not in string_offsets:
+            string_offsets[s] = base + len(strings)
+            strings.extend(s.encode() + b"\0")
+        return string_offsets[s]
+
+    rows = []
+    for url in urls:
+        body, flags = bodies[url]
+        suffix = Path(url).suffix
+        cache = CACHE_REVALIDATE if suffix == ".html" else CACHE_IMMUTABLE
+        rows.append([intern(url), intern(CONTENT_TYPES[suffix]), intern(f'"{etag_of(body)}"'),
+                     intern(cache), 0, len(body), flags])
+
+    data = bytearray()
+    data_base = (base + len(strings) + 3) & ~3
+    for row, url in zip(rows, urls):
+        row[4] = data_base + len(data)
+        data.extend(bodies[url][0])
+        data.extend(b"\0" * (-len(data) % 4))
+
+    body = bytearray()
+    for row in rows:
+        body.extend(ENTRY.pack(*row))
+    body.extend(strings)
+    body.extend(b"\0" * (data_base - base - len(strings)))
+    body.extend(data)
+
+    total = HEADER.size + len(body)
+    return HEADER.pack(MAGIC, VERSION, len(urls), total, fnv1a(bytes(body))) + bytes(body)
+
+
+def build(dist: Path, out: Path) -> bytes:
+    bundle = pack(collect(dist))
+    out.parent.mkdir(parents=True, exist_ok=True)
+    if not out.exists() or out.read_bytes() != bundle:
+        out.write_bytes(bundle)
+    return bundle
+
+
+def main(argv: list[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dist", type=Path, help="portal-ui dist directory")
+    parser.add_argument("out", type=Path, help="bundle image to write")
+    args = parser.parse_args(argv)
+    bundle = build(args.dist, args.out)
+    print(f"[portal-bundle] wrote {args.out} ({len(bundle)} bytes)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
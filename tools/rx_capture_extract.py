@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Rebuild RX capture dumps from an OUT node serial log.
+
+The firmware prints the capture ring (network_rx_capture_dump_serial) as
+"RXCAP BEGIN <bytes> ...", hex "RXCAP <data>" lines and "RXCAP END <crc32>".
+Each complete block is checked for length and CRC-32 and written as a binary
+.rxcap file for the native replay:
+
+    RX_REPLAY_FILE=out_0.rxcap pio test -e native -f test_rx_replay -v
+
+Log lines may carry monitor prefixes (timestamps, port tags); only the text from
+"RXCAP" onwards is parsed.
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import sys
+import zlib
+from pathlib import Path
+
+BEGIN_PATTERN = re.compile(r"RXCAP BEGIN (\d+)")
+END_PATTERN = re.compile(r"RXCAP END ([0-9a-fA-F]{8})")
+DATA_PATTERN = re.compile(r"RXCAP ([0-9a-fA-F]+)\s*$")
+
+
+def extract(lines: list[str]) -> tuple[list[bytes], list[str]]:
+    dumps: list[bytes] = []
+    errors: list[str] = []
+    expected: int | None = None
+    chunks: list[bytes] = []
+
+    for lineno, line in enumerate(lines, start=1):
+        begin = BEGIN_PATTERN.search(line)
+        if begin:
+            if expected is not None:
+                errors.append(f"line {lineno}: BEGIN before END, previous dump discarded")
+            expected = int(begin.group(1))
+            chunks = []
+            continue
+        if expected is None:
+            continue
+        end = END_PATTERN.search(line)
+        if end:
+            data = b"".join(chunks)
+            crc = zlib.crc32(data) & 0xFFFFFFFF
+            if len(data) != expected:
+                errors.append(f"line {lineno}: dump has {len(data)} bytes, expected {expected}")
+            elif crc != int(end.group(1), 16):
+                errors.append(f"line {lineno}: CRC mismatch ({crc:08x} != {end.group(1)})")
+            else:
+                dumps.append(data)
+            expected = None
+            continue
+        data_line = DATA_PATTERN.search(line)
+        if data_line and len(data_line.group(1)) % 2 == 0:
+            chunks.append(bytes.fromhex(data_line.group(1)))
+
+    if expected is not None:
+        errors.append("log ends inside a dump")
+    return dumps, errors
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Extract RX capture dumps from a serial log.")
+    parser.add_argument("log", type=Path, help="Serial log file ('-' for stdin)")
+    parser.add_argument("--out-prefix", default="rx_capture", help="Output file prefix")
+    args = parser.parse_args()
+
+    if str(args.log) == "-":
+        lines = sys.stdin.read().splitlines()
+    else:
+        lines = args.log.read_text(encoding="utf-8", errors="replace").splitlines()
+
+    dumps, errors = extract(lines)
+    for err in errors:
+        print(f"warning: {err}", file=sys.stderr)
+    for index, data in enumerate(dumps):
+        path = Path(f"{args.out_prefix}_{index}.rxcap")
+        path.write_bytes(data)
+        print(f"{path}: {len(data)} bytes")
+    if not dumps:
+        print("no complete RXCAP dump found", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,79 @@
+from __future__ import annotations
+
+import gzip
+import tempfile
+import unittest
+from pathlib import Path
+
+from tools import portal_bundle as pb
+
+
+def read_entries(bundle: bytes) -> dict[str, dict]:
+    magic, version, count, total, checksum = pb.HEADER.unpack_from(bundle)
+    assert (magic, version, total) == (pb.MAGIC, pb.VERSION, len(bundle))
+    assert checksum == pb.fnv1a(bundle[pb.HEADER.size:])
+
+    def string(off: int) -> str:
+        return bundle[off:bundle.index(b"\0", off)].decode()
+
+    entries = {}
+    for i in range(count):
+        path, ctype, etag, cache, data, length, flags = pb.ENTRY.unpack_from(
+            bundle, pb.HEADER.size + i * pb.ENTRY.size)
+        body = bundle[data:data + length]
+        entries[string(path)] = {
+            "type": string(ctype),
+            "etag": string(etag),
+            "cache": string(cache),
+            "data_off": data,
+            "body": gzip.decompress(body) if flags & pb.FLAG_GZIP else body,
+        }
+    return entries
+
+
+class PortalBundleTests(unittest.TestCase):
+    def pack(self, files: dict[str, bytes]) -> bytes:
+        with tempfile.TemporaryDirectory() as tmp:
+            dist = Path(tmp)
+            for name, raw in files.items():
+                (dist / name).write_bytes(raw)
+            return pb.pack(pb.collect(dist))
+
+    def test_round_trips_every_asset_with_headers(self) -> None:
+        js = b"console.log('portal');" * 40
+        entries = read_entries(self.pack({
+            "index.html": b"<html><script src=\"/app.js\"></script></html>",
+            "app.js": js,
+            "app.css": b"body{margin:0}",
+        }))
+        self.assertEqual(list(entries), ["/app.css", "/app.js", "/index.html"])
+        self.assertEqual(entries["/app.js"]["body"], js)
+        self.assertEqual(entries["/app.js"]["type"], "application/javascript")
+        self.assertEqual(entries["/index.html"]["cache"], pb.CACHE_REVALIDATE)
+        self.assertEqual(entries["/app.css"]["cache"], pb.CACHE_IMMUTABLE)
+        for entry in entries.values():
+            self.assertEqual(entry["data_off"] % 4, 0)
+            self.assertRegex(entry["etag"], r'^"[0-9a-f]{16}"$')
+
+    def test_html_references_are_fingerprinted(self) -> None:
+        files = {"index.html": b"<script src=\"/app.js\" defer></script>", "app.js": b"a" * 200}
+        first = read_entries(self.pack(files))
+        tag = first["/app.js"]["etag"].strip('"')[:8]
+        self.assertIn(f'src="/app.js?v={tag}"'.encode(), first["/index.html"]["body"])
+
+        files["app.js"] = b"b" * 200
+        second = read_entries(self.pack(files))
+        self.assertNotEqual(first["/app.js"]["etag"], second["/app.js"]["etag"])
+        self.assertNotEqual(first["/index.html"]["etag"], second["/index.html"]["etag"])
+
+    def test_output_is_reproducible(self) -> None:
+        files = {"index.html": b"<html>" * 50, "app.js": b"x=1;" * 50}
+        self.assertEqual(self.pack(files), self.pack(files))
+
+    def test_missing_index_is_an_error(self) -> None:
+        with self.assertRaises(RuntimeError):
+            self.pack({"app.js": b"x"})
+
+
+if __name__ == "__main__":
+    unittest.main()